@@ -0,0 +1,432 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Exceptions.h"
+#include "Logger.h"
+#include "PreferenceManager.h"
+#include "Assets/EntityDefinitionFileSpec.h"
+#include "Assets/EntityDefinitionManager.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/IOUtils.h"
+#include "IO/MapFileSerializer.h"
+#include "IO/NodeWriter.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/SimpleParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/BrushNode.h"
+#include "Model/EmptyBrushEntityIssueGenerator.h"
+#include "Model/EmptyGroupIssueGenerator.h"
+#include "Model/EmptyPropertyKeyIssueGenerator.h"
+#include "Model/EmptyPropertyValueIssueGenerator.h"
+#include "Model/EntityNode.h"
+#include "Model/ExportFormat.h"
+#include "Model/Game.h"
+#include "Model/GameConfig.h"
+#include "Model/GameFactory.h"
+#include "Model/GroupNode.h"
+#include "Model/InvalidTextureScaleIssueGenerator.h"
+#include "Model/Issue.h"
+#include "Model/IssueIndex.h"
+#include "Model/LayerNode.h"
+#include "Model/LinkSourceIssueGenerator.h"
+#include "Model/LinkTargetIssueGenerator.h"
+#include "Model/LongPropertyKeyIssueGenerator.h"
+#include "Model/LongPropertyValueIssueGenerator.h"
+#include "Model/MapFormat.h"
+#include "Model/MissingClassnameIssueGenerator.h"
+#include "Model/MissingDefinitionIssueGenerator.h"
+#include "Model/MissingModIssueGenerator.h"
+#include "Model/MixedBrushContentsIssueGenerator.h"
+#include "Model/NonIntegerVerticesIssueGenerator.h"
+#include "Model/PatchNode.h"
+#include "Model/PointEntityWithBrushesIssueGenerator.h"
+#include "Model/PropertyKeyWithDoubleQuotationMarksIssueGenerator.h"
+#include "Model/PropertyValueWithDoubleQuotationMarksIssueGenerator.h"
+#include "Model/SoftMapBoundsIssueGenerator.h"
+#include "Model/WorldBoundsIssueGenerator.h"
+#include "Model/WorldNode.h"
+
+#include <kdl/overload.h>
+#include <kdl/thread_pool.h>
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QSettings>
+#include <QString>
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace CLI {
+        /**
+         * Collects the messages logged while processing a map so that the output of maps that are processed in
+         * parallel is not interleaved.
+         */
+        class BufferedLogger : public Logger {
+        private:
+            std::stringstream m_buffer;
+        public:
+            std::string str() const {
+                return m_buffer.str();
+            }
+        private:
+            void doLog(const LogLevel level, const std::string& message) override {
+                switch (level) {
+                    case LogLevel::Debug:
+                        return;
+                    case LogLevel::Info:
+                        break;
+                    case LogLevel::Warn:
+                        m_buffer << "warning: ";
+                        break;
+                    case LogLevel::Error:
+                        m_buffer << "error: ";
+                        break;
+                }
+                m_buffer << message << "\n";
+            }
+
+            void doLog(const LogLevel level, const QString& message) override {
+                doLog(level, message.toStdString());
+            }
+        };
+
+        struct Options {
+            std::optional<std::string> gameName;
+            Model::MapFormat inputFormat = Model::MapFormat::Unknown;
+            bool validate = false;
+            std::optional<Model::MapFormat> convertFormat;
+            bool exportObj = false;
+            std::optional<IO::Path> outputDir;
+        };
+
+        /**
+         * A map to process, together with the game it belongs to. The games are created before processing starts
+         * because creating them accesses the preferences, which is not thread safe.
+         */
+        struct Job {
+            IO::Path mapPath;
+            std::shared_ptr<Model::Game> game;
+            std::vector<Model::MapFormat> formatsToTry;
+        };
+
+        struct JobResult {
+            std::string output;
+            bool success = false;
+        };
+
+        static const auto WorldBounds = vm::bbox3(8192.0);
+
+        static void registerIssueGenerators(Model::WorldNode& world, std::shared_ptr<Model::Game> game) {
+            world.registerIssueGenerator(new Model::MissingClassnameIssueGenerator());
+            world.registerIssueGenerator(new Model::MissingDefinitionIssueGenerator());
+            world.registerIssueGenerator(new Model::MissingModIssueGenerator(game));
+            world.registerIssueGenerator(new Model::EmptyGroupIssueGenerator());
+            world.registerIssueGenerator(new Model::EmptyBrushEntityIssueGenerator());
+            world.registerIssueGenerator(new Model::PointEntityWithBrushesIssueGenerator());
+            world.registerIssueGenerator(new Model::LinkSourceIssueGenerator());
+            world.registerIssueGenerator(new Model::LinkTargetIssueGenerator());
+            world.registerIssueGenerator(new Model::NonIntegerVerticesIssueGenerator());
+            world.registerIssueGenerator(new Model::MixedBrushContentsIssueGenerator());
+            world.registerIssueGenerator(new Model::WorldBoundsIssueGenerator(WorldBounds));
+            world.registerIssueGenerator(new Model::SoftMapBoundsIssueGenerator(game, &world));
+            world.registerIssueGenerator(new Model::EmptyPropertyKeyIssueGenerator());
+            world.registerIssueGenerator(new Model::EmptyPropertyValueIssueGenerator());
+            world.registerIssueGenerator(new Model::LongPropertyKeyIssueGenerator(game->maxPropertyLength()));
+            world.registerIssueGenerator(new Model::LongPropertyValueIssueGenerator(game->maxPropertyLength()));
+            world.registerIssueGenerator(new Model::PropertyKeyWithDoubleQuotationMarksIssueGenerator());
+            world.registerIssueGenerator(new Model::PropertyValueWithDoubleQuotationMarksIssueGenerator());
+            world.registerIssueGenerator(new Model::InvalidTextureScaleIssueGenerator());
+        }
+
+        static std::unique_ptr<Model::WorldNode> readWorld(const Job& job, IO::ParserStatus& status) {
+            const auto file = IO::Disk::openFile(job.mapPath);
+            auto fileReader = file->reader().buffer();
+            return IO::WorldReader::tryRead(fileReader.stringView(), job.formatsToTry, WorldBounds, status);
+        }
+
+        static void loadEntityDefinitions(const Job& job, Model::WorldNode& world, Assets::EntityDefinitionManager& entityDefinitionManager, IO::ParserStatus& status, Logger& logger) {
+            try {
+                const auto spec = job.game->extractEntityDefinitionFile(world.entity());
+                const auto path = job.game->findEntityDefinitionFile(spec, {job.mapPath.deleteLastComponent(), job.game->gamePath()});
+                entityDefinitionManager.loadDefinitions(path, *job.game, status);
+            } catch (const Exception& e) {
+                logger.warn() << "Could not load entity definitions: " << e.what();
+                return;
+            }
+
+            const auto setDefinition = [&](auto* node) {
+                node->setDefinition(entityDefinitionManager.definition(node));
+            };
+            world.accept(kdl::overload(
+                [=](auto&& thisLambda, Model::WorldNode* world_)  { setDefinition(world_); world_->visitChildren(thisLambda); },
+                [] (auto&& thisLambda, Model::LayerNode* layer)   { layer->visitChildren(thisLambda); },
+                [] (auto&& thisLambda, Model::GroupNode* group)   { group->visitChildren(thisLambda); },
+                [=](Model::EntityNode* entity)                    { setDefinition(entity); },
+                [] (Model::BrushNode*)                            {},
+                [] (Model::PatchNode*)                            {}
+            ));
+        }
+
+        /**
+         * Validates the given world and logs every issue. Returns the number of issues found.
+         */
+        static size_t validate(const Job& job, Model::WorldNode& world, Logger& logger) {
+            registerIssueGenerators(world, job.game);
+
+            const auto issues = Model::validateAllIssues(world);
+            for (const auto* issue : issues) {
+                logger.warn() << job.mapPath.asString() << ":" << issue->lineNumber() << ": " << issue->description();
+            }
+            return issues.size();
+        }
+
+        static IO::Path outputPath(const Job& job, const Options& options, const std::string& suffix) {
+            const auto name = job.mapPath.lastComponent().deleteExtension().asString() + suffix;
+            const auto dir = options.outputDir ? *options.outputDir : job.mapPath.deleteLastComponent();
+            return dir + IO::Path{name};
+        }
+
+        /**
+         * Writes the given world in the given format. Brushes whose texture coordinate system does not match the
+         * target format are converted first.
+         */
+        static void convert(const Job& job, Model::WorldNode& world, const Model::MapFormat format, const IO::Path& path, Logger& logger) {
+            if (Model::isParallelTexCoordSystem(world.mapFormat()) != Model::isParallelTexCoordSystem(format)) {
+                const auto toParallel = Model::isParallelTexCoordSystem(format);
+                world.accept(kdl::overload(
+                    [] (auto&& thisLambda, Model::WorldNode* world_)  { world_->visitChildren(thisLambda); },
+                    [] (auto&& thisLambda, Model::LayerNode* layer)   { layer->visitChildren(thisLambda); },
+                    [] (auto&& thisLambda, Model::GroupNode* group)   { group->visitChildren(thisLambda); },
+                    [] (auto&& thisLambda, Model::EntityNode* entity) { entity->visitChildren(thisLambda); },
+                    [=](Model::BrushNode* brushNode) {
+                        const auto& brush = brushNode->brush();
+                        brushNode->setBrush(toParallel ? brush.convertToParallel() : brush.convertToParaxial());
+                    },
+                    [] (Model::PatchNode*)                            {}
+                ));
+            }
+
+            std::ofstream file = IO::openPathAsOutputStream(path);
+            if (!file) {
+                throw FileSystemException("Cannot open file: " + path.asString());
+            }
+            IO::writeGameComment(file, job.game->gameName(), Model::formatName(format));
+
+            IO::NodeWriter writer(world, IO::MapFileSerializer::create(format, file));
+            writer.writeMap();
+
+            logger.info() << "Wrote " << path.asString();
+        }
+
+        static void exportObj(const Job& job, Model::WorldNode& world, const IO::Path& path, Logger& logger) {
+            job.game->exportMap(world, Model::ExportFormat::WavefrontObj, path);
+            logger.info() << "Exported " << path.asString();
+        }
+
+        static JobResult process(const Job& job, const Options& options) {
+            auto logger = BufferedLogger{};
+            auto status = IO::SimpleParserStatus{logger, job.mapPath.asString()};
+            auto success = true;
+
+            try {
+                // the definitions must outlive the world because the entity nodes refer to them
+                auto entityDefinitionManager = Assets::EntityDefinitionManager{};
+
+                auto world = readWorld(job, status);
+                logger.info() << "Loaded " << job.mapPath.asString() << " (" << Model::formatName(world->mapFormat()) << ")";
+
+                if (options.validate) {
+                    loadEntityDefinitions(job, *world, entityDefinitionManager, status, logger);
+                    if (validate(job, *world, logger) > 0u) {
+                        success = false;
+                    }
+                }
+                if (options.exportObj) {
+                    exportObj(job, *world, outputPath(job, options, ".obj"), logger);
+                }
+                if (options.convertFormat) {
+                    const auto format = *options.convertFormat;
+                    convert(job, *world, format, outputPath(job, options, "." + Model::formatName(format) + ".map"), logger);
+                }
+            } catch (const std::exception& e) {
+                logger.error() << job.mapPath.asString() << ": " << e.what();
+                success = false;
+            }
+
+            return JobResult{logger.str(), success};
+        }
+
+        static std::optional<Job> createJob(const IO::Path& mapPath, const Options& options, Logger& logger) {
+            auto& gameFactory = Model::GameFactory::instance();
+
+            try {
+                auto [gameName, format] = gameFactory.detectGame(mapPath);
+                if (options.gameName) {
+                    gameName = *options.gameName;
+                }
+                if (options.inputFormat != Model::MapFormat::Unknown) {
+                    format = options.inputFormat;
+                }
+                if (gameName.empty()) {
+                    logger.error() << mapPath.asString() << ": Could not detect the game, use --game to specify it";
+                    return std::nullopt;
+                }
+
+                auto formatsToTry = format != Model::MapFormat::Unknown
+                    ? std::vector<Model::MapFormat>{format}
+                    : kdl::vec_transform(gameFactory.gameConfig(gameName).fileFormats(), [](const Model::MapFormatConfig& config) {
+                        return Model::formatFromName(config.format);
+                    });
+
+                return Job{mapPath, gameFactory.createGame(gameName, logger), std::move(formatsToTry)};
+            } catch (const Exception& e) {
+                logger.error() << mapPath.asString() << ": " << e.what();
+                return std::nullopt;
+            }
+        }
+
+        static std::optional<Model::MapFormat> parseFormat(const QString& name, Logger& logger) {
+            const auto format = Model::formatFromName(name.toStdString());
+            if (format == Model::MapFormat::Unknown) {
+                logger.error() << "Unknown map format: " << name.toStdString();
+                return std::nullopt;
+            }
+            return format;
+        }
+
+        class StdErrLogger : public Logger {
+        private:
+            void doLog(const LogLevel level, const std::string& message) override {
+                if (level != LogLevel::Debug) {
+                    std::cerr << message << "\n";
+                }
+            }
+
+            void doLog(const LogLevel level, const QString& message) override {
+                doLog(level, message.toStdString());
+            }
+        };
+    }
+}
+
+int main(int argc, char *argv[]) {
+    using namespace TrenchBroom;
+
+    QSettings::setDefaultFormat(QSettings::IniFormat);
+    PreferenceManager::createInstance<AppPreferenceManager>();
+
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("TrenchBroom");
+    // Needs to be "" otherwise Qt adds this to the paths returned by QStandardPaths
+    app.setOrganizationName("");
+    app.setOrganizationDomain("io.github.trenchbroom");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Validates, converts and exports map files without opening the editor.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("maps", "The map files to process.", "<map>...");
+
+    const auto gameOption = QCommandLineOption{"game", "The game of the maps, if it cannot be detected from the map files.", "name"};
+    const auto formatOption = QCommandLineOption{"format", "The map format of the maps, if it cannot be detected from the map files.", "format"};
+    const auto validateOption = QCommandLineOption{"validate", "Report the issues of the maps. Exits with an error if any issues are found."};
+    const auto convertOption = QCommandLineOption{"convert", "Write each map in the given map format, e.g. Standard, Valve or Quake3.", "format"};
+    const auto exportObjOption = QCommandLineOption{"export-obj", "Export each map as a Wavefront OBJ file."};
+    const auto outputOption = QCommandLineOption{"output", "The directory to write converted and exported files to. Defaults to the directory of each map.", "dir"};
+    parser.addOptions({gameOption, formatOption, validateOption, convertOption, exportObjOption, outputOption});
+    parser.process(app);
+
+    auto logger = CLI::StdErrLogger{};
+    const auto workingDir = IO::Disk::getCurrentWorkingDir();
+    const auto absolutePath = [&](const QString& str) {
+        const auto path = IO::Path{str.toStdString()};
+        return path.isAbsolute() ? path : workingDir + path;
+    };
+
+    auto options = CLI::Options{};
+    if (parser.isSet(gameOption)) {
+        options.gameName = parser.value(gameOption).toStdString();
+    }
+    if (parser.isSet(formatOption)) {
+        const auto format = CLI::parseFormat(parser.value(formatOption), logger);
+        if (!format) {
+            return 1;
+        }
+        options.inputFormat = *format;
+    }
+    if (parser.isSet(convertOption)) {
+        options.convertFormat = CLI::parseFormat(parser.value(convertOption), logger);
+        if (!options.convertFormat) {
+            return 1;
+        }
+    }
+    if (parser.isSet(outputOption)) {
+        options.outputDir = absolutePath(parser.value(outputOption));
+    }
+    options.validate = parser.isSet(validateOption);
+    options.exportObj = parser.isSet(exportObjOption);
+
+    const auto mapPaths = parser.positionalArguments();
+    if (mapPaths.isEmpty() || !(options.validate || options.convertFormat || options.exportObj)) {
+        parser.showHelp(1);
+    }
+
+    auto& gameFactory = Model::GameFactory::instance();
+    try {
+        gameFactory.initialize();
+    } catch (const std::exception& e) {
+        // the factory loads all configs it can, so we can still process maps for the other games
+        logger.warn() << e.what();
+    }
+
+    auto jobs = std::vector<CLI::Job>{};
+    auto success = true;
+    for (const auto& mapPath : mapPaths) {
+        if (auto job = CLI::createJob(absolutePath(mapPath), options, logger)) {
+            jobs.push_back(std::move(*job));
+        } else {
+            success = false;
+        }
+    }
+
+    // the maps are independent, so they are processed in parallel; the output is buffered per map and printed in
+    // the order in which the maps were given
+    auto results = std::vector<CLI::JobResult>(jobs.size());
+    kdl::thread_pool::global().parallel_for(jobs.size(), [&](const size_t i) {
+        results[i] = CLI::process(jobs[i], options);
+    });
+
+    for (const auto& result : results) {
+        std::cout << result.output;
+        success = success && result.success;
+    }
+
+    return success ? 0 : 1;
+}
@@ -36,7 +36,9 @@
 
 #include <vecmath/bbox.h>
 
-#include "BenchmarkUtils.h"
+#include <vector>
+
+#include "BenchmarkReport.h"
 #include "../../test/src/Catch2.h"
 
 namespace TrenchBroom {
@@ -54,18 +56,24 @@ namespace TrenchBroom {
         const vm::bbox3 worldBounds(8192.0);
         auto world = worldReader.read(worldBounds, status);
 
-        std::vector<AABB> trees(100);
-        timeLambda([&world, &trees]() {
-            for (auto& tree : trees) {
-                world->accept(kdl::overload(
-                    [] (auto&& thisLambda, Model::WorldNode* world_)  { world_->visitChildren(thisLambda); },
-                    [] (auto&& thisLambda, Model::LayerNode* layer)   { layer->visitChildren(thisLambda); },
-                    [] (auto&& thisLambda, Model::GroupNode* group)   { group->visitChildren(thisLambda); },
-                    [&](auto&& thisLambda, Model::EntityNode* entity) { entity->visitChildren(thisLambda); tree.insert(entity->physicalBounds(), entity); },
-                    [&](Model::BrushNode* brush)                      { tree.insert(brush->physicalBounds(), brush); },
-                    [&](Model::PatchNode* patch)                      { tree.insert(patch->physicalBounds(), patch); }
-                ));
-            }
-        }, "Add objects to AABB tree");
+        auto report = BenchmarkReport{"AABBTreeBenchmark.benchBuildTree"};
+        for (size_t run = 0u; run < BenchmarkReport::runs(); ++run) {
+            std::vector<AABB> trees(100);
+            report.timeStage("add objects to 100 AABB trees", [&world, &trees]() {
+                for (auto& tree : trees) {
+                    world->accept(kdl::overload(
+                        [] (auto&& thisLambda, Model::WorldNode* world_)  { world_->visitChildren(thisLambda); },
+                        [] (auto&& thisLambda, Model::LayerNode* layer)   { layer->visitChildren(thisLambda); },
+                        [] (auto&& thisLambda, Model::GroupNode* group)   { group->visitChildren(thisLambda); },
+                        [&](auto&& thisLambda, Model::EntityNode* entity) { entity->visitChildren(thisLambda); tree.insert(entity->physicalBounds(), entity); },
+                        [&](Model::BrushNode* brush)                      { tree.insert(brush->physicalBounds(), brush); },
+                        [&](Model::PatchNode* patch)                      { tree.insert(patch->physicalBounds(), patch); }
+                    ));
+                }
+            });
+        }
+
+        report.write();
+        CHECK(report.compareToBaseline());
     }
 }
@@ -0,0 +1,95 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "AllocationCounter.h"
+
+#include "AllocationCounting.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef TB_ENABLE_ALLOCATION_COUNTING
+// common already replaces the global operator new and counts the allocations per subsystem
+namespace TrenchBroom {
+    size_t heapAllocationCount() {
+        return totalAllocationCounts().allocations;
+    }
+}
+#else
+namespace TrenchBroom {
+    static std::atomic<size_t> s_heapAllocationCount{0};
+
+    size_t heapAllocationCount() {
+        return s_heapAllocationCount.load(std::memory_order_relaxed);
+    }
+
+    static void* countedAllocate(const std::size_t size) noexcept {
+        s_heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+        return std::malloc(size == 0 ? 1 : size);
+    }
+}
+
+void* operator new(const std::size_t size) {
+    if (auto* ptr = TrenchBroom::countedAllocate(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void* operator new[](const std::size_t size) {
+    if (auto* ptr = TrenchBroom::countedAllocate(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept {
+    return TrenchBroom::countedAllocate(size);
+}
+
+void* operator new[](const std::size_t size, const std::nothrow_t&) noexcept {
+    return TrenchBroom::countedAllocate(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+#endif
@@ -1,5 +1,5 @@
 /*
- Copyright (C) 2010-2017 Kristian Duske
+ Copyright (C) 2021 Kristian Duske
 
  This file is part of TrenchBroom.
 
@@ -17,6 +17,16 @@
  along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
  */
 
-// Hack to reuse the same main() function as the test suite
-#include "../../test/src/TestPreferenceManager.cpp"
-#include "../../test/src/RunAllTests.cpp"
+
+#pragma once
+
+#include <cstddef>
+
+namespace TrenchBroom {
+    /**
+     * Returns the number of heap allocations made by any thread since the program started. The benchmark
+     * executable replaces the global operator new to count them unless TrenchBroom was built with
+     * TB_ENABLE_ALLOCATION_COUNTING, in which case the counts by subsystem are summed up.
+     */
+    size_t heapAllocationCount();
+}
@@ -0,0 +1,233 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkReport.h"
+
+#include "Exceptions.h"
+#include "EL/EvaluationContext.h"
+#include "EL/Expression.h"
+#include "EL/Value.h"
+#include "IO/ELParser.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <sstream>
+
+namespace TrenchBroom {
+    static std::string escapeJson(const std::string& str) {
+        auto result = std::string{};
+        result.reserve(str.size());
+        for (const auto c : str) {
+            switch (c) {
+                case '"':
+                    result += "\\\"";
+                    break;
+                case '\\':
+                    result += "\\\\";
+                    break;
+                case '\n':
+                    result += "\\n";
+                    break;
+                case '\t':
+                    result += "\\t";
+                    break;
+                default:
+                    result += c;
+                    break;
+            }
+        }
+        return result;
+    }
+
+    template <typename T>
+    static std::optional<T> environmentValue(const char* name) {
+        if (const char* str = std::getenv(name)) {
+            auto stream = std::istringstream{str};
+            auto value = T{};
+            if (stream >> value) {
+                return value;
+            }
+            std::cerr << "Ignoring invalid value '" << str << "' of " << name << "\n";
+        }
+        return std::nullopt;
+    }
+
+    static std::vector<double> sorted(std::vector<double> values) {
+        std::sort(std::begin(values), std::end(values));
+        return values;
+    }
+
+    double BenchmarkReport::Stage::median() const {
+        const auto values = sorted(milliseconds);
+        const auto n = values.size();
+        return n % 2u == 1u ? values[n / 2u] : (values[n / 2u - 1u] + values[n / 2u]) / 2.0;
+    }
+
+    double BenchmarkReport::Stage::percentile95() const {
+        // nearest rank method
+        const auto values = sorted(milliseconds);
+        const auto rank = static_cast<size_t>(std::ceil(0.95 * static_cast<double>(values.size())));
+        return values[std::max(rank, size_t(1)) - 1u];
+    }
+
+    size_t BenchmarkReport::Stage::allocationsPerSample() const {
+        return allocations / milliseconds.size();
+    }
+
+    BenchmarkReport::BenchmarkReport(std::string name) :
+    m_name{std::move(name)} {
+        for (size_t i = 0u; i < AllocationTagCount; ++i) {
+            m_initialAllocationCounts[i] = allocationCounts(static_cast<AllocationTag>(i));
+        }
+    }
+
+    size_t BenchmarkReport::runs() {
+        return std::max(environmentValue<size_t>("TB_BENCHMARK_RUNS").value_or(5u), size_t(1));
+    }
+
+    void BenchmarkReport::addProperty(std::string key, std::string value) {
+        m_properties.emplace_back(std::move(key), std::move(value));
+    }
+
+    void BenchmarkReport::addSample(const std::string& stageName, const double milliseconds, const size_t allocations) {
+        const auto it = std::find_if(std::begin(m_stages), std::end(m_stages), [&](const Stage& stage) { return stage.name == stageName; });
+        if (it != std::end(m_stages)) {
+            it->milliseconds.push_back(milliseconds);
+            it->allocations += allocations;
+        } else {
+            m_stages.push_back(Stage{stageName, {milliseconds}, allocations});
+        }
+    }
+
+    double BenchmarkReport::totalMilliseconds() const {
+        return std::accumulate(std::begin(m_stages), std::end(m_stages), 0.0, [](const double total, const Stage& stage) {
+            return total + stage.median();
+        });
+    }
+
+    void BenchmarkReport::writeJson(std::ostream& str) const {
+        str << std::fixed << std::setprecision(3);
+        str << "{\n";
+        str << "  \"name\": \"" << escapeJson(m_name) << "\",\n";
+        str << "  \"properties\": {";
+        for (size_t i = 0u; i < m_properties.size(); ++i) {
+            const auto& [key, value] = m_properties[i];
+            str << (i == 0u ? "\n" : ",\n") << "    \"" << escapeJson(key) << "\": \"" << escapeJson(value) << "\"";
+        }
+        str << (m_properties.empty() ? "},\n" : "\n  },\n");
+        str << "  \"stages\": [";
+        for (size_t i = 0u; i < m_stages.size(); ++i) {
+            const auto& stage = m_stages[i];
+            str << (i == 0u ? "\n" : ",\n") << "    { \"name\": \"" << escapeJson(stage.name) << "\""
+                << ", \"runs\": " << stage.milliseconds.size()
+                << ", \"ms\": " << stage.median()
+                << ", \"p95Ms\": " << stage.percentile95()
+                << ", \"allocations\": " << stage.allocationsPerSample() << " }";
+        }
+        str << (m_stages.empty() ? "],\n" : "\n  ],\n");
+        if (allocationCountingEnabled()) {
+            str << "  \"allocationsByTag\": {";
+            for (size_t i = 0u; i < AllocationTagCount; ++i) {
+                const auto tag = static_cast<AllocationTag>(i);
+                const auto counts = allocationCounts(tag);
+                str << (i == 0u ? "\n" : ",\n") << "    \"" << allocationTagName(tag) << "\": { "
+                    << "\"allocations\": " << counts.allocations - m_initialAllocationCounts[i].allocations
+                    << ", \"bytes\": " << counts.bytes - m_initialAllocationCounts[i].bytes << " }";
+            }
+            str << "\n  },\n";
+        }
+        str << "  \"totalMs\": " << totalMilliseconds() << "\n";
+        str << "}\n";
+    }
+
+    void BenchmarkReport::write() const {
+        writeJson(std::cout);
+
+        if (const char* reportDir = std::getenv("TB_BENCHMARK_REPORT_DIR")) {
+            const auto path = std::string{reportDir} + "/" + m_name + ".json";
+            auto stream = std::ofstream{path};
+            if (stream) {
+                writeJson(stream);
+            } else {
+                std::cerr << "Could not write benchmark report to '" << path << "'\n";
+            }
+        }
+    }
+
+    bool BenchmarkReport::compareToBaseline() const {
+        const char* baselineDir = std::getenv("TB_BENCHMARK_BASELINE_DIR");
+        if (!baselineDir) {
+            return true;
+        }
+
+        const auto path = std::string{baselineDir} + "/" + m_name + ".json";
+        auto stream = std::ifstream{path};
+        if (!stream) {
+            std::cout << "No benchmark baseline found at '" << path << "'\n";
+            return true;
+        }
+
+        auto contents = std::stringstream{};
+        contents << stream.rdbuf();
+
+        const auto threshold = environmentValue<double>("TB_BENCHMARK_THRESHOLD").value_or(0.1);
+        constexpr auto minRegressionMs = 1.0;
+
+        try {
+            const auto baseline = IO::ELParser::parseStrict(contents.str()).evaluate(EL::EvaluationContext());
+
+            const auto baselineStages = baseline["stages"];
+
+            auto result = true;
+            for (const auto& baselineStage : baselineStages.arrayValue()) {
+                const auto name = baselineStage["name"].stringValue();
+                const auto it = std::find_if(std::begin(m_stages), std::end(m_stages), [&](const Stage& stage) { return stage.name == name; });
+                if (it == std::end(m_stages)) {
+                    continue;
+                }
+
+                const auto baselineMs = baselineStage["ms"].numberValue();
+                const auto ms = it->median();
+                if (ms > baselineMs * (1.0 + threshold) && ms - baselineMs > minRegressionMs) {
+                    std::cerr << m_name << ": stage '" << name << "' regressed from " << baselineMs << "ms to " << ms << "ms\n";
+                    result = false;
+                }
+
+                if (baselineStage.contains("allocations")) {
+                    const auto baselineAllocations = baselineStage["allocations"].numberValue();
+                    const auto allocations = static_cast<double>(it->allocationsPerSample());
+                    if (allocations > baselineAllocations * (1.0 + threshold)) {
+                        std::cerr << m_name << ": stage '" << name << "' regressed from " << baselineAllocations << " to " << allocations << " allocations\n";
+                        result = false;
+                    }
+                }
+            }
+            return result;
+        } catch (const Exception& e) {
+            std::cerr << "Could not read benchmark baseline '" << path << "': " << e.what() << "\n";
+            return false;
+        }
+    }
+}
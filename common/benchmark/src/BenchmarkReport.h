@@ -0,0 +1,132 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "AllocationCounter.h"
+#include "AllocationCounting.h"
+
+#include <array>
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom {
+    /**
+     * Collects the durations and heap allocation counts of the individual stages of a benchmark and writes
+     * them as JSON so that results can be compared across versions.
+     *
+     * A stage can be timed several times, e.g. by running the benchmark in a loop of runs() iterations. The
+     * report then contains the median and the 95th percentile of the samples and the average number of
+     * allocations per sample.
+     *
+     * If the environment variable TB_BENCHMARK_REPORT_DIR is set, the report is written to a file named
+     * <name>.json in that directory. The report is always printed to stdout as well.
+     *
+     * If TrenchBroom was built with TB_ENABLE_ALLOCATION_COUNTING, the report also contains the heap allocations
+     * that each subsystem made while the report existed.
+     *
+     * If the environment variable TB_BENCHMARK_BASELINE_DIR is set, compareToBaseline() compares the report
+     * to the file <name>.json in that directory, which is a report previously written by this class.
+     */
+    class BenchmarkReport {
+    private:
+        struct Stage {
+            std::string name;
+            std::vector<double> milliseconds;
+            size_t allocations;
+
+            double median() const;
+            double percentile95() const;
+            size_t allocationsPerSample() const;
+        };
+
+        std::string m_name;
+        std::vector<std::pair<std::string, std::string>> m_properties;
+        std::vector<Stage> m_stages;
+        std::array<AllocationCounts, AllocationTagCount> m_initialAllocationCounts;
+    public:
+        explicit BenchmarkReport(std::string name);
+
+        /**
+         * Returns how often a benchmark should time its stages. Defaults to 5, but can be overridden using the
+         * environment variable TB_BENCHMARK_RUNS.
+         */
+        static size_t runs();
+
+        /**
+         * Adds a property that describes the input of the benchmark, e.g. the map file or the number of brushes.
+         */
+        void addProperty(std::string key, std::string value);
+
+        /**
+         * Runs the given lambda and records its duration and the number of heap allocations it made as a sample
+         * of the stage with the given name. Returns the result of the lambda.
+         */
+        template <typename L>
+        auto timeStage(const std::string& stageName, L&& lambda) {
+            using Clock = std::chrono::high_resolution_clock;
+            const auto allocations = heapAllocationCount();
+            const auto start = Clock::now();
+            if constexpr (std::is_void_v<decltype(lambda())>) {
+                lambda();
+                addSample(stageName, std::chrono::duration<double, std::milli>(Clock::now() - start).count(), heapAllocationCount() - allocations);
+            } else {
+                auto result = lambda();
+                addSample(stageName, std::chrono::duration<double, std::milli>(Clock::now() - start).count(), heapAllocationCount() - allocations);
+                return result;
+            }
+        }
+
+        /**
+         * Adds a sample to the stage with the given name. The stage is created if it doesn't exist yet.
+         */
+        void addSample(const std::string& stageName, double milliseconds, size_t allocations = 0u);
+
+        /**
+         * Returns the sum of the median durations of all stages.
+         */
+        double totalMilliseconds() const;
+
+        void writeJson(std::ostream& str) const;
+
+        /**
+         * Prints the report to stdout and writes it to the report directory if one is configured.
+         */
+        void write() const;
+
+        /**
+         * Compares this report to its baseline, if a baseline directory is configured and contains a baseline
+         * for this report.
+         *
+         * A stage regresses if its median duration or its allocations per sample exceed those of the baseline
+         * by more than the threshold, which defaults to 10% and can be overridden using the environment
+         * variable TB_BENCHMARK_THRESHOLD (e.g. 0.25 for 25%). Durations must additionally exceed the baseline
+         * by more than a millisecond so that very short stages don't fail because of noise.
+         *
+         * Every regression is printed to stderr.
+         *
+         * @return true if no stage regressed and false otherwise
+         */
+        bool compareToBaseline() const;
+    };
+}
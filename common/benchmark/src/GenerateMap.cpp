@@ -0,0 +1,143 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Exceptions.h"
+#include "Model/MapFormat.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "MapGenerator.h"
+
+/**
+ * Command line interface for the map generator, e.g.
+ *
+ *   generate-benchmark-map --format Valve --brushes 100000 --point-entities 5000 --properties 4 -o large.map
+ *
+ * Writes the generated map to stdout unless an output file is given.
+ */
+namespace TrenchBroom {
+    static void printUsage() {
+        std::cerr << "Usage: generate-benchmark-map [options]\n"
+                  << "  --format <name>                    map format, e.g. Standard, Valve, Quake2, Quake3\n"
+                  << "  --brushes <count>                  number of world brushes\n"
+                  << "  --faces <count>                    number of faces per brush (at least 5)\n"
+                  << "  --point-entities <count>           number of point entities\n"
+                  << "  --brush-entities <count>           number of brush entities\n"
+                  << "  --brushes-per-entity <count>       number of brushes per brush entity\n"
+                  << "  --properties <count>               number of random properties per entity\n"
+                  << "  --property-length <length>         maximum length of random property values\n"
+                  << "  --linked-groups <count>            number of linked groups\n"
+                  << "  --linked-group-instances <count>   number of instances per linked group\n"
+                  << "  --brushes-per-linked-group <count> number of brushes per linked group\n"
+                  << "  --patches <count>                  number of patches (Quake 3 formats only)\n"
+                  << "  --textures <count>                 number of distinct textures\n"
+                  << "  --seed <value>                     seed of the random generator\n"
+                  << "  -o <file>                          output file, defaults to stdout\n";
+    }
+
+    template <typename T>
+    static bool parseValue(const std::string& str, T& value) {
+        auto stream = std::istringstream{str};
+        return static_cast<bool>(stream >> value) && stream.eof();
+    }
+
+    static int run(const int argc, const char* const argv[]) {
+        auto config = MapGeneratorConfig{};
+        auto outputPath = std::string{};
+
+        const auto sizeOptions = std::map<std::string, size_t*>{
+            { "--brushes", &config.worldBrushCount },
+            { "--faces", &config.facesPerBrush },
+            { "--point-entities", &config.pointEntityCount },
+            { "--brush-entities", &config.brushEntityCount },
+            { "--brushes-per-entity", &config.brushesPerBrushEntity },
+            { "--properties", &config.propertiesPerEntity },
+            { "--property-length", &config.propertyValueLength },
+            { "--linked-groups", &config.linkedGroupCount },
+            { "--linked-group-instances", &config.linkedGroupInstanceCount },
+            { "--brushes-per-linked-group", &config.brushesPerLinkedGroup },
+            { "--patches", &config.patchCount },
+            { "--textures", &config.textureCount },
+        };
+
+        for (int i = 1; i < argc; ++i) {
+            const auto option = std::string{argv[i]};
+            if (option == "-h" || option == "--help") {
+                printUsage();
+                return EXIT_SUCCESS;
+            }
+            if (i + 1 == argc) {
+                std::cerr << "Missing value for option " << option << "\n";
+                printUsage();
+                return EXIT_FAILURE;
+            }
+
+            const auto value = std::string{argv[++i]};
+            auto valid = true;
+            if (const auto it = sizeOptions.find(option); it != std::end(sizeOptions)) {
+                valid = parseValue(value, *it->second);
+            } else if (option == "--seed") {
+                valid = parseValue(value, config.seed);
+            } else if (option == "--format") {
+                config.format = Model::formatFromName(value);
+                valid = config.format != Model::MapFormat::Unknown;
+            } else if (option == "-o") {
+                outputPath = value;
+            } else {
+                std::cerr << "Unknown option " << option << "\n";
+                printUsage();
+                return EXIT_FAILURE;
+            }
+
+            if (!valid) {
+                std::cerr << "Invalid value '" << value << "' for option " << option << "\n";
+                return EXIT_FAILURE;
+            }
+        }
+
+        try {
+            if (outputPath.empty()) {
+                generateMap(config, std::cout);
+            } else {
+                auto stream = std::ofstream{outputPath};
+                if (!stream) {
+                    std::cerr << "Could not open '" << outputPath << "' for writing\n";
+                    return EXIT_FAILURE;
+                }
+                generateMap(config, stream);
+                std::cerr << "Wrote " << generatedBrushCount(config) << " brushes with " << generatedFaceCount(config) << " faces to '" << outputPath << "'\n";
+            }
+        } catch (const Exception& e) {
+            std::cerr << e.what() << "\n";
+            return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    return TrenchBroom::run(argc, argv);
+}
@@ -0,0 +1,283 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Exceptions.h"
+#include "Logger.h"
+#include "Assets/AssetUtils.h"
+#include "Assets/EntityDefinitionFileSpec.h"
+#include "Assets/EntityDefinitionManager.h"
+#include "Assets/EntityModelManager.h"
+#include "Assets/TextureManager.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushNode.h"
+#include "Model/EmptyBrushEntityIssueGenerator.h"
+#include "Model/EmptyGroupIssueGenerator.h"
+#include "Model/EmptyPropertyKeyIssueGenerator.h"
+#include "Model/EmptyPropertyValueIssueGenerator.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/Game.h"
+#include "Model/GroupNode.h"
+#include "Model/InvalidTextureScaleIssueGenerator.h"
+#include "Model/IssueIndex.h"
+#include "Model/LayerNode.h"
+#include "Model/LinkSourceIssueGenerator.h"
+#include "Model/LinkTargetIssueGenerator.h"
+#include "Model/LongPropertyKeyIssueGenerator.h"
+#include "Model/LongPropertyValueIssueGenerator.h"
+#include "Model/MissingClassnameIssueGenerator.h"
+#include "Model/MissingDefinitionIssueGenerator.h"
+#include "Model/MissingModIssueGenerator.h"
+#include "Model/MixedBrushContentsIssueGenerator.h"
+#include "Model/NonIntegerVerticesIssueGenerator.h"
+#include "Model/PatchNode.h"
+#include "Model/PointEntityWithBrushesIssueGenerator.h"
+#include "Model/PropertyKeyWithDoubleQuotationMarksIssueGenerator.h"
+#include "Model/PropertyValueWithDoubleQuotationMarksIssueGenerator.h"
+#include "Model/SoftMapBoundsIssueGenerator.h"
+#include "Model/TagManager.h"
+#include "Model/WorldBoundsIssueGenerator.h"
+#include "Model/WorldNode.h"
+#include "Renderer/BrushRenderer.h"
+
+#include <kdl/overload.h>
+
+#include <vecmath/bbox.h>
+
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BenchmarkReport.h"
+#include "MapGenerator.h"
+#include "TestUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    /**
+     * Returns the path of the map to load. Defaults to the ne_ruins fixture, but can be overridden using the
+     * environment variable TB_BENCHMARK_MAP so that the same stages can be timed on arbitrary (large) maps.
+     */
+    static IO::Path benchmarkMapPath() {
+        if (const char* mapPath = std::getenv("TB_BENCHMARK_MAP")) {
+            return IO::Path{mapPath};
+        }
+        return IO::Disk::getCurrentWorkingDir() + IO::Path{"fixture/benchmark/AABBTree/ne_ruins.map"};
+    }
+
+    /**
+     * Returns the largest number of world brushes of the generated maps. Defaults to 16384, but can be overridden
+     * using the environment variable TB_BENCHMARK_MAX_GENERATED_BRUSHES to measure how the stages scale on large maps.
+     */
+    static size_t maxGeneratedBrushCount() {
+        if (const char* str = std::getenv("TB_BENCHMARK_MAX_GENERATED_BRUSHES")) {
+            auto stream = std::istringstream{str};
+            auto value = size_t(0);
+            if (stream >> value) {
+                return value;
+            }
+        }
+        return 16384u;
+    }
+
+    static void registerIssueGenerators(Model::WorldNode& world, std::shared_ptr<Model::Game> game) {
+        world.registerIssueGenerator(new Model::MissingClassnameIssueGenerator());
+        world.registerIssueGenerator(new Model::MissingDefinitionIssueGenerator());
+        world.registerIssueGenerator(new Model::MissingModIssueGenerator(game));
+        world.registerIssueGenerator(new Model::EmptyGroupIssueGenerator());
+        world.registerIssueGenerator(new Model::EmptyBrushEntityIssueGenerator());
+        world.registerIssueGenerator(new Model::PointEntityWithBrushesIssueGenerator());
+        world.registerIssueGenerator(new Model::LinkSourceIssueGenerator());
+        world.registerIssueGenerator(new Model::LinkTargetIssueGenerator());
+        world.registerIssueGenerator(new Model::NonIntegerVerticesIssueGenerator());
+        world.registerIssueGenerator(new Model::MixedBrushContentsIssueGenerator());
+        world.registerIssueGenerator(new Model::WorldBoundsIssueGenerator(vm::bbox3(8192.0)));
+        world.registerIssueGenerator(new Model::SoftMapBoundsIssueGenerator(game, &world));
+        world.registerIssueGenerator(new Model::EmptyPropertyKeyIssueGenerator());
+        world.registerIssueGenerator(new Model::EmptyPropertyValueIssueGenerator());
+        world.registerIssueGenerator(new Model::LongPropertyKeyIssueGenerator(game->maxPropertyLength()));
+        world.registerIssueGenerator(new Model::LongPropertyValueIssueGenerator(game->maxPropertyLength()));
+        world.registerIssueGenerator(new Model::PropertyKeyWithDoubleQuotationMarksIssueGenerator());
+        world.registerIssueGenerator(new Model::PropertyValueWithDoubleQuotationMarksIssueGenerator());
+        world.registerIssueGenerator(new Model::InvalidTextureScaleIssueGenerator());
+    }
+
+    /**
+     * Times the stages of loading the given map, from reading the world to preparing the first frame. Textures are
+     * searched relative to the given directory.
+     */
+    static void benchmarkLoadMap(BenchmarkReport& report, const std::string_view mapData, const Model::MapFormat mapFormat, const IO::Path& mapDirectory) {
+        NullLogger logger;
+        auto [game, gameConfig] = Model::loadGame("Quake");
+
+        // the asset managers must outlive the world because the nodes hold references to the assets
+        auto tagManager = Model::TagManager{};
+        auto entityDefinitionManager = Assets::EntityDefinitionManager{};
+        auto entityModelManager = Assets::EntityModelManager{0, 0, logger};
+        auto textureManager = Assets::TextureManager{0, 0, logger};
+
+        IO::TestParserStatus status;
+        auto world = report.timeStage("read world", [&]() {
+            IO::WorldReader worldReader(mapData, mapFormat);
+            return worldReader.read(vm::bbox3(8192.0), status);
+        });
+        REQUIRE(world != nullptr);
+
+        auto brushes = std::vector<Model::BrushNode*>{};
+        auto entityCount = size_t(0);
+        world->accept(kdl::overload(
+            [] (auto&& thisLambda, Model::WorldNode* world_)  { world_->visitChildren(thisLambda); },
+            [] (auto&& thisLambda, Model::LayerNode* layer)   { layer->visitChildren(thisLambda); },
+            [] (auto&& thisLambda, Model::GroupNode* group)   { group->visitChildren(thisLambda); },
+            [&](auto&& thisLambda, Model::EntityNode* entity) { ++entityCount; entity->visitChildren(thisLambda); },
+            [&](Model::BrushNode* brush)                      { brushes.push_back(brush); },
+            [] (Model::PatchNode*)                            {}
+        ));
+        report.addProperty("brushes", std::to_string(brushes.size()));
+        report.addProperty("entities", std::to_string(entityCount));
+
+        report.timeStage("initialize tags", [&]() {
+            tagManager.registerSmartTags(game->smartTags());
+            world->accept(kdl::overload(
+                [&](auto&& thisLambda, Model::WorldNode* world_)  { world_->initializeTags(tagManager); world_->visitChildren(thisLambda); },
+                [&](auto&& thisLambda, Model::LayerNode* layer)   { layer->initializeTags(tagManager); layer->visitChildren(thisLambda); },
+                [&](auto&& thisLambda, Model::GroupNode* group)   { group->initializeTags(tagManager); group->visitChildren(thisLambda); },
+                [&](auto&& thisLambda, Model::EntityNode* entity) { entity->initializeTags(tagManager); entity->visitChildren(thisLambda); },
+                [&](Model::BrushNode* brush)                      { brush->initializeTags(tagManager); },
+                [&](Model::PatchNode* patch)                      { patch->initializeTags(tagManager); }
+            ));
+        });
+
+        report.timeStage("load entity definitions", [&]() {
+            try {
+                const auto spec = game->extractEntityDefinitionFile(world->entity());
+                const auto path = game->findEntityDefinitionFile(spec, {game->gamePath()});
+                entityDefinitionManager.loadDefinitions(path, *game, status);
+            } catch (const Exception& e) {
+                logger.error() << e.what();
+            }
+
+            const auto setDefinition = [&](auto* node) {
+                node->setDefinition(entityDefinitionManager.definition(node));
+            };
+            world->accept(kdl::overload(
+                [=](auto&& thisLambda, Model::WorldNode* world_)  { setDefinition(world_); world_->visitChildren(thisLambda); },
+                [] (auto&& thisLambda, Model::LayerNode* layer)   { layer->visitChildren(thisLambda); },
+                [] (auto&& thisLambda, Model::GroupNode* group)   { group->visitChildren(thisLambda); },
+                [=](Model::EntityNode* entity)                    { setDefinition(entity); },
+                [] (Model::BrushNode*)                            {},
+                [] (Model::PatchNode*)                            {}
+            ));
+        });
+
+        report.timeStage("load entity models", [&]() {
+            entityModelManager.setLoader(game.get());
+            world->accept(kdl::overload(
+                [] (auto&& thisLambda, Model::WorldNode* world_)  { world_->visitChildren(thisLambda); },
+                [] (auto&& thisLambda, Model::LayerNode* layer)   { layer->visitChildren(thisLambda); },
+                [] (auto&& thisLambda, Model::GroupNode* group)   { group->visitChildren(thisLambda); },
+                [&](Model::EntityNode* entity) {
+                    const auto modelSpec = Assets::safeGetModelSpecification(logger, entity->entity().classname(), [&]() {
+                        return entity->entity().modelSpecification();
+                    });
+                    entity->setModelFrame(entityModelManager.frame(modelSpec));
+                },
+                [] (Model::BrushNode*)                            {},
+                [] (Model::PatchNode*)                            {}
+            ));
+        });
+
+        report.timeStage("load textures", [&]() {
+            try {
+                game->loadTextureCollections(world->entity(), mapDirectory, textureManager, logger);
+            } catch (const Exception& e) {
+                logger.error() << e.what();
+            }
+
+            for (auto* brushNode : brushes) {
+                const auto& brush = brushNode->brush();
+                for (size_t i = 0u; i < brush.faceCount(); ++i) {
+                    brushNode->setFaceTexture(i, textureManager.texture(brush.face(i).attributes().textureName()));
+                }
+            }
+        });
+
+        report.timeStage("validate issues", [&]() {
+            registerIssueGenerators(*world, game);
+            const auto issues = Model::validateAllIssues(*world);
+            report.addProperty("issues", std::to_string(issues.size()));
+        });
+
+        // Rendering the first frame requires an OpenGL context, so we only time the CPU side of it, which is
+        // dominated by building the brush vertex and index arrays.
+        auto brushRenderer = Renderer::BrushRenderer{};
+        report.timeStage("prepare first frame", [&]() {
+            brushRenderer.addBrushes(brushes);
+            brushRenderer.validate();
+        });
+    }
+
+    TEST_CASE("LoadMapBenchmark.loadMap", "[LoadMapBenchmark]") {
+        const auto mapPath = benchmarkMapPath();
+
+        auto report = BenchmarkReport{"LoadMapBenchmark." + mapPath.lastComponent().deleteExtension().asString()};
+        report.addProperty("map", mapPath.asString());
+
+        const auto file = IO::Disk::openFile(mapPath);
+        auto fileReader = file->reader().buffer();
+        benchmarkLoadMap(report, fileReader.stringView(), Model::MapFormat::Standard, mapPath.deleteLastComponent());
+
+        report.write();
+        CHECK(report.compareToBaseline());
+    }
+
+    TEST_CASE("LoadMapBenchmark.generatedMaps", "[LoadMapBenchmark]") {
+        // quadruple the map size in every step to show how the stages scale
+        for (size_t brushCount = 1024u; brushCount <= maxGeneratedBrushCount(); brushCount *= 4u) {
+            auto config = MapGeneratorConfig{};
+            config.worldBrushCount = brushCount;
+            config.pointEntityCount = brushCount / 16u;
+            config.brushEntityCount = brushCount / 64u;
+            config.brushesPerBrushEntity = 4u;
+            config.propertiesPerEntity = 4u;
+            config.linkedGroupCount = brushCount / 256u;
+            config.linkedGroupInstanceCount = 4u;
+            config.brushesPerLinkedGroup = 8u;
+            config.textureCount = 64u;
+
+            auto report = BenchmarkReport{"LoadMapBenchmark.generated" + std::to_string(brushCount)};
+            report.addProperty("faces", std::to_string(generatedFaceCount(config)));
+
+            const auto mapData = generateMap(config);
+            benchmarkLoadMap(report, mapData, config.format, IO::Disk::getCurrentWorkingDir() + IO::Path{"fixture/benchmark"});
+
+            report.write();
+            CHECK(report.compareToBaseline());
+        }
+    }
+}
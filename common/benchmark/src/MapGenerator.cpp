@@ -0,0 +1,352 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MapGenerator.h"
+
+#include "Exceptions.h"
+#include "Macros.h"
+
+#include <vecmath/constants.h>
+#include <vecmath/scalar.h>
+#include <vecmath/vec.h>
+
+#include <cmath>
+#include <ostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace TrenchBroom {
+    static constexpr auto WorldSize = 8000.0;
+    static constexpr auto MaxCellSize = 128.0;
+
+    static const std::vector<std::string> PointEntityClassnames = {
+        "light", "info_null", "info_player_deathmatch", "item_health", "weapon_nailgun", "monster_ogre"
+    };
+
+    static const std::vector<std::string> BrushEntityClassnames = {
+        "func_door", "func_wall", "func_detail", "trigger_multiple"
+    };
+
+    static size_t slotCount(const MapGeneratorConfig& config) {
+        return config.worldBrushCount
+            + config.pointEntityCount
+            + config.brushEntityCount * config.brushesPerBrushEntity
+            + config.linkedGroupCount * config.linkedGroupInstanceCount
+            + config.patchCount;
+    }
+
+    static size_t cubeRoot(const size_t count) {
+        auto side = size_t(1);
+        while (side * side * side < count) {
+            ++side;
+        }
+        return side;
+    }
+
+    size_t generatedBrushCount(const MapGeneratorConfig& config) {
+        return config.worldBrushCount
+            + config.brushEntityCount * config.brushesPerBrushEntity
+            + config.linkedGroupCount * config.linkedGroupInstanceCount * config.brushesPerLinkedGroup;
+    }
+
+    size_t generatedFaceCount(const MapGeneratorConfig& config) {
+        return generatedBrushCount(config) * config.facesPerBrush;
+    }
+
+    namespace {
+        /**
+         * Writes the objects of a generated map. Every point entity, brush entity brush, group instance and patch
+         * occupies its own cell of the grid, and the cells are handed out in the order in which the objects are
+         * written.
+         */
+        class MapGenerator {
+        private:
+            const MapGeneratorConfig& m_config;
+            std::ostream& m_str;
+            std::mt19937 m_random;
+            size_t m_gridSize;
+            double m_cellSize;
+            size_t m_nextSlot;
+        public:
+            MapGenerator(const MapGeneratorConfig& config, std::ostream& str) :
+            m_config(config),
+            m_str(str),
+            m_random(config.seed),
+            m_gridSize(cubeRoot(slotCount(config))),
+            m_cellSize(vm::min(MaxCellSize, std::floor(WorldSize / static_cast<double>(m_gridSize) / 2.0) * 2.0)),
+            m_nextSlot(0u) {}
+
+            void generate() {
+                writeWorldspawn();
+                writePointEntities();
+                writeBrushEntities();
+                writeLinkedGroups();
+            }
+        private:
+            void writeWorldspawn() {
+                m_str << "{\n";
+                writeProperty("classname", "worldspawn");
+                if (isValveFormat()) {
+                    writeProperty("mapversion", "220");
+                }
+                for (size_t i = 0u; i < m_config.worldBrushCount; ++i) {
+                    writeBrush(nextSlot(), m_cellSize);
+                }
+                if (isQuake3Format()) {
+                    for (size_t i = 0u; i < m_config.patchCount; ++i) {
+                        writePatch(nextSlot());
+                    }
+                }
+                m_str << "}\n";
+            }
+
+            void writePointEntities() {
+                for (size_t i = 0u; i < m_config.pointEntityCount; ++i) {
+                    const auto origin = nextSlot();
+                    m_str << "{\n";
+                    writeProperty("classname", randomElement(PointEntityClassnames));
+                    writeProperty("origin", vecString(origin));
+                    writeProperty("angle", std::to_string(45u * (m_random() % 8u)));
+                    writeRandomProperties();
+                    m_str << "}\n";
+                }
+            }
+
+            void writeBrushEntities() {
+                for (size_t i = 0u; i < m_config.brushEntityCount; ++i) {
+                    m_str << "{\n";
+                    writeProperty("classname", randomElement(BrushEntityClassnames));
+                    writeRandomProperties();
+                    for (size_t j = 0u; j < m_config.brushesPerBrushEntity; ++j) {
+                        writeBrush(nextSlot(), m_cellSize);
+                    }
+                    m_str << "}\n";
+                }
+            }
+
+            void writeLinkedGroups() {
+                // the brushes of a group share the group's cell
+                const auto subGridSize = cubeRoot(m_config.brushesPerLinkedGroup);
+                const auto subCellSize = m_cellSize / static_cast<double>(subGridSize);
+
+                auto groupId = size_t(1);
+                for (size_t i = 0u; i < m_config.linkedGroupCount; ++i) {
+                    auto firstOrigin = vm::vec3::zero();
+                    for (size_t j = 0u; j < m_config.linkedGroupInstanceCount; ++j) {
+                        const auto origin = nextSlot();
+                        if (j == 0u) {
+                            firstOrigin = origin;
+                        }
+
+                        m_str << "{\n";
+                        writeProperty("classname", "func_group");
+                        writeProperty("_tb_type", "_tb_group");
+                        writeProperty("_tb_name", "Group " + std::to_string(i + 1u) + "." + std::to_string(j + 1u));
+                        writeProperty("_tb_id", std::to_string(groupId++));
+                        writeProperty("_tb_linked_group_id", "linked_group_" + std::to_string(i + 1u));
+                        if (j > 0u) {
+                            const auto delta = origin - firstOrigin;
+                            std::stringstream transformation;
+                            transformation << "1 0 0 " << delta.x() << " 0 1 0 " << delta.y() << " 0 0 1 " << delta.z() << " 0 0 0 1";
+                            writeProperty("_tb_transformation", transformation.str());
+                        }
+
+                        // reset the random generator so that all instances of a group are textured alike
+                        m_random.seed(m_config.seed + static_cast<unsigned int>(i));
+                        const auto cellMin = origin - vm::vec3::fill(m_cellSize / 2.0);
+                        for (size_t k = 0u; k < m_config.brushesPerLinkedGroup; ++k) {
+                            const auto subCell = vm::vec3(
+                                static_cast<double>(k % subGridSize),
+                                static_cast<double>((k / subGridSize) % subGridSize),
+                                static_cast<double>(k / (subGridSize * subGridSize)));
+                            writeBrush(cellMin + (subCell + vm::vec3::fill(0.5)) * subCellSize, subCellSize);
+                        }
+                        m_str << "}\n";
+                    }
+                }
+            }
+
+            /**
+             * Writes a prism that is centered at the given point and fits into a cell of the given size.
+             */
+            void writeBrush(const vm::vec3& center, const double cellSize) {
+                const auto sideCount = m_config.facesPerBrush - 2u;
+                const auto radius = cellSize * 3.0 / 8.0;
+                const auto halfHeight = cellSize / 4.0;
+                const auto bottom = center.z() - halfHeight;
+                const auto top = center.z() + halfHeight;
+
+                // with four sides, the prism is an axis aligned box
+                const auto angleStep = 2.0 * vm::C::pi() / static_cast<double>(sideCount);
+                const auto vertex = [&](const size_t i, const double z) {
+                    const auto angle = (static_cast<double>(i) + 0.5) * angleStep;
+                    return vm::vec3(center.x() + radius * std::cos(angle), center.y() + radius * std::sin(angle), z);
+                };
+
+                m_str << "{\n";
+                for (size_t i = 0u; i < sideCount; ++i) {
+                    const auto p1 = vertex(i, bottom);
+                    const auto p3 = vertex(i + 1u, bottom);
+                    writeFace(p1, vm::vec3(p1.x(), p1.y(), top), p3);
+                }
+                writeFace(vm::vec3(center.x(), center.y(), top), vm::vec3(center.x(), center.y() + radius, top), vm::vec3(center.x() + radius, center.y(), top));
+                writeFace(vm::vec3(center.x(), center.y(), bottom), vm::vec3(center.x() + radius, center.y(), bottom), vm::vec3(center.x(), center.y() + radius, bottom));
+                m_str << "}\n";
+            }
+
+            /**
+             * Writes a face whose normal is (p3 - p1) x (p2 - p1).
+             */
+            void writeFace(const vm::vec3& p1, const vm::vec3& p2, const vm::vec3& p3) {
+                m_str << "( " << vecString(p1) << " ) ( " << vecString(p2) << " ) ( " << vecString(p3) << " ) " << randomTexture();
+
+                if (isValveFormat()) {
+                    const auto normal = vm::cross(p3 - p1, p2 - p1);
+                    const auto [uAxis, vAxis] = paraxialTextureAxes(normal);
+                    m_str << " [ " << vecString(uAxis) << " 0 ] [ " << vecString(vAxis) << " 0 ] 0 1 1";
+                } else {
+                    m_str << " 0 0 0 1 1";
+                }
+
+                if (hasSurfaceAttributes()) {
+                    m_str << " 0 0 0";
+                }
+                m_str << "\n";
+            }
+
+            void writePatch(const vm::vec3& center) {
+                const auto halfSize = m_cellSize * 3.0 / 8.0;
+                m_str << "{\npatchDef2\n{\n" << randomTexture() << "\n( 3 3 0 0 0 )\n(\n";
+                for (size_t row = 0u; row < 3u; ++row) {
+                    m_str << "( ";
+                    for (size_t column = 0u; column < 3u; ++column) {
+                        const auto x = center.x() + (static_cast<double>(row) - 1.0) * halfSize;
+                        const auto y = center.y() + (static_cast<double>(column) - 1.0) * halfSize;
+                        const auto z = center.z() + (row == 1u ? halfSize / 2.0 : 0.0);
+                        m_str << "( " << x << " " << y << " " << z << " " << static_cast<double>(row) / 2.0 << " " << static_cast<double>(column) / 2.0 << " ) ";
+                    }
+                    m_str << ")\n";
+                }
+                m_str << ")\n}\n}\n";
+            }
+
+            void writeProperty(const std::string& key, const std::string& value) {
+                m_str << "\"" << key << "\" \"" << value << "\"\n";
+            }
+
+            void writeRandomProperties() {
+                for (size_t i = 0u; i < m_config.propertiesPerEntity; ++i) {
+                    const auto length = 1u + m_random() % vm::max(m_config.propertyValueLength, size_t(1));
+                    auto value = std::string(length, ' ');
+                    for (auto& c : value) {
+                        c = static_cast<char>('a' + m_random() % 26u);
+                    }
+                    writeProperty("generated_key_" + std::to_string(i), value);
+                }
+            }
+
+            vm::vec3 nextSlot() {
+                const auto slot = m_nextSlot++;
+                const auto cell = vm::vec3(
+                    static_cast<double>(slot % m_gridSize),
+                    static_cast<double>((slot / m_gridSize) % m_gridSize),
+                    static_cast<double>(slot / (m_gridSize * m_gridSize)));
+                const auto gridMin = -static_cast<double>(m_gridSize) * m_cellSize / 2.0;
+                return vm::vec3::fill(gridMin) + (cell + vm::vec3::fill(0.5)) * m_cellSize;
+            }
+
+            std::string randomTexture() {
+                return "generated_" + std::to_string(m_random() % vm::max(m_config.textureCount, size_t(1)));
+            }
+
+            const std::string& randomElement(const std::vector<std::string>& elements) {
+                return elements[m_random() % elements.size()];
+            }
+
+            static std::string vecString(const vm::vec3& v) {
+                std::stringstream str;
+                str << v.x() << " " << v.y() << " " << v.z();
+                return str.str();
+            }
+
+            static std::tuple<vm::vec3, vm::vec3> paraxialTextureAxes(const vm::vec3& normal) {
+                const auto absNormal = vm::abs(normal);
+                if (absNormal.z() >= absNormal.x() && absNormal.z() >= absNormal.y()) {
+                    return {vm::vec3::pos_x(), vm::vec3::neg_y()};
+                } else if (absNormal.x() >= absNormal.y()) {
+                    return {vm::vec3::pos_y(), vm::vec3::neg_z()};
+                } else {
+                    return {vm::vec3::pos_x(), vm::vec3::neg_z()};
+                }
+            }
+
+            bool isValveFormat() const {
+                return m_config.format == Model::MapFormat::Valve
+                    || m_config.format == Model::MapFormat::Quake2_Valve
+                    || m_config.format == Model::MapFormat::Quake3_Valve;
+            }
+
+            bool isQuake3Format() const {
+                return m_config.format == Model::MapFormat::Quake3
+                    || m_config.format == Model::MapFormat::Quake3_Legacy
+                    || m_config.format == Model::MapFormat::Quake3_Valve;
+            }
+
+            bool hasSurfaceAttributes() const {
+                return m_config.format == Model::MapFormat::Quake2
+                    || m_config.format == Model::MapFormat::Quake2_Valve
+                    || isQuake3Format();
+            }
+        };
+    }
+
+    void generateMap(const MapGeneratorConfig& config, std::ostream& str) {
+        switch (config.format) {
+            case Model::MapFormat::Standard:
+            case Model::MapFormat::Quake2:
+            case Model::MapFormat::Quake2_Valve:
+            case Model::MapFormat::Valve:
+            case Model::MapFormat::Quake3:
+            case Model::MapFormat::Quake3_Legacy:
+            case Model::MapFormat::Quake3_Valve:
+                break;
+            case Model::MapFormat::Hexen2:
+            case Model::MapFormat::Daikatana:
+            case Model::MapFormat::Unknown:
+                throw Exception("Cannot generate maps in format " + Model::formatName(config.format));
+            switchDefault()
+        }
+
+        if (config.facesPerBrush < 5u) {
+            throw Exception("Generated brushes must have at least 5 faces");
+        }
+
+        MapGenerator(config, str).generate();
+    }
+
+    std::string generateMap(const MapGeneratorConfig& config) {
+        std::stringstream str;
+        generateMap(config, str);
+        return str.str();
+    }
+}
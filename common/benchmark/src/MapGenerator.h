@@ -0,0 +1,86 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Model/MapFormat.h"
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+namespace TrenchBroom {
+    /**
+     * Describes a synthetic map for benchmarks and stress tests.
+     *
+     * All brushes are prisms with facesPerBrush - 2 sides. The brushes, entities, group instances and patches are laid
+     * out on a cubic grid that is centered at the origin and fits into a world of size 8192. The grid cells shrink as
+     * the number of objects grows.
+     *
+     * The generated map only depends on the configuration, so the same configuration always yields the same map.
+     */
+    struct MapGeneratorConfig {
+        /**
+         * The generated face lines follow the given format. Patches are only generated for the Quake 3 formats.
+         */
+        Model::MapFormat format = Model::MapFormat::Standard;
+        size_t worldBrushCount = 1000u;
+        /** The number of faces of every brush, must be at least 5. */
+        size_t facesPerBrush = 6u;
+        size_t pointEntityCount = 0u;
+        size_t brushEntityCount = 0u;
+        size_t brushesPerBrushEntity = 1u;
+        /** The number of random properties added to every entity and group in addition to its classname. */
+        size_t propertiesPerEntity = 0u;
+        /** The maximum length of the values of the random properties. */
+        size_t propertyValueLength = 16u;
+        size_t linkedGroupCount = 0u;
+        size_t linkedGroupInstanceCount = 2u;
+        size_t brushesPerLinkedGroup = 1u;
+        size_t patchCount = 0u;
+        /** The number of distinct textures the faces and patches cycle through randomly. */
+        size_t textureCount = 16u;
+        unsigned int seed = 0u;
+    };
+
+    /**
+     * Returns the total number of brushes in a map generated from the given configuration.
+     */
+    size_t generatedBrushCount(const MapGeneratorConfig& config);
+
+    /**
+     * Returns the total number of brush faces in a map generated from the given configuration.
+     */
+    size_t generatedFaceCount(const MapGeneratorConfig& config);
+
+    /**
+     * Writes a map generated from the given configuration to the given stream.
+     *
+     * @throws Exception if the configuration is invalid or the map format is not supported
+     */
+    void generateMap(const MapGeneratorConfig& config, std::ostream& str);
+
+    /**
+     * Returns a map generated from the given configuration.
+     *
+     * @throws Exception if the configuration is invalid or the map format is not supported
+     */
+    std::string generateMap(const MapGeneratorConfig& config);
+}
@@ -0,0 +1,118 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "FloatType.h"
+#include "Model/Polyhedron.h"
+#include "Model/Polyhedron3.h"
+#include "Model/Polyhedron_Instantiation.h"
+
+#include <vecmath/constants.h>
+#include <vecmath/plane.h>
+#include <vecmath/vec.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "BenchmarkReport.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * Returns the given number of points evenly distributed on a sphere with the given radius around the given
+         * center. Their convex hull resembles a brush with many faces, such as a cylinder or a sphere built by a
+         * mapper.
+         */
+        static std::vector<vm::vec3> spherePoints(const size_t count, const FloatType radius, const vm::vec3& center) {
+            const auto goldenAngle = vm::C::pi() * (3.0 - std::sqrt(5.0));
+
+            auto result = std::vector<vm::vec3>{};
+            result.reserve(count);
+            for (size_t i = 0u; i < count; ++i) {
+                const auto z = 1.0 - 2.0 * (static_cast<FloatType>(i) + 0.5) / static_cast<FloatType>(count);
+                const auto r = std::sqrt(1.0 - z * z);
+                const auto phi = goldenAngle * static_cast<FloatType>(i);
+
+                // round to integers, as the vertices of most brushes are on the grid
+                result.push_back(vm::round(center + radius * vm::vec3(r * std::cos(phi), r * std::sin(phi), z)));
+            }
+            return result;
+        }
+
+        TEST_CASE("PolyhedronBenchmark.operations", "[PolyhedronBenchmark]") {
+            constexpr auto Radius = 256.0;
+
+            for (const auto pointCount : {8u, 32u, 128u, 512u}) {
+                auto report = BenchmarkReport{"PolyhedronBenchmark." + std::to_string(pointCount)};
+                report.addProperty("points", std::to_string(pointCount));
+
+                const auto points = spherePoints(pointCount, Radius, vm::vec3::zero());
+                const auto otherPoints = spherePoints(pointCount, Radius, vm::vec3(Radius, Radius / 2.0, 0.0));
+                const auto movedPoints = spherePoints(pointCount, Radius + 16.0, vm::vec3::zero());
+
+                const auto polyhedron = Polyhedron3(points);
+                const auto other = Polyhedron3(otherPoints);
+                REQUIRE(polyhedron.polyhedron());
+                REQUIRE(other.polyhedron());
+                report.addProperty("faces", std::to_string(polyhedron.faceCount()));
+
+                for (size_t run = 0u; run < BenchmarkReport::runs(); ++run) {
+                    report.timeStage("build convex hull", [&]() {
+                        return Polyhedron3(points);
+                    });
+
+                    report.timeStage("add points", [&]() {
+                        auto result = Polyhedron3{};
+                        result.addPoints(points);
+                        return result;
+                    });
+
+                    report.timeStage("copy", [&]() {
+                        return Polyhedron3(polyhedron);
+                    });
+
+                    // moving vertices rebuilds the hull from the moved vertex positions
+                    report.timeStage("move vertices", [&]() {
+                        return Polyhedron3(movedPoints);
+                    });
+
+                    auto clipped = polyhedron;
+                    report.timeStage("clip", [&]() {
+                        for (const auto& normal : {vm::vec3::pos_x(), vm::vec3::pos_y(), vm::normalize(vm::vec3(1.0, 1.0, 1.0))}) {
+                            clipped.clip(vm::plane3(Radius / 2.0, normal));
+                        }
+                    });
+
+                    report.timeStage("intersect", [&]() {
+                        return polyhedron.intersect(other);
+                    });
+
+                    report.timeStage("subtract", [&]() {
+                        return polyhedron.subtract(other);
+                    });
+                }
+
+                report.write();
+                CHECK(report.compareToBaseline());
+            }
+        }
+    }
+}
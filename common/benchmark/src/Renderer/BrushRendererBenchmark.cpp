@@ -34,8 +34,9 @@
 #include <string>
 #include <tuple>
 #include <algorithm>
+#include <cstdio>
 
-#include "BenchmarkUtils.h"
+#include "BenchmarkReport.h"
 #include "../../test/src/Catch2.h"
 
 namespace TrenchBroom {
@@ -82,32 +83,22 @@ namespace TrenchBroom {
             return {result, textures};
         }
 
+        static void printStatistics(const std::string& name, const AllocationTracker::Statistics& stats) {
+            printf("%s: capacity %zu, used %zu in %zu blocks, free %zu in %zu blocks, fragmentation %.2f\n",
+                   name.c_str(), stats.capacity, stats.usedSize, stats.usedBlockCount, stats.freeSize,
+                   stats.freeBlockCount, stats.fragmentation());
+        }
+
         TEST_CASE("BrushRendererBenchmark.benchBrushRenderer", "[BrushRendererBenchmark]") {
             auto brushesTextures = makeBrushes();
             std::vector<Model::BrushNode*> brushes = brushesTextures.first;
             std::vector<Assets::Texture*> textures = brushesTextures.second;
 
-            BrushRenderer r;
-
-            timeLambda([&](){ r.addBrushes(brushes); }, "add " + std::to_string(brushes.size()) + " brushes to BrushRenderer");
-            timeLambda([&](){
-                if (!r.valid()) {
-                    r.validate();
-                }
-            }, "validate after adding " + std::to_string(brushes.size()) + " brushes to BrushRenderer");
-
             // Tiny change: remove the last brush
             std::vector<Model::BrushNode*> brushesMinusOne = brushes;
             assert(!brushesMinusOne.empty());
             brushesMinusOne.pop_back();
 
-            timeLambda([&](){ r.setBrushes(brushesMinusOne); }, "setBrushes to " + std::to_string(brushesMinusOne.size()) + " (removing one)");
-            timeLambda([&](){
-                if (!r.valid()) {
-                    r.validate();
-                }
-            }, "validate after removing one brush");
-
             // Large change: keep every second brush
             std::vector<Model::BrushNode*> brushesToKeep;
             for (size_t i = 0; i < brushes.size(); ++i) {
@@ -116,15 +107,42 @@ namespace TrenchBroom {
                 }
             }
 
-            timeLambda([&](){ r.setBrushes(brushesToKeep); },
-                       "set brushes from " + std::to_string(brushes.size()) +
-                       " to " + std::to_string(brushesToKeep.size()));
+            auto report = BenchmarkReport{"BrushRendererBenchmark.benchBrushRenderer"};
+            report.addProperty("brushes", std::to_string(brushes.size()));
+            report.addProperty("textures", std::to_string(textures.size()));
+
+            for (size_t run = 0u; run < BenchmarkReport::runs(); ++run) {
+                BrushRenderer r;
+
+                report.timeStage("add brushes", [&](){ r.addBrushes(brushes); });
+                report.timeStage("validate after adding brushes", [&](){
+                    if (!r.valid()) {
+                        r.validate();
+                    }
+                });
+
+                report.timeStage("remove one brush", [&](){ r.setBrushes(brushesMinusOne); });
+                report.timeStage("validate after removing one brush", [&](){
+                    if (!r.valid()) {
+                        r.validate();
+                    }
+                });
+
+                report.timeStage("keep every second brush", [&](){ r.setBrushes(brushesToKeep); });
+                report.timeStage("validate after keeping every second brush", [&](){
+                    if (!r.valid()) {
+                        r.validate();
+                    }
+                });
+
+                if (run == 0u) {
+                    printStatistics("vertices", r.vertexStatistics());
+                    printStatistics("indices", r.indexStatistics());
+                }
+            }
 
-            timeLambda([&](){
-                           if (!r.valid()) {
-                               r.validate();
-                           }
-                       }, "validate with " + std::to_string(brushesToKeep.size()) + " brushes");
+            report.write();
+            CHECK(report.compareToBaseline());
 
             kdl::vec_clear_and_delete(brushes);
             kdl::vec_clear_and_delete(textures);
@@ -25,20 +25,33 @@
 #include <vecmath/bbox.h>
 #include <vecmath/bbox_io.h>
 #include <vecmath/ray.h>
-#include <vecmath/intersection.h>
 
 #include <cassert>
-#include <iosfwd>
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
 /**
  * An axis aligned bounding box tree that allows for quick ray intersection queries.
  *
+ * The nodes of the tree are stored in a single array and reference each other by index, and the traversals use an
+ * explicit stack, so queries do not dereference any node pointers or perform any virtual calls. When the tree is
+ * built from scratch using clearAndBuild, the nodes are partitioned using the surface area heuristic and stored in
+ * depth first order, so that a node's left child immediately follows it in memory. Nodes can still be inserted and
+ * removed incrementally afterwards.
+ *
  * @tparam T the floating point type
  * @tparam S the number of dimensions for vector types
- * @tparam U the node data to store in the leafs
+ * @tparam U the node data to store in the leafs, must be default constructible
  */
     template <typename T, size_t S, typename U>
     class AABBTree {
@@ -49,427 +62,92 @@ namespace TrenchBroom {
         using FloatType = T;
         static constexpr size_t Components = S;
     private:
-        class InnerNode;
-        class LeafNode;
-
-        class Visitor {
-        public:
-            virtual ~Visitor() = default;
-
-            virtual bool visit(const InnerNode* innerNode) = 0;
-            virtual void visit(const LeafNode* leaf) = 0;
-        };
-
-        template <typename I_V, typename L_V>
-        class LambdaVisitor : public Visitor {
-        private:
-            I_V m_innerNodeVisitor;
-            L_V m_leafNodeVisitor;
-        public:
-            LambdaVisitor(I_V innerNodeVisitor, L_V leafNodeVisitor) :
-                m_innerNodeVisitor(std::move(innerNodeVisitor)),
-                m_leafNodeVisitor(std::move(leafNodeVisitor)) {}
+        using NodeIndex = size_t;
+        static constexpr NodeIndex InvalidIndex = std::numeric_limits<NodeIndex>::max();
 
-            bool visit(const InnerNode* innerNode) override { return m_innerNodeVisitor(innerNode); }
-            void visit(const LeafNode* leafNode)   override { m_leafNodeVisitor(leafNode); }
-        };
-
-#if !defined __GNUC__ || defined __clang__
         /**
-         * Deduction guide.
-         *
-         * Note that as of GCC 9.2, there appears to be a bug in GCC that disallows deduction guides in non-namespace scope.
-         * Luckily, GCC does not need a guide to deduce the template parameters of LambdaVisitor, but clang does!
+         * The number of bins per axis that are used to evaluate the surface area heuristic when building the tree.
          */
-        template <typename I_V, typename L_V>
-        LambdaVisitor(I_V innerNodeVisitor, L_V outerNodeVisitor) -> LambdaVisitor<I_V, L_V>;
-#endif
-
-        class Node {
-        public:
-            Box m_bounds;
-            InnerNode* m_parent;
-        protected:
-            explicit Node(const Box& bounds) :
-                m_bounds(bounds),
-                m_parent(nullptr) {}
-        public:
-            virtual ~Node() = default;
-
-            /**
-             * Return the bounds of this node.
-             *
-             * @return the bounds
-             */
-            const Box& bounds() const {
-                return m_bounds;
-            }
-
-            /**
-             * Return the height of this node. A leaf always has a height of 1, and an inner node has a height equal to the
-             * maximum of the heights of its children plus one.
-             *
-             * @return the height
-             */
-            virtual size_t height() const = 0;
-
-            /**
-             * Inserts a new node into the subtree rooted at `this`.
-             *
-             * @param bounds the bounds of the data to be inserted
-             * @param data the data to be inserted
-             * @return a pair containing the new subtree root (may be `this`, or a new node), and the newly inserted LeafNode
-             */
-            virtual std::pair<Node*, LeafNode*> insert(const Box& bounds, const U& data) = 0;
-
-            /**
-             * Accepts the given visitor.
-             *
-             * @param visitor the visitor to accept
-             */
-            virtual void accept(Visitor& visitor) const = 0;
-        public:
-            /**
-             * Appends a textual representation of this node to the given output stream.
-             *
-             * @param str the stream to append to
-             */
-            void appendTo(std::ostream& str) const {
-                appendTo(str, "  ", 0);
-            }
-
-            /**
-             * Appends a textual representation of this node to the given output stream using the given indent string and
-             * the given level of indentation.
-             *
-             * @param str the stream to append to
-             * @param indent the indent string
-             * @param level the level of indentation
-             */
-            virtual void appendTo(std::ostream& str, const std::string& indent, size_t level) const = 0;
-
-            virtual void checkParentPointers(const Node* expectedParent) const = 0;
-        protected:
-            /**
-             * Updates the bounds of this node.
-             *
-             * @param bounds the new bounds
-             */
-            void setBounds(const Box& bounds) {
-                m_bounds = bounds;
-            }
-
-            /**
-             * Appends a textual representation of this node's bounds to the given output stream.
-             *
-             * @param str the stream to append to
-             */
-            void appendBounds(std::ostream& str) const {
-                str << "[ ( " << m_bounds.min << " ) ( " << m_bounds.max  << " ) ]";
-            }
-        };
+        static constexpr size_t BinCount = 16;
 
         /**
-         * An inner node of an AABB tree does not carry data. It's only purpose is to structure the tree. Its bounds is
-         * the smallest bounding box that contains the bounds of its children.
+         * Tests many boxes against the same ray using the slab method. The reciprocal of the ray direction is
+         * computed once per query, so that each box test takes only multiplications and min / max operations.
+         * Axes along which the ray does not move are tested separately, since the slab method would compute NaN
+         * distances for them if the origin lies on a slab boundary.
+         *
+         * A box is hit if the ray starts inside of it or if the ray intersects it at a non-negative distance.
          */
-        class InnerNode : public Node {
+        class RayQuery {
         private:
-            Node* m_left;
-            Node* m_right;
-            size_t m_height;
+            vm::vec<T,S> m_origin;
+            vm::vec<T,S> m_invDirection;
+            std::array<bool,S> m_parallel;
         public:
-            InnerNode(Node* left, Node* right) :
-                Node(merge(left->bounds(), right->bounds())),
-                m_left(left),
-                m_right(right),
-                m_height(0) {
-                assert(m_left != nullptr);
-                assert(m_right != nullptr);
-
-                m_left->m_parent = this;
-                m_right->m_parent = this;
-
-                updateHeight();
-            }
-
-        private: // node removal private
-            /**
-             * Children (or grandchildren etc.) changed. Update the height and bounds.
-             * Recurses up the tree along the m_parent chain until it reaches the root.
-             *
-             * @return the new root of the tree
-             */
-            Node* updateAndReturnRoot() {
-                updateHeight();
-                updateBounds();
-
-                if (this->m_parent == nullptr) {
-                    return this;
-                }
-
-                return this->m_parent->updateAndReturnRoot();
-            }
-
-            /**
-             * One of our direct children is being swapped for a new node.
-             *
-             * @return the new root of the tree
-             */
-            Node* replaceChild(Node* child, Node* replacement) {
-                replacement->m_parent = this;
-
-                if (child == m_left) {
-                    m_left = replacement;
-                } else {
-                    assert(child == m_right);
-                    m_right = replacement;
-                }
-
-                return updateAndReturnRoot();
-            }
-        public: // Node removal public
-            /**
-             * One of our direct children is being deleted. `this` will turn into a LeafNode.
-             *
-             * @param child either m_left or m_right, which is being deleted
-             * @return the new root of the tree
-             */
-            Node* handleChildDeletion(LeafNode* child) {
-                Node* replacementForThis;
-                if (child == m_left) {
-                    replacementForThis = m_right;
-                } else {
-                    assert(child == m_right);
-                    replacementForThis = m_left;
-                }
-
-                // Clear m_left/m_right so our destructor doesn't delete our children.
-                // The caller is going to delete one of them (`child`),
-                // and we will reuse the other one as the replacement for `this`.
-                m_left = nullptr;
-                m_right = nullptr;
-
-                // Special case when `this` is already the tree root
-                if (this->m_parent == nullptr) {
-                    Node* newTreeRoot = replacementForThis;
-                    newTreeRoot->m_parent = nullptr;
-                    delete this;
-                    return newTreeRoot;
-                }
-
-                Node* newTreeRoot = this->m_parent->replaceChild(this, replacementForThis);
-                delete this;
-                return newTreeRoot;
-            }
-
-        public: // Node overrides
-            ~InnerNode() override {
-                delete m_left;
-                delete m_right;
-            }
-
-            size_t height() const override {
-                return m_height;
-            }
-
-            std::pair<Node*, LeafNode*> insert(const Box& bounds, const U& data) override {
-                // Select the subtree which is increased the least by inserting a node with the given bounds.
-                // Then insert the node into that subtree and update our reference to it.
-                auto*& subtree = selectLeastIncreaser(m_left, m_right, bounds);
-
-                Node* newSubtree;
-                LeafNode* insertedLeafNode;
-                std::tie(newSubtree, insertedLeafNode) = subtree->insert(bounds, data);
-
-                // Update the parent pointer
-                newSubtree->m_parent = this;
-
-                // Subtree is either a reference to m_left or m_right
-                if (subtree == m_left) {
-                    m_left = newSubtree;
-                } else {
-                    assert(subtree == m_right);
-                    m_right = newSubtree;
+            explicit RayQuery(const vm::ray<T,S>& ray) :
+            m_origin(ray.origin) {
+                for (size_t i = 0; i < S; ++i) {
+                    m_parallel[i] = ray.direction[i] == static_cast<T>(0);
+                    m_invDirection[i] = m_parallel[i] ? static_cast<T>(0) : static_cast<T>(1) / ray.direction[i];
                 }
-
-                // Update our data.
-                updateBounds();
-                updateHeight();
-
-                return std::make_pair(this, insertedLeafNode);
             }
 
-        private:
-            /**
-             * Selects one of the two given nodes such that it increases the given bounds the least.
-             *
-             * @tparam TT the type of the nodes
-             * @param node1 the first node to test
-             * @param node2 the second node to test
-             * @param bounds the bounds to test against
-             * @return node1 if it increases the given bounds volume by a smaller or equal amount than node2 would, and
-             *     node2 otherwise
-             */
-            template <typename TT>
-            static TT*& selectLeastIncreaser(TT*& node1, TT*& node2, const Box& bounds) {
-                const auto node1Contains = node1->bounds().contains(bounds);
-                const auto node2Contains = node2->bounds().contains(bounds);
-
-                if (node1Contains && !node2Contains) {
-                    return node1;
-                } else if (!node1Contains && node2Contains) {
-                    return node2;
-                } else if (!node1Contains && !node2Contains) {
-                    const auto new1 = vm::merge(node1->bounds(), bounds);
-                    const auto new2 = vm::merge(node2->bounds(), bounds);
-                    const auto vol1 = node1->bounds().volume();
-                    const auto vol2 = node2->bounds().volume();
-                    const auto diff1 = new1.volume() - vol1;
-                    const auto diff2 = new2.volume() - vol2;
-
-                    if (diff1 < diff2) {
-                        return node1;
-                    } else if (diff2 < diff1) {
-                        return node2;
-                    }
-                }
-
-                static auto choice = 0u;
-
-                if (node1->height() < node2->height()) {
-                    return node1;
-                } else if (node2->height() < node1->height()) {
-                    return node2;
-                } else {
-                    if (choice++ % 2 == 0) {
-                        return node1;
+            bool intersects(const Box& box) const {
+                auto tMin = static_cast<T>(0);
+                auto tMax = std::numeric_limits<T>::infinity();
+                for (size_t i = 0; i < S; ++i) {
+                    if (m_parallel[i]) {
+                        // the ray is parallel to the slab, so it is either within the slab everywhere or nowhere
+                        if (m_origin[i] < box.min[i] || m_origin[i] > box.max[i]) {
+                            return false;
+                        }
                     } else {
-                        return node2;
+                        const auto t1 = (box.min[i] - m_origin[i]) * m_invDirection[i];
+                        const auto t2 = (box.max[i] - m_origin[i]) * m_invDirection[i];
+                        tMin = std::max(tMin, std::min(t1, t2));
+                        tMax = std::min(tMax, std::max(t1, t2));
                     }
                 }
-            }
-
-            void updateBounds() {
-                this->setBounds(merge(m_left->bounds(), m_right->bounds()));
-            }
-
-            void updateHeight() {
-                m_height = std::max(m_left->height(), m_right->height()) + 1;
-                assert(m_height > 0);
-            }
-
-            void accept(Visitor& visitor) const override {
-                if (visitor.visit(this)) {
-                    m_left->accept(visitor);
-                    m_right->accept(visitor);
-                }
-            }
-        public:
-            void appendTo(std::ostream& str, const std::string& indent, const size_t level) const override {
-                for (size_t i = 0; i < level; ++i)
-                    str << indent;
-
-                str << "O ";
-                this->appendBounds(str);
-                str << std::endl;
-
-                m_left->appendTo(str, indent, level + 1);
-                m_right->appendTo(str, indent, level + 1);
-            }
-
-            void checkParentPointers([[maybe_unused]] const Node* expectedParent) const override {
-                assert(this->m_parent == expectedParent);
-                m_left->checkParentPointers(this);
-                m_left->checkParentPointers(this);
+                return tMin <= tMax;
             }
         };
 
         /**
-         * A leaf node represents actual data. It does not have any children. Its bounds equals the bounds supplied when
-         * the node was inserted into the tree. A leaf has a height of 1 and a balance of 0.
+         * A node of the tree. An inner node does not carry data. It's only purpose is to structure the tree. Its bounds
+         * is the smallest bounding box that contains the bounds of its children, and its height is the maximum of the
+         * heights of its children plus one.
+         *
+         * A leaf node represents actual data. It does not have any children, its bounds equals the bounds supplied when
+         * the node was inserted into the tree and its height is always 1.
          */
-        class LeafNode : public Node {
-        private:
-            U m_data;
-        public:
-            LeafNode(const Box& bounds, const U& data) : Node(bounds), m_data(data) {}
-
-            /**
-             * Deletes this. Returns the new root of the tree.
-             */
-            Node* deleteThis() {
-                Node* newRoot = (this->m_parent != nullptr)
-                                ? this->m_parent->handleChildDeletion(this)
-                                : nullptr;
-                delete this;
-                return newRoot;
-            }
-
-            /**
-             * Returns the data associated with this node.
-             *
-             * @return the data associated with this node
-             */
-            U& data() {
-                return m_data;
-            }
-
-            /**
-             * Returns the data associated with this node.
-             *
-             * @return the data associated with this node
-             */
-            const U& data() const {
-                return m_data;
-            }
-
-        public: // Node overrides
-            size_t height() const override {
-                return 1;
-            }
-
-            /**
-             * Returns a new inner node that has this leaf as its left child and a new leaf representing the given bounds
-             * and data as its right child.
-             *
-             * @param bounds the bounds to insert
-             * @param data the data to insert
-             * @return a pair containing the new inner node that is the root of this subtree, and the newly inserted LeafNode
-             */
-            std::pair<Node*, LeafNode*> insert(const Box& bounds, const U& data) override {
-                auto* newLeaf = new LeafNode(bounds, data);
-                auto* newParent = new InnerNode(this, newLeaf);
-
-                return std::make_pair(newParent, newLeaf);
-            }
-
-            void accept(Visitor& visitor) const override {
-                visitor.visit(this);
-            }
-
-            void appendTo(std::ostream& str, const std::string& indent, const size_t level) const override {
-                for (size_t i = 0; i < level; ++i)
-                    str << indent;
+        struct Node {
+            Box bounds;
+            NodeIndex parent;
+            NodeIndex left;
+            NodeIndex right;
+            size_t height;
+            U data;
 
-                str << "L ";
-                this->appendBounds(str);
-                str << ": " << m_data << std::endl;
+            bool isLeaf() const {
+                return left == InvalidIndex;
             }
+        };
 
-            virtual void checkParentPointers([[maybe_unused]] const Node* expectedParent) const override {
-                assert(this->m_parent == expectedParent);
-            }
+        /**
+         * An object to be inserted when building the tree from scratch.
+         */
+        struct BuildItem {
+            Box bounds;
+            vm::vec<T,S> center;
+            U data;
         };
-    private:
-        Node* m_root;
-        std::unordered_map<U, LeafNode*> m_leafForData;
-    public:
-        AABBTree() : m_root(nullptr) {}
 
-        ~AABBTree() {
-            clear();
-        }
+        std::vector<Node> m_nodes;
+        std::vector<NodeIndex> m_freeNodes;
+        NodeIndex m_root;
+        std::unordered_map<U, NodeIndex> m_leafForData;
+    public:
+        AABBTree() : m_root(InvalidIndex) {}
 
         /**
          * Indicates whether a node with the given data exists in this tree.
@@ -483,16 +161,36 @@ namespace TrenchBroom {
         }
 
         /**
-         * Clears this tree and rebuilds it by inserting given objects.
+         * Clears this tree and rebuilds it from the given objects.
+         *
+         * The tree is built top down. Each range of objects is split such that the expected cost of a ray query
+         * according to the surface area heuristic is minimized, which yields a much better tree than inserting the
+         * objects one by one.
          *
          * @param objects the objects to insert, a list of DataType
          * @param getBounds a function from DataType -> Box to compute the bounds of each object
+         *
+         * @throws NodeTreeException if the given objects contain duplicates, or any bounds contains NaN
          */
         template <typename DataList, typename GetBounds>
         void clearAndBuild(const DataList& objects, GetBounds&& getBounds) {
             clear();
+
+            auto items = std::vector<BuildItem>{};
             for (const U& object : objects) {
-                insert(getBounds(object), object);
+                const Box bounds = getBounds(object);
+                check(bounds);
+                items.push_back(BuildItem{bounds, bounds.center(), object});
+            }
+
+            if (!items.empty()) {
+                m_nodes.reserve(2 * items.size() - 1);
+                try {
+                    m_root = build(items, 0, items.size(), InvalidIndex);
+                } catch (...) {
+                    clear();
+                    throw;
+                }
             }
         }
 
@@ -513,16 +211,88 @@ namespace TrenchBroom {
             }
 
             if (empty()) {
-                auto* insertedLeafNode = new LeafNode(bounds, data);
+                m_root = createLeaf(bounds, data, InvalidIndex);
+                return;
+            }
+
+            // Descend into the subtree which is increased the least by inserting a node with the given bounds until
+            // we reach a leaf.
+            auto sibling = m_root;
+            while (!m_nodes[sibling].isLeaf()) {
+                const auto& node = m_nodes[sibling];
+                sibling = selectLeastIncreaser(node.left, node.right, bounds);
+            }
 
-                m_root = insertedLeafNode;
-                m_leafForData[data] = insertedLeafNode;
+            // Replace the leaf by a new inner node that has the leaf as its left child and a new leaf representing the
+            // given bounds and data as its right child.
+            const auto oldParent = m_nodes[sibling].parent;
+            const auto newParent = allocateNode();
+            const auto newLeaf = createLeaf(bounds, data, newParent);
+
+            auto& parentNode = m_nodes[newParent];
+            parentNode.parent = oldParent;
+            parentNode.left = sibling;
+            parentNode.right = newLeaf;
+            m_nodes[sibling].parent = newParent;
+
+            if (oldParent == InvalidIndex) {
+                m_root = newParent;
             } else {
-                LeafNode* insertedLeafNode;
-                std::tie(m_root, insertedLeafNode) = m_root->insert(bounds, data);
+                replaceChild(oldParent, sibling, newParent);
+            }
+
+            updateAncestors(newParent);
+        }
 
-                m_leafForData[data] = insertedLeafNode;
+        /**
+         * Inserts nodes for the given objects into this tree.
+         *
+         * If only a few objects are inserted into a larger tree, they are inserted one by one. Otherwise, the entire
+         * tree is rebuilt once from the existing leaves and the new objects, which is much faster than inserting every
+         * object individually and yields a better tree.
+         *
+         * @param objects the objects to insert, a list of DataType
+         * @param getBounds a function from DataType -> Box to compute the bounds of each object
+         *
+         * @throws NodeTreeException if any of the given objects is already in this tree or occurs more than once, or
+         * any bounds contains NaN; if an exception is thrown, none of the objects are inserted
+         */
+        template <typename DataList, typename GetBounds, typename = std::enable_if_t<std::is_invocable_v<GetBounds, const U&>>>
+        void insert(const DataList& objects, GetBounds&& getBounds) {
+            auto newItems = std::vector<BuildItem>{};
+            auto newData = std::unordered_set<U>{};
+            for (const U& object : objects) {
+                if (m_leafForData.find(object) != m_leafForData.end() || !newData.insert(object).second) {
+                    throw NodeTreeException("Data already in tree");
+                }
+
+                const Box bounds = getBounds(object);
+                check(bounds);
+                newItems.push_back(BuildItem{bounds, bounds.center(), object});
+            }
+
+            if (newItems.empty()) {
+                return;
+            }
+
+            if (newItems.size() < m_leafForData.size() / 4u) {
+                for (const auto& item : newItems) {
+                    insert(item.bounds, item.data);
+                }
+                return;
             }
+
+            auto items = std::vector<BuildItem>{};
+            items.reserve(m_leafForData.size() + newItems.size());
+            for (const auto& [data, leaf] : m_leafForData) {
+                const auto& bounds = m_nodes[leaf].bounds;
+                items.push_back(BuildItem{bounds, bounds.center(), data});
+            }
+            items.insert(std::end(items), std::begin(newItems), std::end(newItems));
+
+            clear();
+            m_nodes.reserve(2 * items.size() - 1);
+            m_root = build(items, 0, items.size(), InvalidIndex);
         }
 
         /**
@@ -537,11 +307,31 @@ namespace TrenchBroom {
                 return false;
             }
 
-            LeafNode* leaf = it->second;
-            assert(leaf->data() == data);
+            const auto leaf = it->second;
+            assert(m_nodes[leaf].data == data);
             m_leafForData.erase(it);
 
-            m_root = leaf->deleteThis();
+            const auto parent = m_nodes[leaf].parent;
+            freeNode(leaf);
+
+            if (parent == InvalidIndex) {
+                m_root = InvalidIndex;
+                return true;
+            }
+
+            // The parent turns into a leaf, so it is replaced by the other child.
+            const auto& parentNode = m_nodes[parent];
+            const auto sibling = parentNode.left == leaf ? parentNode.right : parentNode.left;
+            const auto grandParent = parentNode.parent;
+            freeNode(parent);
+
+            m_nodes[sibling].parent = grandParent;
+            if (grandParent == InvalidIndex) {
+                m_root = sibling;
+            } else {
+                replaceChild(grandParent, parent, sibling);
+                updateAncestors(grandParent);
+            }
 
             return true;
         }
@@ -562,22 +352,325 @@ namespace TrenchBroom {
             }
             insert(newBounds, data);
         }
+
+        /**
+         * Updates the nodes with the given data with their new bounds.
+         *
+         * If only a small part of the tree is affected, the nodes are reinserted one by one. Otherwise, the changed
+         * leaves are refitted to their new bounds and the entire tree is rebuilt once, which is much faster than
+         * reinserting every node and yields a better tree.
+         *
+         * @param objects the data of the nodes to update, a list of DataType
+         * @param getBounds a function from DataType -> Box to compute the new bounds of each object
+         *
+         * @throws NodeTreeException if no node with any of the given data can be found in this tree, or any bounds
+         * contains NaN; if an exception is thrown, none of the nodes are updated
+         */
+        template <typename DataList, typename GetBounds>
+        void update(const DataList& objects, GetBounds&& getBounds) {
+            auto changedLeaves = std::vector<std::pair<NodeIndex, Box>>{};
+            for (const U& object : objects) {
+                const auto it = m_leafForData.find(object);
+                if (it == m_leafForData.end()) {
+                    throw NodeTreeException("AABB node not found");
+                }
+
+                const Box bounds = getBounds(object);
+                check(bounds);
+                changedLeaves.emplace_back(it->second, bounds);
+            }
+
+            if (changedLeaves.size() < m_leafForData.size() / 4u) {
+                for (const auto& [leaf, bounds] : changedLeaves) {
+                    const U data = m_nodes[leaf].data;
+                    remove(data);
+                    insert(bounds, data);
+                }
+                return;
+            }
+
+            for (const auto& [leaf, bounds] : changedLeaves) {
+                m_nodes[leaf].bounds = bounds;
+            }
+
+            auto items = std::vector<BuildItem>{};
+            items.reserve(m_leafForData.size());
+            for (const auto& [data, leaf] : m_leafForData) {
+                const auto& bounds = m_nodes[leaf].bounds;
+                items.push_back(BuildItem{bounds, bounds.center(), data});
+            }
+
+            clear();
+            if (!items.empty()) {
+                m_nodes.reserve(2 * items.size() - 1);
+                m_root = build(items, 0, items.size(), InvalidIndex);
+            }
+        }
     private:
         void check(const Box& bounds) const {
             if (vm::is_nan(bounds.min) || vm::is_nan(bounds.max)) {
                 throw NodeTreeException("Cannot add node to AABB tree with invalid bounds");
             }
         }
+
+        NodeIndex allocateNode() {
+            if (!m_freeNodes.empty()) {
+                const auto index = m_freeNodes.back();
+                m_freeNodes.pop_back();
+                return index;
+            }
+
+            m_nodes.emplace_back();
+            return m_nodes.size() - 1;
+        }
+
+        void freeNode(const NodeIndex index) {
+            m_nodes[index] = Node{};
+            m_freeNodes.push_back(index);
+        }
+
+        NodeIndex createLeaf(const Box& bounds, const U& data, const NodeIndex parent) {
+            if (!m_leafForData.emplace(data, InvalidIndex).second) {
+                throw NodeTreeException("Data already in tree");
+            }
+
+            const auto index = allocateNode();
+            m_nodes[index] = Node{bounds, parent, InvalidIndex, InvalidIndex, 1, data};
+            m_leafForData[data] = index;
+            return index;
+        }
+
+        void replaceChild(const NodeIndex parent, const NodeIndex child, const NodeIndex replacement) {
+            auto& parentNode = m_nodes[parent];
+            if (parentNode.left == child) {
+                parentNode.left = replacement;
+            } else {
+                assert(parentNode.right == child);
+                parentNode.right = replacement;
+            }
+        }
+
+        /**
+         * Updates the bounds and height of the given inner node and all of its ancestors.
+         */
+        void updateAncestors(NodeIndex index) {
+            while (index != InvalidIndex) {
+                auto& node = m_nodes[index];
+                const auto& left = m_nodes[node.left];
+                const auto& right = m_nodes[node.right];
+
+                node.bounds = vm::merge(left.bounds, right.bounds);
+                node.height = std::max(left.height, right.height) + 1;
+                index = node.parent;
+            }
+        }
+
+        /**
+         * Selects one of the two given nodes such that it increases the given bounds the least.
+         *
+         * @param node1 the first node to test
+         * @param node2 the second node to test
+         * @param bounds the bounds to test against
+         * @return node1 if it increases the given bounds volume by a smaller or equal amount than node2 would, and
+         *     node2 otherwise
+         */
+        NodeIndex selectLeastIncreaser(const NodeIndex node1, const NodeIndex node2, const Box& bounds) const {
+            const auto& bounds1 = m_nodes[node1].bounds;
+            const auto& bounds2 = m_nodes[node2].bounds;
+            const auto node1Contains = bounds1.contains(bounds);
+            const auto node2Contains = bounds2.contains(bounds);
+
+            if (node1Contains && !node2Contains) {
+                return node1;
+            } else if (!node1Contains && node2Contains) {
+                return node2;
+            } else if (!node1Contains && !node2Contains) {
+                const auto new1 = vm::merge(bounds1, bounds);
+                const auto new2 = vm::merge(bounds2, bounds);
+                const auto diff1 = new1.volume() - bounds1.volume();
+                const auto diff2 = new2.volume() - bounds2.volume();
+
+                if (diff1 < diff2) {
+                    return node1;
+                } else if (diff2 < diff1) {
+                    return node2;
+                }
+            }
+
+            static auto choice = 0u;
+
+            const auto height1 = m_nodes[node1].height;
+            const auto height2 = m_nodes[node2].height;
+            if (height1 < height2) {
+                return node1;
+            } else if (height2 < height1) {
+                return node2;
+            } else {
+                if (choice++ % 2 == 0) {
+                    return node1;
+                } else {
+                    return node2;
+                }
+            }
+        }
+
+        /**
+         * Returns half of the surface area of the given box, which is all that the surface area heuristic needs.
+         */
+        static T halfArea(const Box& box) {
+            const auto size = box.size();
+            auto result = static_cast<T>(0);
+            for (size_t i = 0; i < S; ++i) {
+                for (size_t j = i + 1; j < S; ++j) {
+                    result += size[i] * size[j];
+                }
+            }
+            return result;
+        }
+
+        /**
+         * Builds the subtree for the items in the range [first, last) and returns the index of its root. The root is
+         * allocated before its children so that the nodes are stored in depth first order.
+         */
+        NodeIndex build(std::vector<BuildItem>& items, const size_t first, const size_t last, const NodeIndex parent) {
+            assert(first < last);
+            if (last - first == 1) {
+                return createLeaf(items[first].bounds, items[first].data, parent);
+            }
+
+            const auto index = allocateNode();
+            const auto middle = partition(items, first, last);
+            const auto left = build(items, first, middle, index);
+            const auto right = build(items, middle, last, index);
+
+            const auto& leftNode = m_nodes[left];
+            const auto& rightNode = m_nodes[right];
+            m_nodes[index] = Node{
+                vm::merge(leftNode.bounds, rightNode.bounds),
+                parent,
+                left,
+                right,
+                std::max(leftNode.height, rightNode.height) + 1,
+                U{}
+            };
+            return index;
+        }
+
+        /**
+         * Partitions the items in the range [first, last) into two non empty ranges and returns the index of the
+         * first item of the second range.
+         *
+         * The items are sorted into bins along each axis by their centers, and the split between two bins that
+         * minimizes the sum of each side's half area weighted by its item count is chosen. If all centers coincide,
+         * the range is split in the middle.
+         */
+        static size_t partition(std::vector<BuildItem>& items, const size_t first, const size_t last) {
+            auto centerBounds = Box(items[first].center, items[first].center);
+            for (size_t i = first + 1; i < last; ++i) {
+                centerBounds = vm::merge(centerBounds, items[i].center);
+            }
+
+            const auto binIndex = [&](const BuildItem& item, const size_t axis) {
+                const auto extent = centerBounds.max[axis] - centerBounds.min[axis];
+                const auto relative = (item.center[axis] - centerBounds.min[axis]) / extent;
+                return std::min(static_cast<size_t>(relative * static_cast<T>(BinCount)), BinCount - 1);
+            };
+
+            auto bestCost = std::numeric_limits<T>::max();
+            auto bestAxis = S;
+            auto bestBin = size_t(0);
+
+            for (size_t axis = 0; axis < S; ++axis) {
+                if (!(centerBounds.max[axis] > centerBounds.min[axis])) {
+                    continue;
+                }
+
+                Box binBounds[BinCount];
+                size_t binCounts[BinCount] = {};
+                for (size_t i = first; i < last; ++i) {
+                    const auto bin = binIndex(items[i], axis);
+                    binBounds[bin] = binCounts[bin] == 0 ? items[i].bounds : vm::merge(binBounds[bin], items[i].bounds);
+                    ++binCounts[bin];
+                }
+
+                // sweep from the right to compute the cost of the right side of each split
+                T rightCosts[BinCount];
+                auto rightBounds = Box();
+                auto rightCount = size_t(0);
+                for (size_t bin = BinCount - 1; bin > 0; --bin) {
+                    if (binCounts[bin] > 0) {
+                        rightBounds = rightCount == 0 ? binBounds[bin] : vm::merge(rightBounds, binBounds[bin]);
+                        rightCount += binCounts[bin];
+                    }
+                    rightCosts[bin] = rightCount == 0 ? static_cast<T>(0) : halfArea(rightBounds) * static_cast<T>(rightCount);
+                }
+
+                // sweep from the left, splitting between bin - 1 and bin
+                auto leftBounds = Box();
+                auto leftCount = size_t(0);
+                for (size_t bin = 1; bin < BinCount; ++bin) {
+                    if (binCounts[bin - 1] > 0) {
+                        leftBounds = leftCount == 0 ? binBounds[bin - 1] : vm::merge(leftBounds, binBounds[bin - 1]);
+                        leftCount += binCounts[bin - 1];
+                    }
+                    if (leftCount > 0 && leftCount < last - first) {
+                        const auto cost = halfArea(leftBounds) * static_cast<T>(leftCount) + rightCosts[bin];
+                        if (cost < bestCost) {
+                            bestCost = cost;
+                            bestAxis = axis;
+                            bestBin = bin;
+                        }
+                    }
+                }
+            }
+
+            if (bestAxis == S) {
+                return first + (last - first) / 2;
+            }
+
+            const auto it = std::partition(std::next(std::begin(items), static_cast<std::ptrdiff_t>(first)), std::next(std::begin(items), static_cast<std::ptrdiff_t>(last)), [&](const BuildItem& item) {
+                return binIndex(item, bestAxis) < bestBin;
+            });
+            const auto middle = static_cast<size_t>(std::distance(std::begin(items), it));
+            assert(middle > first && middle < last);
+            return middle;
+        }
+
+        /**
+         * Visits the nodes of this tree in depth first order. The given function is called for every inner node, and
+         * its children are only visited if it returns true. The given leaf function is called for every leaf.
+         */
+        template <typename VisitInner, typename VisitLeaf>
+        void visit(VisitInner&& visitInner, VisitLeaf&& visitLeaf) const {
+            if (empty()) {
+                return;
+            }
+
+            auto stack = std::vector<NodeIndex>{};
+            stack.reserve(64);
+            stack.push_back(m_root);
+
+            while (!stack.empty()) {
+                const auto& node = m_nodes[stack.back()];
+                stack.pop_back();
+
+                if (node.isLeaf()) {
+                    visitLeaf(node);
+                } else if (visitInner(node)) {
+                    stack.push_back(node.right);
+                    stack.push_back(node.left);
+                }
+            }
+        }
     public:
         /**
          * Clears this node tree.
          */
         void clear() {
-            if (!empty()) {
-                m_leafForData.clear();
-                delete m_root;
-                m_root = nullptr;
-            }
+            m_nodes.clear();
+            m_freeNodes.clear();
+            m_leafForData.clear();
+            m_root = InvalidIndex;
         }
 
         /**
@@ -586,7 +679,7 @@ namespace TrenchBroom {
          * @return true if this tree is empty and false otherwise
          */
         bool empty() const {
-            return m_root == nullptr;
+            return m_root == InvalidIndex;
         }
 
         /**
@@ -601,7 +694,7 @@ namespace TrenchBroom {
             if (empty()) {
                 return EmptyBox;
             } else {
-                return m_root->bounds();
+                return m_nodes[m_root].bounds;
             }
         }
 
@@ -611,7 +704,7 @@ namespace TrenchBroom {
          * @return the height of this tree
          */
         size_t height() const {
-            return empty() ? 0 : m_root->height();
+            return empty() ? 0 : m_nodes[m_root].height;
         }
 
         /**
@@ -636,21 +729,18 @@ namespace TrenchBroom {
          */
         template <typename O>
         void findIntersectors(const vm::ray<T,S>& ray, O out) const {
-            if (!empty()) {
-                LambdaVisitor visitor(
-                    [&](const InnerNode* innerNode) {
-                        return innerNode->bounds().contains(ray.origin) || !vm::is_nan(
-                            vm::intersect_ray_bbox(ray, innerNode->bounds()));
-                    },
-                    [&](const LeafNode* leaf) {
-                        if (leaf->bounds().contains(ray.origin) || !vm::is_nan(vm::intersect_ray_bbox(ray, leaf->bounds()))) {
-                            out = leaf->data();
-                            ++out;
-                        }
+            const auto query = RayQuery(ray);
+            visit(
+                [&](const Node& innerNode) {
+                    return query.intersects(innerNode.bounds);
+                },
+                [&](const Node& leaf) {
+                    if (query.intersects(leaf.bounds)) {
+                        out = leaf.data;
+                        ++out;
                     }
-                );
-                m_root->accept(visitor);
-            }
+                }
+            );
         }
 
         /**
@@ -675,20 +765,17 @@ namespace TrenchBroom {
          */
         template <typename O>
         void findContainers(const vm::vec<T,S>& point, O out) const {
-            if (!empty()) {
-                LambdaVisitor visitor(
-                    [&](const InnerNode* innerNode) {
-                        return innerNode->bounds().contains(point);
-                    },
-                    [&](const LeafNode* leaf) {
-                        if (leaf->bounds().contains(point)) {
-                            out = leaf->data();
-                            ++out;
-                        }
+            visit(
+                [&](const Node& innerNode) {
+                    return innerNode.bounds.contains(point);
+                },
+                [&](const Node& leaf) {
+                    if (leaf.bounds.contains(point)) {
+                        out = leaf.data;
+                        ++out;
                     }
-                );
-                m_root->accept(visitor);
-            }
+                }
+            );
         }
 
         /**
@@ -698,9 +785,23 @@ namespace TrenchBroom {
          */
         void print(std::ostream& str) const {
             if (!empty()) {
-                m_root->appendTo(str);
+                appendTo(str, m_root, "  ", 0);
+            }
+        }
+    private:
+        void appendTo(std::ostream& str, const NodeIndex index, const std::string& indent, const size_t level) const {
+            const auto& node = m_nodes[index];
+            for (size_t i = 0; i < level; ++i) {
+                str << indent;
+            }
+
+            if (node.isLeaf()) {
+                str << "L [ ( " << node.bounds.min << " ) ( " << node.bounds.max << " ) ]: " << node.data << std::endl;
+            } else {
+                str << "O [ ( " << node.bounds.min << " ) ( " << node.bounds.max << " ) ]" << std::endl;
+                appendTo(str, node.left, indent, level + 1);
+                appendTo(str, node.right, indent, level + 1);
             }
         }
     };
 }
-
@@ -0,0 +1,151 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "AllocationCounting.h"
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace TrenchBroom {
+    std::string_view allocationTagName(const AllocationTag tag) {
+        switch (tag) {
+            case AllocationTag::Other:
+                return "Other";
+            case AllocationTag::IO:
+                return "IO";
+            case AllocationTag::Model:
+                return "Model";
+            case AllocationTag::Renderer:
+                return "Renderer";
+            switchDefault();
+        }
+    }
+
+#ifdef TB_ENABLE_ALLOCATION_COUNTING
+    namespace {
+        struct Counter {
+            std::atomic<size_t> allocations{0};
+            std::atomic<size_t> bytes{0};
+        };
+
+        // constant initialized, so the counters can be used by allocations made during static initialization
+        std::array<Counter, AllocationTagCount> s_counters;
+        thread_local AllocationTag t_currentTag = AllocationTag::Other;
+    }
+
+    static void* countedAllocate(const std::size_t size) noexcept {
+        auto& counter = s_counters[static_cast<size_t>(t_currentTag)];
+        counter.allocations.fetch_add(1, std::memory_order_relaxed);
+        counter.bytes.fetch_add(size, std::memory_order_relaxed);
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+    bool allocationCountingEnabled() {
+        return true;
+    }
+
+    AllocationCounts allocationCounts(const AllocationTag tag) {
+        const auto& counter = s_counters[static_cast<size_t>(tag)];
+        return {counter.allocations.load(std::memory_order_relaxed), counter.bytes.load(std::memory_order_relaxed)};
+    }
+
+    AllocationScope::AllocationScope(const AllocationTag tag) :
+    m_previousTag{t_currentTag} {
+        t_currentTag = tag;
+    }
+
+    AllocationScope::~AllocationScope() {
+        t_currentTag = m_previousTag;
+    }
+#else
+    bool allocationCountingEnabled() {
+        return false;
+    }
+
+    AllocationCounts allocationCounts(const AllocationTag) {
+        return {0u, 0u};
+    }
+
+    AllocationScope::AllocationScope(const AllocationTag tag) :
+    m_previousTag{tag} {}
+
+    AllocationScope::~AllocationScope() = default;
+#endif
+
+    AllocationCounts totalAllocationCounts() {
+        auto result = AllocationCounts{0u, 0u};
+        for (size_t i = 0u; i < AllocationTagCount; ++i) {
+            const auto counts = allocationCounts(static_cast<AllocationTag>(i));
+            result.allocations += counts.allocations;
+            result.bytes += counts.bytes;
+        }
+        return result;
+    }
+}
+
+#ifdef TB_ENABLE_ALLOCATION_COUNTING
+void* operator new(const std::size_t size) {
+    if (auto* ptr = TrenchBroom::countedAllocate(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void* operator new[](const std::size_t size) {
+    if (auto* ptr = TrenchBroom::countedAllocate(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept {
+    return TrenchBroom::countedAllocate(size);
+}
+
+void* operator new[](const std::size_t size, const std::nothrow_t&) noexcept {
+    return TrenchBroom::countedAllocate(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+#endif
@@ -0,0 +1,81 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Macros.h"
+
+#include <cstddef>
+#include <string_view>
+
+namespace TrenchBroom {
+    /**
+     * The subsystems whose heap allocations are counted separately.
+     */
+    enum class AllocationTag {
+        Other,
+        IO,
+        Model,
+        Renderer
+    };
+
+    constexpr size_t AllocationTagCount = 4u;
+
+    std::string_view allocationTagName(AllocationTag tag);
+
+    struct AllocationCounts {
+        size_t allocations;
+        size_t bytes;
+    };
+
+    /**
+     * Indicates whether heap allocations are counted. This is only the case if TrenchBroom was built with the
+     * CMake option TB_ENABLE_ALLOCATION_COUNTING, which replaces the global operator new.
+     */
+    bool allocationCountingEnabled();
+
+    /**
+     * Returns the number and the total size of the heap allocations made with the given tag since the program
+     * started. Returns zeroes if allocation counting is disabled.
+     */
+    AllocationCounts allocationCounts(AllocationTag tag);
+
+    /**
+     * Returns the sum of the counts of all tags.
+     */
+    AllocationCounts totalAllocationCounts();
+
+    /**
+     * Attributes all heap allocations made by the current thread during the lifetime of this object to the
+     * given tag. Scopes can be nested, and the previous tag is restored when a scope ends.
+     *
+     * The tag is stored per thread, so allocations made by a parallel loop inside of a scope are attributed to
+     * the tag of the worker thread unless the loop body opens a scope of its own.
+     */
+    class AllocationScope {
+    private:
+        AllocationTag m_previousTag;
+    public:
+        explicit AllocationScope(AllocationTag tag);
+        ~AllocationScope();
+
+        deleteCopyAndMove(AllocationScope)
+    };
+}
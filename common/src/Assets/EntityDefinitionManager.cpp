@@ -29,7 +29,10 @@
 
 #include <kdl/vector_utils.h>
 
+#include <map>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
@@ -72,6 +75,22 @@ namespace TrenchBroom {
             }
         }
 
+        void EntityDefinitionManager::setDefinitions(const std::vector<Model::EntityNodeBase*>& nodes) const {
+            // the classnames are owned by the nodes' entities, which are not modified while the groups are in use
+            auto nodesByClassname = std::unordered_map<std::string_view, std::vector<Model::EntityNodeBase*>>{};
+            for (auto* node : nodes) {
+                nodesByClassname[node->entity().classname()].push_back(node);
+            }
+
+            for (const auto& [classname, nodesWithClassname] : nodesByClassname) {
+                auto it = m_cache.find(std::string{classname});
+                auto* definition = it != std::end(m_cache) ? it->second : nullptr;
+                for (auto* node : nodesWithClassname) {
+                    node->setDefinition(definition);
+                }
+            }
+        }
+
         std::vector<EntityDefinition*> EntityDefinitionManager::definitions(const EntityDefinitionType type, const EntityDefinitionSortOrder order) const {
             return EntityDefinition::filterAndSort(m_definitions, type, order);
         }
@@ -19,8 +19,8 @@
 
 #pragma once
 
-#include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
@@ -42,7 +42,7 @@ namespace TrenchBroom {
 
         class EntityDefinitionManager {
         private:
-            using Cache = std::map<std::string, EntityDefinition*>;
+            using Cache = std::unordered_map<std::string, EntityDefinition*>;
             std::vector<EntityDefinition*> m_definitions;
             std::vector<EntityDefinitionGroup> m_groups;
             Cache m_cache;
@@ -55,6 +55,12 @@ namespace TrenchBroom {
 
             EntityDefinition* definition(const Model::EntityNodeBase* node) const;
             EntityDefinition* definition(const std::string& classname) const;
+
+            /**
+             * Sets the definition of each of the given nodes to the definition matching its classname. The nodes are
+             * grouped by their classnames so that the definition of each classname is only looked up once.
+             */
+            void setDefinitions(const std::vector<Model::EntityNodeBase*>& nodes) const;
             std::vector<EntityDefinition*> definitions(EntityDefinitionType type, EntityDefinitionSortOrder order) const;
             const std::vector<EntityDefinition*>& definitions() const;
 
@@ -51,8 +51,7 @@ namespace TrenchBroom {
         EntityModelFrame(index),
         m_name(name),
         m_bounds(bounds),
-        m_pitchType(pitchType),
-        m_spacialTree(std::make_unique<SpacialTree>()) {}
+        m_pitchType(pitchType) {}
 
         EntityModelLoadedFrame::~EntityModelLoadedFrame() = default;
 
@@ -73,13 +72,18 @@ namespace TrenchBroom {
         }
 
         float EntityModelLoadedFrame::intersect(const vm::ray3f& ray) const {
+            if (m_spacialTree == nullptr) {
+                buildSpacialTree();
+            }
+
             auto closestDistance = vm::nan<float>();
 
             const auto candidates = m_spacialTree->findIntersectors(ray);
             for (const TriNum triNum : candidates) {
-                const vm::vec3f& p1 = m_tris[triNum * 3 + 0];
-                const vm::vec3f& p2 = m_tris[triNum * 3 + 1];
-                const vm::vec3f& p3 = m_tris[triNum * 3 + 2];
+                const auto& triangle = m_tris[triNum];
+                const auto& p1 = vertex(triangle, 0);
+                const auto& p2 = vertex(triangle, 1);
+                const auto& p3 = vertex(triangle, 2);
                 closestDistance = vm::safe_min(closestDistance, vm::intersect_ray_triangle(ray, p1, p2, p3));
             }
 
@@ -95,43 +99,18 @@ namespace TrenchBroom {
                     break;
                 case Renderer::PrimType::Triangles: {
                     assert(count % 3 == 0);
-                    m_tris.reserve(m_tris.size() + count);
+                    m_tris.reserve(m_tris.size() + count / 3);
                     for (size_t i = 0; i < count; i += 3) {
-                        vm::bbox3f::builder bounds;
-                        const auto& p1 = Renderer::getVertexComponent<0>(vertices[index + i + 0]);
-                        const auto& p2 = Renderer::getVertexComponent<0>(vertices[index + i + 1]);
-                        const auto& p3 = Renderer::getVertexComponent<0>(vertices[index + i + 2]);
-                        bounds.add(p1);
-                        bounds.add(p2);
-                        bounds.add(p3);
-
-                        const size_t triIndex = m_tris.size() / 3u;
-                        m_tris.push_back(p1);
-                        m_tris.push_back(p2);
-                        m_tris.push_back(p3);
-                        m_spacialTree->insert(bounds.bounds(), triIndex);
+                        addTriangle(vertices, index + i + 0, index + i + 1, index + i + 2);
                     }
                     break;
                 }
                 case Renderer::PrimType::Polygon:
                 case Renderer::PrimType::TriangleFan: {
                     assert(count > 2);
-                    m_tris.reserve(m_tris.size() + (count - 2) * 3);
-
-                    const auto& p1 = Renderer::getVertexComponent<0>(vertices[index]);
+                    m_tris.reserve(m_tris.size() + count - 2);
                     for (size_t i = 1; i < count - 1; ++i) {
-                        vm::bbox3f::builder bounds;
-                        const auto& p2 = Renderer::getVertexComponent<0>(vertices[index + i]);
-                        const auto& p3 = Renderer::getVertexComponent<0>(vertices[index + i + 1]);
-                        bounds.add(p1);
-                        bounds.add(p2);
-                        bounds.add(p3);
-
-                        const size_t triIndex = m_tris.size() / 3u;
-                        m_tris.push_back(p1);
-                        m_tris.push_back(p2);
-                        m_tris.push_back(p3);
-                        m_spacialTree->insert(bounds.bounds(), triIndex);
+                        addTriangle(vertices, index, index + i, index + i + 1);
                     }
                     break;
                 }
@@ -139,32 +118,57 @@ namespace TrenchBroom {
                 case Renderer::PrimType::QuadStrip:
                 case Renderer::PrimType::TriangleStrip: {
                     assert(count > 2);
-                    m_tris.reserve(m_tris.size() + (count - 2) * 3);
+                    m_tris.reserve(m_tris.size() + count - 2);
                     for (size_t i = 0; i < count-2; ++i) {
-                        vm::bbox3f::builder bounds;
-                        const auto& p1 = Renderer::getVertexComponent<0>(vertices[index + i + 0]);
-                        const auto& p2 = Renderer::getVertexComponent<0>(vertices[index + i + 1]);
-                        const auto& p3 = Renderer::getVertexComponent<0>(vertices[index + i + 2]);
-                        bounds.add(p1);
-                        bounds.add(p2);
-                        bounds.add(p3);
-
-                        const size_t triIndex = m_tris.size() / 3u;
                         if (i % 2 == 0) {
-                            m_tris.push_back(p1);
-                            m_tris.push_back(p2);
-                            m_tris.push_back(p3);
+                            addTriangle(vertices, index + i + 0, index + i + 1, index + i + 2);
                         } else {
-                            m_tris.push_back(p1);
-                            m_tris.push_back(p3);
-                            m_tris.push_back(p2);
+                            addTriangle(vertices, index + i + 0, index + i + 2, index + i + 1);
                         }
-                        m_spacialTree->insert(bounds.bounds(), triIndex);
                     }
                     break;
                 }
                 switchDefault();
             }
+
+            // the tree must be rebuilt to include the new triangles
+            m_spacialTree.reset();
+        }
+
+        void EntityModelLoadedFrame::addTriangle(const std::vector<EntityModelVertex>& vertices, const size_t i1, const size_t i2, const size_t i3) {
+            assert(i1 < vertices.size() && i2 < vertices.size() && i3 < vertices.size());
+            m_tris.push_back(Triangle{
+                &vertices,
+                { static_cast<uint32_t>(i1), static_cast<uint32_t>(i2), static_cast<uint32_t>(i3) }
+            });
+        }
+
+        const vm::vec3f& EntityModelLoadedFrame::vertex(const Triangle& triangle, const size_t i) const {
+            return Renderer::getVertexComponent<0>((*triangle.vertices)[triangle.indices[i]]);
+        }
+
+        void EntityModelLoadedFrame::buildSpacialTree() const {
+            const auto triangleBounds = [&](const TriNum triNum) {
+                const auto& triangle = m_tris[triNum];
+                vm::bbox3f::builder bounds;
+                bounds.add(vertex(triangle, 0));
+                bounds.add(vertex(triangle, 1));
+                bounds.add(vertex(triangle, 2));
+                return bounds.bounds();
+            };
+
+            // degenerate triangles with invalid coordinates cannot be hit, so they are left out of the tree
+            auto triNums = std::vector<TriNum>{};
+            triNums.reserve(m_tris.size());
+            for (TriNum i = 0; i < m_tris.size(); ++i) {
+                const auto bounds = triangleBounds(i);
+                if (!vm::is_nan(bounds.min) && !vm::is_nan(bounds.max)) {
+                    triNums.push_back(i);
+                }
+            }
+
+            m_spacialTree = std::make_unique<SpacialTree>();
+            m_spacialTree->clearAndBuild(triNums, triangleBounds);
         }
 
         // EntityModel::UnloadedFrame
@@ -221,6 +225,13 @@ namespace TrenchBroom {
              */
             explicit EntityModelMesh(const std::vector<EntityModelVertex>& vertices) :
             m_vertices(vertices) {}
+
+            /**
+             * Returns the vertices of this mesh. The frame's spacial tree refers to these vertices.
+             */
+            const std::vector<EntityModelVertex>& vertices() const {
+                return m_vertices;
+            }
         public:
             virtual ~EntityModelMesh() = default;
         public:
@@ -264,8 +275,8 @@ namespace TrenchBroom {
             EntityModelIndexedMesh(EntityModelLoadedFrame& frame, const std::vector<EntityModelVertex>& vertices, const EntityModelIndices& indices) :
             EntityModelMesh(vertices),
             m_indices(indices) {
-                m_indices.forEachPrimitive([&frame, &vertices](const Renderer::PrimType primType, const size_t index, const size_t count) {
-                    frame.addToSpacialTree(vertices, primType, index, count);
+                m_indices.forEachPrimitive([&](const Renderer::PrimType primType, const size_t index, const size_t count) {
+                    frame.addToSpacialTree(this->vertices(), primType, index, count);
                 });
         }
         private:
@@ -294,8 +305,8 @@ namespace TrenchBroom {
             EntityModelTexturedMesh(EntityModelLoadedFrame& frame, const std::vector<EntityModelVertex>& vertices, const EntityModelTexturedIndices& indices) :
             EntityModelMesh(vertices),
             m_indices(indices) {
-                m_indices.forEachPrimitive([&frame, &vertices](const Texture* /* texture */, const Renderer::PrimType primType, const size_t index, const size_t count) {
-                    frame.addToSpacialTree(vertices, primType, index, count);
+                m_indices.forEachPrimitive([&](const Texture* /* texture */, const Renderer::PrimType primType, const size_t index, const size_t count) {
+                    frame.addToSpacialTree(this->vertices(), primType, index, count);
                 });
             }
         private:
@@ -24,6 +24,8 @@
 #include <vecmath/forward.h>
 #include <vecmath/bbox.h>
 
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -112,11 +114,17 @@ namespace TrenchBroom {
             vm::bbox3f m_bounds;
             PitchType m_pitchType;
 
-            // For hit testing
-            std::vector<vm::vec3f> m_tris;
+            // For hit testing. The triangles refer to the vertices of the meshes of this frame instead of copying
+            // them, and the spacial tree is only built when the frame is intersected for the first time.
+            struct Triangle {
+                const std::vector<EntityModelVertex>* vertices;
+                std::array<uint32_t, 3> indices;
+            };
+
+            std::vector<Triangle> m_tris;
             using TriNum = size_t;
             using SpacialTree = AABBTree<float, 3, TriNum>;
-            std::unique_ptr<SpacialTree> m_spacialTree;
+            mutable std::unique_ptr<SpacialTree> m_spacialTree;
         public:
             /**
              * Creates a new frame with the given index, name and bounds.
@@ -136,7 +144,8 @@ namespace TrenchBroom {
             float intersect(const vm::ray3f& ray) const override;
 
             /**
-             * Adds the given primitives to the spacial tree for this frame.
+             * Adds the given primitives to the spacial tree for this frame. The triangles refer to the given
+             * vertices, which must outlive this frame.
              *
              * @param vertices the vertices
              * @param primType the primitive type
@@ -144,6 +153,10 @@ namespace TrenchBroom {
              * @param count the number of vertices that make up the primitive(s)
              */
             void addToSpacialTree(const std::vector<EntityModelVertex>& vertices, Renderer::PrimType primType, size_t index, size_t count);
+        private:
+            void addTriangle(const std::vector<EntityModelVertex>& vertices, size_t i1, size_t i2, size_t i3);
+            const vm::vec3f& vertex(const Triangle& triangle, size_t i) const;
+            void buildSpacialTree() const;
         };
 
         class EntityModelUnloadedFrame;
@@ -19,6 +19,7 @@
 
 #include "EntityModelManager.h"
 
+#include "BufferedLogger.h"
 #include "Exceptions.h"
 #include "Logger.h"
 #include "Macros.h"
@@ -28,6 +29,11 @@
 #include "Model/EntityNode.h"
 #include "Renderer/TexturedIndexRangeRenderer.h"
 
+#include <kdl/parallel.h>
+
+#include <algorithm>
+#include <string>
+
 namespace TrenchBroom {
     namespace Assets {
         EntityModelManager::EntityModelManager(const int magFilter, const int minFilter, Logger& logger) :
@@ -35,7 +41,9 @@ namespace TrenchBroom {
         m_loader(nullptr),
         m_minFilter(minFilter),
         m_magFilter(magFilter),
-        m_resetTextureMode(false) {}
+        m_resetTextureMode(false),
+        m_rendererBudget(DefaultRendererBudget),
+        m_useCounter(0u) {}
 
         EntityModelManager::~EntityModelManager() {
             clear();
@@ -43,6 +51,7 @@ namespace TrenchBroom {
 
         void EntityModelManager::clear() {
             m_renderers.clear();
+            m_rendererIndex.clear();
             m_models.clear();
             m_rendererMismatches.clear();
             m_modelMismatches.clear();
@@ -64,6 +73,10 @@ namespace TrenchBroom {
             m_loader = loader;
         }
 
+        void EntityModelManager::setRendererBudget(const size_t rendererBudget) {
+            m_rendererBudget = rendererBudget;
+        }
+
         Renderer::TexturedRenderer* EntityModelManager::renderer(const Assets::ModelSpecification& spec) const {
             auto* entityModel = safeGetModel(spec.path);
 
@@ -73,7 +86,8 @@ namespace TrenchBroom {
 
             auto it = m_renderers.find(spec);
             if (it != std::end(m_renderers)) {
-                return it->second.get();
+                it->second.lastUse = ++m_useCounter;
+                return it->second.renderer.get();
             }
 
             if (m_rendererMismatches.count(spec) > 0) {
@@ -82,10 +96,11 @@ namespace TrenchBroom {
 
             auto renderer = entityModel->buildRenderer(spec.skinIndex, spec.frameIndex);
             if (renderer != nullptr) {
-                const auto [pos, success] = m_renderers.insert({ spec, std::move(renderer) });
+                const auto [pos, success] = m_renderers.insert({ spec, CachedRenderer{ std::move(renderer), 0u, ++m_useCounter } });
                 assert(success); unused(success);
 
-                auto* result = pos->second.get();
+                auto* result = pos->second.renderer.get();
+                m_rendererIndex.emplace(result, pos);
                 m_unpreparedRenderers.push_back(result);
                 m_logger.debug() << "Constructed entity model renderer for " << spec;
                 return result;
@@ -96,6 +111,34 @@ namespace TrenchBroom {
             }
         }
 
+        Renderer::TexturedRenderer* EntityModelManager::acquireRenderer(const Assets::ModelSpecification& spec) {
+            auto* result = renderer(spec);
+            if (result != nullptr) {
+                auto it = m_rendererIndex.find(result);
+                assert(it != std::end(m_rendererIndex));
+                ++it->second->second.useCount;
+            }
+            return result;
+        }
+
+        void EntityModelManager::releaseRenderer(const Renderer::TexturedRenderer* renderer) {
+            auto it = m_rendererIndex.find(renderer);
+            if (it != std::end(m_rendererIndex)) {
+                auto& cachedRenderer = it->second->second;
+                assert(cachedRenderer.useCount > 0u);
+                --cachedRenderer.useCount;
+                cachedRenderer.lastUse = ++m_useCounter;
+            }
+        }
+
+        size_t EntityModelManager::rendererSize() const {
+            size_t result = 0u;
+            for (const auto& [spec, cachedRenderer] : m_renderers) {
+                result += cachedRenderer.renderer->sizeInBytes();
+            }
+            return result;
+        }
+
         const EntityModelFrame* EntityModelManager::frame(const Assets::ModelSpecification& spec) const {
             auto* model = this->safeGetModel(spec.path);
             if (model == nullptr) {
@@ -110,6 +153,95 @@ namespace TrenchBroom {
             }
         }
 
+        namespace {
+            struct ModelToLoad {
+                IO::Path path;
+                std::vector<ModelSpecification> frameSpecs;
+            };
+
+            struct LoadedModel {
+                std::unique_ptr<EntityModel> model;
+                std::unique_ptr<BufferedLogger> logger;
+                std::string errorMessage;
+            };
+        }
+
+        void EntityModelManager::loadModels(const std::vector<Assets::ModelSpecification>& specs) {
+            if (m_loader == nullptr) {
+                return;
+            }
+
+            auto modelsToLoad = std::vector<ModelToLoad>{};
+            auto modelIndices = std::map<IO::Path, size_t>{};
+            for (const auto& spec : specs) {
+                if (spec.path.isEmpty() || m_models.count(spec.path) > 0 || m_modelMismatches.count(spec.path) > 0) {
+                    continue;
+                }
+
+                const auto [it, inserted] = modelIndices.insert({ spec.path, modelsToLoad.size() });
+                if (inserted) {
+                    modelsToLoad.push_back(ModelToLoad{ spec.path, {} });
+                }
+
+                auto& frameSpecs = modelsToLoad[it->second].frameSpecs;
+                if (std::none_of(std::begin(frameSpecs), std::end(frameSpecs), [&](const auto& frameSpec) { return frameSpec.frameIndex == spec.frameIndex; })) {
+                    frameSpecs.push_back(spec);
+                }
+            }
+
+            if (modelsToLoad.empty()) {
+                return;
+            }
+
+            const auto* loader = m_loader;
+            auto loadedModels = kdl::vec_parallel_transform(modelsToLoad, [&](const ModelToLoad& modelToLoad) {
+                auto logger = std::make_unique<BufferedLogger>();
+                try {
+                    auto model = loader->initializeModel(modelToLoad.path, *logger);
+
+                    // The frames are independent of each other and each of them is stored in a slot of the model
+                    // that was created by initializeModel, so they can be decoded concurrently. Every frame gets its
+                    // own logger so that the messages are not interleaved.
+                    const auto& frameSpecs = modelToLoad.frameSpecs;
+                    auto frameLoggers = std::vector<BufferedLogger>(frameSpecs.size());
+                    kdl::parallel_for(frameSpecs.size(), [&](const size_t i) {
+                        const auto& frameSpec = frameSpecs[i];
+                        if (frameSpec.frameIndex < model->frameCount()) {
+                            try {
+                                loader->loadFrame(frameSpec.path, frameSpec.frameIndex, *model, frameLoggers[i]);
+                            } catch (const Exception& e) {
+                                frameLoggers[i].error() << "Could not load entity model frame " << frameSpec << ": " << e.what();
+                            }
+                        }
+                    });
+                    for (auto& frameLogger : frameLoggers) {
+                        frameLogger.flush(*logger);
+                    }
+
+                    return LoadedModel{ std::move(model), std::move(logger), "" };
+                } catch (const GameException& e) {
+                    return LoadedModel{ nullptr, std::move(logger), e.what() };
+                }
+            });
+
+            for (size_t i = 0; i < modelsToLoad.size(); ++i) {
+                auto& loadedModel = loadedModels[i];
+                loadedModel.logger->flush(m_logger);
+
+                const auto& path = modelsToLoad[i].path;
+                if (loadedModel.model != nullptr) {
+                    auto* model = loadedModel.model.get();
+                    m_models.insert({ path, std::move(loadedModel.model) });
+                    m_unpreparedModels.push_back(model);
+
+                    m_logger.debug() << "Loaded entity model " << path;
+                } else {
+                    m_logger.error() << loadedModel.errorMessage;
+                    m_modelMismatches.insert(path);
+                }
+            }
+        }
+
         EntityModel* EntityModelManager::model(const IO::Path& path) const {
             if (path.isEmpty()) {
                 return nullptr;
@@ -168,6 +300,7 @@ namespace TrenchBroom {
             resetTextureMode();
             prepareModels();
             prepareRenderers(vboManager);
+            evictRenderers();
         }
 
         void EntityModelManager::resetTextureMode() {
@@ -192,5 +325,36 @@ namespace TrenchBroom {
             }
             m_unpreparedRenderers.clear();
         }
+
+        void EntityModelManager::evictRenderers() {
+            auto totalSize = rendererSize();
+            if (totalSize <= m_rendererBudget) {
+                return;
+            }
+
+            std::vector<RendererCache::iterator> candidates;
+            for (auto it = std::begin(m_renderers); it != std::end(m_renderers); ++it) {
+                if (it->second.useCount == 0u) {
+                    candidates.push_back(it);
+                }
+            }
+
+            std::sort(std::begin(candidates), std::end(candidates), [](const auto& lhs, const auto& rhs) {
+                return lhs->second.lastUse < rhs->second.lastUse;
+            });
+
+            for (auto it : candidates) {
+                if (totalSize <= m_rendererBudget) {
+                    break;
+                }
+
+                const auto size = it->second.renderer->sizeInBytes();
+                m_logger.debug() << "Evicting entity model renderer for " << it->first;
+
+                m_rendererIndex.erase(it->second.renderer.get());
+                m_renderers.erase(it);
+                totalSize -= size;
+            }
+        }
     }
 }
@@ -25,6 +25,7 @@
 
 #include <map>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
@@ -48,13 +49,30 @@ namespace TrenchBroom {
         class EntityModelFrame;
         struct ModelSpecification;
 
+        /**
+         * Loads entity models and caches them along with the renderers for their frames.
+         *
+         * Renderers that are acquired by an entity model renderer are kept until they are released again. Renderers
+         * which are no longer used remain cached so that they can be reused, but once the total size of all cached
+         * renderers exceeds the renderer budget, the least recently used of them are destroyed during the next call
+         * to prepare. An evicted renderer is rebuilt from its model if it is requested again.
+         */
         class EntityModelManager {
+        public:
+            static const size_t DefaultRendererBudget = 256u * 1024u * 1024u;
         private:
             using ModelCache = std::map<IO::Path, std::unique_ptr<EntityModel>>;
             using ModelMismatches = kdl::vector_set<IO::Path>;
             using ModelList = std::vector<EntityModel*>;
 
-            using RendererCache = std::map<ModelSpecification, std::unique_ptr<Renderer::TexturedRenderer>>;
+            struct CachedRenderer {
+                std::unique_ptr<Renderer::TexturedRenderer> renderer;
+                size_t useCount;
+                size_t lastUse;
+            };
+
+            using RendererCache = std::map<ModelSpecification, CachedRenderer>;
+            using RendererIndex = std::unordered_map<const Renderer::TexturedRenderer*, RendererCache::iterator>;
             using RendererMismatches = kdl::vector_set<ModelSpecification>;
             using RendererList = std::vector<Renderer::TexturedRenderer*>;
 
@@ -68,8 +86,12 @@ namespace TrenchBroom {
             mutable ModelCache m_models;
             mutable ModelMismatches m_modelMismatches;
             mutable RendererCache m_renderers;
+            mutable RendererIndex m_rendererIndex;
             mutable RendererMismatches m_rendererMismatches;
 
+            size_t m_rendererBudget;
+            mutable size_t m_useCounter;
+
             mutable ModelList m_unpreparedModels;
             mutable RendererList m_unpreparedRenderers;
         public:
@@ -80,9 +102,46 @@ namespace TrenchBroom {
 
             void setTextureMode(int minFilter, int magFilter);
             void setLoader(const IO::EntityModelLoader* loader);
+
+            /**
+             * Sets the maximum total size in bytes of the cached renderers. Renderers which are in use are never
+             * evicted, so the budget may be exceeded if more renderers are in use.
+             */
+            void setRendererBudget(size_t rendererBudget);
+
+            /**
+             * Returns the renderer for the given model specification, building it if necessary. The returned
+             * renderer is not protected from eviction unless it has been acquired.
+             */
             Renderer::TexturedRenderer* renderer(const ModelSpecification& spec) const;
 
+            /**
+             * Returns the renderer for the given model specification and protects it from eviction until it is
+             * released by a matching call to releaseRenderer.
+             */
+            Renderer::TexturedRenderer* acquireRenderer(const ModelSpecification& spec);
+
+            /**
+             * Releases a renderer that was returned by acquireRenderer. Renderers which are unknown to this manager,
+             * e.g. because it was cleared in the meantime, are ignored.
+             */
+            void releaseRenderer(const Renderer::TexturedRenderer* renderer);
+
+            /**
+             * Returns the total size in bytes of the cached renderers.
+             */
+            size_t rendererSize() const;
+
             const EntityModelFrame* frame(const ModelSpecification& spec) const;
+
+            /**
+             * Loads the models and frames referenced by the given specifications which are not loaded yet. The models
+             * are parsed concurrently, and afterwards they are added to the cache in order, so that subsequent calls
+             * to frame and renderer for these specifications don't have to parse any files.
+             *
+             * Any messages logged while parsing are forwarded to the logger on the calling thread.
+             */
+            void loadModels(const std::vector<ModelSpecification>& specs);
         private:
             EntityModel* model(const IO::Path& path) const;
             EntityModel* safeGetModel(const IO::Path& path) const;
@@ -94,6 +153,13 @@ namespace TrenchBroom {
             void resetTextureMode();
             void prepareModels();
             void prepareRenderers(Renderer::VboManager& vboManager);
+        public:
+            /**
+             * Destroys the least recently used renderers which are not in use until the total size of the cached
+             * renderers fits into the renderer budget. This is called by prepare, where it is safe to release the
+             * renderers' vertex buffers.
+             */
+            void evictRenderers();
         };
     }
 }
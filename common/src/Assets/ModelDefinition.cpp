@@ -28,7 +28,10 @@
 
 #include <vecmath/scalar.h>
 
+#include <mutex>
 #include <ostream>
+#include <string>
+#include <unordered_map>
 
 namespace TrenchBroom {
     namespace Assets {
@@ -82,14 +85,28 @@ namespace TrenchBroom {
             return stream;
         }
 
+        struct ModelDefinition::SpecificationMemo {
+            // the memo is bounded in case an expression reads a property which has a different value for every entity
+            static const size_t MaxSize = 4096u;
+
+            std::mutex mutex;
+            std::unordered_map<std::string, ModelSpecification> specifications;
+        };
+
         ModelDefinition::ModelDefinition() :
-        m_expression(EL::LiteralExpression(EL::Value::Undefined), 0, 0) {}
+        m_expression(EL::LiteralExpression(EL::Value::Undefined), 0, 0) {
+            prepareEvaluation();
+        }
 
         ModelDefinition::ModelDefinition(const size_t line, const size_t column) :
-        m_expression(EL::LiteralExpression(EL::Value::Undefined), line, column) {}
+        m_expression(EL::LiteralExpression(EL::Value::Undefined), line, column) {
+            prepareEvaluation();
+        }
 
         ModelDefinition::ModelDefinition(const EL::Expression& expression) :
-        m_expression(expression) {}
+        m_expression(expression) {
+            prepareEvaluation();
+        }
 
         bool operator==(const ModelDefinition& lhs, const ModelDefinition& rhs) {
             return lhs.m_expression.asString() == rhs.m_expression.asString();
@@ -104,6 +121,10 @@ namespace TrenchBroom {
             return str;
         }
 
+        const EL::Expression& ModelDefinition::expression() const {
+            return m_expression;
+        }
+
         void ModelDefinition::append(const ModelDefinition& other) {
             std::vector<EL::Expression> cases;
             cases.push_back(m_expression);
@@ -112,23 +133,74 @@ namespace TrenchBroom {
             const size_t line = m_expression.line();
             const size_t column = m_expression.column();
             m_expression = EL::Expression(EL::SwitchExpression(std::move(cases)), line, column);
+            prepareEvaluation();
         }
 
         ModelSpecification ModelDefinition::modelSpecification(const EL::VariableStore& variableStore) const {
+            if (m_constantSpecification) {
+                return *m_constantSpecification;
+            }
+
+            const auto key = signature(variableStore);
+            {
+                const auto lock = std::lock_guard<std::mutex>{m_memo->mutex};
+                const auto it = m_memo->specifications.find(key);
+                if (it != std::end(m_memo->specifications)) {
+                    return it->second;
+                }
+            }
+
             const EL::EvaluationContext context(variableStore);
-            return convertToModel(m_expression.evaluate(context));
+            auto result = convertToModel(m_expression.evaluate(context));
+
+            const auto lock = std::lock_guard<std::mutex>{m_memo->mutex};
+            if (m_memo->specifications.size() < SpecificationMemo::MaxSize) {
+                m_memo->specifications.emplace(key, result);
+            }
+            return result;
         }
 
         ModelSpecification ModelDefinition::defaultModelSpecification() const {
             return modelSpecification(EL::NullVariableStore());
         }
 
+        void ModelDefinition::prepareEvaluation() {
+            // optimize returns true if the expression was folded into a literal
+            if (m_expression.optimize()) {
+                m_constantSpecification = convertToModel(m_expression.evaluate(EL::EvaluationContext()));
+                m_variableNames.clear();
+                m_memo.reset();
+            } else {
+                m_constantSpecification = std::nullopt;
+                m_variableNames = m_expression.variableNames();
+                m_memo = std::make_shared<SpecificationMemo>();
+            }
+        }
+
+        std::string ModelDefinition::signature(const EL::VariableStore& variableStore) const {
+            auto result = std::string{};
+            for (const auto& variableName : m_variableNames) {
+                const auto value = variableStore.value(variableName);
+                result += static_cast<char>(value.type());
+                result += value.asString();
+                result += '\0';
+            }
+            return result;
+        }
+
         ModelSpecification ModelDefinition::convertToModel(const EL::Value& value) const {
             switch (value.type()) {
-                case EL::ValueType::Map:
-                    return ModelSpecification( path(value["path"]),
-                                              index(value["skin"]),
-                                              index(value["frame"]));
+                case EL::ValueType::Map: {
+                    // look up the values in place instead of copying them
+                    const auto& map = value.mapValue();
+                    const auto get = [&](const std::string& key) -> const EL::Value& {
+                        const auto it = map.find(key);
+                        return it != std::end(map) ? it->second : EL::Value::Null;
+                    };
+                    return ModelSpecification( path(get("path")),
+                                              index(get("skin")),
+                                              index(get("frame")));
+                }
                 case EL::ValueType::String:
                     return ModelSpecification(path(value));
                 case EL::ValueType::Boolean:
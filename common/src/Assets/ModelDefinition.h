@@ -23,6 +23,10 @@
 #include "IO/Path.h"
 
 #include <iosfwd>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Assets {
@@ -48,6 +52,20 @@ namespace TrenchBroom {
         class ModelDefinition {
         private:
             EL::Expression m_expression;
+            /**
+             * If the expression does not depend on any variables, it is folded into a literal and the resulting model
+             * specification is computed once, so that evaluating it for each entity is free.
+             */
+            std::optional<ModelSpecification> m_constantSpecification;
+
+            /**
+             * Otherwise, the results are memoized by the values of the variables which the expression reads, so that
+             * entities which agree on these values share one evaluation. Copies of a model definition share the
+             * memo because they have the same expression.
+             */
+            struct SpecificationMemo;
+            std::vector<std::string> m_variableNames;
+            std::shared_ptr<SpecificationMemo> m_memo;
         public:
             ModelDefinition();
             ModelDefinition(size_t line, size_t column);
@@ -57,6 +75,8 @@ namespace TrenchBroom {
             friend bool operator!=(const ModelDefinition& lhs, const ModelDefinition& rhs);
             friend std::ostream& operator<<(std::ostream& str, const ModelDefinition& def);
 
+            const EL::Expression& expression() const;
+
             void append(const ModelDefinition& other);
 
             /**
@@ -78,6 +98,8 @@ namespace TrenchBroom {
              */
             ModelSpecification defaultModelSpecification() const;
         private:
+            void prepareEvaluation();
+            std::string signature(const EL::VariableStore& variableStore) const;
             ModelSpecification convertToModel(const EL::Value& value) const;
             IO::Path path(const EL::Value& value) const;
             size_t index(const EL::Value& value) const;
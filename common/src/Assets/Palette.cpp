@@ -29,6 +29,8 @@
 
 #include <kdl/string_format.h>
 
+#include <array>
+#include <cstdint>
 #include <cstring>
 #include <string>
 
@@ -137,20 +139,25 @@ namespace TrenchBroom {
             const unsigned char* indexedImage = reinterpret_cast<const unsigned char*>(reader.begin() + reader.position());
             reader.seekForward(pixelCount); // throws ReaderException if there aren't pixelCount bytes available
 
-            // Write rgba pixels
+            // Write rgba pixels and count how often each index occurs, which lets us compute the average color and
+            // check for transparency from the histogram instead of reading the pixels again
+            auto histogram = std::array<size_t, 256>{};
+
             unsigned char* const rgbaData = rgbaImage.data();
             for (size_t i = 0; i < pixelCount; ++i) {
-                const int index = static_cast<int>(indexedImage[i]);
+                const auto index = static_cast<size_t>(indexedImage[i]);
+                ++histogram[index];
 
                 std::memcpy(rgbaData + (i * 4), &paletteData[index * 4], 4);
             }
 
-            // Check average color
-            uint32_t colorSum[3] = {0, 0, 0};
-            for (size_t i = 0; i < pixelCount; ++i) {
-                colorSum[0] += static_cast<uint32_t>(rgbaData[(i * 4) + 0]);
-                colorSum[1] += static_cast<uint32_t>(rgbaData[(i * 4) + 1]);
-                colorSum[2] += static_cast<uint32_t>(rgbaData[(i * 4) + 2]);
+            // Compute average color
+            uint64_t colorSum[3] = {0, 0, 0};
+            for (size_t index = 0; index < histogram.size(); ++index) {
+                const auto count = static_cast<uint64_t>(histogram[index]);
+                colorSum[0] += count * static_cast<uint64_t>(paletteData[(index * 4) + 0]);
+                colorSum[1] += count * static_cast<uint64_t>(paletteData[(index * 4) + 1]);
+                colorSum[2] += count * static_cast<uint64_t>(paletteData[(index * 4) + 2]);
             }
             averageColor = Color(static_cast<float>(colorSum[0]) / (255.0f * static_cast<float>(pixelCount)),
                                  static_cast<float>(colorSum[1]) / (255.0f * static_cast<float>(pixelCount)),
@@ -158,15 +165,7 @@ namespace TrenchBroom {
                                  1.0f);
 
             // Check for transparency
-            bool hasTransparency = false;
-            if (transparency == PaletteTransparency::Index255Transparent) {
-                // Take the bitwise AND of the alpha channel of all pixels
-                unsigned char andAlpha = 0xff;
-                for (size_t i = 0; i < pixelCount; ++i) {
-                    andAlpha &= rgbaData[(i * 4) + 3];
-                }
-                hasTransparency = (andAlpha != 0xff);
-            }
+            const bool hasTransparency = transparency == PaletteTransparency::Index255Transparent && histogram[255] > 0;
 
             return hasTransparency;
         }
@@ -24,8 +24,11 @@
 #include "Renderer/GL.h"
 
 #include <algorithm> // for std::max
+#include <atomic>
 #include <cassert>
+#include <exception>
 #include <ostream>
+#include <utility>
 
 namespace TrenchBroom {
     namespace Assets {
@@ -47,6 +50,45 @@ namespace TrenchBroom {
             return str;
         }
 
+        namespace {
+            struct UploadBudgetState {
+                bool inFrame = false;
+                std::chrono::steady_clock::duration budget = std::chrono::steady_clock::duration::zero();
+                std::chrono::steady_clock::duration spent = std::chrono::steady_clock::duration::zero();
+                bool anyUploaded = false;
+                bool anyDeferred = false;
+            };
+
+            // textures are only uploaded on the main thread
+            UploadBudgetState uploadBudgetState;
+
+            // textures may be destroyed on other threads
+            std::atomic<size_t> totalUploadedBytes{0u};
+        }
+
+        void TextureUploadBudget::beginFrame(const std::chrono::milliseconds budget) {
+            uploadBudgetState = UploadBudgetState{true, budget};
+        }
+
+        bool TextureUploadBudget::endFrame() {
+            const auto anyDeferred = uploadBudgetState.anyDeferred;
+            uploadBudgetState = UploadBudgetState{};
+            return anyDeferred;
+        }
+
+        bool TextureUploadBudget::canUpload() {
+            return !uploadBudgetState.inFrame || !uploadBudgetState.anyUploaded || uploadBudgetState.spent < uploadBudgetState.budget;
+        }
+
+        void TextureUploadBudget::deferUpload() {
+            uploadBudgetState.anyDeferred = true;
+        }
+
+        void TextureUploadBudget::addUploadTime(const std::chrono::steady_clock::duration duration) {
+            uploadBudgetState.anyUploaded = true;
+            uploadBudgetState.spent += duration;
+        }
+
         Texture::Texture(const std::string& name, const size_t width, const size_t height, const Color& averageColor, Buffer&& buffer, const GLenum format, const TextureType type, GameData gameData) :
         m_name(name),
         m_width(width),
@@ -59,6 +101,9 @@ namespace TrenchBroom {
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{TextureBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
         m_textureId{0},
+        m_uploaded{false},
+        m_minFilter{GL_NEAREST},
+        m_magFilter{GL_NEAREST},
         m_gameData{std::move(gameData)} {
             assert(m_width > 0);
             assert(m_height > 0);
@@ -79,6 +124,9 @@ namespace TrenchBroom {
         m_blendFunc{TextureBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
         m_textureId(0),
         m_buffers{std::move(buffers)},
+        m_uploaded{false},
+        m_minFilter{GL_NEAREST},
+        m_magFilter{GL_NEAREST},
         m_gameData{std::move(gameData)} {
             assert(m_width > 0);
             assert(m_height > 0);
@@ -92,6 +140,28 @@ namespace TrenchBroom {
             }
         }
 
+        Texture::Texture(const std::string& name, const size_t width, const size_t height, const Color& averageColor, TextureDecoder decoder, const GLenum format, const TextureType type, GameData gameData) :
+        m_name(name),
+        m_width(width),
+        m_height(height),
+        m_averageColor(averageColor),
+        m_usageCount(0u),
+        m_overridden(false),
+        m_format(format),
+        m_type(type),
+        m_culling(TextureCulling::CullDefault),
+        m_blendFunc{TextureBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
+        m_textureId{0},
+        m_decoder{std::move(decoder)},
+        m_uploaded{false},
+        m_minFilter{GL_NEAREST},
+        m_magFilter{GL_NEAREST},
+        m_gameData{std::move(gameData)} {
+            assert(m_width > 0);
+            assert(m_height > 0);
+            assert(m_decoder);
+        }
+
         Texture::Texture(const std::string& name, const size_t width, const size_t height, const GLenum format, const TextureType type, GameData gameData) :
         m_name(name),
         m_width(width),
@@ -104,14 +174,20 @@ namespace TrenchBroom {
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{TextureBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
         m_textureId{0},
+        m_uploaded{false},
+        m_minFilter{GL_NEAREST},
+        m_magFilter{GL_NEAREST},
         m_gameData{std::move(gameData)} {}
 
-        Texture::~Texture() = default;
+        Texture::~Texture() {
+            totalUploadedBytes -= m_uploadedBytes;
+        }
 
         Texture::Texture(Texture&& other) :
         m_name{std::move(other.m_name)},
         m_absolutePath{std::move(other.m_absolutePath)},
         m_relativePath{std::move(other.m_relativePath)},
+        m_imagePath{std::move(other.m_imagePath)},
         m_width{std::move(other.m_width)},
         m_height{std::move(other.m_height)},
         m_averageColor{std::move(other.m_averageColor)},
@@ -124,12 +200,19 @@ namespace TrenchBroom {
         m_blendFunc{std::move(other.m_blendFunc)},
         m_textureId{std::move(other.m_textureId)},
         m_buffers{std::move(other.m_buffers)},
+        m_decoder{std::move(other.m_decoder)},
+        m_imageTexture{other.m_imageTexture},
+        m_uploaded{std::move(other.m_uploaded)},
+        m_uploadedBytes{std::exchange(other.m_uploadedBytes, 0u)},
+        m_minFilter{std::move(other.m_minFilter)},
+        m_magFilter{std::move(other.m_magFilter)},
         m_gameData{std::move(other.m_gameData)} {}
 
         Texture& Texture::operator=(Texture&& other) {
             m_name = std::move(other.m_name);
             m_absolutePath = std::move(other.m_absolutePath);
             m_relativePath = std::move(other.m_relativePath);
+            m_imagePath = std::move(other.m_imagePath);
             m_width = std::move(other.m_width);
             m_height = std::move(other.m_height);
             m_averageColor = std::move(other.m_averageColor);
@@ -142,6 +225,13 @@ namespace TrenchBroom {
             m_blendFunc = std::move(other.m_blendFunc);
             m_textureId = std::move(other.m_textureId);
             m_buffers = std::move(other.m_buffers);
+            m_decoder = std::move(other.m_decoder);
+            m_imageTexture = other.m_imageTexture;
+            m_uploaded = std::move(other.m_uploaded);
+            totalUploadedBytes -= m_uploadedBytes;
+            m_uploadedBytes = std::exchange(other.m_uploadedBytes, 0u);
+            m_minFilter = std::move(other.m_minFilter);
+            m_magFilter = std::move(other.m_magFilter);
             m_gameData = std::move(other.m_gameData);
             return *this;
         }
@@ -154,6 +244,10 @@ namespace TrenchBroom {
             }
         }
 
+        size_t Texture::uploadedBytes() {
+            return totalUploadedBytes;
+        }
+
         const std::string& Texture::name() const {
             return m_name;
         }
@@ -182,8 +276,44 @@ namespace TrenchBroom {
             return m_height;
         }
 
+        const IO::Path& Texture::imagePath() const {
+            return m_imagePath;
+        }
+
+        void Texture::setImagePath(const IO::Path& imagePath) {
+            m_imagePath = imagePath;
+        }
+
+        void Texture::shareImage(const Texture& imageTexture) {
+            assert(&imageTexture != this);
+            assert(imageTexture.m_imageTexture == nullptr);
+            assert(imageTexture.m_width == m_width && imageTexture.m_height == m_height);
+            assert(!isPrepared());
+
+            m_imageTexture = &imageTexture;
+            m_buffers.clear();
+            m_decoder = nullptr;
+        }
+
+        const Texture& Texture::imageTexture() const {
+            return m_imageTexture != nullptr ? *m_imageTexture : *this;
+        }
+
+        const Texture* Texture::renderTexture() const {
+            if (m_imageTexture != nullptr
+                && m_imageTexture->m_culling == m_culling
+                && m_imageTexture->m_blendFunc.enable == m_blendFunc.enable
+                && (m_blendFunc.enable != TextureBlendFunc::Enable::UseFactors
+                    || (m_imageTexture->m_blendFunc.srcFactor == m_blendFunc.srcFactor
+                        && m_imageTexture->m_blendFunc.destFactor == m_blendFunc.destFactor))) {
+                return m_imageTexture;
+            }
+            return this;
+        }
+
         const Color& Texture::averageColor() const {
-            return m_averageColor;
+            // the average color is only known once the shared image has been decoded
+            return imageTexture().m_averageColor;
         }
 
         bool Texture::masked() const {
@@ -254,52 +384,18 @@ namespace TrenchBroom {
             assert(textureId > 0);
             assert(m_textureId == 0);
 
-            if (!m_buffers.empty()) {
-                glAssert(glPixelStorei(GL_UNPACK_SWAP_BYTES, false));
-                glAssert(glPixelStorei(GL_UNPACK_LSB_FIRST, false));
-                glAssert(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
-                glAssert(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
-                glAssert(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
-                glAssert(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
-
-                glAssert(glBindTexture(GL_TEXTURE_2D, textureId));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
-
-                if (m_type == TextureType::Masked) {
-                    // masked textures don't work well with automatic mipmaps, so we force GL_NEAREST filtering and don't generate any
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_FALSE));
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
-                } else if (m_buffers.size() == 1) {
-                    // generate mipmaps if we don't have any
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE));
-                } else {
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(m_buffers.size() - 1)));
-                }
-
-                // Upload only the first mipmap for masked textures.
-                const auto mipmapsToUpload = (m_type == TextureType::Masked) ? 1u : m_buffers.size();
-
-                for (size_t j = 0; j < mipmapsToUpload; ++j) {
-                    const auto mipSize = sizeAtMipLevel(m_width, m_height, j);
-
-                    const GLvoid* data = reinterpret_cast<const GLvoid*>(m_buffers[j].data());
-                    glAssert(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(j), GL_RGBA,
-                                          static_cast<GLsizei>(mipSize.x()),
-                                          static_cast<GLsizei>(mipSize.y()),
-                                          0, m_format, GL_UNSIGNED_BYTE, data));
-                }
-
-                m_buffers.clear();
+            if (!m_buffers.empty() || m_decoder) {
                 m_textureId = textureId;
+                m_minFilter = minFilter;
+                m_magFilter = magFilter;
             }
         }
 
         void Texture::setMode(const int minFilter, const int magFilter) {
-            if (isPrepared()) {
+            m_minFilter = minFilter;
+            m_magFilter = magFilter;
+
+            if (isPrepared() && m_uploaded) {
                 activate();
                 if (m_type == TextureType::Masked) {
                     // Force GL_NEAREST filtering for masked textures.
@@ -313,9 +409,21 @@ namespace TrenchBroom {
             }
         }
 
-        void Texture::activate() const {
-            if (isPrepared()) {
-                glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
+        bool Texture::activate() const {
+            const auto& image = imageTexture();
+            if (image.isPrepared() && !image.m_uploaded) {
+                if (!TextureUploadBudget::canUpload()) {
+                    TextureUploadBudget::deferUpload();
+                    return false;
+                }
+
+                const auto start = std::chrono::steady_clock::now();
+                image.upload();
+                TextureUploadBudget::addUploadTime(std::chrono::steady_clock::now() - start);
+            }
+
+            if (image.isPrepared()) {
+                glAssert(glBindTexture(GL_TEXTURE_2D, image.m_textureId));
 
                 switch (m_culling) {
                     case Assets::TextureCulling::CullNone:
@@ -342,11 +450,14 @@ namespace TrenchBroom {
                         glAssert(glDisable(GL_BLEND));
                     }
                 }
+                return true;
             }
+            return false;
         }
 
         void Texture::deactivate() const {
-            if (isPrepared()) {
+            const auto& image = imageTexture();
+            if (image.isPrepared() && image.m_uploaded) {
                 if (m_blendFunc.enable != TextureBlendFunc::Enable::UseDefault) {
                     glAssert(glPopAttrib());
                 }
@@ -370,7 +481,100 @@ namespace TrenchBroom {
             }
         }
 
+        void Texture::decode() const {
+            if (m_decoder) {
+                auto decoder = std::move(m_decoder);
+                m_decoder = nullptr;
+
+                try {
+                    auto data = decoder();
+                    m_buffers = std::move(data.buffers);
+                    m_averageColor = data.averageColor;
+                } catch (const std::exception&) {
+                    // the texture will be rendered without any pixel data
+                    m_buffers.clear();
+                }
+            }
+        }
+
+        void Texture::upload() const {
+            assert(isPrepared());
+            assert(!m_uploaded);
+
+            m_uploaded = true;
+            decode();
+
+            if (m_buffers.empty()) {
+                // there is nothing to upload, so we pretend that the texture was never prepared; the texture ID is
+                // still owned and eventually deleted by the texture collection
+                m_textureId = 0;
+                return;
+            }
+
+            glAssert(glPixelStorei(GL_UNPACK_SWAP_BYTES, false));
+            glAssert(glPixelStorei(GL_UNPACK_LSB_FIRST, false));
+            glAssert(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+            glAssert(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
+            glAssert(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
+            glAssert(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+            glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
+            glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_minFilter));
+            glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_magFilter));
+            glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
+            glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
+
+            // if we don't have any mipmaps, we let the GPU generate them after uploading the first level; the legacy
+            // GL_GENERATE_MIPMAP parameter is only used if glGenerateMipmap is not available
+            const auto generateMipmapsAfterUpload = m_type != TextureType::Masked && m_buffers.size() == 1 && (GLEW_VERSION_3_0 || GLEW_ARB_framebuffer_object);
+
+            if (m_type == TextureType::Masked) {
+                // masked textures don't work well with automatic mipmaps, so we force GL_NEAREST filtering and don't generate any
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_FALSE));
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+            } else if (m_buffers.size() == 1 && !generateMipmapsAfterUpload) {
+                // generate mipmaps if we don't have any
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE));
+            } else if (m_buffers.size() > 1) {
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(m_buffers.size() - 1)));
+            }
+
+            // Upload only the first mipmap for masked textures.
+            const auto mipmapsToUpload = (m_type == TextureType::Masked) ? 1u : m_buffers.size();
+
+            auto uploadedBytes = size_t(0);
+            for (size_t j = 0; j < mipmapsToUpload; ++j) {
+                const auto mipSize = sizeAtMipLevel(m_width, m_height, j);
+                uploadedBytes += mipSize.x() * mipSize.y() * 4u; // the internal format is GL_RGBA
+
+                const GLvoid* data = reinterpret_cast<const GLvoid*>(m_buffers[j].data());
+                glAssert(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(j), GL_RGBA,
+                                      static_cast<GLsizei>(mipSize.x()),
+                                      static_cast<GLsizei>(mipSize.y()),
+                                      0, m_format, GL_UNSIGNED_BYTE, data));
+            }
+
+            if (generateMipmapsAfterUpload) {
+                glAssert(glGenerateMipmap(GL_TEXTURE_2D));
+            }
+
+            if (m_type != TextureType::Masked && m_buffers.size() == 1) {
+                // the generated mipmaps add about a third of the base level
+                uploadedBytes += uploadedBytes / 3u;
+            }
+            m_uploadedBytes = uploadedBytes;
+            totalUploadedBytes += uploadedBytes;
+
+            // the texture is bound again by activate()
+            glAssert(glBindTexture(GL_TEXTURE_2D, 0));
+            m_buffers.clear();
+        }
+
         const Texture::BufferList& Texture::buffersIfUnprepared() const {
+            if (!m_uploaded) {
+                decode();
+            }
             return m_buffers;
         }
 
@@ -27,6 +27,8 @@
 #include <vecmath/forward.h>
 
 #include <atomic>
+#include <chrono>
+#include <functional>
 #include <iosfwd>
 #include <set>
 #include <string>
@@ -86,6 +88,40 @@ namespace TrenchBroom {
 
         using GameData = std::variant<std::monostate, Q2Data>;
 
+        /**
+         * The pixel data of a texture whose decoding has been deferred until it is first used.
+         */
+        struct DecodedTextureData {
+            TextureBufferList buffers;
+            Color averageColor;
+        };
+
+        /**
+         * Decodes the pixel data of a texture. May throw an exception if the data cannot be decoded.
+         */
+        using TextureDecoder = std::function<DecodedTextureData()>;
+
+        /**
+         * Limits the time that is spent decoding and uploading textures while a frame is rendered. Once the budget
+         * of a frame is exhausted, textures that haven't been uploaded yet are not activated and are rendered with
+         * their average color instead. At least one texture is uploaded per frame, so every texture is eventually
+         * uploaded as long as frames keep being rendered.
+         *
+         * Outside of a frame, texture uploads are not limited.
+         */
+        class TextureUploadBudget {
+        public:
+            static void beginFrame(std::chrono::milliseconds budget);
+            /**
+             * Ends the current frame and returns whether any texture upload was deferred during the frame.
+             */
+            static bool endFrame();
+
+            static bool canUpload();
+            static void deferUpload();
+            static void addUploadTime(std::chrono::steady_clock::duration duration);
+        };
+
         class Texture {
         private:
             using Buffer = TextureBuffer;
@@ -94,10 +130,11 @@ namespace TrenchBroom {
             std::string m_name;
             IO::Path m_absolutePath;
             IO::Path m_relativePath;
+            IO::Path m_imagePath;
 
             size_t m_width;
             size_t m_height;
-            Color m_averageColor;
+            mutable Color m_averageColor;
 
             std::atomic<size_t> m_usageCount;
             bool m_overridden;
@@ -117,11 +154,22 @@ namespace TrenchBroom {
 
             mutable GLuint m_textureId;
             mutable BufferList m_buffers;
+            mutable TextureDecoder m_decoder;
+            const Texture* m_imageTexture = nullptr;
+            mutable bool m_uploaded;
+            mutable size_t m_uploadedBytes = 0u;
+            int m_minFilter;
+            int m_magFilter;
 
             GameData m_gameData;
         public:
             Texture(const std::string& name, size_t width, size_t height, const Color& averageColor, Buffer&& buffer, GLenum format, TextureType type, GameData gameData = std::monostate{});
             Texture(const std::string& name, size_t width, size_t height, const Color& averageColor, BufferList&& buffers, GLenum format, TextureType type, GameData gameData = std::monostate{});
+            /**
+             * Creates a texture whose pixel data is decoded by the given decoder when the texture is first activated.
+             * Until then, the given average color is used as a placeholder.
+             */
+            Texture(const std::string& name, size_t width, size_t height, const Color& averageColor, TextureDecoder decoder, GLenum format, TextureType type, GameData gameData = std::monostate{});
             Texture(const std::string& name, size_t width, size_t height, GLenum format = GL_RGB, TextureType type = TextureType::Opaque, GameData gameData = std::monostate{});
 
             Texture(const Texture&) = delete;
@@ -134,6 +182,11 @@ namespace TrenchBroom {
 
             static TextureType selectTextureType(bool masked);
 
+            /**
+             * Returns an estimate of the video memory used by all textures that are currently uploaded, in bytes.
+             */
+            static size_t uploadedBytes();
+
             const std::string& name() const;
 
             /**
@@ -152,6 +205,36 @@ namespace TrenchBroom {
             const IO::Path& relativePath() const;
             void setRelativePath(const IO::Path& relativePath);
 
+            /**
+             * Path of the image file that provides the pixel data of this texture if it is not the texture file itself,
+             * e.g. the editor image of a Quake 3 shader. Textures of a collection with the same image path share
+             * their image.
+             *
+             * Currently, only set for textures loaded by Quake3ShaderTextureReader
+             */
+            const IO::Path& imagePath() const;
+            void setImagePath(const IO::Path& imagePath);
+
+            /**
+             * Makes this texture use the pixel data and the GL texture of the given texture instead of its own, which
+             * is discarded. The given texture must have the same dimensions and must outlive this texture. Culling and
+             * blending are still controlled by this texture.
+             */
+            void shareImage(const Texture& imageTexture);
+
+            /**
+             * Returns the texture whose GL texture this texture binds, which is either this texture or the texture
+             * whose image it shares.
+             */
+            const Texture& imageTexture() const;
+
+            /**
+             * Returns a texture that renders exactly like this texture. If this texture shares the image of a texture
+             * that has the same culling and blending settings, then that texture is returned, otherwise this texture.
+             * Faces with the same render texture can be rendered with a single texture activation.
+             */
+            const Texture* renderTexture() const;
+
             size_t width() const;
             size_t height() const;
             const Color& averageColor() const;
@@ -177,15 +260,27 @@ namespace TrenchBroom {
             void setOverridden(bool overridden);
 
             bool isPrepared() const;
+            /**
+             * Assigns the given texture ID to this texture. The texture data is not uploaded until the texture is
+             * activated for the first time, so that textures which are never rendered don't occupy any video memory
+             * and deferred textures are never decoded.
+             */
             void prepare(GLuint textureId, int minFilter, int magFilter);
             void setMode(int minFilter, int magFilter);
 
-            void activate() const;
+            /**
+             * Binds this texture, uploading its data first if necessary. Returns false if the texture could not be
+             * bound, either because it has no data or because its upload was deferred to a later frame.
+             */
+            bool activate() const;
             void deactivate() const;
+        private:
+            void decode() const;
+            void upload() const;
         public: // exposed for tests only
             /**
-             * Returns the texture data in the format returned by format().
-             * Once prepare() is called, this will be an empty vector.
+             * Returns the texture data in the format returned by format(), decoding it if necessary.
+             * Once the texture has been uploaded, this will be an empty vector.
              */
             const BufferList& buffersIfUnprepared() const;
             /**
@@ -25,7 +25,7 @@
 
 #include <FreeImage.h>
 
-#include <algorithm> // for std::max
+#include <algorithm> // for std::max, std::min
 
 namespace TrenchBroom {
     namespace Assets {
@@ -111,5 +111,34 @@ namespace TrenchBroom {
                 FreeImage_Unload(newBitmap);
             }
         }
+
+        TextureBuffer downsampleBuffer(const TextureBuffer& buffer, const vm::vec2s& size, const GLenum format) {
+            const auto bytesPerPixel = bytesPerPixelForFormat(format);
+            ensure(buffer.size() >= bytesPerPixel * size.x() * size.y(), "buffer is too small");
+
+            const auto newSize = sizeAtMipLevel(size.x(), size.y(), 1);
+            auto result = TextureBuffer(bytesPerPixel * newSize.x() * newSize.y());
+
+            const auto* src = buffer.data();
+            auto* dest = result.data();
+            for (size_t y = 0; y < newSize.y(); ++y) {
+                const auto y0 = std::min(2 * y, size.y() - 1);
+                const auto y1 = std::min(2 * y + 1, size.y() - 1);
+                for (size_t x = 0; x < newSize.x(); ++x) {
+                    const auto x0 = std::min(2 * x, size.x() - 1);
+                    const auto x1 = std::min(2 * x + 1, size.x() - 1);
+                    for (size_t c = 0; c < bytesPerPixel; ++c) {
+                        const auto sum =
+                            static_cast<unsigned int>(src[(y0 * size.x() + x0) * bytesPerPixel + c]) +
+                            static_cast<unsigned int>(src[(y0 * size.x() + x1) * bytesPerPixel + c]) +
+                            static_cast<unsigned int>(src[(y1 * size.x() + x0) * bytesPerPixel + c]) +
+                            static_cast<unsigned int>(src[(y1 * size.x() + x1) * bytesPerPixel + c]);
+                        dest[(y * newSize.x() + x) * bytesPerPixel + c] = static_cast<unsigned char>((sum + 2u) / 4u);
+                    }
+                }
+            }
+
+            return result;
+        }
     }
 }
@@ -48,6 +48,16 @@ namespace TrenchBroom {
         void setMipBufferSize(TextureBufferList& buffers, size_t mipLevels, size_t width, size_t height, GLenum format);
 
         void resizeMips(TextureBufferList& buffers, const vm::vec2s& oldSize, const vm::vec2s& newSize);
+
+        /**
+         * Returns a buffer of half the given size (but at least one pixel in each dimension), where each pixel is the
+         * average of the corresponding 2x2 block of pixels of the given buffer.
+         *
+         * @param buffer the buffer to downsample
+         * @param size the width and height of the given buffer in pixels
+         * @param format the pixel format of the given buffer
+         */
+        TextureBuffer downsampleBuffer(const TextureBuffer& buffer, const vm::vec2s& size, GLenum format);
     }
 }
 
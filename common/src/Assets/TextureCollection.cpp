@@ -23,6 +23,7 @@
 
 #include <kdl/vector_utils.h>
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -33,7 +34,9 @@ namespace TrenchBroom {
 
         TextureCollection::TextureCollection(std::vector<Texture> textures) :
         m_loaded(false),
-        m_textures(std::move(textures)) {}
+        m_textures(std::move(textures)) {
+            shareImages();
+        }
 
         TextureCollection::TextureCollection(const IO::Path& path) :
         m_loaded(false),
@@ -42,7 +45,9 @@ namespace TrenchBroom {
         TextureCollection::TextureCollection(const IO::Path& path, std::vector<Texture> textures) :
         m_loaded(true),
         m_path(path),
-        m_textures(std::move(textures)) {}
+        m_textures(std::move(textures)) {
+            shareImages();
+        }
 
         TextureCollection::~TextureCollection() {
             if (!m_textureIds.empty()) {
@@ -127,5 +132,22 @@ namespace TrenchBroom {
                 texture.setMode(minFilter, magFilter);
             }
         }
+
+        void TextureCollection::shareImages() {
+            std::map<IO::Path, const Texture*> texturesByImagePath;
+            for (auto& texture : m_textures) {
+                if (texture.imagePath().isEmpty()) {
+                    continue;
+                }
+
+                const auto [it, inserted] = texturesByImagePath.emplace(texture.imagePath(), &texture);
+                if (!inserted) {
+                    const auto* imageTexture = it->second;
+                    if (imageTexture->width() == texture.width() && imageTexture->height() == texture.height()) {
+                        texture.shareImage(*imageTexture);
+                    }
+                }
+            }
+        }
     }
 }
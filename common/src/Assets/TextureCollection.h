@@ -70,6 +70,12 @@ namespace TrenchBroom {
             bool prepared() const;
             void prepare(int minFilter, int magFilter);
             void setTextureMode(int minFilter, int magFilter);
+        private:
+            /**
+             * Lets all textures with the same image path share the image of the first such texture, so that the
+             * image is decoded and uploaded only once.
+             */
+            void shareImages();
         };
     }
 }
@@ -19,20 +19,26 @@
 
 #include "TextureManager.h"
 
+#include "BufferedLogger.h"
 #include "Exceptions.h"
 #include "Logger.h"
 #include "Assets/Texture.h"
 #include "Assets/TextureCollection.h"
 #include "IO/TextureLoader.h"
+#include "Model/InternedString.h"
 
-#include <kdl/map_utils.h>
+#include <kdl/parallel.h>
+#include <kdl/string_compare.h>
 #include <kdl/string_format.h>
 #include <kdl/vector_utils.h>
 
 #include <algorithm>
 #include <chrono>
 #include <iterator>
+#include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
@@ -56,35 +62,79 @@ namespace TrenchBroom {
             }
         };
 
+        /**
+         * FNV-1a hash of the case folded name, so that lookups need not create a lower case copy of the name.
+         */
+        static size_t hashTextureName(const std::string_view name) {
+            auto hash = size_t(14695981039346656037ull);
+            for (const auto c : name) {
+                hash ^= static_cast<size_t>(static_cast<unsigned char>(kdl::str_to_lower(c)));
+                hash *= size_t(1099511628211ull);
+            }
+            return hash;
+        }
+
         TextureManager::TextureManager(int magFilter, int minFilter, Logger& logger) :
         m_logger(logger),
+        m_loadAsynchronously(false),
         m_minFilter(minFilter),
         m_magFilter(magFilter),
         m_resetTextureMode(false) {}
 
         TextureManager::~TextureManager() = default;
 
+        namespace {
+            struct LoadedCollection {
+                std::optional<TextureCollection> collection;
+                std::string error;
+                long long milliseconds;
+                std::unique_ptr<BufferedLogger> logger;
+            };
+        }
+
         void TextureManager::setTextureCollections(const std::vector<IO::Path>& paths, IO::TextureLoader& loader) {
             auto collections = std::move(m_collections);
             clear();
 
+            const auto findCollection = [&](const IO::Path& path) {
+                return std::find_if(std::begin(collections), std::end(collections), [&](const auto& c) { return c.path() == path; });
+            };
+
+            // The collections are independent of each other, so the ones that must be (re)loaded are loaded
+            // concurrently. They are added in the order of the given paths afterwards, which determines which
+            // collection's textures take precedence. The loggers may only be used on this thread, so each
+            // collection logs to its own buffer, which is flushed in the order of the paths.
+            const auto pathsToLoad = kdl::vec_filter(paths, [&](const auto& path) {
+                const auto it = findCollection(path);
+                return it == std::end(collections) || !it->loaded();
+            });
+            auto loadedCollections = kdl::vec_parallel_transform(pathsToLoad, [&](const IO::Path& path) {
+                auto logger = std::make_unique<BufferedLogger>();
+                const auto startTime = std::chrono::high_resolution_clock::now();
+                try {
+                    auto collection = loader.loadTextureCollection(path, *logger);
+                    const auto endTime = std::chrono::high_resolution_clock::now();
+                    return LoadedCollection{std::move(collection), "", std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count(), std::move(logger)};
+                } catch (const Exception& e) {
+                    return LoadedCollection{std::nullopt, e.what(), 0, std::move(logger)};
+                }
+            });
+
+            auto loadedCollection = std::begin(loadedCollections);
             for (const auto& path : paths) {
-                const auto it = std::find_if(std::begin(collections), std::end(collections), [&](const auto& c) { return c.path() == path; });
+                const auto it = findCollection(path);
                 if (it == std::end(collections) || !it->loaded()) {
-                    try {
-                        const auto startTime = std::chrono::high_resolution_clock::now();
-                        auto collection = loader.loadTextureCollection(path);
-                        const auto endTime = std::chrono::high_resolution_clock::now();
-
-                        m_logger.info() << "Loaded texture collection '" << path << "' in "
-                                        << std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count() << "ms";
-                        addTextureCollection(std::move(collection));
-                    } catch (const Exception& e) {
+                    loadedCollection->logger->flush(m_logger);
+                    if (loadedCollection->collection) {
+                        m_logger.info() << "Loaded texture collection '" << path << "' in " << loadedCollection->milliseconds << "ms";
+                        addTextureCollection(std::move(*loadedCollection->collection));
+                    } else {
                         addTextureCollection(Assets::TextureCollection(path));
                         if (it == std::end(collections)) {
-                            m_logger.error() << "Could not load texture collection '" << path << "': " << e.what();
+                            m_logger.error() << "Could not load texture collection '" << path << "': " << loadedCollection->error;
                         }
                     }
+                    ++loadedCollection;
                 } else {
                     addTextureCollection(std::move(*it));
                 }
@@ -104,6 +154,94 @@ namespace TrenchBroom {
             updateTextures();
         }
 
+        void TextureManager::setTextureCollectionsAsync(const std::vector<IO::Path>& paths, std::shared_ptr<IO::TextureLoader> loader) {
+            auto collections = std::move(m_collections);
+            clear();
+
+            for (const auto& path : paths) {
+                const auto it = std::find_if(std::begin(collections), std::end(collections), [&](const auto& c) { return c.path() == path; });
+                if (it == std::end(collections) || !it->loaded()) {
+                    const auto index = m_collections.size();
+                    addTextureCollection(Assets::TextureCollection(path));
+
+                    auto collection = std::async(std::launch::async, [loader, path, &logger = m_backgroundLogger]() {
+                        const auto startTime = std::chrono::high_resolution_clock::now();
+                        auto result = loader->loadTextureCollection(path);
+                        const auto endTime = std::chrono::high_resolution_clock::now();
+
+                        logger.info() << "Loaded texture collection '" << path << "' in "
+                                      << std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count() << "ms";
+                        return result;
+                    });
+                    m_pendingCollections.push_back(PendingCollection{index, path, it == std::end(collections), std::move(collection)});
+                } else {
+                    addTextureCollection(std::move(*it));
+                }
+                if (it != std::end(collections)) {
+                    collections.erase(it);
+                }
+            }
+
+            updateTextures();
+            m_toRemove = kdl::vec_concat(std::move(m_toRemove), std::move(collections));
+        }
+
+        bool TextureManager::collectLoadedCollections() {
+            auto collected = false;
+
+            auto it = std::begin(m_pendingCollections);
+            while (it != std::end(m_pendingCollections)) {
+                if (it->collection.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                    ++it;
+                    continue;
+                }
+
+                try {
+                    m_collections[it->index] = it->collection.get();
+                    if (m_collections[it->index].loaded() && !m_collections[it->index].prepared()) {
+                        m_toPrepare.push_back(it->index);
+                    }
+                    collected = true;
+                } catch (const Exception& e) {
+                    if (it->logErrors) {
+                        m_logger.error() << "Could not load texture collection '" << it->path << "': " << e.what();
+                    }
+                }
+                it = m_pendingCollections.erase(it);
+            }
+
+            m_backgroundLogger.flush(m_logger);
+
+            if (collected) {
+                updateTextures();
+            }
+            return collected;
+        }
+
+        bool TextureManager::hasPendingCollections() const {
+            return !m_pendingCollections.empty();
+        }
+
+        bool TextureManager::loadAsynchronously() const {
+            return m_loadAsynchronously;
+        }
+
+        void TextureManager::setLoadAsynchronously(const bool loadAsynchronously) {
+            m_loadAsynchronously = loadAsynchronously;
+        }
+
+        Logger& TextureManager::backgroundLogger() {
+            return m_backgroundLogger;
+        }
+
+        std::shared_ptr<IO::TextureCache> TextureManager::textureCache() const {
+            return m_textureCache;
+        }
+
+        void TextureManager::setTextureCache(std::shared_ptr<IO::TextureCache> textureCache) {
+            m_textureCache = std::move(textureCache);
+        }
+
         void TextureManager::addTextureCollection(Assets::TextureCollection collection) {
             const auto index = m_collections.size();
             m_collections.push_back(std::move(collection));
@@ -116,15 +254,37 @@ namespace TrenchBroom {
         }
 
         void TextureManager::clear() {
+            // the futures block until the loaders have finished
+            m_pendingCollections.clear();
+            m_backgroundLogger.clear();
+
             m_collections.clear();
 
             m_toPrepare.clear();
-            m_texturesByName.clear();
+            m_textureIndex.clear();
             m_textures.clear();
 
             // Remove logging because it might fail when the document is already destroyed.
         }
 
+        void TextureManager::unloadTextureCollections(const std::vector<IO::Path>& paths) {
+            auto unloaded = false;
+            for (size_t i = 0u; i < m_collections.size(); ++i) {
+                auto& collection = m_collections[i];
+                if (collection.loaded() && kdl::vec_contains(paths, collection.path())) {
+                    auto path = collection.path();
+                    m_toRemove.push_back(std::move(collection));
+                    collection = TextureCollection(std::move(path));
+                    m_toPrepare = kdl::vec_erase(std::move(m_toPrepare), i);
+                    unloaded = true;
+                }
+            }
+
+            if (unloaded) {
+                updateTextures();
+            }
+        }
+
         void TextureManager::setTextureMode(const int minFilter, const int magFilter) {
             m_minFilter = minFilter;
             m_magFilter = magFilter;
@@ -137,19 +297,30 @@ namespace TrenchBroom {
             m_toRemove.clear();
         }
 
-        const Texture* TextureManager::texture(const std::string& name) const {
-            auto it = m_texturesByName.find(kdl::str_to_lower(name));
-            if (it == std::end(m_texturesByName)) {
-                return nullptr;
-            } else {
-                return it->second;
-            }
+        const Texture* TextureManager::texture(const std::string_view name) const {
+            const auto* slot = findSlot(name, hashTextureName(name));
+            return slot ? slot->texture : nullptr;
         }
 
-        Texture* TextureManager::texture(const std::string& name) {
+        Texture* TextureManager::texture(const std::string_view name) {
             return const_cast<Texture*>(const_cast<const TextureManager*>(this)->texture(name));
         }
 
+        std::vector<Texture*> TextureManager::textures(const std::vector<Model::InternedString>& names) {
+            auto cache = std::unordered_map<const std::string*, Texture*>{};
+
+            auto result = std::vector<Texture*>{};
+            result.reserve(names.size());
+            for (const auto& name : names) {
+                const auto [it, inserted] = cache.try_emplace(&name.str(), nullptr);
+                if (inserted) {
+                    it->second = texture(name.str());
+                }
+                result.push_back(it->second);
+            }
+            return result;
+        }
+
         const std::vector<const Texture*>& TextureManager::textures() const {
             return m_textures;
         }
@@ -176,25 +347,66 @@ namespace TrenchBroom {
         }
 
         void TextureManager::updateTextures() {
-            m_texturesByName.clear();
+            m_textureIndex.clear();
             m_textures.clear();
 
+            auto textureCount = size_t(0);
+            for (const auto& collection : m_collections) {
+                textureCount += collection.textureCount();
+            }
+
+            // keep the load factor at or below 0.5 so that probe sequences stay short
+            auto capacity = size_t(16);
+            while (capacity < 2u * textureCount) {
+                capacity *= 2u;
+            }
+            m_textureIndex.resize(capacity, TextureSlot{0, nullptr});
+
             for (auto& collection : m_collections) {
                 for (auto& texture : collection.textures()) {
-                    const auto key = kdl::str_to_lower(texture.name());
                     texture.setOverridden(false);
 
-                    auto mIt = m_texturesByName.find(key);
-                    if (mIt != std::end(m_texturesByName)) {
-                        mIt->second->setOverridden(true);
-                        mIt->second = &texture;
-                    } else {
-                        m_texturesByName.insert(std::make_pair(key, &texture));
+                    const auto hash = hashTextureName(texture.name());
+                    auto index = hash & (capacity - 1u);
+                    while (m_textureIndex[index].texture != nullptr) {
+                        auto& slot = m_textureIndex[index];
+                        if (slot.hash == hash && kdl::ci::str_is_equal(slot.texture->name(), texture.name())) {
+                            // textures in later collections override textures with the same name in earlier ones
+                            slot.texture->setOverridden(true);
+                            break;
+                        }
+                        index = (index + 1u) & (capacity - 1u);
                     }
+
+                    m_textureIndex[index] = TextureSlot{hash, &texture};
+                }
+            }
+
+            m_textures.reserve(textureCount);
+            for (const auto& slot : m_textureIndex) {
+                if (slot.texture != nullptr) {
+                    m_textures.push_back(slot.texture);
                 }
             }
 
-            m_textures = kdl::vec_transform(kdl::map_values(m_texturesByName), [](auto* t) { return const_cast<const Texture*>(t); });
+            std::sort(std::begin(m_textures), std::end(m_textures), [](const Texture* lhs, const Texture* rhs) {
+                return kdl::ci::str_compare(lhs->name(), rhs->name()) < 0;
+            });
+        }
+
+        const TextureManager::TextureSlot* TextureManager::findSlot(const std::string_view name, const size_t hash) const {
+            if (m_textureIndex.empty()) {
+                return nullptr;
+            }
+
+            const auto mask = m_textureIndex.size() - 1u;
+            for (auto index = hash & mask; m_textureIndex[index].texture != nullptr; index = (index + 1u) & mask) {
+                const auto& slot = m_textureIndex[index];
+                if (slot.hash == hash && kdl::ci::str_is_equal(slot.texture->name(), name)) {
+                    return &slot;
+                }
+            }
+            return nullptr;
         }
     }
 }
@@ -19,36 +19,67 @@
 
 #pragma once
 
+#include "BufferedLogger.h"
 #include "Assets/TextureCollection.h"
+#include "IO/Path.h"
 
-#include <map>
+#include <future>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace TrenchBroom {
     class Logger;
 
     namespace IO {
-        class Path;
+        class TextureCache;
         class TextureLoader;
     }
 
+    namespace Model {
+        class InternedString;
+    }
+
     namespace Assets {
         class Texture;
         class TextureCollection;
 
         class TextureManager {
         private:
-            using TextureMap = std::map<std::string, Texture*>;
+            /**
+             * A slot of the open addressing hash index that maps case folded texture names to textures. A slot
+             * without a texture is empty.
+             */
+            struct TextureSlot {
+                size_t hash;
+                Texture* texture;
+            };
+
+            /**
+             * A texture collection that is being loaded on a worker thread. Until it has been loaded, the collection
+             * at the given index is an unloaded placeholder.
+             */
+            struct PendingCollection {
+                size_t index;
+                IO::Path path;
+                bool logErrors;
+                std::future<TextureCollection> collection;
+            };
 
             Logger& m_logger;
 
             std::vector<TextureCollection> m_collections;
+            // must be declared before the pending collections because their loaders log into it
+            BufferedLogger m_backgroundLogger;
+            std::vector<PendingCollection> m_pendingCollections;
+            bool m_loadAsynchronously;
+            std::shared_ptr<IO::TextureCache> m_textureCache;
 
             std::vector<size_t> m_toPrepare;
             std::vector<TextureCollection> m_toRemove;
 
-            TextureMap m_texturesByName;
+            std::vector<TextureSlot> m_textureIndex;
             std::vector<const Texture*> m_textures;
 
             int m_minFilter;
@@ -60,16 +91,64 @@ namespace TrenchBroom {
 
             void setTextureCollections(const std::vector<IO::Path>& paths, IO::TextureLoader& loader);
             void setTextureCollections(std::vector<TextureCollection> collections);
+
+            /**
+             * Like setTextureCollections, but the collections that are not loaded yet are loaded on worker threads.
+             * They are represented by unloaded placeholders until collectLoadedCollections picks them up.
+             *
+             * The given loader must only log to backgroundLogger(), and the file system it reads from must not be
+             * modified until the pending collections have been collected or clear() has been called.
+             */
+            void setTextureCollectionsAsync(const std::vector<IO::Path>& paths, std::shared_ptr<IO::TextureLoader> loader);
+
+            /**
+             * Replaces the placeholders of the collections that have finished loading in the background with the
+             * loaded collections. Returns true if any textures were added.
+             */
+            bool collectLoadedCollections();
+            bool hasPendingCollections() const;
+
+            bool loadAsynchronously() const;
+            void setLoadAsynchronously(bool loadAsynchronously);
+
+            /**
+             * The logger to use for loaders that run on worker threads. Its messages are forwarded to this manager's
+             * logger by collectLoadedCollections.
+             */
+            Logger& backgroundLogger();
+
+            /**
+             * The cache that loaders should use to look up decoded textures, or null if textures should not be cached.
+             */
+            std::shared_ptr<IO::TextureCache> textureCache() const;
+            void setTextureCache(std::shared_ptr<IO::TextureCache> textureCache);
         private:
             void addTextureCollection(Assets::TextureCollection collection);
         public:
+            /**
+             * Removes all texture collections. Blocks until any collections that are still loading in the background
+             * have finished loading and discards them.
+             */
             void clear();
 
+            /**
+             * Replaces the loaded collections with the given paths by unloaded placeholders, so that the next call to
+             * setTextureCollections or setTextureCollectionsAsync loads them again while keeping all other
+             * collections. The textures of the unloaded collections must no longer be referenced.
+             */
+            void unloadTextureCollections(const std::vector<IO::Path>& paths);
+
             void setTextureMode(int minFilter, int magFilter);
             void commitChanges();
 
-            const Texture* texture(const std::string& name) const;
-            Texture* texture(const std::string& name);
+            const Texture* texture(std::string_view name) const;
+            Texture* texture(std::string_view name);
+
+            /**
+             * Returns the textures with the given names, in the same order as the names. Since the names are
+             * interned, each distinct name is only looked up once, no matter how many faces use it.
+             */
+            std::vector<Texture*> textures(const std::vector<Model::InternedString>& names);
             
             const std::vector<const Texture*>& textures() const;
             const std::vector<TextureCollection>& collections() const;
@@ -78,6 +157,7 @@ namespace TrenchBroom {
             void prepare();
 
             void updateTextures();
+            const TextureSlot* findSlot(std::string_view name, size_t hash) const;
         };
     }
 }
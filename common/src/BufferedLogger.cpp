@@ -0,0 +1,51 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BufferedLogger.h"
+
+#include <QString>
+
+namespace TrenchBroom {
+    void BufferedLogger::flush(Logger& logger) {
+        auto messages = std::vector<std::tuple<LogLevel, std::string>>{};
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            messages = std::move(m_messages);
+            m_messages.clear();
+        }
+
+        for (const auto& [level, message] : messages) {
+            logger.log(level, message);
+        }
+    }
+
+    void BufferedLogger::clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_messages.clear();
+    }
+
+    void BufferedLogger::doLog(const LogLevel level, const std::string& message) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_messages.emplace_back(level, message);
+    }
+
+    void BufferedLogger::doLog(const LogLevel level, const QString& message) {
+        doLog(level, message.toStdString());
+    }
+}
@@ -28,6 +28,7 @@
 #include <algorithm>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace TrenchBroom {
     namespace EL {
@@ -121,6 +122,21 @@ namespace TrenchBroom {
             }
         }
 
+        std::vector<std::string> Expression::variableNames() const {
+            auto result = std::vector<std::string>{};
+            appendVariableNames(result);
+            std::sort(std::begin(result), std::end(result));
+            result.erase(std::unique(std::begin(result), std::end(result)), std::end(result));
+            return result;
+        }
+
+        void Expression::appendVariableNames(std::vector<std::string>& result) const {
+            std::visit(kdl::overload(
+                [](const LiteralExpression&) {},
+                [&](const auto& e) { e.appendVariableNames(result); }
+            ), *m_expression);
+        }
+
         size_t Expression::line() const {
             return m_line;
         }
@@ -209,6 +225,10 @@ namespace TrenchBroom {
             return context.variableValue(m_variableName);
         }
         
+        void VariableExpression::appendVariableNames(std::vector<std::string>& result) const {
+            result.push_back(m_variableName);
+        }
+
         std::ostream& operator<<(std::ostream& str, const VariableExpression& exp) {
             str << exp.m_variableName;
             return str;
@@ -251,6 +271,12 @@ namespace TrenchBroom {
             }
         }
 
+        void ArrayExpression::appendVariableNames(std::vector<std::string>& result) const {
+            for (const auto& element : m_elements) {
+                element.appendVariableNames(result);
+            }
+        }
+
         std::ostream& operator<<(std::ostream& str, const ArrayExpression& exp) {
             str << "[ ";
             size_t i = 0u;
@@ -291,6 +317,12 @@ namespace TrenchBroom {
             }
         }
 
+        void MapExpression::appendVariableNames(std::vector<std::string>& result) const {
+            for (const auto& [key, element] : m_elements) {
+                element.appendVariableNames(result);
+            }
+        }
+
         std::ostream& operator<<(std::ostream& str, const MapExpression& exp) {
             str << "{ ";
             size_t i = 0u;
@@ -333,6 +365,10 @@ namespace TrenchBroom {
             }
         }
 
+        void UnaryExpression::appendVariableNames(std::vector<std::string>& result) const {
+            m_operand.appendVariableNames(result);
+        }
+
         std::ostream& operator<<(std::ostream& str, const UnaryExpression& exp) {
             switch (exp.m_operator) {
                 case UnaryOperator::Plus:
@@ -493,6 +529,11 @@ namespace TrenchBroom {
             };
         }
 
+        void BinaryExpression::appendVariableNames(std::vector<std::string>& result) const {
+            m_leftOperand.appendVariableNames(result);
+            m_rightOperand.appendVariableNames(result);
+        }
+
         std::ostream& operator<<(std::ostream& str, const BinaryExpression& exp) {
             switch (exp.m_operator) {
                 case BinaryOperator::Addition:
@@ -587,6 +628,11 @@ namespace TrenchBroom {
             }
         }
 
+        void SubscriptExpression::appendVariableNames(std::vector<std::string>& result) const {
+            m_leftOperand.appendVariableNames(result);
+            m_rightOperand.appendVariableNames(result);
+        }
+
         std::ostream& operator<<(std::ostream& str, const SubscriptExpression& exp) {
             str << exp.m_leftOperand << "[" << exp.m_rightOperand << "]";
             return str;
@@ -621,6 +667,12 @@ namespace TrenchBroom {
             return std::nullopt;
         }
 
+        void SwitchExpression::appendVariableNames(std::vector<std::string>& result) const {
+            for (const auto& case_ : m_cases) {
+                case_.appendVariableNames(result);
+            }
+        }
+
         std::ostream& operator<<(std::ostream& str, const SwitchExpression& exp) {
             str << "{{ ";
             size_t i = 0u;
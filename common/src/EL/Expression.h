@@ -75,6 +75,12 @@ namespace TrenchBroom {
             Value evaluate(const EvaluationContext& context) const;
             bool optimize();
 
+            /**
+             * Returns the sorted names of all variables that this expression may read when it is evaluated.
+             */
+            std::vector<std::string> variableNames() const;
+            void appendVariableNames(std::vector<std::string>& result) const;
+
             size_t line() const;
             size_t column() const;
 
@@ -105,6 +111,8 @@ namespace TrenchBroom {
             
             Value evaluate(const EvaluationContext& context) const;
             
+            void appendVariableNames(std::vector<std::string>& result) const;
+            
             friend std::ostream& operator<<(std::ostream& str, const VariableExpression& exp);
         };
         
@@ -117,6 +125,8 @@ namespace TrenchBroom {
             Value evaluate(const EvaluationContext& context) const;
             std::optional<LiteralExpression> optimize();
             
+            void appendVariableNames(std::vector<std::string>& result) const;
+            
             friend std::ostream& operator<<(std::ostream& str, const ArrayExpression& exp);
         };
         
@@ -129,6 +139,8 @@ namespace TrenchBroom {
             Value evaluate(const EvaluationContext& context) const;
             std::optional<LiteralExpression> optimize();
             
+            void appendVariableNames(std::vector<std::string>& result) const;
+            
             friend std::ostream& operator<<(std::ostream& str, const MapExpression& exp);
         };
         
@@ -150,6 +162,8 @@ namespace TrenchBroom {
             Value evaluate(const EvaluationContext& context) const;
             std::optional<LiteralExpression> optimize();
             
+            void appendVariableNames(std::vector<std::string>& result) const;
+            
             friend std::ostream& operator<<(std::ostream& str, const UnaryExpression& exp);
         };
         
@@ -193,6 +207,8 @@ namespace TrenchBroom {
             
             size_t precedence() const;
 
+            void appendVariableNames(std::vector<std::string>& result) const;
+            
             friend std::ostream& operator<<(std::ostream& str, const BinaryExpression& exp);
         };
         
@@ -208,6 +224,8 @@ namespace TrenchBroom {
             Value evaluate(const EvaluationContext& context) const;
             std::optional<LiteralExpression> optimize();
             
+            void appendVariableNames(std::vector<std::string>& result) const;
+            
             friend std::ostream& operator<<(std::ostream& str, const SubscriptExpression& exp);
         };
         
@@ -220,6 +238,8 @@ namespace TrenchBroom {
             Value evaluate(const EvaluationContext& context) const;
             std::optional<LiteralExpression> optimize();
             
+            void appendVariableNames(std::vector<std::string>& result) const;
+            
             friend std::ostream& operator<<(std::ostream& str, const SwitchExpression& exp);
         };
     }
@@ -34,6 +34,7 @@
 #include <iterator>
 #include <sstream>
 #include <string>
+#include <type_traits>
 
 namespace TrenchBroom {
     namespace EL {
@@ -46,6 +47,18 @@ namespace TrenchBroom {
         const Value Value::Null = Value(NullType::Value);
         const Value Value::Undefined = Value(UndefinedType::Value);
             
+        template <typename F>
+        decltype(auto) Value::visit(F&& f) const {
+            return std::visit([&](const auto& value) -> decltype(auto) {
+                using T = std::decay_t<decltype(value)>;
+                if constexpr (std::is_same_v<T, ArrayPtr> || std::is_same_v<T, MapPtr> || std::is_same_v<T, RangePtr>) {
+                    return f(*value);
+                } else {
+                    return f(value);
+                }
+            }, m_value);
+        }
+
         Value::Value() :
         m_value(NullType::Value),
         m_line(0u),
@@ -87,17 +100,17 @@ namespace TrenchBroom {
         m_column(column) {}
     
         Value::Value(ArrayType value, const size_t line, const size_t column) :
-        m_value(std::move(value)),
+        m_value(std::make_shared<const ArrayType>(std::move(value))),
         m_line(line),
         m_column(column) {}
     
         Value::Value(MapType value, const size_t line, const size_t column) :
-        m_value(std::move(value)),
+        m_value(std::make_shared<const MapType>(std::move(value))),
         m_line(line),
         m_column(column) {}
     
         Value::Value(RangeType value, const size_t line, const size_t column) :
-        m_value(std::move(value)),
+        m_value(std::make_shared<const RangeType>(std::move(value))),
         m_line(line),
         m_column(column) {}
     
@@ -117,7 +130,7 @@ namespace TrenchBroom {
         m_column(column) {}
         
         ValueType Value::type() const {
-            return std::visit(kdl::overload(
+            return visit(kdl::overload(
                 [](const BooleanType&)   { return ValueType::Boolean; },
                 [](const StringType&)    { return ValueType::String; },
                 [](const NumberType&)    { return ValueType::Number; },
@@ -126,7 +139,7 @@ namespace TrenchBroom {
                 [](const RangeType&)     { return ValueType::Range; },
                 [](const NullType&)      { return ValueType::Null; },
                 [](const UndefinedType&) { return ValueType::Undefined; }
-            ), m_value);
+            ));
         }
         
         std::string Value::typeName() const {
@@ -146,7 +159,7 @@ namespace TrenchBroom {
         }
 
         const BooleanType& Value::booleanValue() const {
-            return std::visit(kdl::overload(
+            return visit(kdl::overload(
                 [&](const BooleanType& b) -> const BooleanType& { return b; },
                 [&](const StringType&)    -> const BooleanType& { throw DereferenceError(describe(), type(), ValueType::String); },
                 [&](const NumberType&)    -> const BooleanType& { throw DereferenceError(describe(), type(), ValueType::Number); },
@@ -155,11 +168,11 @@ namespace TrenchBroom {
                 [&](const RangeType&)     -> const BooleanType& { throw DereferenceError(describe(), type(), ValueType::Range); },
                 [&](const NullType&)      -> const BooleanType& { static const BooleanType b = false; return b; },
                 [&](const UndefinedType&) -> const BooleanType& { throw DereferenceError(describe(), type(), ValueType::Undefined); }
-            ), m_value);
+            ));
         }
         
         const StringType& Value::stringValue() const {
-            return std::visit(kdl::overload(
+            return visit(kdl::overload(
                 [&](const BooleanType&)   -> const StringType& { throw DereferenceError(describe(), type(), ValueType::Boolean); },
                 [&](const StringType& s)  -> const StringType& { return s; },
                 [&](const NumberType&)    -> const StringType& { throw DereferenceError(describe(), type(), ValueType::Number); },
@@ -168,11 +181,11 @@ namespace TrenchBroom {
                 [&](const RangeType&)     -> const StringType& { throw DereferenceError(describe(), type(), ValueType::Range); },
                 [&](const NullType&)      -> const StringType& { static const StringType s; return s; },
                 [&](const UndefinedType&) -> const StringType& { throw DereferenceError(describe(), type(), ValueType::Undefined); }
-            ), m_value);
+            ));
         }
         
         const NumberType& Value::numberValue() const {
-            return std::visit(kdl::overload(
+            return visit(kdl::overload(
                 [&](const BooleanType&)   -> const NumberType& { throw DereferenceError(describe(), type(), ValueType::Boolean); },
                 [&](const StringType&)    -> const NumberType& { throw DereferenceError(describe(), type(), ValueType::String); },
                 [&](const NumberType& n)  -> const NumberType& { return n; },
@@ -181,7 +194,7 @@ namespace TrenchBroom {
                 [&](const RangeType&)     -> const NumberType& { throw DereferenceError(describe(), type(), ValueType::Range); },
                 [&](const NullType&)      -> const NumberType& { static const NumberType n = 0.0; return n; },
                 [&](const UndefinedType&) -> const NumberType& { throw DereferenceError(describe(), type(), ValueType::Undefined); }
-            ), m_value);
+            ));
         }
         
         IntegerType Value::integerValue() const {
@@ -189,7 +202,7 @@ namespace TrenchBroom {
         }
         
         const ArrayType& Value::arrayValue() const {
-            return std::visit(kdl::overload(
+            return visit(kdl::overload(
                 [&](const BooleanType&)   -> const ArrayType& { throw DereferenceError(describe(), type(), ValueType::Boolean); },
                 [&](const StringType&)    -> const ArrayType& { throw DereferenceError(describe(), type(), ValueType::String); },
                 [&](const NumberType&)    -> const ArrayType& { throw DereferenceError(describe(), type(), ValueType::Number); },
@@ -198,11 +211,11 @@ namespace TrenchBroom {
                 [&](const RangeType&)     -> const ArrayType& { throw DereferenceError(describe(), type(), ValueType::Range); },
                 [&](const NullType&)      -> const ArrayType& { static const ArrayType a(0); return a; },
                 [&](const UndefinedType&) -> const ArrayType& { throw DereferenceError(describe(), type(), ValueType::Undefined); }
-            ), m_value);
+            ));
         }
         
         const MapType& Value::mapValue() const {
-            return std::visit(kdl::overload(
+            return visit(kdl::overload(
                 [&](const BooleanType&)   -> const MapType& { throw DereferenceError(describe(), type(), ValueType::Boolean); },
                 [&](const StringType&)    -> const MapType& { throw DereferenceError(describe(), type(), ValueType::String); },
                 [&](const NumberType&)    -> const MapType& { throw DereferenceError(describe(), type(), ValueType::Number); },
@@ -211,11 +224,11 @@ namespace TrenchBroom {
                 [&](const RangeType&)     -> const MapType& { throw DereferenceError(describe(), type(), ValueType::Range); },
                 [&](const NullType&)      -> const MapType& { static const MapType m; return m; },
                 [&](const UndefinedType&) -> const MapType& { throw DereferenceError(describe(), type(), ValueType::Undefined); }
-            ), m_value);
+            ));
         }
         
         const RangeType& Value::rangeValue() const {
-            return std::visit(kdl::overload(
+            return visit(kdl::overload(
                 [&](const BooleanType&)   -> const RangeType& { throw DereferenceError(describe(), type(), ValueType::Boolean); },
                 [&](const StringType&)    -> const RangeType& { throw DereferenceError(describe(), type(), ValueType::String); },
                 [&](const NumberType&)    -> const RangeType& { throw DereferenceError(describe(), type(), ValueType::Number); },
@@ -224,7 +237,7 @@ namespace TrenchBroom {
                 [&](const RangeType& r)   -> const RangeType& { return r; },
                 [&](const NullType&)      -> const RangeType& { throw DereferenceError(describe(), type(), ValueType::Null); },
                 [&](const UndefinedType&) -> const RangeType& { throw DereferenceError(describe(), type(), ValueType::Undefined); }
-            ), m_value);
+            ));
         }
         
         bool Value::null() const {
@@ -259,7 +272,7 @@ namespace TrenchBroom {
         }
 
         size_t Value::length() const {
-            return std::visit(kdl::overload(
+            return visit(kdl::overload(
                 [](const BooleanType&)   -> size_t { return 1u; },
                 [](const StringType& s)  -> size_t { return s.length(); },
                 [](const NumberType&)    -> size_t { return 1u; },
@@ -268,11 +281,11 @@ namespace TrenchBroom {
                 [](const RangeType& r)   -> size_t { return r.size(); },
                 [](const NullType&)      -> size_t { return 0u; },
                 [](const UndefinedType&) -> size_t { return 0u; }
-            ), m_value);
+            ));
         }
         
         bool Value::convertibleTo(const ValueType toType) const {
-            return std::visit(kdl::overload(
+            return visit(kdl::overload(
                 [&](const BooleanType&) {
                     switch (toType) {
                         case ValueType::Boolean:
@@ -412,11 +425,11 @@ namespace TrenchBroom {
 
                     return false;
                 }
-            ), m_value);
+            ));
         }
         
         Value Value::convertTo(const ValueType toType) const {
-            return std::visit(kdl::overload(
+            return visit(kdl::overload(
                 [&](const BooleanType& b) -> Value {
                     switch (toType) {
                         case ValueType::Boolean:
@@ -566,7 +579,7 @@ namespace TrenchBroom {
 
                     throw ConversionError(describe(), type(), toType);
                 }
-            ), m_value);
+            ));
         }
 
         std::string Value::asString(const bool multiline) const {
@@ -576,7 +589,7 @@ namespace TrenchBroom {
         }
         
         void Value::appendToStream(std::ostream& str, const bool multiline, const std::string& indent) const {
-            std::visit(kdl::overload(
+            visit(kdl::overload(
                 [&](const BooleanType& b) {
                     str << (b ? "true" : "false");
                 },
@@ -677,7 +690,7 @@ namespace TrenchBroom {
                 [&](const UndefinedType&) {
                     str << "undefined";
                 }
-            ), m_value);
+            ));
         }
 
         static  size_t computeIndex(const long index, const size_t indexableSize) {
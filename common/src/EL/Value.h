@@ -23,6 +23,7 @@
 
 // FIXME: try to remove some of these headers
 #include <iosfwd>
+#include <memory>
 #include <variant>
 #include <string>
 #include <vector>
@@ -45,7 +46,15 @@ namespace TrenchBroom {
         
         class Value {
         private:
-            std::variant<BooleanType, StringType, NumberType, ArrayType, MapType, RangeType, NullType, UndefinedType> m_value;
+            /*
+             * Arrays, maps and ranges are immutable once they are stored in a value, so they are shared between copies
+             * of the value instead of being copied. This makes copying a value O(1).
+             */
+            using ArrayPtr = std::shared_ptr<const ArrayType>;
+            using MapPtr = std::shared_ptr<const MapType>;
+            using RangePtr = std::shared_ptr<const RangeType>;
+
+            std::variant<BooleanType, StringType, NumberType, ArrayPtr, MapPtr, RangePtr, NullType, UndefinedType> m_value;
             size_t m_line;
             size_t m_column;
         private:
@@ -58,6 +67,12 @@ namespace TrenchBroom {
                 }
                 return result;
             }
+
+            /**
+             * Visits the stored value, passing shared arrays, maps and ranges to the visitor by reference.
+             */
+            template <typename F>
+            decltype(auto) visit(F&& f) const;
         public:
             static const Value Null;
             static const Value Undefined;
@@ -79,7 +94,7 @@ namespace TrenchBroom {
         
             template <typename T>
             explicit Value(const std::vector<T>& value, const size_t line = 0u, const size_t column = 0u) :
-            m_value(makeArray(value, line, column)),
+            m_value(std::make_shared<const ArrayType>(makeArray(value, line, column))),
             m_line(line),
             m_column(column) {}
             
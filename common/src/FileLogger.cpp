@@ -27,19 +27,34 @@
 
 #include <cassert>
 #include <string>
+#include <utility>
 
 #include <QString>
 
 namespace TrenchBroom {
-    FileLogger::FileLogger(const IO::Path& filePath) :
-    m_file(nullptr) {
+    FileLogger::FileLogger(const IO::Path& filePath, const std::chrono::milliseconds flushInterval) :
+    m_file(nullptr),
+    m_flushInterval(flushInterval),
+    m_stopping(false) {
         const auto fixedPath = IO::Disk::fixPath(filePath);
         IO::Disk::ensureDirectoryExists(fixedPath.deleteLastComponent());
         m_file = openPathAsFILE(fixedPath, "w");
         ensure(m_file != nullptr, "log file could not be opened");
+
+        m_writer = std::thread([&]() { runWriter(); });
     }
 
     FileLogger::~FileLogger() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_messagesAvailable.notify_one();
+        m_writer.join();
+
+        // write the messages that were logged after the writer thread stopped
+        writePendingMessages();
+
         if (m_file != nullptr) {
             fclose(m_file);
             m_file = nullptr;
@@ -51,14 +66,51 @@ namespace TrenchBroom {
         return Instance;
     }
 
-    void FileLogger::doLog(const LogLevel /* level */, const std::string& message) {
+    void FileLogger::flush() {
+        writePendingMessages();
+    }
+
+    void FileLogger::runWriter() {
+        auto lock = std::unique_lock<std::mutex>(m_mutex);
+        while (!m_stopping) {
+            m_messagesAvailable.wait(lock, [&]() { return m_stopping || !m_pendingMessages.empty(); });
+
+            // give other messages the chance to arrive so that they are written in one batch
+            m_messagesAvailable.wait_for(lock, m_flushInterval, [&]() { return m_stopping; });
+
+            lock.unlock();
+            writePendingMessages();
+            lock.lock();
+        }
+    }
+
+    void FileLogger::writePendingMessages() {
+        // the file lock is taken first so that batches are written in the order in which they were taken
+        std::lock_guard<std::mutex> fileLock(m_fileMutex);
+
+        auto messages = std::vector<std::string>{};
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::swap(messages, m_pendingMessages);
+        }
+
         assert(m_file != nullptr);
-        if (m_file != nullptr) {
-            std::fprintf(m_file, "%s\n", message.c_str());
+        if (m_file != nullptr && !messages.empty()) {
+            for (const auto& message : messages) {
+                std::fprintf(m_file, "%s\n", message.c_str());
+            }
             std::fflush(m_file);
         }
     }
 
+    void FileLogger::doLog(const LogLevel /* level */, const std::string& message) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pendingMessages.push_back(message);
+        }
+        m_messagesAvailable.notify_one();
+    }
+
     void FileLogger::doLog(const LogLevel level, const QString& message) {
         log(level, message.toStdString());
     }
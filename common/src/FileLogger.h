@@ -22,7 +22,12 @@
 #include "Macros.h"
 #include "Logger.h"
 
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 class QString;
 
@@ -31,15 +36,43 @@ namespace TrenchBroom {
         class Path;
     }
 
+    /**
+     * Writes log messages to a file.
+     *
+     * Logging a message only appends it to a queue. A background thread writes the queued messages in batches and
+     * flushes the file after each batch, waiting for at most the given flush interval after a message was queued. Call
+     * flush to write all pending messages immediately, e.g. before the log file is read or copied.
+     */
     class FileLogger : public Logger {
+    public:
+        static constexpr auto DefaultFlushInterval = std::chrono::milliseconds(100);
     private:
         FILE* m_file;
+        std::chrono::milliseconds m_flushInterval;
+
+        std::mutex m_mutex;
+        std::condition_variable m_messagesAvailable;
+        std::vector<std::string> m_pendingMessages;
+        bool m_stopping;
+
+        // serializes writing to the file between the writer thread and flush
+        std::mutex m_fileMutex;
+
+        std::thread m_writer;
     public:
-        explicit FileLogger(const IO::Path& filePath);
+        explicit FileLogger(const IO::Path& filePath, std::chrono::milliseconds flushInterval = DefaultFlushInterval);
         ~FileLogger() override;
 
         static FileLogger& instance();
+
+        /**
+         * Writes all pending messages to the file and flushes it.
+         */
+        void flush();
     private:
+        void runWriter();
+        void writePendingMessages();
+
         void doLog(LogLevel level, const std::string& message) override;
         void doLog(LogLevel level, const QString& message) override;
 
@@ -143,13 +143,22 @@ namespace TrenchBroom {
             reader.seekFromBegin(BspLayout::DirModelAddress);
             const auto modelsOffset = reader.readSize<int32_t>();
 
+            auto modelReader = reader.subReaderFromBegin(modelsOffset + frameIndex * BspLayout::ModelSize, BspLayout::ModelSize);
+            modelReader.seekForward(BspLayout::ModelFaceIndex);
+            const auto modelFaceIndex = modelReader.readSize<int32_t>();
+            const auto modelFaceCount = modelReader.readSize<int32_t>();
+            if (modelFaceIndex + modelFaceCount > faceInfoCount) {
+                throw AssetException("Invalid face range for BSP model " + std::to_string(frameIndex));
+            }
+
+            // a BSP file contains the faces of all of its models, but we only need to parse the faces of this model
             const auto textureInfos = parseTextureInfos(reader.subReaderFromBegin(textureInfoOffset), textureInfoCount);
             const auto vertices = parseVertices(reader.subReaderFromBegin(vertexOffset), vertexCount);
             const auto edgeInfos = parseEdgeInfos(reader.subReaderFromBegin(edgeInfoOffset), edgeInfoCount);
-            const auto faceInfos = parseFaceInfos(reader.subReaderFromBegin(faceInfoOffset), faceInfoCount);
+            const auto faceInfos = parseFaceInfos(reader.subReaderFromBegin(faceInfoOffset + modelFaceIndex * BspLayout::FaceSize), modelFaceCount);
             const auto faceEdges = parseFaceEdges(reader.subReaderFromBegin(faceEdgesOffset), faceEdgesCount);
 
-            parseFrame(reader.subReaderFromBegin(modelsOffset + frameIndex * BspLayout::ModelSize, BspLayout::ModelSize), frameIndex, model, textureInfos, vertices, edgeInfos, faceInfos, faceEdges);
+            parseFrame(frameIndex, model, textureInfos, vertices, edgeInfos, faceInfos, faceEdges);
         }
 
         std::vector<Assets::Texture> Bsp29Parser::parseTextures(Reader reader, Logger& logger) {
@@ -200,18 +209,22 @@ namespace TrenchBroom {
         }
 
         std::vector<vm::vec3f> Bsp29Parser::parseVertices(Reader reader, const size_t vertexCount) {
+            // the vertices are stored as tightly packed float triples, so they can be read in one go
+            static_assert(sizeof(vm::vec3f) == 3 * sizeof(float), "vec3f must be tightly packed");
+
             std::vector<vm::vec3f> result(vertexCount);
-            for (size_t i = 0; i < vertexCount; ++i) {
-                result[i] = reader.readVec<float, 3>();
-            }
+            reader.read(reinterpret_cast<char*>(result.data()), vertexCount * sizeof(vm::vec3f));
             return result;
         }
 
         Bsp29Parser::EdgeInfoList Bsp29Parser::parseEdgeInfos(Reader reader, const size_t edgeInfoCount) {
+            std::vector<uint16_t> vertexIndices(2u * edgeInfoCount);
+            reader.read(reinterpret_cast<char*>(vertexIndices.data()), vertexIndices.size() * sizeof(uint16_t));
+
             EdgeInfoList result(edgeInfoCount);
             for (size_t i = 0; i < edgeInfoCount; ++i) {
-                result[i].vertexIndex1 = reader.readSize<uint16_t>();
-                result[i].vertexIndex2 = reader.readSize<uint16_t>();
+                result[i].vertexIndex1 = static_cast<size_t>(vertexIndices[2u * i]);
+                result[i].vertexIndex2 = static_cast<size_t>(vertexIndices[2u * i + 1u]);
             }
             return result;
         }
@@ -230,26 +243,20 @@ namespace TrenchBroom {
 
         Bsp29Parser::FaceEdgeIndexList Bsp29Parser::parseFaceEdges(Reader reader, const size_t faceEdgeCount) {
             FaceEdgeIndexList result(faceEdgeCount);
-            for (size_t i = 0; i < faceEdgeCount; ++i) {
-                result[i] = reader.readInt<int32_t>();
-            }
+            reader.read(reinterpret_cast<char*>(result.data()), faceEdgeCount * sizeof(int32_t));
             return result;
         }
 
-        void Bsp29Parser::parseFrame(Reader reader, const size_t frameIndex, Assets::EntityModel& model, const TextureInfoList& textureInfos, const std::vector<vm::vec3f>& vertices, const EdgeInfoList& edgeInfos, const FaceInfoList& faceInfos, const FaceEdgeIndexList& faceEdges) {
+        void Bsp29Parser::parseFrame(const size_t frameIndex, Assets::EntityModel& model, const TextureInfoList& textureInfos, const std::vector<vm::vec3f>& vertices, const EdgeInfoList& edgeInfos, const FaceInfoList& faceInfos, const FaceEdgeIndexList& faceEdges) {
             using Vertex = Assets::EntityModelVertex;
             using VertexList = std::vector<Vertex>;
 
             auto& surface = model.surface(0);
 
-            reader.seekForward(BspLayout::ModelFaceIndex);
-            const auto modelFaceIndex = reader.readSize<int32_t>();
-            const auto modelFaceCount = reader.readSize<int32_t>();
             size_t totalVertexCount = 0;
             Renderer::TexturedIndexRangeMap::Size size;
 
-            for (size_t i = 0; i < modelFaceCount; ++i) {
-                const auto& faceInfo = faceInfos[modelFaceIndex + i];
+            for (const auto& faceInfo : faceInfos) {
                 const auto& textureInfo = textureInfos[faceInfo.textureInfoIndex];
                 auto* skin = surface.skin(textureInfo.textureIndex);
                 if (skin != nullptr) {
@@ -262,8 +269,7 @@ namespace TrenchBroom {
             vm::bbox3f::builder bounds;
 
             Renderer::TexturedIndexRangeMapBuilder<Vertex::Type> builder(totalVertexCount, size);
-            for (size_t i = 0; i < modelFaceCount; ++i) {
-                const auto& faceInfo = faceInfos[modelFaceIndex + i];
+            for (const auto& faceInfo : faceInfos) {
                 const auto& textureInfo = textureInfos[faceInfo.textureInfoIndex];
                 auto* skin = surface.skin(textureInfo.textureIndex);
                 if (skin != nullptr) {
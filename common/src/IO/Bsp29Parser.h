@@ -22,6 +22,7 @@
 #include "Assets/TextureCollection.h"
 #include "IO/EntityModelParser.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -62,7 +63,7 @@ namespace TrenchBroom {
             };
             using FaceInfoList = std::vector<FaceInfo>;
 
-            using FaceEdgeIndexList = std::vector<int>;
+            using FaceEdgeIndexList = std::vector<int32_t>;
 
             std::string m_name;
             const char* m_begin;
@@ -82,7 +83,7 @@ namespace TrenchBroom {
             FaceInfoList parseFaceInfos(Reader reader, size_t faceInfoCount);
             FaceEdgeIndexList parseFaceEdges(Reader reader, size_t faceEdgeCount);
 
-            void parseFrame(Reader reader, size_t frameIndex, Assets::EntityModel& model, const TextureInfoList& textureInfos, const std::vector<vm::vec3f>& vertices, const EdgeInfoList& edgeInfos, const FaceInfoList& faceInfos, const FaceEdgeIndexList& faceEdges);
+            void parseFrame(size_t frameIndex, Assets::EntityModel& model, const TextureInfoList& textureInfos, const std::vector<vm::vec3f>& vertices, const EdgeInfoList& edgeInfos, const FaceInfoList& faceInfos, const FaceEdgeIndexList& faceEdges);
             vm::vec2f textureCoords(const vm::vec3f& vertex, const TextureInfo& textureInfo, const Assets::Texture* texture) const;
         };
     }
@@ -60,13 +60,21 @@ namespace TrenchBroom {
         }
 
         std::unique_ptr<Model::CompilationProfile> CompilationConfigParser::parseProfile(const EL::Value& value) const {
-            expectStructure(value, "[ {'name': 'String', 'workdir': 'String', 'tasks': 'Array'}, {} ]");
+            expectStructure(value, "[ {'name': 'String', 'workdir': 'String', 'tasks': 'Array'}, { 'jobs': 'Number' } ]");
 
             const std::string name = value["name"].stringValue();
             const std::string workdir = value["workdir"].stringValue();
             auto tasks = parseTasks(value["tasks"]);
 
-            return std::make_unique<Model::CompilationProfile>(name, workdir, std::move(tasks));
+            auto profile = std::make_unique<Model::CompilationProfile>(name, workdir, std::move(tasks));
+            if (value.contains("jobs")) {
+                const auto jobs = value["jobs"].integerValue();
+                if (jobs < 1) {
+                    throw ParserException("Invalid job count " + std::to_string(jobs) + " in compilation profile '" + name + "'");
+                }
+                profile->setJobCount(static_cast<size_t>(jobs));
+            }
+            return profile;
         }
 
         std::vector<std::unique_ptr<Model::CompilationTask>> CompilationConfigParser::parseTasks(const EL::Value& value) const {
@@ -83,26 +91,47 @@ namespace TrenchBroom {
             expectMapEntry(value, "type", EL::ValueType::String);
             const std::string type = value["type"].stringValue();
 
+            auto task = std::unique_ptr<Model::CompilationTask>{};
             if (type == "export") {
-                return parseExportTask(value);
+                task = parseExportTask(value);
             } else if (type == "copy") {
-                return parseCopyTask(value);
+                task = parseCopyTask(value);
             } else if (type == "tool") {
-                return parseToolTask(value);
+                task = parseToolTask(value);
             } else {
                 throw ParserException("Unknown compilation task type '" + type + "'");
             }
+
+            parseTaskDependencies(value, *task);
+            return task;
+        }
+
+        void CompilationConfigParser::parseTaskDependencies(const EL::Value& value, Model::CompilationTask& task) const {
+            if (value.contains("name")) {
+                task.setName(value["name"].stringValue());
+            }
+            if (value.contains("dependsOn")) {
+                const auto& dependsOn = value["dependsOn"];
+
+                auto dependencies = std::vector<std::string>{};
+                dependencies.reserve(dependsOn.length());
+                for (size_t i = 0; i < dependsOn.length(); ++i) {
+                    expectType(dependsOn[i], EL::ValueType::String);
+                    dependencies.push_back(dependsOn[i].stringValue());
+                }
+                task.setDependencies(std::move(dependencies));
+            }
         }
 
         std::unique_ptr<Model::CompilationTask> CompilationConfigParser::parseExportTask(const EL::Value& value) const {
-            expectStructure(value, "[ {'type': 'String', 'target': 'String'}, { 'enabled': 'Boolean' } ]");
+            expectStructure(value, "[ {'type': 'String', 'target': 'String'}, { 'enabled': 'Boolean', 'name': 'String', 'dependsOn': 'Array' } ]");
             const bool enabled = value.contains("enabled") ? value["enabled"].booleanValue() : true;
             const std::string target = value["target"].stringValue();
             return std::make_unique<Model::CompilationExportMap>(enabled, target);
         }
 
         std::unique_ptr<Model::CompilationTask> CompilationConfigParser::parseCopyTask(const EL::Value& value) const {
-            expectStructure(value, "[ {'type': 'String', 'source': 'String', 'target': 'String'}, { 'enabled': 'Boolean' } ]");
+            expectStructure(value, "[ {'type': 'String', 'source': 'String', 'target': 'String'}, { 'enabled': 'Boolean', 'name': 'String', 'dependsOn': 'Array' } ]");
 
             const bool enabled = value.contains("enabled") ? value["enabled"].booleanValue() : true;
             const std::string source = value["source"].stringValue();
@@ -112,7 +141,7 @@ namespace TrenchBroom {
         }
 
         std::unique_ptr<Model::CompilationTask> CompilationConfigParser::parseToolTask(const EL::Value& value) const {
-            expectStructure(value, "[ {'type': 'String', 'tool': 'String', 'parameters': 'String'}, { 'enabled': 'Boolean' } ]");
+            expectStructure(value, "[ {'type': 'String', 'tool': 'String', 'parameters': 'String'}, { 'enabled': 'Boolean', 'name': 'String', 'dependsOn': 'Array' } ]");
 
             const bool enabled = value.contains("enabled") ? value["enabled"].booleanValue() : true;
             const std::string tool = value["tool"].stringValue();
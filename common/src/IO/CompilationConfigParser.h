@@ -51,6 +51,7 @@ namespace TrenchBroom {
             std::unique_ptr<Model::CompilationTask> parseExportTask(const EL::Value& value) const;
             std::unique_ptr<Model::CompilationTask> parseCopyTask(const EL::Value& value) const;
             std::unique_ptr<Model::CompilationTask> parseToolTask(const EL::Value& value) const;
+            void parseTaskDependencies(const EL::Value& value, Model::CompilationTask& task) const;
 
             deleteCopyAndMove(CompilationConfigParser)
         };
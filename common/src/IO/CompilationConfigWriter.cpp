@@ -57,6 +57,9 @@ namespace TrenchBroom {
             EL::MapType map;
             map["name"] = EL::Value(profile->name());
             map["workdir"] = EL::Value(profile->workDirSpec());
+            if (profile->jobCount() != 1u) {
+                map["jobs"] = EL::Value(profile->jobCount());
+            }
             map["tasks"] = writeTasks(profile);
             return EL::Value(map);
         }
@@ -66,6 +69,19 @@ namespace TrenchBroom {
             EL::ArrayType m_array;
         public:
             EL::Value result() const { return EL::Value(m_array); }
+        private:
+            static void writeTaskDependencies(const Model::CompilationTask& task, EL::MapType& map) {
+                if (!task.name().empty()) {
+                    map["name"] = EL::Value(task.name());
+                }
+                if (const auto& dependencies = task.dependencies()) {
+                    EL::ArrayType array;
+                    for (const auto& dependency : *dependencies) {
+                        array.push_back(EL::Value(dependency));
+                    }
+                    map["dependsOn"] = EL::Value(array);
+                }
+            }
         public:
             void visit(const Model::CompilationExportMap& task) override {
                 EL::MapType map;
@@ -73,6 +89,7 @@ namespace TrenchBroom {
                     map["enabled"] = EL::Value(false);
                 }
                 map["type"] = EL::Value("export");
+                writeTaskDependencies(task, map);
                 map["target"] = EL::Value(task.targetSpec());
                 m_array.push_back(EL::Value(map));
             }
@@ -83,6 +100,7 @@ namespace TrenchBroom {
                     map["enabled"] = EL::Value(false);
                 }
                 map["type"] = EL::Value("copy");
+                writeTaskDependencies(task, map);
                 map["source"] = EL::Value(task.sourceSpec());
                 map["target"] = EL::Value(task.targetSpec());
                 m_array.push_back(EL::Value(map));
@@ -94,6 +112,7 @@ namespace TrenchBroom {
                     map["enabled"] = EL::Value(false);
                 }
                 map["type"] = EL::Value("tool");
+                writeTaskDependencies(task, map);
                 map["tool"] = EL::Value(task.toolSpec());
                 map["parameters"] = EL::Value(task.parameterSpec());
                 m_array.push_back(EL::Value(map));
@@ -160,7 +160,7 @@ namespace TrenchBroom {
             return names;
         }
 
-        std::vector<EntityDefinitionClassInfo> DefParser::parseClassInfos(ParserStatus& status) {
+        std::vector<EntityDefinitionClassInfo> DefParser::doParseClassInfos(ParserStatus& status) {
             std::vector<EntityDefinitionClassInfo> result;
 
             auto classInfo = parseClassInfo(status);
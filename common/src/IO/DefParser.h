@@ -74,7 +74,7 @@ namespace TrenchBroom {
             DefParser(std::string_view str, const Color& defaultEntityColor);
         private:
             TokenNameMap tokenNames() const override;
-            std::vector<EntityDefinitionClassInfo> parseClassInfos(ParserStatus& status) override;
+            std::vector<EntityDefinitionClassInfo> doParseClassInfos(ParserStatus& status) override;
 
             std::optional<EntityDefinitionClassInfo> parseClassInfo(ParserStatus& status);
             PropertyDefinitionPtr parseSpawnflags(ParserStatus& status);
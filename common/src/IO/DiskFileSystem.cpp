@@ -65,6 +65,10 @@ namespace TrenchBroom {
             return Disk::getDirectoryContents(doMakeAbsolute(path));
         }
 
+        std::vector<std::pair<Path, bool>> DiskFileSystem::doGetDirectoryEntries(const Path& path) const {
+            return Disk::getDirectoryEntries(doMakeAbsolute(path));
+        }
+
         std::shared_ptr<File> DiskFileSystem::doOpenFile(const Path& path) const {
             auto file = Disk::openFile(doMakeAbsolute(path));
             return std::make_shared<FileView>(path, file, 0u, file->size());
@@ -45,6 +45,7 @@ namespace TrenchBroom {
             bool doFileExists(const Path& path) const override;
 
             std::vector<Path> doGetDirectoryContents(const Path& path) const override;
+            std::vector<std::pair<Path, bool>> doGetDirectoryEntries(const Path& path) const override;
             std::shared_ptr<File> doOpenFile(const Path& path) const override;
         };
 
@@ -25,11 +25,15 @@
 #include "IO/FileMatcher.h"
 #include "IO/PathQt.h"
 
-#include <kdl/string_compare.h>
+#include <kdl/string_format.h>
 
 #include <fstream>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <unordered_map>
 
+#include <QDateTime>
 #include <QDir>
 #include <QFileInfo>
 
@@ -37,7 +41,7 @@ namespace TrenchBroom {
     namespace IO {
         namespace Disk {
             bool doCheckCaseSensitive();
-            Path findCaseSensitivePath(const std::vector<Path>& list, const Path& path);
+            std::optional<Path> findCaseSensitiveEntry(const Path& directory, const Path& name);
             Path fixCase(const Path& path);
 
             bool doCheckCaseSensitive() {
@@ -54,12 +58,58 @@ namespace TrenchBroom {
                 return caseSensitive;
             }
 
-            Path findCaseSensitivePath(const std::vector<Path>& list, const Path& path) {
-                for (const Path& entry : list) {
-                    if (kdl::ci::str_is_equal(entry.asString(), path.asString()))
-                        return entry;
+            namespace {
+                /**
+                 * The entries of a directory, keyed by their lower case names. The index is rebuilt whenever the
+                 * modification time of the directory changes, that is, when entries are added, removed or renamed.
+                 */
+                struct DirectoryIndex {
+                    QDateTime lastModified;
+                    std::unordered_map<std::string, std::string> entries;
+                };
+
+                std::mutex directoryIndexMutex;
+                std::unordered_map<std::string, DirectoryIndex> directoryIndices;
+
+                DirectoryIndex buildDirectoryIndex(const QFileInfo& directoryInfo) {
+                    auto index = DirectoryIndex{directoryInfo.lastModified(), {}};
+
+                    const auto dir = QDir{directoryInfo.absoluteFilePath()};
+                    for (const auto& entry : dir.entryList(QDir::NoDotAndDotDot | QDir::AllEntries | QDir::Hidden | QDir::System)) {
+                        auto name = pathFromQString(entry).asString();
+                        auto key = kdl::str_to_lower(name);
+                        // keep the first entry if several entries differ only by case
+                        index.entries.emplace(std::move(key), std::move(name));
+                    }
+                    return index;
                 }
-                return Path("");
+            }
+
+            /**
+             * Finds the entry of the given directory whose name matches the given name, ignoring case.
+             * An entry whose name matches exactly is preferred.
+             */
+            std::optional<Path> findCaseSensitiveEntry(const Path& directory, const Path& name) {
+                const auto directoryInfo = QFileInfo{pathAsQString(directory)};
+                if (!directoryInfo.isDir()) {
+                    return std::nullopt;
+                }
+
+                const auto lastModified = directoryInfo.lastModified();
+                const auto nameStr = name.asString();
+
+                std::lock_guard<std::mutex> lock{directoryIndexMutex};
+                auto it = directoryIndices.find(directory.asString());
+                if (it == std::end(directoryIndices) || it->second.lastModified != lastModified) {
+                    it = directoryIndices.insert_or_assign(directory.asString(), buildDirectoryIndex(directoryInfo)).first;
+                }
+
+                const auto& entries = it->second.entries;
+                const auto entryIt = entries.find(kdl::str_to_lower(nameStr));
+                if (entryIt == std::end(entries)) {
+                    return std::nullopt;
+                }
+                return entryIt->second == nameStr ? name : Path{entryIt->second};
             }
 
             Path fixCase(const Path& path) {
@@ -78,16 +128,10 @@ namespace TrenchBroom {
                         return result;
 
                     while (!remainder.isEmpty()) {
-                        const QString nextPathStr = pathAsQString(result + remainder.firstComponent());
-                        if (!QFileInfo::exists(nextPathStr)) {
-                            const std::vector<Path> content = getDirectoryContents(result);
-                            const Path part = findCaseSensitivePath(content, remainder.firstComponent());
-                            if (part.isEmpty())
-                                return path;
-                            result = result + part;
-                        } else {
-                            result = result + remainder.firstComponent();
-                        }
+                        const auto part = findCaseSensitiveEntry(result, remainder.firstComponent());
+                        if (!part)
+                            return path;
+                        result = result + *part;
                         remainder = remainder.deleteFirstComponent();
                     }
                     return result;
@@ -133,13 +177,30 @@ namespace TrenchBroom {
                 return result;
             }
 
+            std::vector<std::pair<Path, bool>> getDirectoryEntries(const Path& path) {
+                const Path fixedPath = fixPath(path);
+                QDir dir(pathAsQString(fixedPath));
+                if (!dir.exists()) {
+                    throw FileSystemException("Cannot open directory: '" + fixedPath.asString() + "'");
+                }
+
+                dir.setFilter(QDir::NoDotAndDotDot | QDir::AllEntries);
+
+                std::vector<std::pair<Path, bool>> result;
+                for (const QFileInfo& entry : dir.entryInfoList()) {
+                    result.emplace_back(pathFromQString(entry.fileName()), entry.isDir());
+                }
+                return result;
+            }
+
             std::shared_ptr<File> openFile(const Path& path) {
                 const Path fixedPath = fixPath(path);
                 if (!fileExists(fixedPath)) {
                     throw FileNotFoundException(fixedPath.asString());
                 }
 
-                return std::make_shared<CFile>(fixedPath);
+                // the file is mapped into memory so that buffering its reader does not copy the file contents
+                return std::make_shared<MappedFile>(fixedPath);
             }
 
             std::string readTextFile(const Path& path) {
@@ -23,6 +23,8 @@
 
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
@@ -37,18 +39,26 @@ namespace TrenchBroom {
             bool fileExists(const Path& path);
 
             std::vector<Path> getDirectoryContents(const Path& path);
+
+            /**
+             * Returns the names of the items in the given directory, each paired with whether the item is a
+             * directory. The item types are determined while listing the directory, so this is much cheaper than
+             * calling directoryExists for each item of getDirectoryContents.
+             */
+            std::vector<std::pair<Path, bool>> getDirectoryEntries(const Path& path);
+
             std::shared_ptr<File> openFile(const Path& path);
             std::string readTextFile(const Path& path);
             Path getCurrentWorkingDir();
 
             template <class M>
             void doFindItems(const Path& searchPath, const M& matcher, const bool recurse, std::vector<Path>& result) {
-                for (const Path& itemPath : getDirectoryContents(searchPath)) {
-                    const bool directory = directoryExists(searchPath + itemPath);
+                for (const auto& [itemName, directory] : getDirectoryEntries(searchPath)) {
+                    const auto itemPath = searchPath + itemName;
                     if (directory && recurse)
-                        doFindItems(searchPath + itemPath, matcher, recurse, result);
-                    if (matcher(searchPath + itemPath, directory))
-                        result.push_back(searchPath + itemPath);
+                        doFindItems(itemPath, matcher, recurse, result);
+                    if (matcher(itemPath, directory))
+                        result.push_back(itemPath);
                 }
             }
 
@@ -33,6 +33,7 @@
 #include "Renderer/PrimType.h"
 
 #include <kdl/string_format.h>
+#include <kdl/vector_utils.h>
 
 #include <string>
 
@@ -381,15 +382,8 @@ namespace TrenchBroom {
         }
 
         void DkmParser::loadSkins(Assets::EntityModelSurface& surface, const DkmParser::DkmSkinList& skins, Logger& logger) {
-            std::vector<Assets::Texture> textures;
-            textures.reserve(skins.size());
-            
-            for (const auto& skin : skins) {
-                const auto skinPath = findSkin(skin);
-                textures.push_back(loadSkin(skinPath, m_fs, logger));
-            }
-            
-            surface.setSkins(std::move(textures));
+            const auto paths = kdl::vec_transform(skins, [&](const auto& skin) { return findSkin(skin); });
+            surface.setSkins(IO::loadSkins(paths, m_fs, logger));
         }
 
         /**
@@ -47,7 +47,7 @@ namespace TrenchBroom {
         m_begin(str.data()),
         m_end(str.data() + str.size()) {}
 
-        std::vector<EntityDefinitionClassInfo> EntParser::parseClassInfos(ParserStatus& status) {
+        std::vector<EntityDefinitionClassInfo> EntParser::doParseClassInfos(ParserStatus& status) {
             tinyxml2::XMLDocument doc;
             doc.Parse(m_begin, static_cast<size_t>(m_end - m_begin));
             if (doc.Error()) {
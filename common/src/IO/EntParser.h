@@ -55,7 +55,7 @@ namespace TrenchBroom {
         public:
             EntParser(std::string_view str, const Color& defaultEntityColor);
         private:
-            std::vector<EntityDefinitionClassInfo> parseClassInfos(ParserStatus& status) override;
+            std::vector<EntityDefinitionClassInfo> doParseClassInfos(ParserStatus& status) override;
             
             std::vector<EntityDefinitionClassInfo> parseClassInfos(const tinyxml2::XMLDocument& document, ParserStatus& status);
             std::optional<EntityDefinitionClassInfo> parseClassInfo(const tinyxml2::XMLElement& element, const PropertyDefinitionList& propertyDeclarations, ParserStatus& status);
@@ -0,0 +1,401 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EntityDefinitionCache.h"
+
+#include "Color.h"
+#include "Exceptions.h"
+#include "FloatType.h"
+#include "Assets/ModelDefinition.h"
+#include "Assets/PropertyDefinition.h"
+#include "EL/Expression.h"
+#include "IO/DiskIO.h"
+#include "IO/ELParser.h"
+#include "IO/EntityDefinitionClassInfo.h"
+#include "IO/File.h"
+#include "IO/MapCache.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <type_traits>
+
+namespace TrenchBroom {
+    namespace IO {
+        namespace EntityDefinitionCache {
+            namespace {
+                constexpr auto Magic = std::string_view{"TBDC"};
+                // increment this whenever the layout of the cache data or the class infos changes
+                constexpr auto Version = uint32_t(1);
+
+                /**
+                 * Appends values in native byte order. The cache is only ever read by the machine that wrote it, and
+                 * data from a different platform fails the validation of the header anyway.
+                 */
+                class CacheWriter {
+                private:
+                    std::string m_data;
+                public:
+                    template <typename T>
+                    void write(const T value) {
+                        static_assert(std::is_arithmetic_v<T>, "T must be an arithmetic type");
+                        m_data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+                    }
+
+                    void writeString(const std::string_view str) {
+                        write(uint64_t(str.size()));
+                        m_data.append(str);
+                    }
+
+                    void writeOptionalString(const std::optional<std::string>& str) {
+                        write(uint8_t(str ? 1 : 0));
+                        if (str) {
+                            writeString(*str);
+                        }
+                    }
+
+                    template <typename T, size_t S>
+                    void writeVec(const vm::vec<T,S>& vec) {
+                        for (size_t i = 0; i < S; ++i) {
+                            write(vec[i]);
+                        }
+                    }
+
+                    template <typename T>
+                    void writeOptional(const std::optional<T>& value) {
+                        write(uint8_t(value ? 1 : 0));
+                        if (value) {
+                            write(*value);
+                        }
+                    }
+
+                    std::string take() {
+                        return std::move(m_data);
+                    }
+                };
+
+                void writeFileInfo(CacheWriter& writer, const std::string_view contents) {
+                    writer.write(uint64_t(contents.size()));
+                    writer.write(MapCache::hashSource(contents));
+                }
+
+                void writeHeader(CacheWriter& writer, const std::string_view source, const std::vector<Path>& includedPaths) {
+                    writer.writeString(Magic);
+                    writer.write(Version);
+                    writer.write(uint32_t(sizeof(size_t)));
+                    writeFileInfo(writer, source);
+
+                    writer.write(uint64_t(includedPaths.size()));
+                    for (const auto& includedPath : includedPaths) {
+                        const auto file = Disk::openFile(includedPath);
+                        auto reader = file->reader().buffer();
+                        writer.writeString(includedPath.asString());
+                        writeFileInfo(writer, reader.stringView());
+                    }
+                }
+
+                void writePropertyDefinition(CacheWriter& writer, const Assets::PropertyDefinition& definition) {
+                    writer.write(uint8_t(definition.type()));
+                    writer.writeString(definition.key());
+                    writer.writeString(definition.shortDescription());
+                    writer.writeString(definition.longDescription());
+                    writer.write(uint8_t(definition.readOnly() ? 1 : 0));
+
+                    switch (definition.type()) {
+                        case Assets::PropertyDefinitionType::TargetSourceProperty:
+                        case Assets::PropertyDefinitionType::TargetDestinationProperty:
+                            break;
+                        case Assets::PropertyDefinitionType::StringProperty: {
+                            const auto& stringDefinition = static_cast<const Assets::StringPropertyDefinition&>(definition);
+                            writer.write(uint8_t(dynamic_cast<const Assets::UnknownPropertyDefinition*>(&definition) ? 1 : 0));
+                            writer.writeOptionalString(stringDefinition.hasDefaultValue() ? std::optional<std::string>{stringDefinition.defaultValue()} : std::nullopt);
+                            break;
+                        }
+                        case Assets::PropertyDefinitionType::BooleanProperty: {
+                            const auto& booleanDefinition = static_cast<const Assets::BooleanPropertyDefinition&>(definition);
+                            writer.writeOptional(booleanDefinition.hasDefaultValue() ? std::optional<uint8_t>{booleanDefinition.defaultValue() ? 1 : 0} : std::nullopt);
+                            break;
+                        }
+                        case Assets::PropertyDefinitionType::IntegerProperty: {
+                            const auto& integerDefinition = static_cast<const Assets::IntegerPropertyDefinition&>(definition);
+                            writer.writeOptional(integerDefinition.hasDefaultValue() ? std::optional<int32_t>{integerDefinition.defaultValue()} : std::nullopt);
+                            break;
+                        }
+                        case Assets::PropertyDefinitionType::FloatProperty: {
+                            const auto& floatDefinition = static_cast<const Assets::FloatPropertyDefinition&>(definition);
+                            writer.writeOptional(floatDefinition.hasDefaultValue() ? std::optional<float>{floatDefinition.defaultValue()} : std::nullopt);
+                            break;
+                        }
+                        case Assets::PropertyDefinitionType::ChoiceProperty: {
+                            const auto& choiceDefinition = static_cast<const Assets::ChoicePropertyDefinition&>(definition);
+                            writer.write(uint64_t(choiceDefinition.options().size()));
+                            for (const auto& option : choiceDefinition.options()) {
+                                writer.writeString(option.value());
+                                writer.writeString(option.description());
+                            }
+                            writer.writeOptionalString(choiceDefinition.hasDefaultValue() ? std::optional<std::string>{choiceDefinition.defaultValue()} : std::nullopt);
+                            break;
+                        }
+                        case Assets::PropertyDefinitionType::FlagsProperty: {
+                            const auto& flagsDefinition = static_cast<const Assets::FlagsPropertyDefinition&>(definition);
+                            writer.write(uint64_t(flagsDefinition.options().size()));
+                            for (const auto& option : flagsDefinition.options()) {
+                                writer.write(int32_t(option.value()));
+                                writer.writeString(option.shortDescription());
+                                writer.writeString(option.longDescription());
+                                writer.write(uint8_t(option.isDefault() ? 1 : 0));
+                            }
+                            break;
+                        }
+                    }
+                }
+
+                void writeClassInfo(CacheWriter& writer, const EntityDefinitionClassInfo& classInfo) {
+                    writer.write(uint8_t(classInfo.type));
+                    writer.write(uint64_t(classInfo.line));
+                    writer.write(uint64_t(classInfo.column));
+                    writer.writeString(classInfo.name);
+                    writer.writeOptionalString(classInfo.description);
+
+                    writer.write(uint8_t(classInfo.color ? 1 : 0));
+                    if (classInfo.color) {
+                        writer.writeVec(static_cast<const vm::vec<float,4>&>(*classInfo.color));
+                    }
+
+                    writer.write(uint8_t(classInfo.size ? 1 : 0));
+                    if (classInfo.size) {
+                        writer.writeVec(classInfo.size->min);
+                        writer.writeVec(classInfo.size->max);
+                    }
+
+                    // model definitions are stored as expression source and parsed again when the cache is read
+                    writer.writeOptionalString(classInfo.modelDefinition ? std::optional<std::string>{classInfo.modelDefinition->expression().asString()} : std::nullopt);
+
+                    writer.write(uint64_t(classInfo.propertyDefinitions.size()));
+                    for (const auto& propertyDefinition : classInfo.propertyDefinitions) {
+                        writePropertyDefinition(writer, *propertyDefinition);
+                    }
+
+                    writer.write(uint64_t(classInfo.superClasses.size()));
+                    for (const auto& superClass : classInfo.superClasses) {
+                        writer.writeString(superClass);
+                    }
+                }
+
+                std::string readString(Reader& reader) {
+                    const auto size = reader.readSize<uint64_t>();
+                    if (!reader.canRead(size)) {
+                        throw ReaderException("String size exceeds cache data");
+                    }
+                    return reader.readString(size);
+                }
+
+                std::optional<std::string> readOptionalString(Reader& reader) {
+                    if (reader.readUnsignedChar<uint8_t>() == 0) {
+                        return std::nullopt;
+                    }
+                    return readString(reader);
+                }
+
+                template <typename T>
+                std::optional<T> readOptional(Reader& reader) {
+                    if (reader.readUnsignedChar<uint8_t>() == 0) {
+                        return std::nullopt;
+                    }
+                    return reader.read<T, T>();
+                }
+
+                bool readFileInfo(Reader& reader, const std::string_view contents) {
+                    return reader.read<uint64_t, uint64_t>() == uint64_t(contents.size())
+                        && reader.read<uint64_t, uint64_t>() == MapCache::hashSource(contents);
+                }
+
+                bool readHeader(Reader& reader, const std::string_view source) {
+                    if (readString(reader) != Magic
+                        || reader.read<uint32_t, uint32_t>() != Version
+                        || reader.read<uint32_t, uint32_t>() != uint32_t(sizeof(size_t))
+                        || !readFileInfo(reader, source)) {
+                        return false;
+                    }
+
+                    const auto includedFileCount = reader.readSize<uint64_t>();
+                    for (size_t i = 0; i < includedFileCount; ++i) {
+                        const auto includedPath = Path{readString(reader)};
+                        if (!Disk::fileExists(includedPath)) {
+                            return false;
+                        }
+
+                        const auto file = Disk::openFile(includedPath);
+                        auto fileReader = file->reader().buffer();
+                        if (!readFileInfo(reader, fileReader.stringView())) {
+                            return false;
+                        }
+                    }
+
+                    return true;
+                }
+
+                std::shared_ptr<Assets::PropertyDefinition> readPropertyDefinition(Reader& reader) {
+                    const auto type = static_cast<Assets::PropertyDefinitionType>(reader.readUnsignedChar<uint8_t>());
+                    const auto key = readString(reader);
+                    const auto shortDescription = readString(reader);
+                    const auto longDescription = readString(reader);
+                    const auto readOnly = reader.readBool<uint8_t>();
+
+                    switch (type) {
+                        case Assets::PropertyDefinitionType::TargetSourceProperty:
+                        case Assets::PropertyDefinitionType::TargetDestinationProperty:
+                            return std::make_shared<Assets::PropertyDefinition>(key, type, shortDescription, longDescription, readOnly);
+                        case Assets::PropertyDefinitionType::StringProperty: {
+                            const auto unknown = reader.readBool<uint8_t>();
+                            auto defaultValue = readOptionalString(reader);
+                            if (unknown) {
+                                return std::make_shared<Assets::UnknownPropertyDefinition>(key, shortDescription, longDescription, readOnly, std::move(defaultValue));
+                            }
+                            return std::make_shared<Assets::StringPropertyDefinition>(key, shortDescription, longDescription, readOnly, std::move(defaultValue));
+                        }
+                        case Assets::PropertyDefinitionType::BooleanProperty: {
+                            const auto defaultValue = readOptional<uint8_t>(reader);
+                            return std::make_shared<Assets::BooleanPropertyDefinition>(key, shortDescription, longDescription, readOnly, defaultValue ? std::optional<bool>{*defaultValue != 0} : std::nullopt);
+                        }
+                        case Assets::PropertyDefinitionType::IntegerProperty:
+                            return std::make_shared<Assets::IntegerPropertyDefinition>(key, shortDescription, longDescription, readOnly, readOptional<int32_t>(reader));
+                        case Assets::PropertyDefinitionType::FloatProperty:
+                            return std::make_shared<Assets::FloatPropertyDefinition>(key, shortDescription, longDescription, readOnly, readOptional<float>(reader));
+                        case Assets::PropertyDefinitionType::ChoiceProperty: {
+                            const auto optionCount = reader.readSize<uint64_t>();
+                            auto options = Assets::ChoicePropertyOption::List{};
+                            for (size_t i = 0; i < optionCount; ++i) {
+                                auto value = readString(reader);
+                                auto description = readString(reader);
+                                options.emplace_back(value, description);
+                            }
+                            auto defaultValue = readOptionalString(reader);
+                            return std::make_shared<Assets::ChoicePropertyDefinition>(key, shortDescription, longDescription, options, readOnly, std::move(defaultValue));
+                        }
+                        case Assets::PropertyDefinitionType::FlagsProperty: {
+                            auto result = std::make_shared<Assets::FlagsPropertyDefinition>(key);
+                            const auto optionCount = reader.readSize<uint64_t>();
+                            for (size_t i = 0; i < optionCount; ++i) {
+                                const auto value = reader.read<int32_t, int>();
+                                const auto optionShortDescription = readString(reader);
+                                const auto optionLongDescription = readString(reader);
+                                const auto isDefault = reader.readBool<uint8_t>();
+                                result->addOption(value, optionShortDescription, optionLongDescription, isDefault);
+                            }
+                            return result;
+                        }
+                    }
+
+                    throw ReaderException("Unknown property definition type");
+                }
+
+                EntityDefinitionClassInfo readClassInfo(Reader& reader) {
+                    auto classInfo = EntityDefinitionClassInfo{};
+
+                    const auto type = reader.readUnsignedChar<uint8_t>();
+                    if (type > uint8_t(EntityDefinitionClassType::BaseClass)) {
+                        throw ReaderException("Unknown entity definition class type");
+                    }
+                    classInfo.type = static_cast<EntityDefinitionClassType>(type);
+                    classInfo.line = reader.readSize<uint64_t>();
+                    classInfo.column = reader.readSize<uint64_t>();
+                    classInfo.name = readString(reader);
+                    classInfo.description = readOptionalString(reader);
+
+                    if (reader.readUnsignedChar<uint8_t>() != 0) {
+                        classInfo.color = Color{reader.readVec<float, 4>()};
+                    }
+
+                    if (reader.readUnsignedChar<uint8_t>() != 0) {
+                        const auto min = reader.readVec<FloatType, 3>();
+                        const auto max = reader.readVec<FloatType, 3>();
+                        classInfo.size = vm::bbox3{min, max};
+                    }
+
+                    if (const auto expression = readOptionalString(reader)) {
+                        // an empty model definition holds an undefined literal, which cannot be parsed
+                        classInfo.modelDefinition = *expression == "undefined"
+                            ? Assets::ModelDefinition{}
+                            : Assets::ModelDefinition{ELParser::parseStrict(*expression)};
+                    }
+
+                    const auto propertyDefinitionCount = reader.readSize<uint64_t>();
+                    for (size_t i = 0; i < propertyDefinitionCount; ++i) {
+                        classInfo.propertyDefinitions.push_back(readPropertyDefinition(reader));
+                    }
+
+                    const auto superClassCount = reader.readSize<uint64_t>();
+                    for (size_t i = 0; i < superClassCount; ++i) {
+                        classInfo.superClasses.push_back(readString(reader));
+                    }
+
+                    return classInfo;
+                }
+            }
+
+            Path cachePath(const Path& cacheDirectory, const Path& path) {
+                auto name = std::stringstream{};
+                name << std::hex << std::setw(16) << std::setfill('0') << MapCache::hashSource(path.asString()) << ".tbdefcache";
+                return cacheDirectory + Path{name.str()};
+            }
+
+            std::string write(const std::string_view source, const std::vector<Path>& includedPaths, const std::vector<EntityDefinitionClassInfo>& classInfos) {
+                auto writer = CacheWriter{};
+                writeHeader(writer, source, includedPaths);
+
+                writer.write(uint64_t(classInfos.size()));
+                for (const auto& classInfo : classInfos) {
+                    writeClassInfo(writer, classInfo);
+                }
+
+                return writer.take();
+            }
+
+            std::optional<std::vector<EntityDefinitionClassInfo>> read(const std::string_view cacheData, const std::string_view source) {
+                try {
+                    auto reader = Reader::from(cacheData.data(), cacheData.data() + cacheData.size());
+                    if (!readHeader(reader, source)) {
+                        return std::nullopt;
+                    }
+
+                    const auto classInfoCount = reader.readSize<uint64_t>();
+                    auto classInfos = std::vector<EntityDefinitionClassInfo>{};
+                    for (size_t i = 0; i < classInfoCount; ++i) {
+                        classInfos.push_back(readClassInfo(reader));
+                    }
+
+                    if (!reader.eof()) {
+                        return std::nullopt;
+                    }
+                    return classInfos;
+                } catch (const Exception&) {
+                    // malformed cache data and unreadable or unparsable included files are treated like stale data
+                    return std::nullopt;
+                }
+            }
+        }
+    }
+}
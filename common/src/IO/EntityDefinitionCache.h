@@ -0,0 +1,67 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        struct EntityDefinitionClassInfo;
+        class Path;
+
+        /**
+         * Stores the class infos that an entity definition parser collects in a compact binary form, so that an
+         * unchanged entity definition file can be loaded again without tokenizing and parsing it.
+         *
+         * The cache data contains a hash of the source string and the paths and hashes of all files that were
+         * included by it. Cache data that doesn't match the current files is ignored. Parser warnings are not
+         * stored, so they are only reported when the source is actually parsed.
+         */
+        namespace EntityDefinitionCache {
+            /**
+             * Returns the path of the cache file for the entity definition file at the given absolute path. The
+             * cache files are stored in the given directory because the entity definition files are often shipped
+             * with the application or the game and may not be writable.
+             */
+            Path cachePath(const Path& cacheDirectory, const Path& path);
+
+            /**
+             * Serializes the given class infos which were parsed from the given source string.
+             *
+             * @param source the source string
+             * @param includedPaths the absolute paths of the files which were included by the source
+             * @param classInfos the class infos to serialize
+             *
+             * @throws FileSystemException if an included file cannot be read
+             */
+            std::string write(std::string_view source, const std::vector<Path>& includedPaths, const std::vector<EntityDefinitionClassInfo>& classInfos);
+
+            /**
+             * Restores the class infos from the given cache data. Returns an empty optional if the cache data is
+             * malformed, if it was not created for the given source string, or if any of the included files has
+             * changed.
+             */
+            std::optional<std::vector<EntityDefinitionClassInfo>> read(std::string_view cacheData, std::string_view source);
+        }
+    }
+}
@@ -326,7 +326,7 @@ namespace TrenchBroom {
             };
         }
 
-        std::vector<Assets::EntityDefinition*> EntityDefinitionParser::createDefinitions(ParserStatus& status, const std::vector<EntityDefinitionClassInfo>& classInfos) const {
+        EntityDefinitionParser::EntityDefinitionList EntityDefinitionParser::createDefinitions(ParserStatus& status, const std::vector<EntityDefinitionClassInfo>& classInfos) const {
             const auto resolvedClasses = resolveInheritance(status, filterRedundantClasses(status, classInfos));
 
             std::vector<Assets::EntityDefinition*> result;
@@ -343,5 +343,9 @@ namespace TrenchBroom {
             auto classInfos = parseClassInfos(status);
             return createDefinitions(status, std::move(classInfos));
         }
+
+        std::vector<EntityDefinitionClassInfo> EntityDefinitionParser::parseClassInfos(ParserStatus& status) {
+            return doParseClassInfos(status);
+        }
     }
 }
@@ -52,11 +52,21 @@ namespace TrenchBroom {
             virtual ~EntityDefinitionParser();
             
             EntityDefinitionList parseDefinitions(ParserStatus& status);
+
+            /**
+             * Parses the class infos without resolving their inheritance. Together with createDefinitions, this
+             * allows the class infos to be cached.
+             */
+            std::vector<EntityDefinitionClassInfo> parseClassInfos(ParserStatus& status);
+
+            /**
+             * Resolves the inheritance of the given class infos and creates the entity definitions.
+             */
+            EntityDefinitionList createDefinitions(ParserStatus& status, const std::vector<EntityDefinitionClassInfo>& classInfos) const;
         private:
             std::unique_ptr<Assets::EntityDefinition> createDefinition(const EntityDefinitionClassInfo& classInfo) const;
-            std::vector<Assets::EntityDefinition*> createDefinitions(ParserStatus& status, const std::vector<EntityDefinitionClassInfo>& classInfos) const;
  
-            virtual std::vector<EntityDefinitionClassInfo> parseClassInfos(ParserStatus& status) = 0;
+            virtual std::vector<EntityDefinitionClassInfo> doParseClassInfos(ParserStatus& status) = 0;
         };
     }
 }
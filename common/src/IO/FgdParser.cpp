@@ -139,6 +139,10 @@ namespace TrenchBroom {
         FgdParser::FgdParser(std::string_view str, const Color& defaultEntityColor) :
         FgdParser(std::move(str), defaultEntityColor, Path()) {}
 
+        const std::vector<Path>& FgdParser::includedPaths() const {
+            return m_includedPaths;
+        }
+
         FgdParser::TokenNameMap FgdParser::tokenNames() const {
             using namespace FgdToken;
 
@@ -201,7 +205,7 @@ namespace TrenchBroom {
             return false;
         }
 
-        std::vector<EntityDefinitionClassInfo> FgdParser::parseClassInfos(ParserStatus& status) {
+        std::vector<EntityDefinitionClassInfo> FgdParser::doParseClassInfos(ParserStatus& status) {
             std::vector<EntityDefinitionClassInfo> classInfos;
             auto token = m_tokenizer.peekToken();
             while (!token.hasType(FgdToken::Eof)) {
@@ -725,9 +729,10 @@ namespace TrenchBroom {
 
                 if (!isRecursiveInclude(filePath)) {
                     const PushIncludePath pushIncludePath(this, filePath);
+                    m_includedPaths.push_back(m_fs->makeAbsolute(filePath));
                     auto reader = file->reader().buffer();
                     m_tokenizer.replaceState(reader.stringView());
-                    result = parseClassInfos(status);
+                    result = doParseClassInfos(status);
                 } else {
                     status.error(m_tokenizer.line(), kdl::str_to_string("Skipping recursively included file: ", path.asString(), " (", filePath, ")"));
                 }
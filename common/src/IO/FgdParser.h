@@ -72,12 +72,18 @@ namespace TrenchBroom {
             using Token = FgdTokenizer::Token;
 
             std::vector<Path> m_paths;
+            std::vector<Path> m_includedPaths;
             std::shared_ptr<FileSystem> m_fs;
 
             FgdTokenizer m_tokenizer;
         public:
             FgdParser(std::string_view str, const Color& defaultEntityColor, const Path& path);
             FgdParser(std::string_view str, const Color& defaultEntityColor);
+
+            /**
+             * Returns the absolute paths of the files which were included while parsing.
+             */
+            const std::vector<Path>& includedPaths() const;
         private:
             class PushIncludePath;
             void pushIncludePath(const Path& path);
@@ -88,7 +94,7 @@ namespace TrenchBroom {
         private:
             TokenNameMap tokenNames() const override;
 
-            std::vector<EntityDefinitionClassInfo> parseClassInfos(ParserStatus& status) override;
+            std::vector<EntityDefinitionClassInfo> doParseClassInfos(ParserStatus& status) override;
 
             void parseClassInfoOrInclude(ParserStatus& status, std::vector<EntityDefinitionClassInfo>& classInfos);
 
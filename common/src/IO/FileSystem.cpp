@@ -49,6 +49,10 @@ namespace TrenchBroom {
             return std::move(m_next);
         }
 
+        void FileSystem::setNext(std::shared_ptr<FileSystem> next) {
+            m_next = std::move(next);
+        }
+
         bool FileSystem::canMakeAbsolute(const Path& path) const {
             return !path.isAbsolute();
         }
@@ -184,6 +188,15 @@ namespace TrenchBroom {
             }
         }
 
+        std::vector<std::pair<Path, bool>> FileSystem::doGetDirectoryEntries(const Path& path) const {
+            auto result = std::vector<std::pair<Path, bool>>{};
+            for (auto& itemName : doGetDirectoryContents(path)) {
+                const auto directory = doDirectoryExists(path + itemName);
+                result.emplace_back(std::move(itemName), directory);
+            }
+            return result;
+        }
+
         bool FileSystem::doCanMakeAbsolute(const Path& /* path */) const {
             return false;
         }
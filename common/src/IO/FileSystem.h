@@ -27,6 +27,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
@@ -34,6 +35,10 @@ namespace TrenchBroom {
         class File;
         class Path;
 
+        /**
+         * The const methods of a file system may be called concurrently, e.g. to open and read files on several
+         * threads, as long as neither the file system nor the file systems it is chained to are modified meanwhile.
+         */
         class FileSystem {
             deleteCopyAndMove(FileSystem)
         protected:
@@ -55,6 +60,12 @@ namespace TrenchBroom {
             const FileSystem& next() const;
             std::shared_ptr<FileSystem> releaseNext();
 
+            /**
+             * Replaces the next file system in the search path. This allows to create file systems independently of
+             * each other, e.g. concurrently, and to chain them afterwards.
+             */
+            void setNext(std::shared_ptr<FileSystem> next);
+
             bool canMakeAbsolute(const Path& path) const;
             Path makeAbsolute(const Path& path) const;
 
@@ -186,14 +197,22 @@ namespace TrenchBroom {
             template <class M>
             void doFindItems(const Path& searchPath, const M& matcher, const bool recurse, std::vector<Path>& result) const {
                 if (doDirectoryExists(searchPath)) {
-                    for (const auto& itemPath : doGetDirectoryContents(searchPath)) {
-                        const auto directory = doDirectoryExists(searchPath + itemPath);
-                        if (directory && recurse) {
-                            doFindItems(searchPath + itemPath, matcher, recurse, result);
-                        }
-                        if (matcher(searchPath + itemPath, directory)) {
-                            result.push_back(searchPath + itemPath);
-                        }
+                    doFindItemsInDirectory(searchPath, matcher, recurse, result);
+                }
+            }
+
+            /**
+             * Like doFindItems, but assumes that the given search path is an existing directory of this file system.
+             */
+            template <class M>
+            void doFindItemsInDirectory(const Path& searchPath, const M& matcher, const bool recurse, std::vector<Path>& result) const {
+                for (const auto& [itemName, directory] : doGetDirectoryEntries(searchPath)) {
+                    const auto itemPath = searchPath + itemName;
+                    if (directory && recurse) {
+                        doFindItemsInDirectory(itemPath, matcher, recurse, result);
+                    }
+                    if (matcher(itemPath, directory)) {
+                        result.push_back(itemPath);
                     }
                 }
             }
@@ -206,6 +225,13 @@ namespace TrenchBroom {
 
             virtual std::vector<Path> doGetDirectoryContents(const Path& path) const = 0;
 
+            /**
+             * Returns the items in the given directory, each paired with whether the item is a directory. The default
+             * implementation checks each item of doGetDirectoryContents individually, so file systems which can
+             * determine the item types while listing a directory should override this.
+             */
+            virtual std::vector<std::pair<Path, bool>> doGetDirectoryEntries(const Path& path) const;
+
             virtual std::shared_ptr<File> doOpenFile(const Path& path) const = 0;
         };
 
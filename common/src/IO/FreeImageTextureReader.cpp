@@ -23,17 +23,28 @@
 #include "Ensure.h"
 #include "Exceptions.h"
 #include "FreeImage.h"
+#include "Logger.h"
 #include "Assets/Texture.h"
 #include "Assets/TextureBuffer.h"
 #include "IO/File.h"
 #include "IO/ImageLoaderImpl.h"
+#include "IO/TextureCache.h"
 
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <stdexcept>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
-        FreeImageTextureReader::FreeImageTextureReader(const NameStrategy& nameStrategy, const FileSystem& fs, Logger& logger) :
-        TextureReader(nameStrategy, fs, logger) {}
+        FreeImageTextureReader::FreeImageTextureReader(const NameStrategy& nameStrategy, const FileSystem& fs, Logger& logger, const bool deferDecoding) :
+        TextureReader(nameStrategy, fs, logger),
+        m_deferDecoding(deferDecoding) {}
+
+        void FreeImageTextureReader::setCache(std::shared_ptr<TextureCache> cache) {
+            m_cache = std::move(cache);
+        }
 
         /**
          * The byte order of a 32bpp FIBITMAP is defined by the macros FI_RGBA_RED,
@@ -66,24 +77,89 @@ namespace TrenchBroom {
             const unsigned char* const data = buffer.data();
             const std::size_t bufferSize = buffer.size();
 
-            Color average;
+            // Summing the channels as integers is exact and cheap, whereas summing colors converts every channel to
+            // float and loses precision on large textures.
+            std::uint64_t sum[4] = {0u, 0u, 0u, 0u};
             for (std::size_t i = 0; i < bufferSize; i += 4) {
-                average = average + Color(data[i], data[i+1], data[i+2], data[i+3]);
+                sum[0] += data[i];
+                sum[1] += data[i+1];
+                sum[2] += data[i+2];
+                sum[3] += data[i+3];
             }
             const std::size_t numPixels = bufferSize / 4;
-            average = average / static_cast<float>(numPixels);
+            const auto divisor = 255.0f * static_cast<float>(numPixels);
 
-            return average;
+            return Color(static_cast<float>(sum[0]) / divisor,
+                         static_cast<float>(sum[1]) / divisor,
+                         static_cast<float>(sum[2]) / divisor,
+                         static_cast<float>(sum[3]) / divisor);
         }
 
-        Assets::Texture FreeImageTextureReader::doReadTexture(std::shared_ptr<File> file) const {
-            auto reader = file->reader().buffer();
+        struct DecodedImage {
+            size_t width;
+            size_t height;
+            bool masked;
+            Assets::TextureBufferList buffers;
+            Color averageColor;
+        };
+
+        using CheckDimensions = bool(*)(size_t width, size_t height);
+
+        /**
+         * Copies the pixels of the given image to the given buffer, top row first, if the image is an opaque 24 bit
+         * or 8 bit indexed image. These are the most common formats of TGA and PCX textures, and copying them
+         * directly avoids converting the entire image to 32 bits first.
+         *
+         * Returns false if the image has a different format and must be converted.
+         */
+        static bool copyOpaquePixels(FIBITMAP* image, unsigned char* outBytes, const size_t width, const size_t height) {
+            if (FreeImage_GetImageType(image) != FIT_BITMAP || FreeImage_IsTransparent(image)) {
+                return false;
+            }
+
+            const auto bitsPerPixel = FreeImage_GetBPP(image);
+            const auto colourType = FreeImage_GetColorType(image);
+            if (bitsPerPixel == 24 && colourType == FIC_RGB) {
+                for (size_t y = 0; y < height; ++y) {
+                    // FreeImage stores the rows bottom up
+                    const auto* inRow = FreeImage_GetScanLine(image, static_cast<int>(height - y - 1));
+                    auto* outRow = outBytes + y * width * 4;
+                    for (size_t x = 0; x < width; ++x) {
+                        outRow[4 * x + FI_RGBA_RED]   = inRow[3 * x + FI_RGBA_RED];
+                        outRow[4 * x + FI_RGBA_GREEN] = inRow[3 * x + FI_RGBA_GREEN];
+                        outRow[4 * x + FI_RGBA_BLUE]  = inRow[3 * x + FI_RGBA_BLUE];
+                        outRow[4 * x + FI_RGBA_ALPHA] = 0xFF;
+                    }
+                }
+                return true;
+            }
+
+            if (bitsPerPixel == 8 && colourType == FIC_PALETTE && FreeImage_GetColorsUsed(image) == 256) {
+                const auto* palette = FreeImage_GetPalette(image);
+                if (palette == nullptr) {
+                    return false;
+                }
+
+                for (size_t y = 0; y < height; ++y) {
+                    const auto* inRow = FreeImage_GetScanLine(image, static_cast<int>(height - y - 1));
+                    auto* outRow = outBytes + y * width * 4;
+                    for (size_t x = 0; x < width; ++x) {
+                        const auto& colour = palette[inRow[x]];
+                        outRow[4 * x + FI_RGBA_RED]   = colour.rgbRed;
+                        outRow[4 * x + FI_RGBA_GREEN] = colour.rgbGreen;
+                        outRow[4 * x + FI_RGBA_BLUE]  = colour.rgbBlue;
+                        outRow[4 * x + FI_RGBA_ALPHA] = 0xFF;
+                    }
+                }
+                return true;
+            }
+
+            return false;
+        }
 
+        static DecodedImage decodeImage(const char* begin, const char* end, const CheckDimensions checkDimensions) {
             InitFreeImage::initialize();
 
-            const auto& path            = file->path();
-            const auto* begin           = reader.begin();
-            const auto* end             = reader.end();
             const auto  imageSize       = static_cast<size_t>(end - begin);
                   auto* imageBegin      = reinterpret_cast<BYTE*>(const_cast<char*>(begin));
                   auto* imageMemory     = FreeImage_OpenMemory(imageBegin, static_cast<DWORD>(imageSize));
@@ -98,7 +174,8 @@ namespace TrenchBroom {
             const auto imageWidth      = static_cast<size_t>(FreeImage_GetWidth(image));
             const auto imageHeight     = static_cast<size_t>(FreeImage_GetHeight(image));
 
-            if (!checkTextureDimensions(imageWidth, imageHeight)) {
+            if (!checkDimensions(imageWidth, imageHeight)) {
+                FreeImage_Unload(image);
                 FreeImage_CloseMemory(imageMemory);
                 throw AssetException("Invalid texture dimensions");
             }
@@ -113,6 +190,15 @@ namespace TrenchBroom {
             Assets::TextureBufferList buffers(mipCount);
             Assets::setMipBufferSize(buffers, mipCount, imageWidth, imageHeight, format);
 
+                  auto* outBytes = buffers.at(0).data();
+            if (copyOpaquePixels(image, outBytes, imageWidth, imageHeight)) {
+                FreeImage_Unload(image);
+                FreeImage_CloseMemory(imageMemory);
+
+                const Color averageColor = getAverageColor(buffers.at(0), format);
+                return DecodedImage{imageWidth, imageHeight, masked == TRUE, std::move(buffers), averageColor};
+            }
+
             const auto inputBytesPerPixel = FreeImage_GetLine(image) / FreeImage_GetWidth(image);
             if (imageColourType != FIC_RGBALPHA || inputBytesPerPixel != 4) {
                 FIBITMAP* tempImage = FreeImage_ConvertTo32Bits(image);
@@ -128,7 +214,6 @@ namespace TrenchBroom {
             const auto bytesPerPixel = FreeImage_GetLine(image) / FreeImage_GetWidth(image);
             ensure(bytesPerPixel == 4, "expected to have converted image to 32-bit");
 
-                  auto* outBytes = buffers.at(0).data();
             const auto  outBytesPerRow = static_cast<int>(imageWidth * 4);
 
             FreeImage_ConvertToRawBits(outBytes, image, outBytesPerRow, 32, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
@@ -136,10 +221,96 @@ namespace TrenchBroom {
             FreeImage_Unload(image);
             FreeImage_CloseMemory(imageMemory);
 
-            const auto textureType = Assets::Texture::selectTextureType(masked);
             const Color averageColor = getAverageColor(buffers.at(0), format);
+            return DecodedImage{imageWidth, imageHeight, masked == TRUE, std::move(buffers), averageColor};
+        }
+
+        struct ImageHeader {
+            size_t width;
+            size_t height;
+            bool masked;
+        };
 
-            return Assets::Texture(textureName(path), imageWidth, imageHeight, averageColor, std::move(buffers), format, textureType);
+        /**
+         * Reads only the header of the given image. Returns an empty optional if the image format does not support
+         * loading the header without the pixel data.
+         */
+        static std::optional<ImageHeader> readImageHeader(const char* begin, const char* end) {
+            InitFreeImage::initialize();
+
+            const auto  imageSize       = static_cast<size_t>(end - begin);
+                  auto* imageBegin      = reinterpret_cast<BYTE*>(const_cast<char*>(begin));
+                  auto* imageMemory     = FreeImage_OpenMemory(imageBegin, static_cast<DWORD>(imageSize));
+            const auto  imageFormat     = FreeImage_GetFileTypeFromMemory(imageMemory);
+
+            if (imageFormat == FIF_UNKNOWN || !FreeImage_FIFSupportsNoPixels(imageFormat)) {
+                FreeImage_CloseMemory(imageMemory);
+                return std::nullopt;
+            }
+
+            auto* image = FreeImage_LoadFromMemory(imageFormat, imageMemory, FIF_LOAD_NOPIXELS);
+            if (image == nullptr) {
+                FreeImage_CloseMemory(imageMemory);
+                return std::nullopt;
+            }
+
+            const auto imageWidth  = static_cast<size_t>(FreeImage_GetWidth(image));
+            const auto imageHeight = static_cast<size_t>(FreeImage_GetHeight(image));
+
+            // Without pixels, FreeImage cannot check the alpha channel, so any image with an alpha channel is
+            // considered to be transparent.
+            const auto masked = FreeImage_IsTransparent(image);
+
+            FreeImage_Unload(image);
+            FreeImage_CloseMemory(imageMemory);
+
+            return ImageHeader{imageWidth, imageHeight, masked == TRUE};
+        }
+
+        Assets::Texture FreeImageTextureReader::doReadTexture(std::shared_ptr<File> file) const {
+            auto reader = file->reader().buffer();
+            constexpr auto format = freeImage32BPPFormatToGLFormat();
+
+            const auto& path = file->path();
+            if (m_deferDecoding) {
+                if (const auto header = readImageHeader(reader.begin(), reader.end())) {
+                    if (!checkTextureDimensions(header->width, header->height)) {
+                        throw AssetException("Invalid texture dimensions");
+                    }
+
+                    // keep a copy of the encoded data because the file may not outlive the texture
+                    auto data = std::make_shared<std::vector<char>>(reader.begin(), reader.end());
+                    auto decoder = [data = std::move(data)]() {
+                        auto image = decodeImage(data->data(), data->data() + data->size(), &FreeImageTextureReader::checkTextureDimensions);
+                        return Assets::DecodedTextureData{std::move(image.buffers), image.averageColor};
+                    };
+
+                    const auto textureType = Assets::Texture::selectTextureType(header->masked);
+                    const auto placeholderColor = Color(0.5f, 0.5f, 0.5f, 1.0f);
+                    return Assets::Texture(textureName(path), header->width, header->height, placeholderColor, std::move(decoder), format, textureType);
+                }
+            }
+
+            const auto dataSize = static_cast<size_t>(reader.end() - reader.begin());
+            const auto cacheKey = m_cache ? TextureCache::computeKey(reader.begin(), reader.end()) : uint64_t(0);
+            if (m_cache) {
+                if (auto cachedTexture = m_cache->readTexture(cacheKey, dataSize, textureName(path))) {
+                    return std::move(*cachedTexture);
+                }
+            }
+
+            auto image = decodeImage(reader.begin(), reader.end(), &FreeImageTextureReader::checkTextureDimensions);
+            const auto textureType = Assets::Texture::selectTextureType(image.masked);
+
+            auto texture = Assets::Texture(textureName(path), image.width, image.height, image.averageColor, std::move(image.buffers), format, textureType);
+            if (m_cache) {
+                try {
+                    m_cache->writeTexture(cacheKey, dataSize, texture);
+                } catch (const FileSystemException& e) {
+                    m_logger.debug() << "Could not cache texture '" << path << "': " << e.what();
+                }
+            }
+            return texture;
         }
     }
 }
@@ -30,10 +30,25 @@ namespace TrenchBroom {
     namespace IO {
         class File;
         class FileSystem;
+        class TextureCache;
 
         class FreeImageTextureReader : public TextureReader {
+        private:
+            bool m_deferDecoding;
+            std::shared_ptr<TextureCache> m_cache;
         public:
-            explicit FreeImageTextureReader(const NameStrategy& nameStrategy, const FileSystem& fs, Logger& logger);
+            /**
+             * Creates a new reader. If deferDecoding is true, only the image header is read and the pixel data is
+             * decoded when the texture is first used, provided that the image format supports this. The encoded
+             * image data is kept in memory until then.
+             */
+            explicit FreeImageTextureReader(const NameStrategy& nameStrategy, const FileSystem& fs, Logger& logger, bool deferDecoding = false);
+
+            /**
+             * Sets the cache to look up decoded images in before decoding them. Images that are decoded are added to
+             * the cache. Textures whose decoding is deferred bypass the cache.
+             */
+            void setCache(std::shared_ptr<TextureCache> cache);
         private:
             Assets::Texture doReadTexture(std::shared_ptr<File> file) const override;
         };
@@ -23,8 +23,11 @@
 #include "IO/DiskFileSystem.h"
 #include "IO/File.h"
 
+#include <kdl/string_format.h>
+
 #include <cassert>
 #include <memory>
+#include <mutex>
 
 namespace TrenchBroom {
     namespace IO {
@@ -34,6 +37,14 @@ namespace TrenchBroom {
             return doOpen();
         }
 
+        bool ImageFileSystemBase::FileEntry::compressed() const {
+            return doIsCompressed();
+        }
+
+        bool ImageFileSystemBase::FileEntry::doIsCompressed() const {
+            return false;
+        }
+
         ImageFileSystemBase::SimpleFileEntry::SimpleFileEntry(std::shared_ptr<File> file) :
         m_file(std::move(file)) {}
 
@@ -50,6 +61,10 @@ namespace TrenchBroom {
             return std::make_shared<OwningBufferFile>(m_file->path(), std::move(data), m_uncompressedSize);
         }
 
+        bool ImageFileSystemBase::CompressedFileEntry::doIsCompressed() const {
+            return true;
+        }
+
         ImageFileSystemBase::Directory::Directory(const Path& path) :
         m_path(path) {}
 
@@ -69,78 +84,37 @@ namespace TrenchBroom {
             }
         }
 
-        bool ImageFileSystemBase::Directory::directoryExists(const Path& path) const {
-            if (path.isEmpty()) {
-                return true;
-            }
+        std::vector<Path> ImageFileSystemBase::Directory::contents() const {
+            std::vector<Path> contents;
 
-            auto it = m_directories.find(path.firstComponent());
-            if (it == std::end(m_directories)) {
-                return false;
-            } else {
-                return it->second->directoryExists(path.deleteFirstComponent());
+            for (const auto& [path, directory] : m_directories) {
+                contents.push_back(Path(path));
             }
-        }
 
-        bool ImageFileSystemBase::Directory::fileExists(const Path& path) const {
-            if (path.length() == 1) {
-                return m_files.count(path) > 0;
+            for (const auto& [path, file] : m_files) {
+                contents.push_back(Path(path));
             }
 
-            auto it = m_directories.find(path.firstComponent());
-            if (it == std::end(m_directories)) {
-                return false;
-            } else {
-                return it->second->fileExists(path.deleteFirstComponent());
-            }
+            return contents;
         }
 
-        const ImageFileSystemBase::Directory& ImageFileSystemBase::Directory::findDirectory(const Path& path) const {
-            if (path.isEmpty()) {
-                return *this;
-            }
-
-            auto it = m_directories.find(path.firstComponent());
-            if (it == std::end(m_directories)) {
-                throw FileSystemException("Path does not exist: '" + (m_path + path).asString() + "'");
-            } else {
-                return it->second->findDirectory(path.deleteFirstComponent());
-            }
+        /**
+         * Returns the key of the given path in the file and directory indices.
+         */
+        static std::string indexKey(const Path& path) {
+            return kdl::str_to_lower(path.asString("/"));
         }
 
-        const ImageFileSystemBase::FileEntry& ImageFileSystemBase::Directory::findFile(const Path& path) const {
-            assert(!path.isEmpty());
+        void ImageFileSystemBase::Directory::collectIndex(FileIndex& fileIndex, DirectoryIndex& directoryIndex) const {
+            directoryIndex[indexKey(m_path)] = contents();
 
-            const auto name = path.firstComponent();
-            if (path.length() == 1) {
-                auto it = m_files.find(name);
-                if (it == std::end(m_files)) {
-                    throw FileSystemException("File not found: '" + (m_path + path).asString() + "'");
-                } else {
-                    return *it->second;
-                }
-            } else {
-                auto it = m_directories.find(name);
-                if (it == std::end(m_directories)) {
-                    throw FileSystemException("File not found: '" + (m_path + path).asString() + "'");
-                } else {
-                    return it->second->findFile(path.deleteFirstComponent());
-                }
+            for (const auto& [path, file] : m_files) {
+                fileIndex[indexKey(m_path + path)] = file.get();
             }
-        }
-
-        std::vector<Path> ImageFileSystemBase::Directory::contents() const {
-            std::vector<Path> contents;
 
             for (const auto& [path, directory] : m_directories) {
-                contents.push_back(Path(path));
-            }
-
-            for (const auto& [path, file] : m_files) {
-                contents.push_back(Path(path));
+                directory->collectIndex(fileIndex, directoryIndex);
             }
-
-            return contents;
         }
 
         ImageFileSystemBase::Directory& ImageFileSystemBase::Directory::findOrCreateDirectory(const Path& path) {
@@ -159,7 +133,9 @@ namespace TrenchBroom {
         ImageFileSystemBase::ImageFileSystemBase(std::shared_ptr<FileSystem> next, const Path& path) :
         FileSystem(std::move(next)),
         m_path(path),
-        m_root(Path()) {}
+        m_root(Path()),
+        m_cacheCapacity(DefaultCacheCapacity),
+        m_cacheSize(0u) {}
 
 
         ImageFileSystemBase::~ImageFileSystemBase() = default;
@@ -170,37 +146,95 @@ namespace TrenchBroom {
             } catch (const std::exception& e) {
                 throw FileSystemException("Could not initialize image file system '" + m_path.asString() + "': " + e.what());
             }
+            buildIndex();
         }
 
         void ImageFileSystemBase::reload() {
+            clearCache();
             m_root = Directory(Path());
             initialize();
         }
 
+        void ImageFileSystemBase::setCacheCapacity(const size_t cacheCapacity) {
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            m_cacheCapacity = cacheCapacity;
+            evictCachedFiles();
+        }
+
+        void ImageFileSystemBase::buildIndex() {
+            m_fileIndex.clear();
+            m_directoryIndex.clear();
+            m_root.collectIndex(m_fileIndex, m_directoryIndex);
+        }
+
         bool ImageFileSystemBase::doDirectoryExists(const Path& path) const {
-            const auto searchPath = path.makeLowerCase().makeCanonical();
-            return m_root.directoryExists(searchPath);
+            return m_directoryIndex.count(indexKey(path.makeCanonical())) > 0u;
         }
 
         bool ImageFileSystemBase::doFileExists(const Path& path) const {
-            const auto searchPath = path.makeLowerCase().makeCanonical();
-            return m_root.fileExists(searchPath);
+            return m_fileIndex.count(indexKey(path.makeCanonical())) > 0u;
         }
 
         std::vector<Path> ImageFileSystemBase::doGetDirectoryContents(const Path& path) const {
-            const auto searchPath = path.makeLowerCase().makeCanonical();
-            const auto& directory = m_root.findDirectory(path);
-            return directory.contents();
+            const auto it = m_directoryIndex.find(indexKey(path.makeCanonical()));
+            if (it == std::end(m_directoryIndex)) {
+                throw FileSystemException("Path does not exist: '" + (m_path + path).asString() + "'");
+            }
+            return it->second;
         }
 
         std::shared_ptr<File> ImageFileSystemBase::doOpenFile(const Path& path) const {
-            const auto searchPath = path.makeLowerCase().makeCanonical();
-            return m_root.findFile(path).open();
+            const auto it = m_fileIndex.find(indexKey(path.makeCanonical()));
+            if (it == std::end(m_fileIndex)) {
+                throw FileSystemException("File not found: '" + (m_path + path).asString() + "'");
+            }
+
+            const auto& entry = *it->second;
+            return entry.compressed() ? openCompressedFile(entry) : entry.open();
+        }
+
+        std::shared_ptr<File> ImageFileSystemBase::openCompressedFile(const FileEntry& entry) const {
+            {
+                std::lock_guard<std::mutex> lock(m_cacheMutex);
+                if (const auto it = m_cacheIndex.find(&entry); it != std::end(m_cacheIndex)) {
+                    m_cache.splice(std::begin(m_cache), m_cache, it->second);
+                    return it->second->second;
+                }
+            }
+
+            // decompress without holding the lock, the file may be large
+            auto file = entry.open();
+
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            if (m_cacheIndex.count(&entry) == 0u && file->size() <= m_cacheCapacity) {
+                m_cache.emplace_front(&entry, file);
+                m_cacheIndex.emplace(&entry, std::begin(m_cache));
+                m_cacheSize += file->size();
+                evictCachedFiles();
+            }
+            return file;
+        }
+
+        void ImageFileSystemBase::evictCachedFiles() const {
+            while (m_cacheSize > m_cacheCapacity) {
+                assert(!m_cache.empty());
+                const auto& [entry, file] = m_cache.back();
+                m_cacheSize -= file->size();
+                m_cacheIndex.erase(entry);
+                m_cache.pop_back();
+            }
+        }
+
+        void ImageFileSystemBase::clearCache() {
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            m_cache.clear();
+            m_cacheIndex.clear();
+            m_cacheSize = 0u;
         }
 
         ImageFileSystem::ImageFileSystem(std::shared_ptr<FileSystem> next, const Path& path) :
         ImageFileSystemBase(std::move(next), path),
-        m_file(std::make_shared<CFile>(path)) {
+        m_file(std::make_shared<MappedFile>(path)) {
             ensure(m_path.isAbsolute(), "path must be absolute");
         }
     }
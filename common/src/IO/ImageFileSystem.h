@@ -24,13 +24,18 @@
 
 #include <kdl/string_compare.h>
 
+#include <list>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
-        class CFile;
         class File;
+        class MappedFile;
 
         class ImageFileSystemBase : public FileSystem {
         protected:
@@ -39,8 +44,15 @@ namespace TrenchBroom {
                 virtual ~FileEntry();
 
                 std::shared_ptr<File> open() const;
+
+                /**
+                 * Indicates whether opening this entry creates a new copy of its contents. The opened files of such
+                 * entries are cached by the file system.
+                 */
+                bool compressed() const;
             private:
                 virtual std::shared_ptr<File> doOpen() const = 0;
+                virtual bool doIsCompressed() const;
             };
 
             class SimpleFileEntry : public FileEntry {
@@ -61,9 +73,24 @@ namespace TrenchBroom {
                 ~CompressedFileEntry() override = default;
             private:
                 std::shared_ptr<File> doOpen() const override;
+                bool doIsCompressed() const override;
                 virtual std::unique_ptr<char[]> decompress(std::shared_ptr<File> file, size_t uncompressedSize) const = 0;
             };
 
+            /**
+             * Maps the lowercase paths of all files to their entries.
+             */
+            using FileIndex = std::unordered_map<std::string, const FileEntry*>;
+
+            /**
+             * Maps the lowercase paths of all directories to their contents.
+             */
+            using DirectoryIndex = std::unordered_map<std::string, std::vector<Path>>;
+
+            /**
+             * The directory tree that subclasses populate when reading their directory. Once it is read, all
+             * lookups go through the flat file and directory indices which are built from the tree.
+             */
             class Directory {
             private:
                 using DirMap  = std::map<Path, std::unique_ptr<Directory>, Path::Less<kdl::ci::string_less>>;
@@ -78,18 +105,38 @@ namespace TrenchBroom {
                 void addFile(const Path& path, std::shared_ptr<File> file);
                 void addFile(const Path& path, std::unique_ptr<FileEntry> file);
 
-                bool directoryExists(const Path& path) const;
-                bool fileExists(const Path& path) const;
-
-                const Directory& findDirectory(const Path& path) const;
-                const FileEntry& findFile(const Path& path) const;
                 std::vector<Path> contents() const;
+
+                /**
+                 * Adds the files and directories of this directory and of its subdirectories to the given indices.
+                 */
+                void collectIndex(FileIndex& fileIndex, DirectoryIndex& directoryIndex) const;
             private:
                 Directory& findOrCreateDirectory(const Path& path);
             };
+        public:
+            /**
+             * The default maximum total size of the decompressed files that are cached, in bytes.
+             */
+            static constexpr size_t DefaultCacheCapacity = 64u * 1024u * 1024u;
         protected:
             Path m_path;
             Directory m_root;
+        private:
+            FileIndex m_fileIndex;
+            DirectoryIndex m_directoryIndex;
+
+            using CacheList = std::list<std::pair<const FileEntry*, std::shared_ptr<File>>>;
+
+            /**
+             * The decompressed files that were opened recently, the most recently used one first. Files are
+             * evicted once their total size exceeds the cache capacity.
+             */
+            size_t m_cacheCapacity;
+            mutable std::mutex m_cacheMutex;
+            mutable CacheList m_cache;
+            mutable std::unordered_map<const FileEntry*, CacheList::iterator> m_cacheIndex;
+            mutable size_t m_cacheSize;
         protected:
             ImageFileSystemBase(std::shared_ptr<FileSystem> next, const Path& path);
         public:
@@ -101,19 +148,30 @@ namespace TrenchBroom {
              * Reload this file system.
              */
             void reload();
+
+            /**
+             * Sets the maximum total size of the decompressed files that are cached, in bytes. Files which are
+             * larger than the capacity are not cached at all.
+             */
+            void setCacheCapacity(size_t cacheCapacity);
         private:
+            void buildIndex();
+
             bool doDirectoryExists(const Path& path) const override;
             bool doFileExists(const Path& path) const override;
 
             std::vector<Path> doGetDirectoryContents(const Path& path) const override;
             std::shared_ptr<File> doOpenFile(const Path& path) const override;
+            std::shared_ptr<File> openCompressedFile(const FileEntry& entry) const;
+            void evictCachedFiles() const;
+            void clearCache();
         private:
             virtual void doReadDirectory() = 0;
         };
 
         class ImageFileSystem : public ImageFileSystemBase {
         protected:
-            std::shared_ptr<CFile> m_file;
+            std::shared_ptr<MappedFile> m_file;
         protected:
             ImageFileSystem(std::shared_ptr<FileSystem> next, const Path& path);
         };
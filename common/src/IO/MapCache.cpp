@@ -0,0 +1,362 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MapCache.h"
+
+#include "Color.h"
+#include "FloatType.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
+#include "Model/BrushError.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceAttributes.h"
+#include "Model/EntityProperties.h"
+#include "Model/MapFormat.h"
+
+#include <kdl/overload.h>
+#include <kdl/result.h>
+
+#include <vecmath/vec.h>
+
+#include <type_traits>
+#include <variant>
+
+namespace TrenchBroom {
+    namespace IO {
+        namespace MapCache {
+            namespace {
+                constexpr auto Magic = std::string_view{"TBMC"};
+                constexpr auto Version = uint32_t(1);
+
+                enum class ObjectType : uint8_t {
+                    Entity,
+                    Brush,
+                    Patch
+                };
+
+                /**
+                 * Appends values in native byte order. The cache is only ever read by the machine that wrote it, and
+                 * data from a different platform fails the validation of the header anyway.
+                 */
+                class CacheWriter {
+                private:
+                    std::string m_data;
+                public:
+                    template <typename T>
+                    void write(const T value) {
+                        static_assert(std::is_arithmetic_v<T>, "T must be an arithmetic type");
+                        m_data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+                    }
+
+                    void writeString(const std::string_view str) {
+                        write(uint64_t(str.size()));
+                        m_data.append(str);
+                    }
+
+                    template <typename T, size_t S>
+                    void writeVec(const vm::vec<T,S>& vec) {
+                        for (size_t i = 0; i < S; ++i) {
+                            write(vec[i]);
+                        }
+                    }
+
+                    template <typename T>
+                    void writeOptional(const std::optional<T>& value) {
+                        write(uint8_t(value ? 1 : 0));
+                        if (value) {
+                            write(*value);
+                        }
+                    }
+
+                    void writeOptionalSize(const std::optional<size_t>& value) {
+                        write(uint8_t(value ? 1 : 0));
+                        if (value) {
+                            write(uint64_t(*value));
+                        }
+                    }
+
+                    std::string take() {
+                        return std::move(m_data);
+                    }
+                };
+
+                void writeHeader(CacheWriter& writer, const std::string_view source, const Model::MapFormat sourceMapFormat, const Model::MapFormat targetMapFormat) {
+                    writer.writeString(Magic);
+                    writer.write(Version);
+                    writer.write(uint32_t(sizeof(size_t)));
+                    writer.write(uint64_t(source.size()));
+                    writer.write(hashSource(source));
+                    writer.write(int32_t(sourceMapFormat));
+                    writer.write(int32_t(targetMapFormat));
+                }
+
+                void writeAttributes(CacheWriter& writer, const Model::BrushFaceAttributes& attribs) {
+                    writer.writeString(attribs.textureName());
+                    writer.writeVec(attribs.offset());
+                    writer.writeVec(attribs.scale());
+                    writer.write(attribs.rotation());
+                    writer.writeOptional(attribs.surfaceContents());
+                    writer.writeOptional(attribs.surfaceFlags());
+                    writer.writeOptional(attribs.surfaceValue());
+                    writer.write(uint8_t(attribs.hasColor() ? 1 : 0));
+                    if (attribs.hasColor()) {
+                        writer.writeVec(static_cast<const vm::vec<float,4>&>(*attribs.color()));
+                    }
+                }
+
+                void writeFace(CacheWriter& writer, const Model::BrushFace& face, const Model::MapFormat targetMapFormat) {
+                    writer.write(uint64_t(face.lineNumber()));
+                    for (const auto& point : face.points()) {
+                        writer.writeVec(point);
+                    }
+                    writeAttributes(writer, face.attributes());
+                    if (Model::isParallelTexCoordSystem(targetMapFormat)) {
+                        writer.writeVec(face.textureXAxis());
+                        writer.writeVec(face.textureYAxis());
+                    }
+                }
+
+                std::string readString(Reader& reader) {
+                    const auto size = reader.readSize<uint64_t>();
+                    if (!reader.canRead(size)) {
+                        throw ReaderException("String size exceeds cache data");
+                    }
+                    return reader.readString(size);
+                }
+
+                template <typename T>
+                std::optional<T> readOptional(Reader& reader) {
+                    if (reader.readUnsignedChar<uint8_t>() == 0) {
+                        return std::nullopt;
+                    }
+                    return reader.read<T, T>();
+                }
+
+                std::optional<size_t> readOptionalSize(Reader& reader) {
+                    if (reader.readUnsignedChar<uint8_t>() == 0) {
+                        return std::nullopt;
+                    }
+                    return reader.readSize<uint64_t>();
+                }
+
+                bool readHeader(Reader& reader, const std::string_view source, const Model::MapFormat sourceMapFormat, const Model::MapFormat targetMapFormat) {
+                    return readString(reader) == Magic
+                        && reader.read<uint32_t, uint32_t>() == Version
+                        && reader.read<uint32_t, uint32_t>() == uint32_t(sizeof(size_t))
+                        && reader.read<uint64_t, uint64_t>() == uint64_t(source.size())
+                        && reader.read<uint64_t, uint64_t>() == hashSource(source)
+                        && reader.read<int32_t, int32_t>() == int32_t(sourceMapFormat)
+                        && reader.read<int32_t, int32_t>() == int32_t(targetMapFormat);
+                }
+
+                Model::BrushFaceAttributes readAttributes(Reader& reader) {
+                    auto attribs = Model::BrushFaceAttributes{readString(reader)};
+                    attribs.setOffset(reader.readVec<float, 2>());
+                    attribs.setScale(reader.readVec<float, 2>());
+                    attribs.setRotation(reader.readFloat<float>());
+                    attribs.setSurfaceContents(readOptional<int32_t>(reader));
+                    attribs.setSurfaceFlags(readOptional<int32_t>(reader));
+                    attribs.setSurfaceValue(readOptional<float>(reader));
+                    if (reader.readUnsignedChar<uint8_t>() != 0) {
+                        attribs.setColor(Color{reader.readVec<float, 4>()});
+                    }
+                    return attribs;
+                }
+
+                std::optional<Model::BrushFace> readFace(Reader& reader, const Model::MapFormat targetMapFormat) {
+                    const auto line = reader.readSize<uint64_t>();
+                    const auto point1 = reader.readVec<FloatType, 3>();
+                    const auto point2 = reader.readVec<FloatType, 3>();
+                    const auto point3 = reader.readVec<FloatType, 3>();
+                    const auto attribs = readAttributes(reader);
+
+                    // the faces were created in the target format already, so their texture coordinate systems are
+                    // passed through unchanged
+                    auto result = [&]() {
+                        if (Model::isParallelTexCoordSystem(targetMapFormat)) {
+                            const auto texAxisX = reader.readVec<FloatType, 3>();
+                            const auto texAxisY = reader.readVec<FloatType, 3>();
+                            return Model::BrushFace::createFromValve(point1, point2, point3, attribs, texAxisX, texAxisY, targetMapFormat);
+                        } else {
+                            return Model::BrushFace::createFromStandard(point1, point2, point3, attribs, targetMapFormat);
+                        }
+                    }();
+
+                    return std::move(result).visit(kdl::overload(
+                        [&](Model::BrushFace&& face) -> std::optional<Model::BrushFace> {
+                            face.setFilePosition(line, 1u);
+                            return std::move(face);
+                        },
+                        [](const Model::BrushError) -> std::optional<Model::BrushFace> {
+                            return std::nullopt;
+                        }
+                    ));
+                }
+            }
+
+            Path cachePath(const Path& mapPath) {
+                return mapPath.addExtension("tbcache");
+            }
+
+            uint64_t hashSource(const std::string_view str) {
+                // 64 bit FNV-1a
+                auto hash = uint64_t(14695981039346656037u);
+                for (const auto c : str) {
+                    hash ^= uint64_t(static_cast<unsigned char>(c));
+                    hash *= uint64_t(1099511628211u);
+                }
+                return hash;
+            }
+
+            std::string write(const std::string_view source, const Model::MapFormat sourceMapFormat, const Model::MapFormat targetMapFormat, const std::vector<MapReader::ObjectInfo>& objectInfos) {
+                auto writer = CacheWriter{};
+                writeHeader(writer, source, sourceMapFormat, targetMapFormat);
+
+                writer.write(uint64_t(objectInfos.size()));
+                for (const auto& objectInfo : objectInfos) {
+                    std::visit(kdl::overload(
+                        [&](const MapReader::EntityInfo& entityInfo) {
+                            writer.write(uint8_t(ObjectType::Entity));
+                            writer.write(uint64_t(entityInfo.startLine));
+                            writer.write(uint64_t(entityInfo.lineCount));
+                            writer.write(uint64_t(entityInfo.properties.size()));
+                            for (const auto& property : entityInfo.properties) {
+                                writer.writeString(property.key());
+                                writer.writeString(property.value());
+                            }
+                        },
+                        [&](const MapReader::BrushInfo& brushInfo) {
+                            writer.write(uint8_t(ObjectType::Brush));
+                            writer.write(uint64_t(brushInfo.startLine));
+                            writer.write(uint64_t(brushInfo.lineCount));
+                            writer.writeOptionalSize(brushInfo.parentIndex);
+                            writer.write(uint64_t(brushInfo.faces.size()));
+                            for (const auto& face : brushInfo.faces) {
+                                writeFace(writer, face, targetMapFormat);
+                            }
+                        },
+                        [&](const MapReader::PatchInfo& patchInfo) {
+                            writer.write(uint8_t(ObjectType::Patch));
+                            writer.write(uint64_t(patchInfo.startLine));
+                            writer.write(uint64_t(patchInfo.lineCount));
+                            writer.writeOptionalSize(patchInfo.parentIndex);
+                            writer.write(uint64_t(patchInfo.rowCount));
+                            writer.write(uint64_t(patchInfo.columnCount));
+                            for (const auto& controlPoint : patchInfo.controlPoints) {
+                                writer.writeVec(controlPoint);
+                            }
+                            writer.writeString(patchInfo.textureName);
+                        }
+                    ), objectInfo);
+                }
+
+                return writer.take();
+            }
+
+            std::optional<std::vector<MapReader::ObjectInfo>> read(const std::string_view cacheData, const std::string_view source, const Model::MapFormat sourceMapFormat, const Model::MapFormat targetMapFormat) {
+                try {
+                    auto reader = Reader::from(cacheData.data(), cacheData.data() + cacheData.size());
+                    if (!readHeader(reader, source, sourceMapFormat, targetMapFormat)) {
+                        return std::nullopt;
+                    }
+
+                    const auto objectCount = reader.readSize<uint64_t>();
+                    auto objectInfos = std::vector<MapReader::ObjectInfo>{};
+
+                    // parent indices must refer to an entity that was read before
+                    const auto isValidParent = [&](const std::optional<size_t>& parentIndex) {
+                        return !parentIndex || (*parentIndex < objectInfos.size() && std::holds_alternative<MapReader::EntityInfo>(objectInfos[*parentIndex]));
+                    };
+
+                    for (size_t i = 0; i < objectCount; ++i) {
+                        const auto type = static_cast<ObjectType>(reader.readUnsignedChar<uint8_t>());
+                        const auto startLine = reader.readSize<uint64_t>();
+                        const auto lineCount = reader.readSize<uint64_t>();
+
+                        switch (type) {
+                            case ObjectType::Entity: {
+                                const auto propertyCount = reader.readSize<uint64_t>();
+                                auto properties = std::vector<Model::EntityProperty>{};
+                                for (size_t j = 0; j < propertyCount; ++j) {
+                                    auto key = readString(reader);
+                                    auto value = readString(reader);
+                                    properties.emplace_back(std::move(key), std::move(value));
+                                }
+                                objectInfos.push_back(MapReader::EntityInfo{std::move(properties), startLine, lineCount});
+                                break;
+                            }
+                            case ObjectType::Brush: {
+                                const auto parentIndex = readOptionalSize(reader);
+                                if (!isValidParent(parentIndex)) {
+                                    return std::nullopt;
+                                }
+
+                                const auto faceCount = reader.readSize<uint64_t>();
+                                auto faces = std::vector<Model::BrushFace>{};
+                                for (size_t j = 0; j < faceCount; ++j) {
+                                    auto face = readFace(reader, targetMapFormat);
+                                    if (!face) {
+                                        return std::nullopt;
+                                    }
+                                    faces.push_back(std::move(*face));
+                                }
+                                objectInfos.push_back(MapReader::BrushInfo{std::move(faces), startLine, lineCount, parentIndex});
+                                break;
+                            }
+                            case ObjectType::Patch: {
+                                const auto parentIndex = readOptionalSize(reader);
+                                if (!isValidParent(parentIndex)) {
+                                    return std::nullopt;
+                                }
+
+                                const auto rowCount = reader.readSize<uint64_t>();
+                                const auto columnCount = reader.readSize<uint64_t>();
+                                // check the division first so that the multiplication below cannot overflow
+                                const auto remaining = reader.size() - reader.position();
+                                if (columnCount != 0 && rowCount > remaining / columnCount / sizeof(Model::BezierPatch::Point)) {
+                                    return std::nullopt;
+                                }
+
+                                auto controlPoints = std::vector<Model::BezierPatch::Point>{};
+                                controlPoints.reserve(rowCount * columnCount);
+                                for (size_t j = 0; j < rowCount * columnCount; ++j) {
+                                    controlPoints.push_back(reader.readVec<FloatType, 5>());
+                                }
+                                auto textureName = readString(reader);
+                                objectInfos.push_back(MapReader::PatchInfo{rowCount, columnCount, std::move(controlPoints), std::move(textureName), startLine, lineCount, parentIndex});
+                                break;
+                            }
+                            default:
+                                return std::nullopt;
+                        }
+                    }
+
+                    if (!reader.eof()) {
+                        return std::nullopt;
+                    }
+                    return objectInfos;
+                } catch (const ReaderException&) {
+                    return std::nullopt;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "IO/MapReader.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        enum class MapFormat;
+    }
+
+    namespace IO {
+        class Path;
+
+        /**
+         * Stores the data that MapReader collects while parsing a map in a compact binary form, so that an unchanged
+         * map can be reopened without tokenizing and parsing it again.
+         *
+         * The cache data contains a hash of the source string and the map formats it was parsed with. Cache data
+         * that doesn't match is ignored. Parser warnings are not stored, so they are only reported when the source
+         * is actually parsed.
+         */
+        namespace MapCache {
+            /**
+             * Returns the path of the cache file for the map file at the given path.
+             */
+            Path cachePath(const Path& mapPath);
+
+            /**
+             * Returns a hash of the given source string which is stable across runs and platforms.
+             */
+            uint64_t hashSource(std::string_view str);
+
+            /**
+             * Serializes the given object infos which were parsed from the given source string.
+             */
+            std::string write(std::string_view source, Model::MapFormat sourceMapFormat, Model::MapFormat targetMapFormat, const std::vector<MapReader::ObjectInfo>& objectInfos);
+
+            /**
+             * Restores the object infos from the given cache data. Returns an empty optional if the cache data is
+             * malformed or if it was not created for the given source string and map formats.
+             */
+            std::optional<std::vector<MapReader::ObjectInfo>> read(std::string_view cacheData, std::string_view source, Model::MapFormat sourceMapFormat, Model::MapFormat targetMapFormat);
+        }
+    }
+}
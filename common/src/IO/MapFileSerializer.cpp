@@ -39,9 +39,11 @@
 
 #include <fmt/format.h>
 
-#include <iterator> // for std::ostreambuf_iterator
+#include <algorithm>
+#include <iterator> // for std::back_inserter, std::ostreambuf_iterator
 #include <memory>
-#include <sstream>
+#include <ostream>
+#include <string>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -53,16 +55,16 @@ namespace TrenchBroom {
             explicit QuakeFileSerializer(std::ostream& stream) :
             MapFileSerializer(stream) {}
         private:
-            void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const override {
-                writeFacePoints(stream, face);
-                writeTextureInfo(stream, face);
-                fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+            void doWriteBrushFace(std::string& str, const Model::BrushFace& face) const override {
+                writeFacePoints(str, face);
+                writeTextureInfo(str, face);
+                fmt::format_to(std::back_inserter(str), "\n");
             }
         protected:
-            void writeFacePoints(std::ostream& stream, const Model::BrushFace& face) const {
+            void writeFacePoints(std::string& str, const Model::BrushFace& face) const {
                 const Model::BrushFace::Points& points = face.points();
 
-                fmt::format_to(std::ostreambuf_iterator<char>(stream), "( {} {} {} ) ( {} {} {} ) ( {} {} {} )",
+                fmt::format_to(std::back_inserter(str), "( {} {} {} ) ( {} {} {} ) ( {} {} {} )",
                                points[0].x(),
                                points[0].y(),
                                points[0].z(),
@@ -82,10 +84,10 @@ namespace TrenchBroom {
                 return "\"" + kdl::str_escape(textureName, "\"") + "\"";
             }
 
-            void writeTextureInfo(std::ostream& stream, const Model::BrushFace& face) const {
+            void writeTextureInfo(std::string& str, const Model::BrushFace& face) const {
                 const std::string& textureName = face.attributes().textureName().empty() ? Model::BrushFaceAttributes::NoTextureName : face.attributes().textureName();
 
-                fmt::format_to(std::ostreambuf_iterator<char>(stream), " {} {} {} {} {} {}",
+                fmt::format_to(std::back_inserter(str), " {} {} {} {} {} {}",
                                shouldQuoteTextureName(textureName) ? quoteTextureName(textureName) : textureName,
                                face.attributes().xOffset(),
                                face.attributes().yOffset(),
@@ -94,12 +96,12 @@ namespace TrenchBroom {
                                face.attributes().yScale());
             }
 
-            void writeValveTextureInfo(std::ostream& stream, const Model::BrushFace& face) const {
+            void writeValveTextureInfo(std::string& str, const Model::BrushFace& face) const {
                 const std::string& textureName = face.attributes().textureName().empty() ? Model::BrushFaceAttributes::NoTextureName : face.attributes().textureName();
                 const vm::vec3 xAxis = face.textureXAxis();
                 const vm::vec3 yAxis = face.textureYAxis();
 
-                fmt::format_to(std::ostreambuf_iterator<char>(stream), " {} [ {} {} {} {} ] [ {} {} {} {} ] {} {} {}",
+                fmt::format_to(std::back_inserter(str), " {} [ {} {} {} {} ] [ {} {} {} {} ] {} {} {}",
                                textureName,
 
                                xAxis.x(),
@@ -123,19 +125,19 @@ namespace TrenchBroom {
             explicit Quake2FileSerializer(std::ostream& stream) :
             QuakeFileSerializer(stream) {}
         private:
-            void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const override {
-                writeFacePoints(stream, face);
-                writeTextureInfo(stream, face);
+            void doWriteBrushFace(std::string& str, const Model::BrushFace& face) const override {
+                writeFacePoints(str, face);
+                writeTextureInfo(str, face);
 
                 if (face.attributes().hasSurfaceAttributes()) {
-                    writeSurfaceAttributes(stream, face);
+                    writeSurfaceAttributes(str, face);
                 }
 
-                fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+                fmt::format_to(std::back_inserter(str), "\n");
             }
         protected:
-            void writeSurfaceAttributes(std::ostream& stream, const Model::BrushFace& face) const {
-                fmt::format_to(std::ostreambuf_iterator<char>(stream), " {} {} {}",
+            void writeSurfaceAttributes(std::string& str, const Model::BrushFace& face) const {
+                fmt::format_to(std::back_inserter(str), " {} {} {}",
                                face.resolvedSurfaceContents(),
                                face.resolvedSurfaceFlags(),
                                face.resolvedSurfaceValue());
@@ -147,15 +149,15 @@ namespace TrenchBroom {
             explicit Quake2ValveFileSerializer(std::ostream& stream) :
             Quake2FileSerializer(stream) {}
         private:
-            void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const override {
-                writeFacePoints(stream, face);
-                writeValveTextureInfo(stream, face);
+            void doWriteBrushFace(std::string& str, const Model::BrushFace& face) const override {
+                writeFacePoints(str, face);
+                writeValveTextureInfo(str, face);
 
                 if (face.attributes().hasSurfaceAttributes()) {
-                    writeSurfaceAttributes(stream, face);
+                    writeSurfaceAttributes(str, face);
                 }
 
-                fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+                fmt::format_to(std::back_inserter(str), "\n");
             }
         };
 
@@ -167,22 +169,22 @@ namespace TrenchBroom {
             Quake2FileSerializer(stream),
             SurfaceColorFormat(" %d %d %d") {}
         private:
-            void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const override {
-                writeFacePoints(stream, face);
-                writeTextureInfo(stream, face);
+            void doWriteBrushFace(std::string& str, const Model::BrushFace& face) const override {
+                writeFacePoints(str, face);
+                writeTextureInfo(str, face);
 
                 if (face.attributes().hasSurfaceAttributes() || face.attributes().hasColor()) {
-                    writeSurfaceAttributes(stream, face);
+                    writeSurfaceAttributes(str, face);
                 }
                 if (face.attributes().hasColor()) {
-                    writeSurfaceColor(stream, face);
+                    writeSurfaceColor(str, face);
                 }
 
-                fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+                fmt::format_to(std::back_inserter(str), "\n");
             }
         protected:
-            void writeSurfaceColor(std::ostream& stream, const Model::BrushFace& face) const {
-                fmt::format_to(std::ostreambuf_iterator<char>(stream), " {} {} {}",
+            void writeSurfaceColor(std::string& str, const Model::BrushFace& face) const {
+                fmt::format_to(std::back_inserter(str), " {} {} {}",
                                static_cast<int>(face.resolvedColor().r()),
                                static_cast<int>(face.resolvedColor().g()),
                                static_cast<int>(face.resolvedColor().b()));
@@ -194,10 +196,10 @@ namespace TrenchBroom {
             explicit Hexen2FileSerializer(std::ostream& stream):
             QuakeFileSerializer(stream) {}
         private:
-            void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const override {
-                writeFacePoints(stream, face);
-                writeTextureInfo(stream, face);
-                fmt::format_to(std::ostreambuf_iterator<char>(stream), " 0\n"); // extra value written here
+            void doWriteBrushFace(std::string& str, const Model::BrushFace& face) const override {
+                writeFacePoints(str, face);
+                writeTextureInfo(str, face);
+                fmt::format_to(std::back_inserter(str), " 0\n"); // extra value written here
             }
         };
 
@@ -206,14 +208,14 @@ namespace TrenchBroom {
             explicit ValveFileSerializer(std::ostream& stream) :
             QuakeFileSerializer(stream) {}
         private:
-            void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const override {
-                writeFacePoints(stream, face);
-                writeValveTextureInfo(stream, face);
-                fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+            void doWriteBrushFace(std::string& str, const Model::BrushFace& face) const override {
+                writeFacePoints(str, face);
+                writeValveTextureInfo(str, face);
+                fmt::format_to(std::back_inserter(str), "\n");
             }
         };
 
-        std::unique_ptr<NodeSerializer> MapFileSerializer::create(const Model::MapFormat format, std::ostream& stream) {
+        static std::unique_ptr<MapFileSerializer> createMapFileSerializer(const Model::MapFormat format, std::ostream& stream) {
             switch (format) {
                 case Model::MapFormat::Standard:
                     return std::make_unique<QuakeFileSerializer>(stream);
@@ -237,50 +239,69 @@ namespace TrenchBroom {
             }
         }
 
+        std::unique_ptr<NodeSerializer> MapFileSerializer::create(const Model::MapFormat format, std::ostream& stream, NodeSerializationCache* cache) {
+            auto serializer = createMapFileSerializer(format, stream);
+            if (cache != nullptr) {
+                cache->setFormat(format);
+                serializer->m_cache = cache;
+            }
+            return serializer;
+        }
+
         MapFileSerializer::MapFileSerializer(std::ostream& stream) :
         m_line(1),
-        m_stream(stream) {}
-
-        void MapFileSerializer::doBeginFile(const std::vector<const Model::Node*>& rootNodes) {
-            ensure(m_nodeToPrecomputedString.empty(), "MapFileSerializer may not be reused");
-
-            // collect nodes
-            std::vector<std::variant<const Model::BrushNode*, const Model::PatchNode*>> nodesToSerialize;
-            nodesToSerialize.reserve(rootNodes.size());
-
-            Model::Node::visitAll(rootNodes, kdl::overload(
-                [](auto&& thisLambda, const Model::WorldNode* world) { world->visitChildren(thisLambda); },
-                [](auto&& thisLambda, const Model::LayerNode* layer) { layer->visitChildren(thisLambda); },
-                [](auto&& thisLambda, const Model::GroupNode* group) { group->visitChildren(thisLambda); },
-                [](auto&& thisLambda, const Model::EntityNode* entity) { entity->visitChildren(thisLambda); },
-                [&](const Model::BrushNode* brush) {
-                    nodesToSerialize.push_back(brush);
-                },
-                [&](const Model::PatchNode* patchNode) {
-                    nodesToSerialize.push_back(patchNode);
+        m_stream(stream),
+        m_nextBatchStart(0),
+        m_cache(nullptr) {}
+
+        namespace {
+            /**
+             * Collects the brush and patch nodes in the order in which NodeWriter writes them, that is, the brushes
+             * and patches of a container are written before the groups and entities nested in it.
+             */
+            template <typename N>
+            void collectNodesToSerialize(const std::vector<N*>& nodes, const bool exporting, std::vector<std::variant<const Model::BrushNode*, const Model::PatchNode*>>& result) {
+                for (const auto* node : nodes) {
+                    node->accept(kdl::overload(
+                        [] (const Model::WorldNode*)  {},
+                        [] (const Model::LayerNode*)  {},
+                        [] (const Model::GroupNode*)  {},
+                        [] (const Model::EntityNode*) {},
+                        [&](const Model::BrushNode* brushNode) { result.push_back(brushNode); },
+                        [&](const Model::PatchNode* patchNode) { result.push_back(patchNode); }
+                    ));
                 }
-            ));
 
-            // serialize brushes to strings in parallel
-            using Entry = std::pair<const Model::Node*, PrecomputedString>;
-            std::vector<Entry> result = kdl::vec_parallel_transform(std::move(nodesToSerialize),
-                [&](const auto& node) {
-                    return std::visit(kdl::overload(
-                        [&](const Model::BrushNode* brushNode) {
-                            return Entry{brushNode, writeBrushFaces(brushNode->brush())};
+                for (const auto* node : nodes) {
+                    node->accept(kdl::overload(
+                        [&](const Model::WorldNode* worldNode) {
+                            collectNodesToSerialize(worldNode->children(), exporting, result);
                         },
-                        [&](const Model::PatchNode* patchNode) {
-                            return Entry{patchNode, writePatch(patchNode->patch())};
-                        }
-                    ), node);
-                });
-            
-            // move strings into a map
-            for (auto& entry: result) {
-                m_nodeToPrecomputedString.insert(std::move(entry));
+                        [&](const Model::LayerNode* layerNode) {
+                            if (!(exporting && layerNode->layer().omitFromExport())) {
+                                collectNodesToSerialize(layerNode->children(), exporting, result);
+                            }
+                        },
+                        [&](const Model::GroupNode* groupNode) {
+                            collectNodesToSerialize(groupNode->children(), exporting, result);
+                        },
+                        [&](const Model::EntityNode* entityNode) {
+                            collectNodesToSerialize(entityNode->children(), exporting, result);
+                        },
+                        [] (const Model::BrushNode*) {},
+                        [] (const Model::PatchNode*) {}
+                    ));
+                }
             }
         }
 
+        void MapFileSerializer::doBeginFile(const std::vector<const Model::Node*>& rootNodes) {
+            ensure(m_nodesToSerialize.empty(), "MapFileSerializer may not be reused");
+
+            // the nodes are only collected here, they are serialized in batches as they are written
+            collectNodesToSerialize(rootNodes, exporting(), m_nodesToSerialize);
+        }
+
         void MapFileSerializer::doEndFile() {}
 
         void MapFileSerializer::doBeginEntity(const Model::Node* /* node */) {
@@ -312,10 +333,8 @@ namespace TrenchBroom {
             ++m_line;
 
             // write pre-serialized brush faces
-            auto it = m_nodeToPrecomputedString.find(brush);
-            ensure(it != std::end(m_nodeToPrecomputedString), "attempted to serialize a brush which was not passed to doBeginFile");
-            const PrecomputedString& precomputedString = it->second;
-            m_stream << precomputedString.string;
+            const auto precomputedString = takePrecomputedString(brush);
+            m_stream.write(precomputedString.string.data(), static_cast<std::streamsize>(precomputedString.string.size()));
             m_line += precomputedString.lineCount;
 
             fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "}}\n");
@@ -325,7 +344,9 @@ namespace TrenchBroom {
 
         void MapFileSerializer::doBrushFace(const Model::BrushFace& face) {
             const size_t lines = 1u;
-            doWriteBrushFace(m_stream, face);
+            auto str = std::string{};
+            doWriteBrushFace(str, face);
+            m_stream.write(str.data(), static_cast<std::streamsize>(str.size()));
             face.setFilePosition(m_line, lines);
             m_line += lines;
         }
@@ -336,10 +357,8 @@ namespace TrenchBroom {
             m_startLineStack.push_back(m_line);
 
             // write pre-serialized patch
-            auto it = m_nodeToPrecomputedString.find(patchNode);
-            ensure(it != std::end(m_nodeToPrecomputedString), "attempted to serialize a patch which was not passed to doBeginFile");
-            const PrecomputedString& precomputedString = it->second;
-            m_stream << precomputedString.string;
+            const auto precomputedString = takePrecomputedString(patchNode);
+            m_stream.write(precomputedString.string.data(), static_cast<std::streamsize>(precomputedString.string.size()));
             m_line += precomputedString.lineCount;
 
             setFilePosition(patchNode);
@@ -350,6 +369,65 @@ namespace TrenchBroom {
             node->setFilePosition(start, m_line - start);
         }
 
+        /**
+         * Returns the pre-serialized string of the given node and discards it. If the node is not part of the current
+         * batch, the following batches are serialized until it is found. When a whole map is written, the nodes are
+         * requested in the order in which they were collected, so only one batch is kept in memory at a time.
+         */
+        MapFileSerializer::PrecomputedString MapFileSerializer::takePrecomputedString(const Model::Node* node) {
+            auto it = m_nodeToPrecomputedString.find(node);
+            while (it == std::end(m_nodeToPrecomputedString) && m_nextBatchStart < m_nodesToSerialize.size()) {
+                serializeNextBatch();
+                it = m_nodeToPrecomputedString.find(node);
+            }
+            ensure(it != std::end(m_nodeToPrecomputedString), "attempted to serialize a node which was not passed to doBeginFile");
+
+            auto result = std::move(it->second);
+            m_nodeToPrecomputedString.erase(it);
+            return result;
+        }
+
+        void MapFileSerializer::serializeNextBatch() {
+            const auto batchBegin = std::next(std::begin(m_nodesToSerialize), static_cast<std::ptrdiff_t>(m_nextBatchStart));
+            const auto batchSize = std::min(BatchSize, m_nodesToSerialize.size() - m_nextBatchStart);
+            auto batch = std::vector<NodeToSerialize>(batchBegin, std::next(batchBegin, static_cast<std::ptrdiff_t>(batchSize)));
+            m_nextBatchStart += batchSize;
+
+            if (m_cache != nullptr) {
+                // take the nodes that are cached, only the remaining ones must be serialized
+                batch = kdl::vec_filter(std::move(batch), [&](const auto& node) {
+                    const auto* modelNode = std::visit([](const auto* n) -> const Model::Node* { return n; }, node);
+                    if (const auto* serializedNode = m_cache->find(modelNode)) {
+                        m_nodeToPrecomputedString.emplace(modelNode, *serializedNode);
+                        return false;
+                    }
+                    return true;
+                });
+            }
+
+            // serialize brushes to strings in parallel
+            using Entry = std::pair<const Model::Node*, PrecomputedString>;
+            std::vector<Entry> result = kdl::vec_parallel_transform(std::move(batch),
+                [&](const auto& node) {
+                    return std::visit(kdl::overload(
+                        [&](const Model::BrushNode* brushNode) {
+                            return Entry{brushNode, writeBrushFaces(brushNode->brush())};
+                        },
+                        [&](const Model::PatchNode* patchNode) {
+                            return Entry{patchNode, writePatch(patchNode->patch())};
+                        }
+                    ), node);
+                });
+
+            // move strings into a map
+            for (auto& entry: result) {
+                if (m_cache != nullptr) {
+                    m_cache->insert(entry.first, entry.second);
+                }
+                m_nodeToPrecomputedString.insert(std::move(entry));
+            }
+        }
+
         size_t MapFileSerializer::startLine() {
             assert(!m_startLineStack.empty());
             const size_t result = m_startLineStack.back();
@@ -361,38 +439,38 @@ namespace TrenchBroom {
          * Threadsafe
          */
         MapFileSerializer::PrecomputedString MapFileSerializer::writeBrushFaces(const Model::Brush& brush) const {
-            std::stringstream stream;
+            std::string str;
             for (const Model::BrushFace& face : brush.faces()) {
-                doWriteBrushFace(stream, face);
+                doWriteBrushFace(str, face);
             }
-            return PrecomputedString{stream.str(), brush.faces().size()};
+            return PrecomputedString{std::move(str), brush.faces().size()};
         }
 
         MapFileSerializer::PrecomputedString MapFileSerializer::writePatch(const Model::BezierPatch& patch) const {
             size_t lineCount = 0u;
-            std::stringstream stream;
+            std::string str;
             
-            fmt::format_to(std::ostreambuf_iterator<char>(stream), "{{\n"); ++lineCount;
-            fmt::format_to(std::ostreambuf_iterator<char>(stream), "patchDef2\n"); ++lineCount;
-            fmt::format_to(std::ostreambuf_iterator<char>(stream), "{{\n"); ++lineCount;
-            fmt::format_to(std::ostreambuf_iterator<char>(stream), "{}\n", patch.textureName()); ++lineCount;
-            fmt::format_to(std::ostreambuf_iterator<char>(stream), "( {} {} 0 0 0 )\n", patch.pointRowCount(), patch.pointColumnCount()); ++lineCount;
-            fmt::format_to(std::ostreambuf_iterator<char>(stream), "(\n"); ++lineCount;
+            fmt::format_to(std::back_inserter(str), "{{\n"); ++lineCount;
+            fmt::format_to(std::back_inserter(str), "patchDef2\n"); ++lineCount;
+            fmt::format_to(std::back_inserter(str), "{{\n"); ++lineCount;
+            fmt::format_to(std::back_inserter(str), "{}\n", patch.textureName()); ++lineCount;
+            fmt::format_to(std::back_inserter(str), "( {} {} 0 0 0 )\n", patch.pointRowCount(), patch.pointColumnCount()); ++lineCount;
+            fmt::format_to(std::back_inserter(str), "(\n"); ++lineCount;
 
             for (size_t row = 0u; row < patch.pointRowCount(); ++row) {
-                fmt::format_to(std::ostreambuf_iterator<char>(stream), "( ");
+                fmt::format_to(std::back_inserter(str), "( ");
                 for (size_t col = 0u; col < patch.pointColumnCount(); ++col) {
                     const auto& p = patch.controlPoint(row, col);
-                    fmt::format_to(std::ostreambuf_iterator<char>(stream), "( {} {} {} {} {} ) ", p[0], p[1], p[2], p[3], p[4]);
+                    fmt::format_to(std::back_inserter(str), "( {} {} {} {} {} ) ", p[0], p[1], p[2], p[3], p[4]);
                 }
-                fmt::format_to(std::ostreambuf_iterator<char>(stream), ")\n"); ++lineCount;
+                fmt::format_to(std::back_inserter(str), ")\n"); ++lineCount;
             }
 
-            fmt::format_to(std::ostreambuf_iterator<char>(stream), ")\n"); ++lineCount;
-            fmt::format_to(std::ostreambuf_iterator<char>(stream), "}}\n"); ++lineCount;
-            fmt::format_to(std::ostreambuf_iterator<char>(stream), "}}\n"); ++lineCount;
+            fmt::format_to(std::back_inserter(str), ")\n"); ++lineCount;
+            fmt::format_to(std::back_inserter(str), "}}\n"); ++lineCount;
+            fmt::format_to(std::back_inserter(str), "}}\n"); ++lineCount;
 
-            return PrecomputedString{stream.str(), lineCount};
+            return PrecomputedString{std::move(str), lineCount};
         }
     }
 }
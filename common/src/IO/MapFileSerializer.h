@@ -19,11 +19,15 @@
 
 #pragma once
 
+#include "IO/NodeSerializationCache.h"
 #include "IO/NodeSerializer.h"
 #include "Model/MapFormat.h"
 
 #include <iosfwd>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <variant>
 #include <vector>
 
 namespace TrenchBroom {
@@ -45,13 +49,22 @@ namespace TrenchBroom {
             size_t m_line;
             std::ostream& m_stream;
 
-            struct PrecomputedString {
-                std::string string;
-                size_t lineCount;
-            };
+            using PrecomputedString = SerializedNode;
+
+            /** The number of nodes that are serialized to strings in parallel before they are written. */
+            static constexpr size_t BatchSize = 4096u;
+
+            using NodeToSerialize = std::variant<const Model::BrushNode*, const Model::PatchNode*>;
+            std::vector<NodeToSerialize> m_nodesToSerialize;
+            size_t m_nextBatchStart;
             std::unordered_map<const Model::Node*, PrecomputedString> m_nodeToPrecomputedString;
+            NodeSerializationCache* m_cache;
         public:
-            static std::unique_ptr<NodeSerializer> create(Model::MapFormat format, std::ostream& stream);
+            /**
+             * Creates a serializer for the given format. If a cache is given, brushes and patches found in the cache are
+             * not serialized again, and the cache is updated with the nodes that had to be serialized.
+             */
+            static std::unique_ptr<NodeSerializer> create(Model::MapFormat format, std::ostream& stream, NodeSerializationCache* cache = nullptr);
         protected:
             explicit MapFileSerializer(std::ostream& stream);
         private:
@@ -68,8 +81,11 @@ namespace TrenchBroom {
         private:
             void setFilePosition(const Model::Node* node);
             size_t startLine();
+
+            PrecomputedString takePrecomputedString(const Model::Node* node);
+            void serializeNextBatch();
         private: // threadsafe
-            virtual void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const = 0;
+            virtual void doWriteBrushFace(std::string& str, const Model::BrushFace& face) const = 0;
             PrecomputedString writeBrushFaces(const Model::Brush& brush) const;
             PrecomputedString writePatch(const Model::BezierPatch& patch) const;
         };
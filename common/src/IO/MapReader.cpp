@@ -19,6 +19,10 @@
 
 #include "MapReader.h"
 
+#include "AllocationCounting.h"
+#include "Logger.h"
+#include "Profiler.h"
+#include "IO/MapCache.h"
 #include "IO/ParserStatus.h"
 #include "Model/BrushError.h"
 #include "Model/BrushFace.h"
@@ -37,6 +41,7 @@
 #include <vecmath/mat.h>
 #include <vecmath/mat_io.h>
 
+#include <kdl/overload.h>
 #include <kdl/parallel.h>
 #include <kdl/result.h>
 #include <kdl/result_for_each.h>
@@ -44,22 +49,198 @@
 #include <kdl/string_utils.h>
 #include <kdl/vector_utils.h>
 
+#include <algorithm>
 #include <cassert>
+#include <exception>
 #include <optional>
 #include <string>
+#include <thread>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom {
     namespace IO {
-        MapReader::MapReader(std::string_view str, const Model::MapFormat sourceMapFormat, const Model::MapFormat targetMapFormat) :
-        StandardMapParser(std::move(str), sourceMapFormat, targetMapFormat) {}
+        MapReader::MapReader(std::string_view str, const Model::MapFormat sourceMapFormat, const Model::MapFormat targetMapFormat, const size_t startLine) :
+        StandardMapParser(str, sourceMapFormat, targetMapFormat, startLine),
+        m_str(str) {}
+
+        /**
+         * Parses a chunk of top level entities on behalf of another reader. The chunk reader only records the
+         * object infos, the nodes are created by the reader that owns the entire source string.
+         */
+        class MapReader::ChunkReader : public MapReader {
+        public:
+            ChunkReader(const EntityChunk& chunk, const Model::MapFormat sourceMapFormat, const Model::MapFormat targetMapFormat) :
+            MapReader(chunk.str, sourceMapFormat, targetMapFormat, chunk.startLine) {}
+
+            std::vector<ObjectInfo> parse(ParserStatus& status) {
+                parseEntities(status);
+                return std::move(m_objectInfos);
+            }
+        private:
+            Model::Node* onWorldNode(std::unique_ptr<Model::WorldNode>, ParserStatus&) override { return nullptr; }
+            void onLayerNode(std::unique_ptr<Model::Node>, ParserStatus&) override {}
+            void onNode(Model::Node*, std::unique_ptr<Model::Node>, ParserStatus&) override {}
+        };
+
+        namespace {
+            /** Sources smaller than this are always parsed serially. */
+            constexpr size_t MinParallelSourceSize = 1024u * 1024u;
+            /** Lower bound for the size of a chunk so that the per chunk overhead stays negligible. */
+            constexpr size_t MinChunkSize = 64u * 1024u;
+
+            std::string_view trimLine(std::string_view line) {
+                const auto first = line.find_first_not_of(" \t\r");
+                if (first == std::string_view::npos) {
+                    return std::string_view{};
+                }
+                const auto last = line.find_last_not_of(" \t\r");
+                return line.substr(first, last - first + 1u);
+            }
+
+            bool isLineComment(const std::string_view line) {
+                // "/// " starts a comment token that is not accepted between entities
+                return (line.substr(0u, 2u) == "//" && line.substr(0u, 4u) != "/// ") || line.front() == ';';
+            }
+
+            /**
+             * Splits the given source into chunks of complete top level entities. This relies on the layout written
+             * by TrenchBroom and most other editors, where every entity and brush brace is on a line of its own.
+             *
+             * Returns an empty vector if the source is too small to benefit from parallel parsing or if its layout
+             * deviates in any way, in which case the source must be parsed serially. This ensures that malformed
+             * input is always reported by the regular parser.
+             */
+            std::vector<MapReader::EntityChunk> findEntityChunks(const std::string_view str) {
+                const auto threadCount = size_t(std::thread::hardware_concurrency());
+                if (str.size() < MinParallelSourceSize || threadCount < 2u) {
+                    return {};
+                }
+
+                // create several chunks per thread to balance the load
+                const auto targetChunkSize = std::max(str.size() / (threadCount * 4u), MinChunkSize);
+
+                auto result = std::vector<MapReader::EntityChunk>{};
+                auto chunkStart = size_t(0);
+                auto chunkStartLine = size_t(1);
+                auto depth = size_t(0);
+                auto line = size_t(1);
+
+                auto pos = size_t(0);
+                while (pos < str.size()) {
+                    const auto lineEnd = std::min(str.find('\n', pos), str.size());
+                    const auto lineStr = trimLine(str.substr(pos, lineEnd - pos));
+
+                    if (!lineStr.empty()) {
+                        if (lineStr.find('\r') != std::string_view::npos) {
+                            // a lone carriage return counts as a line break for the tokenizer
+                            return {};
+                        }
+
+                        const auto first = lineStr.front();
+                        if (first == '{' || first == '}') {
+                            if (lineStr.size() != 1u) {
+                                return {};
+                            }
+                            if (first == '{') {
+                                ++depth;
+                            } else {
+                                if (depth == 0u) {
+                                    return {};
+                                }
+                                if (--depth == 0u && lineEnd - chunkStart >= targetChunkSize) {
+                                    const auto chunkEnd = std::min(lineEnd + 1u, str.size());
+                                    result.push_back({str.substr(chunkStart, chunkEnd - chunkStart), chunkStartLine});
+                                    chunkStart = chunkEnd;
+                                    chunkStartLine = line + 1u;
+                                }
+                            }
+                        } else if (first == '"') {
+                            // entity properties must not span multiple lines
+                            if (depth != 1u || lineStr.size() < 2u || lineStr.back() != '"') {
+                                return {};
+                            }
+                        } else if (depth == 0u && !isLineComment(lineStr)) {
+                            return {};
+                        }
+                    }
+
+                    ++line;
+                    pos = lineEnd + 1u;
+                }
+
+                if (depth != 0u) {
+                    return {};
+                }
+
+                if (chunkStart < str.size()) {
+                    result.push_back({str.substr(chunkStart), chunkStartLine});
+                }
+                return result;
+            }
+
+            Logger& nullLogger() {
+                static auto logger = NullLogger{};
+                return logger;
+            }
+
+            using LogMessage = std::tuple<LogLevel, std::string>;
+
+            /**
+             * Records the messages of a parser running on a worker thread so that they can be replayed in source
+             * order once all chunks have been parsed.
+             */
+            class BufferedParserStatus : public ParserStatus {
+            private:
+                std::vector<LogMessage> m_messages;
+            public:
+                BufferedParserStatus() :
+                ParserStatus(nullLogger(), "") {}
+
+                std::vector<LogMessage> takeMessages() {
+                    return std::move(m_messages);
+                }
+            private:
+                void doProgress(const double /* progress */) override {}
+
+                void doLog(const LogLevel level, const std::string& str) override {
+                    m_messages.emplace_back(level, str);
+                }
+            };
+
+            struct ChunkResult {
+                std::vector<MapReader::ObjectInfo> objectInfos;
+                std::vector<LogMessage> messages;
+                std::exception_ptr exception;
+            };
+        }
 
         void MapReader::readEntities(const vm::bbox3& worldBounds, ParserStatus& status) {
             m_worldBounds = worldBounds;
-            parseEntities(status);
+            parseAllEntities(status);
+            createNodes(status);
+        }
+
+        std::optional<std::string> MapReader::readEntities(const vm::bbox3& worldBounds, const std::string_view cacheData, ParserStatus& status) {
+            m_worldBounds = worldBounds;
+
+            if (auto objectInfos = MapCache::read(cacheData, m_str, m_sourceMapFormat, m_targetMapFormat)) {
+                m_objectInfos = std::move(*objectInfos);
+                createNodes(status);
+                return std::nullopt;
+            }
+
+            parseAllEntities(status);
+            auto newCacheData = MapCache::write(m_str, m_sourceMapFormat, m_targetMapFormat, m_objectInfos);
             createNodes(status);
+            return newCacheData;
+        }
+
+        std::string MapReader::readEntityCacheData(ParserStatus& status) {
+            parseAllEntities(status);
+            return MapCache::write(m_str, m_sourceMapFormat, m_targetMapFormat, m_objectInfos);
         }
 
         void MapReader::readBrushes(const vm::bbox3& worldBounds, ParserStatus& status) {
@@ -128,7 +309,61 @@ namespace TrenchBroom {
         }
 
         // helper methods
-        
+
+        void MapReader::parseAllEntities(ParserStatus& status) {
+            TB_PROFILE_SCOPE("MapReader::parseAllEntities");
+            const auto chunks = findEntityChunks(m_str);
+            if (chunks.size() > 1u) {
+                parseEntityChunks(chunks, status);
+            } else {
+                parseEntities(status);
+            }
+        }
+
+        void MapReader::parseEntityChunks(const std::vector<EntityChunk>& chunks, ParserStatus& status) {
+            auto results = kdl::vec_parallel_transform(chunks, [&](const EntityChunk& chunk) {
+                const auto allocationScope = AllocationScope{AllocationTag::IO};
+                auto chunkStatus = BufferedParserStatus{};
+                auto result = ChunkResult{};
+                try {
+                    auto reader = ChunkReader{chunk, m_sourceMapFormat, m_targetMapFormat};
+                    result.objectInfos = reader.parse(chunkStatus);
+                } catch (...) {
+                    result.exception = std::current_exception();
+                }
+                result.messages = chunkStatus.takeMessages();
+                return result;
+            });
+
+            // merge in source order; the parent indices are relative to the chunk's first object
+            for (auto& result : results) {
+                for (const auto& [level, message] : result.messages) {
+                    status.logMessage(level, message);
+                }
+                if (result.exception) {
+                    std::rethrow_exception(result.exception);
+                }
+
+                const auto offset = m_objectInfos.size();
+                for (auto& objectInfo : result.objectInfos) {
+                    std::visit(kdl::overload(
+                        [] (EntityInfo&) {},
+                        [&](BrushInfo& brushInfo) {
+                            if (brushInfo.parentIndex) {
+                                *brushInfo.parentIndex += offset;
+                            }
+                        },
+                        [&](PatchInfo& patchInfo) {
+                            if (patchInfo.parentIndex) {
+                                *patchInfo.parentIndex += offset;
+                            }
+                        }
+                    ), objectInfo);
+                    m_objectInfos.push_back(std::move(objectInfo));
+                }
+            }
+        }
+
         namespace {
             /** The type of a node's container. */
             enum class ContainerType {
@@ -454,6 +689,7 @@ namespace TrenchBroom {
             // create nodes in parallel, moving data out of objectInfos
             // we store optionals in the result vector to make the elements default constructible, which is a requirement for parallel transform
             std::vector<CreateNodeResult> createNodeResults = kdl::vec_parallel_transform(std::move(objectInfos), [&](auto&& objectInfo) -> CreateNodeResult {
+                const auto allocationScope = AllocationScope{AllocationTag::Model};
                 return std::visit(kdl::overload(
                     [&](MapReader::EntityInfo&& entityInfo) {
                         return createNodeFromEntityInfo(std::move(entityInfo), mapFormat);
@@ -628,6 +864,7 @@ namespace TrenchBroom {
          * from the `onWorldNode` callback.
          */
         void MapReader::createNodes(ParserStatus& status) {
+            TB_PROFILE_SCOPE("MapReader::createNodes");
             // create nodes from the recorded object infos
             auto nodeInfos = createNodesFromObjectInfos(std::move(m_objectInfos), m_worldBounds, m_targetMapFormat, status);
 
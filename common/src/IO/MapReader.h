@@ -32,6 +32,7 @@
 #include <vecmath/bbox.h>
 
 #include <optional>
+#include <string>
 #include <string_view>
 #include <variant>
 #include <vector>
@@ -94,7 +95,19 @@ namespace TrenchBroom {
             };
 
             using ObjectInfo = std::variant<EntityInfo, BrushInfo, PatchInfo>;
+
+            /**
+             * A part of the source string that contains one or more complete top level entities and can be parsed
+             * independently of the remaining source.
+             */
+            struct EntityChunk {
+                std::string_view str;
+                size_t startLine;
+            };
         private:
+            class ChunkReader;
+
+            std::string_view m_str;
             vm::bbox3 m_worldBounds;
         private: // data populated in response to MapParser callbacks
             std::vector<ObjectInfo> m_objectInfos;
@@ -107,15 +120,36 @@ namespace TrenchBroom {
              * @param str the string to parse
              * @param sourceMapFormat the expected format of the given string
              * @param targetMapFormat the format to convert the created objects to
+             * @param startLine the line number of the first line of the given string
              */
-            MapReader(std::string_view str, Model::MapFormat sourceMapFormat, Model::MapFormat targetMapFormat);
+            MapReader(std::string_view str, Model::MapFormat sourceMapFormat, Model::MapFormat targetMapFormat, size_t startLine = 1);
 
             /**
              * Attempts to parse as one or more entities.
              *
+             * Large inputs are split into chunks of top level entities which are parsed in parallel. The results
+             * are merged in source order, so the created nodes and the reported messages are the same as if the
+             * input had been parsed serially.
+             *
              * @throws ParserException if parsing fails
              */
             void readEntities(const vm::bbox3& worldBounds, ParserStatus& status);
+
+            /**
+             * Like readEntities, but restores the parsed data from the given cache data if it is valid for the
+             * source string. Otherwise, the source string is parsed and new cache data is returned.
+             *
+             * @return the new cache data, or an empty optional if the given cache data was used
+             * @throws ParserException if parsing fails
+             */
+            std::optional<std::string> readEntities(const vm::bbox3& worldBounds, std::string_view cacheData, ParserStatus& status);
+            /**
+             * Parses the source string as one or more entities and returns cache data for it without creating any
+             * nodes. The cache data can be passed to readEntities later to skip parsing the same source again.
+             *
+             * @throws ParserException if parsing fails
+             */
+            std::string readEntityCacheData(ParserStatus& status);
             /**
              * Attempts to parse as one or more brushes without any enclosing entity.
              *
@@ -137,6 +171,8 @@ namespace TrenchBroom {
             void onValveBrushFace(size_t line, Model::MapFormat targetMapFormat, const vm::vec3& point1, const vm::vec3& point2, const vm::vec3& point3, const Model::BrushFaceAttributes& attribs, const vm::vec3& texAxisX, const vm::vec3& texAxisY, ParserStatus& status) override;
             void onPatch(size_t startLine, size_t lineCount, Model::MapFormat targetMapFormat, size_t rowCount, size_t columnCount, std::vector<vm::vec<FloatType, 5>> controlPoints, std::string textureName, ParserStatus& status) override;
         private: // helper methods
+            void parseAllEntities(ParserStatus& status);
+            void parseEntityChunks(const std::vector<EntityChunk>& chunks, ParserStatus& status);
             void createNodes(ParserStatus& status);
         private: // subclassing interface - these will be called in the order that nodes should be inserted
             /**
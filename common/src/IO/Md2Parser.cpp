@@ -32,6 +32,8 @@
 #include "Renderer/IndexRangeMapBuilder.h"
 #include "Renderer/PrimType.h"
 
+#include <kdl/vector_utils.h>
+
 #include <string>
 
 namespace TrenchBroom {
@@ -346,14 +348,8 @@ namespace TrenchBroom {
         }
 
         void Md2Parser::loadSkins(Assets::EntityModelSurface& surface, const Md2SkinList& skins, Logger& logger) {
-            std::vector<Assets::Texture> textures;
-            textures.reserve(skins.size());
-            
-            for (const auto& skin : skins) {
-                textures.push_back(loadSkin(Path(skin), m_fs, logger, m_palette));
-            }
-            
-            surface.setSkins(std::move(textures));
+            const auto paths = kdl::vec_transform(skins, [](const auto& skin) { return Path(skin); });
+            surface.setSkins(IO::loadSkins(paths, m_fs, logger, m_palette));
         }
 
         void Md2Parser::buildFrame(Assets::EntityModel& model, Assets::EntityModelSurface& surface, const size_t frameIndex, const Md2Frame& frame, const Md2MeshList& meshes) {
@@ -29,6 +29,8 @@
 #include "Renderer/IndexRangeMapBuilder.h"
 #include "Renderer/PrimType.h"
 
+#include <kdl/vector_utils.h>
+
 #include <string>
 
 namespace TrenchBroom {
@@ -262,19 +264,8 @@ namespace TrenchBroom {
         }
 
         void Md3Parser::loadSurfaceSkins(Assets::EntityModelSurface& surface, const std::vector<Path>& shaders, Logger& logger) {
-            std::vector<Assets::Texture> textures;
-            textures.reserve(shaders.size());
-            
-            for (const auto& shader : shaders) {
-                textures.push_back(loadShader(logger, shader));
-            }
-            
-            surface.setSkins(std::move(textures));
-        }
-
-        Assets::Texture Md3Parser::loadShader(Logger& logger, const Path& path) const {
-            const auto shaderPath = path.deleteExtension();
-            return IO::loadShader(shaderPath, m_fs, logger);
+            const auto shaderPaths = kdl::vec_transform(shaders, [](const auto& shader) { return shader.deleteExtension(); });
+            surface.setSkins(IO::loadShaders(shaderPaths, m_fs, logger));
         }
 
         void Md3Parser::buildFrameSurface(Assets::EntityModelLoadedFrame& frame, Assets::EntityModelSurface& surface, const std::vector<Md3Parser::Md3Triangle>& triangles, const std::vector<Assets::EntityModelVertex>& vertices) {
@@ -65,7 +65,6 @@ namespace TrenchBroom {
             std::vector<Assets::EntityModelVertex> buildVertices(const std::vector<vm::vec3f>& positions, const std::vector<vm::vec2f>& texCoords);
 
             void loadSurfaceSkins(Assets::EntityModelSurface& surface, const std::vector<Path>& shaders, Logger& logger);
-            Assets::Texture loadShader(Logger& logger, const Path& path) const;
             
             void buildFrameSurface(Assets::EntityModelLoadedFrame& frame, Assets::EntityModelSurface& surface, const std::vector<Md3Parser::Md3Triangle>& triangles, const std::vector<Assets::EntityModelVertex>& vertices);
         };
@@ -31,6 +31,8 @@
 #include "Renderer/IndexRangeMapBuilder.h"
 #include "Renderer/PrimType.h"
 
+#include <kdl/vector_utils.h>
+
 #include <string>
 
 namespace TrenchBroom {
@@ -353,18 +355,11 @@ namespace TrenchBroom {
         }
 
         void MdxParser::loadSkins(Assets::EntityModelSurface& surface, const MdxSkinList& skins, Logger& logger) {
-            std::vector<Assets::Texture> textures;
-            textures.reserve(skins.size());
-        
-            for (const auto& skin : skins) {
+            const auto paths = kdl::vec_transform(skins, [](const auto& skin) {
                 auto path = Path(skin);
-                if (path.isAbsolute()) {
-                    path = path.makeRelative();
-                }
-                textures.push_back(loadSkin(path, m_fs, logger));
-            }
-            
-            surface.setSkins(std::move(textures));
+                return path.isAbsolute() ? path.makeRelative() : path;
+            });
+            surface.setSkins(IO::loadSkins(paths, m_fs, logger));
         }
 
         void MdxParser::buildFrame(Assets::EntityModel& model, Assets::EntityModelSurface& surface, const size_t frameIndex, const MdxFrame& frame, const MdxMeshList& meshes) {
@@ -39,9 +39,13 @@ namespace TrenchBroom {
         MapReader(str, sourceMapFormat, targetMapFormat) {}
 
         std::vector<Model::Node*> NodeReader::read(const std::string& str, const Model::MapFormat preferredMapFormat, const vm::bbox3& worldBounds, ParserStatus& status) {
+            return read(str, preferredMapFormat, worldBounds, std::string_view{}, status);
+        }
+
+        std::vector<Model::Node*> NodeReader::read(const std::string& str, const Model::MapFormat preferredMapFormat, const vm::bbox3& worldBounds, const std::string_view cacheData, ParserStatus& status) {
             // Try preferred format first
             for (const auto compatibleMapFormat : Model::compatibleFormats(preferredMapFormat)) {
-                if (auto result = readAsFormat(compatibleMapFormat, preferredMapFormat, str, worldBounds, status); !result.empty()) {
+                if (auto result = readAsFormat(compatibleMapFormat, preferredMapFormat, str, worldBounds, cacheData, status); !result.empty()) {
                     return result;
                 }
             }
@@ -58,11 +62,26 @@ namespace TrenchBroom {
          *
          * @returns the parsed nodes; caller is responsible for freeing them.
          */
-        std::vector<Model::Node*> NodeReader::readAsFormat(const Model::MapFormat sourceMapFormat, const Model::MapFormat targetMapFormat, const std::string& str, const vm::bbox3& worldBounds, ParserStatus& status) {
+        std::string NodeReader::writeCacheData(const std::string& str, const Model::MapFormat mapFormat, ParserStatus& status) {
+            NodeReader reader(str, mapFormat, mapFormat);
+            try {
+                return reader.readEntityCacheData(status);
+            } catch (const ParserException& e) {
+                status.info("Couldn't parse as " + Model::formatName(mapFormat) + " entities: " + e.what());
+                return "";
+            }
+        }
+
+        std::vector<Model::Node*> NodeReader::readAsFormat(const Model::MapFormat sourceMapFormat, const Model::MapFormat targetMapFormat, const std::string& str, const vm::bbox3& worldBounds, const std::string_view cacheData, ParserStatus& status) {
             {
                 NodeReader reader(str, sourceMapFormat, targetMapFormat);
                 try {
-                    reader.readEntities(worldBounds, status);
+                    if (cacheData.empty()) {
+                        reader.readEntities(worldBounds, status);
+                    } else {
+                        // the cache data is only used if it was created for this string and these formats
+                        reader.readEntities(worldBounds, cacheData, status);
+                    }
                     status.info("Parsed successfully as " + Model::formatName(sourceMapFormat) + " entities");
                     return reader.m_nodes;
                 } catch (const ParserException& e) {
@@ -47,8 +47,21 @@ namespace TrenchBroom {
             NodeReader(std::string_view str, Model::MapFormat sourceMapFormat, Model::MapFormat targetMapFormat);
 
             static std::vector<Model::Node*> read(const std::string& str, Model::MapFormat preferredMapFormat, const vm::bbox3& worldBounds, ParserStatus& status);
+
+            /**
+             * Like read, but restores the parsed entities from the given cache data if it was created for the given
+             * string by writeCacheData. Otherwise, the string is parsed.
+             */
+            static std::vector<Model::Node*> read(const std::string& str, Model::MapFormat preferredMapFormat, const vm::bbox3& worldBounds, std::string_view cacheData, ParserStatus& status);
+
+            /**
+             * Parses the given string as entities in the given format and returns cache data that allows reading
+             * the string into a document of the same format without parsing it again. Returns an empty string if
+             * the string cannot be parsed as entities.
+             */
+            static std::string writeCacheData(const std::string& str, Model::MapFormat mapFormat, ParserStatus& status);
         private:
-            static std::vector<Model::Node*> readAsFormat(Model::MapFormat sourceMapFormat, Model::MapFormat targetMapFormat, const std::string& str, const vm::bbox3& worldBounds, ParserStatus& status);
+            static std::vector<Model::Node*> readAsFormat(Model::MapFormat sourceMapFormat, Model::MapFormat targetMapFormat, const std::string& str, const vm::bbox3& worldBounds, std::string_view cacheData, ParserStatus& status);
         private: // implement MapReader interface
             Model::Node* onWorldNode(std::unique_ptr<Model::WorldNode> worldNode, ParserStatus& status) override;
             void onLayerNode(std::unique_ptr<Model::Node> layerNode, ParserStatus& status) override;
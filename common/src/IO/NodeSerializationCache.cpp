@@ -0,0 +1,66 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NodeSerializationCache.h"
+
+#include "Model/Node.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        NodeSerializationCache::NodeSerializationCache() :
+        m_format(Model::MapFormat::Unknown) {}
+
+        void NodeSerializationCache::setFormat(const Model::MapFormat format) {
+            if (format != m_format) {
+                clear();
+                m_format = format;
+            }
+        }
+
+        const SerializedNode* NodeSerializationCache::find(const Model::Node* node) const {
+            const auto it = m_entries.find(node);
+            return it != std::end(m_entries) ? &it->second : nullptr;
+        }
+
+        void NodeSerializationCache::insert(const Model::Node* node, SerializedNode serializedNode) {
+            m_entries.insert_or_assign(node, std::move(serializedNode));
+        }
+
+        void NodeSerializationCache::invalidate(const std::vector<Model::Node*>& nodes) {
+            for (const auto* node : nodes) {
+                m_entries.erase(node);
+            }
+        }
+
+        void NodeSerializationCache::invalidateRecursively(const std::vector<Model::Node*>& nodes) {
+            for (auto* node : nodes) {
+                m_entries.erase(node);
+                invalidateRecursively(node->children());
+            }
+        }
+
+        void NodeSerializationCache::clear() {
+            m_entries.clear();
+        }
+
+        size_t NodeSerializationCache::size() const {
+            return m_entries.size();
+        }
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Model/MapFormat.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        class Node;
+    }
+
+    namespace IO {
+        /**
+         * The serialized form of a brush or patch node.
+         */
+        struct SerializedNode {
+            std::string string;
+            size_t lineCount;
+        };
+
+        /**
+         * Caches the serialized form of brush and patch nodes across several runs of a MapFileSerializer, so that only
+         * nodes that changed since the last run need to be serialized again.
+         *
+         * The cache does not observe the nodes, so its owner must invalidate a node whenever it changes and remove it
+         * before it is destroyed.
+         */
+        class NodeSerializationCache {
+        private:
+            Model::MapFormat m_format;
+            std::unordered_map<const Model::Node*, SerializedNode> m_entries;
+        public:
+            NodeSerializationCache();
+
+            /**
+             * Prepares the cache for serializing nodes in the given format. Clears the cache if it was filled using a
+             * different format.
+             */
+            void setFormat(Model::MapFormat format);
+
+            const SerializedNode* find(const Model::Node* node) const;
+            void insert(const Model::Node* node, SerializedNode serializedNode);
+
+            /**
+             * Removes the given nodes from the cache.
+             */
+            void invalidate(const std::vector<Model::Node*>& nodes);
+
+            /**
+             * Removes the given nodes and all of their descendants from the cache.
+             */
+            void invalidateRecursively(const std::vector<Model::Node*>& nodes);
+
+            void clear();
+            size_t size() const;
+        };
+    }
+}
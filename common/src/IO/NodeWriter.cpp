@@ -72,9 +72,9 @@ namespace TrenchBroom {
             }
         }
 
-        NodeWriter::NodeWriter(const Model::WorldNode& world, std::ostream& stream) :
+        NodeWriter::NodeWriter(const Model::WorldNode& world, std::ostream& stream, NodeSerializationCache* cache) :
         m_world(world),
-        m_serializer(MapFileSerializer::create(m_world.mapFormat(), stream)) {}
+        m_serializer(MapFileSerializer::create(m_world.mapFormat(), stream, cache)) {}
 
         NodeWriter::NodeWriter(const Model::WorldNode& world, std::unique_ptr<NodeSerializer> serializer) :
         m_world(world),
@@ -35,6 +35,7 @@ namespace TrenchBroom {
     }
 
     namespace IO {
+        class NodeSerializationCache;
         class NodeSerializer;
 
         class NodeWriter {
@@ -44,7 +45,7 @@ namespace TrenchBroom {
             const Model::WorldNode& m_world;
             std::unique_ptr<NodeSerializer> m_serializer;
         public:
-            NodeWriter(const Model::WorldNode& world, std::ostream& stream);
+            NodeWriter(const Model::WorldNode& world, std::ostream& stream, NodeSerializationCache* cache = nullptr);
             NodeWriter(const Model::WorldNode& world, std::unique_ptr<NodeSerializer> serializer);
             ~NodeWriter();
 
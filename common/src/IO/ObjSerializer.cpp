@@ -26,56 +26,81 @@
 #include "Model/BrushGeometry.h"
 #include "Model/PatchNode.h"
 #include "Model/Polyhedron.h"
+#include "Model/TexCoordSystem.h"
 
 #include <kdl/overload.h>
+#include <kdl/parallel.h>
 
 #include <fmt/format.h>
 
 #include <iostream>
+#include <iterator> // for std::back_inserter
+#include <map>
 
 namespace TrenchBroom {
     namespace IO {
-        std::ostream& operator<<(std::ostream& str, const ObjSerializer::IndexedVertex& vertex) {
-            str << " " << (vertex.vertex + 1u) << "/" << (vertex.texCoords + 1u) << "/" << (vertex.normal + 1u);
-            return str;
+        static void writeIndexedVertex(std::string& str, const ObjSerializer::IndexedVertex& vertex) {
+            fmt::format_to(std::back_inserter(str), " {}/{}/{}", vertex.vertex + 1u, vertex.texCoords + 1u, vertex.normal + 1u);
         }
 
-        std::ostream& operator<<(std::ostream& str, const ObjSerializer::BrushObject& object) {
-            str << "o entity" << object.entityNo << "_brush" << object.brushNo << "\n";
+        static void writeBrushObject(std::string& str, const ObjSerializer::BrushObject& object) {
+            fmt::format_to(std::back_inserter(str), "o entity{}_brush{}\n", object.entityNo, object.brushNo);
             for (const auto& face : object.faces) {
-                str << "usemtl " << face.textureName << "\n";
-                str << "f";
+                fmt::format_to(std::back_inserter(str), "usemtl {}\nf", face.textureName);
                 for (const auto& vertex : face.verts) {
-                    str << " " << vertex;
+                    str += " ";
+                    writeIndexedVertex(str, vertex);
                 }
-                str << "\n";
+                str += "\n";
             }
-            return str;
         }
 
-        std::ostream& operator<<(std::ostream& str, const ObjSerializer::PatchObject& object) {
-            str << "o entity" << object.entityNo << "_patch" << object.patchNo << "\n";
-            str << "usemtl " << object.textureName << "\n";
+        static void writePatchObject(std::string& str, const ObjSerializer::PatchObject& object) {
+            fmt::format_to(std::back_inserter(str), "o entity{}_patch{}\n", object.entityNo, object.patchNo);
+            fmt::format_to(std::back_inserter(str), "usemtl {}\n", object.textureName);
             for (const auto& quad : object.quads) {
-                str << "f";
+                str += "f";
                 for (const auto& vertex : quad.verts) {
-                    str << " " << vertex;
+                    str += " ";
+                    writeIndexedVertex(str, vertex);
                 }
-                str << "\n";
+                str += "\n";
             }
-            return str;
         }
 
-        std::ostream& operator<<(std::ostream& str, const ObjSerializer::Object& object) {
+        static void writeObject(std::string& str, const ObjSerializer::Object& object) {
             std::visit(kdl::overload(
                 [&](const ObjSerializer::BrushObject& brushObject) {
-                    str << brushObject;
+                    writeBrushObject(str, brushObject);
                 },
                 [&](const ObjSerializer::PatchObject& patchObject) {
-                    str << patchObject;
+                    writePatchObject(str, patchObject);
                 }
             ), object);
-            return str;
+        }
+
+        std::ostream& operator<<(std::ostream& str, const ObjSerializer::IndexedVertex& vertex) {
+            auto buffer = std::string{};
+            writeIndexedVertex(buffer, vertex);
+            return str << buffer;
+        }
+
+        std::ostream& operator<<(std::ostream& str, const ObjSerializer::BrushObject& object) {
+            auto buffer = std::string{};
+            writeBrushObject(buffer, object);
+            return str << buffer;
+        }
+
+        std::ostream& operator<<(std::ostream& str, const ObjSerializer::PatchObject& object) {
+            auto buffer = std::string{};
+            writePatchObject(buffer, object);
+            return str << buffer;
+        }
+
+        std::ostream& operator<<(std::ostream& str, const ObjSerializer::Object& object) {
+            auto buffer = std::string{};
+            writeObject(buffer, object);
+            return str << buffer;
         }
 
         ObjSerializer::ObjSerializer(std::ostream& objStream, std::ostream& mtlStream, std::string mtlFilename) :
@@ -112,51 +137,57 @@ namespace TrenchBroom {
             }
         }
 
-        static void writeVertices(std::ostream& str, const std::vector<vm::vec3>& vertices) {
-            str << "# vertices\n";
+        static void writeVertices(std::string& str, const std::vector<vm::vec3>& vertices) {
+            str += "# vertices\n";
             for (const vm::vec3& elem : vertices) {
                 // no idea why I have to switch Y and Z
-                fmt::format_to(std::ostreambuf_iterator<char>(str), "v {} {} {}\n", elem.x(), elem.z(), -elem.y());
+                fmt::format_to(std::back_inserter(str), "v {} {} {}\n", elem.x(), elem.z(), -elem.y());
             }
         }
 
-        static void writeTexCoords(std::ostream& str, const std::vector<vm::vec2f>& texCoords) {
-            str << "# texture coordinates\n";
+        static void writeTexCoords(std::string& str, const std::vector<vm::vec2f>& texCoords) {
+            str += "# texture coordinates\n";
             for (const vm::vec2f& elem : texCoords) {
                 // multiplying Y by -1 needed to get the UV's to appear correct in Blender and UE4
                 // (see: https://github.com/TrenchBroom/TrenchBroom/issues/2851 )
-                fmt::format_to(std::ostreambuf_iterator<char>(str), "vt {} {}\n", elem.x(), -elem.y());
+                fmt::format_to(std::back_inserter(str), "vt {} {}\n", elem.x(), -elem.y());
             }
         }
 
-        static void writeNormals(std::ostream& str, const std::vector<vm::vec3>& normals) {
-            str << "# normals\n";
+        static void writeNormals(std::string& str, const std::vector<vm::vec3>& normals) {
+            str += "# normals\n";
             for (const vm::vec3& elem : normals) {
                 // no idea why I have to switch Y and Z
-                fmt::format_to(std::ostreambuf_iterator<char>(str), "vn {} {} {}\n", elem.x(), elem.z(), -elem.y());
+                fmt::format_to(std::back_inserter(str), "vn {} {} {}\n", elem.x(), elem.z(), -elem.y());
             }
         }
 
         static void writeObjFile(
-            std::ostream& str, const std::string mtlFilename, 
+            std::ostream& stream, const std::string mtlFilename, 
             const std::vector<vm::vec3>& vertices, const std::vector<vm::vec2f>& texCoords, const std::vector<vm::vec3>& normals, 
             const std::vector<ObjSerializer::Object>& objects) {
-            
-            str << "mtllib " << mtlFilename << "\n";
+
+            // format everything into one buffer and write it at once, formatting each element through the stream
+            // is much slower
+            auto str = std::string{};
+            fmt::format_to(std::back_inserter(str), "mtllib {}\n", mtlFilename);
             writeVertices(str, vertices);
-            str << "\n";
+            str += "\n";
             writeTexCoords(str, texCoords);
-            str << "\n";
+            str += "\n";
             writeNormals(str, normals);
-            str << "\n";
+            str += "\n";
             
             for (const auto& object : objects) {
-                str << object;
-                str << "\n";
+                writeObject(str, object);
+                str += "\n";
             }
+
+            stream.write(str.data(), static_cast<std::streamsize>(str.size()));
         }
 
         void ObjSerializer::doEndFile() {
+            exportNodes();
             writeMtlFile(m_mtlStream, m_objects);
             writeObjFile(m_objStream, m_mtlFilename, m_vertices.list(), m_texCoords.list(), m_normals.list(), m_objects);
         }
@@ -166,71 +197,129 @@ namespace TrenchBroom {
         void ObjSerializer::doEntityProperty(const Model::EntityProperty& /* property */) {}
 
         void ObjSerializer::doBrush(const Model::BrushNode* brush) {
-            m_currentBrush = BrushObject{entityNo(), brushNo(), {}};
-            m_currentBrush->faces.reserve(brush->brush().faceCount());
-
-            // Vertex positions inserted from now on should get new indices
-            m_vertices.clearIndices();
+            m_nodesToExport.emplace_back(BrushToExport{entityNo(), brushNo(), brush});
+        }
 
-            for (const Model::BrushFace& face : brush->brush().faces()) {
-                doBrushFace(face);
-            }
+        void ObjSerializer::doBrushFace(const Model::BrushFace& /* face */) {}
 
-            m_objects.push_back(std::move(*m_currentBrush));
-            m_currentBrush = std::nullopt;
+        void ObjSerializer::doPatch(const Model::PatchNode* patchNode) {
+            m_nodesToExport.emplace_back(PatchToExport{entityNo(), brushNo(), patchNode});
         }
 
-        void ObjSerializer::doBrushFace(const Model::BrushFace& face) {
-            const vm::vec3& normal = face.boundary().normal;
-            const size_t normalIndex = m_normals.index(normal);
+        namespace {
+            struct FaceVertices {
+                std::vector<vm::vec3> positions;
+                std::vector<vm::vec2f> texCoords;
+            };
 
-            auto indexedVertices = std::vector<IndexedVertex>{};
-            indexedVertices.reserve(face.vertexCount());
+            std::vector<FaceVertices> computeFaceVertices(const Model::BrushNode* brushNode) {
+                const auto& brush = brushNode->brush();
 
-            for (const Model::BrushVertex* vertex : face.vertices()) {
-                const vm::vec3& position = vertex->position();
-                const vm::vec2f texCoords = face.textureCoords(position);
+                auto result = std::vector<FaceVertices>{};
+                result.reserve(brush.faceCount());
 
-                const size_t vertexIndex = m_vertices.index(position);
-                const size_t texCoordsIndex = m_texCoords.index(texCoords);
+                for (const Model::BrushFace& face : brush.faces()) {
+                    auto faceVertices = FaceVertices{};
+                    faceVertices.positions.reserve(face.vertexCount());
+                    faceVertices.texCoords.reserve(face.vertexCount());
 
-                indexedVertices.push_back(IndexedVertex{vertexIndex, texCoordsIndex, normalIndex});
-            }
+                    for (const Model::BrushVertex* vertex : face.vertices()) {
+                        faceVertices.positions.push_back(vertex->position());
+                    }
+                    face.texCoordProjection().texCoords(std::begin(faceVertices.positions), std::end(faceVertices.positions), std::back_inserter(faceVertices.texCoords));
+
+                    result.push_back(std::move(faceVertices));
+                }
 
-            m_currentBrush->faces.push_back(BrushFace{std::move(indexedVertices), face.attributes().textureName(), face.texture()});
+                return result;
+            }
         }
 
-        void ObjSerializer::doPatch(const Model::PatchNode* patchNode) {
-            const auto& patch = patchNode->patch();
-            auto patchObject = PatchObject{entityNo(), brushNo(), {}, patch.textureName(), patch.texture()};
+        /**
+         * Computing the vertex positions and texture coordinates of the brush faces is independent for each brush,
+         * so it is done in parallel. The indices must be assigned in the order in which the nodes were visited to
+         * produce a deterministic file, so that is done afterwards.
+         */
+        void ObjSerializer::exportNodes() {
+            auto faceVerticesPerNode = kdl::vec_parallel_transform(m_nodesToExport, [](const auto& nodeToExport) {
+                return std::visit(kdl::overload(
+                    [](const BrushToExport& brushToExport) {
+                        return computeFaceVertices(brushToExport.brushNode);
+                    },
+                    [](const PatchToExport&) {
+                        return std::vector<FaceVertices>{};
+                    }
+                ), nodeToExport);
+            });
+
+            m_objects.reserve(m_objects.size() + m_nodesToExport.size());
+            for (size_t i = 0u; i < m_nodesToExport.size(); ++i) {
+                std::visit(kdl::overload(
+                    [&](const BrushToExport& brushToExport) {
+                        const auto& brush = brushToExport.brushNode->brush();
+                        const auto& faceVertices = faceVerticesPerNode[i];
 
-            const auto& patchGrid = patchNode->grid();
-            patchObject.quads.reserve(patchGrid.quadRowCount() * patchGrid.quadColumnCount());
+                        auto brushObject = BrushObject{brushToExport.entityNo, brushToExport.brushNo, {}};
+                        brushObject.faces.reserve(brush.faceCount());
 
-            // Vertex positions inserted from now on should get new indices
-            m_vertices.clearIndices();
+                        // Vertex positions inserted from now on should get new indices
+                        m_vertices.clearIndices();
 
-            const auto makeIndexedVertex = [&](const auto& p) {
-                const size_t positionIndex = m_vertices.index(p.position);
-                const size_t texCoordsIndex = m_texCoords.index(vm::vec2f{p.texCoords});
-                const size_t normalIndex = m_normals.index(p.normal);
+                        for (size_t j = 0u; j < brush.faceCount(); ++j) {
+                            const auto& face = brush.face(j);
+                            const size_t normalIndex = m_normals.index(face.boundary().normal);
 
-                return IndexedVertex{positionIndex, texCoordsIndex, normalIndex};
-            };
+                            auto indexedVertices = std::vector<IndexedVertex>{};
+                            indexedVertices.reserve(faceVertices[j].positions.size());
 
-            for (size_t row = 0u; row < patchGrid.pointRowCount - 1u; ++row) {
-                for (size_t col = 0u; col < patchGrid.pointColumnCount - 1u; ++col) {
-                        // counter clockwise order
-                        patchObject.quads.push_back(PatchQuad{{
-                            makeIndexedVertex(patchGrid.point(row, col)),
-                            makeIndexedVertex(patchGrid.point(row + 1u, col)),
-                            makeIndexedVertex(patchGrid.point(row + 1u, col + 1u)),
-                            makeIndexedVertex(patchGrid.point(row, col + 1u)),
-                        }});
-                }
+                            for (size_t k = 0u; k < faceVertices[j].positions.size(); ++k) {
+                                const size_t vertexIndex = m_vertices.index(faceVertices[j].positions[k]);
+                                const size_t texCoordsIndex = m_texCoords.index(faceVertices[j].texCoords[k]);
+
+                                indexedVertices.push_back(IndexedVertex{vertexIndex, texCoordsIndex, normalIndex});
+                            }
+
+                            brushObject.faces.push_back(BrushFace{std::move(indexedVertices), face.attributes().textureName(), face.texture()});
+                        }
+
+                        m_objects.push_back(std::move(brushObject));
+                    },
+                    [&](const PatchToExport& patchToExport) {
+                        const auto& patch = patchToExport.patchNode->patch();
+                        auto patchObject = PatchObject{patchToExport.entityNo, patchToExport.patchNo, {}, patch.textureName(), patch.texture()};
+
+                        const auto& patchGrid = patchToExport.patchNode->grid();
+                        patchObject.quads.reserve(patchGrid.quadRowCount() * patchGrid.quadColumnCount());
+
+                        // Vertex positions inserted from now on should get new indices
+                        m_vertices.clearIndices();
+
+                        const auto makeIndexedVertex = [&](const auto& p) {
+                            const size_t positionIndex = m_vertices.index(p.position);
+                            const size_t texCoordsIndex = m_texCoords.index(vm::vec2f{p.texCoords});
+                            const size_t normalIndex = m_normals.index(p.normal);
+
+                            return IndexedVertex{positionIndex, texCoordsIndex, normalIndex};
+                        };
+
+                        for (size_t row = 0u; row < patchGrid.pointRowCount - 1u; ++row) {
+                            for (size_t col = 0u; col < patchGrid.pointColumnCount - 1u; ++col) {
+                                // counter clockwise order
+                                patchObject.quads.push_back(PatchQuad{{
+                                    makeIndexedVertex(patchGrid.point(row, col)),
+                                    makeIndexedVertex(patchGrid.point(row + 1u, col)),
+                                    makeIndexedVertex(patchGrid.point(row + 1u, col + 1u)),
+                                    makeIndexedVertex(patchGrid.point(row, col + 1u)),
+                                }});
+                            }
+                        }
+
+                        m_objects.push_back(std::move(patchObject));
+                    }
+                ), m_nodesToExport[i]);
             }
 
-            m_objects.push_back(std::move(patchObject));
+            m_nodesToExport.clear();
         }
     }
 }
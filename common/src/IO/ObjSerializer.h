@@ -23,12 +23,13 @@
 #include "IO/NodeSerializer.h"
 
 #include <vecmath/forward.h>
+#include <vecmath/vec.h>
 
 #include <array>
+#include <functional>
 #include <iosfwd>
-#include <map>
-#include <optional>
 #include <string>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
@@ -42,15 +43,27 @@ namespace TrenchBroom {
         class BrushFace;
         class EntityProperty;
         class Node;
+        class PatchNode;
     }
 
     namespace IO {
         class ObjSerializer : public NodeSerializer {
         public:
+            struct VecHash {
+                template <typename T, size_t S>
+                size_t operator()(const vm::vec<T,S>& v) const {
+                    auto result = std::hash<T>{}(v[0]);
+                    for (size_t i = 1u; i < S; ++i) {
+                        result ^= std::hash<T>{}(v[i]) + 0x9e3779b9 + (result << 6) + (result >> 2);
+                    }
+                    return result;
+                }
+            };
+
             template <typename V>
             class IndexMap {
             private:
-                std::map<V, size_t> m_map;
+                std::unordered_map<V, size_t, VecHash> m_map;
                 std::vector<V> m_list;
             public:
                 const std::vector<V>& list() const {
@@ -122,7 +135,23 @@ namespace TrenchBroom {
             IndexMap<vm::vec2f> m_texCoords;
             IndexMap<vm::vec3> m_normals;
 
-            std::optional<BrushObject> m_currentBrush;
+            struct BrushToExport {
+                size_t entityNo;
+                size_t brushNo;
+                const Model::BrushNode* brushNode;
+            };
+
+            struct PatchToExport {
+                size_t entityNo;
+                size_t patchNo;
+                const Model::PatchNode* patchNode;
+            };
+
+            /**
+             * The nodes are only recorded during traversal and converted into objects at the end of the file. This
+             * allows computing the vertex data of all brushes in parallel.
+             */
+            std::vector<std::variant<BrushToExport, PatchToExport>> m_nodesToExport;
             std::vector<Object> m_objects;
         public:
             explicit ObjSerializer(std::ostream& objStream, std::ostream& mtlStream, std::string mtlFilename);
@@ -138,6 +167,8 @@ namespace TrenchBroom {
             void doBrushFace(const Model::BrushFace& face) override;
 
             void doPatch(const Model::PatchNode* patchNode) override;
+
+            void exportNodes();
         };
     }
 }
@@ -0,0 +1,239 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PackageIndex.h"
+
+#include "Exceptions.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/IOUtils.h"
+#include "IO/PathQt.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
+
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <QDateTime>
+#include <QFileInfo>
+
+namespace TrenchBroom {
+    namespace IO {
+        namespace {
+            constexpr auto Magic = std::string_view{"TBPI"};
+            constexpr auto Version = uint32_t(2);
+
+            struct FileStat {
+                uint64_t size;
+                int64_t modificationTime;
+            };
+
+            std::optional<FileStat> statFile(const Path& path) {
+                const auto fileInfo = QFileInfo{pathAsQString(path)};
+                if (!fileInfo.isFile()) {
+                    return std::nullopt;
+                }
+                return FileStat{static_cast<uint64_t>(fileInfo.size()), static_cast<int64_t>(fileInfo.lastModified().toMSecsSinceEpoch())};
+            }
+
+            /**
+             * Appends values in native byte order; an index written on a different platform fails the validation of
+             * the header.
+             */
+            template <typename T>
+            void write(std::string& data, const T value) {
+                static_assert(std::is_arithmetic_v<T>, "T must be an arithmetic type");
+                data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+            }
+
+            void writeString(std::string& data, const std::string_view str) {
+                write(data, uint64_t(str.size()));
+                data.append(str);
+            }
+
+            std::string readString(Reader& reader) {
+                const auto size = reader.readSize<uint64_t>();
+                if (!reader.canRead(size)) {
+                    throw ReaderException("String size exceeds index data");
+                }
+                return reader.readString(size);
+            }
+        }
+
+        const std::chrono::seconds PackageIndex::MaxRecordAge = std::chrono::hours(24 * 90);
+        const std::chrono::seconds PackageIndex::LastUseResolution = std::chrono::hours(24);
+
+        PackageIndex::PackageIndex() :
+        m_modified(false) {}
+
+        PackageIndex PackageIndex::read(const Path& path) {
+            auto result = PackageIndex{};
+            if (!Disk::fileExists(path)) {
+                return result;
+            }
+
+            try {
+                const auto file = Disk::openFile(path);
+                auto reader = file->reader().buffer();
+                if (readString(reader) != Magic || reader.readUnsignedInt<uint32_t>() != Version || reader.readSize<uint32_t>() != sizeof(size_t)) {
+                    return result;
+                }
+
+                const auto recordCount = reader.readSize<uint64_t>();
+                for (size_t i = 0; i < recordCount; ++i) {
+                    auto packagePath = readString(reader);
+                    auto record = Record{};
+                    record.size = reader.read<uint64_t, uint64_t>();
+                    record.modificationTime = reader.read<int64_t, int64_t>();
+                    record.lastUse = reader.read<int64_t, int64_t>();
+
+                    const auto entryCount = reader.readSize<uint64_t>();
+                    for (size_t j = 0; j < entryCount; ++j) {
+                        auto entry = ZipFileSystem::Entry{};
+                        entry.name = readString(reader);
+                        entry.dataOffset = reader.readSize<uint64_t>();
+                        entry.compressedSize = reader.readSize<uint64_t>();
+                        entry.uncompressedSize = reader.readSize<uint64_t>();
+                        entry.checksum = reader.read<uint32_t, uint32_t>();
+                        entry.compressed = reader.readBool<uint8_t>();
+                        record.entries.push_back(std::move(entry));
+                    }
+
+                    result.m_records[std::move(packagePath)] = std::move(record);
+                }
+            } catch (const ReaderException&) {
+                return PackageIndex{};
+            } catch (const FileSystemException&) {
+                return PackageIndex{};
+            }
+
+            return result;
+        }
+
+        void PackageIndex::write(const Path& path) const {
+            auto data = std::string{};
+            writeString(data, Magic);
+            write(data, Version);
+            write(data, uint32_t(sizeof(size_t)));
+
+            auto recordCount = uint64_t(0);
+            for (const auto& [packagePath, record] : m_records) {
+                if (!expired(record)) {
+                    ++recordCount;
+                }
+            }
+            write(data, recordCount);
+
+            for (const auto& [packagePath, record] : m_records) {
+                if (expired(record)) {
+                    continue;
+                }
+
+                writeString(data, packagePath);
+                write(data, record.size);
+                write(data, record.modificationTime);
+                write(data, record.lastUse);
+                write(data, uint64_t(record.entries.size()));
+                for (const auto& entry : record.entries) {
+                    writeString(data, entry.name);
+                    write(data, uint64_t(entry.dataOffset));
+                    write(data, uint64_t(entry.compressedSize));
+                    write(data, uint64_t(entry.uncompressedSize));
+                    write(data, entry.checksum);
+                    write(data, uint8_t(entry.compressed ? 1 : 0));
+                }
+            }
+
+            // write to a temporary file first so that other instances never see a partially written index
+            auto tempName = std::stringstream{};
+            tempName << path.lastComponent().asString() << "." << std::hash<std::thread::id>{}(std::this_thread::get_id()) << ".tmp";
+            const auto tempPath = path.deleteLastComponent() + Path(tempName.str());
+
+            {
+                auto stream = openPathAsOutputStream(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+                if (!stream.write(data.data(), static_cast<std::streamsize>(data.size())).flush()) {
+                    stream.close();
+                    if (Disk::fileExists(tempPath)) {
+                        Disk::deleteFile(tempPath);
+                    }
+                    throw FileSystemException("Could not write package index '" + path.asString() + "'");
+                }
+            }
+
+            Disk::moveFile(tempPath, path, true);
+        }
+
+        bool PackageIndex::modified() const {
+            if (m_modified) {
+                return true;
+            }
+            // expired records are dropped when writing the index
+            for (const auto& [packagePath, record] : m_records) {
+                if (expired(record)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        std::optional<std::vector<ZipFileSystem::Entry>> PackageIndex::entries(const Path& packagePath) {
+            const auto it = m_records.find(packagePath.asString());
+            if (it == std::end(m_records)) {
+                return std::nullopt;
+            }
+
+            auto& record = it->second;
+            const auto fileStat = statFile(packagePath);
+            if (!fileStat || fileStat->size != record.size || fileStat->modificationTime != record.modificationTime) {
+                return std::nullopt;
+            }
+
+            const auto currentTime = now();
+            if (currentTime - record.lastUse >= LastUseResolution.count()) {
+                record.lastUse = currentTime;
+                m_modified = true;
+            }
+            return record.entries;
+        }
+
+        void PackageIndex::setEntries(const Path& packagePath, std::vector<ZipFileSystem::Entry> entries) {
+            if (const auto fileStat = statFile(packagePath)) {
+                m_records[packagePath.asString()] = Record{fileStat->size, fileStat->modificationTime, now(), std::move(entries)};
+                m_modified = true;
+            }
+        }
+
+        size_t PackageIndex::recordCount() const {
+            return m_records.size();
+        }
+
+        int64_t PackageIndex::now() {
+            return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+        }
+
+        bool PackageIndex::expired(const Record& record) {
+            return now() - record.lastUse > MaxRecordAge.count();
+        }
+    }
+}
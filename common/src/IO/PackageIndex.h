@@ -0,0 +1,107 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "IO/Path.h"
+#include "IO/ZipFileSystem.h"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * Persists the entries of zip archives so that the central directories of unchanged archives don't have to be
+         * read again when the game file system is initialized. An archive is considered unchanged if its size and
+         * modification time match the recorded values.
+         *
+         * The index is shared by all games, so records that are not used when one game is loaded are kept. Every
+         * record stores when it was last used, and records that have not been used for a while are dropped when the
+         * index is written.
+         */
+        class PackageIndex {
+        public:
+            /**
+             * Records that have not been used for longer than this are dropped when the index is written.
+             */
+            static const std::chrono::seconds MaxRecordAge;
+        private:
+            /**
+             * The last use of a record is only updated if it is older than this so that loading the same game again
+             * doesn't require the index to be written.
+             */
+            static const std::chrono::seconds LastUseResolution;
+
+            struct Record {
+                uint64_t size;
+                int64_t modificationTime;
+                int64_t lastUse;
+                std::vector<ZipFileSystem::Entry> entries;
+            };
+
+            std::map<std::string, Record> m_records;
+            bool m_modified;
+        public:
+            PackageIndex();
+
+            /**
+             * Reads the index from the file at the given path. Returns an empty index if the file does not exist or
+             * if it is malformed.
+             */
+            static PackageIndex read(const Path& path);
+
+            /**
+             * Writes the index to the file at the given path. The index is written to a temporary file first, which
+             * is then moved to the given path so that other instances never read a partially written index.
+             *
+             * @throws FileSystemException if the file cannot be written
+             */
+            void write(const Path& path) const;
+
+            /**
+             * Indicates whether any records were added, used for the first time in a while, or expired since the
+             * index was read.
+             */
+            bool modified() const;
+
+            /**
+             * Returns the recorded entries of the archive at the given absolute path if it is unchanged.
+             */
+            std::optional<std::vector<ZipFileSystem::Entry>> entries(const Path& packagePath);
+
+            /**
+             * Records the entries of the archive at the given absolute path.
+             */
+            void setEntries(const Path& packagePath, std::vector<ZipFileSystem::Entry> entries);
+
+            /**
+             * Returns the number of records, including the ones that were not used since the index was read.
+             */
+            size_t recordCount() const;
+        private:
+            static int64_t now();
+            static bool expired(const Record& record);
+        };
+    }
+}
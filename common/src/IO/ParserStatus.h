@@ -54,6 +54,12 @@ namespace TrenchBroom {
             void warn(const std::string& str);
             void error(const std::string& str);
             [[noreturn]] void errorAndThrow(const std::string& str);
+
+            /**
+             * Logs a message that already contains its position information, e.g. a message that was recorded by
+             * another parser status without a prefix. Only this status's prefix is prepended.
+             */
+            void logMessage(LogLevel level, const std::string& message);
         private:
             void log(LogLevel level, size_t line, size_t column, const std::string& str);
             std::string buildMessage(size_t line, size_t column, const std::string& str) const;
@@ -37,8 +37,30 @@ namespace TrenchBroom {
             return std::string_view("/\\");
         }
 
-        Path::Path(bool absolute, const std::vector<std::string>& components) :
-        m_components(components),
+        /**
+         * Joins the given components without going through a string stream, since paths are converted to strings in
+         * many places, e.g. whenever a file is opened.
+         */
+        static std::string joinComponents(const std::string_view prefix, const std::vector<std::string>& components, const std::string_view separator) {
+            auto length = prefix.size();
+            for (const auto& component : components) {
+                length += component.size() + separator.size();
+            }
+
+            auto result = std::string{};
+            result.reserve(length);
+            result += prefix;
+            for (size_t i = 0u; i < components.size(); ++i) {
+                if (i > 0u) {
+                    result += separator;
+                }
+                result += components[i];
+            }
+            return result;
+        }
+
+        Path::Path(bool absolute, std::vector<std::string> components) :
+        m_components(std::move(components)),
         m_absolute(absolute) {}
 
         Path::Path(const std::string& path) {
@@ -57,9 +79,11 @@ namespace TrenchBroom {
             if (rhs.isAbsolute()) {
                 throw PathException("Cannot concatenate absolute path");
             }
-            auto components = m_components;
+            auto components = std::vector<std::string>{};
+            components.reserve(m_components.size() + rhs.m_components.size());
+            components.insert(std::end(components), std::begin(m_components), std::end(m_components));
             components.insert(std::end(components), std::begin(rhs.m_components), std::end(rhs.m_components));
-            return Path(m_absolute, components);
+            return Path(m_absolute, std::move(components));
         }
 
         int Path::compare(const Path& rhs, const bool caseSensitive) const {
@@ -114,15 +138,15 @@ namespace TrenchBroom {
             if (m_absolute) {
 #ifdef _WIN32
                 if (hasDriveSpec(m_components)) {
-                    return kdl::str_join(m_components, separator);
+                    return joinComponents("", m_components, separator);
                 } else {
-                    return std::string(separator) + kdl::str_join(m_components, separator);
+                    return joinComponents(separator, m_components, separator);
                 }
 #else
-                return std::string(separator) + kdl::str_join(m_components, separator);
+                return joinComponents(separator, m_components, separator);
 #endif
             }
-            return kdl::str_join(m_components, separator);
+            return joinComponents("", m_components, separator);
         }
 
 
@@ -181,14 +205,14 @@ namespace TrenchBroom {
                 auto components = std::vector<std::string>();
                 components.reserve(m_components.size() - 1);
                 components.insert(std::begin(components), std::begin(m_components) + 1, std::end(m_components));
-                return Path(false, components);
+                return Path(false, std::move(components));
             }
 #ifdef _WIN32
             if (!m_components.empty() && hasDriveSpec(m_components[0])) {
                 std::vector<std::string> components;
                 components.reserve(m_components.size() - 1);
                 components.insert(std::begin(components), std::begin(m_components) + 1, std::end(m_components));
-                return Path(false, components);
+                return Path(false, std::move(components));
             }
             return Path(false, m_components);
 #else
@@ -215,7 +239,7 @@ namespace TrenchBroom {
                 auto components = std::vector<std::string>();
                 components.reserve(m_components.size() - 1);
                 components.insert(std::begin(components), std::begin(m_components), std::end(m_components) - 1);
-                return Path(m_absolute, components);
+                return Path(m_absolute, std::move(components));
             } else {
                 return Path(m_absolute, m_components);
             }
@@ -243,7 +267,7 @@ namespace TrenchBroom {
             for (size_t i = 0u; i < count; ++i) {
                 newComponents.push_back(m_components[index + i]);
             }
-            return Path(m_absolute && index == 0, newComponents);
+            return Path(m_absolute && index == 0, std::move(newComponents));
         }
 
         const std::vector<std::string>& Path::components() const {
@@ -267,13 +291,7 @@ namespace TrenchBroom {
                 throw PathException("Cannot get basename of empty path");
             }
 
-            const auto filename = this->filename();
-            const auto dotIndex = filename.rfind('.');
-            if (dotIndex == std::string::npos) {
-                return filename;
-            } else {
-                return filename.substr(0, dotIndex);
-            }
+            return std::string(basenameView());
         }
 
         std::string Path::extension() const {
@@ -281,13 +299,26 @@ namespace TrenchBroom {
                 throw PathException("Cannot get extension of empty path");
             }
 
-            const auto filename = this->filename();
-            const auto dotIndex = filename.rfind('.');
-            if (dotIndex == std::string::npos) {
-                return "";
-            } else {
-                return filename.substr(dotIndex + 1);
+            return std::string(extensionView());
+        }
+
+        std::string_view Path::filenameView() const {
+            if (isEmpty()) {
+                throw PathException("Cannot get filename of empty path");
             }
+            return m_components.empty() ? std::string_view() : std::string_view(m_components.back());
+        }
+
+        std::string_view Path::basenameView() const {
+            const auto filename = filenameView();
+            const auto dotIndex = filename.rfind('.');
+            return dotIndex == std::string_view::npos ? filename : filename.substr(0, dotIndex);
+        }
+
+        std::string_view Path::extensionView() const {
+            const auto filename = filenameView();
+            const auto dotIndex = filename.rfind('.');
+            return dotIndex == std::string_view::npos ? std::string_view() : filename.substr(dotIndex + 1);
         }
 
         bool Path::hasPrefix(const Path& prefix, bool caseSensitive) const {
@@ -300,9 +331,9 @@ namespace TrenchBroom {
 
         bool Path::hasFilename(const std::string& filename, const bool caseSensitive) const {
             if (caseSensitive) {
-                return filename == this->filename();
+                return filename == filenameView();
             } else {
-                return kdl::ci::str_is_equal(filename, this->filename());
+                return kdl::ci::str_is_equal(filename, filenameView());
             }
         }
 
@@ -317,9 +348,9 @@ namespace TrenchBroom {
 
         bool Path::hasBasename(const std::string& basename, const bool caseSensitive) const {
             if (caseSensitive) {
-                return basename == this->basename();
+                return basename == basenameView();
             } else {
-                return kdl::ci::str_is_equal(basename, this->basename());
+                return kdl::ci::str_is_equal(basename, basenameView());
             }
         }
 
@@ -334,9 +365,9 @@ namespace TrenchBroom {
 
         bool Path::hasExtension(const std::string& extension, const bool caseSensitive) const {
             if (caseSensitive) {
-                return extension == this->extension();
+                return extension == extensionView();
             } else {
-                return kdl::ci::str_is_equal(extension, this->extension());
+                return kdl::ci::str_is_equal(extension, extensionView());
             }
         }
 
@@ -368,7 +399,7 @@ namespace TrenchBroom {
             } else {
                 components.back() += "." + extension;
             }
-            return Path(m_absolute, components);
+            return Path(m_absolute, std::move(components));
         }
 
         Path Path::replaceExtension(const std::string& extension) const {
@@ -482,7 +513,7 @@ namespace TrenchBroom {
                 components.push_back(theirResolved[i]);
             }
 
-            return Path(false, components);
+            return Path(false, std::move(components));
         }
 
         Path Path::makeCanonical() const {
@@ -495,7 +526,7 @@ namespace TrenchBroom {
             for (const auto& component : m_components) {
                 lcComponents.push_back(kdl::str_to_lower(component));
             }
-            return Path(m_absolute, lcComponents);
+            return Path(m_absolute, std::move(lcComponents));
         }
 
         std::vector<Path> Path::makeAbsoluteAndCanonical(const std::vector<Path>& paths, const Path& relativePath) {
@@ -50,7 +50,7 @@ namespace TrenchBroom {
             std::vector<std::string> m_components;
             bool m_absolute;
 
-            Path(bool absolute, const std::vector<std::string>& components);
+            Path(bool absolute, std::vector<std::string> components);
         public:
             explicit Path(const std::string& path = "");
 
@@ -112,6 +112,10 @@ namespace TrenchBroom {
 
             static std::vector<Path> makeAbsoluteAndCanonical(const std::vector<Path>& paths, const Path& relativePath);
         private:
+            std::string_view filenameView() const;
+            std::string_view basenameView() const;
+            std::string_view extensionView() const;
+
             static bool hasDriveSpec(const std::vector<std::string>& components);
             static bool hasDriveSpec(const std::string& component);
             std::vector<std::string> resolvePath(bool absolute, const std::vector<std::string>& components) const;
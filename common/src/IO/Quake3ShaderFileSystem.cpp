@@ -19,6 +19,7 @@
 
 #include "Quake3ShaderFileSystem.h"
 
+#include "BufferedLogger.h"
 #include "Logger.h"
 #include "Assets/Quake3Shader.h"
 #include "IO/File.h"
@@ -26,8 +27,10 @@
 #include "IO/Quake3ShaderParser.h"
 #include "IO/SimpleParserStatus.h"
 
+#include <kdl/parallel.h>
 #include <kdl/vector_utils.h>
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -49,22 +52,39 @@ namespace TrenchBroom {
             }
         }
 
+        namespace {
+            struct ParsedShaderFile {
+                std::vector<Assets::Quake3Shader> shaders;
+                std::unique_ptr<BufferedLogger> logger;
+            };
+        }
+
         std::vector<Assets::Quake3Shader> Quake3ShaderFileSystem::loadShaders() const {
             auto result = std::vector<Assets::Quake3Shader>();
 
             if (next().directoryExists(m_shaderSearchPath)) {
                 const auto paths = next().findItems(m_shaderSearchPath, FileExtensionMatcher("shader"));
-                for (const auto& path : paths) {
+
+                // the file systems are only read here, so the files are opened and parsed in parallel, and the messages
+                // are logged in the order of the files afterwards
+                auto parsedShaderFiles = kdl::vec_parallel_transform(paths, [&](const Path& path) {
+                    auto logger = std::make_unique<BufferedLogger>();
                     const auto file = next().openFile(path);
                     auto bufferedReader = file->reader().buffer();
 
                     try {
                         Quake3ShaderParser parser(bufferedReader.stringView());
-                        SimpleParserStatus status(m_logger, file->path().asString());
-                        result = kdl::vec_concat(std::move(result), parser.parse(status));
+                        SimpleParserStatus status(*logger, file->path().asString());
+                        return ParsedShaderFile{parser.parse(status), std::move(logger)};
                     } catch (const ParserException& e) {
-                        m_logger.warn() << "Skipping malformed shader file " << path << ": " << e.what();
+                        logger->warn() << "Skipping malformed shader file " << path << ": " << e.what();
+                        return ParsedShaderFile{{}, std::move(logger)};
                     }
+                });
+
+                for (auto& parsedShaderFile : parsedShaderFiles) {
+                    parsedShaderFile.logger->flush(m_logger);
+                    result = kdl::vec_concat(std::move(result), std::move(parsedShaderFile.shaders));
                 }
             }
 
@@ -89,24 +109,32 @@ namespace TrenchBroom {
 
         void Quake3ShaderFileSystem::linkTextures(const std::vector<Path>& textures, std::vector<Assets::Quake3Shader>& shaders) {
             m_logger.debug() << "Linking textures...";
+
+            // index the shaders by their paths so that we don't have to search for the shader of every texture; if
+            // several shaders have the same path, the first one is linked
+            auto shaderIndices = std::map<Path, size_t>{};
+            for (size_t i = 0u; i < shaders.size(); ++i) {
+                shaderIndices.emplace(shaders[i].shaderPath, i);
+            }
+            auto linkedShaders = std::vector<bool>(shaders.size(), false);
+
             for (const auto& texture : textures) {
                 const auto shaderPath = texture.deleteExtension();
 
                 // Only link a shader if it has not been linked yet.
                 if (!fileExists(shaderPath)) {
-                    const auto shaderIt = std::find_if(std::begin(shaders), std::end(shaders), [&shaderPath](const auto& shader){
-                        return shaderPath == shader.shaderPath;
-                    });
+                    const auto shaderIndexIt = shaderIndices.find(shaderPath);
 
-                    if (shaderIt != std::end(shaders)) {
+                    if (shaderIndexIt != std::end(shaderIndices) && !linkedShaders[shaderIndexIt->second]) {
                         // Found a matching shader.
-                        auto& shader = *shaderIt;
+                        const auto shaderIndex = shaderIndexIt->second;
+                        auto& shader = shaders[shaderIndex];
 
                         auto shaderFile = std::make_shared<ObjectFile<Assets::Quake3Shader>>(shaderPath, shader);
                         m_root.addFile(shaderPath, shaderFile);
 
-                        // Remove the shader so that we don't revisit it when linking standalone shaders.
-                        shaders.erase(shaderIt);
+                        // Mark the shader so that we don't revisit it when linking standalone shaders.
+                        linkedShaders[shaderIndex] = true;
                     } else {
                         // No matching shader found, generate one.
                         auto shader = Assets::Quake3Shader();
@@ -118,6 +146,16 @@ namespace TrenchBroom {
                     }
                 }
             }
+
+            // Remove the linked shaders in one pass.
+            auto unlinkedShaders = std::vector<Assets::Quake3Shader>{};
+            unlinkedShaders.reserve(shaders.size());
+            for (size_t i = 0u; i < shaders.size(); ++i) {
+                if (!linkedShaders[i]) {
+                    unlinkedShaders.push_back(std::move(shaders[i]));
+                }
+            }
+            shaders = std::move(unlinkedShaders);
         }
 
         void Quake3ShaderFileSystem::linkStandaloneShaders(std::vector<Assets::Quake3Shader>& shaders) {
@@ -48,6 +48,7 @@ namespace TrenchBroom {
             }
 
             auto texture = loadTextureImage(shader.shaderPath, texturePath);
+            texture.setImagePath(texturePath);
             texture.setSurfaceParms(shader.surfaceParms);
             texture.setOpaque();
 
@@ -85,7 +86,8 @@ namespace TrenchBroom {
                 throw AssetException("Image file '" + imagePath.asString() + "' does not exist");
             }
 
-            FreeImageTextureReader imageReader(StaticNameStrategy(name), m_fs, m_logger);
+            // shader packs can be huge, so only decode the images of shaders that are actually used
+            FreeImageTextureReader imageReader(StaticNameStrategy(name), m_fs, m_logger, true);
             return imageReader.readTexture(m_fs.openFile(imagePath));
         }
 
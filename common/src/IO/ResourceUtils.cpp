@@ -76,8 +76,23 @@ namespace TrenchBroom {
         }
 
         QPixmap loadPixmapResource(const Path& imagePath) {
-            const QString imagePathString = imagePathToString(imagePath);
-            return QPixmap(imagePathString);
+            // Images that are bundled with the application cannot change while it is running, so they are decoded
+            // only once. This matters for images such as the default game icon or the document icon, which would
+            // otherwise be decoded again for every list item and whenever a window is recreated. Absolute paths, e.g.
+            // game icons from user configurations, are not cached because the files might be changed.
+            if (imagePath.isAbsolute()) {
+                return QPixmap(imagePathToString(imagePath));
+            }
+
+            ensure(qApp->thread() == QThread::currentThread(), "loadPixmapResource can only be used on the main thread");
+
+            static std::map<Path, QPixmap> cache;
+            auto it = cache.find(imagePath);
+            if (it == cache.end()) {
+                it = cache.emplace(imagePath, QPixmap(imagePathToString(imagePath))).first;
+            }
+            // QPixmap is implicitly shared, so this doesn't copy the image data
+            return it->second;
         }
 
         static QImage createDisabledState(const QImage& image) {
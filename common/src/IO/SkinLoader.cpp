@@ -19,6 +19,7 @@
 
 #include "SkinLoader.h"
 
+#include "BufferedLogger.h"
 #include "Ensure.h"
 #include "Exceptions.h"
 #include "Logger.h"
@@ -32,9 +33,12 @@
 #include "IO/ResourceUtils.h"
 #include "IO/WalTextureReader.h"
 
+#include <kdl/parallel.h>
 #include <kdl/string_format.h>
 
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
@@ -62,6 +66,42 @@ namespace TrenchBroom {
             }
         }
 
+        /**
+         * Loads a texture for each of the given paths in parallel. Every texture is loaded with its own buffered
+         * logger, and the messages are forwarded to the given logger in the order of the paths.
+         */
+        template <typename L>
+        static std::vector<Assets::Texture> loadTexturesInParallel(const std::vector<Path>& paths, Logger& logger, const L& loadTexture) {
+            struct LoadedTexture {
+                Assets::Texture texture;
+                std::unique_ptr<BufferedLogger> logger;
+            };
+
+            auto loadedTextures = kdl::vec_parallel_transform(paths, [&](const Path& path) {
+                auto textureLogger = std::make_unique<BufferedLogger>();
+                auto texture = loadTexture(path, *textureLogger);
+                return LoadedTexture{std::move(texture), std::move(textureLogger)};
+            });
+
+            auto textures = std::vector<Assets::Texture>{};
+            textures.reserve(loadedTextures.size());
+            for (auto& loadedTexture : loadedTextures) {
+                loadedTexture.logger->flush(logger);
+                textures.push_back(std::move(loadedTexture.texture));
+            }
+            return textures;
+        }
+
+        std::vector<Assets::Texture> loadSkins(const std::vector<Path>& paths, const FileSystem& fs, Logger& logger) {
+            return loadSkins(paths, fs, logger, Assets::Palette());
+        }
+
+        std::vector<Assets::Texture> loadSkins(const std::vector<Path>& paths, const FileSystem& fs, Logger& logger, const Assets::Palette& palette) {
+            return loadTexturesInParallel(paths, logger, [&](const Path& path, Logger& skinLogger) {
+                return loadSkin(path, fs, skinLogger, palette);
+            });
+        }
+
         Assets::Texture loadShader(const Path& path, const FileSystem& fs, Logger& logger) {
             const TextureReader::PathSuffixNameStrategy nameStrategy(0u);
             
@@ -82,5 +122,11 @@ namespace TrenchBroom {
             const auto name = nameStrategy.textureName("", path);
             return loadDefaultTexture(fs, logger, name);
         }
+
+        std::vector<Assets::Texture> loadShaders(const std::vector<Path>& paths, const FileSystem& fs, Logger& logger) {
+            return loadTexturesInParallel(paths, logger, [&](const Path& path, Logger& shaderLogger) {
+                return loadShader(path, fs, shaderLogger);
+            });
+        }
     }
 }
@@ -20,6 +20,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 namespace TrenchBroom {
     class Logger;
@@ -35,8 +36,21 @@ namespace TrenchBroom {
 
         Assets::Texture loadSkin(const Path& path, const FileSystem& fs, Logger& logger);
         Assets::Texture loadSkin(const Path& path, const FileSystem& fs, Logger& logger, const Assets::Palette& palette);
+
+        /**
+         * Loads the skins with the given paths in parallel and returns them in the order of the given paths. The
+         * messages are logged in the same order once all skins are loaded.
+         */
+        std::vector<Assets::Texture> loadSkins(const std::vector<Path>& paths, const FileSystem& fs, Logger& logger);
+        std::vector<Assets::Texture> loadSkins(const std::vector<Path>& paths, const FileSystem& fs, Logger& logger, const Assets::Palette& palette);
         
         Assets::Texture loadShader(const Path& path, const FileSystem& fs, Logger& logger);
+
+        /**
+         * Loads the shaders with the given paths in parallel and returns them in the order of the given paths. The
+         * messages are logged in the same order once all shaders are loaded.
+         */
+        std::vector<Assets::Texture> loadShaders(const std::vector<Path>& paths, const FileSystem& fs, Logger& logger);
     }
 }
 
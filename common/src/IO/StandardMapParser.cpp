@@ -39,8 +39,8 @@ namespace TrenchBroom {
             return numberDelim;
         }
 
-        QuakeMapTokenizer::QuakeMapTokenizer(std::string_view str) :
-        Tokenizer(std::move(str), "\"", '\\'),
+        QuakeMapTokenizer::QuakeMapTokenizer(std::string_view str, const size_t line) :
+        Tokenizer(std::move(str), "\"", '\\', line),
         m_skipEol(true) {}
 
         void QuakeMapTokenizer::setSkipEol(bool skipEol) {
@@ -112,22 +112,18 @@ namespace TrenchBroom {
                         discardWhile(Whitespace());
                         break;
                     default: { // whitespace, integer, decimal or word
-                        const auto* e = readInteger(NumberDelim());
+                        // face lines consist mostly of numbers, so they are scanned only once
+                        const auto [e, integer] = readNumber(NumberDelim());
                         if (e != nullptr) {
-                            return Token(QuakeMapToken::Integer, c, e, offset(c), startLine, startColumn);
+                            return Token(integer ? QuakeMapToken::Integer : QuakeMapToken::Decimal, c, e, offset(c), startLine, startColumn);
                         }
 
-                        e = readDecimal(NumberDelim());
-                        if (e != nullptr) {
-                            return Token(QuakeMapToken::Decimal, c, e, offset(c), startLine, startColumn);
-                        }
-
-                        e = readUntil(Whitespace());
-                        if (e == nullptr) {
+                        const auto* s = readUntil(Whitespace());
+                        if (s == nullptr) {
                             throw ParserException(startLine, startColumn, "Unexpected character: " + std::string(c, 1));
                         }
 
-                        return Token(QuakeMapToken::String, c, e, offset(c), startLine, startColumn);
+                        return Token(QuakeMapToken::String, c, s, offset(c), startLine, startColumn);
                     }
                 }
             }
@@ -137,8 +133,8 @@ namespace TrenchBroom {
         const std::string StandardMapParser::BrushPrimitiveId = "brushDef";
         const std::string StandardMapParser::PatchId = "patchDef2";
 
-        StandardMapParser::StandardMapParser(std::string_view str, const Model::MapFormat sourceMapFormat, const Model::MapFormat targetMapFormat) :
-        m_tokenizer(QuakeMapTokenizer(std::move(str))),
+        StandardMapParser::StandardMapParser(std::string_view str, const Model::MapFormat sourceMapFormat, const Model::MapFormat targetMapFormat, const size_t startLine) :
+        m_tokenizer(QuakeMapTokenizer(std::move(str), startLine)),
         m_sourceMapFormat(sourceMapFormat),
         m_targetMapFormat(targetMapFormat) {
             assert(m_sourceMapFormat != Model::MapFormat::Unknown);
@@ -229,19 +225,19 @@ namespace TrenchBroom {
         void StandardMapParser::parseEntityProperty(std::vector<Model::EntityProperty>& properties, PropertyKeys& keys, ParserStatus& status) {
             auto token = m_tokenizer.nextToken();
             assert(token.type() == QuakeMapToken::String);
-            const auto name = token.data();
+            // the keys are views into the source, so they remain valid while the entity is parsed
+            const auto name = token.view();
 
             const auto line = token.line();
             const auto column = token.column();
 
             expect(QuakeMapToken::String, token = m_tokenizer.nextToken());
-            const auto value = token.data();
+            const auto value = token.view();
 
-            if (keys.count(name) == 0) {
-                properties.push_back(Model::EntityProperty(name, value));
-                keys.insert(name);
+            if (keys.insert(name).second) {
+                properties.emplace_back(std::string(name), std::string(value));
             } else {
-                status.warn(line, column, "Ignoring duplicate entity property '" + name + "'");
+                status.warn(line, column, "Ignoring duplicate entity property '" + std::string(name) + "'");
             }
         }
 
@@ -261,7 +257,7 @@ namespace TrenchBroom {
                 expect(QuakeMapToken::String | QuakeMapToken::OParenthesis, token);
                 if (token.hasType(QuakeMapToken::String)) {
                     expect(std::vector<std::string>({ BrushPrimitiveId, PatchId }), token);
-                    if (token.data() == BrushPrimitiveId) {
+                    if (token.view() == BrushPrimitiveId) {
                         parseBrushPrimitive(status, startLine);
                     } else {
                         parsePatch(status, startLine);
@@ -533,7 +529,7 @@ namespace TrenchBroom {
             expect(PatchId, token);
             expect(QuakeMapToken::OBrace, m_tokenizer.nextToken());
 
-            auto textureName = parseTextureName(status);
+            auto textureName = std::string(parseTextureName(status));
             expect(QuakeMapToken::OParenthesis, m_tokenizer.nextToken());
 
             /*
@@ -597,9 +593,14 @@ namespace TrenchBroom {
             return std::make_tuple(p1, p2, p3);
         }
 
-        std::string StandardMapParser::parseTextureName(ParserStatus& /* status */) {
+        std::string_view StandardMapParser::parseTextureName(ParserStatus& /* status */) {
             const auto [textureName, wasQuoted] = m_tokenizer.readAnyString(QuakeMapTokenizer::Whitespace());
-            return wasQuoted ? kdl::str_unescape(textureName, "\"\\") : std::string(textureName);
+            if (!wasQuoted || textureName.find('\\') == std::string_view::npos) {
+                return textureName;
+            }
+
+            m_unescapedTextureName = kdl::str_unescape(textureName, "\"\\");
+            return m_unescapedTextureName;
         }
 
         std::tuple<vm::vec3, float, vm::vec3, float> StandardMapParser::parseValveTextureAxes(ParserStatus& /* status */) {
@@ -59,7 +59,7 @@ namespace TrenchBroom {
             static const std::string& NumberDelim();
             bool m_skipEol;
         public:
-            explicit QuakeMapTokenizer(std::string_view str);
+            explicit QuakeMapTokenizer(std::string_view str, size_t line = 1);
 
             void setSkipEol(bool skipEol);
         private:
@@ -69,12 +69,18 @@ namespace TrenchBroom {
         class StandardMapParser : public MapParser, public Parser<QuakeMapToken::Type> {
         private:
             using Token = QuakeMapTokenizer::Token;
-            using PropertyKeys = kdl::vector_set<std::string>;
+            using PropertyKeys = kdl::vector_set<std::string_view>;
 
             static const std::string BrushPrimitiveId;
             static const std::string PatchId;
 
             QuakeMapTokenizer m_tokenizer;
+
+            /**
+             * Holds the most recently parsed texture name if it had to be unescaped. Texture names that don't need
+             * unescaping are returned as views into the source to avoid copying them twice.
+             */
+            std::string m_unescapedTextureName;
         protected:
             Model::MapFormat m_sourceMapFormat;
             Model::MapFormat m_targetMapFormat;
@@ -86,8 +92,10 @@ namespace TrenchBroom {
              * @param str the string to parse
              * @param sourceMapFormat the expected format of the given string
              * @param targetMapFormat the format to convert the created objects to
+             * @param startLine the line number of the first line of the given string, used when parsing a portion of
+             * a larger string
              */
-            StandardMapParser(std::string_view str, Model::MapFormat sourceMapFormat, Model::MapFormat targetMapFormat);
+            StandardMapParser(std::string_view str, Model::MapFormat sourceMapFormat, Model::MapFormat targetMapFormat, size_t startLine = 1);
 
             ~StandardMapParser() override;
         protected:
@@ -116,7 +124,7 @@ namespace TrenchBroom {
             void parsePatch(ParserStatus& status, size_t startLine);
 
             std::tuple<vm::vec3, vm::vec3, vm::vec3> parseFacePoints(ParserStatus& status);
-            std::string parseTextureName(ParserStatus& status);
+            std::string_view parseTextureName(ParserStatus& status);
             std::tuple<vm::vec3, float, vm::vec3, float> parseValveTextureAxes(ParserStatus& status);
             std::tuple<vm::vec3, vm::vec3> parsePrimitiveTextureAxes(ParserStatus& status);
 
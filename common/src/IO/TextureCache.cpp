@@ -0,0 +1,250 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextureCache.h"
+
+#include "Color.h"
+#include "Exceptions.h"
+#include "Macros.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/IOUtils.h"
+#include "IO/PathQt.h"
+#include "IO/Reader.h"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QtGlobal>
+
+namespace TrenchBroom {
+    namespace IO {
+        static const std::string CacheEntryMagic = "TBTC";
+        // increment this whenever the entry layout or the way textures are decoded changes
+        static const uint32_t CacheEntryVersion = 1u;
+
+        TextureCache::TextureCache(Path directory, const size_t capacity) :
+        m_directory(std::move(directory)),
+        m_capacity(capacity) {}
+
+        const Path& TextureCache::directory() const {
+            return m_directory;
+        }
+
+        size_t TextureCache::capacity() const {
+            return m_capacity;
+        }
+
+        uint64_t TextureCache::computeKey(const char* begin, const char* end) {
+            // 64 bit FNV-1a
+            auto hash = uint64_t(14695981039346656037ull);
+            for (const char* cur = begin; cur != end; ++cur) {
+                hash ^= static_cast<uint64_t>(static_cast<unsigned char>(*cur));
+                hash *= uint64_t(1099511628211ull);
+            }
+            return hash;
+        }
+
+        /**
+         * Marks the entry at the given path as used. Failing to do so only affects the order of eviction.
+         */
+        static void touchEntry(const Path& path) {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+            auto file = QFile{pathAsQString(path)};
+            if (file.open(QIODevice::Append)) {
+                file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+            }
+#else
+            // older versions of Qt cannot set the file time, so entries are evicted in the order they were written
+            unused(path);
+#endif
+        }
+
+        static QFileInfoList entryInfos(const Path& directory) {
+            return QDir{pathAsQString(directory)}.entryInfoList({"*.tex"}, QDir::Files);
+        }
+
+        static bool isValidFormat(const uint32_t format) {
+            return format == GL_RGB || format == GL_BGR || format == GL_RGBA || format == GL_BGRA;
+        }
+
+        std::optional<Assets::Texture> TextureCache::readTexture(const uint64_t key, const size_t dataSize, const std::string& name) const {
+            const auto path = entryPath(key);
+            if (!Disk::fileExists(path)) {
+                return std::nullopt;
+            }
+
+            try {
+                const auto file = Disk::openFile(path);
+                auto reader = file->reader().buffer();
+
+                if (reader.readString(CacheEntryMagic.size()) != CacheEntryMagic ||
+                    reader.readUnsignedInt<uint32_t>() != CacheEntryVersion ||
+                    reader.readSize<uint64_t>() != dataSize) {
+                    return std::nullopt;
+                }
+
+                const auto width = reader.readSize<uint32_t>();
+                const auto height = reader.readSize<uint32_t>();
+                const auto format = reader.readUnsignedInt<uint32_t>();
+                const auto type = reader.readUnsignedChar<uint8_t>() != 0u ? Assets::TextureType::Masked : Assets::TextureType::Opaque;
+                if (width == 0u || height == 0u || !isValidFormat(format)) {
+                    return std::nullopt;
+                }
+
+                const auto r = reader.readFloat<float>();
+                const auto g = reader.readFloat<float>();
+                const auto b = reader.readFloat<float>();
+                const auto a = reader.readFloat<float>();
+
+                const auto mipCount = reader.readSize<uint32_t>();
+                if (mipCount == 0u) {
+                    return std::nullopt;
+                }
+
+                const auto bytesPerPixel = Assets::bytesPerPixelForFormat(static_cast<GLenum>(format));
+                auto buffers = Assets::TextureBufferList{};
+                for (size_t level = 0u; level < mipCount; ++level) {
+                    const auto mipSize = Assets::sizeAtMipLevel(width, height, level);
+                    const auto bufferSize = reader.readSize<uint64_t>();
+                    if (bufferSize < mipSize.x() * mipSize.y() * bytesPerPixel || !reader.canRead(bufferSize)) {
+                        return std::nullopt;
+                    }
+
+                    auto& buffer = buffers.emplace_back(bufferSize);
+                    reader.read(buffer.data(), bufferSize);
+                }
+
+                touchEntry(path);
+                return Assets::Texture(name, width, height, Color(r, g, b, a), std::move(buffers), static_cast<GLenum>(format), type);
+            } catch (const Exception&) {
+                // treat unreadable entries as missing; they will be overwritten
+                return std::nullopt;
+            }
+        }
+
+        template <typename T>
+        static void writeValue(std::ostream& stream, const T value) {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        void TextureCache::writeTexture(const uint64_t key, const size_t dataSize, const Assets::Texture& texture) const {
+            Disk::ensureDirectoryExists(m_directory);
+
+            const auto path = entryPath(key);
+
+            // write to a temporary file that is unique to this thread so that concurrent writers of the same entry
+            // don't interfere with each other, and readers never see partially written entries
+            auto tempName = std::stringstream{};
+            tempName << path.lastComponent().asString() << "." << std::hash<std::thread::id>{}(std::this_thread::get_id()) << ".tmp";
+            const auto tempPath = path.deleteLastComponent() + Path(tempName.str());
+
+            {
+                auto stream = openPathAsOutputStream(tempPath, std::ios::out | std::ios::binary);
+                if (!stream) {
+                    throw FileSystemException("Could not open file '" + tempPath.asString() + "' for writing");
+                }
+
+                const auto& buffers = texture.buffersIfUnprepared();
+                const auto& color = texture.averageColor();
+
+                stream.write(CacheEntryMagic.data(), static_cast<std::streamsize>(CacheEntryMagic.size()));
+                writeValue(stream, CacheEntryVersion);
+                writeValue(stream, static_cast<uint64_t>(dataSize));
+                writeValue(stream, static_cast<uint32_t>(texture.width()));
+                writeValue(stream, static_cast<uint32_t>(texture.height()));
+                writeValue(stream, static_cast<uint32_t>(texture.format()));
+                writeValue(stream, static_cast<uint8_t>(texture.masked() ? 1u : 0u));
+                writeValue(stream, color.r());
+                writeValue(stream, color.g());
+                writeValue(stream, color.b());
+                writeValue(stream, color.a());
+                writeValue(stream, static_cast<uint32_t>(buffers.size()));
+                for (const auto& buffer : buffers) {
+                    writeValue(stream, static_cast<uint64_t>(buffer.size()));
+                    stream.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+                }
+
+                if (!stream) {
+                    stream.close();
+                    Disk::deleteFile(tempPath);
+                    throw FileSystemException("Could not write file '" + tempPath.asString() + "'");
+                }
+            }
+
+            Disk::moveFile(tempPath, path, true);
+
+            std::lock_guard<std::mutex> lock(m_sizeMutex);
+            if (!m_size) {
+                auto size = size_t(0);
+                for (const auto& entryInfo : entryInfos(m_directory)) {
+                    size += static_cast<size_t>(entryInfo.size());
+                }
+                m_size = size;
+            } else {
+                *m_size += static_cast<size_t>(QFileInfo{pathAsQString(path)}.size());
+            }
+
+            if (*m_size > m_capacity) {
+                evictEntries(path);
+            }
+        }
+
+        void TextureCache::evictEntries(const Path& keepPath) const {
+            auto infos = entryInfos(m_directory);
+            std::sort(std::begin(infos), std::end(infos), [](const auto& lhs, const auto& rhs) {
+                return lhs.lastModified() < rhs.lastModified();
+            });
+
+            auto size = size_t(0);
+            for (const auto& entryInfo : infos) {
+                size += static_cast<size_t>(entryInfo.size());
+            }
+
+            const auto keepFileName = pathAsQString(keepPath.lastComponent());
+            for (const auto& entryInfo : infos) {
+                if (size <= m_capacity) {
+                    break;
+                }
+                // entries which are being read by another thread or process may not be deletable
+                if (entryInfo.fileName() != keepFileName && QFile::remove(entryInfo.absoluteFilePath())) {
+                    size -= static_cast<size_t>(entryInfo.size());
+                }
+            }
+
+            m_size = size;
+        }
+
+        Path TextureCache::entryPath(const uint64_t key) const {
+            auto name = std::stringstream{};
+            name << std::hex << std::setw(16) << std::setfill('0') << key << ".tex";
+            return m_directory + Path(name.str());
+        }
+    }
+}
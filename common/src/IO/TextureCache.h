@@ -0,0 +1,101 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "IO/Path.h"
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace TrenchBroom {
+    namespace Assets {
+        class Texture;
+    }
+
+    namespace IO {
+        /**
+         * A persistent cache of decoded textures.
+         *
+         * Each entry is keyed by a hash of the encoded texture data, so an entry automatically becomes stale when
+         * the texture file changes. Entries only contain the pixel data and its properties; the name of a texture
+         * is always determined by the reader. Entries are written to a temporary file first and then moved into
+         * place, so multiple threads and processes can share a cache directory.
+         *
+         * The total size of the entries is limited. Once it exceeds the capacity, the least recently used entries are
+         * deleted. Reading an entry updates its modification time, which serves as the time of its last use.
+         */
+        class TextureCache {
+        public:
+            /**
+             * The default maximum total size of the cache entries, in bytes.
+             */
+            static constexpr size_t DefaultCapacity = 1024u * 1024u * 1024u;
+        private:
+            Path m_directory;
+            size_t m_capacity;
+
+            /**
+             * The total size of the entries, which is determined when the first entry is written. Entries written
+             * by other processes are only accounted for when entries are evicted.
+             */
+            mutable std::mutex m_sizeMutex;
+            mutable std::optional<size_t> m_size;
+        public:
+            explicit TextureCache(Path directory, size_t capacity = DefaultCapacity);
+
+            const Path& directory() const;
+            size_t capacity() const;
+
+            /**
+             * Computes the key of the cache entry for the given encoded texture data.
+             */
+            static uint64_t computeKey(const char* begin, const char* end);
+
+            /**
+             * Reads the cache entry with the given key and returns a texture with the given name. Returns an empty
+             * optional if there is no such entry, if the entry was written for data of a different size or if it
+             * cannot be read.
+             *
+             * @param key the key, see computeKey
+             * @param dataSize the size of the encoded texture data that the key was computed for
+             * @param name the name of the returned texture
+             */
+            std::optional<Assets::Texture> readTexture(uint64_t key, size_t dataSize, const std::string& name) const;
+
+            /**
+             * Writes the given texture to the cache and evicts the least recently used entries if the total size of
+             * the entries exceeds the capacity. The written entry is never evicted.
+             *
+             * @throws FileSystemException if the entry cannot be written
+             */
+            void writeTexture(uint64_t key, size_t dataSize, const Assets::Texture& texture) const;
+        private:
+            Path entryPath(uint64_t key) const;
+
+            /**
+             * Deletes the least recently used entries except for the one at the given path until the total size of
+             * the entries does not exceed the capacity. Must be called with m_sizeMutex locked.
+             */
+            void evictEntries(const Path& keepPath) const;
+        };
+    }
+}
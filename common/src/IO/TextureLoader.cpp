@@ -40,9 +40,18 @@
 
 namespace TrenchBroom {
     namespace IO {
-        TextureLoader::TextureLoader(const FileSystem& gameFS, const std::vector<IO::Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, Logger& logger) :
+        static bool needsPalette(const Model::TextureConfig& textureConfig) {
+            return textureConfig.format.format == "idmip" || textureConfig.format.format == "wal";
+        }
+
+        TextureLoader::TextureLoader(const FileSystem& gameFS, const std::vector<IO::Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, Logger& logger, std::shared_ptr<TextureCache> textureCache) :
+        m_gameFS(gameFS),
+        m_fileSearchPaths(fileSearchPaths),
+        m_textureConfig(std::make_unique<Model::TextureConfig>(textureConfig)),
+        m_palette(std::make_unique<Assets::Palette>(needsPalette(textureConfig) ? loadPalette(gameFS, textureConfig, logger) : Assets::Palette())),
+        m_textureCache(std::move(textureCache)),
         m_textureExtensions(getTextureExtensions(textureConfig)),
-        m_textureReader(createTextureReader(gameFS, textureConfig, logger)),
+        m_textureReader(createTextureReader(gameFS, textureConfig, *m_palette, logger, m_textureCache)),
         m_textureCollectionLoader(createTextureCollectionLoader(gameFS, fileSearchPaths, textureConfig, logger)) {
             ensure(m_textureReader != nullptr, "textureReader is null");
             ensure(m_textureCollectionLoader != nullptr, "textureCollectionLoader is null");
@@ -54,18 +63,20 @@ namespace TrenchBroom {
             return textureConfig.format.extensions;
         }
 
-        std::unique_ptr<TextureReader> TextureLoader::createTextureReader(const FileSystem& gameFS, const Model::TextureConfig& textureConfig, Logger& logger) {
+        std::unique_ptr<TextureReader> TextureLoader::createTextureReader(const FileSystem& gameFS, const Model::TextureConfig& textureConfig, const Assets::Palette& palette, Logger& logger, std::shared_ptr<TextureCache> textureCache) {
             const auto prefixLength = textureConfig.package.rootDirectory.length();
             const TextureReader::PathSuffixNameStrategy nameStrategy(prefixLength);
             
             if (textureConfig.format.format == "idmip") {
-                return std::make_unique<IdMipTextureReader>(nameStrategy, gameFS, logger, loadPalette(gameFS, textureConfig, logger));
+                return std::make_unique<IdMipTextureReader>(nameStrategy, gameFS, logger, palette);
             } else if (textureConfig.format.format == "hlmip") {
                 return std::make_unique<HlMipTextureReader>(nameStrategy, gameFS, logger);
             } else if (textureConfig.format.format == "wal") {
-                return std::make_unique<WalTextureReader>(nameStrategy, gameFS, logger, loadPalette(gameFS, textureConfig, logger));
+                return std::make_unique<WalTextureReader>(nameStrategy, gameFS, logger, palette);
             } else if (textureConfig.format.format == "image") {
-                return std::make_unique<FreeImageTextureReader>(nameStrategy, gameFS, logger);
+                auto reader = std::make_unique<FreeImageTextureReader>(nameStrategy, gameFS, logger);
+                reader->setCache(std::move(textureCache));
+                return reader;
             } else if (textureConfig.format.format == "q3shader") {
                 return std::make_unique<Quake3ShaderTextureReader>(nameStrategy, gameFS, logger);
             } else if (textureConfig.format.format == "m8") {
@@ -107,6 +118,12 @@ namespace TrenchBroom {
             return m_textureCollectionLoader->loadTextureCollection(path, m_textureExtensions, *m_textureReader);
         }
 
+        Assets::TextureCollection TextureLoader::loadTextureCollection(const Path& path, Logger& logger) const {
+            const auto textureReader = createTextureReader(m_gameFS, *m_textureConfig, *m_palette, logger, m_textureCache);
+            const auto textureCollectionLoader = createTextureCollectionLoader(m_gameFS, m_fileSearchPaths, *m_textureConfig, logger);
+            return textureCollectionLoader->loadTextureCollection(path, m_textureExtensions, *textureReader);
+        }
+
         void TextureLoader::loadTextures(const std::vector<Path>& paths, Assets::TextureManager& textureManager) {
             textureManager.setTextureCollections(paths, *this);
         }
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "Macros.h"
+#include "IO/Path.h"
 
 #include <memory>
 #include <string>
@@ -41,24 +42,41 @@ namespace TrenchBroom {
     namespace IO {
         class FileSystem;
         class Path;
+        class TextureCache;
         class TextureCollectionLoader;
         class TextureReader;
 
         class TextureLoader {
         private:
+            const FileSystem& m_gameFS;
+            std::vector<Path> m_fileSearchPaths;
+            std::unique_ptr<Model::TextureConfig> m_textureConfig;
+            std::unique_ptr<Assets::Palette> m_palette;
+            std::shared_ptr<TextureCache> m_textureCache;
+
             std::vector<std::string> m_textureExtensions;
             std::unique_ptr<TextureReader> m_textureReader;
             std::unique_ptr<TextureCollectionLoader> m_textureCollectionLoader;
         public:
-            TextureLoader(const FileSystem& gameFS, const std::vector<Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, Logger& logger);
+            /**
+             * Creates a loader for the given texture configuration. If a texture cache is given, readers that decode
+             * expensive image formats look up decoded textures in it.
+             */
+            TextureLoader(const FileSystem& gameFS, const std::vector<Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, Logger& logger, std::shared_ptr<TextureCache> textureCache = nullptr);
             ~TextureLoader();
         private:
             static std::vector<std::string> getTextureExtensions(const Model::TextureConfig& textureConfig);
-            static std::unique_ptr<TextureReader> createTextureReader(const FileSystem& gameFS, const Model::TextureConfig& textureConfig, Logger& logger);
+            static std::unique_ptr<TextureReader> createTextureReader(const FileSystem& gameFS, const Model::TextureConfig& textureConfig, const Assets::Palette& palette, Logger& logger, std::shared_ptr<TextureCache> textureCache);
             static Assets::Palette loadPalette(const FileSystem& gameFS, const Model::TextureConfig& textureConfig, Logger& logger);
             static std::unique_ptr<TextureCollectionLoader> createTextureCollectionLoader(const FileSystem& gameFS, const std::vector<Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, Logger& logger);
         public:
             Assets::TextureCollection loadTextureCollection(const Path& path);
+
+            /**
+             * Loads the texture collection at the given path and logs to the given logger instead of the logger that
+             * was passed to the constructor. Every call creates its own readers, so this may be called concurrently.
+             */
+            Assets::TextureCollection loadTextureCollection(const Path& path, Logger& logger) const;
             void loadTextures(const std::vector<Path>& paths, Assets::TextureManager& textureManager);
 
             deleteCopyAndMove(TextureLoader)
@@ -20,7 +20,13 @@
 #pragma once
 
 #include <cassert>
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
 #include <string>
+#include <string_view>
+#include <system_error>
 
 #include <kdl/string_utils.h>
 
@@ -74,6 +80,13 @@ namespace TrenchBroom {
                 return std::string(m_begin, length());
             }
 
+            /**
+             * Returns a view of the token data. The view is only valid as long as the tokenized source is valid.
+             */
+            std::string_view view() const {
+                return std::string_view(m_begin, length());
+            }
+
             size_t position() const {
                 return m_position;
             }
@@ -92,12 +105,42 @@ namespace TrenchBroom {
 
             template <typename T>
             T toFloat() const {
-                return static_cast<T>(kdl::str_to_double(std::string(m_begin, m_end)).value_or(0.0));
+                // Map files contain millions of numbers, so the token is parsed from a null terminated copy on the
+                // stack rather than from a temporary string. Floating point std::from_chars is not available on all
+                // supported platforms.
+                constexpr auto BufferSize = size_t(64);
+                const auto length = static_cast<size_t>(m_end - m_begin);
+                if (length >= BufferSize) {
+                    return static_cast<T>(kdl::str_to_double(std::string(m_begin, m_end)).value_or(0.0));
+                }
+
+                char buffer[BufferSize];
+                std::memcpy(buffer, m_begin, length);
+                buffer[length] = '\0';
+
+                // like kdl::str_to_double, return 0 if the token is not a number or out of range
+                char* end = nullptr;
+                errno = 0;
+                const auto value = std::strtod(buffer, &end);
+                if (end == buffer || errno == ERANGE) {
+                    return static_cast<T>(0.0);
+                }
+                return static_cast<T>(value);
             }
 
             template <typename T>
             T toInteger() const {
-                return static_cast<T>(kdl::str_to_long(std::string(m_begin, m_end)).value_or(0l));
+                // std::from_chars does not accept a leading plus sign
+                const auto* begin = m_begin;
+                if (m_end - begin > 1 && *begin == '+' && *(begin + 1) >= '0' && *(begin + 1) <= '9') {
+                    ++begin;
+                }
+
+                auto value = 0l;
+                if (std::from_chars(begin, m_end, value).ec != std::errc{}) {
+                    return static_cast<T>(0l);
+                }
+                return static_cast<T>(value);
             }
         };
     }
@@ -19,8 +19,10 @@
 
 #include "WorldReader.h"
 
+#include "AllocationCounting.h"
 #include "IO/ParserStatus.h"
 #include "Color.h"
+#include "Profiler.h"
 #include "Model/BrushNode.h"
 #include "Model/Entity.h"
 #include "Model/EntityProperties.h"
@@ -86,13 +88,31 @@ namespace TrenchBroom {
         }
 
         std::unique_ptr<Model::WorldNode> WorldReader::read(const vm::bbox3& worldBounds, ParserStatus& status) {
+            TB_PROFILE_SCOPE("WorldReader::read");
+            const auto allocationScope = AllocationScope{AllocationTag::IO};
             readEntities(worldBounds, status);
             sanitizeLayerSortIndicies(status);
-            m_world->rebuildNodeTree();
+            {
+                TB_PROFILE_SCOPE("WorldNode::rebuildNodeTree");
+                m_world->rebuildNodeTree();
+            }
             m_world->enableNodeTreeUpdates();
             return std::move(m_world);
         }
 
+        std::tuple<std::unique_ptr<Model::WorldNode>, std::optional<std::string>> WorldReader::read(const vm::bbox3& worldBounds, const std::string_view cacheData, ParserStatus& status) {
+            TB_PROFILE_SCOPE("WorldReader::read");
+            const auto allocationScope = AllocationScope{AllocationTag::IO};
+            auto newCacheData = readEntities(worldBounds, cacheData, status);
+            sanitizeLayerSortIndicies(status);
+            {
+                TB_PROFILE_SCOPE("WorldNode::rebuildNodeTree");
+                m_world->rebuildNodeTree();
+            }
+            m_world->enableNodeTreeUpdates();
+            return {std::move(m_world), std::move(newCacheData)};
+        }
+
         /**
          * Sanitizes the sort indices of custom layers:
          * Ensures there are no duplicates or sort indices less than 0.
@@ -23,7 +23,9 @@
 #include "IO/MapReader.h"
 
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <vector>
 
@@ -51,6 +53,13 @@ namespace TrenchBroom {
 
             std::unique_ptr<Model::WorldNode> read(const vm::bbox3& worldBounds, ParserStatus& status);
 
+            /**
+             * Like read, but restores the parsed data from the given cache data if it is valid for the source string.
+             *
+             * @return the world node and the new cache data, which is empty if the given cache data was used
+             */
+            std::tuple<std::unique_ptr<Model::WorldNode>, std::optional<std::string>> read(const vm::bbox3& worldBounds, std::string_view cacheData, ParserStatus& status);
+
             /**
              * Try to parse the given string as the given map formats, in order.
              * Returns the world if parsing is successful, otherwise throws an exception.
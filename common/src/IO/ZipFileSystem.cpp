@@ -19,37 +19,48 @@
 
 #include "ZipFileSystem.h"
 
+#include "Exceptions.h"
 #include "IO/File.h"
 #include "IO/DiskFileSystem.h"
+#include "IO/Reader.h"
 
+#include <miniz/miniz.h>
+
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 
 namespace TrenchBroom {
     namespace IO {
+        namespace ZipLayout {
+            static const size_t   LocalHeaderLength               = 0x1E;
+            static const size_t   LocalHeaderFilenameLengthOffset = 0x1A;
+            static const uint32_t LocalHeaderSignature            = 0x04034b50;
+        }
+
         // ZipFileSystem::ZipCompressedFile
 
-        ZipFileSystem::ZipCompressedFile::ZipCompressedFile(ZipFileSystem* owner, const mz_uint fileIndex) :
-        m_owner(owner),
-        m_fileIndex(fileIndex) {}
+        ZipFileSystem::ZipCompressedFile::ZipCompressedFile(std::shared_ptr<File> file, const size_t uncompressedSize, const uint32_t checksum) :
+        CompressedFileEntry(std::move(file), uncompressedSize),
+        m_checksum(checksum) {}
 
-        std::shared_ptr<File> ZipFileSystem::ZipCompressedFile::doOpen() const {
-            const auto path = Path(m_owner->filename(m_fileIndex));
+        std::unique_ptr<char[]> ZipFileSystem::ZipCompressedFile::decompress(std::shared_ptr<File> file, const size_t uncompressedSize) const {
+            const auto reader = file->reader().buffer();
+            const auto compressedData = reader.stringView();
 
-            mz_zip_archive_file_stat stat;
-            if (!mz_zip_reader_file_stat(&m_owner->m_archive, m_fileIndex, &stat)) {
-                throw FileSystemException("mz_zip_reader_file_stat failed for " + path.asString());
+            auto result = std::make_unique<char[]>(uncompressedSize);
+            const auto size = tinfl_decompress_mem_to_mem(result.get(), uncompressedSize, compressedData.data(), compressedData.size(), 0);
+            if (size != uncompressedSize) {
+                throw FileSystemException("Could not decompress " + file->path().asString());
             }
 
-            const auto uncompressedSize = static_cast<size_t>(stat.m_uncomp_size);
-            auto data = std::make_unique<char[]>(uncompressedSize);
-            auto* begin = data.get();
-
-            if (!mz_zip_reader_extract_to_mem(&m_owner->m_archive, m_fileIndex, begin, uncompressedSize, 0)) {
-                throw FileSystemException("mz_zip_reader_extract_to_mem failed for " + path.asString());
+            const auto checksum = mz_crc32(MZ_CRC32_INIT, reinterpret_cast<const unsigned char*>(result.get()), uncompressedSize);
+            if (checksum != m_checksum) {
+                throw FileSystemException("Checksum mismatch for " + file->path().asString());
             }
 
-            return std::make_shared<OwningBufferFile>(path, std::move(data), uncompressedSize);
+            return result;
         }
 
         // ZipFileSystem
@@ -58,41 +69,45 @@ namespace TrenchBroom {
         ZipFileSystem(nullptr, path) {}
 
         ZipFileSystem::ZipFileSystem(std::shared_ptr<FileSystem> next, const Path& path) :
-        ImageFileSystem(std::move(next), path) {
+        ZipFileSystem(std::move(next), path, {}) {}
+
+        ZipFileSystem::ZipFileSystem(std::shared_ptr<FileSystem> next, const Path& path, std::vector<Entry> entries) :
+        ImageFileSystem(std::move(next), path),
+        m_entries(std::move(entries)) {
             initialize();
         }
 
-        ZipFileSystem::~ZipFileSystem() {
-            mz_zip_reader_end(&m_archive);
+        const std::vector<ZipFileSystem::Entry>& ZipFileSystem::entries() const {
+            return m_entries;
         }
 
         void ZipFileSystem::doReadDirectory() {
-            mz_zip_zero_struct(&m_archive);
-
-            if (mz_zip_reader_init_cfile(&m_archive, m_file->file(), m_file->size(), 0) != MZ_TRUE) {
-                throw FileSystemException("Error calling mz_zip_reader_init_cfile");
+            if (m_entries.empty()) {
+                m_entries = readEntries();
             }
 
-            const mz_uint numFiles = mz_zip_reader_get_num_files(&m_archive);
-            for (mz_uint i = 0; i < numFiles; ++i) {
-                if (!mz_zip_reader_is_file_a_directory(&m_archive, i)) {
-                    const auto path = Path(filename(i));
-                    m_root.addFile(path, std::make_unique<ZipCompressedFile>(this, i));
+            for (const auto& entry : m_entries) {
+                const auto path = Path(entry.name);
+                if (entry.dataOffset + entry.compressedSize > m_file->size()) {
+                    throw FileSystemException("Invalid data location for " + path.asString());
                 }
-            }
 
-            const auto err = mz_zip_get_last_error(&m_archive);
-            if (err != MZ_ZIP_NO_ERROR) {
-                throw FileSystemException(std::string("Error while reading compressed file: ") + mz_zip_get_error_string(err));
+                // the data of a file is accessed directly in the mapped archive
+                auto entryFile = std::make_shared<FileView>(path, m_file, entry.dataOffset, entry.compressedSize);
+                if (entry.compressed) {
+                    m_root.addFile(path, std::make_unique<ZipCompressedFile>(std::move(entryFile), entry.uncompressedSize, entry.checksum));
+                } else {
+                    m_root.addFile(path, std::move(entryFile));
+                }
             }
         }
 
         /**
          * Helper to get the filename of a file in the zip archive
          */
-        std::string ZipFileSystem::filename(const mz_uint fileIndex) {
+        static std::string filename(mz_zip_archive& archive, const mz_uint fileIndex) {
             // nameLen includes space for the null-terminator byte
-            const mz_uint nameLen = mz_zip_reader_get_filename(&m_archive, fileIndex, nullptr, 0);
+            const mz_uint nameLen = mz_zip_reader_get_filename(&archive, fileIndex, nullptr, 0);
             if (nameLen == 0) {
                 return "";
             }
@@ -101,7 +116,78 @@ namespace TrenchBroom {
             result.resize(static_cast<size_t>(nameLen - 1));
 
             // NOTE: this will overwrite the std::string's null terminator, which is permitted in C++17 and later
-            mz_zip_reader_get_filename(&m_archive, fileIndex, result.data(), nameLen);
+            mz_zip_reader_get_filename(&archive, fileIndex, result.data(), nameLen);
+
+            return result;
+        }
+
+        /**
+         * Returns the offset of the data of the given file in the archive, which follows its local header.
+         */
+        static std::optional<size_t> dataOffset(const MappedFile& archiveFile, const mz_zip_archive_file_stat& stat) {
+            const auto headerOffset = static_cast<size_t>(stat.m_local_header_ofs);
+            if (headerOffset + ZipLayout::LocalHeaderLength > archiveFile.size()) {
+                return std::nullopt;
+            }
+
+            auto reader = archiveFile.reader();
+            reader.seekFromBegin(headerOffset);
+            if (reader.readUnsignedInt<uint32_t>() != ZipLayout::LocalHeaderSignature) {
+                return std::nullopt;
+            }
+
+            // the lengths of the file name and the extra field follow each other
+            reader.seekFromBegin(headerOffset + ZipLayout::LocalHeaderFilenameLengthOffset);
+            const auto filenameLength = reader.readSize<uint16_t>();
+            const auto extraFieldLength = reader.readSize<uint16_t>();
+
+            const auto offset = headerOffset + ZipLayout::LocalHeaderLength + filenameLength + extraFieldLength;
+            if (offset + static_cast<size_t>(stat.m_comp_size) > archiveFile.size()) {
+                return std::nullopt;
+            }
+            return offset;
+        }
+
+        std::vector<ZipFileSystem::Entry> ZipFileSystem::readEntries() const {
+            mz_zip_archive archive;
+            mz_zip_zero_struct(&archive);
+
+            if (mz_zip_reader_init_mem(&archive, m_file->begin(), m_file->size(), 0) != MZ_TRUE) {
+                throw FileSystemException("Error calling mz_zip_reader_init_mem");
+            }
+
+            auto result = std::vector<Entry>{};
+
+            const mz_uint numFiles = mz_zip_reader_get_num_files(&archive);
+            for (mz_uint i = 0; i < numFiles; ++i) {
+                mz_zip_archive_file_stat stat;
+                if (mz_zip_reader_is_file_a_directory(&archive, i) || !mz_zip_reader_file_stat(&archive, i, &stat)) {
+                    continue;
+                }
+
+                // only stored and deflated files can be read
+                const auto compressed = stat.m_method == MZ_DEFLATED;
+                if (stat.m_is_encrypted || (!compressed && stat.m_method != 0)) {
+                    continue;
+                }
+
+                if (const auto offset = dataOffset(*m_file, stat)) {
+                    result.push_back(Entry{
+                        filename(archive, i),
+                        *offset,
+                        static_cast<size_t>(stat.m_comp_size),
+                        static_cast<size_t>(stat.m_uncomp_size),
+                        static_cast<uint32_t>(stat.m_crc32),
+                        compressed});
+                }
+            }
+
+            const auto err = mz_zip_get_last_error(&archive);
+            mz_zip_reader_end(&archive);
+
+            if (err != MZ_ZIP_NO_ERROR) {
+                throw FileSystemException(std::string("Error while reading compressed file: ") + mz_zip_get_error_string(err));
+            }
 
             return result;
         }
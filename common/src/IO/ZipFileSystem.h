@@ -21,37 +21,54 @@
 
 #include "IO/ImageFileSystem.h"
 
+#include <cstdint>
 #include <memory>
-
-#include <miniz/miniz.h>
+#include <string>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
         class Path;
 
         class ZipFileSystem : public ImageFileSystem {
+        public:
+            /**
+             * A file in the archive together with the location of its data. Entries are read from the central
+             * directory of the archive, or they can be passed in if they were read from the same archive before.
+             */
+            struct Entry {
+                std::string name;
+                size_t dataOffset;
+                size_t compressedSize;
+                size_t uncompressedSize;
+                uint32_t checksum;
+                bool compressed;
+            };
         private:
-            mz_zip_archive m_archive;
-        private:
-            class ZipCompressedFile : public FileEntry {
+            class ZipCompressedFile : public CompressedFileEntry {
             private:
-                ZipFileSystem* m_owner;
-                mz_uint m_fileIndex;
+                uint32_t m_checksum;
             public:
-                ZipCompressedFile(ZipFileSystem* owner, mz_uint fileIndex);
+                ZipCompressedFile(std::shared_ptr<File> file, size_t uncompressedSize, uint32_t checksum);
             private:
-                std::shared_ptr<File> doOpen() const override;
+                std::unique_ptr<char[]> decompress(std::shared_ptr<File> file, size_t uncompressedSize) const override;
             };
-            friend class ZipCompressedFile;
+
+            std::vector<Entry> m_entries;
         public:
             explicit ZipFileSystem(const Path& path);
             ZipFileSystem(std::shared_ptr<FileSystem> next, const Path& path);
-            ~ZipFileSystem() override;
+
+            /**
+             * Creates a file system for the archive at the given path without reading its central directory. The
+             * given entries must have been read from the same unchanged archive.
+             */
+            ZipFileSystem(std::shared_ptr<FileSystem> next, const Path& path, std::vector<Entry> entries);
+
+            const std::vector<Entry>& entries() const;
         private:
             void doReadDirectory() override;
-        private:
-            std::string filename(mz_uint fileIndex);
+            std::vector<Entry> readEntries() const;
         };
     }
 }
-
@@ -26,6 +26,7 @@
 #include "Model/BrushError.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushGeometry.h"
+#include "Model/InternedString.h"
 #include "Model/MapFormat.h"
 #include "Model/TexCoordSystem.h"
 
@@ -34,6 +35,7 @@
 #include <kdl/string_utils.h>
 #include <kdl/vector_utils.h>
 
+#include <vecmath/constants.h>
 #include <vecmath/intersection.h>
 #include <vecmath/vec.h>
 #include <vecmath/vec_ext.h>
@@ -44,6 +46,7 @@
 #include <vecmath/util.h>
 
 #include <iterator>
+#include <optional>
 #include <set>
 #include <string>
 #include <vector>
@@ -51,25 +54,14 @@
 
 namespace TrenchBroom {
     namespace Model {
-        class Brush::CopyCallback : public BrushGeometry::CopyCallback {
-        public:
-            void faceWasCopied(const BrushFaceGeometry* original, BrushFaceGeometry* copy) const override {
-                copy->setPayload(original->payload());
-            }
-        };
-
         Brush::Brush() {}
 
         Brush::Brush(const Brush& other) :
         m_faces(other.m_faces),
-        m_geometry(other.m_geometry ? std::make_unique<BrushGeometry>(*other.m_geometry, CopyCallback()) : nullptr) {
-            if (m_geometry) {
-                for (BrushFaceGeometry* faceGeometry : m_geometry->faces()) {
-                    if (const auto faceIndex = faceGeometry->payload()) {
-                        BrushFace& face = m_faces[*faceIndex];
-                        face.setGeometry(faceGeometry);
-                    }
-                }
+        m_geometry(other.m_geometry) {
+            // copying a face does not copy its geometry link, but the copied faces share the geometry with the original
+            for (size_t i = 0u; i < m_faces.size(); ++i) {
+                m_faces[i].setGeometry(other.m_faces[i].geometry());
             }
         }
 
@@ -100,21 +92,71 @@ namespace TrenchBroom {
                 .and_then([&]() { return std::move(brush); });
         }
 
+        /**
+         * Checks whether the given faces bound an axis aligned cuboid that lies strictly within the given world bounds
+         * and returns its bounds if so. The vertices of such a brush are the intersections of its face planes, which
+         * can be read off the plane distances directly, so there is no need to clip the world bounds with every face.
+         *
+         * Expects that the given faces are sorted.
+         */
+        static std::optional<vm::bbox3> axisAlignedCuboidBounds(const std::vector<BrushFace>& faces, const vm::bbox3& worldBounds) {
+            if (faces.size() != 6u) {
+                return std::nullopt;
+            }
+
+            // the sorted normals of an axis aligned cuboid
+            static const vm::vec3 normals[] = {
+                vm::vec3::neg_x(), vm::vec3::neg_y(), vm::vec3::neg_z(),
+                vm::vec3::pos_z(), vm::vec3::pos_y(), vm::vec3::pos_x()
+            };
+
+            for (size_t i = 0u; i < faces.size(); ++i) {
+                if (faces[i].boundary().normal != normals[i]) {
+                    return std::nullopt;
+                }
+            }
+
+            const auto min = vm::vec3(-faces[0].boundary().distance, -faces[1].boundary().distance, -faces[2].boundary().distance);
+            const auto max = vm::vec3( faces[5].boundary().distance,  faces[4].boundary().distance,  faces[3].boundary().distance);
+
+            // empty brushes and brushes touching the world bounds are left to the clipping algorithm
+            const auto epsilon = vm::constants<FloatType>::point_status_epsilon();
+            for (size_t i = 0u; i < 3u; ++i) {
+                if (!(worldBounds.min[i] + epsilon < min[i] && min[i] < max[i] && max[i] < worldBounds.max[i] - epsilon)) {
+                    return std::nullopt;
+                }
+            }
+
+            return vm::bbox3(min, max);
+        }
+
         kdl::result<void, BrushError> Brush::updateGeometryFromFaces(const vm::bbox3& worldBounds) {
             // First, add all faces to the brush geometry
             BrushFace::sortFaces(m_faces);
-            
-            auto geometry = std::make_unique<BrushGeometry>(worldBounds);
-            
-            for (size_t i = 0u; i < m_faces.size(); ++i) {
-                BrushFace& face = m_faces[i];
-                const auto result = geometry->clip(face.boundary());
-                if (result.success()) {
-                    BrushFaceGeometry* faceGeometry = result.face();
-                    face.setGeometry(faceGeometry);
-                    faceGeometry->setPayload(i);
-                } else  if (result.empty()) {
-                    return BrushError::EmptyBrush;
+
+            const auto cuboidBounds = axisAlignedCuboidBounds(m_faces, worldBounds);
+
+            std::unique_ptr<BrushGeometry> geometry;
+            if (cuboidBounds) {
+                geometry = std::make_unique<BrushGeometry>(*cuboidBounds);
+
+                for (BrushFaceGeometry* faceGeometry : geometry->faces()) {
+                    const auto faceIndex = findFace(faceGeometry->plane().normal);
+                    assert(faceIndex);
+
+                    faceGeometry->setPayload(*faceIndex);
+                }
+            } else {
+                geometry = std::make_unique<BrushGeometry>(worldBounds);
+
+                for (size_t i = 0u; i < m_faces.size(); ++i) {
+                    const auto result = geometry->clip(m_faces[i].boundary());
+                    if (result.success()) {
+                        BrushFaceGeometry* faceGeometry = result.face();
+                        faceGeometry->setPayload(i);
+                    } else  if (result.empty()) {
+                        return BrushError::EmptyBrush;
+                    }
                 }
             }
 
@@ -123,7 +165,23 @@ namespace TrenchBroom {
             if (!geometry->healEdges()) {
                 return BrushError::InvalidBrush;
             }
-            
+
+            // Link the faces to their geometry only now because clipping and healing change the face boundaries, and
+            // the faces cache their vertex positions
+            for (BrushFaceGeometry* faceGeometry : geometry->faces()) {
+                if (const auto faceIndex = faceGeometry->payload()) {
+                    m_faces[*faceIndex].setGeometry(faceGeometry);
+                }
+            }
+
+            if (cuboidBounds && geometry->faceCount() == m_faces.size()) {
+                // Keep the faces in their sorted order, which is the order in which clipping the world bounds would
+                // have produced them.
+                m_geometry = std::move(geometry);
+                assert(checkFaceLinks());
+                return kdl::void_success;
+            }
+
             // Now collect all faces which still remain
             std::vector<BrushFace> remainingFaces;
             remainingFaces.reserve(m_faces.size());
@@ -151,7 +209,8 @@ namespace TrenchBroom {
         }
 
         std::optional<size_t> Brush::findFace(const std::string& textureName) const {
-            return kdl::vec_index_of(m_faces, [&](const BrushFace& face) { return face.attributes().textureName() == textureName; });
+            const auto internedTextureName = InternedString(textureName);
+            return kdl::vec_index_of(m_faces, [&](const BrushFace& face) { return face.attributes().internedTextureName() == internedTextureName; });
         }
 
         std::optional<size_t> Brush::findFace(const vm::vec3& normal) const {
@@ -213,6 +272,18 @@ namespace TrenchBroom {
             return true;
         }
 
+        size_t Brush::memoryUsage() const {
+            auto result = sizeof(Brush) + m_faces.capacity() * sizeof(BrushFace);
+            if (m_geometry) {
+                const auto geometrySize = sizeof(BrushGeometry)
+                    + m_geometry->vertexCount() * sizeof(BrushVertex)
+                    + m_geometry->edgeCount() * (sizeof(BrushEdge) + 2u * sizeof(BrushHalfEdge))
+                    + m_geometry->faceCount() * sizeof(BrushFaceGeometry);
+                result += geometrySize / static_cast<size_t>(m_geometry.use_count());
+            }
+            return result;
+        }
+
         void Brush::cloneFaceAttributesFrom(const Brush& brush) {
             for (auto& destination : m_faces) {
                 if (const auto sourceIndex = brush.findFace(destination.boundary())) {
@@ -447,6 +518,19 @@ namespace TrenchBroom {
             return doMoveVertices(worldBounds, vertexPositions, delta, uvLock);
         }
 
+        kdl::result<bool, BrushError> Brush::moveVerticesIfPossible(const vm::bbox3& worldBounds, const std::vector<vm::vec3>& vertexPositions, const vm::vec3& delta, const bool uvLock) {
+            ensure(m_geometry != nullptr, "geometry is null");
+
+            const auto canMoveResult = doCanMoveVertices(worldBounds, vertexPositions, delta, true);
+            if (!canMoveResult.success) {
+                return false;
+            }
+
+            // the geometry computed by the check is exactly the one doMoveVertices would build
+            return updateFacesFromMovedGeometry(worldBounds, vertexPositions, delta, *canMoveResult.geometry, uvLock)
+                .and_then([]() { return true; });
+        }
+
         bool Brush::canAddVertex(const vm::bbox3& worldBounds, const vm::vec3& position) const {
             ensure(m_geometry != nullptr, "geometry is null");
             if (!worldBounds.contains(position)) {
@@ -496,7 +580,10 @@ namespace TrenchBroom {
             return updateFacesFromGeometry(worldBounds, matcher, newGeometry);
         }
 
-        static BrushGeometry snappedGeometry(const BrushGeometry& geometry, const FloatType snapToF) {
+        /**
+         * Returns the snapped positions of the vertices of the given geometry, in the order of its vertices.
+         */
+        static std::vector<vm::vec3> snappedVertexPositions(const BrushGeometry& geometry, const FloatType snapToF) {
             std::vector<vm::vec3> points;
             points.reserve(geometry.vertexCount());
             
@@ -504,23 +591,50 @@ namespace TrenchBroom {
                 points.push_back(snapToF * vm::round(vertex->position() / snapToF));
             }
 
-            return BrushGeometry(std::move(points));
+            return points;
+        }
+
+        static BrushGeometry snappedGeometry(const BrushGeometry& geometry, const FloatType snapToF) {
+            return BrushGeometry(snappedVertexPositions(geometry, snapToF));
         }
         
+        bool Brush::hasSnappedVertices(const FloatType snapToF) const {
+            ensure(m_geometry != nullptr, "geometry is null");
+
+            for (const auto* vertex : m_geometry->vertices()) {
+                const auto& position = vertex->position();
+                if (snapToF * vm::round(position / snapToF) != position) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
         bool Brush::canSnapVertices(const vm::bbox3& /* worldBounds */, const FloatType snapToF) const {
             ensure(m_geometry != nullptr, "geometry is null");
-            return snappedGeometry(*m_geometry, snapToF).polyhedron();
+            return hasSnappedVertices(snapToF) || snappedGeometry(*m_geometry, snapToF).polyhedron();
         }
 
         kdl::result<void, BrushError> Brush::snapVertices(const vm::bbox3& worldBounds, const FloatType snapToF, const bool uvLock) {
             ensure(m_geometry != nullptr, "geometry is null");
+
+            // rebuilding the geometry is expensive, and nothing would change
+            if (hasSnappedVertices(snapToF)) {
+                return kdl::void_success;
+            }
             
-            const BrushGeometry newGeometry = snappedGeometry(*m_geometry, snapToF);
+            // the snapped positions are needed twice, for building the new geometry and for mapping the vertices
+            const auto snappedPositions = snappedVertexPositions(*m_geometry, snapToF);
+            const BrushGeometry newGeometry(snappedPositions);
+            if (!newGeometry.polyhedron()) {
+                return BrushError::InvalidBrush;
+            }
 
             std::map<vm::vec3,vm::vec3> vertexMapping;
+            auto snappedPosition = std::begin(snappedPositions);
             for (const auto* vertex : m_geometry->vertices()) {
                 const auto& origin = vertex->position();
-                const auto destination = snapToF * round(origin / snapToF);
+                const auto& destination = *snappedPosition++;
                 if (newGeometry.hasVertex(destination)) {
                     vertexMapping.insert(std::make_pair(origin, destination));
                 }
@@ -728,25 +842,32 @@ namespace TrenchBroom {
             ensure(!vertexPositions.empty(), "no vertex positions");
             assert(canMoveVertices(worldBounds, vertexPositions, delta));
 
+            const auto vertexSet = std::set<vm::vec3>(std::begin(vertexPositions), std::end(vertexPositions));
+
             std::vector<vm::vec3> newVertices;
             newVertices.reserve(vertexCount());
             
             for (const auto* vertex : m_geometry->vertices()) {
                 const auto& position = vertex->position();
-                if (kdl::vec_contains(vertexPositions, position)) {
+                if (vertexSet.count(position)) {
                     newVertices.push_back(position + delta);
                 } else {
                     newVertices.push_back(position);
                 }
             }
             
-            BrushGeometry newGeometry(newVertices);
+            const BrushGeometry newGeometry(newVertices);
+            return updateFacesFromMovedGeometry(worldBounds, vertexPositions, delta, newGeometry, uvLock);
+        }
+
+        kdl::result<void, BrushError> Brush::updateFacesFromMovedGeometry(const vm::bbox3& worldBounds, const std::vector<vm::vec3>& vertexPositions, const vm::vec3& delta, const BrushGeometry& newGeometry, const bool uvLock) {
+            const auto vertexSet = std::set<vm::vec3>(std::begin(vertexPositions), std::end(vertexPositions));
 
             using VecMap = std::map<vm::vec3, vm::vec3>;
             VecMap vertexMapping;
             for (auto* oldVertex : m_geometry->vertices()) {
                 const auto& oldPosition = oldVertex->position();
-                const auto moved = kdl::vec_contains(vertexPositions, oldPosition);
+                const auto moved = vertexSet.count(oldPosition) > 0u;
                 const auto newPosition = moved ? oldPosition + delta : oldPosition;
                 const auto* newVertex = newGeometry.findClosestVertex(newPosition, CloseVertexEpsilon);
                 if (newVertex != nullptr) {
@@ -871,7 +992,13 @@ namespace TrenchBroom {
             for (const auto* subtrahend : subtrahends) {
                 auto nextResults = std::vector<BrushGeometry>{};
 
-                for (const BrushGeometry& fragment : result) {
+                for (BrushGeometry& fragment : result) {
+                    if (!fragment.bounds().intersects(subtrahend->bounds())) {
+                        // disjoint fragments are not affected by the subtrahend
+                        nextResults.push_back(std::move(fragment));
+                        continue;
+                    }
+
                     auto subFragments = fragment.subtract(*subtrahend->m_geometry);
                     nextResults = kdl::vec_concat(std::move(nextResults), std::move(subFragments));
                 }
@@ -908,8 +1035,15 @@ namespace TrenchBroom {
                 return false;
             }
 
-            for (const auto& vertex : bounds.vertices()) {
-                if (!containsPoint(vertex)) {
+            // The brush is convex, so it contains the box if no face has the box corner that lies farthest in the
+            // direction of the face normal above it. This tests one corner per face instead of all eight.
+            for (const auto& face : m_faces) {
+                const auto& plane = face.boundary();
+                const auto corner = vm::vec3(
+                    plane.normal.x() >= 0.0 ? bounds.max.x() : bounds.min.x(),
+                    plane.normal.y() >= 0.0 ? bounds.max.y() : bounds.min.y(),
+                    plane.normal.z() >= 0.0 ? bounds.max.z() : bounds.min.z());
+                if (plane.point_status(corner) == vm::plane_status::above) {
                     return false;
                 }
             }
@@ -41,8 +41,6 @@ namespace TrenchBroom {
 
         class Brush {
         private:
-            class CopyCallback;
-            
             /**
              * Epsilon value to use when finding a vertex after applying a vertex operation
              */
@@ -52,7 +50,11 @@ namespace TrenchBroom {
             using EdgeList = BrushEdgeList;
         private:
             std::vector<BrushFace> m_faces;
-            std::unique_ptr<BrushGeometry> m_geometry;
+            /**
+             * The geometry is never modified once it has been set, it is only ever replaced by a new geometry. This
+             * allows copies of a brush, such as the snapshots kept by the undo stack, to share it.
+             */
+            std::shared_ptr<const BrushGeometry> m_geometry;
         public:
             Brush();
 
@@ -86,6 +88,12 @@ namespace TrenchBroom {
 
             bool closed() const;
             bool fullySpecified() const;
+
+            /**
+             * Returns an estimate of the number of bytes used by this brush. If the geometry is shared with other
+             * brushes, only the corresponding fraction of its size is accounted for.
+             */
+            size_t memoryUsage() const;
         public: // clone face attributes from matching faces of other brushes
             void cloneFaceAttributesFrom(const Brush& brush);
             void cloneFaceAttributesFrom(const std::vector<const Brush*>& brushes);
@@ -143,13 +151,28 @@ namespace TrenchBroom {
             bool canMoveVertices(const vm::bbox3& worldBounds, const std::vector<vm::vec3>& vertices, const vm::vec3& delta) const;
             kdl::result<void, BrushError> moveVertices(const vm::bbox3& worldBounds, const std::vector<vm::vec3>& vertexPositions, const vm::vec3& delta, bool uvLock = false);
 
+            /**
+             * Moves the given vertices if canMoveVertices allows it and returns whether they were moved. This is
+             * equivalent to calling canMoveVertices followed by moveVertices, but builds the moved geometry only once.
+             */
+            kdl::result<bool, BrushError> moveVerticesIfPossible(const vm::bbox3& worldBounds, const std::vector<vm::vec3>& vertexPositions, const vm::vec3& delta, bool uvLock = false);
+
             bool canAddVertex(const vm::bbox3& worldBounds, const vm::vec3& position) const;
             kdl::result<void, BrushError> addVertex(const vm::bbox3& worldBounds, const vm::vec3& position);
 
             bool canRemoveVertices(const vm::bbox3& worldBounds, const std::vector<vm::vec3>& vertexPositions) const;
             kdl::result<void, BrushError> removeVertices(const vm::bbox3& worldBounds, const std::vector<vm::vec3>& vertexPositions);
 
+            /**
+             * Returns whether every vertex of this brush is a multiple of the given value, in which case snapping
+             * the vertices has no effect.
+             */
+            bool hasSnappedVertices(FloatType snapTo) const;
             bool canSnapVertices(const vm::bbox3& worldBounds, FloatType snapTo) const;
+            /**
+             * Snaps the vertices of this brush to multiples of the given value. Fails with BrushError::InvalidBrush
+             * if the snapped vertices don't form a valid brush, so it is not necessary to call canSnapVertices first.
+             */
             kdl::result<void, BrushError> snapVertices(const vm::bbox3& worldBounds, FloatType snapTo, bool uvLock = false);
 
             // edge operations
@@ -173,6 +196,7 @@ namespace TrenchBroom {
 
             CanMoveVerticesResult doCanMoveVertices(const vm::bbox3& worldBounds, const std::vector<vm::vec3>& vertexPositions, vm::vec3 delta, bool allowVertexRemoval) const;
             kdl::result<void, BrushError> doMoveVertices(const vm::bbox3& worldBounds, const std::vector<vm::vec3>& vertexPositions, const vm::vec3& delta, bool lockTexture);
+            kdl::result<void, BrushError> updateFacesFromMovedGeometry(const vm::bbox3& worldBounds, const std::vector<vm::vec3>& vertexPositions, const vm::vec3& delta, const BrushGeometry& newGeometry, bool lockTexture);
             /**
              * Tries to find 3 vertices in `left` and `right` that are related according to the PolyhedronMatcher, and
              * generates an affine transform for them which can then be used to implement UV lock.
@@ -80,6 +80,7 @@ namespace TrenchBroom {
         m_textureReference(std::move(other.m_textureReference)),
         m_texCoordSystem(std::move(other.m_texCoordSystem)),
         m_geometry(other.m_geometry),
+        m_vertexPositions(std::move(other.m_vertexPositions)),
         m_lineNumber(other.m_lineNumber),
         m_lineCount(other.m_lineCount),
         m_selected(other.m_selected),
@@ -100,6 +101,7 @@ namespace TrenchBroom {
             swap(lhs.m_textureReference, rhs.m_textureReference);
             swap(lhs.m_texCoordSystem, rhs.m_texCoordSystem);
             swap(lhs.m_geometry, rhs.m_geometry);
+            swap(lhs.m_vertexPositions, rhs.m_vertexPositions);
             swap(lhs.m_lineNumber, rhs.m_lineNumber);
             swap(lhs.m_lineCount, rhs.m_lineCount);
             swap(lhs.m_selected, rhs.m_selected);
@@ -256,8 +258,7 @@ namespace TrenchBroom {
 
         vm::vec3 BrushFace::center() const {
             ensure(m_geometry != nullptr, "geometry is null");
-            const BrushHalfEdgeList& boundary = m_geometry->boundary();
-            return vm::average(std::begin(boundary), std::end(boundary), BrushGeometry::GetVertexPosition());
+            return vm::average(std::begin(m_vertexPositions), std::end(m_vertexPositions), [](const vm::vec3& position) { return position; });
         }
 
         vm::vec3 BrushFace::boundsCenter() const {
@@ -602,9 +603,9 @@ namespace TrenchBroom {
             return VertexList(m_geometry->boundary(), TransformHalfEdgeToVertex());
         }
 
-        std::vector<vm::vec3> BrushFace::vertexPositions() const {
+        const std::vector<vm::vec3>& BrushFace::vertexPositions() const {
             ensure(m_geometry != nullptr, "geometry is null");
-            return m_geometry->vertexPositions();
+            return m_vertexPositions;
         }
 
         bool BrushFace::hasVertices(const vm::polygon3& vertices, const FloatType epsilon) const {
@@ -614,7 +615,7 @@ namespace TrenchBroom {
 
         vm::polygon3 BrushFace::polygon() const {
             ensure(m_geometry != nullptr, "geometry is null");
-            return vm::polygon3(vertexPositions());
+            return vm::polygon3(m_vertexPositions);
         }
 
         BrushFaceGeometry* BrushFace::geometry() const {
@@ -623,6 +624,15 @@ namespace TrenchBroom {
 
         void BrushFace::setGeometry(BrushFaceGeometry* geometry) {
             m_geometry = geometry;
+
+            // reuse the storage since faces usually keep their vertex count when their geometry is rebuilt
+            m_vertexPositions.clear();
+            if (m_geometry != nullptr) {
+                m_vertexPositions.reserve(m_geometry->boundary().size());
+                for (const BrushHalfEdge* halfEdge : m_geometry->boundary()) {
+                    m_vertexPositions.push_back(halfEdge->origin()->position());
+                }
+            }
         }
 
         size_t BrushFace::lineNumber() const {
@@ -652,6 +662,10 @@ namespace TrenchBroom {
             return m_texCoordSystem->getTexCoords(point, m_attributes, textureSize());
         }
 
+        TexCoordProjection BrushFace::texCoordProjection() const {
+            return m_texCoordSystem->texCoordProjection(m_attributes, textureSize());
+        }
+
         FloatType BrushFace::intersectWithRay(const vm::ray3& ray) const {
             ensure(m_geometry != nullptr, "geometry is null");
 
@@ -46,6 +46,7 @@ namespace TrenchBroom {
 
     namespace Model {
         class TexCoordSystem;
+        struct TexCoordProjection;
         class TexCoordSystemSnapshot;
         enum class WrapStyle;
         enum class BrushError;
@@ -89,6 +90,11 @@ namespace TrenchBroom {
             Assets::AssetReference<Assets::Texture> m_textureReference;
             std::unique_ptr<TexCoordSystem> m_texCoordSystem;
             BrushFaceGeometry* m_geometry;
+            /**
+             * The positions of the vertices of m_geometry in the order of its boundary, updated whenever the geometry
+             * is set.
+             */
+            std::vector<vm::vec3> m_vertexPositions;
 
             mutable size_t m_lineNumber;
             mutable size_t m_lineCount;
@@ -201,12 +207,16 @@ namespace TrenchBroom {
             size_t vertexCount() const;
             EdgeList edges() const;
             VertexList vertices() const;
-            std::vector<vm::vec3> vertexPositions() const;
+            const std::vector<vm::vec3>& vertexPositions() const;
 
             bool hasVertices(const vm::polygon3& vertices, FloatType epsilon = static_cast<FloatType>(0.0)) const;
             vm::polygon3 polygon() const;
         public:
             BrushFaceGeometry* geometry() const;
+            /**
+             * Sets the geometry of this face and caches its vertex positions. The given geometry must not be changed
+             * afterwards unless it is set again.
+             */
             void setGeometry(BrushFaceGeometry* geometry);
 
             size_t lineNumber() const;
@@ -217,6 +227,11 @@ namespace TrenchBroom {
             void deselect();
 
             vm::vec2f textureCoords(const vm::vec3& point) const;
+            /**
+             * Returns the texture projection of this face, which computes the same texture coordinates as
+             * textureCoords, but is cheaper when the coordinates of all vertices of this face are needed.
+             */
+            TexCoordProjection texCoordProjection() const;
 
             FloatType intersectWithRay(const vm::ray3& ray) const;
         private:
@@ -84,6 +84,10 @@ namespace TrenchBroom {
         }
 
         const std::string& BrushFaceAttributes::textureName() const {
+            return m_textureName.str();
+        }
+
+        const InternedString& BrushFaceAttributes::internedTextureName() const {
             return m_textureName;
         }
 
@@ -148,6 +152,10 @@ namespace TrenchBroom {
         }
         
         bool BrushFaceAttributes::setTextureName(const std::string& textureName) {
+            return setTextureName(InternedString(textureName));
+        }
+
+        bool BrushFaceAttributes::setTextureName(const InternedString& textureName) {
             if (textureName == m_textureName) {
                 return false;
             } else {
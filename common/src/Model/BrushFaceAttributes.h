@@ -20,6 +20,7 @@
 #pragma once
 
 #include "Color.h"
+#include "Model/InternedString.h"
 
 #include <vecmath/forward.h>
 
@@ -37,7 +38,7 @@ namespace TrenchBroom {
         public:
             static const std::string NoTextureName;
         private:
-            std::string m_textureName;
+            InternedString m_textureName;
 
             vm::vec2f m_offset;
             vm::vec2f m_scale;
@@ -59,6 +60,10 @@ namespace TrenchBroom {
             friend void swap(BrushFaceAttributes& lhs, BrushFaceAttributes& rhs);
 
             const std::string& textureName() const;
+            /**
+             * Returns the interned texture name, which can be compared with other interned names in constant time.
+             */
+            const InternedString& internedTextureName() const;
 
             const vm::vec2f& offset() const;
             float xOffset() const;
@@ -82,6 +87,7 @@ namespace TrenchBroom {
             bool valid() const;
 
             bool setTextureName(const std::string& textureName);
+            bool setTextureName(const InternedString& textureName);
             bool setOffset(const vm::vec2f& offset);
             bool setXOffset(float xOffset);
             bool setYOffset(float yOffset);
@@ -58,6 +58,7 @@
 
 #include <algorithm> // for std::remove
 #include <iterator>
+#include <limits>
 #include <set>
 #include <string>
 #include <vector>
@@ -129,11 +130,41 @@ namespace TrenchBroom {
             m_brush.face(faceIndex).updateTags(tagManager);
         }
 
-        void BrushNode::setFaceTexture(const size_t faceIndex, Assets::Texture* texture) {
-            m_brush.face(faceIndex).setTexture(texture);
-            
+        bool BrushNode::setFaceTexture(const size_t faceIndex, Assets::Texture* texture) {
+            if (!m_brush.face(faceIndex).setTexture(texture)) {
+                return false;
+            }
+
+            invalidateIssues();
+            invalidateVertexCache();
+            return true;
+        }
+
+        std::string BrushNode::setFaceTextureName(const size_t faceIndex, std::string textureName) {
+            auto& face = m_brush.face(faceIndex);
+            auto attributes = face.attributes();
+            auto oldTextureName = attributes.textureName();
+            attributes.setTextureName(std::move(textureName));
+            face.setAttributes(attributes);
+
+            invalidateIssues();
+            invalidateVertexCache();
+            return oldTextureName;
+        }
+
+        std::tuple<BrushFaceAttributes, std::unique_ptr<TexCoordSystemSnapshot>> BrushNode::setFaceAttributes(const size_t faceIndex, BrushFaceAttributes attributes, const TexCoordSystemSnapshot* texCoordSystemSnapshot) {
+            auto& face = m_brush.face(faceIndex);
+            auto oldAttributes = face.attributes();
+            auto oldTexCoordSystemSnapshot = face.takeTexCoordSystemSnapshot();
+
+            face.setAttributes(attributes);
+            if (texCoordSystemSnapshot) {
+                face.restoreTexCoordSystemSnapshot(*texCoordSystemSnapshot);
+            }
+
             invalidateIssues();
             invalidateVertexCache();
+            return {std::move(oldAttributes), std::move(oldTexCoordSystemSnapshot)};
         }
 
         static bool containsPatch(const Brush& brush, const PatchGrid& grid) {
@@ -321,16 +352,49 @@ namespace TrenchBroom {
         }
 
         std::optional<std::tuple<FloatType, size_t>> BrushNode::findFaceHit(const vm::ray3& ray) const {
-            if (!vm::is_nan(vm::intersect_ray_bbox(ray, logicalBounds()))) {
-                for (size_t i = 0u; i < m_brush.faceCount(); ++i) {
-                    const auto& face = m_brush.face(i);
-                    const auto distance = face.intersectWithRay(ray);
-                    if (!vm::is_nan(distance)) {
-                        return std::make_tuple(distance, i);
+            if (vm::is_nan(vm::intersect_ray_bbox(ray, logicalBounds()))) {
+                return std::nullopt;
+            }
+
+            // A brush is the intersection of the half spaces below its face planes, so instead of testing the ray
+            // against each face polygon, we clip it against the face planes. The ray enters the brush at the last
+            // plane it crosses from above and leaves it at the first plane it crosses from below. This only needs
+            // two dot products per face and no vertices at all.
+            auto enterDistance = -std::numeric_limits<FloatType>::infinity();
+            auto exitDistance = std::numeric_limits<FloatType>::infinity();
+            auto enterFaceIndex = m_brush.faceCount();
+
+            for (size_t i = 0u; i < m_brush.faceCount(); ++i) {
+                const auto& plane = m_brush.face(i).boundary();
+                const auto cos = vm::dot(plane.normal, ray.direction);
+                const auto originDistance = plane.point_distance(ray.origin);
+
+                if (cos == FloatType(0.0)) {
+                    if (originDistance > FloatType(0.0)) {
+                        // the ray is parallel to and above the plane
+                        return std::nullopt;
+                    }
+                } else {
+                    const auto distance = -originDistance / cos;
+                    if (cos < FloatType(0.0)) {
+                        if (distance > enterDistance) {
+                            enterDistance = distance;
+                            enterFaceIndex = i;
+                        }
+                    } else {
+                        exitDistance = std::min(exitDistance, distance);
+                    }
+                    if (enterDistance > exitDistance) {
+                        return std::nullopt;
                     }
                 }
             }
-            return std::nullopt;
+
+            // if the ray starts inside of the brush, it does not hit any face from the front
+            if (enterFaceIndex == m_brush.faceCount() || enterDistance < FloatType(0.0)) {
+                return std::nullopt;
+            }
+            return std::make_tuple(enterDistance, enterFaceIndex);
         }
 
         Node* BrushNode::doGetContainer() {
@@ -35,6 +35,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace TrenchBroom {
@@ -48,8 +49,10 @@ namespace TrenchBroom {
 
     namespace Model {
         class BrushFace;
+        class BrushFaceAttributes;
         class GroupNode;
         class LayerNode;
+        class TexCoordSystemSnapshot;
 
         class ModelFactory;
 
@@ -81,7 +84,27 @@ namespace TrenchBroom {
             
             void updateFaceTags(size_t faceIndex, TagManager& tagManager);
             
-            void setFaceTexture(size_t faceIndex, Assets::Texture* texture);
+            /**
+             * Sets the texture of the face with the given index. Returns true if the texture of the face has changed.
+             */
+            bool setFaceTexture(size_t faceIndex, Assets::Texture* texture);
+
+            /**
+             * Sets the texture name of the face with the given index and returns its previous texture name. The
+             * geometry of the brush is not affected, so this is much cheaper than replacing the entire brush.
+             *
+             * The caller is responsible for setting the face's texture afterwards.
+             */
+            std::string setFaceTextureName(size_t faceIndex, std::string textureName);
+
+            /**
+             * Sets the attributes of the face with the given index and restores its texture coordinate system from
+             * the given snapshot unless it is null. Returns the previous attributes and a snapshot of the previous
+             * texture coordinate system.
+             *
+             * The caller is responsible for setting the face's texture afterwards.
+             */
+            std::tuple<BrushFaceAttributes, std::unique_ptr<TexCoordSystemSnapshot>> setFaceAttributes(size_t faceIndex, BrushFaceAttributes attributes, const TexCoordSystemSnapshot* texCoordSystemSnapshot);
 
             bool contains(const Node* node) const;
             bool intersects(const Node* node) const;
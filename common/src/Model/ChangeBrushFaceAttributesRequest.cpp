@@ -113,7 +113,7 @@ namespace TrenchBroom {
         m_colorValueOp(ValueOp_None) {}
 
         void ChangeBrushFaceAttributesRequest::clear() {
-            m_textureName = "";
+            m_textureName = InternedString();
             m_xOffset = m_yOffset = 0.0f;
             m_rotation = 0.0f;
             m_xScale = m_yScale = 1.0f;
@@ -193,7 +193,7 @@ namespace TrenchBroom {
         }
 
         void ChangeBrushFaceAttributesRequest::setTextureName(const std::string& textureName) {
-            m_textureName = textureName;
+            m_textureName = InternedString(textureName);
             m_textureOp = TextureOp_Set;
         }
 
@@ -378,7 +378,8 @@ namespace TrenchBroom {
         }
 
         void ChangeBrushFaceAttributesRequest::setAllExceptContentFlags(const Model::BrushFaceAttributes& attributes) {
-            setTextureName(attributes.textureName());
+            m_textureName = attributes.internedTextureName();
+            m_textureOp = TextureOp_Set;
             setXOffset(attributes.xOffset());
             setYOffset(attributes.yOffset());
             setRotation(attributes.rotation());
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "Color.h"
+#include "Model/InternedString.h"
 
 #include <vecmath/forward.h>
 
@@ -65,7 +66,7 @@ namespace TrenchBroom {
                 TextureOp_Set
             } TextureOp;
         private:
-            std::string m_textureName;
+            InternedString m_textureName;
             float m_xOffset;
             float m_yOffset;
             float m_rotation;
@@ -30,12 +30,14 @@ namespace TrenchBroom {
     namespace Model {
         CompilationProfile::CompilationProfile(const std::string& name, const std::string& workDirSpec) :
         m_name(name),
-        m_workDirSpec(workDirSpec) {}
+        m_workDirSpec(workDirSpec),
+        m_jobCount(1u) {}
 
         CompilationProfile::CompilationProfile(const std::string& name, const std::string& workDirSpec, std::vector<std::unique_ptr<CompilationTask>> tasks) :
         m_name(name),
         m_workDirSpec(workDirSpec),
-        m_tasks(std::move(tasks)) {}
+        m_tasks(std::move(tasks)),
+        m_jobCount(1u) {}
 
         CompilationProfile::~CompilationProfile() = default;
 
@@ -47,7 +49,9 @@ namespace TrenchBroom {
                 clones.push_back(std::unique_ptr<CompilationTask>(original->clone()));
             }
 
-            return std::make_unique<CompilationProfile>(m_name, m_workDirSpec, std::move(clones));
+            auto result = std::make_unique<CompilationProfile>(m_name, m_workDirSpec, std::move(clones));
+            result->setJobCount(m_jobCount);
+            return result;
         }
 
         bool CompilationProfile::operator==(const CompilationProfile& other) const {
@@ -57,6 +61,9 @@ namespace TrenchBroom {
             if (m_workDirSpec != other.m_workDirSpec) {
                 return false;
             }
+            if (m_jobCount != other.m_jobCount) {
+                return false;
+            }
             if (m_tasks.size() != other.m_tasks.size()) {
                 return false;
             }
@@ -88,6 +95,15 @@ namespace TrenchBroom {
             m_workDirSpec = workDirSpec;
         }
 
+        size_t CompilationProfile::jobCount() const {
+            return m_jobCount;
+        }
+
+        void CompilationProfile::setJobCount(const size_t jobCount) {
+            assert(jobCount > 0u);
+            m_jobCount = jobCount;
+        }
+
 
         size_t CompilationProfile::taskCount() const {
             return m_tasks.size();
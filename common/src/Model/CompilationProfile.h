@@ -38,6 +38,7 @@ namespace TrenchBroom {
             std::string m_name;
             std::string m_workDirSpec;
             std::vector<std::unique_ptr<CompilationTask>> m_tasks;
+            size_t m_jobCount;
         public:
             CompilationProfile(const std::string& name, const std::string& workDirSpec);
             CompilationProfile(const std::string& name, const std::string& workDirSpec, std::vector<std::unique_ptr<CompilationTask>> tasks);
@@ -53,6 +54,12 @@ namespace TrenchBroom {
             const std::string& workDirSpec() const;
             void setWorkDirSpec(const std::string& workDirSpec);
 
+            /**
+             * The maximum number of tasks that may run at the same time. Defaults to 1.
+             */
+            size_t jobCount() const;
+            void setJobCount(size_t jobCount);
+
             size_t taskCount() const;
             CompilationTask* task(size_t index) const;
             size_t indexOfTask(CompilationTask* task) const;
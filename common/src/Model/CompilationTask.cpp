@@ -38,10 +38,32 @@ namespace TrenchBroom {
             m_enabled = enabled;
         }
 
+        const std::string& CompilationTask::name() const {
+            return m_name;
+        }
+
+        void CompilationTask::setName(const std::string& name) {
+            m_name = name;
+        }
+
+        const std::optional<std::vector<std::string>>& CompilationTask::dependencies() const {
+            return m_dependencies;
+        }
+
+        void CompilationTask::setDependencies(std::optional<std::vector<std::string>> dependencies) {
+            m_dependencies = std::move(dependencies);
+        }
+
         bool CompilationTask::operator!=(const CompilationTask& other) const {
             return !(*this == other);
         }
 
+        bool CompilationTask::equalsBase(const CompilationTask& other) const {
+            return m_enabled == other.m_enabled
+                && m_name == other.m_name
+                && m_dependencies == other.m_dependencies;
+        }
+
         // CompilationExportMap
 
         CompilationExportMap::CompilationExportMap(const bool enabled, const std::string& targetSpec) :
@@ -73,7 +95,7 @@ namespace TrenchBroom {
         }
 
         CompilationExportMap* CompilationExportMap::clone() const {
-            return new CompilationExportMap(enabled(), m_targetSpec);
+            return copyBase(new CompilationExportMap(enabled(), m_targetSpec));
         }
 
         bool CompilationExportMap::operator==(const CompilationTask& other) const {
@@ -81,7 +103,7 @@ namespace TrenchBroom {
             if (otherCasted == nullptr) {
                 return false;
             }
-            if (m_enabled != otherCasted->m_enabled) {
+            if (!equalsBase(*otherCasted)) {
                 return false;
             }
             if (m_targetSpec != otherCasted->m_targetSpec) {
@@ -130,7 +152,7 @@ namespace TrenchBroom {
         }
 
         CompilationCopyFiles* CompilationCopyFiles::clone() const {
-            return new CompilationCopyFiles(enabled(), m_sourceSpec, m_targetSpec);
+            return copyBase(new CompilationCopyFiles(enabled(), m_sourceSpec, m_targetSpec));
         }
 
         bool CompilationCopyFiles::operator==(const CompilationTask& other) const {
@@ -138,7 +160,7 @@ namespace TrenchBroom {
             if (otherCasted == nullptr) {
                 return false;
             }
-            if (m_enabled != otherCasted->m_enabled) {
+            if (!equalsBase(*otherCasted)) {
                 return false;
             }
             if (m_sourceSpec != otherCasted->m_sourceSpec) {
@@ -190,7 +212,7 @@ namespace TrenchBroom {
         }
 
         CompilationRunTool* CompilationRunTool::clone() const {
-            return new CompilationRunTool(enabled(), m_toolSpec, m_parameterSpec);
+            return copyBase(new CompilationRunTool(enabled(), m_toolSpec, m_parameterSpec));
         }
 
         bool CompilationRunTool::operator==(const CompilationTask& other) const {
@@ -198,7 +220,7 @@ namespace TrenchBroom {
             if (otherCasted == nullptr) {
                 return false;
             }
-            if (m_enabled != otherCasted->m_enabled) {
+            if (!equalsBase(*otherCasted)) {
                 return false;
             }
             if (m_toolSpec != otherCasted->m_toolSpec) {
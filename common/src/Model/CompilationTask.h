@@ -21,7 +21,9 @@
 
 #include "Macros.h"
 
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Model {
@@ -30,9 +32,19 @@ namespace TrenchBroom {
         class ConstCompilationTaskConstVisitor;
         class ConstCompilationTaskVisitor;
 
+        /**
+         * A task of a compilation profile.
+         *
+         * A task can be given a name so that other tasks can refer to it in their dependencies. If a task has no
+         * dependency list, it depends on the task that precedes it in its profile, so that profiles without any
+         * dependency information run their tasks in order. A task with a dependency list only waits for the named
+         * tasks, and it may run concurrently with other tasks if the profile allows more than one job.
+         */
         class CompilationTask {
         protected:
             bool m_enabled;
+            std::string m_name;
+            std::optional<std::vector<std::string>> m_dependencies;
         protected:
             explicit CompilationTask(bool enabled);
         public:
@@ -46,9 +58,24 @@ namespace TrenchBroom {
             bool enabled() const;
             void setEnabled(bool enabled);
 
+            const std::string& name() const;
+            void setName(const std::string& name);
+
+            const std::optional<std::vector<std::string>>& dependencies() const;
+            void setDependencies(std::optional<std::vector<std::string>> dependencies);
+
             virtual CompilationTask* clone() const = 0;
             virtual bool operator==(const CompilationTask& other) const = 0;
             bool operator!=(const CompilationTask& other) const;
+        protected:
+            bool equalsBase(const CompilationTask& other) const;
+
+            template <typename T>
+            T* copyBase(T* clone) const {
+                clone->m_name = m_name;
+                clone->m_dependencies = m_dependencies;
+                return clone;
+            }
 
             deleteCopyAndMove(CompilationTask)
         };
@@ -189,7 +189,7 @@ namespace TrenchBroom {
         }
 
         bool EditorContext::visible(const Model::BrushNode* brushNode, const Model::BrushFace& face) const {
-            return visible(brushNode) && !face.hasTag(m_hiddenTags);
+            return visible(brushNode) && faceVisible(face);
         }
 
         bool EditorContext::visible(const Model::PatchNode* patchNode) const {
@@ -204,6 +204,10 @@ namespace TrenchBroom {
             return patchNode->visible();
         }
 
+        bool EditorContext::faceVisible(const Model::BrushFace& face) const {
+            return !face.hasTag(m_hiddenTags);
+        }
+
         bool EditorContext::anyChildVisible(const Model::Node* node) const {
             const auto& children = node->children();
             return std::any_of(std::begin(children), std::end(children), [this](const Node* child) { return visible(child); });
@@ -78,6 +78,12 @@ namespace TrenchBroom {
             bool visible(const Model::BrushNode* brushNode) const;
             bool visible(const Model::BrushNode* brushNode, const Model::BrushFace& face) const;
             bool visible(const Model::PatchNode* patchNode) const;
+
+            /**
+             * Returns whether the given face is visible provided that its brush is visible. Callers that test all
+             * faces of a brush should test the brush once and then use this function for its faces.
+             */
+            bool faceVisible(const Model::BrushFace& face) const;
         private:
             bool anyChildVisible(const Model::Node* node) const;
 
@@ -41,6 +41,18 @@ namespace TrenchBroom {
     namespace Model {
         const vm::bbox3 Entity::DefaultBounds = vm::bbox3(8.0);
 
+        /**
+         * Returns whether the cached properties depend on the value or the presence of the property with the given key.
+         */
+        static bool isCachedPropertyKey(const std::string& key) {
+            return key == PropertyKeys::Classname
+                || key == PropertyKeys::Origin
+                || key == PropertyKeys::Angle
+                || key == PropertyKeys::Angles
+                || key == PropertyKeys::Mangle
+                || key == PropertyKeys::Target;
+        }
+
         Entity::Entity() :
         m_pointEntity(true),
         m_model(nullptr) {}
@@ -138,8 +150,9 @@ namespace TrenchBroom {
             }
         }
 
-        const vm::mat4x4 Entity::modelTransformation() const {
-            return vm::translation_matrix(origin()) * rotation();
+        const vm::mat4x4& Entity::modelTransformation() const {
+            validateCachedProperties();
+            return m_cachedProperties->modelTransformation;
         }
 
         void Entity::addOrUpdateProperty(std::string key, std::string value, const bool defaultToProtected) {
@@ -153,7 +166,10 @@ namespace TrenchBroom {
                     m_protectedProperties.push_back(key);
                 }
             }
-            invalidateCachedProperties();
+
+            if (isCachedPropertyKey(key)) {
+                invalidateCachedProperties();
+            }
         }
 
         void Entity::renameProperty(const std::string& oldKey, std::string newKey) {
@@ -173,8 +189,11 @@ namespace TrenchBroom {
                     m_properties.erase(newIt);
                 }
 
+                const auto affectsCachedProperties = isCachedPropertyKey(oldKey) || isCachedPropertyKey(newKey);
                 oldIt->setKey(std::move(newKey));
-                invalidateCachedProperties();
+                if (affectsCachedProperties) {
+                    invalidateCachedProperties();
+                }
             }
         }
 
@@ -182,7 +201,9 @@ namespace TrenchBroom {
             const auto it = findProperty(key);
             if (it != std::end(m_properties)) {
                 m_properties.erase(it);
-                invalidateCachedProperties();
+                if (isCachedPropertyKey(key)) {
+                    invalidateCachedProperties();
+                }
             }
         }
 
@@ -308,6 +329,7 @@ namespace TrenchBroom {
                 m_cachedProperties->classname = classnameValue ? *classnameValue : PropertyValues::NoClassname;
                 m_cachedProperties->origin = originValue ? vm::parse<FloatType, 3>(*originValue).value_or(vm::vec3::zero()) : vm::vec3::zero();
                 m_cachedProperties->rotation = EntityRotationPolicy::getRotation(*this);
+                m_cachedProperties->modelTransformation = vm::translation_matrix(m_cachedProperties->origin) * m_cachedProperties->rotation;
             }
         }
 
@@ -163,7 +163,7 @@ namespace TrenchBroom {
                 // only if the bbox hit test failed do we hit test the model
                 if (m_entity.model() != nullptr) {
                     // we transform the ray into the model's space
-                    const auto transform = m_entity.modelTransformation();
+                    const auto& transform = m_entity.modelTransformation();
                     const auto [invertible, inverse] = vm::invert(transform);
                     if (invertible) {
                         const auto transformedRay = vm::ray3f(ray.transform(inverse));
@@ -25,8 +25,10 @@
 #include "Model/EntityProperties.h"
 
 #include <kdl/compact_trie.h>
+#include <kdl/string_compare.h>
 #include <kdl/vector_utils.h>
 
+#include <algorithm>
 #include <iterator>
 #include <list>
 #include <string>
@@ -46,10 +48,34 @@ namespace TrenchBroom {
             return EntityNodeIndexQuery(Type_Numbered, pattern);
         }
 
+        EntityNodeIndexQuery EntityNodeIndexQuery::wildcard(const std::string& pattern) {
+            return EntityNodeIndexQuery(Type_Wildcard, pattern);
+        }
+
         EntityNodeIndexQuery EntityNodeIndexQuery::any() {
             return EntityNodeIndexQuery(Type_Any);
         }
 
+        EntityNodeIndexQuery::Type EntityNodeIndexQuery::type() const {
+            return m_type;
+        }
+
+        bool EntityNodeIndexQuery::matches(const std::string& str) const {
+            switch (m_type) {
+                case Type_Exact:
+                    return str == m_pattern;
+                case Type_Prefix:
+                    return kdl::cs::str_is_prefix(str, m_pattern);
+                case Type_Numbered:
+                    return isNumberedProperty(m_pattern, str);
+                case Type_Wildcard:
+                    return kdl::cs::str_matches_glob(str, m_pattern);
+                case Type_Any:
+                    return true;
+                switchDefault()
+            }
+        }
+
         std::set<EntityNodeBase*> EntityNodeIndexQuery::execute(const EntityNodeStringIndex& index) const {
             std::set<EntityNodeBase*> result;
             switch (m_type) {
@@ -62,6 +88,9 @@ namespace TrenchBroom {
                 case Type_Numbered:
                     index.find_matches(m_pattern + "%*", std::inserter(result, std::end(result)));
                     break;
+                case Type_Wildcard:
+                    index.find_matches(m_pattern, std::inserter(result, std::end(result)));
+                    break;
                 case Type_Any:
                     break;
                 switchDefault()
@@ -77,6 +106,12 @@ namespace TrenchBroom {
                     return node->entity().hasPropertyWithPrefix(m_pattern, value);
                 case Type_Numbered:
                     return node->entity().hasNumberedProperty(m_pattern, value);
+                case Type_Wildcard: {
+                    const auto& properties = node->entity().properties();
+                    return std::any_of(std::begin(properties), std::end(properties), [&](const auto& property) {
+                        return property.value() == value && matches(property.key());
+                    });
+                }
                 case Type_Any:
                     return true;
                 switchDefault()
@@ -92,6 +127,8 @@ namespace TrenchBroom {
                     return entity.propertiesWithPrefix(m_pattern);
                 case Type_Numbered:
                     return entity.numberedProperties(m_pattern);
+                case Type_Wildcard:
+                    return kdl::vec_filter(entity.properties(), [&](const auto& property) { return matches(property.key()); });
                 case Type_Any:
                     return entity.properties();
                 switchDefault()
@@ -151,6 +188,25 @@ namespace TrenchBroom {
             return result;
         }
 
+        std::vector<EntityNodeBase*> EntityNodeIndex::findEntityNodes(const EntityNodeIndexQuery& keyQuery, const EntityNodeIndexQuery& valueQuery) const {
+            const auto candidates = valueQuery.type() != EntityNodeIndexQuery::Type_Any
+                ? valueQuery.execute(*m_valueIndex)
+                : keyQuery.execute(*m_keyIndex);
+
+            std::vector<EntityNodeBase*> result;
+            for (auto* node : candidates) {
+                const auto properties = keyQuery.execute(node);
+                if (std::any_of(std::begin(properties), std::end(properties), [&](const auto& property) { return valueQuery.matches(property.value()); })) {
+                    result.push_back(node);
+                }
+            }
+            return result;
+        }
+
+        size_t EntityNodeIndex::countEntityNodes(const EntityNodeIndexQuery& keyQuery, const EntityNodeIndexQuery& valueQuery) const {
+            return findEntityNodes(keyQuery, valueQuery).size();
+        }
+
         std::vector<std::string> EntityNodeIndex::allKeys() const {
             std::vector<std::string> result;
             m_keyIndex->get_keys(std::back_inserter(result));
@@ -39,6 +39,7 @@ namespace TrenchBroom {
                 Type_Exact,
                 Type_Prefix,
                 Type_Numbered,
+                Type_Wildcard,
                 Type_Any
             } Type;
         private:
@@ -48,8 +49,19 @@ namespace TrenchBroom {
             static EntityNodeIndexQuery exact(const std::string& pattern);
             static EntityNodeIndexQuery prefix(const std::string& pattern);
             static EntityNodeIndexQuery numbered(const std::string& pattern);
+            /**
+             * Matches strings against a glob pattern, see kdl::cs::str_matches_glob for the syntax.
+             */
+            static EntityNodeIndexQuery wildcard(const std::string& pattern);
             static EntityNodeIndexQuery any();
 
+            Type type() const;
+
+            /**
+             * Indicates whether the given string is matched by this query.
+             */
+            bool matches(const std::string& str) const;
+
             std::set<EntityNodeBase*> execute(const EntityNodeStringIndex& index) const;
             bool execute(const EntityNodeBase* node, const std::string& value) const;
             std::vector<Model::EntityProperty> execute(const EntityNodeBase* node) const;
@@ -72,6 +84,18 @@ namespace TrenchBroom {
             void removeProperty(EntityNodeBase* node, const std::string& key, const std::string& value);
 
             std::vector<EntityNodeBase*> findEntityNodes(const EntityNodeIndexQuery& keyQuery, const std::string& value) const;
+
+            /**
+             * Finds the entity nodes that have a property whose key matches the given key query and whose value
+             * matches the given value query. The candidates are looked up using the value index, unless the value
+             * query matches any value, in which case they are looked up using the key index.
+             */
+            std::vector<EntityNodeBase*> findEntityNodes(const EntityNodeIndexQuery& keyQuery, const EntityNodeIndexQuery& valueQuery) const;
+
+            /**
+             * Returns the number of entity nodes that findEntityNodes(keyQuery, valueQuery) would return.
+             */
+            size_t countEntityNodes(const EntityNodeIndexQuery& keyQuery, const EntityNodeIndexQuery& valueQuery) const;
             std::vector<std::string> allKeys() const;
             std::vector<std::string> allValuesForKeys(const EntityNodeIndexQuery& keyQuery) const;
         };
@@ -86,19 +86,21 @@ namespace TrenchBroom {
 
         EntityProperty::EntityProperty() = default;
 
-        EntityProperty::EntityProperty(const std::string& key, const std::string& value) :
+        EntityProperty::EntityProperty(std::string key, std::string value) :
         m_key(key),
-        m_value(value) {}
+        m_value(std::move(value)) {}
 
         int EntityProperty::compare(const EntityProperty& rhs) const {
-            const int keyCmp = m_key.compare(rhs.m_key);
-            if (keyCmp != 0)
-                return keyCmp;
+            if (m_key != rhs.m_key) {
+                const int keyCmp = m_key.str().compare(rhs.m_key.str());
+                if (keyCmp != 0)
+                    return keyCmp;
+            }
             return m_value.compare(rhs.m_value);
         }
 
         const std::string& EntityProperty::key() const {
-            return m_key;
+            return m_key.str();
         }
 
         const std::string& EntityProperty::value() const {
@@ -106,7 +108,11 @@ namespace TrenchBroom {
         }
 
         bool EntityProperty::hasKey(std::string_view key) const {
-            return kdl::cs::str_is_equal(m_key, key);
+            // the given key is often the key of another property, so the interned keys are compared first
+            if (key.data() == m_key.str().data() && key.size() == m_key.str().size()) {
+                return true;
+            }
+            return kdl::cs::str_is_equal(m_key.str(), key);
         }
 
         bool EntityProperty::hasValue(const std::string_view value) const {
@@ -118,7 +124,7 @@ namespace TrenchBroom {
         }
 
         bool EntityProperty::hasPrefix(const std::string_view prefix) const {
-            return kdl::cs::str_is_prefix(m_key, prefix);
+            return kdl::cs::str_is_prefix(m_key.str(), prefix);
         }
 
         bool EntityProperty::hasPrefixAndValue(const std::string_view prefix, const std::string_view value) const {
@@ -126,7 +132,7 @@ namespace TrenchBroom {
         }
 
         bool EntityProperty::hasNumberedPrefix(const std::string_view prefix) const {
-            return isNumberedProperty(prefix, m_key);
+            return isNumberedProperty(prefix, m_key.str());
         }
 
         bool EntityProperty::hasNumberedPrefixAndValue(const std::string_view prefix, const std::string_view value) const {
@@ -134,7 +140,7 @@ namespace TrenchBroom {
         }
 
         void EntityProperty::setKey(const std::string& key) {
-            m_key = key;
+            m_key = InternedString(key);
         }
 
         void EntityProperty::setValue(const std::string& value) {
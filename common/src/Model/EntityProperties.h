@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include "Model/InternedString.h"
+
 #include <iosfwd>
 #include <string>
 #include <vector>
@@ -75,13 +77,18 @@ namespace TrenchBroom {
 
         bool isNumberedProperty(std::string_view prefix, std::string_view key);
 
+        /**
+         * A key and value pair. Keys are interned: every distinct key is stored once for the lifetime of the
+         * program, and properties only point to it. Maps use a small set of keys over and over, so this saves an
+         * allocation for every long key and makes copying and comparing keys cheap.
+         */
         class EntityProperty {
         private:
-            std::string m_key;
+            InternedString m_key;
             std::string m_value;
         public:
             EntityProperty();
-            EntityProperty(const std::string& key, const std::string& value);
+            EntityProperty(std::string key, std::string value);
             
             int compare(const EntityProperty& rhs) const;
 
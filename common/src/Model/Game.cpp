@@ -86,12 +86,12 @@ namespace TrenchBroom {
             doWriteMap(world, path);
         }
 
-        void Game::exportMap(WorldNode& world, const Model::ExportFormat format, const IO::Path& path) const {
-            doExportMap(world, format, path);
+        void Game::exportMap(WorldNode& world, const Model::ExportFormat format, const IO::Path& path, IO::NodeSerializationCache* cache) const {
+            doExportMap(world, format, path, cache);
         }
 
-        std::vector<Node*> Game::parseNodes(const std::string& str, const MapFormat mapFormat, const vm::bbox3& worldBounds, Logger& logger) const {
-            return doParseNodes(str, mapFormat, worldBounds, logger);
+        std::vector<Node*> Game::parseNodes(const std::string& str, const MapFormat mapFormat, const vm::bbox3& worldBounds, Logger& logger, const std::string_view cacheData) const {
+            return doParseNodes(str, mapFormat, worldBounds, cacheData, logger);
         }
 
         std::vector<BrushFace> Game::parseBrushFaces(const std::string& str, const MapFormat mapFormat, const vm::bbox3& worldBounds, Logger& logger) const {
@@ -102,6 +102,10 @@ namespace TrenchBroom {
             doWriteNodesToStream(world, nodes, stream);
         }
 
+        std::string Game::writeNodesCacheData(const std::string& str, const MapFormat mapFormat, Logger& logger) const {
+            return doWriteNodesCacheData(str, mapFormat, logger);
+        }
+
         void Game::writeBrushFacesToStream(WorldNode& world, const std::vector<BrushFace>& faces, std::ostream& stream) const {
             doWriteBrushFacesToStream(world, faces, stream);
         }
@@ -31,6 +31,7 @@
 #include <memory>
 #include <map>
 #include <string>
+#include <string_view>
 #include <optional>
 #include <utility>
 #include <vector>
@@ -43,6 +44,10 @@ namespace TrenchBroom {
         class TextureManager;
     }
 
+    namespace IO {
+        class NodeSerializationCache;
+    }
+
     namespace Model {
         class EntityNodeBase;
         class BrushFace;
@@ -98,12 +103,25 @@ namespace TrenchBroom {
             std::unique_ptr<WorldNode> newMap(MapFormat format, const vm::bbox3& worldBounds, Logger& logger) const;
             std::unique_ptr<WorldNode> loadMap(MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const;
             void writeMap(WorldNode& world, const IO::Path& path) const;
-            void exportMap(WorldNode& world, Model::ExportFormat format, const IO::Path& path) const;
+            /**
+             * Exports the given world to the given path. If a cache is given, it is used to avoid serializing
+             * unchanged brushes and patches again when exporting to a map file.
+             */
+            void exportMap(WorldNode& world, Model::ExportFormat format, const IO::Path& path, IO::NodeSerializationCache* cache = nullptr) const;
         public: // parsing and serializing objects
-            std::vector<Node*> parseNodes(const std::string& str, MapFormat mapFormat, const vm::bbox3& worldBounds, Logger& logger) const;
+            /**
+             * Parses the given string as nodes. If cache data is given that was created from the same string by
+             * writeNodesCacheData, the string is not parsed again.
+             */
+            std::vector<Node*> parseNodes(const std::string& str, MapFormat mapFormat, const vm::bbox3& worldBounds, Logger& logger, std::string_view cacheData = {}) const;
             std::vector<BrushFace> parseBrushFaces(const std::string& str, MapFormat mapFormat, const vm::bbox3& worldBounds, Logger& logger) const;
 
             void writeNodesToStream(WorldNode& world, const std::vector<Node*>& nodes, std::ostream& stream) const;
+            /**
+             * Returns cache data for the given string, which must have been written by writeNodesToStream, so that
+             * it can be parsed into a document of the given format more quickly.
+             */
+            std::string writeNodesCacheData(const std::string& str, MapFormat mapFormat, Logger& logger) const;
             void writeBrushFacesToStream(WorldNode& world, const std::vector<BrushFace>& faces, std::ostream& stream) const;
         public: // texture collection handling
             TexturePackageType texturePackageType() const;
@@ -147,11 +165,12 @@ namespace TrenchBroom {
             virtual std::unique_ptr<WorldNode> doNewMap(MapFormat format, const vm::bbox3& worldBounds, Logger& logger) const = 0;
             virtual std::unique_ptr<WorldNode> doLoadMap(MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const = 0;
             virtual void doWriteMap(WorldNode& world, const IO::Path& path) const = 0;
-            virtual void doExportMap(WorldNode& world, Model::ExportFormat format, const IO::Path& path) const = 0;
+            virtual void doExportMap(WorldNode& world, Model::ExportFormat format, const IO::Path& path, IO::NodeSerializationCache* cache) const = 0;
 
-            virtual std::vector<Node*> doParseNodes(const std::string& str, MapFormat mapFormat, const vm::bbox3& worldBounds, Logger& logger) const = 0;
+            virtual std::vector<Node*> doParseNodes(const std::string& str, MapFormat mapFormat, const vm::bbox3& worldBounds, std::string_view cacheData, Logger& logger) const = 0;
             virtual std::vector<BrushFace> doParseBrushFaces(const std::string& str, MapFormat mapFormat, const vm::bbox3& worldBounds, Logger& logger) const = 0;
             virtual void doWriteNodesToStream(WorldNode& world, const std::vector<Node*>& nodes, std::ostream& stream) const = 0;
+            virtual std::string doWriteNodesCacheData(const std::string& str, MapFormat mapFormat, Logger& logger) const = 0;
             virtual void doWriteBrushFacesToStream(WorldNode& world, const std::vector<BrushFace>& faces, std::ostream& stream) const = 0;
 
             virtual TexturePackageType doTexturePackageType() const = 0;
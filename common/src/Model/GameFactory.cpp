@@ -40,12 +40,16 @@
 #include "Model/GameImpl.h"
 
 #include <kdl/collection_utils.h>
+#include <kdl/parallel.h>
 #include <kdl/string_compare.h>
 #include <kdl/string_utils.h>
+#include <kdl/vector_utils.h>
 
+#include <exception>
 #include <iostream>
 #include <fstream>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -198,13 +202,44 @@ namespace TrenchBroom {
             }
         }
 
+        namespace {
+            struct ParsedGameConfig {
+                std::optional<GameConfig> config;
+                std::exception_ptr exception;
+            };
+        }
+
         void GameFactory::loadGameConfigs() {
             std::vector<std::string> errors;
 
-            const auto configFiles = m_configFS->findItemsRecursively(IO::Path(""), IO::FileNameMatcher("GameConfig.cfg"));
-            for (const auto& configFilePath : configFiles) {
+            // the config file system is only read until the configs are registered, so the files are read and parsed
+            // in parallel; they are registered serially because that updates this factory and may write profiles
+            const auto configFilePaths = m_configFS->findItemsRecursively(IO::Path(""), IO::FileNameMatcher("GameConfig.cfg"));
+            auto parsedConfigs = kdl::vec_parallel_transform(configFilePaths, [&](const IO::Path& path) {
+                try {
+                    const auto configFile = m_configFS->openFile(path);
+                    auto reader = configFile->reader().buffer();
+                    IO::GameConfigParser parser(reader.stringView(), m_configFS->makeAbsolute(path));
+                    return ParsedGameConfig{parser.parse(), nullptr};
+                } catch (...) {
+                    return ParsedGameConfig{std::nullopt, std::current_exception()};
+                }
+            });
+
+            for (size_t i = 0; i < configFilePaths.size(); ++i) {
+                const auto& configFilePath = configFilePaths[i];
+                auto& parsedConfig = parsedConfigs[i];
                 try {
-                loadGameConfig(configFilePath);
+                    if (parsedConfig.config) {
+                        registerGameConfig(std::move(*parsedConfig.config));
+                    } else {
+                        try {
+                            std::rethrow_exception(parsedConfig.exception);
+                        } catch (const RecoverableException& e) {
+                            e.recover();
+                            doLoadGameConfig(configFilePath);
+                        }
+                    }
                 } catch (const std::exception& e) {
                     errors.push_back(kdl::str_to_string("Could not load game configuration file ", configFilePath, ": ", e.what()));
                 }
@@ -217,22 +252,15 @@ namespace TrenchBroom {
             }
         }
 
-        void GameFactory::loadGameConfig(const IO::Path& path) {
-            try {
-                doLoadGameConfig(path);
-            } catch (const RecoverableException& e) {
-                e.recover();
-                doLoadGameConfig(path);
-            }
-        }
-
         void GameFactory::doLoadGameConfig(const IO::Path& path) {
             const auto configFile = m_configFS->openFile(path);
             const auto absolutePath = m_configFS->makeAbsolute(path);
             auto reader = configFile->reader().buffer();
             IO::GameConfigParser parser(reader.stringView(), absolutePath);
-            GameConfig config = parser.parse();
+            registerGameConfig(parser.parse());
+        }
 
+        void GameFactory::registerGameConfig(GameConfig config) {
             loadCompilationConfig(config);
             loadGameEngineConfig(config);
 
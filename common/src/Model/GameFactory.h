@@ -120,8 +120,8 @@ namespace TrenchBroom {
             GameFactory();
             void initializeFileSystem();
             void loadGameConfigs();
-            void loadGameConfig(const IO::Path& path);
             void doLoadGameConfig(const IO::Path& path);
+            void registerGameConfig(GameConfig config);
             void loadCompilationConfig(GameConfig& gameConfig);
             void loadGameEngineConfig(GameConfig& gameConfig);
 
@@ -26,15 +26,19 @@
 #include "IO/DkPakFileSystem.h"
 #include "IO/IdPakFileSystem.h"
 #include "IO/FileMatcher.h"
+#include "IO/PackageIndex.h"
 #include "IO/Quake3ShaderFileSystem.h"
 #include "IO/SystemPaths.h"
 #include "IO/ZipFileSystem.h"
 #include "Model/GameConfig.h"
 
+#include <kdl/parallel.h>
 #include <kdl/string_compare.h>
 #include <kdl/vector_utils.h>
 
 #include <memory>
+#include <optional>
+#include <string>
 
 namespace TrenchBroom {
     namespace Model {
@@ -42,7 +46,7 @@ namespace TrenchBroom {
         FileSystem(),
         m_shaderFS(nullptr) {}
 
-        void GameFileSystem::initialize(const GameConfig& config, const IO::Path& gamePath, const std::vector<IO::Path>& additionalSearchPaths, Logger& logger) {
+        void GameFileSystem::initialize(const GameConfig& config, const IO::Path& gamePath, const std::vector<IO::Path>& additionalSearchPaths, Logger& logger, const IO::Path& packageIndexPath) {
             // delete the existing file system
             releaseNext();
             m_shaderFS = nullptr;
@@ -50,8 +54,17 @@ namespace TrenchBroom {
             addDefaultAssetPaths(config, logger);
 
             if (!gamePath.isEmpty() && IO::Disk::directoryExists(gamePath)) {
-                addGameFileSystems(config, gamePath, additionalSearchPaths, logger);
+                auto packageIndex = packageIndexPath.isEmpty() ? IO::PackageIndex{} : IO::PackageIndex::read(packageIndexPath);
+                addGameFileSystems(config, gamePath, additionalSearchPaths, packageIndex, logger);
                 addShaderFileSystem(config, logger);
+
+                if (!packageIndexPath.isEmpty() && packageIndex.modified()) {
+                    try {
+                        packageIndex.write(packageIndexPath);
+                    } catch (const FileSystemException& e) {
+                        logger.warn() << "Could not write package index: " << e.what();
+                    }
+                }
             }
         }
 
@@ -86,14 +99,14 @@ namespace TrenchBroom {
             }
         }
 
-        void GameFileSystem::addGameFileSystems(const GameConfig& config, const IO::Path& gamePath, const std::vector<IO::Path>& additionalSearchPaths, Logger& logger) {
+        void GameFileSystem::addGameFileSystems(const GameConfig& config, const IO::Path& gamePath, const std::vector<IO::Path>& additionalSearchPaths, IO::PackageIndex& packageIndex, Logger& logger) {
             const auto& fileSystemConfig = config.fileSystemConfig();
             addFileSystemPath(gamePath + fileSystemConfig.searchPath, logger);
-            addFileSystemPackages(config, gamePath + fileSystemConfig.searchPath, logger);
+            addFileSystemPackages(config, gamePath + fileSystemConfig.searchPath, packageIndex, logger);
 
             for (const auto& searchPath : additionalSearchPaths) {
                 addFileSystemPath(gamePath + searchPath, logger);
-                addFileSystemPackages(config, gamePath + searchPath, logger);
+                addFileSystemPackages(config, gamePath + searchPath, packageIndex, logger);
             }
         }
 
@@ -106,32 +119,80 @@ namespace TrenchBroom {
             }
         }
 
-        void GameFileSystem::addFileSystemPackages(const GameConfig& config, const IO::Path& searchPath, Logger& logger) {
+        namespace {
+            struct PackageToOpen {
+                IO::Path path;
+                std::optional<std::vector<IO::ZipFileSystem::Entry>> indexedEntries;
+            };
+
+            struct OpenedPackage {
+                std::shared_ptr<IO::FileSystem> fileSystem;
+                std::optional<std::vector<IO::ZipFileSystem::Entry>> scannedEntries;
+                std::string errorMessage;
+            };
+        }
+
+        void GameFileSystem::addFileSystemPackages(const GameConfig& config, const IO::Path& searchPath, IO::PackageIndex& packageIndex, Logger& logger) {
             const auto& fileSystemConfig = config.fileSystemConfig();
             const auto& packageFormatConfig = fileSystemConfig.packageFormat;
 
             const auto& packageExtensions = packageFormatConfig.extensions;
             const auto& packageFormat = packageFormatConfig.format;
 
+            const auto isIdPak = kdl::ci::str_is_equal(packageFormat, "idpak");
+            const auto isDkPak = kdl::ci::str_is_equal(packageFormat, "dkpak");
+            const auto isZip = kdl::ci::str_is_equal(packageFormat, "zip");
+            if (!isIdPak && !isDkPak && !isZip) {
+                return;
+            }
+
             if (IO::Disk::directoryExists(searchPath)) {
                 const IO::DiskFileSystem diskFS(searchPath);
                 auto packages = diskFS.findItems(IO::Path(""), IO::FileExtensionMatcher(packageExtensions));
                 packages = kdl::vec_sort(std::move(packages), IO::Path::Less<kdl::ci::string_less>());
 
-                for (const auto& packagePath : packages) {
+                auto packagesToOpen = kdl::vec_transform(packages, [&](const IO::Path& packagePath) {
+                    const auto absolutePath = diskFS.makeAbsolute(packagePath);
+                    return PackageToOpen{absolutePath, isZip ? packageIndex.entries(absolutePath) : std::nullopt};
+                });
+
+                // the packages are opened concurrently and chained afterwards, in order
+                auto openedPackages = kdl::vec_parallel_transform(std::move(packagesToOpen), [&](PackageToOpen&& package) {
                     try {
-                        if (kdl::ci::str_is_equal(packageFormat, "idpak")) {
-                            logger.info() << "Adding file system package " << packagePath;
-                            m_next = std::make_shared<IO::IdPakFileSystem>(m_next, diskFS.makeAbsolute(packagePath));
-                        } else if (kdl::ci::str_is_equal(packageFormat, "dkpak")) {
-                            logger.info() << "Adding file system package " << packagePath;
-                            m_next = std::make_shared<IO::DkPakFileSystem>(m_next, diskFS.makeAbsolute(packagePath));
-                        } else if (kdl::ci::str_is_equal(packageFormat, "zip")) {
-                            logger.info() << "Adding file system package " << packagePath;
-                            m_next = std::make_shared<IO::ZipFileSystem>(m_next, diskFS.makeAbsolute(packagePath));
+                        if (isIdPak) {
+                            return OpenedPackage{std::make_shared<IO::IdPakFileSystem>(nullptr, package.path), std::nullopt, ""};
+                        } else if (isDkPak) {
+                            return OpenedPackage{std::make_shared<IO::DkPakFileSystem>(nullptr, package.path), std::nullopt, ""};
+                        }
+
+                        if (package.indexedEntries) {
+                            try {
+                                return OpenedPackage{std::make_shared<IO::ZipFileSystem>(nullptr, package.path, std::move(*package.indexedEntries)), std::nullopt, ""};
+                            } catch (const FileSystemException&) {
+                                // the recorded entries don't match the archive, read its directory instead
+                            }
                         }
+
+                        auto zipFS = std::make_shared<IO::ZipFileSystem>(nullptr, package.path);
+                        auto entries = zipFS->entries();
+                        return OpenedPackage{std::move(zipFS), std::move(entries), ""};
                     } catch (const std::exception& e) {
-                        logger.error() << e.what();
+                        return OpenedPackage{nullptr, std::nullopt, e.what()};
+                    }
+                });
+
+                for (size_t i = 0; i < packages.size(); ++i) {
+                    auto& openedPackage = openedPackages[i];
+                    if (openedPackage.fileSystem) {
+                        logger.info() << "Adding file system package " << packages[i];
+                        openedPackage.fileSystem->setNext(std::move(m_next));
+                        m_next = std::move(openedPackage.fileSystem);
+
+                        if (openedPackage.scannedEntries) {
+                            packageIndex.setEntries(diskFS.makeAbsolute(packages[i]), std::move(*openedPackage.scannedEntries));
+                        }
+                    } else {
+                        logger.error() << openedPackage.errorMessage;
                     }
                 }
             }
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "IO/FileSystem.h"
+#include "IO/Path.h"
 
 #include <memory>
 #include <vector>
@@ -28,7 +29,7 @@ namespace TrenchBroom {
     class Logger;
 
     namespace IO {
-        class Path;
+        class PackageIndex;
         class Quake3ShaderFileSystem;
     }
 
@@ -40,14 +41,18 @@ namespace TrenchBroom {
             IO::Quake3ShaderFileSystem* m_shaderFS;
         public:
             GameFileSystem();
-            void initialize(const GameConfig& config, const IO::Path& gamePath, const std::vector<IO::Path>& additionalSearchPaths, Logger& logger);
+            /**
+             * Builds the chain of file systems for the given game. If a package index path is given, the entries of
+             * zip packages are read from and recorded in the package index at that path.
+             */
+            void initialize(const GameConfig& config, const IO::Path& gamePath, const std::vector<IO::Path>& additionalSearchPaths, Logger& logger, const IO::Path& packageIndexPath = IO::Path());
             void reloadShaders();
         private:
             void addDefaultAssetPaths(const GameConfig& config, Logger& logger);
-            void addGameFileSystems(const GameConfig& config, const IO::Path& gamePath, const std::vector<IO::Path>& additionalSearchPaths, Logger& logger);
+            void addGameFileSystems(const GameConfig& config, const IO::Path& gamePath, const std::vector<IO::Path>& additionalSearchPaths, IO::PackageIndex& packageIndex, Logger& logger);
             void addShaderFileSystem(const GameConfig& config, Logger& logger);
             void addFileSystemPath(const IO::Path& path, Logger& logger);
-            void addFileSystemPackages(const GameConfig& config, const IO::Path& searchPath, Logger& logger);
+            void addFileSystemPackages(const GameConfig& config, const IO::Path& searchPath, IO::PackageIndex& packageIndex, Logger& logger);
         private:
             bool doDirectoryExists(const IO::Path& path) const override;
             bool doFileExists(const IO::Path& path) const override;
@@ -23,9 +23,12 @@
 #include "Exceptions.h"
 #include "Logger.h"
 #include "Macros.h"
+#include "PreferenceManager.h"
+#include "Preferences.h"
 #include "Assets/Palette.h"
 #include "Assets/EntityModel.h"
 #include "Assets/EntityDefinitionFileSpec.h"
+#include "Assets/TextureManager.h"
 #include "IO/AseParser.h"
 #include "IO/BrushFaceReader.h"
 #include "IO/Bsp29Parser.h"
@@ -33,12 +36,14 @@
 #include "IO/DiskIO.h"
 #include "IO/DkmParser.h"
 #include "IO/DiskFileSystem.h"
+#include "IO/EntityDefinitionCache.h"
 #include "IO/EntParser.h"
 #include "IO/FgdParser.h"
 #include "IO/File.h"
 #include "IO/FileMatcher.h"
 #include "IO/GameConfigParser.h"
 #include "IO/IOUtils.h"
+#include "IO/MapCache.h"
 #include "IO/MdlParser.h"
 #include "IO/Md2Parser.h"
 #include "IO/Md3Parser.h"
@@ -47,6 +52,7 @@
 #include "IO/NodeWriter.h"
 #include "IO/ObjParser.h"
 #include "IO/ObjSerializer.h"
+#include "IO/Reader.h"
 #include "IO/WorldReader.h"
 #include "IO/SimpleParserStatus.h"
 #include "IO/SystemPaths.h"
@@ -71,7 +77,10 @@
 #include <vecmath/vec_io.h>
 
 #include <fstream>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace TrenchBroom {
@@ -83,7 +92,7 @@ namespace TrenchBroom {
         }
 
         void GameImpl::initializeFileSystem(Logger& logger) {
-            m_fs.initialize(m_config, m_gamePath, m_additionalSearchPaths, logger);
+            m_fs.initialize(m_config, m_gamePath, m_additionalSearchPaths, logger, IO::SystemPaths::userDataDirectory() + IO::Path("package_index.bin"));
         }
 
         const std::string& GameImpl::doGameName() const {
@@ -175,6 +184,46 @@ namespace TrenchBroom {
             }
         }
 
+        /**
+         * Reads the world from the given string, using the cache file next to the map file at the given path if it
+         * is valid. If it is missing or stale, the cache file is written. Failing to read or write the cache file is
+         * not an error.
+         */
+        static std::unique_ptr<WorldNode> readWorldWithCache(const std::string_view str, const MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, IO::ParserStatus& parserStatus, Logger& logger) {
+            const auto cachePath = IO::MapCache::cachePath(IO::Disk::fixPath(path));
+
+            // keep the cache file and its reader alive so that the cache data need not be copied
+            auto cacheFile = std::shared_ptr<IO::File>{};
+            auto cacheReader = std::optional<IO::BufferedReader>{};
+            try {
+                if (IO::Disk::fileExists(cachePath)) {
+                    cacheFile = IO::Disk::openFile(cachePath);
+                    cacheReader = cacheFile->reader().buffer();
+                }
+            } catch (const Exception& e) {
+                logger.warn() << "Could not open map cache " << cachePath.asString() << ": " << e.what();
+            }
+
+            const auto cacheData = cacheReader ? cacheReader->stringView() : std::string_view{};
+
+            IO::WorldReader worldReader(str, format);
+            auto [worldNode, newCacheData] = worldReader.read(worldBounds, cacheData, parserStatus);
+
+            if (newCacheData) {
+                cacheReader.reset();
+                cacheFile.reset();
+                auto stream = openPathAsOutputStream(cachePath, std::ios::out | std::ios::binary);
+                if (stream) {
+                    stream.write(newCacheData->data(), static_cast<std::streamsize>(newCacheData->size()));
+                }
+                if (!stream) {
+                    logger.warn() << "Could not write map cache " << cachePath.asString();
+                }
+            }
+
+            return std::move(worldNode);
+        }
+
         std::unique_ptr<WorldNode> GameImpl::doLoadMap(const MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const {
             IO::SimpleParserStatus parserStatus(logger);
             auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
@@ -185,13 +234,15 @@ namespace TrenchBroom {
                     return Model::formatFromName(config.format);
                 });
                 return IO::WorldReader::tryRead(fileReader.stringView(), possibleFormats, worldBounds, parserStatus);
+            } else if (pref(Preferences::CacheParsedMaps)) {
+                return readWorldWithCache(fileReader.stringView(), format, worldBounds, path, parserStatus, logger);
             } else {
                 IO::WorldReader worldReader(fileReader.stringView(), format);
                 return worldReader.read(worldBounds, parserStatus);
             }
         }
 
-        void GameImpl::doWriteMap(WorldNode& world, const IO::Path& path, const bool exporting) const {
+        void GameImpl::doWriteMap(WorldNode& world, const IO::Path& path, const bool exporting, IO::NodeSerializationCache* cache) const {
             const auto mapFormatName = formatName(world.mapFormat());
 
             std::ofstream file = openPathAsOutputStream(path);
@@ -200,16 +251,16 @@ namespace TrenchBroom {
             }
             IO::writeGameComment(file, gameName(), mapFormatName);
 
-            IO::NodeWriter writer(world, file);
+            IO::NodeWriter writer(world, file, cache);
             writer.setExporting(exporting);
             writer.writeMap();
         }
 
         void GameImpl::doWriteMap(WorldNode& world, const IO::Path& path) const {
-            doWriteMap(world, path, false);
+            doWriteMap(world, path, false, nullptr);
         }
 
-        void GameImpl::doExportMap(WorldNode& world, const Model::ExportFormat format, const IO::Path& path) const {
+        void GameImpl::doExportMap(WorldNode& world, const Model::ExportFormat format, const IO::Path& path, IO::NodeSerializationCache* cache) const {
             switch (format) {
                 case Model::ExportFormat::WavefrontObj: {
                     std::ofstream objFile = openPathAsOutputStream(path);
@@ -229,14 +280,14 @@ namespace TrenchBroom {
                     break;
                 }
                 case Model::ExportFormat::Map:
-                    doWriteMap(world, path, true);
+                    doWriteMap(world, path, true, cache);
                     break;
             }
         }
 
-        std::vector<Node*> GameImpl::doParseNodes(const std::string& str, const MapFormat mapFormat, const vm::bbox3& worldBounds, Logger& logger) const {
+        std::vector<Node*> GameImpl::doParseNodes(const std::string& str, const MapFormat mapFormat, const vm::bbox3& worldBounds, const std::string_view cacheData, Logger& logger) const {
             IO::SimpleParserStatus parserStatus(logger);
-            return IO::NodeReader::read(str, mapFormat, worldBounds, parserStatus);
+            return IO::NodeReader::read(str, mapFormat, worldBounds, cacheData, parserStatus);
         }
 
         std::vector<BrushFace> GameImpl::doParseBrushFaces(const std::string& str, const MapFormat mapFormat, const vm::bbox3& worldBounds, Logger& logger) const {
@@ -250,6 +301,11 @@ namespace TrenchBroom {
             writer.writeNodes(nodes);
         }
 
+        std::string GameImpl::doWriteNodesCacheData(const std::string& str, const MapFormat mapFormat, Logger& logger) const {
+            IO::SimpleParserStatus parserStatus(logger);
+            return IO::NodeReader::writeCacheData(str, mapFormat, parserStatus);
+        }
+
         void GameImpl::doWriteBrushFacesToStream(WorldNode& world, const std::vector<BrushFace>& faces, std::ostream& stream) const {
             IO::NodeWriter writer(world, stream);
             writer.writeBrushFaces(faces);
@@ -272,8 +328,14 @@ namespace TrenchBroom {
             const auto paths = extractTextureCollections(entity);
 
             const auto fileSearchPaths = textureCollectionSearchPaths(documentPath);
-            IO::TextureLoader textureLoader(m_fs, fileSearchPaths, m_config.textureConfig(), logger);
-            textureLoader.loadTextures(paths, textureManager);
+            if (textureManager.loadAsynchronously()) {
+                // the loader outlives this call and is used from worker threads, so it must log to a thread safe logger
+                auto textureLoader = std::make_shared<IO::TextureLoader>(m_fs, fileSearchPaths, m_config.textureConfig(), textureManager.backgroundLogger(), textureManager.textureCache());
+                textureManager.setTextureCollectionsAsync(paths, std::move(textureLoader));
+            } else {
+                IO::TextureLoader textureLoader(m_fs, fileSearchPaths, m_config.textureConfig(), logger, textureManager.textureCache());
+                textureLoader.loadTextures(paths, textureManager);
+            }
         }
 
         std::vector<IO::Path> GameImpl::textureCollectionSearchPaths(const IO::Path& documentPath) const {
@@ -360,25 +422,68 @@ namespace TrenchBroom {
             }
         }
 
+        /**
+         * Creates the entity definitions from the class infos in the cache file for the entity definition file at the
+         * given path if it is valid. Otherwise, the class infos are parsed using the given parser and the cache file is
+         * written. Failing to read or write the cache file is not an error. If caching is disabled in the preferences,
+         * the file is always parsed.
+         *
+         * @param getIncludedPaths returns the absolute paths of the files which the parser included
+         */
+        template <typename G>
+        static std::vector<Assets::EntityDefinition*> parseEntityDefinitionsWithCache(IO::EntityDefinitionParser& parser, const std::string_view source, const IO::Path& path, IO::ParserStatus& status, const G& getIncludedPaths) {
+            if (!pref(Preferences::CacheParsedEntityDefinitions)) {
+                return parser.parseDefinitions(status);
+            }
+
+            const auto cachePath = IO::EntityDefinitionCache::cachePath(IO::SystemPaths::userDataDirectory() + IO::Path("cache/entitydefinitions"), path);
+
+            try {
+                if (IO::Disk::fileExists(cachePath)) {
+                    const auto cacheFile = IO::Disk::openFile(cachePath);
+                    auto cacheReader = cacheFile->reader().buffer();
+                    if (auto classInfos = IO::EntityDefinitionCache::read(cacheReader.stringView(), source)) {
+                        return parser.createDefinitions(status, *classInfos);
+                    }
+                }
+            } catch (const Exception&) {
+                // fall back to parsing the file
+            }
+
+            const auto classInfos = parser.parseClassInfos(status);
+
+            try {
+                const auto cacheData = IO::EntityDefinitionCache::write(source, getIncludedPaths(), classInfos);
+                IO::Disk::ensureDirectoryExists(cachePath.deleteLastComponent());
+                auto stream = openPathAsOutputStream(cachePath, std::ios::out | std::ios::binary);
+                stream.write(cacheData.data(), static_cast<std::streamsize>(cacheData.size()));
+            } catch (const Exception&) {
+                // the cache will be written on the next attempt
+            }
+
+            return parser.createDefinitions(status, classInfos);
+        }
+
         std::vector<Assets::EntityDefinition*> GameImpl::doLoadEntityDefinitions(IO::ParserStatus& status, const IO::Path& path) const {
             const auto extension = path.extension();
             const auto& defaultColor = m_config.entityConfig().defaultColor;
+            const auto noIncludedPaths = []() { return std::vector<IO::Path>{}; };
 
             if (kdl::ci::str_is_equal("fgd", extension)) {
                 auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
                 auto reader = file->reader().buffer();
                 IO::FgdParser parser(reader.stringView(), defaultColor, file->path());
-                return parser.parseDefinitions(status);
+                return parseEntityDefinitionsWithCache(parser, reader.stringView(), file->path(), status, [&]() { return parser.includedPaths(); });
             } else if (kdl::ci::str_is_equal("def", extension)) {
                 auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
                 auto reader = file->reader().buffer();
                 IO::DefParser parser(reader.stringView(), defaultColor);
-                return parser.parseDefinitions(status);
+                return parseEntityDefinitionsWithCache(parser, reader.stringView(), file->path(), status, noIncludedPaths);
             } else if (kdl::ci::str_is_equal("ent", extension)) {
                 auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
                 auto reader = file->reader().buffer();
                 IO::EntParser parser(reader.stringView(), defaultColor);
-                return parser.parseDefinitions(status);
+                return parseEntityDefinitionsWithCache(parser, reader.stringView(), file->path(), status, noIncludedPaths);
             } else {
                 throw GameException("Unknown entity definition format: '" + path.asString() + "'");
             }
@@ -44,7 +44,10 @@
 
 #include <vecmath/ray.h>
 
+#include <algorithm>
 #include <functional>
+#include <iterator>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -72,6 +75,40 @@ namespace TrenchBroom {
             return result;
         }
 
+        /**
+         * Returns a copy of the contents of the given node, transformed by the given transformation.
+         */
+        static kdl::result<NodeContents, BrushError> transformNodeContents(const Node& node, const vm::bbox3& worldBounds, const vm::mat4x4& transformation) {
+            using TransformResult = kdl::result<NodeContents, BrushError>;
+
+            return node.accept(kdl::overload(
+                [] (const WorldNode*) -> TransformResult { ensure(false, "Linked group structure is valid"); },
+                [] (const LayerNode*) -> TransformResult { ensure(false, "Linked group structure is valid"); },
+                [&](const GroupNode* groupNode) -> TransformResult {
+                    auto group = groupNode->group();
+                    group.transform(transformation);
+                    return NodeContents{std::move(group)};
+                },
+                [&](const EntityNode* entityNode) -> TransformResult {
+                    auto entity = entityNode->entity();
+                    entity.transform(transformation);
+                    return NodeContents{std::move(entity)};
+                },
+                [&](const BrushNode* brushNode) -> TransformResult {
+                    auto brush = brushNode->brush();
+                    return brush.transform(worldBounds, transformation, true)
+                        .and_then([&]() -> TransformResult {
+                            return NodeContents{std::move(brush)};
+                        });
+                },
+                [&](const PatchNode* patchNode) -> TransformResult {
+                    auto patch = patchNode->patch();
+                    patch.transform(transformation);
+                    return NodeContents{std::move(patch)};
+                }
+            ));
+        }
+
         /**
          * Given a node, clones its children recursively and applies the given transform.
          * 
@@ -80,36 +117,12 @@ namespace TrenchBroom {
         static kdl::result<std::vector<std::unique_ptr<Node>>, UpdateLinkedGroupsError> cloneAndTransformChildren(const Node& node, const vm::bbox3& worldBounds, const vm::mat4x4& transformation) {
             auto nodesToClone = collectNodesToCloneAndTransform(node);
 
-            using TransformResult = kdl::result<std::pair<const Node*, NodeContents>, BrushError>;
-
             // In parallel, produce pairs { node pointer, transformed contents } from the nodes in `nodesToClone`
             const auto transformResults = kdl::vec_parallel_transform(nodesToClone, [&](const Node* nodeToTransform) {
-                return nodeToTransform->accept(kdl::overload(
-                    [] (const WorldNode*) -> TransformResult { ensure(false, "Linked group structure is valid"); },
-                    [] (const LayerNode*) -> TransformResult { ensure(false, "Linked group structure is valid"); },
-                    [&](const GroupNode* groupNode) -> TransformResult {
-                        auto group = groupNode->group();
-                        group.transform(transformation);
-                        return std::make_pair(nodeToTransform, NodeContents{std::move(group)});
-                    },
-                    [&](const EntityNode* entityNode) -> TransformResult {
-                        auto entity = entityNode->entity();
-                        entity.transform(transformation);
-                        return std::make_pair(nodeToTransform, NodeContents{std::move(entity)});
-                    },
-                    [&](const BrushNode* brushNode) -> TransformResult {
-                        auto brush = brushNode->brush();
-                        return brush.transform(worldBounds, transformation, true)
-                            .and_then([&]() -> TransformResult {
-                                return std::make_pair(nodeToTransform, NodeContents{std::move(brush)});
-                            });
-                    },
-                    [&](const PatchNode* patchNode) -> TransformResult {
-                        auto patch = patchNode->patch();
-                        patch.transform(transformation);
-                        return std::make_pair(nodeToTransform, NodeContents{std::move(patch)});
-                    }
-                ));
+                return transformNodeContents(*nodeToTransform, worldBounds, transformation)
+                    .and_then([&](NodeContents&& transformedContents) {
+                        return std::make_pair(nodeToTransform, std::move(transformedContents));
+                    });
             });
 
             bool transformFailed = false;
@@ -215,15 +228,7 @@ namespace TrenchBroom {
             }
         }
 
-        static void preserveEntityProperties(EntityNode& clonedEntityNode, const EntityNode& correspondingEntityNode) {
-            if (clonedEntityNode.entity().protectedProperties().empty() && 
-                correspondingEntityNode.entity().protectedProperties().empty()) {
-                return;
-            }
-
-            auto clonedEntity = clonedEntityNode.entity();
-            const auto& correspondingEntity = correspondingEntityNode.entity();
-
+        static void preserveEntityProperties(Entity& clonedEntity, const Entity& correspondingEntity) {
             const auto allProtectedProperties = kdl::vec_sort_and_remove_duplicates(
                 kdl::vec_concat(
                     clonedEntity.protectedProperties(),
@@ -238,7 +243,16 @@ namespace TrenchBroom {
                     clonedEntity.addOrUpdateProperty(propertyKey, *propertyValue);
                 }
             }
+        }
+
+        static void preserveEntityProperties(EntityNode& clonedEntityNode, const EntityNode& correspondingEntityNode) {
+            if (clonedEntityNode.entity().protectedProperties().empty() && 
+                correspondingEntityNode.entity().protectedProperties().empty()) {
+                return;
+            }
 
+            auto clonedEntity = clonedEntityNode.entity();
+            preserveEntityProperties(clonedEntity, correspondingEntityNode.entity());
             clonedEntityNode.setEntity(std::move(clonedEntity));
         }
 
@@ -293,6 +307,146 @@ namespace TrenchBroom {
             });
         }
 
+        static bool haveSameType(const Node& lhs, const Node& rhs) {
+            return lhs.accept(kdl::overload(
+                [&](const WorldNode*)  { return dynamic_cast<const WorldNode*>(&rhs) != nullptr; },
+                [&](const LayerNode*)  { return dynamic_cast<const LayerNode*>(&rhs) != nullptr; },
+                [&](const GroupNode*)  { return dynamic_cast<const GroupNode*>(&rhs) != nullptr; },
+                [&](const EntityNode*) { return dynamic_cast<const EntityNode*>(&rhs) != nullptr; },
+                [&](const BrushNode*)  { return dynamic_cast<const BrushNode*>(&rhs) != nullptr; },
+                [&](const PatchNode*)  { return dynamic_cast<const PatchNode*>(&rhs) != nullptr; }
+            ));
+        }
+
+        static bool haveMatchingChildren(const Node& lhs, const Node& rhs) {
+            const auto& lhsChildren = lhs.children();
+            const auto& rhsChildren = rhs.children();
+            if (lhsChildren.size() != rhsChildren.size()) {
+                return false;
+            }
+
+            for (size_t i = 0u; i < lhsChildren.size(); ++i) {
+                if (!haveSameType(*lhsChildren[i], *rhsChildren[i]) || !haveMatchingChildren(*lhsChildren[i], *rhsChildren[i])) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        bool canUpdateLinkedGroupContents(const GroupNode& sourceGroupNode, const GroupNode& targetGroupNode) {
+            return haveMatchingChildren(sourceGroupNode, targetGroupNode);
+        }
+
+        /**
+         * Returns the indices of the children that lead from the given ancestor to the given node, or an empty optional
+         * if the given node is not a descendant of the given ancestor.
+         */
+        static std::optional<std::vector<size_t>> findChildIndexPath(const Node& ancestor, const Node& node) {
+            auto result = std::vector<size_t>{};
+
+            const auto* current = &node;
+            while (current != &ancestor) {
+                const auto* parent = current->parent();
+                if (parent == nullptr) {
+                    return std::nullopt;
+                }
+
+                const auto& siblings = parent->children();
+                const auto it = std::find(std::begin(siblings), std::end(siblings), current);
+                assert(it != std::end(siblings));
+                result.push_back(static_cast<size_t>(std::distance(std::begin(siblings), it)));
+
+                current = parent;
+            }
+
+            if (result.empty()) {
+                // the given node is the ancestor itself
+                return std::nullopt;
+            }
+
+            std::reverse(std::begin(result), std::end(result));
+            return result;
+        }
+
+        static Node* findNodeAtChildIndexPath(Node& ancestor, const std::vector<size_t>& path) {
+            auto* current = &ancestor;
+            for (const auto index : path) {
+                current = current->children()[index];
+            }
+            return current;
+        }
+
+        static bool contentsExceedWorldBounds(const NodeContents& contents, const vm::bbox3& worldBounds) {
+            return std::visit(kdl::overload(
+                [] (const Layer&)             { return false; },
+                // the bounds of a group are determined by its children
+                [] (const Group&)             { return false; },
+                [&](const Entity& entity)     { return !worldBounds.contains(EntityNode{entity}.logicalBounds()); },
+                [&](const Brush& brush)       { return !worldBounds.contains(brush.bounds()); },
+                [&](const BezierPatch& patch) { return !worldBounds.contains(patch.bounds()); }
+            ), contents.get());
+        }
+
+        kdl::result<UpdateLinkedGroupContentsResult, UpdateLinkedGroupsError> updateLinkedGroupContents(const GroupNode& sourceGroupNode, const std::vector<GroupNode*>& targetGroupNodes, const std::vector<const Node*>& changedNodes, const vm::bbox3& worldBounds) {
+            const auto& sourceGroup = sourceGroupNode.group();
+            const auto [success, invertedSourceTransformation] = vm::invert(sourceGroup.transformation());
+            if (!success) {
+                return UpdateLinkedGroupsError::TransformIsNotInvertible;
+            }
+
+            // only the changed nodes that belong to the source group need to be propagated
+            auto changedSourceNodes = std::vector<const Node*>{};
+            auto changedSourceNodePaths = std::vector<std::vector<size_t>>{};
+            for (const auto* changedNode : changedNodes) {
+                if (auto path = findChildIndexPath(sourceGroupNode, *changedNode)) {
+                    changedSourceNodes.push_back(changedNode);
+                    changedSourceNodePaths.push_back(std::move(*path));
+                }
+            }
+
+            auto result = UpdateLinkedGroupContentsResult{};
+
+            const auto targetGroupNodesToUpdate = kdl::vec_erase(targetGroupNodes, &sourceGroupNode);
+            for (auto* targetGroupNode : targetGroupNodesToUpdate) {
+                assert(canUpdateLinkedGroupContents(sourceGroupNode, *targetGroupNode));
+
+                const auto transformation = targetGroupNode->group().transformation() * invertedSourceTransformation;
+                auto transformResults = kdl::vec_parallel_transform(changedSourceNodes, [&](const Node* changedSourceNode) {
+                    return transformNodeContents(*changedSourceNode, worldBounds, transformation);
+                });
+
+                for (size_t i = 0u; i < transformResults.size(); ++i) {
+                    if (transformResults[i].is_error()) {
+                        return UpdateLinkedGroupsError::TransformFailed;
+                    }
+
+                    auto* targetNode = findNodeAtChildIndexPath(*targetGroupNode, changedSourceNodePaths[i]);
+                    auto contents = std::move(transformResults[i]).value();
+                    if (contentsExceedWorldBounds(contents, worldBounds)) {
+                        return UpdateLinkedGroupsError::UpdateExceedsWorldBounds;
+                    }
+
+                    targetNode->accept(kdl::overload(
+                        [] (const WorldNode*) {},
+                        [] (const LayerNode*) {},
+                        [&](const GroupNode* targetChildGroupNode) {
+                            std::get<Group>(contents.get()).setName(targetChildGroupNode->group().name());
+                        },
+                        [&](const EntityNode* targetEntityNode) {
+                            preserveEntityProperties(std::get<Entity>(contents.get()), targetEntityNode->entity());
+                        },
+                        [] (const BrushNode*) {},
+                        [] (const PatchNode*) {}
+                    ));
+
+                    result.emplace_back(targetNode, std::move(contents));
+                }
+            }
+
+            return {std::move(result)};
+        }
+
         GroupNode::GroupNode(Group group) :
         m_group(std::move(group)),
         m_editState(EditState::Closed),
@@ -303,6 +457,9 @@ namespace TrenchBroom {
         }
 
         Group GroupNode::setGroup(Group group) {
+            // notifies the world so that it can update its linked group index
+            const NotifyNodeChange nodeChange(this);
+
             using std::swap;
             swap(m_group, group);
             return group;
@@ -38,8 +38,10 @@
 
 namespace TrenchBroom {
     namespace Model {
+        class NodeContents;
         enum class UpdateLinkedGroupsError;
         using UpdateLinkedGroupsResult = std::vector<std::pair<Node*, std::vector<std::unique_ptr<Node>>>>;
+        using UpdateLinkedGroupContentsResult = std::vector<std::pair<Node*, NodeContents>>;
 
         /**
          * Updates the given target group nodes from the given source group node.
@@ -67,6 +69,28 @@ namespace TrenchBroom {
          */
         kdl::result<UpdateLinkedGroupsResult, UpdateLinkedGroupsError> updateLinkedGroups(const GroupNode& sourceGroupNode, const std::vector<Model::GroupNode*>& targetGroupNodes, const vm::bbox3& worldBounds);
 
+        /**
+         * Checks whether the given target group node can be updated from the given source group node using
+         * `updateLinkedGroupContents`. This is the case if the children of both group nodes have the same structure,
+         * i.e., if the corresponding children are of the same type and have matching children themselves.
+         */
+        bool canUpdateLinkedGroupContents(const GroupNode& sourceGroupNode, const GroupNode& targetGroupNode);
+
+        /**
+         * Updates the given target group nodes from the given source group node, but unlike `updateLinkedGroups`, only
+         * propagates the contents of the given changed nodes instead of cloning all children of the source group node.
+         * Changed nodes that are not descendants of the source group node are ignored.
+         *
+         * The nodes of the source group and a target group are matched by their positions in the node tree, so for
+         * every target group node, `canUpdateLinkedGroupContents` must return true. The contents of the changed nodes
+         * are transformed and their group names and protected entity properties are preserved like in
+         * `updateLinkedGroups`, and the same errors can occur.
+         *
+         * If this operation succeeds, a vector of pairs is returned where each pair consists of a descendant of a target
+         * node and its new contents.
+         */
+        kdl::result<UpdateLinkedGroupContentsResult, UpdateLinkedGroupsError> updateLinkedGroupContents(const GroupNode& sourceGroupNode, const std::vector<Model::GroupNode*>& targetGroupNodes, const std::vector<const Node*>& changedNodes, const vm::bbox3& worldBounds);
+
         /**
          * A group of nodes that can be edited as one.
          *
@@ -19,16 +19,164 @@
 
 #pragma once
 
+#include "Ensure.h"
 #include "FloatType.h"
 #include "Macros.h"
 #include "Model/HitType.h"
 
 #include <vecmath/vec.h>
 
-#include <any>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace TrenchBroom {
     namespace Model {
+        /**
+         * Holds the target of a hit, which can be of any copyable type.
+         *
+         * Unlike std::any, targets up to the size of a line segment are stored in place, so that creating, copying
+         * and sorting hits for nodes, faces and most handles doesn't allocate any memory. Larger targets are stored on
+         * the heap.
+         */
+        class HitTarget {
+        private:
+            static constexpr size_t BufferSize = 6u * sizeof(FloatType);
+            using Buffer = std::aligned_storage_t<BufferSize, alignof(std::max_align_t)>;
+
+            template <typename T>
+            static constexpr bool StoredInPlace = sizeof(T) <= sizeof(Buffer) && alignof(T) <= alignof(Buffer) && std::is_nothrow_move_constructible_v<T>;
+
+            struct Operations {
+                void (*copy)(const Buffer& from, Buffer& to);
+                void (*move)(Buffer& from, Buffer& to);
+                void (*destroy)(Buffer& buffer);
+            };
+
+            // the address of the operations also identifies the type of the target
+            template <typename T>
+            static const Operations TypeOperations;
+
+            const Operations* m_operations;
+            Buffer m_buffer;
+        public:
+            HitTarget() :
+            m_operations(nullptr) {}
+
+            template <typename T, typename = std::enable_if_t<!std::is_same_v<std::decay_t<T>, HitTarget>>>
+            HitTarget(T&& target) :
+            m_operations(&TypeOperations<std::decay_t<T>>) {
+                using U = std::decay_t<T>;
+                if constexpr (StoredInPlace<U>) {
+                    new (&m_buffer) U(std::forward<T>(target));
+                } else {
+                    new (&m_buffer) U*(new U(std::forward<T>(target)));
+                }
+            }
+
+            HitTarget(const HitTarget& other) :
+            m_operations(other.m_operations) {
+                if (m_operations) {
+                    m_operations->copy(other.m_buffer, m_buffer);
+                }
+            }
+
+            HitTarget(HitTarget&& other) noexcept :
+            m_operations(other.m_operations) {
+                if (m_operations) {
+                    m_operations->move(other.m_buffer, m_buffer);
+                    other.m_operations = nullptr;
+                }
+            }
+
+            ~HitTarget() {
+                reset();
+            }
+
+            HitTarget& operator=(const HitTarget& other) {
+                if (this != &other) {
+                    reset();
+                    if (other.m_operations) {
+                        other.m_operations->copy(other.m_buffer, m_buffer);
+                        m_operations = other.m_operations;
+                    }
+                }
+                return *this;
+            }
+
+            HitTarget& operator=(HitTarget&& other) noexcept {
+                if (this != &other) {
+                    reset();
+                    if (other.m_operations) {
+                        other.m_operations->move(other.m_buffer, m_buffer);
+                        m_operations = other.m_operations;
+                        other.m_operations = nullptr;
+                    }
+                }
+                return *this;
+            }
+
+            template <typename T>
+            const T& get() const {
+                ensure(m_operations == &TypeOperations<T>, "hit target has a different type");
+                return *get<T>(m_buffer);
+            }
+        private:
+            void reset() {
+                if (m_operations) {
+                    m_operations->destroy(m_buffer);
+                    m_operations = nullptr;
+                }
+            }
+
+            template <typename T>
+            static T* get(Buffer& buffer) {
+                if constexpr (StoredInPlace<T>) {
+                    return std::launder(reinterpret_cast<T*>(&buffer));
+                } else {
+                    return *std::launder(reinterpret_cast<T**>(&buffer));
+                }
+            }
+
+            template <typename T>
+            static const T* get(const Buffer& buffer) {
+                return get<T>(const_cast<Buffer&>(buffer));
+            }
+
+            template <typename T>
+            static void copy(const Buffer& from, Buffer& to) {
+                if constexpr (StoredInPlace<T>) {
+                    new (&to) T(*get<T>(from));
+                } else {
+                    new (&to) T*(new T(*get<T>(from)));
+                }
+            }
+
+            template <typename T>
+            static void move(Buffer& from, Buffer& to) {
+                if constexpr (StoredInPlace<T>) {
+                    new (&to) T(std::move(*get<T>(from)));
+                    get<T>(from)->~T();
+                } else {
+                    // just take over the pointer
+                    new (&to) T*(get<T>(from));
+                }
+            }
+
+            template <typename T>
+            static void destroy(Buffer& buffer) {
+                if constexpr (StoredInPlace<T>) {
+                    get<T>(buffer)->~T();
+                } else {
+                    delete get<T>(buffer);
+                }
+            }
+        };
+
+        template <typename T>
+        const HitTarget::Operations HitTarget::TypeOperations = { &HitTarget::copy<T>, &HitTarget::move<T>, &HitTarget::destroy<T> };
+
         class Hit {
         public:
             static const Hit NoHit;
@@ -36,7 +184,7 @@ namespace TrenchBroom {
             HitType::Type m_type;
             FloatType m_distance;
             vm::vec3 m_hitPoint;
-            std::any m_target;
+            HitTarget m_target;
             FloatType m_error;
         public:
             template <typename T>
@@ -63,7 +211,7 @@ namespace TrenchBroom {
 
             template <typename T>
             T target() const {
-                return std::any_cast<T>(m_target);
+                return m_target.get<std::remove_cv_t<std::remove_reference_t<T>>>();
             }
         };
 
@@ -0,0 +1,81 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "InternedString.h"
+
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace TrenchBroom {
+    namespace Model {
+        namespace {
+            class InternedStringTable {
+            private:
+                std::shared_mutex m_mutex;
+                // deque never moves its elements, so the views into the strings remain valid
+                std::deque<std::string> m_strings;
+                std::unordered_map<std::string_view, const std::string*> m_index;
+            public:
+                const std::string* intern(const std::string_view str) {
+                    {
+                        std::shared_lock<std::shared_mutex> lock(m_mutex);
+                        if (const auto it = m_index.find(str); it != m_index.end()) {
+                            return it->second;
+                        }
+                    }
+
+                    std::unique_lock<std::shared_mutex> lock(m_mutex);
+                    // another thread may have interned the string in the meantime
+                    if (const auto it = m_index.find(str); it != m_index.end()) {
+                        return it->second;
+                    }
+
+                    const auto& result = m_strings.emplace_back(str);
+                    m_index.emplace(std::string_view(result), &result);
+                    return &result;
+                }
+            };
+
+            InternedStringTable& table() {
+                // intentionally leaked so that handles remain valid during static destruction
+                static auto* instance = new InternedStringTable();
+                return *instance;
+            }
+
+            const std::string* emptyString() {
+                static const auto* result = table().intern(std::string_view());
+                return result;
+            }
+        }
+
+        InternedString::InternedString() :
+        m_str(emptyString()) {}
+
+        InternedString::InternedString(const std::string_view str) :
+        m_str(table().intern(str)) {}
+
+        std::ostream& operator<<(std::ostream& str, const InternedString& internedString) {
+            str << internedString.str();
+            return str;
+        }
+    }
+}
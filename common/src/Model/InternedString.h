@@ -0,0 +1,66 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * A handle to a string that is stored exactly once in a process wide table. Handles to equal strings refer
+         * to the same storage, so comparing two handles is a pointer comparison and copying a handle does not
+         * allocate. The interned strings are never released, so this is only suitable for strings drawn from a small
+         * set of distinct values, such as texture names.
+         *
+         * Interning is thread safe.
+         */
+        class InternedString {
+        private:
+            const std::string* m_str;
+        public:
+            /**
+             * Creates a handle to the empty string.
+             */
+            InternedString();
+
+            explicit InternedString(std::string_view str);
+
+            const std::string& str() const {
+                return *m_str;
+            }
+
+            bool empty() const {
+                return m_str->empty();
+            }
+
+            friend bool operator==(const InternedString& lhs, const InternedString& rhs) {
+                return lhs.m_str == rhs.m_str;
+            }
+
+            friend bool operator!=(const InternedString& lhs, const InternedString& rhs) {
+                return lhs.m_str != rhs.m_str;
+            }
+
+            friend std::ostream& operator<<(std::ostream& str, const InternedString& internedString);
+        };
+    }
+}
@@ -40,6 +40,12 @@ namespace TrenchBroom {
 
             size_t seqId() const;
             size_t lineNumber() const;
+
+            /**
+             * Formats the description of this issue. Issues are created in large numbers, but only the descriptions
+             * of the issues currently shown in the issue browser are ever needed, so issues store only what they need
+             * to format their descriptions, and the descriptions are formatted on every call.
+             */
             std::string description() const;
 
             IssueType type() const;
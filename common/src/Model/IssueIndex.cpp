@@ -0,0 +1,218 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IssueIndex.h"
+
+#include "Profiler.h"
+#include "Model/BrushNode.h"
+#include "Model/EntityNode.h"
+#include "Model/EntityNodeBase.h"
+#include "Model/GroupNode.h"
+#include "Model/LayerNode.h"
+#include "Model/Node.h"
+#include "Model/PatchNode.h"
+#include "Model/WorldNode.h"
+
+#include <kdl/overload.h>
+#include <kdl/parallel.h>
+
+#include <algorithm>
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * The number of nodes that are validated by one task. Validating a single brush is cheap, so handing out
+         * individual nodes would be dominated by the synchronization overhead of the thread pool.
+         */
+        static const size_t ValidationRangeSize = 64u;
+
+        std::vector<Issue*> validateIssues(const std::vector<Node*>& nodes, const std::vector<IssueGenerator*>& issueGenerators) {
+            // Validating a node can populate lazily computed caches of the node itself, such as the classname and
+            // the bounds of an entity, so these are computed up front.
+            for (auto* node : nodes) {
+                node->accept(kdl::overload(
+                    [&](WorldNode* world)   { world->entity().classname(); world->issues(issueGenerators); },
+                    [&](LayerNode* layer)   { layer->issues(issueGenerators); },
+                    [&](GroupNode* group)   { group->issues(issueGenerators); },
+                    [] (EntityNode* entity) { entity->entity().classname(); entity->logicalBounds(); },
+                    [] (BrushNode*)         {},
+                    [] (PatchNode*)         {}
+                ));
+            }
+
+            const auto rangeCount = (nodes.size() + ValidationRangeSize - 1u) / ValidationRangeSize;
+            auto rangeIssues = std::vector<std::vector<Issue*>>(rangeCount);
+            kdl::parallel_for(rangeCount, [&](const size_t i) {
+                const auto first = i * ValidationRangeSize;
+                const auto last = std::min(first + ValidationRangeSize, nodes.size());
+                auto& issues = rangeIssues[i];
+                for (auto j = first; j < last; ++j) {
+                    const auto& nodeIssues = nodes[j]->issues(issueGenerators);
+                    issues.insert(std::end(issues), std::begin(nodeIssues), std::end(nodeIssues));
+                }
+            });
+
+            auto result = std::vector<Issue*>{};
+            for (auto& issues : rangeIssues) {
+                result.insert(std::end(result), std::begin(issues), std::end(issues));
+            }
+            return result;
+        }
+
+        std::vector<Issue*> validateAllIssues(WorldNode& world) {
+            TB_PROFILE_SCOPE("validateAllIssues");
+            auto nodes = std::vector<Node*>{};
+            world.accept([&](auto&& thisLambda, Node* node) {
+                nodes.push_back(node);
+                node->visitChildren(thisLambda);
+            });
+            return validateIssues(nodes, world.registeredIssueGenerators());
+        }
+
+        void IssueIndex::reset(WorldNode* world) {
+            clear();
+            if (world != nullptr) {
+                world->accept([&](auto&& thisLambda, Node* node) {
+                    scheduleNode(node);
+                    node->visitChildren(thisLambda);
+                });
+            }
+        }
+
+        void IssueIndex::clear() {
+            m_issues.clear();
+            m_dirtyNodes.clear();
+        }
+
+        void IssueIndex::nodesWereAdded(const std::vector<Node*>& nodes) {
+            for (auto* node : nodes) {
+                node->accept([&](auto&& thisLambda, Node* descendant) {
+                    scheduleNode(descendant);
+                    scheduleLinkedNodes(descendant);
+                    descendant->visitChildren(thisLambda);
+                });
+                scheduleNodeAndAncestors(node);
+            }
+        }
+
+        void IssueIndex::nodesWillBeRemoved(const std::vector<Node*>& nodes) {
+            for (auto* node : nodes) {
+                node->accept([&](auto&& thisLambda, Node* descendant) {
+                    scheduleLinkedNodes(descendant);
+                    descendant->visitChildren(thisLambda);
+                });
+                scheduleNodeAndAncestors(node);
+            }
+        }
+
+        void IssueIndex::nodesWereRemoved(const std::vector<Node*>& nodes) {
+            for (auto* node : nodes) {
+                node->accept([&](auto&& thisLambda, Node* descendant) {
+                    forgetNode(descendant);
+                    descendant->visitChildren(thisLambda);
+                });
+            }
+        }
+
+        void IssueIndex::nodesWillChange(const std::vector<Node*>& nodes) {
+            for (auto* node : nodes) {
+                scheduleLinkedNodes(node);
+            }
+        }
+
+        void IssueIndex::nodesDidChange(const std::vector<Node*>& nodes) {
+            for (auto* node : nodes) {
+                scheduleNodeAndAncestors(node);
+                scheduleLinkedNodes(node);
+            }
+        }
+
+        bool IssueIndex::hasDirtyNodes() const {
+            return !m_dirtyNodes.empty();
+        }
+
+        bool IssueIndex::validate(const std::vector<IssueGenerator*>& issueGenerators) {
+            for (const auto& [node, issues] : m_issues) {
+                if (!node->issuesValid()) {
+                    m_dirtyNodes.insert(node);
+                }
+            }
+
+            if (m_dirtyNodes.empty()) {
+                return false;
+            }
+
+            TB_PROFILE_SCOPE("IssueIndex::validate");
+            validateIssues(std::vector<Node*>(std::begin(m_dirtyNodes), std::end(m_dirtyNodes)), issueGenerators);
+
+            for (auto* node : m_dirtyNodes) {
+                const auto& issues = node->issues(issueGenerators);
+                if (issues.empty()) {
+                    m_issues.erase(node);
+                } else {
+                    m_issues[node] = issues;
+                }
+            }
+
+            m_dirtyNodes.clear();
+            return true;
+        }
+
+        std::vector<Issue*> IssueIndex::issues() const {
+            auto result = std::vector<Issue*>{};
+            for (const auto& [node, issues] : m_issues) {
+                result.insert(std::end(result), std::begin(issues), std::end(issues));
+            }
+            return result;
+        }
+
+        void IssueIndex::scheduleNode(Node* node) {
+            m_dirtyNodes.insert(node);
+        }
+
+        void IssueIndex::scheduleNodeAndAncestors(Node* node) {
+            while (node != nullptr) {
+                scheduleNode(node);
+                node = node->parent();
+            }
+        }
+
+        void IssueIndex::scheduleLinkedNodes(Node* node) {
+            const auto scheduleLinks = [&](const std::vector<EntityNodeBase*>& linkedNodes) {
+                for (auto* linkedNode : linkedNodes) {
+                    scheduleNode(linkedNode);
+                }
+            };
+
+            node->accept(kdl::overload(
+                [&](WorldNode* world)   { scheduleLinks(world->linkSources()); scheduleLinks(world->linkTargets()); scheduleLinks(world->killSources()); scheduleLinks(world->killTargets()); },
+                [] (LayerNode*)         {},
+                [] (GroupNode*)         {},
+                [&](EntityNode* entity) { scheduleLinks(entity->linkSources()); scheduleLinks(entity->linkTargets()); scheduleLinks(entity->killSources()); scheduleLinks(entity->killTargets()); },
+                [] (BrushNode*)         {},
+                [] (PatchNode*)         {}
+            ));
+        }
+
+        void IssueIndex::forgetNode(Node* node) {
+            m_issues.erase(node);
+            m_dirtyNodes.erase(node);
+        }
+    }
+}
@@ -0,0 +1,97 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        class Issue;
+        class IssueGenerator;
+        class Node;
+        class WorldNode;
+
+        /**
+         * Validates the issues of the given nodes and returns them, in the order of the given nodes.
+         *
+         * The nodes are split into ranges that are validated concurrently. Nodes whose issue generators look at
+         * other nodes, that is worlds, layers and groups, are validated up front on the calling thread, as are
+         * lazily computed caches that the generators would otherwise populate concurrently.
+         */
+        std::vector<Issue*> validateIssues(const std::vector<Node*>& nodes, const std::vector<IssueGenerator*>& issueGenerators);
+
+        /**
+         * Validates the issues of all nodes of the given world using its registered issue generators.
+         */
+        std::vector<Issue*> validateAllIssues(WorldNode& world);
+
+        /**
+         * Keeps track of the issues of all nodes of a world and revalidates only the nodes that are affected by a
+         * change.
+         *
+         * Changing a node also invalidates the issues of its ancestors and of the entities linked to it, so these
+         * are scheduled for validation, too. Linked entities must be scheduled before the change because the links
+         * may be gone afterwards, so the index must be told about changes and removals before and after they happen.
+         *
+         * The index holds pointers to the issues owned by the nodes, but never dereferences them. Before validating,
+         * any known node whose issues were invalidated behind the index's back is rescheduled, so that no stale
+         * issue is ever returned.
+         */
+        class IssueIndex {
+        private:
+            std::unordered_map<Node*, std::vector<Issue*>> m_issues;
+            std::unordered_set<Node*> m_dirtyNodes;
+        public:
+            /**
+             * Forgets all issues and schedules every node of the given world for validation. If the given world is
+             * null, the index is cleared.
+             */
+            void reset(WorldNode* world);
+            void clear();
+
+            void nodesWereAdded(const std::vector<Node*>& nodes);
+            void nodesWillBeRemoved(const std::vector<Node*>& nodes);
+            void nodesWereRemoved(const std::vector<Node*>& nodes);
+            void nodesWillChange(const std::vector<Node*>& nodes);
+            void nodesDidChange(const std::vector<Node*>& nodes);
+
+            bool hasDirtyNodes() const;
+
+            /**
+             * Validates the issues of all scheduled nodes using validateIssues().
+             *
+             * @return true if any node was validated
+             */
+            bool validate(const std::vector<IssueGenerator*>& issueGenerators);
+
+            /**
+             * Returns the issues of all validated nodes, in no particular order.
+             */
+            std::vector<Issue*> issues() const;
+        private:
+            void scheduleNode(Node* node);
+            void scheduleNodeAndAncestors(Node* node);
+            void scheduleLinkedNodes(Node* node);
+            void forgetNode(Node* node);
+        };
+    }
+}
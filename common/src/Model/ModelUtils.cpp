@@ -33,8 +33,13 @@
 #include "Model/WorldNode.h"
 
 #include <kdl/overload.h>
+#include <kdl/parallel.h>
 #include <kdl/vector_utils.h>
 
+#include <vecmath/bbox.h>
+
+#include <algorithm>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom {
@@ -114,24 +119,7 @@ namespace TrenchBroom {
         }
 
         std::vector<Model::GroupNode*> findLinkedGroups(Model::WorldNode& worldNode, const std::string& linkedGroupId) {
-            auto result = std::vector<Model::GroupNode*>{};
-
-            worldNode.accept(kdl::overload(
-                [] (auto&& thisLambda, Model::WorldNode* w) { w->visitChildren(thisLambda); },
-                [] (auto&& thisLambda, Model::LayerNode* l) { l->visitChildren(thisLambda); },
-                [&](auto&& thisLambda, Model::GroupNode* g) {
-                    if (g->group().linkedGroupId() == linkedGroupId) {
-                        result.push_back(g);
-                    } else {
-                        g->visitChildren(thisLambda);
-                    }
-                },
-                [] (Model::EntityNode*) {},
-                [] (Model::BrushNode*)  {},
-                [] (Model::PatchNode*)  {}
-            ));
-
-            return result;
+            return worldNode.findLinkedGroups(linkedGroupId);
         }
 
         static void collectWithParents(Node* node, std::vector<Node*>& result) {
@@ -225,6 +213,21 @@ namespace TrenchBroom {
             return allNodes;
         }
 
+        NodeCollection collectNodesByType(const std::vector<Node*>& nodes) {
+            auto result = NodeCollection{};
+
+            Node::visitAll(nodes, kdl::overload(
+                [] (auto&& thisLambda, WorldNode* world)   { world->visitChildren(thisLambda); },
+                [&](auto&& thisLambda, LayerNode* layer)   { result.addNode(layer); layer->visitChildren(thisLambda); },
+                [&](auto&& thisLambda, GroupNode* group)   { result.addNode(group); group->visitChildren(thisLambda); },
+                [&](auto&& thisLambda, EntityNode* entity) { result.addNode(entity); entity->visitChildren(thisLambda); },
+                [&](BrushNode* brush)                      { result.addNode(brush); },
+                [&](PatchNode* patch)                      { result.addNode(patch); }
+            ));
+
+            return result;
+        }
+
         /**
          * Recursively collect brushes and entities from the given vector of node trees such that
          * the returned nodes match the given predicate. A matching brush is only returned if it
@@ -232,18 +235,31 @@ namespace TrenchBroom {
          * in the given vector of brushes such that the predicate evaluates to true for that pair of
          * node and brush.
          *
-         * The given predicate must be a function that maps a node and a brush to true or false.
+         * The given predicate must be a function that maps a node and a brush to true or false. It is only invoked
+         * for pairs whose bounds intersect, and it is invoked in parallel, so it must not modify any nodes.
          */
         template <typename P>
         static std::vector<Node*> collectMatchingNodes(const std::vector<Node*>& nodes, const std::vector<BrushNode*>& brushes, const P& predicate) {
-            auto result = std::vector<Model::Node*>{};
+            if (brushes.empty()) {
+                return {};
+            }
+
+            // copy the bounds of the query brushes into a contiguous array so that the per candidate tests need
+            // not chase the brush node pointers
+            const auto brushBounds = kdl::vec_transform(brushes, [](const auto* brush) { return brush->logicalBounds(); });
+
+            auto queryBounds = brushBounds.front();
+            for (const auto& bounds : brushBounds) {
+                queryBounds = vm::merge(queryBounds, bounds);
+            }
+            const auto queryBrushes = std::unordered_set<const BrushNode*>{std::begin(brushes), std::end(brushes)};
 
+            // Collect the candidates whose bounds intersect the query, which also computes and caches the bounds
+            // of any groups and entities before the exact tests run in parallel.
+            auto candidates = std::vector<Model::Node*>{};
             const auto collectIfMatching = [&](auto* node) {
-                for (const auto* brush : brushes) {
-                    if (predicate(node, brush)) {
-                        result.push_back(node);
-                        return;
-                    }
+                if (node->logicalBounds().intersects(queryBounds)) {
+                    candidates.push_back(node);
                 }
             };
 
@@ -267,7 +283,7 @@ namespace TrenchBroom {
                     },
                     [&](Model::BrushNode* brush)  { 
                         // if `brush` is one of the search query nodes, don't count it as touching
-                        if (!kdl::vec_contains(brushes, brush)) {
+                        if (queryBrushes.count(brush) == 0u) {
                             collectIfMatching(brush);
                         }
                     },
@@ -278,6 +294,22 @@ namespace TrenchBroom {
                 ));
             }
 
+            const auto matches = kdl::vec_parallel_transform(candidates, [&](const Model::Node* node) {
+                const auto& nodeBounds = node->logicalBounds();
+                for (size_t i = 0u; i < brushBounds.size(); ++i) {
+                    if (brushBounds[i].intersects(nodeBounds) && predicate(node, brushes[i])) {
+                        return true;
+                    }
+                }
+                return false;
+            });
+
+            auto result = std::vector<Model::Node*>{};
+            for (size_t i = 0u; i < candidates.size(); ++i) {
+                if (matches[i]) {
+                    result.push_back(candidates[i]);
+                }
+            }
             return result;
         }
 
@@ -383,10 +415,15 @@ namespace TrenchBroom {
                     [] (auto&& thisLambda, GroupNode* group)   { group->visitChildren(thisLambda); },
                     [] (auto&& thisLambda, EntityNode* entity) { entity->visitChildren(thisLambda); },
                     [&](BrushNode* brushNode) {
+                        // only test the brush once, the face test only needs to check the face's tags
+                        if (!editorContext.visible(brushNode) || !editorContext.editable(brushNode)) {
+                            return;
+                        }
+
                         const auto& brush = brushNode->brush();
                         for (size_t i = 0; i < brush.faceCount(); ++i) {
                             const auto& face = brush.face(i);
-                            if (editorContext.selectable(brushNode, face)) {
+                            if (editorContext.faceVisible(face)) {
                                 faces.emplace_back(brushNode, i);
                             }
                         }
@@ -22,6 +22,7 @@
 #include "FloatType.h"
 #include "Model/HitType.h"
 #include "Model/Node.h"
+#include "Model/NodeCollection.h"
 
 #include <vecmath/bbox.h>
 
@@ -67,6 +68,13 @@ namespace TrenchBroom {
 
         std::vector<Node*> collectNodes(const std::vector<Node*>& nodes);
 
+        /**
+         * Collects the given nodes and all of their descendants in a node collection, which keeps one vector per
+         * node type. Bulk algorithms that only process nodes of some types can iterate over these vectors directly
+         * instead of visiting the entire node tree once per pass. World nodes are traversed, but not collected.
+         */
+        NodeCollection collectNodesByType(const std::vector<Node*>& nodes);
+
         std::vector<Node*> collectTouchingNodes(const std::vector<Node*>& nodes, const std::vector<BrushNode*>& brushes);
         std::vector<Node*> collectContainedNodes(const std::vector<Node*>& nodes, const std::vector<BrushNode*>& brushes);
 
@@ -26,12 +26,15 @@
 #include "Model/LockState.h"
 #include "Model/VisibilityState.h"
 
+#include <kdl/parallel.h>
 #include <kdl/vector_utils.h>
 
 #include <vecmath/bbox.h>
 
+#include <algorithm>
 #include <cassert>
 #include <iterator>
+#include <memory>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -148,10 +151,11 @@ namespace TrenchBroom {
         }
 
         std::vector<Node*> Node::cloneRecursively(const vm::bbox3& worldBounds, const std::vector<Node*>& nodes) {
-            std::vector<Node*> clones;
-            clones.reserve(nodes.size());
-            cloneRecursively(worldBounds, std::begin(nodes), std::end(nodes), std::back_inserter(clones));
-            return clones;
+            // cloning only reads the original nodes, and the clones are not connected to anything yet
+            auto clones = kdl::vec_parallel_transform(nodes, [&](const Node* node) {
+                return std::unique_ptr<Node>(node->cloneRecursively(worldBounds));
+            });
+            return kdl::vec_transform(std::move(clones), [](std::unique_ptr<Node>&& clone) { return clone.release(); });
         }
 
         size_t Node::depth() const {
@@ -225,7 +229,26 @@ namespace TrenchBroom {
         }
 
         void Node::addChildren(const std::vector<Node*>& children) {
-            addChildren(std::begin(children), std::end(children), children.size());
+            if (children.empty()) {
+                return;
+            }
+
+            m_children.reserve(m_children.size() + children.size());
+
+            descendantsWillBeAdded();
+            size_t descendantCountDelta = 0;
+            try {
+                for (auto* child : children) {
+                    doAddChild(child);
+                    descendantCountDelta += child->descendantCount() + 1;
+                }
+            } catch (...) {
+                incDescendantCount(descendantCountDelta);
+                descendantsWereAdded();
+                throw;
+            }
+            incDescendantCount(descendantCountDelta);
+            descendantsWereAdded();
         }
 
         Node& Node::addChild(Node* child) {
@@ -263,6 +286,34 @@ namespace TrenchBroom {
             return oldChildren;
         }
 
+        void Node::removeChildren(const std::vector<Node*>& children) {
+            if (children.empty()) {
+                return;
+            }
+
+            size_t descendantCountDelta = 0;
+            for (auto* child : children) {
+                ensure(child != nullptr, "child is null");
+                assert(child->parent() == this);
+                assert(canRemoveChild(child));
+
+                childWillBeRemoved(child);
+                child->setParent(nullptr);
+                descendantCountDelta += child->descendantCount() + 1;
+            }
+
+            // the detached children are exactly the ones without a parent
+            m_children.erase(std::remove_if(std::begin(m_children), std::end(m_children), [](const Node* child) {
+                return child->parent() == nullptr;
+            }), std::end(m_children));
+
+            for (auto* child : children) {
+                childWasRemoved(child);
+            }
+
+            decDescendantCount(descendantCountDelta);
+        }
+
         void Node::removeChild(Node* child) {
             doRemoveChild(child);
             decDescendantCount(child->descendantCount() + 1u);
@@ -344,6 +395,18 @@ namespace TrenchBroom {
             invalidateIssues();
         }
 
+        void Node::descendantsWillBeAdded() {
+            doDescendantsWillBeAdded();
+            if (m_parent != nullptr)
+                m_parent->descendantsWillBeAdded();
+        }
+
+        void Node::descendantsWereAdded() {
+            doDescendantsWereAdded();
+            if (m_parent != nullptr)
+                m_parent->descendantsWereAdded();
+        }
+
         void Node::descendantWillBeRemoved(Node* node, const size_t depth) {
             doDescendantWillBeRemoved(node, depth);
             if (m_parent != nullptr)
@@ -705,6 +768,10 @@ namespace TrenchBroom {
             m_issuesValid = false;
         }
 
+        bool Node::issuesValid() const {
+            return m_issuesValid;
+        }
+
         void Node::clearIssues() const {
             kdl::vec_clear_and_delete(m_issues);
         }
@@ -740,6 +807,8 @@ namespace TrenchBroom {
         void Node::doDescendantWasAdded(Node* /* node */, const size_t /* depth */) {}
         void Node::doDescendantWillBeRemoved(Node* /* node */, const size_t /* depth */) {}
         void Node::doDescendantWasRemoved(Node* /* oldParent */, Node* /* node */, const size_t /* depth */) {}
+        void Node::doDescendantsWillBeAdded() {}
+        void Node::doDescendantsWereAdded() {}
 
         void Node::doParentWillChange() {}
         void Node::doParentDidChange() {}
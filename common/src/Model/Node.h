@@ -120,11 +120,17 @@ namespace TrenchBroom {
         public: // cloning and snapshots
             Node* clone(const vm::bbox3& worldBounds) const;
             Node* cloneRecursively(const vm::bbox3& worldBounds) const;
+
+            /**
+             * Clones the given nodes recursively. The nodes are cloned in parallel, and so are the children of each
+             * node, so the given nodes must not be modified concurrently. The clones are returned in the order of
+             * the given nodes.
+             */
+            static std::vector<Node*> cloneRecursively(const vm::bbox3& worldBounds, const std::vector<Node*>& nodes);
         protected:
             void cloneAttributes(Node* node) const;
 
             static std::vector<Node*> clone(const vm::bbox3& worldBounds, const std::vector<Node*>& nodes);
-            static std::vector<Node*> cloneRecursively(const vm::bbox3& worldBounds, const std::vector<Node*>& nodes);
 
             template <typename I, typename O>
             static void clone(const vm::bbox3& worldBounds, I cur, I end, O result) {
@@ -162,19 +168,16 @@ namespace TrenchBroom {
 
             bool shouldAddToSpacialIndex() const;
         public:
+            /**
+             * Adds the given children to this node. The ancestors of this node are told that the children are added
+             * as one batch, which allows them to defer expensive bookkeeping, such as updating the spatial index of
+             * the world, until all children have been added.
+             */
             void addChildren(const std::vector<Node*>& children);
 
             template <typename I>
-            void addChildren(I cur, I end, size_t count = 0) {
-                m_children.reserve(m_children.size() + count);
-                size_t descendantCountDelta = 0;
-                while (cur != end) {
-                    Node* child = *cur;
-                    doAddChild(child);
-                    descendantCountDelta += child->descendantCount() + 1;
-                    ++cur;
-                }
-                incDescendantCount(descendantCountDelta);
+            void addChildren(I cur, I end) {
+                addChildren(std::vector<Node*>(cur, end));
             }
 
             Node& addChild(Node* child);
@@ -183,16 +186,16 @@ namespace TrenchBroom {
 
             template <typename I>
             void removeChildren(I cur, I end) {
-                size_t descendantCountDelta = 0;
-                while (cur != end) {
-                    Node* child = *cur;
-                    doRemoveChild(child);
-                    descendantCountDelta += child->descendantCount() + 1;
-                    ++cur;
-                }
-                decDescendantCount(descendantCountDelta);
+                removeChildren(std::vector<Node*>(cur, end));
             }
 
+            /**
+             * Removes the given children from this node. The children are detached first, then the list of
+             * children is compacted in a single pass, so removing many children takes linear time instead of
+             * erasing each one from the list individually.
+             */
+            void removeChildren(const std::vector<Node*>& children);
+
             void removeChild(Node* child);
 
             bool canAddChild(const Node* child) const;
@@ -230,6 +233,9 @@ namespace TrenchBroom {
             void descendantWillBeRemoved(Node* node, size_t depth);
             void descendantWasRemoved(Node* oldParent, Node* node, size_t depth);
 
+            void descendantsWillBeAdded();
+            void descendantsWereAdded();
+
             void incDescendantCount(size_t delta);
             void decDescendantCount(size_t delta);
 
@@ -328,6 +334,7 @@ namespace TrenchBroom {
             bool containsLine(size_t lineNumber) const;
         public: // issue management
             const std::vector<Issue*>& issues(const std::vector<IssueGenerator*>& issueGenerators);
+            bool issuesValid() const;
 
             bool issueHidden(IssueType type) const;
             void setIssueHidden(IssueType type, bool hidden);
@@ -471,6 +478,13 @@ namespace TrenchBroom {
             virtual void doDescendantWillBeRemoved(Node* node, size_t depth);
             virtual void doDescendantWasRemoved(Node* oldParent, Node* node, size_t depth);
 
+            /**
+             * Called before and after a batch of nodes is added to this node or one of its descendants. The calls
+             * pair up and may nest. Every node of the batch is still passed to doDescendantWasAdded as usual.
+             */
+            virtual void doDescendantsWillBeAdded();
+            virtual void doDescendantsWereAdded();
+
             virtual void doParentWillChange();
             virtual void doParentDidChange();
             virtual void doAncestorWillChange();
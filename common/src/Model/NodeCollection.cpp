@@ -31,6 +31,7 @@
 #include <kdl/overload.h>
 
 #include <algorithm>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom {
@@ -206,46 +207,24 @@ namespace TrenchBroom {
         }
 
         static const auto doRemoveNodes = [](auto& nodes, auto& layers, auto& groups, auto& entities, auto& brushes, auto& patches, auto cur, auto end) {
-            auto nodeEnd = std::end(nodes);
-            auto layerEnd = std::end(layers);
-            auto groupEnd = std::end(groups);
-            auto entityEnd = std::end(entities);
-            auto brushEnd = std::end(brushes);
-            auto patchEnd = std::end(patches);
-
-            while (cur != end) {
-                (*cur)->accept(kdl::overload(
-                    [] (WorldNode*)         {},
-                    [&](LayerNode* layer)   { 
-                        nodeEnd = std::remove(std::begin(nodes), nodeEnd, layer);
-                        layerEnd = std::remove(std::begin(layers), layerEnd, layer);
-                    },
-                    [&](GroupNode* group)   {
-                        nodeEnd = std::remove(std::begin(nodes), nodeEnd, group);
-                        groupEnd = std::remove(std::begin(groups), groupEnd, group);
-                    },
-                    [&](EntityNode* entity) {
-                        nodeEnd = std::remove(std::begin(nodes), nodeEnd, entity);
-                        entityEnd = std::remove(std::begin(entities), entityEnd, entity);
-                    },
-                    [&](BrushNode* brush)   {
-                        nodeEnd = std::remove(std::begin(nodes), nodeEnd, brush);
-                        brushEnd = std::remove(std::begin(brushes), brushEnd, brush);
-                    },
-                    [&](PatchNode* patch)   {
-                        nodeEnd = std::remove(std::begin(nodes), nodeEnd, patch);
-                        patchEnd = std::remove(std::begin(patches), patchEnd, patch);
-                    }
-                ));
-                ++cur;
+            if (cur == end) {
+                return;
             }
 
-            nodes.erase(nodeEnd, std::end(nodes));
-            layers.erase(layerEnd, std::end(layers));
-            groups.erase(groupEnd, std::end(groups));
-            entities.erase(entityEnd, std::end(entities));
-            brushes.erase(brushEnd, std::end(brushes));
-            patches.erase(patchEnd, std::end(patches));
+            // removing each node with std::remove would be quadratic, which is prohibitive when deselecting large
+            // parts of a map, so we remove all nodes in one pass over every vector
+            const auto nodesToRemove = std::unordered_set<const Node*>(cur, end);
+            const auto shouldRemove = [&](const Node* node) { return nodesToRemove.count(node) > 0u; };
+            const auto removeFrom = [&](auto& vec) {
+                vec.erase(std::remove_if(std::begin(vec), std::end(vec), shouldRemove), std::end(vec));
+            };
+
+            removeFrom(nodes);
+            removeFrom(layers);
+            removeFrom(groups);
+            removeFrom(entities);
+            removeFrom(brushes);
+            removeFrom(patches);
         };
 
         void NodeCollection::removeNodes(const std::vector<Node*>& nodes) {
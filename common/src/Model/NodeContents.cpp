@@ -20,6 +20,7 @@
 #include "NodeContents.h"
 
 #include "Model/BrushFace.h"
+#include "Model/EntityProperties.h"
 
 #include <kdl/overload.h>
 
@@ -50,5 +51,26 @@ namespace TrenchBroom {
         std::variant<Layer, Group, Entity, Brush, BezierPatch>& NodeContents::get() {
             return m_contents;
         }
+
+        size_t NodeContents::memoryUsage() const {
+            return sizeof(NodeContents) + std::visit(kdl::overload(
+                [](const Layer&) -> size_t { return 0u; },
+                [](const Group&) -> size_t { return 0u; },
+                [](const Entity& entity) -> size_t {
+                    auto result = size_t(0);
+                    for (const auto& property : entity.properties()) {
+                        // keys are interned and shared by all properties
+                        result += sizeof(EntityProperty) + property.value().capacity();
+                    }
+                    return result;
+                },
+                [](const Brush& brush) -> size_t {
+                    return brush.memoryUsage() - sizeof(Brush);
+                },
+                [](const BezierPatch& patch) -> size_t {
+                    return patch.controlPoints().size() * sizeof(BezierPatch::Point);
+                }
+            ), m_contents);
+        }
     }
 }
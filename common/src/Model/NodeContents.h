@@ -25,6 +25,7 @@
 #include "Model/Group.h"
 #include "Model/Layer.h"
 
+#include <cstddef>
 #include <variant>
 
 namespace TrenchBroom {
@@ -41,6 +42,11 @@ namespace TrenchBroom {
 
             const std::variant<Layer, Group, Entity, Brush, BezierPatch>& get() const;
             std::variant<Layer, Group, Entity, Brush, BezierPatch>& get();
+
+            /**
+             * Returns an estimate of the number of bytes used by the contents.
+             */
+            size_t memoryUsage() const;
         };
     }
 }
@@ -19,9 +19,8 @@
 
 #include "NonIntegerVerticesIssueGenerator.h"
 
-#include "Polyhedron.h"
+#include "Model/Brush.h"
 #include "Model/BrushNode.h"
-#include "Model/BrushGeometry.h"
 #include "Model/Issue.h"
 #include "Model/IssueQuickFix.h"
 #include "Model/MapFacade.h"
@@ -67,11 +66,8 @@ namespace TrenchBroom {
 
         void NonIntegerVerticesIssueGenerator::doGenerate(BrushNode* brushNode, IssueList& issues) const {
             const Brush& brush = brushNode->brush();
-            for (const BrushVertex* vertex : brush.vertices()) {
-                if (!vm::is_integral(vertex->position())) {
-                    issues.push_back(new NonIntegerVerticesIssue(brushNode));
-                    return;
-                }
+            if (!brush.hasSnappedVertices(1.0)) {
+                issues.push_back(new NonIntegerVerticesIssue(brushNode));
             }
         }
     }
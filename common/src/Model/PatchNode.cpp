@@ -34,7 +34,9 @@
 #include <kdl/overload.h>
 #include <kdl/zip_iterator.h>
 
+#include <vecmath/bbox.h>
 #include <vecmath/intersection.h>
+#include <vecmath/scalar.h>
 #include <vecmath/vec_io.h>
 
 #include <cassert>
@@ -282,17 +284,62 @@ namespace TrenchBroom {
 
             auto previousPatch = std::exchange(m_patch, std::move(patch));
             m_grid = makePatchGrid(m_patch, DefaultSubdivisionsPerSurface);
+            m_pickTree.clear();
             return previousPatch;
         }
 
-        void PatchNode::setTexture(Assets::Texture* texture) {
-            m_patch.setTexture(texture);
+        bool PatchNode::setTexture(Assets::Texture* texture) {
+            return m_patch.setTexture(texture);
         }
 
         const PatchGrid& PatchNode::grid() const {
             return m_grid;
         }
 
+        const std::vector<PatchNode::PickTreeNode>& PatchNode::pickTree() const {
+            if (m_pickTree.empty() && m_grid.quadRowCount() > 0u && m_grid.quadColumnCount() > 0u) {
+                m_pickTree.reserve(2u * m_grid.quadRowCount() * m_grid.quadColumnCount());
+                buildPickTree(0u, m_grid.quadRowCount(), 0u, m_grid.quadColumnCount());
+            }
+            return m_pickTree;
+        }
+
+        size_t PatchNode::buildPickTree(const size_t firstRow, const size_t rowCount, const size_t firstColumn, const size_t columnCount) const {
+            static constexpr auto MaxQuadsPerLeaf = size_t(4);
+
+            const auto index = m_pickTree.size();
+            m_pickTree.push_back(PickTreeNode{vm::bbox3{}, firstRow, rowCount, firstColumn, columnCount, 0u});
+
+            if (rowCount * columnCount <= MaxQuadsPerLeaf) {
+                auto builder = vm::bbox3::builder{};
+                for (size_t row = firstRow; row <= firstRow + rowCount; ++row) {
+                    for (size_t col = firstColumn; col <= firstColumn + columnCount; ++col) {
+                        builder.add(m_grid.point(row, col).position);
+                    }
+                }
+                // flat patches would otherwise yield degenerate boxes, which rays can slip through
+                m_pickTree[index].bounds = builder.bounds().expand(vm::constants<FloatType>::almost_zero());
+                return index;
+            }
+
+            // split the longer side in half
+            auto rightChild = size_t(0);
+            if (rowCount >= columnCount) {
+                const auto half = rowCount / 2u;
+                buildPickTree(firstRow, half, firstColumn, columnCount);
+                rightChild = buildPickTree(firstRow + half, rowCount - half, firstColumn, columnCount);
+            } else {
+                const auto half = columnCount / 2u;
+                buildPickTree(firstRow, rowCount, firstColumn, half);
+                rightChild = buildPickTree(firstRow, rowCount, firstColumn + half, columnCount - half);
+            }
+
+            auto& node = m_pickTree[index];
+            node.rightChild = rightChild;
+            node.bounds = vm::merge(m_pickTree[index + 1u].bounds, m_pickTree[rightChild].bounds);
+            return index;
+        }
+
         const std::string& PatchNode::doGetName() const {
             static const auto name = std::string{"patch"};
             return name;
@@ -349,27 +396,55 @@ namespace TrenchBroom {
             if (!editorContext.visible(this)) {
                 return;
             }
+            const auto& tree = pickTree();
+            if (tree.empty()) {
+                return;
+            }
+
+            auto closestDistance = vm::nan<FloatType>();
             const auto pickTriangle = [&](const auto& p0, const auto& p1, const auto& p2) {
-                if (const auto distance = vm::intersect_ray_triangle(pickRay, p0, p1, p2); !vm::is_nan(distance)) {
-                    const auto hitPoint = vm::point_at_distance(pickRay, distance);
-                    pickResult.addHit(Hit(PatchHitType, distance, hitPoint, this));
-                    return true;
+                const auto distance = vm::intersect_ray_triangle(pickRay, p0, p1, p2);
+                if (!vm::is_nan(distance) && (vm::is_nan(closestDistance) || distance < closestDistance)) {
+                    closestDistance = distance;
                 }
-                return false;
             };
 
-            for (size_t row = 0u; row < m_grid.pointRowCount - 1u; ++row) {
-                for (size_t col = 0u; col < m_grid.pointColumnCount - 1u; ++col) {
-                    const auto v0 = m_grid.point(row, col).position;
-                    const auto v1 = m_grid.point(row, col + 1u).position;
-                    const auto v2 = m_grid.point(row + 1u, col + 1u).position;
-                    const auto v3 = m_grid.point(row + 1u, col).position;
+            // visit the nodes whose bounds are hit by the ray, skipping those that are farther away than the
+            // closest triangle found so far
+            auto nodesToVisit = std::vector<size_t>{0u};
+            while (!nodesToVisit.empty()) {
+                const auto nodeIndex = nodesToVisit.back();
+                const auto& node = tree[nodeIndex];
+                nodesToVisit.pop_back();
+
+                const auto boundsDistance = node.bounds.contains(pickRay.origin) ? FloatType(0) : vm::intersect_ray_bbox(pickRay, node.bounds);
+                if (vm::is_nan(boundsDistance) || (!vm::is_nan(closestDistance) && boundsDistance > closestDistance)) {
+                    continue;
+                }
 
-                    if (pickTriangle(v0, v1, v2) || pickTriangle(v2, v3, v0)) {
-                        return;
+                if (node.rightChild != 0u) {
+                    nodesToVisit.push_back(node.rightChild);
+                    nodesToVisit.push_back(nodeIndex + 1u);
+                    continue;
+                }
+
+                for (size_t row = node.firstRow; row < node.firstRow + node.rowCount; ++row) {
+                    for (size_t col = node.firstColumn; col < node.firstColumn + node.columnCount; ++col) {
+                        const auto v0 = m_grid.point(row, col).position;
+                        const auto v1 = m_grid.point(row, col + 1u).position;
+                        const auto v2 = m_grid.point(row + 1u, col + 1u).position;
+                        const auto v3 = m_grid.point(row + 1u, col).position;
+
+                        pickTriangle(v0, v1, v2);
+                        pickTriangle(v2, v3, v0);
                     }
                 }
             }
+
+            if (!vm::is_nan(closestDistance)) {
+                const auto hitPoint = vm::point_at_distance(pickRay, closestDistance);
+                pickResult.addHit(Hit(PatchHitType, closestDistance, hitPoint, this));
+            }
         }
 
         void PatchNode::doFindNodesContaining(const vm::vec3&, std::vector<Node*>&) {}
@@ -26,6 +26,7 @@
 
 #include <iosfwd>
 #include <optional>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Assets {
@@ -69,6 +70,21 @@ namespace TrenchBroom {
         private:
             BezierPatch m_patch;
             PatchGrid m_grid;
+
+            /*
+             * A bounding volume hierarchy over the quads of the grid that lets picking skip most of them. The nodes
+             * are stored in depth first order, so the left child of a node is the next node. Leafs have no right
+             * child. The tree is built on demand and discarded whenever the grid changes.
+             */
+            struct PickTreeNode {
+                vm::bbox3 bounds;
+                size_t firstRow;
+                size_t rowCount;
+                size_t firstColumn;
+                size_t columnCount;
+                size_t rightChild;
+            };
+            mutable std::vector<PickTreeNode> m_pickTree;
         public:
             explicit PatchNode(BezierPatch patch);
 
@@ -78,9 +94,15 @@ namespace TrenchBroom {
             const BezierPatch& patch() const;
             BezierPatch setPatch(BezierPatch patch);
 
-            void setTexture(Assets::Texture* texture);
+            /**
+             * Sets the texture of the patch. Returns true if the texture has changed.
+             */
+            bool setTexture(Assets::Texture* texture);
 
             const PatchGrid& grid() const;
+        private:
+            const std::vector<PickTreeNode>& pickTree() const;
+            size_t buildPickTree(size_t firstRow, size_t rowCount, size_t firstColumn, size_t columnCount) const;
         private: // implement Node interface
             const std::string& doGetName() const override;
             const vm::bbox3& doGetLogicalBounds() const override;
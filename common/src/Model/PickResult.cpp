@@ -30,6 +30,7 @@
 #include <kdl/vector_utils.h>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 
 namespace TrenchBroom {
@@ -46,18 +47,32 @@ namespace TrenchBroom {
         m_compare(std::move(compare)) {}
 
         PickResult::PickResult() :
-        m_compare(std::make_shared<CompareHitsByDistance>()) {}
+        m_compare(compareByDistance()) {}
 
         PickResult::~PickResult() = default;
 
+        // The comparators are stateless, so they are shared by all pick results instead of being allocated for every
+        // pick.
+
+        std::shared_ptr<CompareHits> PickResult::compareByDistance() {
+            static const auto compare = std::make_shared<CompareHitsByDistance>();
+            return compare;
+        }
+
         PickResult PickResult::byDistance() {
-            return PickResult(std::make_shared<CombineCompareHits>(
+            static const auto compare = std::make_shared<CombineCompareHits>(
                 std::make_unique<CompareHitsByDistance>(),
-                std::make_unique<CompareHitsByType>()));
+                std::make_unique<CompareHitsByType>());
+            return PickResult(compare);
         }
 
         PickResult PickResult::bySize(const vm::axis::type axis) {
-            return PickResult(std::make_shared<CompareHitsBySize>(axis));
+            static const auto compare = std::array<std::shared_ptr<CompareHits>, 3>{
+                std::make_shared<CompareHitsBySize>(vm::axis::x),
+                std::make_shared<CompareHitsBySize>(vm::axis::y),
+                std::make_shared<CompareHitsBySize>(vm::axis::z)
+            };
+            return PickResult(compare[axis]);
         }
 
         bool PickResult::empty() const {
@@ -59,6 +59,8 @@ namespace TrenchBroom {
             std::vector<Hit> all(const HitFilter& filter) const;
 
             void clear();
+        private:
+            static std::shared_ptr<CompareHits> compareByDistance();
         };
     }
 }
@@ -29,6 +29,7 @@
 #include <vecmath/util.h>
 #include <vecmath/vec.h>
 
+#include <cstddef>
 #include <initializer_list>
 #include <limits>
 #include <optional>
@@ -101,6 +102,12 @@ namespace TrenchBroom {
              */
             explicit Polyhedron_Vertex(const vm::vec<T,3>& position);
         public:
+            /**
+             * Allocates vertices from a kdl::object_pool. Polyhedra are rebuilt whenever a brush changes, so this
+             * avoids a trip to the general purpose allocator for every element.
+             */
+            static void* operator new(std::size_t size);
+            static void operator delete(void* ptr) noexcept;
             /**
              * Returns the position of this vertex.
              */
@@ -235,6 +242,11 @@ namespace TrenchBroom {
              */
             Polyhedron_Edge(HalfEdge* first, HalfEdge* second = nullptr);
         public:
+            /**
+             * Allocates edges from a kdl::object_pool.
+             */
+            static void* operator new(std::size_t size);
+            static void operator delete(void* ptr) noexcept;
             /**
              * Returns the origin of the first half edge.
              */
@@ -513,6 +525,11 @@ namespace TrenchBroom {
              */
             Polyhedron_HalfEdge(Vertex* origin);
         public:
+            /**
+             * Allocates half edges from a kdl::object_pool.
+             */
+            static void* operator new(std::size_t size);
+            static void operator delete(void* ptr) noexcept;
             /**
              * Returns the origin vertex of this half edge.
              */
@@ -718,6 +735,11 @@ namespace TrenchBroom {
              */
             explicit Polyhedron_Face(HalfEdgeList&& boundary, const vm::plane<T,3>& plane);
         public:
+            /**
+             * Allocates faces from a kdl::object_pool.
+             */
+            static void* operator new(std::size_t size);
+            static void operator delete(void* ptr) noexcept;
             /**
              * Returns the circular list of half edges that make up the boundary of this face.
              */
@@ -1397,7 +1419,7 @@ namespace TrenchBroom {
              * @param maxDistance the maximum distance at which a face is considered
              * @return a face or null if no face satisfies the criteria listed above
              */
-            Face* findClosestFace(const std::vector<vm::vec<T,3>>& positions, T maxDistance = std::numeric_limits<T>::max());
+            const Face* findClosestFace(const std::vector<vm::vec<T,3>>& positions, T maxDistance = std::numeric_limits<T>::max()) const;
         private:
             /**
              * Updates the bounds to the smallest bounding box that contains the positions of all vertices of this
@@ -31,6 +31,7 @@
 #include <vecmath/segment.h>
 #include <vecmath/util.h>
 
+#include <array>
 #include <list>
 #include <unordered_set>
 #include <vector>
@@ -48,12 +49,76 @@ namespace TrenchBroom {
             return std::max(computedEpsilon, defaultEpsilon);
         }
 
+        /**
+         * If more points than this are added at once, the points which cannot be vertices of the convex hull are
+         * discarded up front, see findExtremePoints.
+         */
+        static const size_t InteriorPointFilterThreshold = 64u;
+
+        /**
+         * Returns the points that are extreme along the coordinate axes and the diagonals of the unit cube. Their
+         * convex hull is contained in the convex hull of all points, so any point that lies strictly inside it cannot
+         * be a vertex of the convex hull of all points.
+         */
+        template <typename T>
+        static std::vector<vm::vec<T,3>> findExtremePoints(const std::vector<vm::vec<T,3>>& points) {
+            static const auto Directions = std::array<vm::vec<T,3>, 13>{
+                vm::vec<T,3>( 1,  0,  0), vm::vec<T,3>( 0,  1,  0), vm::vec<T,3>( 0,  0,  1),
+                vm::vec<T,3>( 1,  1,  0), vm::vec<T,3>( 1, -1,  0), vm::vec<T,3>( 1,  0,  1),
+                vm::vec<T,3>( 1,  0, -1), vm::vec<T,3>( 0,  1,  1), vm::vec<T,3>( 0,  1, -1),
+                vm::vec<T,3>( 1,  1,  1), vm::vec<T,3>( 1,  1, -1), vm::vec<T,3>( 1, -1,  1),
+                vm::vec<T,3>(-1,  1,  1),
+            };
+
+            auto minIndices = std::array<size_t, 13>{};
+            auto maxIndices = std::array<size_t, 13>{};
+            auto minDots = std::array<T, 13>{};
+            auto maxDots = std::array<T, 13>{};
+            for (size_t j = 0u; j < Directions.size(); ++j) {
+                minDots[j] = maxDots[j] = vm::dot(points.front(), Directions[j]);
+            }
+
+            for (size_t i = 1u; i < points.size(); ++i) {
+                for (size_t j = 0u; j < Directions.size(); ++j) {
+                    const auto d = vm::dot(points[i], Directions[j]);
+                    if (d < minDots[j]) {
+                        minDots[j] = d;
+                        minIndices[j] = i;
+                    } else if (d > maxDots[j]) {
+                        maxDots[j] = d;
+                        maxIndices[j] = i;
+                    }
+                }
+            }
+
+            auto indices = kdl::vec_concat(std::vector<size_t>(std::begin(minIndices), std::end(minIndices)), std::vector<size_t>(std::begin(maxIndices), std::end(maxIndices)));
+            indices = kdl::vec_sort_and_remove_duplicates(std::move(indices));
+            return kdl::vec_transform(indices, [&](const size_t i) { return points[i]; });
+        }
+
         template <typename T, typename FP, typename VP>
         void Polyhedron<T,FP,VP>::addPoints(std::vector<vm::vec<T,3>> points) {
             if (!points.empty()) {
                 points = kdl::vec_sort_and_remove_duplicates(std::move(points));
                 
                 const auto planeEpsilon = computePlaneEpsilon(points);
+
+                if (points.size() > InteriorPointFilterThreshold) {
+                    // Building the hull of the extreme points is cheap because there are so few of them, and it
+                    // usually allows discarding most of the points, e.g. when merging many adjacent brushes.
+                    const auto extremeHull = Polyhedron(findExtremePoints(points));
+                    if (extremeHull.polyhedron()) {
+                        points = kdl::vec_erase_if(std::move(points), [&](const vm::vec<T,3>& point) {
+                            for (const Face* face : extremeHull.faces()) {
+                                if (face->plane().point_status(point, planeEpsilon) != vm::plane_status::below) {
+                                    return false;
+                                }
+                            }
+                            return true;
+                        });
+                    }
+                }
+
                 for (const auto& point : points) {
                     addPoint(point, planeEpsilon);
                 }
@@ -22,6 +22,8 @@
 #include "Polyhedron.h"
 #include "Macros.h"
 
+#include <kdl/object_pool.h>
+
 #include <vecmath/vec.h>
 #include <vecmath/plane.h>
 #include <vecmath/segment.h>
@@ -40,6 +42,16 @@ namespace TrenchBroom {
             return edge->m_link;
         }
 
+        template <typename T, typename FP, typename VP>
+        void* Polyhedron_Edge<T,FP,VP>::operator new(const std::size_t size) {
+            return kdl::object_pool<Polyhedron_Edge<T,FP,VP>>::allocate(size);
+        }
+
+        template <typename T, typename FP, typename VP>
+        void Polyhedron_Edge<T,FP,VP>::operator delete(void* ptr) noexcept {
+            kdl::object_pool<Polyhedron_Edge<T,FP,VP>>::deallocate(ptr);
+        }
+
         template <typename T, typename FP, typename VP>
         Polyhedron_Edge<T,FP,VP>::Polyhedron_Edge(HalfEdge* first, HalfEdge* second) :
             m_first(first),
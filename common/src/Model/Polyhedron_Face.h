@@ -23,6 +23,8 @@
 
 #include "Polyhedron.h"
 
+#include <kdl/object_pool.h>
+
 #include <vecmath/vec.h>
 #include <vecmath/ray.h>
 #include <vecmath/plane.h>
@@ -45,6 +47,16 @@ namespace TrenchBroom {
             return face->m_link;
         }
 
+        template <typename T, typename FP, typename VP>
+        void* Polyhedron_Face<T,FP,VP>::operator new(const std::size_t size) {
+            return kdl::object_pool<Polyhedron_Face<T,FP,VP>>::allocate(size);
+        }
+
+        template <typename T, typename FP, typename VP>
+        void Polyhedron_Face<T,FP,VP>::operator delete(void* ptr) noexcept {
+            kdl::object_pool<Polyhedron_Face<T,FP,VP>>::deallocate(ptr);
+        }
+
         template <typename T, typename FP, typename VP>
         Polyhedron_Face<T,FP,VP>::Polyhedron_Face(HalfEdgeList&& boundary, const vm::plane<T,3>& plane) :
             m_boundary(std::move(boundary)),
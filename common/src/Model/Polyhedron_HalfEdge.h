@@ -21,6 +21,8 @@
 
 #include "Polyhedron.h"
 
+#include <kdl/object_pool.h>
+
 namespace TrenchBroom {
     namespace Model {
         template <typename T, typename FP, typename VP>
@@ -33,6 +35,16 @@ namespace TrenchBroom {
             return halfEdge->m_link;
         }
 
+        template <typename T, typename FP, typename VP>
+        void* Polyhedron_HalfEdge<T,FP,VP>::operator new(const std::size_t size) {
+            return kdl::object_pool<Polyhedron_HalfEdge<T,FP,VP>>::allocate(size);
+        }
+
+        template <typename T, typename FP, typename VP>
+        void Polyhedron_HalfEdge<T,FP,VP>::operator delete(void* ptr) noexcept {
+            kdl::object_pool<Polyhedron_HalfEdge<T,FP,VP>>::deallocate(ptr);
+        }
+
         template <typename T, typename FP, typename VP>
         Polyhedron_HalfEdge<T,FP,VP>::Polyhedron_HalfEdge(Vertex* origin) :
             m_origin(origin),
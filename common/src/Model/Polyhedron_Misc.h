@@ -644,12 +644,12 @@ namespace TrenchBroom {
         }
 
         template <typename T, typename FP, typename VP>
-        typename Polyhedron<T,FP,VP>::Face* Polyhedron<T,FP,VP>::findClosestFace(const std::vector<vm::vec<T,3>>& positions, const T maxDistance) {
+        const typename Polyhedron<T,FP,VP>::Face* Polyhedron<T,FP,VP>::findClosestFace(const std::vector<vm::vec<T,3>>& positions, const T maxDistance) const {
             auto closestDistance = maxDistance;
-            Face* closestFace = nullptr;
+            const Face* closestFace = nullptr;
 
-            Face* firstFace = m_faces.front();
-            Face* currentFace = firstFace;
+            const Face* firstFace = m_faces.front();
+            const Face* currentFace = firstFace;
             do {
                 const auto currentDistance = currentFace->distanceTo(positions);
                 if (currentDistance < closestDistance) {
@@ -22,6 +22,7 @@
 #include "Polyhedron.h"
 
 #include <kdl/intrusive_circular_list.h>
+#include <kdl/object_pool.h>
 
 namespace TrenchBroom {
     namespace Model {
@@ -35,6 +36,16 @@ namespace TrenchBroom {
             return vertex->m_link;
         }
 
+        template <typename T, typename FP, typename VP>
+        void* Polyhedron_Vertex<T,FP,VP>::operator new(const std::size_t size) {
+            return kdl::object_pool<Polyhedron_Vertex<T,FP,VP>>::allocate(size);
+        }
+
+        template <typename T, typename FP, typename VP>
+        void Polyhedron_Vertex<T,FP,VP>::operator delete(void* ptr) noexcept {
+            kdl::object_pool<Polyhedron_Vertex<T,FP,VP>>::deallocate(ptr);
+        }
+
         template <typename T, typename FP, typename VP>
         Polyhedron_Vertex<T,FP,VP>::Polyhedron_Vertex(const vm::vec<T,3>& position) :
             m_position(position),
@@ -20,18 +20,22 @@
 #include "PortalFile.h"
 
 #include "Exceptions.h"
+#include "IO/File.h"
 #include "IO/IOUtils.h"
 #include "IO/Path.h"
 
 #include <kdl/string_format.h>
-#include <kdl/string_utils.h>
 
 #include <vecmath/forward.h>
 #include <vecmath/polygon.h>
 #include <vecmath/vec.h>
 
+#include <algorithm>
+#include <cstdlib>
 #include <fstream>
+#include <optional>
 #include <string>
+#include <string_view>
 
 namespace TrenchBroom {
     namespace Model {
@@ -51,66 +55,145 @@ namespace TrenchBroom {
             return m_portals;
         }
 
-        void PortalFile::load(const IO::Path& path) {
-            std::ifstream stream = openPathAsInputStream(path);
-            if (!stream.good()) {
-                throw FileFormatException("Couldn't open file");
+        namespace {
+            /**
+             * Reads the lines of a portal file directly from the mapped file contents in order to avoid copying
+             * the (potentially very large) file into a stream and splitting each line into separate strings.
+             */
+            class PortalFileReader {
+            private:
+                const char* m_cur;
+                const char* m_end;
+            public:
+                PortalFileReader(const char* begin, const char* end) :
+                m_cur(begin),
+                m_end(end) {}
+
+                std::optional<std::string_view> readLine() {
+                    if (m_cur == m_end) {
+                        return std::nullopt;
+                    }
+
+                    const auto* lineEnd = std::find(m_cur, m_end, '\n');
+                    const auto line = std::string_view(m_cur, static_cast<size_t>(lineEnd - m_cur));
+                    m_cur = lineEnd == m_end ? m_end : lineEnd + 1;
+                    return line;
+                }
+
+                std::string_view readRequiredLine(const char* errorMessage) {
+                    if (const auto line = readLine()) {
+                        return *line;
+                    }
+                    throw FileFormatException(errorMessage);
+                }
+            };
+
+            bool isDelimiter(const char c) {
+                return c == '(' || c == ')' || c == ' ' || c == '\t' || c == '\r';
             }
 
-            std::string line;
+            /**
+             * Returns the next token of the given line, starting at the given position, and advances the position
+             * past the token. Parentheses are treated like whitespace. Returns an empty view if there is no token
+             * left.
+             */
+            std::string_view nextToken(const std::string_view line, size_t& pos) {
+                while (pos < line.size() && isDelimiter(line[pos])) {
+                    ++pos;
+                }
+                const auto start = pos;
+                while (pos < line.size() && !isDelimiter(line[pos])) {
+                    ++pos;
+                }
+                return line.substr(start, pos - start);
+            }
+
+            template <typename T, typename F>
+            T parseNumber(const std::string_view token, F&& convert) {
+                // copy the token because the mapped file contents are not null terminated
+                char buffer[64];
+                if (token.empty() || token.size() >= sizeof(buffer)) {
+                    throw FileFormatException("Error reading portal");
+                }
+                std::copy(std::begin(token), std::end(token), buffer);
+                buffer[token.size()] = '\0';
+
+                char* numberEnd = nullptr;
+                const auto result = convert(buffer, &numberEnd);
+                if (numberEnd != buffer + token.size()) {
+                    throw FileFormatException("Error reading portal");
+                }
+                return static_cast<T>(result);
+            }
+
+            int parseInt(const std::string_view token) {
+                return parseNumber<int>(token, [](const char* str, char** end) { return std::strtol(str, end, 10); });
+            }
+
+            float parseFloat(const std::string_view token) {
+                return parseNumber<float>(token, [](const char* str, char** end) { return std::strtof(str, end); });
+            }
+
+            int parseCount(const std::string_view line) {
+                return std::stoi(std::string(line));
+            }
+        }
+
+        void PortalFile::load(const IO::Path& path) {
+            const auto file = IO::MappedFile(path);
+            auto reader = PortalFileReader(file.begin(), file.end());
+
             int numPortals;
 
             // read header
-            std::getline(stream, line);
-            const std::string formatCode = kdl::str_trim(line); // trim off any trailing \r
+            const std::string formatCode = kdl::str_trim(reader.readRequiredLine("Error reading header")); // trim off any trailing \r
 
             if (formatCode == "PRT1") {
-                std::getline(stream, line); // number of leafs (ignored)
-                std::getline(stream, line); // number of portals
-                numPortals = std::stoi(line);
+                reader.readRequiredLine("Error reading header"); // number of leafs (ignored)
+                numPortals = parseCount(reader.readRequiredLine("Error reading header")); // number of portals
             } else if (formatCode == "PRT2") {
-                std::getline(stream, line); // number of leafs (ignored)
-                std::getline(stream, line); // number of clusters (ignored)
-                std::getline(stream, line); // number of portals
-                numPortals = std::stoi(line);
+                reader.readRequiredLine("Error reading header"); // number of leafs (ignored)
+                reader.readRequiredLine("Error reading header"); // number of clusters (ignored)
+                numPortals = parseCount(reader.readRequiredLine("Error reading header")); // number of portals
             } else if (formatCode == "PRT1-AM") {
-                std::getline(stream, line); // number of clusters (ignored)
-                std::getline(stream, line); // number of portals
-                numPortals = std::stoi(line);
-                std::getline(stream, line); // number of leafs (ignored)
+                reader.readRequiredLine("Error reading header"); // number of clusters (ignored)
+                numPortals = parseCount(reader.readRequiredLine("Error reading header")); // number of portals
+                reader.readRequiredLine("Error reading header"); // number of leafs (ignored)
             } else {
                 throw FileFormatException("Unknown portal format: " + formatCode);
             }
 
-            if (!stream.good()) {
+            if (numPortals < 0) {
                 throw FileFormatException("Error reading header");
             }
 
+            // every portal takes at least one line, so a corrupt count cannot make us reserve too much memory
+            m_portals.reserve(std::min(static_cast<size_t>(numPortals), file.size()));
+
             // read portals
+            std::vector<vm::vec3f> verts;
             for (int i = 0; i < numPortals; ++i) {
-                std::getline(stream, line);
-                const auto components = kdl::str_split(line, "() \n\t\r");
+                const auto line = reader.readRequiredLine("Error reading portal");
+
+                size_t pos = 0u;
+                const int numPoints = parseInt(nextToken(line, pos));
+                parseInt(nextToken(line, pos)); // first leaf or cluster (ignored)
+                parseInt(nextToken(line, pos)); // second leaf or cluster (ignored)
 
-                if (!stream.good() || components.size() < 3) {
+                if (numPoints < 0) {
                     throw FileFormatException("Error reading portal");
                 }
 
-                std::vector<vm::vec3f> verts;
-                size_t ptr = 3;
-                const int numPoints = std::stoi(components.at(0));
+                verts.clear();
+                verts.reserve(static_cast<size_t>(numPoints));
                 for (int j = 0; j < numPoints; ++j) {
-                    if (ptr + 2 >= components.size()) {
-                        throw FileFormatException("Error reading portal");
-                    }
-
-                    const vm::vec3f vert(std::stof(components.at(ptr)),
-                                     std::stof(components.at(ptr+1)),
-                                     std::stof(components.at(ptr+2)));
-                    verts.push_back(vert);
-                    ptr += 3;
+                    const auto x = parseFloat(nextToken(line, pos));
+                    const auto y = parseFloat(nextToken(line, pos));
+                    const auto z = parseFloat(nextToken(line, pos));
+                    verts.emplace_back(x, y, z);
                 }
 
-                m_portals.push_back(vm::polygon3f(verts));
+                m_portals.emplace_back(verts);
             }
         }
     }
@@ -127,16 +127,18 @@ namespace TrenchBroom {
         }
 
         bool TextureNameTagMatcher::matchesTextureName(std::string_view textureName) const {
-            // If the match pattern doesn't contain a slash, match against
-            // only the last component of the texture name.
-            if (m_pattern.find('/') == std::string::npos) {
-                const auto pos = textureName.find_last_of('/');
-                if (pos != std::string::npos) {
-                    textureName = textureName.substr(pos + 1);
+            return m_cache.matches(textureName, [&](std::string_view name) {
+                // If the match pattern doesn't contain a slash, match against
+                // only the last component of the texture name.
+                if (m_pattern.find('/') == std::string::npos) {
+                    const auto pos = name.find_last_of('/');
+                    if (pos != std::string::npos) {
+                        name = name.substr(pos + 1);
+                    }
                 }
-            }
 
-            return kdl::ci::str_matches_glob(textureName, m_pattern);
+                return kdl::ci::str_matches_glob(name, m_pattern);
+            });
         }
 
         SurfaceParmTagMatcher::SurfaceParmTagMatcher(const std::string& parameter) :
@@ -369,7 +371,9 @@ namespace TrenchBroom {
         }
 
         bool EntityClassNameTagMatcher::matchesClassname(const std::string& classname) const {
-            return kdl::ci::str_matches_glob(classname, m_pattern);
+            return m_cache.matches(classname, [&](const std::string_view name) {
+                return kdl::ci::str_matches_glob(name, m_pattern);
+            });
         }
     }
 }
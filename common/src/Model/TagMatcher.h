@@ -27,8 +27,10 @@
 
 #include <functional>
 #include <memory>
+#include <shared_mutex>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
@@ -70,6 +72,35 @@ namespace TrenchBroom {
             void visit(const BrushNode& brush) override;
         };
 
+        /**
+         * Remembers whether strings such as texture names or classnames match a pattern, so that the pattern is
+         * matched only once per distinct string. Tags are updated for every face of a map, but maps only use a small
+         * number of distinct textures and classnames. May be used from multiple threads at once.
+         */
+        class PatternMatchCache {
+        private:
+            mutable std::shared_mutex m_mutex;
+            mutable std::unordered_map<std::string, bool> m_results;
+        public:
+            template <typename Match>
+            bool matches(const std::string_view str, Match&& match) const {
+                const auto key = std::string(str);
+                {
+                    std::shared_lock<std::shared_mutex> lock(m_mutex);
+                    const auto it = m_results.find(key);
+                    if (it != std::end(m_results)) {
+                        return it->second;
+                    }
+                }
+
+                const auto result = match(str);
+
+                std::unique_lock<std::shared_mutex> lock(m_mutex);
+                m_results.emplace(key, result);
+                return result;
+            }
+        };
+
         class TextureTagMatcher : public TagMatcher {
         public:
             void enable(TagMatcherCallback& callback, MapFacade& facade) const override;
@@ -81,6 +112,7 @@ namespace TrenchBroom {
         class TextureNameTagMatcher : public TextureTagMatcher {
         private:
             std::string m_pattern;
+            PatternMatchCache m_cache;
         public:
             explicit TextureNameTagMatcher(const std::string& pattern);
             std::unique_ptr<TagMatcher> clone() const override;
@@ -142,6 +174,7 @@ namespace TrenchBroom {
              * The texture to set when this tag is enabled.
              */
             std::string m_texture;
+            PatternMatchCache m_cache;
         public:
             EntityClassNameTagMatcher(const std::string& pattern, const std::string& texture);
             std::unique_ptr<TagMatcher> clone() const override;
@@ -86,11 +86,30 @@ namespace TrenchBroom {
             return doGetTexCoords(point, attribs, textureSize);
         }
 
+        TexCoordProjection TexCoordSystem::texCoordProjection(const BrushFaceAttributes& attribs, const vm::vec2f& textureSize) const {
+            return TexCoordProjection{
+                safeScaleAxis(getXAxis(), attribs.scale().x()),
+                safeScaleAxis(getYAxis(), attribs.scale().y()),
+                attribs.offset(),
+                textureSize
+            };
+        }
+
         void TexCoordSystem::setRotation(const vm::vec3& normal, const float oldAngle, const float newAngle) {
             doSetRotation(normal, oldAngle, newAngle);
         }
 
         void TexCoordSystem::transform(const vm::plane3& oldBoundary, const vm::plane3& newBoundary, const vm::mat4x4& transformation, BrushFaceAttributes& attribs, const vm::vec2f& textureSize, bool lockTexture, const vm::vec3& invariant) {
+            if (lockTexture && attribs.xScale() != 0.0f && attribs.yScale() != 0.0f && vm::strip_translation(transformation) == vm::mat4x4::identity()) {
+                // A translation leaves the texture axes, the scale and the rotation unchanged, so only the offset
+                // must be adjusted such that the texture coordinates of the invariant stay the same. This is much
+                // cheaper than the general case, and moving objects is by far the most common transformation.
+                const auto translation = transformation * vm::vec3::zero();
+                const auto oldInvariantTexCoords = computeTexCoords(invariant, attribs.scale()) + attribs.offset();
+                const auto newInvariantTexCoords = computeTexCoords(invariant + translation, attribs.scale());
+                attribs.setOffset(correct(attribs.modOffset(oldInvariantTexCoords - newInvariantTexCoords, textureSize), 4));
+                return;
+            }
             doTransform(oldBoundary, newBoundary, transformation, attribs, textureSize, lockTexture, invariant);
         }
 
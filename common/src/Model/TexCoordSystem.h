@@ -54,6 +54,35 @@ namespace TrenchBroom {
             Rotation
         };
 
+        /**
+         * The texture projection of a face, with the scale already applied to the texture axes. Computing texture
+         * coordinates using this is equivalent to TexCoordSystem::getTexCoords, but it avoids the virtual calls to
+         * obtain the axes for every point, which matters when the coordinates of many vertices are computed.
+         */
+        struct TexCoordProjection {
+            vm::vec3 scaledXAxis;
+            vm::vec3 scaledYAxis;
+            vm::vec2f offset;
+            vm::vec2f textureSize;
+
+            vm::vec2f texCoords(const vm::vec3& point) const {
+                return (vm::vec2f(dot(point, scaledXAxis), dot(point, scaledYAxis)) + offset) / textureSize;
+            }
+
+            /**
+             * Computes the texture coordinates of the given points and writes them to the given output iterator.
+             * The iterations are independent of each other, so if the points are stored contiguously, the compiler
+             * can vectorize this loop.
+             */
+            template <typename I, typename O>
+            O texCoords(I cur, const I end, O out) const {
+                for (; cur != end; ++cur, ++out) {
+                    *out = texCoords(*cur);
+                }
+                return out;
+            }
+        };
+
         class TexCoordSystem {
         public:
             TexCoordSystem();
@@ -74,6 +103,7 @@ namespace TrenchBroom {
             void resetTextureAxesToParallel(const vm::vec3& normal, float angle);
 
             vm::vec2f getTexCoords(const vm::vec3& point, const BrushFaceAttributes& attribs, const vm::vec2f& textureSize) const;
+            TexCoordProjection texCoordProjection(const BrushFaceAttributes& attribs, const vm::vec2f& textureSize) const;
 
             void setRotation(const vm::vec3& normal, float oldAngle, float newAngle);
             void transform(const vm::plane3& oldBoundary, const vm::plane3& newBoundary, const vm::mat4x4& transformation, BrushFaceAttributes& attribs, const vm::vec2f& textureSize, bool lockTexture, const vm::vec3& invariant);
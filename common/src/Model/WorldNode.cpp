@@ -21,6 +21,7 @@
 
 #include "AABBTree.h"
 #include "Ensure.h"
+#include "Profiler.h"
 #include "Model/BrushNode.h"
 #include "Model/BrushFace.h"
 #include "Model/EntityNode.h"
@@ -38,6 +39,7 @@
 
 #include <vecmath/bbox_io.h>
 
+#include <cassert>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -50,7 +52,8 @@ namespace TrenchBroom {
         m_entityNodeIndex(std::make_unique<EntityNodeIndex>()),
         m_issueGeneratorRegistry(std::make_unique<IssueGeneratorRegistry>()),
         m_nodeTree(std::make_unique<NodeTree>()),
-        m_updateNodeTree(true) {
+        m_updateNodeTree(true),
+        m_nodeTreeInsertionBatchDepth(0u) {
             entity.addOrUpdateProperty(PropertyKeys::Classname, PropertyValues::WorldspawnClassname);
             entity.setPointEntity(false);
             setEntity(std::move(entity));
@@ -64,6 +67,7 @@ namespace TrenchBroom {
         }
 
         const WorldNode::NodeTree& WorldNode::nodeTree() const {
+            validateNodeTree();
             return *m_nodeTree;
         }
 
@@ -146,6 +150,28 @@ namespace TrenchBroom {
             return *m_entityNodeIndex;
         }
 
+        std::vector<GroupNode*> WorldNode::findLinkedGroups(const std::string& linkedGroupId) const {
+            const auto it = m_linkedGroupIndex.find(linkedGroupId);
+            return it != std::end(m_linkedGroupIndex) ? it->second : std::vector<GroupNode*>{};
+        }
+
+        void WorldNode::addToLinkedGroupIndex(GroupNode* groupNode) {
+            if (const auto linkedGroupId = groupNode->group().linkedGroupId()) {
+                m_linkedGroupIndex[*linkedGroupId].push_back(groupNode);
+            }
+        }
+
+        void WorldNode::removeFromLinkedGroupIndex(GroupNode* groupNode) {
+            if (const auto linkedGroupId = groupNode->group().linkedGroupId()) {
+                if (const auto it = m_linkedGroupIndex.find(*linkedGroupId); it != std::end(m_linkedGroupIndex)) {
+                    it->second = kdl::vec_erase(std::move(it->second), groupNode);
+                    if (it->second.empty()) {
+                        m_linkedGroupIndex.erase(it);
+                    }
+                }
+            }
+        }
+
         const std::vector<IssueGenerator*>& WorldNode::registeredIssueGenerators() const {
             return m_issueGeneratorRegistry->registeredGenerators();
         }
@@ -165,6 +191,8 @@ namespace TrenchBroom {
         }
 
         void WorldNode::disableNodeTreeUpdates() {
+            // nodes may be removed while updates are disabled, so we must not keep any of them
+            validateNodeTree();
             m_updateNodeTree = false;
         }
 
@@ -190,6 +218,36 @@ namespace TrenchBroom {
             ));
 
             m_nodeTree->clearAndBuild(nodes, [](const auto* node){ return node->physicalBounds(); });
+            m_nodesWithInvalidTreeBounds.clear();
+        }
+
+        void WorldNode::validateNodeTree() const {
+            if (!m_nodesWithInvalidTreeBounds.empty()) {
+                m_nodeTree->update(m_nodesWithInvalidTreeBounds, [](const auto* node) { return node->physicalBounds(); });
+                m_nodesWithInvalidTreeBounds.clear();
+            }
+        }
+
+        void WorldNode::insertIntoNodeTree(Node* node) {
+            if (m_nodeTreeInsertionBatchDepth > 0u) {
+                m_nodesToInsertIntoTree.push_back(node);
+            } else {
+                m_nodeTree->insert(node->physicalBounds(), node);
+            }
+        }
+
+        void WorldNode::removeFromNodeTree(Node* node) {
+            m_nodesWithInvalidTreeBounds.erase(node);
+            if (m_nodeTreeInsertionBatchDepth > 0u && kdl::vec_contains(m_nodesToInsertIntoTree, node)) {
+                m_nodesToInsertIntoTree = kdl::vec_erase(std::move(m_nodesToInsertIntoTree), node);
+                return;
+            }
+
+            if (!m_nodeTree->remove(node)) {
+                auto str = std::stringstream();
+                str << "Node not found with bounds " << node->physicalBounds() << ": " << node;
+                throw NodeTreeException(str.str());
+            }
         }
 
         void WorldNode::invalidateAllIssues() {
@@ -275,9 +333,9 @@ namespace TrenchBroom {
                     [&](auto&& thisLambda, WorldNode* world)   { world->visitChildren(thisLambda); },
                     [&](auto&& thisLambda, LayerNode* layer)   { layer->visitChildren(thisLambda); },
                     [&](auto&& thisLambda, GroupNode* group)   { group->visitChildren(thisLambda); },
-                    [&](auto&& thisLambda, EntityNode* entity) { m_nodeTree->insert(entity->physicalBounds(), entity); entity->visitChildren(thisLambda); },
-                    [&](BrushNode* brush)                      { m_nodeTree->insert(brush->physicalBounds(), brush); },
-                    [&](PatchNode* patch)                      { m_nodeTree->insert(patch->physicalBounds(), patch); }
+                    [&](auto&& thisLambda, EntityNode* entity) { insertIntoNodeTree(entity); entity->visitChildren(thisLambda); },
+                    [&](BrushNode* brush)                      { insertIntoNodeTree(brush); },
+                    [&](PatchNode* patch)                      { insertIntoNodeTree(patch); }
                 ));
             }
 
@@ -293,7 +351,7 @@ namespace TrenchBroom {
             node->accept(kdl::overload(
                 [&](auto&& thisLambda, WorldNode* world) { world->visitChildren(thisLambda); },
                 [&](auto&& thisLambda, LayerNode* layer) { layer->visitChildren(thisLambda); if (layer != defaultLayer()) { updatePersistentId(layer); } },
-                [&](auto&& thisLambda, GroupNode* group) { group->visitChildren(thisLambda); updatePersistentId(group); },
+                [&](auto&& thisLambda, GroupNode* group) { group->visitChildren(thisLambda); updatePersistentId(group); addToLinkedGroupIndex(group); },
                 [&](EntityNode*)                         {},
                 [&](BrushNode*)                          {},
                 [&](PatchNode*)                          {}
@@ -302,23 +360,37 @@ namespace TrenchBroom {
 
         void WorldNode::doDescendantWillBeRemoved(Node* node, const size_t /* depth */) {
             if (m_updateNodeTree) {
-                const auto doRemove = [&](auto* nodeToRemove) {
-                if (!m_nodeTree->remove(nodeToRemove)) {
-                    auto str = std::stringstream();
-                    str << "Node not found with bounds " << nodeToRemove->physicalBounds() << ": " << nodeToRemove;
-                    throw NodeTreeException(str.str());
-                }
-                };
-
                 node->accept(kdl::overload(
                     [&](auto&& thisLambda, WorldNode* world)   { world->visitChildren(thisLambda); },
                     [&](auto&& thisLambda, LayerNode* layer)   { layer->visitChildren(thisLambda); },
                     [&](auto&& thisLambda, GroupNode* group)   { group->visitChildren(thisLambda); },
-                    [&](auto&& thisLambda, EntityNode* entity) { doRemove(entity); entity->visitChildren(thisLambda); },
-                    [&](BrushNode* brush)                      { doRemove(brush); },
-                    [&](PatchNode* patch)                      { doRemove(patch); }
+                    [&](auto&& thisLambda, EntityNode* entity) { removeFromNodeTree(entity); entity->visitChildren(thisLambda); },
+                    [&](BrushNode* brush)                      { removeFromNodeTree(brush); },
+                    [&](PatchNode* patch)                      { removeFromNodeTree(patch); }
                 ));
             }
+
+            node->accept(kdl::overload(
+                [] (auto&& thisLambda, WorldNode* world)  { world->visitChildren(thisLambda); },
+                [] (auto&& thisLambda, LayerNode* layer)  { layer->visitChildren(thisLambda); },
+                [&](auto&& thisLambda, GroupNode* group)  { removeFromLinkedGroupIndex(group); group->visitChildren(thisLambda); },
+                [] (EntityNode*)                          {},
+                [] (BrushNode*)                           {},
+                [] (PatchNode*)                           {}
+            ));
+        }
+
+        void WorldNode::doDescendantsWillBeAdded() {
+            ++m_nodeTreeInsertionBatchDepth;
+        }
+
+        void WorldNode::doDescendantsWereAdded() {
+            assert(m_nodeTreeInsertionBatchDepth > 0u);
+            if (--m_nodeTreeInsertionBatchDepth == 0u && !m_nodesToInsertIntoTree.empty()) {
+                auto nodesToInsert = std::move(m_nodesToInsertIntoTree);
+                m_nodesToInsertIntoTree.clear();
+                m_nodeTree->insert(nodesToInsert, [](const auto* node) { return node->physicalBounds(); });
+            }
         }
 
         void WorldNode::doDescendantPhysicalBoundsDidChange(Node* node) {
@@ -327,24 +399,49 @@ namespace TrenchBroom {
                     [] (WorldNode*) {},
                     [] (LayerNode*) {},
                     [] (GroupNode*) {},
-                    [&](EntityNode* entity) { m_nodeTree->update(entity->physicalBounds(), entity); },
-                    [&](BrushNode* brush)   { m_nodeTree->update(brush->physicalBounds(), brush); },
-                    [&](PatchNode* patch)   { m_nodeTree->update(patch->physicalBounds(), patch); }
+                    [&](EntityNode* entity) { m_nodesWithInvalidTreeBounds.insert(entity); },
+                    [&](BrushNode* brush)   { m_nodesWithInvalidTreeBounds.insert(brush); },
+                    [&](PatchNode* patch)   { m_nodesWithInvalidTreeBounds.insert(patch); }
                 ));
             }
         }
 
+        void WorldNode::doDescendantWillChange(Node* node) {
+            node->accept(kdl::overload(
+                [] (WorldNode*)         {},
+                [] (LayerNode*)         {},
+                [&](GroupNode* group)   { removeFromLinkedGroupIndex(group); },
+                [] (EntityNode*)        {},
+                [] (BrushNode*)         {},
+                [] (PatchNode*)         {}
+            ));
+        }
+
+        void WorldNode::doDescendantDidChange(Node* node) {
+            node->accept(kdl::overload(
+                [] (WorldNode*)         {},
+                [] (LayerNode*)         {},
+                [&](GroupNode* group)   { addToLinkedGroupIndex(group); },
+                [] (EntityNode*)        {},
+                [] (BrushNode*)         {},
+                [] (PatchNode*)         {}
+            ));
+        }
+
         bool WorldNode::doSelectable() const {
             return false;
         }
 
         void WorldNode::doPick(const EditorContext& editorContext, const vm::ray3& ray, PickResult& pickResult) {
+            TB_PROFILE_SCOPE("WorldNode::doPick");
+            validateNodeTree();
             for (auto* node : m_nodeTree->findIntersectors(ray)) {
                 node->pick(editorContext, ray, pickResult);
             }
         }
 
         void WorldNode::doFindNodesContaining(const vm::vec3& point, std::vector<Node*>& result) {
+            validateNodeTree();
             for (auto* node : m_nodeTree->findContainers(point)) {
                 node->findNodesContaining(point, result);
             }
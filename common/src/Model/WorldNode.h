@@ -30,6 +30,8 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom {
@@ -55,6 +57,25 @@ namespace TrenchBroom {
             std::unique_ptr<NodeTree> m_nodeTree;
             bool m_updateNodeTree;
 
+            /*
+             * Nodes whose bounds have changed since they were last updated in the node tree. Updating the node tree
+             * is deferred until it is queried, so that bulk changes don't force the bounds of parent entities to be
+             * recomputed whenever one of their children changes.
+             */
+            mutable std::unordered_set<Node*> m_nodesWithInvalidTreeBounds;
+
+            /*
+             * While nodes are added in a batch, they are collected here and inserted into the node tree at once when
+             * the outermost batch ends.
+             */
+            size_t m_nodeTreeInsertionBatchDepth;
+            std::vector<Node*> m_nodesToInsertIntoTree;
+
+            /*
+             * Maps each linked group ID to the groups in this world that have it.
+             */
+            std::unordered_map<std::string, std::vector<GroupNode*>> m_linkedGroupIndex;
+
             IdType m_nextPersistentId = 1;
         public:
             WorldNode(Entity entity, MapFormat mapFormat);
@@ -111,6 +132,14 @@ namespace TrenchBroom {
             void createDefaultLayer();
         public: // index
             const EntityNodeIndex& entityNodeIndex() const;
+
+            /**
+             * Returns the groups in this world with the given linked group ID.
+             */
+            std::vector<GroupNode*> findLinkedGroups(const std::string& linkedGroupId) const;
+        private:
+            void addToLinkedGroupIndex(GroupNode* groupNode);
+            void removeFromLinkedGroupIndex(GroupNode* groupNode);
         public: // selection
             // issue generator registration
             const std::vector<IssueGenerator*>& registeredIssueGenerators() const;
@@ -122,6 +151,9 @@ namespace TrenchBroom {
             void enableNodeTreeUpdates();
             void rebuildNodeTree();
         private:
+            void validateNodeTree() const;
+            void insertIntoNodeTree(Node* node);
+            void removeFromNodeTree(Node* node);
             void invalidateAllIssues();
         private: // implement Node interface
             const vm::bbox3& doGetLogicalBounds() const override;
@@ -136,7 +168,11 @@ namespace TrenchBroom {
 
             void doDescendantWasAdded(Node* node, size_t depth) override;
             void doDescendantWillBeRemoved(Node* node, size_t depth) override;
+            void doDescendantsWillBeAdded() override;
+            void doDescendantsWereAdded() override;
             void doDescendantPhysicalBoundsDidChange(Node* node) override;
+            void doDescendantWillChange(Node* node) override;
+            void doDescendantDidChange(Node* node) override;
 
             bool doSelectable() const override;
             void doPick(const EditorContext& editorContext, const vm::ray3& ray, PickResult& pickResult) override;
@@ -23,6 +23,7 @@
 
 #include <kdl/set_temp.h>
 #include <kdl/tuple_utils.h>
+#include <kdl/vector_utils.h>
 
 #include <cassert>
 #include <functional>
@@ -219,6 +220,78 @@ namespace TrenchBroom {
     };
 
 
+    /**
+     * A notifier whose observers receive a vector of values, and which can coalesce several notifications into one.
+     *
+     * Outside of a coalescing scope, every notification is dispatched immediately. Between calls to beginCoalescing()
+     * and endCoalescing(), the values of every notification are collected instead, and once the outermost scope ends, the
+     * observers are notified once with the collected values, sorted and with duplicates removed. Scopes can be nested.
+     *
+     * @tparam T the type of the vector elements passed to the observer callbacks
+     */
+    template <typename T>
+    class CoalescingNotifier {
+    private:
+        Notifier<const std::vector<T>&> m_notifier;
+        size_t m_coalescingDepth{0};
+        std::vector<T> m_pending;
+    public:
+        /**
+         * Adds the given observer callback to this notifier.
+         *
+         * @see Notifier::connect
+         */
+        template <typename... C>
+        [[nodiscard]] NotifierConnection connect(C&&... c) {
+            return m_notifier.connect(std::forward<C>(c)...);
+        }
+
+        /**
+         * Notifies all observers with the given values, or collects the values if this notifier is coalescing.
+         */
+        void notify(const std::vector<T>& values) {
+            if (m_coalescingDepth > 0u) {
+                m_pending.insert(std::end(m_pending), std::begin(values), std::end(values));
+            } else {
+                m_notifier.notify(values);
+            }
+        }
+
+        void operator()(const std::vector<T>& values) {
+            notify(values);
+        }
+
+        bool coalescing() const {
+            return m_coalescingDepth > 0u;
+        }
+
+        void beginCoalescing() {
+            ++m_coalescingDepth;
+        }
+
+        /**
+         * Ends the current coalescing scope. If it is the outermost scope, the collected values are dispatched.
+         */
+        void endCoalescing() {
+            assert(m_coalescingDepth > 0u);
+            if (--m_coalescingDepth == 0u) {
+                flush();
+            }
+        }
+
+        /**
+         * Dispatches the values collected so far without ending the current coalescing scope. Does nothing if no
+         * values were collected.
+         */
+        void flush() {
+            if (!m_pending.empty()) {
+                const auto values = kdl::vec_sort_and_remove_duplicates(std::move(m_pending));
+                m_pending.clear();
+                m_notifier.notify(values);
+            }
+        }
+    };
+
     /**
     * RAII style helper tht notifies the given notifier when it is destroyed, passing the given arguments.
     */
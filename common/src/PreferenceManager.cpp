@@ -38,6 +38,7 @@
 #include <QStandardPaths>
 #include <QStringBuilder>
 #include <QMessageBox>
+#include <QTimer>
 
 #include <string>
 #include <vector>
@@ -254,8 +255,11 @@ namespace TrenchBroom {
         return *m_instance;
     }
 
+    static const int WriteDelayMs = 500;
+
     AppPreferenceManager::AppPreferenceManager() :
     m_fileSystemWatcher(nullptr),
+    m_writeTimer(nullptr),
     m_fileReadWriteDisabled(false) {
 #if defined __APPLE__
         m_saveInstantly = true;
@@ -273,6 +277,12 @@ namespace TrenchBroom {
 
         this->loadCacheFromDisk();
 
+        m_writeTimer = new QTimer(this);
+        m_writeTimer->setSingleShot(true);
+        m_writeTimer->setInterval(WriteDelayMs);
+        connect(m_writeTimer, &QTimer::timeout, this, &AppPreferenceManager::writeCacheToDisk);
+        connect(qApp, &QCoreApplication::aboutToQuit, this, &AppPreferenceManager::flushCacheToDisk);
+
         m_fileSystemWatcher = new QFileSystemWatcher(this);
         if (m_fileSystemWatcher->addPath(m_preferencesFilePath)) {
             connect(m_fileSystemWatcher, &QFileSystemWatcher::QFileSystemWatcher::fileChanged, this, [this](){
@@ -296,6 +306,13 @@ namespace TrenchBroom {
         }
         m_unsavedPreferences.clear();
 
+        // the observers are notified right away, but the file is written once the changes have settled
+        if (!m_fileReadWriteDisabled) {
+            m_writeTimer->start();
+        }
+    }
+
+    void AppPreferenceManager::writeCacheToDisk() {
         if (m_fileReadWriteDisabled) {
             return;
         }
@@ -305,6 +322,13 @@ namespace TrenchBroom {
         }
     }
 
+    void AppPreferenceManager::flushCacheToDisk() {
+        if (m_writeTimer->isActive()) {
+            m_writeTimer->stop();
+            writeCacheToDisk();
+        }
+    }
+
     void AppPreferenceManager::discardChanges() {
         m_unsavedPreferences.clear();
         invalidatePreferences();
@@ -371,6 +395,11 @@ namespace TrenchBroom {
             return;
         }
 
+        // m_cache has changes that are about to be written, and which would be lost by reloading it
+        if (m_writeTimer != nullptr && m_writeTimer->isActive()) {
+            return;
+        }
+
         const std::map<IO::Path, QJsonValue> oldPrefs = m_cache;
 
         // Reload m_cache
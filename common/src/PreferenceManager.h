@@ -39,6 +39,7 @@
 
 class QTextStream;
 class QFileSystemWatcher;
+class QTimer;
 
 namespace TrenchBroom {
     class Color;
@@ -143,11 +144,8 @@ namespace TrenchBroom {
             preference.setValue(value);
             preference.setValid(true);
 
+            // if changes are saved instantly, saving the preference also notifies the observers
             savePreference(preference);
-            if (saveInstantly()) {
-                preferenceDidChangeNotifier(preference.path());
-            }
-
             return true;
         }
 
@@ -176,12 +174,17 @@ namespace TrenchBroom {
         bool m_saveInstantly;
         UnsavedPreferences m_unsavedPreferences;
         /**
-         * This should always be in sync with what is on disk.
+         * This should always be in sync with what is on disk, except while a write is pending (see m_writeTimer).
          * Preference objects may have different values if there are unsaved changes.
          * There may also be values in here we don't know how to deserialize; we write them back to disk.
          */
         std::map<IO::Path, QJsonValue> m_cache;
         QFileSystemWatcher* m_fileSystemWatcher;
+        /**
+         * Delays writing m_cache to disk so that a burst of changes, e.g. while dragging a slider, results in only
+         * one write.
+         */
+        QTimer* m_writeTimer;
         /**
          * If true, don't try to read/write preferences anymore.
          * This gets set to true if there is a JSON parse error, so
@@ -200,6 +203,8 @@ namespace TrenchBroom {
         void markAsUnsaved(PreferenceBase& preference);
         void showErrorAndDisableFileReadWrite(const QString& reason, const QString& suggestion);
         void loadCacheFromDisk();
+        void writeCacheToDisk();
+        void flushCacheToDisk();
         void invalidatePreferences();
         void loadPreferenceFromCache(PreferenceBase& pref);
         void savePreferenceToCache(PreferenceBase& pref);
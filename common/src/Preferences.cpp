@@ -47,7 +47,9 @@ namespace TrenchBroom {
         Preference<Color> PointFileColor(IO::Path("Renderer/Colors/Point file"), Color(0.0f, 1.0f, 0.0f, 1.0f));
         Preference<Color> PortalFileBorderColor(IO::Path("Renderer/Colors/Portal file border"), Color(1.0f, 1.0f, 1.0f, 0.5f));
         Preference<Color> PortalFileFillColor(IO::Path("Renderer/Colors/Portal file fill"), Color(1.0f, 0.4f, 0.4f, 0.2f));
+        Preference<float> PortalFileViewDistance(IO::Path("Renderer/Portal file view distance"), 0.0f);
         Preference<bool>  ShowFPS(IO::Path("Renderer/Show FPS"), false);
+        Preference<bool>  PersistentlyMappedBuffers(IO::Path("Renderer/Persistently mapped buffers"), false);
 
         Preference<Color>& axisColor(vm::axis::type axis) {
             switch (axis) {
@@ -132,9 +134,15 @@ namespace TrenchBroom {
         Preference<int> TextureMinFilter(IO::Path("Renderer/Texture mode min filter"), 0x2700);
         Preference<int> TextureMagFilter(IO::Path("Renderer/Texture mode mag filter"), 0x2600);
         Preference<bool> EnableMSAA(IO::Path("Renderer/Enable multisampling"), true);
+        Preference<bool> LoadTexturesInBackground(IO::Path("Renderer/Load textures in background"), false);
+        Preference<bool> CacheDecodedTextures(IO::Path("Renderer/Cache decoded textures"), true);
+        Preference<bool> OcclusionCulling(IO::Path("Renderer/Occlusion culling"), false);
 
         Preference<bool> TextureLock(IO::Path("Editor/Texture lock"), true);
         Preference<bool> UVLock(IO::Path("Editor/UV lock"), false);
+        Preference<int> UndoMemoryBudget(IO::Path("Editor/Undo memory budget"), 1024); // in MiB, 0 means unlimited
+        Preference<bool> CacheParsedMaps(IO::Path("Editor/Cache parsed maps"), false);
+        Preference<bool> CacheParsedEntityDefinitions(IO::Path("Editor/Cache parsed entity definitions"), false);
 
         Preference<IO::Path>& RendererFontPath() {
             static Preference<IO::Path> fontPath(IO::Path("Renderer/Font name"), IO::Path("fonts/SourceSansPro-Regular.otf"));
@@ -242,7 +250,9 @@ namespace TrenchBroom {
                 &PointFileColor,
                 &PortalFileBorderColor,
                 &PortalFileFillColor,
+                &PortalFileViewDistance,
                 &ShowFPS,
+                &PersistentlyMappedBuffers,
                 &CompassBackgroundColor,
                 &CompassBackgroundOutlineColor,
                 &CompassAxisOutlineColor,
@@ -296,8 +306,14 @@ namespace TrenchBroom {
                 &GridColor2D,
                 &TextureMinFilter,
                 &TextureMagFilter,
+                &LoadTexturesInBackground,
+                &CacheDecodedTextures,
+                &OcclusionCulling,
                 &TextureLock,
                 &UVLock,
+                &UndoMemoryBudget,
+                &CacheParsedMaps,
+                &CacheParsedEntityDefinitions,
                 &RendererFontPath(),
                 &RendererFontSize,
                 &BrowserFontSize,
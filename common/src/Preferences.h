@@ -50,7 +50,9 @@ namespace TrenchBroom {
         extern Preference<Color> PointFileColor;
         extern Preference<Color> PortalFileBorderColor;
         extern Preference<Color> PortalFileFillColor;
+        extern Preference<float> PortalFileViewDistance;
         extern Preference<bool>  ShowFPS;
+        extern Preference<bool>  PersistentlyMappedBuffers;
 
         Preference<Color>& axisColor(vm::axis::type axis);
 
@@ -125,9 +127,15 @@ namespace TrenchBroom {
         extern Preference<int> TextureMinFilter;
         extern Preference<int> TextureMagFilter;
         extern Preference<bool> EnableMSAA;
+        extern Preference<bool> LoadTexturesInBackground;
+        extern Preference<bool> CacheDecodedTextures;
+        extern Preference<bool> OcclusionCulling;
 
         extern Preference<bool> TextureLock;
         extern Preference<bool> UVLock;
+        extern Preference<int> UndoMemoryBudget;
+        extern Preference<bool> CacheParsedMaps;
+        extern Preference<bool> CacheParsedEntityDefinitions;
 
         Preference<IO::Path>& RendererFontPath();
         extern Preference<int> RendererFontSize;
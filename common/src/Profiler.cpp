@@ -0,0 +1,126 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Profiler.h"
+
+#include <atomic>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+
+namespace TrenchBroom {
+    namespace {
+        struct ProfileEventBuffer {
+            std::mutex mutex;
+            std::vector<ProfileEvent> events;
+            size_t next = 0u;
+        };
+
+        ProfileEventBuffer& profileEventBuffer() {
+            static auto buffer = ProfileEventBuffer{};
+            return buffer;
+        }
+
+        std::chrono::steady_clock::time_point profileEpoch() {
+            static const auto epoch = std::chrono::steady_clock::now();
+            return epoch;
+        }
+
+        uint32_t currentThreadId() {
+            static auto nextThreadId = std::atomic<uint32_t>{0u};
+            thread_local const auto threadId = nextThreadId.fetch_add(1u);
+            return threadId;
+        }
+
+        uint64_t nsecsSinceEpoch(const std::chrono::steady_clock::time_point time) {
+            const auto epoch = profileEpoch();
+            return time > epoch ? static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time - epoch).count()) : 0u;
+        }
+
+        // initialize the epoch during static initialization so that it precedes any recorded event
+        const auto s_initialEpoch = profileEpoch();
+    }
+
+    void recordProfileEvent(const char* name, const std::chrono::steady_clock::time_point start, const std::chrono::steady_clock::time_point end) {
+        const auto event = ProfileEvent{
+            name,
+            nsecsSinceEpoch(start),
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()),
+            currentThreadId()
+        };
+
+        auto& buffer = profileEventBuffer();
+        const auto lock = std::lock_guard<std::mutex>{buffer.mutex};
+        if (buffer.events.size() < ProfileEventCapacity) {
+            buffer.events.push_back(event);
+        } else {
+            buffer.events[buffer.next] = event;
+        }
+        buffer.next = (buffer.next + 1u) % ProfileEventCapacity;
+    }
+
+    std::vector<ProfileEvent> profileEvents() {
+        auto& buffer = profileEventBuffer();
+        const auto lock = std::lock_guard<std::mutex>{buffer.mutex};
+
+        auto result = std::vector<ProfileEvent>{};
+        result.reserve(buffer.events.size());
+        if (buffer.events.size() < ProfileEventCapacity) {
+            result = buffer.events;
+        } else {
+            result.insert(std::end(result), std::next(std::begin(buffer.events), static_cast<std::ptrdiff_t>(buffer.next)), std::end(buffer.events));
+            result.insert(std::end(result), std::begin(buffer.events), std::next(std::begin(buffer.events), static_cast<std::ptrdiff_t>(buffer.next)));
+        }
+        return result;
+    }
+
+    void clearProfileEvents() {
+        auto& buffer = profileEventBuffer();
+        const auto lock = std::lock_guard<std::mutex>{buffer.mutex};
+        buffer.events.clear();
+        buffer.next = 0u;
+    }
+
+    void writeChromeTrace(std::ostream& str) {
+        const auto events = profileEvents();
+
+        str << std::fixed << std::setprecision(3);
+        str << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        for (size_t i = 0u; i < events.size(); ++i) {
+            const auto& event = events[i];
+            // the names are string literals without any characters that need escaping
+            str << (i == 0u ? "\n" : ",\n")
+                << "{\"name\":\"" << event.name << "\""
+                << ",\"cat\":\"TrenchBroom\",\"ph\":\"X\""
+                << ",\"ts\":" << static_cast<double>(event.startNsecs) / 1000.0
+                << ",\"dur\":" << static_cast<double>(event.durationNsecs) / 1000.0
+                << ",\"pid\":1,\"tid\":" << event.threadId << "}";
+        }
+        str << "\n]}\n";
+    }
+
+    ProfileScope::ProfileScope(const char* name) :
+    m_name{name},
+    m_start{std::chrono::steady_clock::now()} {}
+
+    ProfileScope::~ProfileScope() {
+        recordProfileEvent(m_name, m_start, std::chrono::steady_clock::now());
+    }
+}
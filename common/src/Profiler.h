@@ -0,0 +1,80 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Macros.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace TrenchBroom {
+    /**
+     * A timed probe recorded by a ProfileScope. The times are measured in nanoseconds since the program started.
+     */
+    struct ProfileEvent {
+        const char* name;
+        uint64_t startNsecs;
+        uint64_t durationNsecs;
+        uint32_t threadId;
+    };
+
+    /**
+     * The number of events the profiler keeps. Once the ring buffer is full, the oldest events are overwritten.
+     */
+    constexpr size_t ProfileEventCapacity = size_t(1) << 16;
+
+    void recordProfileEvent(const char* name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+    /**
+     * Returns the recorded events, oldest first.
+     */
+    std::vector<ProfileEvent> profileEvents();
+    void clearProfileEvents();
+
+    /**
+     * Writes the recorded events in the Chrome trace event format, which can be loaded into chrome://tracing
+     * or Perfetto. Nested scopes show up as a hierarchy because their durations are nested on the same thread.
+     */
+    void writeChromeTrace(std::ostream& str);
+
+    /**
+     * Records the time between its construction and destruction as a profile event. The name is not copied and
+     * must therefore be a string literal.
+     *
+     * Use the TB_PROFILE_SCOPE macro to place a probe.
+     */
+    class ProfileScope {
+    private:
+        const char* m_name;
+        std::chrono::steady_clock::time_point m_start;
+    public:
+        explicit ProfileScope(const char* name);
+        ~ProfileScope();
+
+        deleteCopyAndMove(ProfileScope)
+    };
+}
+
+#define TB_PROFILE_CONCAT_IMPL(a, b) a##b
+#define TB_PROFILE_CONCAT(a, b) TB_PROFILE_CONCAT_IMPL(a, b)
+#define TB_PROFILE_SCOPE(name) const auto TB_PROFILE_CONCAT(profileScope, __LINE__) = TrenchBroom::ProfileScope{name}
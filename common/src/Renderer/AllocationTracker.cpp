@@ -44,6 +44,19 @@ namespace TrenchBroom {
             return size < other.size;
         }
 
+        bool AllocationTracker::Relocation::operator==(const Relocation& other) const {
+            return oldPos == other.oldPos
+                   && newPos == other.newPos
+                   && size == other.size;
+        }
+
+        double AllocationTracker::Statistics::fragmentation() const {
+            if (freeSize == 0) {
+                return 0.0;
+            }
+            return 1.0 - static_cast<double>(largestFreeBlock) / static_cast<double>(freeSize);
+        }
+
         static std::vector<AllocationTracker::Block*>::iterator findFirstLargerOrEqualBin(std::vector<AllocationTracker::Block*>& bins, const size_t desiredSize) {
             return std::lower_bound(bins.begin(),
                                     bins.end(),
@@ -169,6 +182,8 @@ namespace TrenchBroom {
             block->nextOfSameSize = nullptr;
             block->prevOfSameSize = nullptr;
 
+            m_usedSize += needed;
+
             if (block->size == needed) {
                 // lucky case: exact size. we're done
                 block->free = false;
@@ -217,6 +232,8 @@ namespace TrenchBroom {
             assert(block->prevOfSameSize == nullptr);
             assert(block->nextOfSameSize == nullptr);
 
+            m_usedSize -= block->size;
+
             Block* left = block->left;
             Block* right = block->right;
 
@@ -314,6 +331,7 @@ namespace TrenchBroom {
 
         AllocationTracker::AllocationTracker(const Index initial_capacity)
                 : m_capacity(0),
+                  m_usedSize(0),
                   m_leftmostBlock(nullptr),
                   m_rightmostBlock(nullptr),
                   m_recycledBlockList(nullptr) {
@@ -325,6 +343,7 @@ namespace TrenchBroom {
 
         AllocationTracker::AllocationTracker()
                 : m_capacity(0),
+                  m_usedSize(0),
                   m_leftmostBlock(nullptr),
                   m_rightmostBlock(nullptr),
                   m_recycledBlockList(nullptr) {}
@@ -421,6 +440,131 @@ namespace TrenchBroom {
             return false;
         }
 
+        AllocationTracker::Index AllocationTracker::usedSize() const {
+            return m_usedSize;
+        }
+
+        std::vector<AllocationTracker::Relocation> AllocationTracker::compact() {
+            checkInvariants();
+
+            std::vector<Relocation> result;
+            if (m_capacity == 0) {
+                return result;
+            }
+
+            // all free blocks are recycled and replaced by a single one at the end
+            m_freeBlockSizeBins.clear();
+
+            Block* block = m_leftmostBlock;
+            Block* lastUsedBlock = nullptr;
+            Index pos = 0;
+            m_leftmostBlock = nullptr;
+
+            while (block != nullptr) {
+                Block* next = block->right;
+                if (block->free) {
+                    block->prevOfSameSize = nullptr;
+                    block->nextOfSameSize = nullptr;
+                    recycle(block);
+                } else {
+                    if (block->pos != pos) {
+                        result.push_back(Relocation{block->pos, pos, block->size});
+                        block->pos = pos;
+                    }
+
+                    block->left = lastUsedBlock;
+                    if (lastUsedBlock == nullptr) {
+                        m_leftmostBlock = block;
+                    } else {
+                        lastUsedBlock->right = block;
+                    }
+                    lastUsedBlock = block;
+                    pos += block->size;
+                }
+                block = next;
+            }
+
+            m_rightmostBlock = lastUsedBlock;
+            if (lastUsedBlock != nullptr) {
+                lastUsedBlock->right = nullptr;
+            }
+
+            if (pos < m_capacity) {
+                Block* freeBlock = obtainBlock();
+                freeBlock->pos = pos;
+                freeBlock->size = m_capacity - pos;
+                freeBlock->prevOfSameSize = nullptr;
+                freeBlock->nextOfSameSize = nullptr;
+                freeBlock->left = lastUsedBlock;
+                freeBlock->right = nullptr;
+                freeBlock->free = true;
+
+                if (lastUsedBlock == nullptr) {
+                    m_leftmostBlock = freeBlock;
+                } else {
+                    lastUsedBlock->right = freeBlock;
+                }
+                m_rightmostBlock = freeBlock;
+
+                linkToBinList(freeBlock);
+            }
+
+            checkInvariants();
+            return result;
+        }
+
+        void AllocationTracker::truncate(const Index newCapacity) {
+            checkInvariants();
+
+            if (newCapacity > m_capacity) {
+                throw std::invalid_argument("truncate() requires a smaller capacity");
+            }
+            if (newCapacity == m_capacity) {
+                return;
+            }
+
+            const Index decrease = m_capacity - newCapacity;
+            Block* lastBlock = m_rightmostBlock;
+            if (!lastBlock->free || lastBlock->size < decrease) {
+                throw std::invalid_argument("truncate() requires free space at the end");
+            }
+
+            unlinkFromBinList(lastBlock);
+            lastBlock->size -= decrease;
+
+            if (lastBlock->size == 0) {
+                m_rightmostBlock = lastBlock->left;
+                if (m_rightmostBlock == nullptr) {
+                    m_leftmostBlock = nullptr;
+                } else {
+                    m_rightmostBlock->right = nullptr;
+                }
+                recycle(lastBlock);
+            } else {
+                linkToBinList(lastBlock);
+            }
+
+            m_capacity = newCapacity;
+
+            checkInvariants();
+        }
+
+        AllocationTracker::Statistics AllocationTracker::statistics() const {
+            Statistics result;
+            result.capacity = m_capacity;
+            for (Block* block = m_leftmostBlock; block != nullptr; block = block->right) {
+                if (block->free) {
+                    result.freeSize += block->size;
+                    ++result.freeBlockCount;
+                } else {
+                    result.usedSize += block->size;
+                    ++result.usedBlockCount;
+                }
+            }
+            result.largestFreeBlock = largestPossibleAllocation();
+            return result;
+        }
+
 // Testing / debugging
 
         std::vector<AllocationTracker::Range> AllocationTracker::freeBlocks() const {
@@ -489,6 +633,14 @@ namespace TrenchBroom {
             }
             assert(m_capacity == totalSize);
 
+            size_t usedSize = 0;
+            for (Block* block = m_leftmostBlock; block != nullptr; block = block->right) {
+                if (!block->free) {
+                    usedSize += block->size;
+                }
+            }
+            assert(m_usedSize == usedSize);
+
             // check the size map
             for (const auto& headBlock : m_freeBlockSizeBins) {
                 assert(headBlock != nullptr);
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <vector>
 
 namespace TrenchBroom {
@@ -62,6 +63,32 @@ namespace TrenchBroom {
                 Block* nextRecycledBlock;
             };
 
+            /**
+             * Describes how compact() moved a used block.
+             */
+            struct Relocation {
+                Index oldPos;
+                Index newPos;
+                Index size;
+
+                bool operator==(const Relocation& other) const;
+            };
+
+            struct Statistics {
+                Index capacity = 0;
+                Index usedSize = 0;
+                Index freeSize = 0;
+                size_t usedBlockCount = 0;
+                size_t freeBlockCount = 0;
+                Index largestFreeBlock = 0;
+
+                /**
+                 * Returns the share of free space that is not part of the largest free block, i.e. 0 if all free
+                 * space is contiguous and close to 1 if it is scattered across many small blocks.
+                 */
+                double fragmentation() const;
+            };
+
         private:
             /**
              * Size of memory managed by this AllocationTracker.
@@ -69,6 +96,11 @@ namespace TrenchBroom {
              */
             Index m_capacity;
 
+            /**
+             * Sum of `size` of all used Blocks.
+             */
+            Index m_usedSize;
+
             /**
              * Points to the Block with pos 0. Used to free all of the blocks in the destructor
              */
@@ -124,6 +156,31 @@ namespace TrenchBroom {
              * tracker is free. Returns false if `capacity() == 0`. Constant time.
              */
             bool hasAllocations() const;
+            /**
+             * @return the sum of the sizes of all allocations. Constant time.
+             */
+            Index usedSize() const;
+
+            /**
+             * Moves all used blocks to the start of the managed range without changing their order, so that the free
+             * space forms a single block at the end. The used Block objects remain valid, only their pos changes.
+             *
+             * @return the relocations ordered by position; since every block moves towards the start, the caller can
+             * move its data by applying them in order
+             */
+            std::vector<Relocation> compact();
+
+            /**
+             * Reduces the capacity by removing free space from the end.
+             *
+             * @throws std::invalid_argument if the range beyond the given capacity is not free
+             */
+            void truncate(Index newCapacity);
+
+            /**
+             * Computes statistics about the used and free blocks. Linear in the number of blocks.
+             */
+            Statistics statistics() const;
 
             // Testing / debugging
 
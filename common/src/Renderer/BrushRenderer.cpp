@@ -19,7 +19,9 @@
 
 #include "BrushRenderer.h"
 
+#include "AllocationCounting.h"
 #include "Preferences.h"
+#include "Profiler.h"
 #include "PreferenceManager.h"
 #include "Model/Brush.h"
 #include "Model/BrushNode.h"
@@ -27,12 +29,30 @@
 #include "Model/EditorContext.h"
 #include "Model/Polyhedron.h"
 #include "Model/TagAttribute.h"
+#include "Renderer/ActiveShader.h"
 #include "Renderer/BrushRendererArrays.h"
 #include "Renderer/BrushRendererBrushCache.h"
+#include "Renderer/Camera.h"
+#include "Renderer/GLVertexType.h"
+#include "Renderer/OcclusionQuery.h"
+#include "Renderer/PrimType.h"
+#include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
+#include "Renderer/Renderable.h"
+#include "Renderer/Shaders.h"
+#include "Renderer/VertexArray.h"
 
+#include <kdl/parallel.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/scalar.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstring>
+#include <optional>
 #include <vector>
 
 namespace TrenchBroom {
@@ -77,7 +97,11 @@ namespace TrenchBroom {
             const Model::BrushFace& firstFace = brush.face(*firstFaceIndex);
             const Model::BrushFace& secondFace = brush.face(*secondFaceIndex);
             
-            return m_context.visible(brushNode, firstFace) || m_context.visible(brushNode, secondFace);
+            return m_context.visible(brushNode) && (m_context.faceVisible(firstFace) || m_context.faceVisible(secondFace));
+        }
+
+        bool BrushRenderer::DefaultFilter::faceVisible(const Model::BrushFace& face) const {
+            return m_context.faceVisible(face);
         }
 
         bool BrushRenderer::DefaultFilter::editable(const Model::BrushNode* brush) const {
@@ -133,10 +157,17 @@ namespace TrenchBroom {
         m_showOccludedEdges(false),
         m_forceTransparent(false),
         m_transparencyAlpha(1.0f),
-        m_showHiddenBrushes(false) {
+        m_showHiddenBrushes(false),
+        m_occlusionCulling(false) {
             clear();
         }
 
+        BrushRenderer::~BrushRenderer() {
+            // like the chunks' buffers, the queries are freed assuming that the owner made its context current
+            clearChunks();
+            freeReleasedQueries();
+        }
+
         void BrushRenderer::addBrushes(const std::vector<Model::BrushNode*>& brushes) {
             for (auto* brush : brushes) {
                 addBrush(brush);
@@ -170,10 +201,11 @@ namespace TrenchBroom {
                 removeBrushFromVbo(brush);
             }
             m_invalidBrushes = m_allBrushes;
+            m_opaqueFaceRenderer = FaceRenderer();
+            m_transparentFaceRenderer = FaceRenderer();
 
             assert(m_brushInfo.empty());
-            assert(m_transparentFaces->empty());
-            assert(m_opaqueFaces->empty());
+            assert(m_chunks.empty());
         }
 
         void BrushRenderer::invalidateBrushes(const std::vector<Model::BrushNode*>& brushes) {
@@ -200,14 +232,10 @@ namespace TrenchBroom {
             m_allBrushes.clear();
             m_invalidBrushes.clear();
 
+            clearChunks();
+            m_opaqueFaceRenderer = FaceRenderer();
+            m_transparentFaceRenderer = FaceRenderer();
             m_vertexArray = std::make_shared<BrushVertexArray>();
-            m_edgeIndices = std::make_shared<BrushIndexArray>();
-            m_transparentFaces = std::make_shared<TextureToBrushIndicesMap>();
-            m_opaqueFaces = std::make_shared<TextureToBrushIndicesMap>();
-
-            m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
-            m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
-            m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, m_edgeIndices);
         }
 
         void BrushRenderer::setFaceColor(const Color& faceColor) {
@@ -263,21 +291,69 @@ namespace TrenchBroom {
             }
         }
 
+        void BrushRenderer::setOcclusionCulling(const bool occlusionCulling) {
+            m_occlusionCulling = occlusionCulling;
+        }
+
+        AllocationTracker::Statistics BrushRenderer::vertexStatistics() const {
+            return m_vertexArray->statistics();
+        }
+
+        AllocationTracker::Statistics BrushRenderer::indexStatistics() const {
+            auto result = AllocationTracker::Statistics{};
+            const auto add = [&](const BrushIndexArray& indexArray) {
+                const auto stats = indexArray.statistics();
+                result.capacity += stats.capacity;
+                result.usedSize += stats.usedSize;
+                result.freeSize += stats.freeSize;
+                result.usedBlockCount += stats.usedBlockCount;
+                result.freeBlockCount += stats.freeBlockCount;
+                result.largestFreeBlock = std::max(result.largestFreeBlock, stats.largestFreeBlock);
+            };
+
+            for (const auto& [key, chunk] : m_chunks) {
+                add(*chunk.edgeIndices);
+                for (const auto& projectedEdgeIndices : chunk.projectedEdgeIndices) {
+                    add(*projectedEdgeIndices);
+                }
+                for (const auto& [texture, indexArray] : *chunk.opaqueFaces) {
+                    add(*indexArray);
+                }
+                for (const auto& [texture, indexArray] : *chunk.transparentFaces) {
+                    add(*indexArray);
+                }
+            }
+            return result;
+        }
+
         void BrushRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch) {
             renderOpaque(renderContext, renderBatch);
             renderTransparent(renderContext, renderBatch);
         }
 
         void BrushRenderer::renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch) {
+            freeReleasedQueries();
             if (!m_allBrushes.empty()) {
+                const auto viewAxis = projectedEdgeAxis(renderContext);
                 if (!valid()) {
                     validate();
                 }
-                if (renderContext.showFaces()) {
-                    renderOpaqueFaces(renderBatch);
+                auto opaqueFaces = IndexArrayMapList{};
+                for (auto& [key, chunk] : m_chunks) {
+                    if (chunkVisible(renderContext, chunk)) {
+                        if (renderContext.showFaces() && !chunk.opaqueFaces->empty()) {
+                            opaqueFaces.push_back(chunk.opaqueFaces);
+                        }
+                        if (m_showEdges || (renderContext.showEdges() && chunkEdgesVisible(renderContext, chunk))) {
+                            renderEdges(chunk, renderBatch, viewAxis);
+                        }
+                    }
+                }
+                if (!opaqueFaces.empty()) {
+                    renderOpaqueFaces(std::move(opaqueFaces), renderBatch);
                 }
-                if (renderContext.showEdges() || m_showEdges) {
-                    renderEdges(renderBatch);
+                if (m_occlusionCulling && renderContext.render3D()) {
+                    renderOcclusionQueries(renderContext, renderBatch);
                 }
             }
         }
@@ -288,19 +364,142 @@ namespace TrenchBroom {
                     validate();
                 }
                 if (renderContext.showFaces()) {
-                    renderTransparentFaces(renderBatch);
+                    auto transparentFaces = IndexArrayMapList{};
+                    for (auto& [key, chunk] : m_chunks) {
+                        if (!chunk.transparentFaces->empty() && chunkVisible(renderContext, chunk)) {
+                            transparentFaces.push_back(chunk.transparentFaces);
+                        }
+                    }
+                    if (!transparentFaces.empty()) {
+                        renderTransparentFaces(std::move(transparentFaces), renderBatch);
+                    }
+                }
+            }
+        }
+
+        /**
+         * Renders the bounding boxes of the given chunks with color and depth writes disabled, wrapping each box in
+         * the occlusion query of its chunk. The results are read back in the next frame, so the boxes must be
+         * rendered after the opaque geometry to be tested against its depth values.
+         */
+        class BrushRenderer::OcclusionQueryRenderable : public DirectRenderable {
+        private:
+            using Vertex = GLVertexTypes::P3::Vertex;
+            static constexpr GLsizei VerticesPerBox = 24;
+
+            std::vector<OcclusionQuery*> m_queries;
+            VertexArray m_vertexArray;
+        public:
+            explicit OcclusionQueryRenderable(const std::vector<Chunk*>& chunks) {
+                std::vector<Vertex> vertices;
+                vertices.reserve(VerticesPerBox * chunks.size());
+                m_queries.reserve(chunks.size());
+
+                for (auto* chunk : chunks) {
+                    chunk->bounds.for_each_face([&](const auto& v1, const auto& v2, const auto& v3, const auto& v4, const auto& /* n */) {
+                        vertices.emplace_back(v1);
+                        vertices.emplace_back(v2);
+                        vertices.emplace_back(v3);
+                        vertices.emplace_back(v4);
+                    });
+                    m_queries.push_back(chunk->occlusionQuery.get());
+                }
+
+                m_vertexArray = VertexArray::move(std::move(vertices));
+            }
+        private:
+            void doPrepareVertices(VboManager& vboManager) override {
+                m_vertexArray.prepare(vboManager);
+            }
+
+            void doRender(RenderContext& renderContext) override {
+                ActiveShader shader(renderContext.shaderManager(), Shaders::VaryingPUniformCShader);
+                shader.set("Color", Color(1.0f, 1.0f, 1.0f, 1.0f));
+
+                glAssert(glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE))
+                glAssert(glDepthMask(GL_FALSE))
+                glAssert(glDisable(GL_CULL_FACE))
+
+                m_vertexArray.setup();
+                for (size_t i = 0; i < m_queries.size(); ++i) {
+                    auto* query = m_queries[i];
+                    if (!query->pending()) {
+                        query->begin();
+                        m_vertexArray.render(PrimType::Quads, static_cast<GLint>(i) * VerticesPerBox, VerticesPerBox);
+                        query->end();
+                    }
                 }
+                m_vertexArray.cleanup();
+
+                glAssert(glEnable(GL_CULL_FACE))
+                glAssert(glDepthMask(GL_TRUE))
+                glAssert(glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE))
+            }
+        };
+
+        bool BrushRenderer::chunkVisible(const RenderContext& renderContext, const Chunk& chunk) const {
+            const auto& camera = renderContext.camera();
+            if (!camera.intersectsFrustum(chunk.bounds)) {
+                return false;
+            }
+            if (!m_occlusionCulling || !renderContext.render3D() || !chunk.occlusionQuery) {
+                return true;
+            }
+
+            // the bounding box of a chunk that contains the camera may be clipped by the near plane, so the query
+            // cannot be trusted
+            const auto margin = vm::vec3f::fill(camera.nearPlane());
+            if (vm::bbox3f(chunk.bounds.min - margin, chunk.bounds.max + margin).contains(camera.position())) {
+                return true;
             }
+            return chunk.occlusionQuery->visible();
         }
 
-        void BrushRenderer::renderOpaqueFaces(RenderBatch& renderBatch) {
+        bool BrushRenderer::chunkEdgesVisible(const RenderContext& renderContext, const Chunk& chunk) const {
+            if (!renderContext.render3D() || chunk.brushCount == 0) {
+                return true;
+            }
+
+            // estimate the size of a brush by distributing the chunk's volume evenly among its brushes, and measure
+            // it at the point of the chunk that is closest to the camera
+            const auto& camera = renderContext.camera();
+            const auto size = chunk.bounds.size();
+            const auto brushSize = std::cbrt(size.x() * size.y() * size.z() / static_cast<float>(chunk.brushCount));
+            const auto closestPoint = vm::max(chunk.bounds.min, vm::min(chunk.bounds.max, camera.position()));
+            const auto unitsPerPixel = camera.perspectiveScalingFactor(closestPoint);
+
+            return unitsPerPixel <= 0.0f || brushSize / unitsPerPixel >= MinBrushSizeForEdges;
+        }
+
+        void BrushRenderer::renderOcclusionQueries(RenderContext& renderContext, RenderBatch& renderBatch) {
+            const auto& camera = renderContext.camera();
+
+            std::vector<Chunk*> chunks;
+            chunks.reserve(m_chunks.size());
+            for (auto& [key, chunk] : m_chunks) {
+                if (camera.intersectsFrustum(chunk.bounds)) {
+                    if (!chunk.occlusionQuery) {
+                        chunk.occlusionQuery = std::make_unique<OcclusionQuery>();
+                    }
+                    chunks.push_back(&chunk);
+                }
+            }
+
+            if (!chunks.empty()) {
+                renderBatch.addOneShot(new OcclusionQueryRenderable(chunks));
+            }
+        }
+
+        void BrushRenderer::renderOpaqueFaces(IndexArrayMapList opaqueFaces, RenderBatch& renderBatch) {
+            m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, std::move(opaqueFaces), m_faceColor);
             m_opaqueFaceRenderer.setGrayscale(m_grayscale);
             m_opaqueFaceRenderer.setTint(m_tint);
             m_opaqueFaceRenderer.setTintColor(m_tintColor);
             m_opaqueFaceRenderer.render(renderBatch);
         }
 
-        void BrushRenderer::renderTransparentFaces(RenderBatch& renderBatch) {
+        void BrushRenderer::renderTransparentFaces(IndexArrayMapList transparentFaces, RenderBatch& renderBatch) {
+            m_transparentFaceRenderer = FaceRenderer(m_vertexArray, std::move(transparentFaces), m_faceColor);
             m_transparentFaceRenderer.setGrayscale(m_grayscale);
             m_transparentFaceRenderer.setTint(m_tint);
             m_transparentFaceRenderer.setTintColor(m_tintColor);
@@ -308,11 +507,38 @@ namespace TrenchBroom {
             m_transparentFaceRenderer.render(renderBatch);
         }
 
-        void BrushRenderer::renderEdges(RenderBatch& renderBatch) {
-            if (m_showOccludedEdges) {
-                m_edgeRenderer.renderOnTop(renderBatch, m_occludedEdgeColor);
+        void BrushRenderer::renderEdges(Chunk& chunk, RenderBatch& renderBatch, const std::optional<size_t> viewAxis) {
+            const auto& edgeIndices = viewAxis ? chunk.projectedEdgeIndices[*viewAxis] : chunk.edgeIndices;
+            auto& edgeRenderer = viewAxis ? chunk.projectedEdgeRenderers[*viewAxis] : chunk.edgeRenderer;
+            if (edgeIndices->hasValidIndices()) {
+                if (m_showOccludedEdges) {
+                    edgeRenderer.renderOnTop(renderBatch, m_occludedEdgeColor);
+                }
+                edgeRenderer.render(renderBatch, m_edgeColor);
             }
-            m_edgeRenderer.render(renderBatch, m_edgeColor);
+        }
+
+        /**
+         * Returns the axis that the camera of the given 2D render context looks along, or nothing if the context is
+         * not 2D or the camera is not axis aligned. The first time a 2D view looks along an axis, the brushes are
+         * invalidated so that the edges that are not parallel to that axis are collected for every brush.
+         */
+        std::optional<size_t> BrushRenderer::projectedEdgeAxis(RenderContext& renderContext) {
+            if (!renderContext.render2D()) {
+                return std::nullopt;
+            }
+
+            const auto& direction = renderContext.camera().direction();
+            const auto axis = vm::find_abs_max_component(direction);
+            if (std::abs(direction[axis]) < 1.0f - vm::constants<float>::almost_zero()) {
+                return std::nullopt;
+            }
+
+            if (!m_projectedEdgeAxes[axis]) {
+                m_projectedEdgeAxes[axis] = true;
+                invalidate();
+            }
+            return axis;
         }
 
         class BrushRenderer::FilterWrapper : public BrushRenderer::Filter {
@@ -341,15 +567,128 @@ namespace TrenchBroom {
         void BrushRenderer::validate() {
             assert(!valid());
 
-            for (auto brush : m_invalidBrushes) {
-                validateBrush(brush);
+            TB_PROFILE_SCOPE("BrushRenderer::validate");
+            const auto allocationScope = AllocationScope{AllocationTag::Renderer};
+            const auto invalidBrushes = std::vector<const Model::BrushNode*>(std::begin(m_invalidBrushes), std::end(m_invalidBrushes));
+
+            // the vertex caches only touch the data of their own brush, so they can be filled in parallel
+            kdl::parallel_for(invalidBrushes.size(), [&](const size_t i) {
+                const auto workerAllocationScope = AllocationScope{AllocationTag::Renderer};
+                const auto* brush = invalidBrushes[i];
+                brush->brushRendererBrushCache().validateVertexCache(brush);
+            });
+
+            // evaluating the filter and allocating space in the arrays must happen serially, but once all
+            // allocations are made, the brushes write to disjoint ranges of the arrays
+            auto pendingBrushes = std::vector<PendingBrush>{};
+            pendingBrushes.reserve(invalidBrushes.size());
+            for (const auto* brush : invalidBrushes) {
+                auto pendingBrush = PendingBrush{};
+                if (allocateBrush(brush, pendingBrush)) {
+                    pendingBrushes.push_back(pendingBrush);
+                }
             }
+
+            kdl::parallel_for(pendingBrushes.size(), [&](const size_t i) {
+                writeBrush(pendingBrushes[i]);
+            });
             m_invalidBrushes.clear();
             assert(valid());
 
-            m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
-            m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
-            m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, m_edgeIndices);
+            compactArrays();
+
+            for (auto& [key, chunk] : m_chunks) {
+                resetChunkRenderers(chunk);
+            }
+        }
+
+        void BrushRenderer::compactArrays() {
+            // Remove the index arrays of textures that no face of a chunk uses anymore, e.g. after the textures of
+            // many faces were replaced. Otherwise, every frame would still issue a draw call for each of them.
+            const auto removeUnusedIndexArrays = [](TextureToBrushIndicesMap& indexArrays) {
+                for (auto it = std::begin(indexArrays); it != std::end(indexArrays);) {
+                    if (!it->second->hasValidIndices()) {
+                        it = indexArrays.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            };
+
+            for (auto& [key, chunk] : m_chunks) {
+                removeUnusedIndexArrays(*chunk.opaqueFaces);
+                removeUnusedIndexArrays(*chunk.transparentFaces);
+            }
+
+            const auto forEachIndexArray = [&](const auto& f) {
+                for (auto& [key, chunk] : m_chunks) {
+                    f(*chunk.edgeIndices);
+                    for (auto& projectedEdgeIndices : chunk.projectedEdgeIndices) {
+                        f(*projectedEdgeIndices);
+                    }
+                    for (auto& [texture, indexArray] : *chunk.opaqueFaces) {
+                        f(*indexArray);
+                    }
+                    for (auto& [texture, indexArray] : *chunk.transparentFaces) {
+                        f(*indexArray);
+                    }
+                }
+            };
+
+            forEachIndexArray([](BrushIndexArray& indexArray) { indexArray.compact(); });
+
+            const auto relocations = m_vertexArray->compact();
+            if (!relocations.empty()) {
+                forEachIndexArray([&](BrushIndexArray& indexArray) { indexArray.relocateVertices(relocations); });
+            }
+        }
+
+        BrushRenderer::Chunk& BrushRenderer::chunkForBrush(const Model::BrushNode* brush) {
+            const auto bounds = vm::bbox3f(brush->logicalBounds());
+            const auto center = bounds.center();
+            const auto cell = [&](const size_t i) { return static_cast<int>(std::floor(center[i] / ChunkSize)); };
+            const auto key = ChunkKey{cell(0), cell(1), cell(2)};
+
+            auto [it, inserted] = m_chunks.try_emplace(key);
+            auto& chunk = it->second;
+            if (inserted) {
+                chunk.key = key;
+                chunk.bounds = bounds;
+                chunk.edgeIndices = std::make_shared<BrushIndexArray>();
+                for (auto& projectedEdgeIndices : chunk.projectedEdgeIndices) {
+                    projectedEdgeIndices = std::make_shared<BrushIndexArray>();
+                }
+                chunk.transparentFaces = std::make_shared<TextureToBrushIndicesMap>();
+                chunk.opaqueFaces = std::make_shared<TextureToBrushIndicesMap>();
+                resetChunkRenderers(chunk);
+            } else {
+                // the bounds only grow until the chunk becomes empty, which is fine for culling
+                chunk.bounds = vm::merge(chunk.bounds, bounds);
+            }
+            return chunk;
+        }
+
+        void BrushRenderer::clearChunks() {
+            for (auto& [key, chunk] : m_chunks) {
+                if (chunk.occlusionQuery) {
+                    m_releasedQueries.push_back(std::move(chunk.occlusionQuery));
+                }
+            }
+            m_chunks.clear();
+        }
+
+        void BrushRenderer::freeReleasedQueries() {
+            for (auto& query : m_releasedQueries) {
+                query->free();
+            }
+            m_releasedQueries.clear();
+        }
+
+        void BrushRenderer::resetChunkRenderers(Chunk& chunk) {
+            chunk.edgeRenderer = IndexedEdgeRenderer(m_vertexArray, chunk.edgeIndices);
+            for (size_t i = 0; i < 3; ++i) {
+                chunk.projectedEdgeRenderers[i] = IndexedEdgeRenderer(m_vertexArray, chunk.projectedEdgeIndices[i]);
+            }
         }
 
         static size_t triIndicesCountForPolygon(const size_t vertexCount) {
@@ -358,6 +697,16 @@ namespace TrenchBroom {
             return indexCount;
         }
 
+        struct CompareCachedFaceByTexture {
+            bool operator()(const BrushRendererBrushCache::CachedFace& face, const Assets::Texture* texture) const {
+                return face.texture < texture;
+            }
+
+            bool operator()(const Assets::Texture* texture, const BrushRendererBrushCache::CachedFace& face) const {
+                return texture < face.texture;
+            }
+        };
+
         static void addTriIndicesForPolygon(GLuint* dest, const GLuint baseIndex, const size_t vertexCount) {
             assert(vertexCount >= 3);
             for (size_t i = 0; i < vertexCount - 2; ++i) {
@@ -384,16 +733,49 @@ namespace TrenchBroom {
             }
         }
 
-        static size_t countMarkedEdgeIndices(const Model::BrushNode* brush, const BrushRenderer::Filter::EdgeRenderPolicy policy) {
+        /**
+         * Indicates whether the given edge is parallel to the given axis, i.e., whether it collapses to a single point
+         * in a 2D view that looks along that axis.
+         */
+        static bool isEdgeParallelToAxis(const BrushRendererBrushCache& brushCache, const BrushRendererBrushCache::CachedEdge& edge, const size_t axis) {
+            const auto& vertices = brushCache.cachedVertices();
+            const auto& p1 = getVertexComponent<0>(vertices[edge.vertexIndex1RelativeToBrush]);
+            const auto& p2 = getVertexComponent<0>(vertices[edge.vertexIndex2RelativeToBrush]);
+            for (size_t i = 0; i < 3; ++i) {
+                if (i != axis && std::abs(p1[i] - p2[i]) > vm::constants<float>::almost_zero()) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * Returns whether the given edge should be rendered according to the given policy. If an axis is given, edges
+         * that are parallel to it are not rendered.
+         */
+        static bool shouldRenderEdge(const BrushRendererBrushCache& brushCache,
+                                     const BrushRendererBrushCache::CachedEdge& edge,
+                                     const BrushRenderer::Filter::EdgeRenderPolicy policy,
+                                     const std::optional<size_t> excludedAxis) {
+            return shouldRenderEdge(edge, policy) && !(excludedAxis && isEdgeParallelToAxis(brushCache, edge, *excludedAxis));
+        }
+
+        static size_t countMarkedEdgeIndices(const Model::BrushNode* brush, const BrushRenderer::Filter::EdgeRenderPolicy policy, const std::optional<size_t> excludedAxis = std::nullopt) {
             using EdgeRenderPolicy = BrushRenderer::Filter::EdgeRenderPolicy;
 
             if (policy == EdgeRenderPolicy::RenderNone) {
                 return 0;
             }
 
+            const auto& brushCache = brush->brushRendererBrushCache();
+            const auto& edges = brushCache.cachedEdges();
+            if (policy == EdgeRenderPolicy::RenderAll && !excludedAxis) {
+                return 2u * edges.size();
+            }
+
             size_t indexCount = 0;
-            for (const auto& edge : brush->brushRendererBrushCache().cachedEdges()) {
-                if (shouldRenderEdge(edge, policy)) {
+            for (const auto& edge : edges) {
+                if (shouldRenderEdge(brushCache, edge, policy, excludedAxis)) {
                     indexCount += 2;
                 }
             }
@@ -403,16 +785,18 @@ namespace TrenchBroom {
         static void getMarkedEdgeIndices(const Model::BrushNode* brush,
                                          const BrushRenderer::Filter::EdgeRenderPolicy policy,
                                          const GLuint brushVerticesStartIndex,
-                                         GLuint* dest) {
+                                         GLuint* dest,
+                                         const std::optional<size_t> excludedAxis = std::nullopt) {
             using EdgeRenderPolicy = BrushRenderer::Filter::EdgeRenderPolicy;
 
             if (policy == EdgeRenderPolicy::RenderNone) {
                 return;
             }
 
+            const auto& brushCache = brush->brushRendererBrushCache();
             size_t i = 0;
-            for (const auto& edge : brush->brushRendererBrushCache().cachedEdges()) {
-                if (shouldRenderEdge(edge, policy)) {
+            for (const auto& edge : brushCache.cachedEdges()) {
+                if (shouldRenderEdge(brushCache, edge, policy, excludedAxis)) {
                     dest[i++] = static_cast<GLuint>(brushVerticesStartIndex + edge.vertexIndex1RelativeToBrush);
                     dest[i++] = static_cast<GLuint>(brushVerticesStartIndex + edge.vertexIndex2RelativeToBrush);
                 }
@@ -438,7 +822,7 @@ namespace TrenchBroom {
             return false;
         }
 
-        void BrushRenderer::validateBrush(const Model::BrushNode* brush) {
+        bool BrushRenderer::allocateBrush(const Model::BrushNode* brush, PendingBrush& pendingBrush) {
             assert(m_allBrushes.find(brush) != std::end(m_allBrushes));
             assert(m_invalidBrushes.find(brush) != std::end(m_invalidBrushes));
             assert(m_brushInfo.find(brush) == std::end(m_brushInfo));
@@ -452,42 +836,49 @@ namespace TrenchBroom {
             if (facePolicy == Filter::FaceRenderPolicy::RenderNone &&
                 edgePolicy == Filter::EdgeRenderPolicy::RenderNone) {
                 // NOTE: this skips inserting the brush into m_brushInfo
-                return;
+                return false;
             }
 
             BrushInfo& info = m_brushInfo[brush];
+            Chunk& chunk = chunkForBrush(brush);
+            info.chunk = &chunk;
+            ++chunk.brushCount;
 
-            // collect vertices
-            auto& brushCache = brush->brushRendererBrushCache();
-            brushCache.validateVertexCache(brush);
+            pendingBrush.brush = brush;
+            pendingBrush.edgePolicy = edgePolicy;
+            pendingBrush.info = &info;
+
+            // allocate vertices
+            const auto& brushCache = brush->brushRendererBrushCache();
             const auto& cachedVertices = brushCache.cachedVertices();
             ensure(!cachedVertices.empty(), "Brush must have cached vertices");
 
             assert(m_vertexArray != nullptr);
-            auto [vertBlock, dest] = m_vertexArray->getPointerToInsertVerticesAt(cachedVertices.size());
-            std::memcpy(dest, cachedVertices.data(), cachedVertices.size() * sizeof(*dest));
-            info.vertexHolderKey = vertBlock;
-
-            const auto brushVerticesStartIndex = static_cast<GLuint>(vertBlock->pos);
-
-            // insert edge indices into VBO
-            {
-                const size_t edgeIndexCount = countMarkedEdgeIndices(brush, edgePolicy);
-                if (edgeIndexCount > 0) {
-                    auto [key, insertDest] = m_edgeIndices->getPointerToInsertElementsAt(edgeIndexCount);
-                    info.edgeIndicesKey = key;
-                    getMarkedEdgeIndices(brush, edgePolicy, brushVerticesStartIndex, insertDest);
-                } else {
-                    // it's possible to have no edges to render
-                    // e.g. select all faces of a brush, and the unselected brush renderer
-                    // will hit this branch.
-                    ensure(info.edgeIndicesKey == nullptr, "BrushInfo not initialized");
-                }
+            info.vertexHolderKey = m_vertexArray->allocateVertices(cachedVertices.size());
+
+            // allocate edge indices
+            const size_t edgeIndexCount = countMarkedEdgeIndices(brush, edgePolicy);
+            if (edgeIndexCount > 0) {
+                info.edgeIndicesKey = chunk.edgeIndices->allocateElements(edgeIndexCount);
+            } else {
+                // it's possible to have no edges to render
+                // e.g. select all faces of a brush, and the unselected brush renderer
+                // will hit this branch.
+                ensure(info.edgeIndicesKey == nullptr, "BrushInfo not initialized");
             }
 
-            // insert face indices
+            // allocate the edge indices for the axes that 2D views look along
+            for (size_t axis = 0; axis < 3; ++axis) {
+                if (m_projectedEdgeAxes[axis]) {
+                    const size_t projectedEdgeIndexCount = countMarkedEdgeIndices(brush, edgePolicy, axis);
+                    if (projectedEdgeIndexCount > 0) {
+                        info.projectedEdgeIndicesKeys[axis] = chunk.projectedEdgeIndices[axis]->allocateElements(projectedEdgeIndexCount);
+                    }
+                }
+            }
 
-            auto& facesSortedByTex = brushCache.cachedFacesSortedByTexture();
+            // allocate face indices, one allocation per texture and pass
+            const auto& facesSortedByTex = brushCache.cachedFacesSortedByTexture();
             const size_t facesSortedByTexSize = facesSortedByTex.size();
 
             size_t nextI;
@@ -514,48 +905,63 @@ namespace TrenchBroom {
                 }
 
                 if (transparentIndexCount > 0) {
-                    TextureToBrushIndicesMap& faceVboMap = *m_transparentFaces;
-                    auto& holderPtr = faceVboMap[texture];
+                    auto& holderPtr = (*chunk.transparentFaces)[texture];
                     if (holderPtr == nullptr) {
                         // inserts into map!
                         holderPtr = std::make_shared<BrushIndexArray>();
                     }
-
-                    auto [key, insertDest] = holderPtr->getPointerToInsertElementsAt(transparentIndexCount);
-                    info.transparentFaceIndicesKeys.push_back({texture, key});
-
-                    // process all faces with this texture (they'll be consecutive)
-                    GLuint *currentDest = insertDest;
-                    for (size_t j = i; j < nextI; ++j) {
-                        const BrushRendererBrushCache::CachedFace& cache = facesSortedByTex[j];
-                        if (cache.face->isMarked() && shouldDrawFaceInTransparentPass(brush, *cache.face)) {
-                            addTriIndicesForPolygon(currentDest,
-                                                    static_cast<GLuint>(brushVerticesStartIndex +
-                                                                        cache.indexOfFirstVertexRelativeToBrush),
-                                                    cache.vertexCount);
-
-                            currentDest += triIndicesCountForPolygon(cache.vertexCount);
-                        }
-                    }
-                    assert(currentDest == (insertDest + transparentIndexCount));
+                    info.transparentFaceIndicesKeys.push_back({texture, holderPtr->allocateElements(transparentIndexCount)});
                 }
 
                 if (opaqueIndexCount > 0) {
-                    TextureToBrushIndicesMap& faceVboMap = *m_opaqueFaces;
-                    auto& holderPtr = faceVboMap[texture];
+                    auto& holderPtr = (*chunk.opaqueFaces)[texture];
                     if (holderPtr == nullptr) {
                         // inserts into map!
                         holderPtr = std::make_shared<BrushIndexArray>();
                     }
+                    info.opaqueFaceIndicesKeys.push_back({texture, holderPtr->allocateElements(opaqueIndexCount)});
+                }
+            }
+
+            return true;
+        }
+
+        void BrushRenderer::writeBrush(const PendingBrush& pendingBrush) const {
+            const auto* brush = pendingBrush.brush;
+            const auto& info = *pendingBrush.info;
+            const auto& chunk = *info.chunk;
+            const auto& brushCache = brush->brushRendererBrushCache();
 
-                    auto [key, insertDest] = holderPtr->getPointerToInsertElementsAt(opaqueIndexCount);
-                    info.opaqueFaceIndicesKeys.push_back({texture, key});
+            // write vertices
+            const auto& cachedVertices = brushCache.cachedVertices();
+            auto* vertexDest = m_vertexArray->vertices(info.vertexHolderKey);
+            std::memcpy(vertexDest, cachedVertices.data(), cachedVertices.size() * sizeof(*vertexDest));
+
+            const auto brushVerticesStartIndex = static_cast<GLuint>(info.vertexHolderKey->pos);
 
-                    // process all faces with this texture (they'll be consecutive)
-                    GLuint *currentDest = insertDest;
-                    for (size_t j = i; j < nextI; ++j) {
-                        const BrushRendererBrushCache::CachedFace& cache = facesSortedByTex[j];
-                        if (cache.face->isMarked() && !shouldDrawFaceInTransparentPass(brush, *cache.face)) {
+            // write edge indices
+            if (info.edgeIndicesKey != nullptr) {
+                auto* edgeDest = chunk.edgeIndices->elements(info.edgeIndicesKey);
+                getMarkedEdgeIndices(brush, pendingBrush.edgePolicy, brushVerticesStartIndex, edgeDest);
+            }
+            for (size_t axis = 0; axis < 3; ++axis) {
+                if (auto* key = info.projectedEdgeIndicesKeys[axis]) {
+                    auto* edgeDest = chunk.projectedEdgeIndices[axis]->elements(key);
+                    getMarkedEdgeIndices(brush, pendingBrush.edgePolicy, brushVerticesStartIndex, edgeDest, axis);
+                }
+            }
+
+            // write face indices
+            const auto& facesSortedByTex = brushCache.cachedFacesSortedByTexture();
+            const auto writeFaceIndices = [&](const TextureToBrushIndicesMap& indexArrays, const auto& keys, const bool transparent) {
+                for (const auto& [texture, key] : keys) {
+                    const auto faces = std::equal_range(std::begin(facesSortedByTex), std::end(facesSortedByTex), texture, CompareCachedFaceByTexture{});
+
+                    GLuint* insertDest = indexArrays.at(texture)->elements(key);
+                    GLuint* currentDest = insertDest;
+                    for (auto it = faces.first; it != faces.second; ++it) {
+                        const BrushRendererBrushCache::CachedFace& cache = *it;
+                        if (cache.face->isMarked() && shouldDrawFaceInTransparentPass(brush, *cache.face) == transparent) {
                             addTriIndicesForPolygon(currentDest,
                                                     static_cast<GLuint>(brushVerticesStartIndex +
                                                                         cache.indexOfFirstVertexRelativeToBrush),
@@ -564,9 +970,13 @@ namespace TrenchBroom {
                             currentDest += triIndicesCountForPolygon(cache.vertexCount);
                         }
                     }
-                    assert(currentDest == (insertDest + opaqueIndexCount));
+                    assert(currentDest == (insertDest + key->size));
+                    unused(insertDest);
                 }
-            }
+            };
+
+            writeFaceIndices(*chunk.transparentFaces, info.transparentFaceIndicesKeys, true);
+            writeFaceIndices(*chunk.opaqueFaces, info.opaqueFaceIndicesKeys, false);
         }
 
         void BrushRenderer::addBrush(const Model::BrushNode* brush) {
@@ -595,39 +1005,53 @@ namespace TrenchBroom {
             auto it = m_brushInfo.find(brush);
 
             if (it == std::end(m_brushInfo)) {
-                // This means BrushRenderer::validateBrush skipped rendering the brush, so it was never
+                // This means BrushRenderer::allocateBrush skipped rendering the brush, so it was never
                 // uploaded to the VBO's
                 return;
             }
 
             const BrushInfo& info = it->second;
+            Chunk& chunk = *info.chunk;
 
             // update Vbo's
             m_vertexArray->deleteVerticesWithKey(info.vertexHolderKey);
             if (info.edgeIndicesKey != nullptr) {
-                m_edgeIndices->zeroElementsWithKey(info.edgeIndicesKey);
+                chunk.edgeIndices->zeroElementsWithKey(info.edgeIndicesKey);
+            }
+            for (size_t axis = 0; axis < 3; ++axis) {
+                if (auto* key = info.projectedEdgeIndicesKeys[axis]) {
+                    chunk.projectedEdgeIndices[axis]->zeroElementsWithKey(key);
+                }
             }
 
             for (const auto& [texture, opaqueKey] : info.opaqueFaceIndicesKeys) {
-                std::shared_ptr<BrushIndexArray> faceIndexHolder = m_opaqueFaces->at(texture);
+                std::shared_ptr<BrushIndexArray> faceIndexHolder = chunk.opaqueFaces->at(texture);
                 faceIndexHolder->zeroElementsWithKey(opaqueKey);
 
                 if (!faceIndexHolder->hasValidIndices()) {
                     // There are no indices left to render for this texture, so delete the <Texture, BrushIndexArray> entry from the map
-                    m_opaqueFaces->erase(texture);
+                    chunk.opaqueFaces->erase(texture);
                 }
             }
             for (const auto& [texture, transparentKey] : info.transparentFaceIndicesKeys) {
-                std::shared_ptr<BrushIndexArray> faceIndexHolder = m_transparentFaces->at(texture);
+                std::shared_ptr<BrushIndexArray> faceIndexHolder = chunk.transparentFaces->at(texture);
                 faceIndexHolder->zeroElementsWithKey(transparentKey);
 
                 if (!faceIndexHolder->hasValidIndices()) {
                     // There are no indices left to render for this texture, so delete the <Texture, BrushIndexArray> entry from the map
-                    m_transparentFaces->erase(texture);
+                    chunk.transparentFaces->erase(texture);
                 }
             }
 
             m_brushInfo.erase(it);
+
+            assert(chunk.brushCount > 0u);
+            if (--chunk.brushCount == 0u) {
+                if (chunk.occlusionQuery) {
+                    m_releasedQueries.push_back(std::move(chunk.occlusionQuery));
+                }
+                m_chunks.erase(chunk.key);
+            }
         }
     }
 }
@@ -24,8 +24,14 @@
 #include "Renderer/AllocationTracker.h"
 #include "Renderer/EdgeRenderer.h"
 #include "Renderer/FaceRenderer.h"
+#include "Renderer/OcclusionQuery.h"
 
+#include <vecmath/bbox.h>
+
+#include <array>
+#include <map>
 #include <memory>
+#include <optional>
 #include <tuple>
 #include <unordered_map>
 #include <unordered_set>
@@ -93,6 +99,7 @@ namespace TrenchBroom {
                 bool visible(const Model::BrushNode* brush) const;
                 bool visible(const Model::BrushNode* brush, const Model::BrushFace& face) const;
                 bool visible(const Model::BrushNode* brush, const Model::BrushEdge* edge) const;
+                bool faceVisible(const Model::BrushFace& face) const;
 
                 bool editable(const Model::BrushNode* brush) const;
                 bool editable(const Model::BrushNode* brush, const Model::BrushFace& face) const;
@@ -117,9 +124,59 @@ namespace TrenchBroom {
         private:
             std::unique_ptr<Filter> m_filter;
 
+            using TextureToBrushIndicesMap = std::unordered_map<const Assets::Texture*, std::shared_ptr<BrushIndexArray>>;
+
+            /**
+             * The brushes are bucketed into chunks on a regular grid by the centers of their bounds. Every chunk has
+             * its own index arrays, so that chunks that lie outside of the camera frustum can be skipped when
+             * rendering. The vertex array is shared by all chunks, and the faces of all visible chunks are rendered
+             * by a single face renderer per pass.
+             */
+            using ChunkKey = std::tuple<int, int, int>;
+
+            struct Chunk {
+                ChunkKey key;
+                vm::bbox3f bounds;
+                size_t brushCount = 0;
+
+                std::shared_ptr<BrushIndexArray> edgeIndices;
+                std::shared_ptr<TextureToBrushIndicesMap> transparentFaces;
+                std::shared_ptr<TextureToBrushIndicesMap> opaqueFaces;
+
+                /**
+                 * For each axis, the edges that are not parallel to it. A 2D view that looks along an axis renders
+                 * these instead of all edges, since the other edges collapse to single points. Only brushes that
+                 * were allocated after a 2D view looked along an axis have edges in the corresponding array.
+                 */
+                std::array<std::shared_ptr<BrushIndexArray>, 3> projectedEdgeIndices;
+
+                IndexedEdgeRenderer edgeRenderer;
+                std::array<IndexedEdgeRenderer, 3> projectedEdgeRenderers;
+
+                /**
+                 * Counts the samples of the chunk's bounding box that passed the depth test in the last frame in
+                 * which the query was issued. Only used if occlusion culling is enabled.
+                 */
+                std::unique_ptr<OcclusionQuery> occlusionQuery;
+            };
+
+            /**
+             * The edge length of a chunk. Each chunk adds one draw call per texture, so the chunks must not be too
+             * small.
+             */
+            static constexpr float ChunkSize = 1024.0f;
+
+            /**
+             * The edges of a chunk are not rendered in the 3D view if its brushes would on average be smaller than
+             * this many pixels on screen, because the edges of distant geometry only add noise at that point.
+             */
+            static constexpr float MinBrushSizeForEdges = 4.0f;
+
             struct BrushInfo {
+                Chunk* chunk;
                 AllocationTracker::Block* vertexHolderKey;
                 AllocationTracker::Block* edgeIndicesKey;
+                std::array<AllocationTracker::Block*, 3> projectedEdgeIndicesKeys;
                 std::vector<std::pair<const Assets::Texture*, AllocationTracker::Block*>> opaqueFaceIndicesKeys;
                 std::vector<std::pair<const Assets::Texture*, AllocationTracker::Block*>> transparentFaceIndicesKeys;
             };
@@ -139,15 +196,23 @@ namespace TrenchBroom {
             std::unordered_set<const Model::BrushNode*> m_invalidBrushes;
 
             std::shared_ptr<BrushVertexArray> m_vertexArray;
-            std::shared_ptr<BrushIndexArray> m_edgeIndices;
 
-            using TextureToBrushIndicesMap = std::unordered_map<const Assets::Texture*, std::shared_ptr<BrushIndexArray>>;
-            std::shared_ptr<TextureToBrushIndicesMap> m_transparentFaces;
-            std::shared_ptr<TextureToBrushIndicesMap> m_opaqueFaces;
+            /**
+             * Chunks are erased once they don't contain any brushes, so the pointers to chunks are stable.
+             */
+            std::map<ChunkKey, Chunk> m_chunks;
+
+            /**
+             * The occlusion queries of erased chunks. Chunks may be erased while no OpenGL context is current, so
+             * their queries are freed the next time the brushes are rendered.
+             */
+            std::vector<std::unique_ptr<OcclusionQuery>> m_releasedQueries;
 
+            /**
+             * Rebuilt from the visible chunks whenever the brushes are rendered.
+             */
             FaceRenderer m_opaqueFaceRenderer;
             FaceRenderer m_transparentFaceRenderer;
-            IndexedEdgeRenderer m_edgeRenderer;
 
             Color m_faceColor;
             bool m_showEdges;
@@ -161,6 +226,12 @@ namespace TrenchBroom {
             float m_transparencyAlpha;
 
             bool m_showHiddenBrushes;
+            bool m_occlusionCulling;
+
+            /**
+             * The axes along which a 2D view has rendered the brushes, see Chunk::projectedEdgeIndices.
+             */
+            std::array<bool, 3> m_projectedEdgeAxes;
         public:
             template <typename FilterT>
             explicit BrushRenderer(const FilterT& filter) :
@@ -171,11 +242,14 @@ namespace TrenchBroom {
             m_showOccludedEdges(false),
             m_forceTransparent(false),
             m_transparencyAlpha(1.0f),
-            m_showHiddenBrushes(false) {
+            m_showHiddenBrushes(false),
+            m_occlusionCulling(false),
+            m_projectedEdgeAxes{false, false, false} {
                 clear();
             }
 
             BrushRenderer();
+            ~BrushRenderer();
 
             /**
              * New brushes are invalidated, brushes already in the BrushRenderer are not invalidated.
@@ -194,8 +268,8 @@ namespace TrenchBroom {
              *
              * Until a brush is invalidated, we don't re-evaluate the Filter, and don't check the Brush object for modification.
              *
-             * Additionally, calling `invalidate()` guarantees the m_brushInfo, m_transparentFaces, and m_opaqueFaces
-             * maps will be empty, so the BrushRenderer will not have any lingering Texture* pointers.
+             * Additionally, calling `invalidate()` guarantees the m_brushInfo and m_chunks maps will be empty, so the
+             * BrushRenderer will not have any lingering Texture* pointers.
              */
             void invalidate();
             void invalidateBrushes(const std::vector<Model::BrushNode*>& brushes);
@@ -265,14 +339,39 @@ namespace TrenchBroom {
              * Specifies whether or not brushes which are currently hidden should be rendered regardless.
              */
             void setShowHiddenBrushes(bool showHiddenBrushes);
+
+            /**
+             * Specifies whether or not chunks whose bounding boxes were entirely hidden behind other geometry in the
+             * previous frame should be skipped. Only applies to 3D views.
+             */
+            void setOcclusionCulling(bool occlusionCulling);
+
+            /**
+             * Returns the allocation statistics of the vertex array.
+             */
+            AllocationTracker::Statistics vertexStatistics() const;
+
+            /**
+             * Returns the allocation statistics of all index arrays combined. The largest free block is the largest
+             * free block of any index array.
+             */
+            AllocationTracker::Statistics indexStatistics() const;
         public: // rendering
             void render(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
         private:
-            void renderOpaqueFaces(RenderBatch& renderBatch);
-            void renderTransparentFaces(RenderBatch& renderBatch);
-            void renderEdges(RenderBatch& renderBatch);
+            class OcclusionQueryRenderable;
+
+            bool chunkVisible(const RenderContext& renderContext, const Chunk& chunk) const;
+            bool chunkEdgesVisible(const RenderContext& renderContext, const Chunk& chunk) const;
+            void renderOcclusionQueries(RenderContext& renderContext, RenderBatch& renderBatch);
+            using IndexArrayMapList = std::vector<std::shared_ptr<const TextureToBrushIndicesMap>>;
+
+            void renderOpaqueFaces(IndexArrayMapList opaqueFaces, RenderBatch& renderBatch);
+            void renderTransparentFaces(IndexArrayMapList transparentFaces, RenderBatch& renderBatch);
+            void renderEdges(Chunk& chunk, RenderBatch& renderBatch, std::optional<size_t> viewAxis);
+            std::optional<size_t> projectedEdgeAxis(RenderContext& renderContext);
 
         public:
             /**
@@ -281,10 +380,47 @@ namespace TrenchBroom {
             void validate();
         private:
             bool shouldDrawFaceInTransparentPass(const Model::BrushNode* brush, const Model::BrushFace& face) const;
-            void validateBrush(const Model::BrushNode* brush);
+            /**
+             * A brush whose space in the vertex and index arrays was allocated by allocateBrush(), but whose vertices
+             * and indices have not been written yet.
+             */
+            struct PendingBrush {
+                const Model::BrushNode* brush;
+                Filter::EdgeRenderPolicy edgePolicy;
+                BrushInfo* info;
+            };
+
+            /**
+             * Evaluates the filter for the given brush and allocates space for its vertices and indices. Expects the
+             * brush's vertex cache to be valid.
+             *
+             * @return false if the brush is not rendered at all
+             */
+            bool allocateBrush(const Model::BrushNode* brush, PendingBrush& pendingBrush);
+
+            /**
+             * Writes the vertices and indices of the given brush into the space allocated for it. Can run
+             * concurrently for different brushes since they write to disjoint ranges.
+             */
+            void writeBrush(const PendingBrush& pendingBrush) const;
             void addBrush(const Model::BrushNode* brush);
             void removeBrush(const Model::BrushNode* brush);
 
+            /**
+             * Compacts the vertex and index arrays if they have become sparse, so that long editing sessions don't
+             * keep growing the buffers.
+             */
+            void compactArrays();
+
+            Chunk& chunkForBrush(const Model::BrushNode* brush);
+            void resetChunkRenderers(Chunk& chunk);
+
+            /**
+             * Moves the occlusion queries of all chunks to the released queries and erases the chunks.
+             */
+            void clearChunks();
+            void freeReleasedQueries();
+
             /**
              * If the given brush is not currently in the VBO, it's silently ignored.
              * Otherwise, it's removed from the VBO (having its indices zeroed out, causing it to no longer draw).
@@ -22,6 +22,7 @@
 #include <cassert>
 #include <algorithm>
 #include <cstring>
+#include <iterator>
 #include <stdexcept>
 
 namespace TrenchBroom {
@@ -68,6 +69,23 @@ namespace TrenchBroom {
             return m_dirtySize == 0;
         }
 
+        /**
+         * Arrays are only compacted once more than half of their capacity is free, and they retain some free space
+         * afterwards so that they aren't compacted again and again while the user is editing.
+         */
+        static constexpr size_t MinCompactionCapacity = 1024u;
+
+        static bool shouldCompact(const AllocationTracker& allocationTracker) {
+            const auto capacity = allocationTracker.capacity();
+            const auto usedSize = allocationTracker.usedSize();
+            return capacity >= MinCompactionCapacity && capacity - usedSize > usedSize;
+        }
+
+        static size_t compactedCapacity(const AllocationTracker& allocationTracker) {
+            const auto usedSize = allocationTracker.usedSize();
+            return usedSize + usedSize / 2u;
+        }
+
         // IndexHolder
 
         IndexHolder::IndexHolder() : VboHolder<Index>(VboType::ElementArrayBuffer) {}
@@ -80,6 +98,25 @@ namespace TrenchBroom {
             std::memset(dest, 0, count * sizeof(Index));
         }
 
+        void IndexHolder::relocateVertices(const std::vector<AllocationTracker::Relocation>& relocations) {
+            if (relocations.empty() || empty()) {
+                return;
+            }
+
+            for (auto& index : m_snapshot) {
+                // find the last relocation that starts at or before the index
+                auto it = std::upper_bound(std::begin(relocations), std::end(relocations), index,
+                    [](const Index i, const AllocationTracker::Relocation& relocation) { return i < relocation.oldPos; });
+                if (it != std::begin(relocations)) {
+                    const auto& relocation = *std::prev(it);
+                    if (index < relocation.oldPos + relocation.size) {
+                        index = static_cast<Index>(index - relocation.oldPos + relocation.newPos);
+                    }
+                }
+            }
+            markAllDirty();
+        }
+
         void IndexHolder::render(const PrimType primType, const size_t offset, size_t count) const {
             const GLsizei renderCount = static_cast<GLsizei>(count);
             const GLvoid *renderOffset = reinterpret_cast<GLvoid *>(m_vbo->offset() + sizeof(Index) * offset);
@@ -103,24 +140,30 @@ namespace TrenchBroom {
         }
 
         std::pair<AllocationTracker::Block*, GLuint*> BrushIndexArray::getPointerToInsertElementsAt(const size_t elementCount) {
+            auto* block = allocateElements(elementCount);
+            return {block, elements(block)};
+        }
+
+        AllocationTracker::Block* BrushIndexArray::allocateElements(const size_t elementCount) {
             auto block = m_allocationTracker.allocate(elementCount);
-            if (block != nullptr) {
-                GLuint* dest = m_indexHolder.getPointerToWriteElementsTo(block->pos, elementCount);
-                return {block, dest};
+            if (block == nullptr) {
+                // retry
+                const size_t newSize = std::max(2 * m_allocationTracker.capacity(),
+                                                m_allocationTracker.capacity() + elementCount);
+                m_allocationTracker.expand(newSize);
+                m_indexHolder.resize(newSize);
+
+                // insert again
+                block = m_allocationTracker.allocate(elementCount);
+                assert(block != nullptr);
             }
 
-            // retry
-            const size_t newSize = std::max(2 * m_allocationTracker.capacity(),
-                                            m_allocationTracker.capacity() + elementCount);
-            m_allocationTracker.expand(newSize);
-            m_indexHolder.resize(newSize);
-
-            // insert again
-            block = m_allocationTracker.allocate(elementCount);
-            assert(block != nullptr);
+            m_indexHolder.getPointerToWriteElementsTo(block->pos, elementCount);
+            return block;
+        }
 
-            GLuint* dest = m_indexHolder.getPointerToWriteElementsTo(block->pos, elementCount);
-            return {block, dest};
+        GLuint* BrushIndexArray::elements(AllocationTracker::Block* key) {
+            return m_indexHolder.elementsAt(key->pos);
         }
 
         void BrushIndexArray::zeroElementsWithKey(AllocationTracker::Block* key) {
@@ -131,6 +174,31 @@ namespace TrenchBroom {
             m_indexHolder.zeroRange(pos, size);
         }
 
+        bool BrushIndexArray::compact() {
+            if (!shouldCompact(m_allocationTracker)) {
+                return false;
+            }
+
+            const auto newCapacity = compactedCapacity(m_allocationTracker);
+            const auto relocations = m_allocationTracker.compact();
+            m_allocationTracker.truncate(newCapacity);
+            m_indexHolder.relocate(relocations, newCapacity);
+
+            // the free range at the end must consist of degenerate primitives
+            if (newCapacity > m_allocationTracker.usedSize()) {
+                m_indexHolder.zeroRange(m_allocationTracker.usedSize(), newCapacity - m_allocationTracker.usedSize());
+            }
+            return true;
+        }
+
+        void BrushIndexArray::relocateVertices(const std::vector<AllocationTracker::Relocation>& relocations) {
+            m_indexHolder.relocateVertices(relocations);
+        }
+
+        AllocationTracker::Statistics BrushIndexArray::statistics() const {
+            return m_allocationTracker.statistics();
+        }
+
         void BrushIndexArray::render(const PrimType primType) const {
             assert(m_indexHolder.prepared());
             m_indexHolder.render(primType, 0, m_indexHolder.size());
@@ -159,24 +227,30 @@ namespace TrenchBroom {
                                                m_allocationTracker(0) {}
 
         std::pair<AllocationTracker::Block*, BrushVertexArray::Vertex*> BrushVertexArray::getPointerToInsertVerticesAt(const size_t vertexCount) {
+            auto* block = allocateVertices(vertexCount);
+            return {block, vertices(block)};
+        }
+
+        AllocationTracker::Block* BrushVertexArray::allocateVertices(const size_t vertexCount) {
             auto block = m_allocationTracker.allocate(vertexCount);
-            if (block != nullptr) {
-                Vertex* dest = m_vertexHolder.getPointerToWriteElementsTo(block->pos, vertexCount);
-                return {block, dest};
+            if (block == nullptr) {
+                // retry
+                const size_t newSize = std::max(2 * m_allocationTracker.capacity(),
+                                                m_allocationTracker.capacity() + vertexCount);
+                m_allocationTracker.expand(newSize);
+                m_vertexHolder.resize(newSize);
+
+                // insert again
+                block = m_allocationTracker.allocate(vertexCount);
+                assert(block != nullptr);
             }
 
-            // retry
-            const size_t newSize = std::max(2 * m_allocationTracker.capacity(),
-                                            m_allocationTracker.capacity() + vertexCount);
-            m_allocationTracker.expand(newSize);
-            m_vertexHolder.resize(newSize);
-
-            // insert again
-            block = m_allocationTracker.allocate(vertexCount);
-            assert(block != nullptr);
+            m_vertexHolder.getPointerToWriteElementsTo(block->pos, vertexCount);
+            return block;
+        }
 
-            Vertex* dest = m_vertexHolder.getPointerToWriteElementsTo(block->pos, vertexCount);
-            return {block, dest};
+        BrushVertexArray::Vertex* BrushVertexArray::vertices(AllocationTracker::Block* key) {
+            return m_vertexHolder.elementsAt(key->pos);
         }
 
         void BrushVertexArray::deleteVerticesWithKey(AllocationTracker::Block* key) {
@@ -188,6 +262,22 @@ namespace TrenchBroom {
             // us to re-use the space later
         }
 
+        std::vector<AllocationTracker::Relocation> BrushVertexArray::compact() {
+            if (!shouldCompact(m_allocationTracker)) {
+                return {};
+            }
+
+            const auto newCapacity = compactedCapacity(m_allocationTracker);
+            auto relocations = m_allocationTracker.compact();
+            m_allocationTracker.truncate(newCapacity);
+            m_vertexHolder.relocate(relocations, newCapacity);
+            return relocations;
+        }
+
+        AllocationTracker::Statistics BrushVertexArray::statistics() const {
+            return m_allocationTracker.statistics();
+        }
+
         bool BrushVertexArray::setupVertices() {
             return m_vertexHolder.setupVertices();
         }
@@ -30,6 +30,8 @@
 
 #include <vecmath/vec.h>
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <memory>
 #include <unordered_map>
@@ -63,8 +65,10 @@ namespace TrenchBroom {
          * Non-copyable; meant to be held in a std::shared_ptr.
          * Able to be resized, and handles copying edits made in the local std::vector to the VBO.
          *
-         * Currently uses a single range to track the modified region which might upload much more than necessary;
-         * it might be worth mapping the VBO and editing it directly.
+         * Currently uses a single range to track the modified region which might upload much more than necessary.
+         * If the VboManager uses persistently mapped buffers, the upload is a plain memory copy into the next region
+         * of the buffer. Since that region lacks the changes that were written to the other regions in the meantime,
+         * the holder tracks them for every region and writes them along with the new changes.
          */
         template<typename T>
         class VboHolder {
@@ -72,6 +76,7 @@ namespace TrenchBroom {
             VboType m_type;
             std::vector<T> m_snapshot;
             DirtyRangeTracker m_dirtyRange;
+            std::array<DirtyRangeTracker, Vbo::RegionCount> m_regionDirtyRanges;
             VboManager* m_vboManager;
             Vbo* m_vbo;
         private:
@@ -82,6 +87,13 @@ namespace TrenchBroom {
                 }
             }
 
+            void writeRange(const size_t pos, const size_t size) {
+                const size_t bytesFromStart = pos * sizeof(T);
+                m_vbo->writeArray(bytesFromStart,
+                                  m_snapshot.data() + pos,
+                                  size);
+            }
+
             void allocateBlock(VboManager& vboManager) {
                 if (m_vboManager != nullptr) {
                     assert(m_vboManager == &vboManager);
@@ -95,6 +107,14 @@ namespace TrenchBroom {
 
                 m_vbo->writeElements(0, m_snapshot);
 
+                // only the current region has been written
+                for (size_t i = 0; i < m_regionDirtyRanges.size(); ++i) {
+                    m_regionDirtyRanges[i] = DirtyRangeTracker(m_snapshot.size());
+                    if (i != m_vbo->region()) {
+                        m_regionDirtyRanges[i].markDirty(0, m_snapshot.size());
+                    }
+                }
+
                 m_dirtyRange = DirtyRangeTracker(m_snapshot.size());
                 assert(m_dirtyRange.clean());
                 assert((m_vbo->capacity() / sizeof(T)) == m_dirtyRange.capacity());
@@ -105,6 +125,7 @@ namespace TrenchBroom {
             m_type(type),
             m_snapshot(),
             m_dirtyRange(0),
+            m_regionDirtyRanges(),
             m_vboManager(nullptr),
             m_vbo(nullptr) {}
 
@@ -115,6 +136,7 @@ namespace TrenchBroom {
             m_type(type),
             m_snapshot(),
             m_dirtyRange(elements.size()),
+            m_regionDirtyRanges(),
             m_vboManager(nullptr),
             m_vbo(nullptr) {
 
@@ -151,11 +173,42 @@ namespace TrenchBroom {
                 return m_snapshot.data() + offsetWithinBlock;
             }
 
+            /**
+             * Returns a pointer to the given element without marking anything dirty. The pointer is invalidated by
+             * resizing.
+             */
+            T* elementsAt(const size_t offsetWithinBlock) {
+                assert(offsetWithinBlock < m_snapshot.size());
+                return m_snapshot.data() + offsetWithinBlock;
+            }
+
             bool prepared() const {
                 // NOTE: this returns true if the capacity is 0
                 return m_dirtyRange.clean();
             }
 
+            /**
+             * Moves the elements as described by the given relocations, which must be ordered by position and move
+             * every range towards the start, and then truncates to the given size. The next call to prepare() uploads
+             * the elements into a new buffer if the size changed.
+             */
+            void relocate(const std::vector<AllocationTracker::Relocation>& relocations, const size_t newSize) {
+                T* data = m_snapshot.data();
+                for (const auto& relocation : relocations) {
+                    assert(relocation.newPos < relocation.oldPos);
+                    std::copy(data + relocation.oldPos, data + relocation.oldPos + relocation.size, data + relocation.newPos);
+                }
+
+                assert(newSize <= m_snapshot.size());
+                m_snapshot.resize(newSize);
+                markAllDirty();
+            }
+
+            void markAllDirty() {
+                m_dirtyRange = DirtyRangeTracker(m_snapshot.size());
+                m_dirtyRange.markDirty(0, m_snapshot.size());
+            }
+
             void prepare(VboManager& vboManager) {
                 if (empty()) {
                     assert(prepared());
@@ -183,13 +236,25 @@ namespace TrenchBroom {
                 // otherwise, it's an incremental update of the dirty ranges.
 
                 if (!m_dirtyRange.clean()) {
+                    if (m_vbo->advanceRegion()) {
+                        auto& regionDirtyRange = m_regionDirtyRanges[m_vbo->region()];
+                        if (!regionDirtyRange.clean()) {
+                            writeRange(regionDirtyRange.m_dirtyPos, regionDirtyRange.m_dirtySize);
+                        }
+                        regionDirtyRange = DirtyRangeTracker(m_snapshot.size());
+                    }
+
                     const size_t pos = m_dirtyRange.m_dirtyPos;
                     const size_t size = m_dirtyRange.m_dirtySize;
-
-                    const size_t bytesFromStart = pos * sizeof(T);
-                    m_vbo->writeArray(bytesFromStart,
-                                      m_snapshot.data() + pos,
-                                      size);
+                    writeRange(pos, size);
+
+                    if (m_vbo->persistentlyMapped()) {
+                        for (size_t i = 0; i < m_regionDirtyRanges.size(); ++i) {
+                            if (i != m_vbo->region()) {
+                                m_regionDirtyRanges[i].markDirty(pos, size);
+                            }
+                        }
+                    }
                 }
 
                 m_dirtyRange = DirtyRangeTracker(m_snapshot.size());
@@ -223,6 +288,10 @@ namespace TrenchBroom {
              */
             explicit IndexHolder(std::vector<Index>& elements);
             void zeroRange(size_t offsetWithinBlock, size_t count);
+            /**
+             * Adjusts all indices that refer to vertices that were moved by the given relocations.
+             */
+            void relocateVertices(const std::vector<AllocationTracker::Relocation>& relocations);
             void render(PrimType primType, size_t offset, size_t count) const;
 
             static std::shared_ptr<IndexHolder> swap(std::vector<Index>& elements);
@@ -254,11 +323,39 @@ namespace TrenchBroom {
              */
             std::pair<AllocationTracker::Block*, GLuint*> getPointerToInsertElementsAt(size_t elementCount);
 
+            /**
+             * Allocates the given number of indices and marks them dirty, but doesn't return a pointer to write them
+             * to, because the pointer would be invalidated by subsequent allocations. Use elements() to obtain a
+             * pointer once all allocations are made.
+             */
+            AllocationTracker::Block* allocateElements(size_t elementCount);
+
+            /**
+             * Returns a pointer to the indices of the given allocation. Writing to it is safe from several threads as
+             * long as the allocations differ and no allocations are made concurrently.
+             */
+            GLuint* elements(AllocationTracker::Block* key);
+
             /**
              * Deletes indices for the given brush and marks the allocation as free.
              */
             void zeroElementsWithKey(AllocationTracker::Block* key);
 
+            /**
+             * Moves all allocations to the start of the array and shrinks it if more than half of its capacity is
+             * free. The keys returned by getPointerToInsertElementsAt() remain valid.
+             *
+             * @return true if the array was compacted
+             */
+            bool compact();
+
+            /**
+             * Adjusts the indices after the vertices they refer to were moved by BrushVertexArray::compact().
+             */
+            void relocateVertices(const std::vector<AllocationTracker::Relocation>& relocations);
+
+            AllocationTracker::Statistics statistics() const;
+
             void render(const PrimType primType) const;
             bool prepared() const;
             void prepare(VboManager& vboManager);
@@ -314,7 +411,7 @@ namespace TrenchBroom {
          */
         class BrushVertexArray {
         private:
-            using Vertex = Renderer::GLVertexTypes::P3NT2::Vertex;
+            using Vertex = Renderer::GLVertexTypes::P3NPT2::Vertex;
 
             VertexHolder<Vertex> m_vertexHolder;
             AllocationTracker m_allocationTracker;
@@ -331,8 +428,30 @@ namespace TrenchBroom {
              */
             std::pair<AllocationTracker::Block*, Vertex*> getPointerToInsertVerticesAt(size_t vertexCount);
 
+            /**
+             * Same as BrushIndexArray::allocateElements(), but for vertices.
+             */
+            AllocationTracker::Block* allocateVertices(size_t vertexCount);
+
+            /**
+             * Same as BrushIndexArray::elements(), but for vertices.
+             */
+            Vertex* vertices(AllocationTracker::Block* key);
+
             void deleteVerticesWithKey(AllocationTracker::Block* key);
 
+            /**
+             * Moves all allocations to the start of the array and shrinks it if more than half of its capacity is
+             * free. The keys returned by getPointerToInsertVerticesAt() remain valid, but the indices referring to
+             * the moved vertices must be adjusted by passing the returned relocations to
+             * BrushIndexArray::relocateVertices() for every index array that refers to this vertex array.
+             *
+             * @return the relocations of the moved vertices, empty if the array was not compacted
+             */
+            std::vector<AllocationTracker::Relocation> compact();
+
+            AllocationTracker::Statistics statistics() const;
+
             // setting up GL attributes
             bool setupVertices();
             void cleanupVertices();
@@ -23,8 +23,10 @@
 #include "Model/BrushFace.h"
 #include "Model/BrushGeometry.h"
 #include "Model/Polyhedron.h"
+#include "Model/TexCoordSystem.h"
 
 #include <algorithm>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -68,26 +70,51 @@ namespace TrenchBroom {
             m_cachedFacesSortedByTexture.clear();
             m_cachedFacesSortedByTexture.reserve(brush.faceCount());
 
+            m_cachedEdges.clear();
+            m_cachedEdges.reserve(brush.edgeCount());
+
             for (const Model::BrushFace& face : brush.faces()) {
                 const auto indexOfFirstVertexRelativeToBrush = m_cachedVertices.size();
+                const auto normal = GLVertexAttributeTypes::NP::pack(vm::vec3f(face.boundary().normal));
 
                 // The boundary is in CCW order, but the renderer expects CW order:
-                auto& boundary = face.geometry()->boundary();
+                const auto& boundary = face.geometry()->boundary();
+
+                // Compute the texture coordinates of all vertices of the face in one batch. The buffers are reused
+                // so that brushes validated on the same thread don't allocate them again.
+                thread_local auto positions = std::vector<vm::vec3>{};
+                thread_local auto texCoords = std::vector<vm::vec2f>{};
+                positions.clear();
+                for (auto it = std::rbegin(boundary), end = std::rend(boundary); it != end; ++it) {
+                    positions.push_back((*it)->origin()->position());
+                }
+                texCoords.resize(positions.size());
+                face.texCoordProjection().texCoords(std::begin(positions), std::end(positions), std::begin(texCoords));
+
                 for (auto it = std::rbegin(boundary), end = std::rend(boundary); it != end; ++it) {
-                    Model::BrushHalfEdge* current = *it;
-                    Model::BrushVertex* vertex = current->origin();
+                    const Model::BrushHalfEdge* current = *it;
 
-                    // Set the vertex payload to the index, relative to the brush's first vertex being 0.
-                    // This is used below when building the edge cache.
-                    // NOTE: we'll overwrite the payload as we visit the same vertex several times while visiting
-                    // different faces, this is fine.
+                    // The brush geometry may be shared with other brushes, so we must not store the vertex index in
+                    // the vertex payload. Instead, we build the edge cache here: every edge is visited exactly once
+                    // as the first half edge of one of its faces. Its second vertex is the origin of the next half
+                    // edge, which we visit right before the current half edge unless the current half edge is the
+                    // first one we visit.
                     const auto currentIndex = m_cachedVertices.size();
-                    vertex->setPayload(static_cast<GLuint>(currentIndex));
+                    const Model::BrushEdge* edge = current->edge();
+                    if (edge->firstEdge() == current) {
+                        const auto nextIndex = currentIndex == indexOfFirstVertexRelativeToBrush
+                            ? indexOfFirstVertexRelativeToBrush + boundary.size() - 1u
+                            : currentIndex - 1u;
 
-                    const auto& position = vertex->position();
-                    m_cachedVertices.emplace_back(vm::vec3f(position), vm::vec3f(face.boundary().normal), face.textureCoords(position));
+                        const auto faceIndex1 = edge->firstFace()->payload();
+                        const auto faceIndex2 = edge->secondFace()->payload();
+                        assert(faceIndex1 && faceIndex2);
 
-                    current = current->previous();
+                        m_cachedEdges.emplace_back(&brush.face(*faceIndex1), &brush.face(*faceIndex2), currentIndex, nextIndex);
+                    }
+
+                    const auto faceVertexIndex = currentIndex - indexOfFirstVertexRelativeToBrush;
+                    m_cachedVertices.emplace_back(vm::vec3f(positions[faceVertexIndex]), normal, texCoords[faceVertexIndex]);
                 }
 
                 // face cache
@@ -101,25 +128,6 @@ namespace TrenchBroom {
                       m_cachedFacesSortedByTexture.end(),
                       [](const CachedFace& a, const CachedFace& b){ return a.texture < b.texture; });
 
-            // Build edge index cache
-
-            m_cachedEdges.clear();
-            m_cachedEdges.reserve(brush.edgeCount());
-
-            for (const Model::BrushEdge* currentEdge : brush.edges()) {
-                const auto faceIndex1 = currentEdge->firstFace()->payload();
-                const auto faceIndex2 = currentEdge->secondFace()->payload();
-                assert(faceIndex1 && faceIndex2);
-                
-                const auto& face1 = brush.face(*faceIndex1);
-                const auto& face2 = brush.face(*faceIndex2);
-                
-                const auto vertexIndex1RelativeToBrush = currentEdge->firstVertex()->payload();
-                const auto vertexIndex2RelativeToBrush = currentEdge->secondVertex()->payload();
-
-                m_cachedEdges.emplace_back(&face1, &face2, vertexIndex1RelativeToBrush, vertexIndex2RelativeToBrush);
-            }
-
             m_rendererCacheValid = true;
         }
 
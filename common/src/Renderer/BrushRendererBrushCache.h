@@ -36,7 +36,7 @@ namespace TrenchBroom {
     namespace Renderer {
         class BrushRendererBrushCache {
         public:
-            using VertexSpec = Renderer::GLVertexTypes::P3NT2;
+            using VertexSpec = Renderer::GLVertexTypes::P3NPT2;
             using Vertex = VertexSpec::Vertex;
 
             struct CachedFace {
@@ -21,6 +21,8 @@
 
 #include "Macros.h"
 
+#include <vecmath/bbox.h>
+#include <vecmath/plane.h>
 #include <vecmath/ray.h>
 #include <vecmath/distance.h>
 #include <vecmath/intersection.h>
@@ -152,6 +154,23 @@ namespace TrenchBroom {
             doComputeFrustumPlanes(top, right, bottom, left);
         }
 
+        bool Camera::intersectsFrustum(const vm::bbox3f& bounds) const {
+            if (!m_valid)
+                validateMatrices();
+
+            for (const auto& plane : m_frustumPlanes) {
+                // the corner of the box that lies furthest in the opposite direction of the plane normal
+                auto corner = vm::vec3f{};
+                for (size_t i = 0; i < 3; ++i) {
+                    corner[i] = plane.normal[i] >= 0.0f ? bounds.min[i] : bounds.max[i];
+                }
+                if (plane.point_distance(corner) > 0.0f) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
         vm::ray3f Camera::viewRay() const {
             return vm::ray3f(m_position, m_direction);
         }
@@ -403,6 +422,8 @@ namespace TrenchBroom {
             const auto [invertible, inverse] = vm::invert(m_matrix);
             assert(invertible); unused(invertible);
             m_inverseMatrix = inverse;
+
+            doComputeFrustumPlanes(m_frustumPlanes[0], m_frustumPlanes[1], m_frustumPlanes[2], m_frustumPlanes[3]);
             m_valid = true;
         }
 
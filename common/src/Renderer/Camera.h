@@ -25,6 +25,7 @@
 #include <vecmath/forward.h>
 #include <vecmath/vec.h>
 #include <vecmath/mat.h>
+#include <vecmath/plane.h>
 #include <vecmath/ray.h>
 
 namespace TrenchBroom {
@@ -78,6 +79,7 @@ namespace TrenchBroom {
             mutable vm::mat4x4f m_viewMatrix;
             mutable vm::mat4x4f m_matrix;
             mutable vm::mat4x4f m_inverseMatrix;
+            mutable vm::plane3f m_frustumPlanes[4];
         protected:
             typedef enum {
                 Projection_Orthographic,
@@ -108,6 +110,13 @@ namespace TrenchBroom {
             const vm::mat4x4f verticalBillboardMatrix() const;
             void frustumPlanes(vm::plane3f& topPlane, vm::plane3f& rightPlane, vm::plane3f& bottomPlane, vm::plane3f& leftPlane) const;
 
+            /**
+             * Indicates whether the given box may be visible to this camera. Only the side planes of the frustum
+             * are considered, and the test is conservative: it may return true for some boxes that are close to the
+             * frustum, but it never returns false for a box that intersects it.
+             */
+            bool intersectsFrustum(const vm::bbox3f& bounds) const;
+
             vm::ray3f viewRay() const;
             vm::ray3f pickRay(float x, float y) const;
             vm::ray3f pickRay(const vm::vec3f& point) const;
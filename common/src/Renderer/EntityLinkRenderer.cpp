@@ -27,6 +27,7 @@
 #include "Model/EntityNodeBase.h"
 #include "Model/GroupNode.h"
 #include "Model/LayerNode.h"
+#include "Model/PatchNode.h"
 #include "Model/WorldNode.h"
 #include "View/MapDocument.h"
 
@@ -43,7 +44,8 @@ namespace TrenchBroom {
         EntityLinkRenderer::EntityLinkRenderer(std::weak_ptr<View::MapDocument> document) :
         m_document(document),
         m_defaultColor(0.5f, 1.0f, 0.5f, 1.0f),
-        m_selectedColor(1.0f, 0.0f, 0.0f, 1.0f) {}
+        m_selectedColor(1.0f, 0.0f, 0.0f, 1.0f),
+        m_linksBySourceValid(false) {}
 
         void EntityLinkRenderer::setDefaultColor(const Color& color) {
             if (color == m_defaultColor)
@@ -242,10 +244,142 @@ namespace TrenchBroom {
             }
         }
 
+        void EntityLinkRenderer::invalidateNodes(const std::vector<Model::Node*>& nodes) {
+            if (!m_linksBySourceValid) {
+                // everything is recomputed anyway
+                invalidateVertices();
+                return;
+            }
+
+            for (auto* node : nodes) {
+                node->accept(kdl::overload(
+                    [&](Model::WorldNode* world) {
+                        invalidateSource(world);
+                    },
+                    [](auto&& thisLambda, Model::LayerNode* layer) {
+                        layer->visitChildren(thisLambda);
+                    },
+                    [](auto&& thisLambda, Model::GroupNode* group) {
+                        group->visitChildren(thisLambda);
+                    },
+                    [&](Model::EntityNode* entity) {
+                        invalidateSource(entity);
+                    },
+                    [&](Model::BrushNode* brush) {
+                        invalidateSource(brush->entity());
+                    },
+                    [&](Model::PatchNode* patch) {
+                        invalidateSource(patch->entity());
+                    }
+                ));
+            }
+
+            invalidateVertices();
+        }
+
+        void EntityLinkRenderer::invalidateSource(Model::EntityNodeBase* node) {
+            if (node == nullptr) {
+                return;
+            }
+
+            // the links starting at the node and the links ending at the node must be recomputed; the cached sources
+            // cover the links that ended at the node before its properties changed
+            m_invalidSources.insert(node);
+            m_invalidSources.insert(std::begin(node->linkSources()), std::end(node->linkSources()));
+            m_invalidSources.insert(std::begin(node->killSources()), std::end(node->killSources()));
+
+            const auto it = m_sourcesByTarget.find(node);
+            if (it != std::end(m_sourcesByTarget)) {
+                m_invalidSources.insert(std::begin(it->second), std::end(it->second));
+                m_sourcesByTarget.erase(it);
+            }
+        }
+
+        void EntityLinkRenderer::validateLinksBySource(View::MapDocument& document) {
+            const auto& editorContext = document.editorContext();
+
+            if (!m_linksBySourceValid) {
+                m_linksBySource.clear();
+                m_sourcesByTarget.clear();
+                m_invalidSources.clear();
+
+                if (document.world() != nullptr) {
+                    document.world()->accept(kdl::overload(
+                        [](auto&& thisLambda, Model::WorldNode* world) {
+                            world->visitChildren(thisLambda);
+                        },
+                        [](auto&& thisLambda, Model::LayerNode* layer) {
+                            layer->visitChildren(thisLambda);
+                        },
+                        [](auto&& thisLambda, Model::GroupNode* group) {
+                            group->visitChildren(thisLambda);
+                        },
+                        [&](Model::EntityNode* entity) {
+                            addLinksBySource(editorContext, entity);
+                        },
+                        [](Model::BrushNode*) {},
+                        [](Model::PatchNode*) {}
+                    ));
+                }
+
+                m_linksBySourceValid = true;
+            } else if (!m_invalidSources.empty()) {
+                for (auto* source : m_invalidSources) {
+                    m_linksBySource.erase(source);
+
+                    // links starting at the world are not shown, see above
+                    source->accept(kdl::overload(
+                        [](Model::WorldNode*) {},
+                        [](Model::LayerNode*) {},
+                        [](Model::GroupNode*) {},
+                        [&](Model::EntityNode* entity) {
+                            addLinksBySource(editorContext, entity);
+                        },
+                        [](Model::BrushNode*) {},
+                        [](Model::PatchNode*) {}
+                    ));
+                }
+                m_invalidSources.clear();
+            }
+        }
+
+        void EntityLinkRenderer::addLinksBySource(const Model::EditorContext& editorContext, Model::EntityNodeBase* source) {
+            auto links = std::vector<LineVertex>{};
+            CollectAllLinksVisitor collectLinks(editorContext, m_defaultColor, m_selectedColor, links);
+            collectLinks.visit(source);
+
+            for (auto* target : source->linkTargets()) {
+                m_sourcesByTarget[target].insert(source);
+            }
+            for (auto* target : source->killTargets()) {
+                m_sourcesByTarget[target].insert(source);
+            }
+
+            if (!links.empty()) {
+                m_linksBySource[source] = std::move(links);
+            }
+        }
+
+        void EntityLinkRenderer::doInvalidate() {
+            m_linksBySourceValid = false;
+        }
+
         std::vector<LinkRenderer::LineVertex> EntityLinkRenderer::getLinks() {
             auto document = kdl::mem_lock(m_document);
             auto links = std::vector<LineVertex>{};
-            Renderer::getLinks(*document, m_defaultColor, m_selectedColor, links);
+
+            const QString entityLinkMode = pref(Preferences::EntityLinkMode);
+            if (entityLinkMode == Preferences::entityLinkModeAll()) {
+                validateLinksBySource(*document);
+                for (const auto& [source, sourceLinks] : m_linksBySource) {
+                    links.insert(std::end(links), std::begin(sourceLinks), std::end(sourceLinks));
+                }
+            } else {
+                // the other modes only show the links of the selected entities, which are cheap to collect
+                m_linksBySourceValid = false;
+                Renderer::getLinks(*document, m_defaultColor, m_selectedColor, links);
+            }
+
             return links;
         }
     }
@@ -24,9 +24,17 @@
 #include "Renderer/LinkRenderer.h"
 
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom {
+    namespace Model {
+        class EditorContext;
+        class EntityNodeBase;
+        class Node;
+    }
+
     namespace View {
         class MapDocument; // FIXME: Renderer should not depend on View
     }
@@ -37,12 +45,34 @@ namespace TrenchBroom {
 
             Color m_defaultColor;
             Color m_selectedColor;
+
+            /*
+             * When all links are shown, the links are cached per source entity so that changing a few entities
+             * only recomputes the links that start or end at them.
+             */
+            std::unordered_map<Model::EntityNodeBase*, std::vector<LinkRenderer::LineVertex>> m_linksBySource;
+            std::unordered_map<Model::EntityNodeBase*, std::unordered_set<Model::EntityNodeBase*>> m_sourcesByTarget;
+            std::unordered_set<Model::EntityNodeBase*> m_invalidSources;
+            bool m_linksBySourceValid;
         public:
             EntityLinkRenderer(std::weak_ptr<View::MapDocument> document);
 
             void setDefaultColor(const Color& color);
             void setSelectedColor(const Color& color);
+
+            /**
+             * Invalidates the links that start or end at the entities among or containing the given nodes, e.g.
+             * because the entities were moved or their link properties changed.
+             *
+             * The given nodes must not have been removed from the map since the links were last computed.
+             */
+            void invalidateNodes(const std::vector<Model::Node*>& nodes);
         private:
+            void invalidateSource(Model::EntityNodeBase* source);
+            void validateLinksBySource(View::MapDocument& document);
+            void addLinksBySource(const Model::EditorContext& editorContext, Model::EntityNodeBase* source);
+
+            void doInvalidate() override;
             std::vector<LinkRenderer::LineVertex> getLinks() override;
 
             deleteCopy(EntityLinkRenderer)
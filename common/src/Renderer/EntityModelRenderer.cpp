@@ -26,20 +26,28 @@
 #include "Assets/EntityModel.h"
 #include "Assets/EntityModelManager.h"
 #include "Assets/ModelDefinition.h"
+#include "Assets/Texture.h"
 #include "EL/ELExceptions.h"
 #include "Model/EditorContext.h"
 #include "Model/Entity.h"
 #include "Model/EntityNode.h"
 #include "Renderer/ActiveShader.h"
+#include "Renderer/Camera.h"
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
+#include "Renderer/RenderUtils.h"
 #include "Renderer/Shaders.h"
 #include "Renderer/ShaderManager.h"
 #include "Renderer/TexturedIndexRangeRenderer.h"
 #include "Renderer/Transformation.h"
 
+#include <vecmath/bbox.h>
 #include <vecmath/mat.h>
 
+#include <algorithm>
+#include <functional>
+#include <vector>
+
 namespace TrenchBroom {
     namespace Renderer {
         EntityModelRenderer::EntityModelRenderer(Logger& logger, Assets::EntityModelManager& entityModelManager, const Model::EditorContext& editorContext) :
@@ -58,9 +66,13 @@ namespace TrenchBroom {
                 return entityNode->entity().modelSpecification();
             });
 
-            auto* renderer = m_entityModelManager.renderer(modelSpec);
+            auto* renderer = m_entityModelManager.acquireRenderer(modelSpec);
             if (renderer != nullptr) {
-                m_entities.insert(std::make_pair(entityNode, renderer));
+                const auto [it, success] = m_entities.insert(std::make_pair(entityNode, renderer));
+                if (!success) {
+                    m_entityModelManager.releaseRenderer(it->second);
+                    it->second = renderer;
+                }
             }
         }
 
@@ -69,7 +81,7 @@ namespace TrenchBroom {
                 return entityNode->entity().modelSpecification();
             });
 
-            auto* renderer = m_entityModelManager.renderer(modelSpec);
+            auto* renderer = m_entityModelManager.acquireRenderer(modelSpec);
             EntityMap::iterator it = m_entities.find(entityNode);
 
             if (renderer == nullptr && it == std::end(m_entities)) {
@@ -79,15 +91,19 @@ namespace TrenchBroom {
             if (it == std::end(m_entities)) {
                 m_entities.insert(std::make_pair(entityNode, renderer));
             } else {
+                m_entityModelManager.releaseRenderer(it->second);
                 if (renderer == nullptr) {
                     m_entities.erase(it);
-                } else if (it->second != renderer) {
+                } else {
                     it->second = renderer;
                 }
             }
         }
 
         void EntityModelRenderer::clear() {
+            for (const auto& [entityNode, renderer] : m_entities) {
+                m_entityModelManager.releaseRenderer(renderer);
+            }
             m_entities.clear();
         }
 
@@ -115,6 +131,66 @@ namespace TrenchBroom {
             m_showHiddenEntities = showHiddenEntities;
         }
 
+        namespace {
+            using EntityInstance = std::pair<TexturedRenderer*, const Model::EntityNode*>;
+            using EntityInstanceIterator = std::vector<EntityInstance>::const_iterator;
+
+            /**
+             * Sets the transformation of each entity in a range of entities that share the same renderer.
+             */
+            class EntityInstanceRenderFunc : public InstanceRenderFunc {
+            private:
+                Transformation& m_transformation;
+                ActiveShader& m_shader;
+                EntityInstanceIterator m_begin;
+            public:
+                EntityInstanceRenderFunc(Transformation& transformation, ActiveShader& shader, EntityInstanceIterator begin) :
+                m_transformation(transformation),
+                m_shader(shader),
+                m_begin(begin) {}
+
+                void before(const size_t index) override {
+                    const auto* entityNode = std::next(m_begin, static_cast<std::ptrdiff_t>(index))->second;
+                    const auto transformation = vm::mat4x4f(entityNode->entity().modelTransformation());
+
+                    m_transformation.pushModelMatrix(transformation);
+                    m_shader.set("ModelMatrix", transformation);
+                }
+
+                void after(const size_t /* index */) override {
+                    m_transformation.popModelMatrix();
+                }
+            };
+
+            /**
+             * Binds the textures of the entity models. If the upload of a texture was deferred, the models using it
+             * are rendered with the texture's average color instead.
+             */
+            class EntityTextureRenderFunc : public TextureRenderFunc {
+            private:
+                ActiveShader& m_shader;
+            public:
+                explicit EntityTextureRenderFunc(ActiveShader& shader) :
+                m_shader(shader) {}
+
+                void before(const Assets::Texture* texture) override {
+                    if (texture != nullptr) {
+                        const auto active = texture->activate();
+                        m_shader.set("ApplyTexture", active);
+                        m_shader.set("Color", texture->averageColor());
+                    } else {
+                        m_shader.set("ApplyTexture", false);
+                    }
+                }
+
+                void after(const Assets::Texture* texture) override {
+                    if (texture != nullptr) {
+                        texture->deactivate();
+                    }
+                }
+            };
+        }
+
         void EntityModelRenderer::render(RenderBatch& renderBatch) {
             renderBatch.add(this);
         }
@@ -143,17 +219,34 @@ namespace TrenchBroom {
             glAssert(glEnable(GL_TEXTURE_2D));
             glAssert(glActiveTexture(GL_TEXTURE0));
 
+            const auto& camera = renderContext.camera();
+            auto instances = std::vector<EntityInstance>{};
+            instances.reserve(m_entities.size());
             for (const auto& [entityNode, renderer] : m_entities) {
                 if (!m_showHiddenEntities && !m_editorContext.visible(entityNode)) {
                     continue;
                 }
+                if (!camera.intersectsFrustum(vm::bbox3f(entityNode->physicalBounds()))) {
+                    continue;
+                }
+                instances.emplace_back(renderer, entityNode);
+            }
+
+            // entities which share a model are drawn together so that their vertices and textures are set up once
+            std::stable_sort(std::begin(instances), std::end(instances), [](const auto& lhs, const auto& rhs) {
+                return std::less<const TexturedRenderer*>()(lhs.first, rhs.first);
+            });
 
-                const auto transformation = entityNode->entity().modelTransformation();
-                MultiplyModelMatrix multMatrix(renderContext.transformation(), vm::mat4x4f(transformation));
+            auto groupBegin = std::begin(instances);
+            while (groupBegin != std::end(instances)) {
+                auto* renderer = groupBegin->first;
+                const auto groupEnd = std::find_if(groupBegin, std::end(instances), [&](const auto& instance) { return instance.first != renderer; });
 
-                shader.set("ModelMatrix", vm::mat4x4f(transformation));
+                EntityTextureRenderFunc textureFunc(shader);
+                EntityInstanceRenderFunc func(renderContext.transformation(), shader, groupBegin);
+                renderer->renderInstances(static_cast<size_t>(std::distance(groupBegin, groupEnd)), textureFunc, func);
 
-                renderer->render();
+                groupBegin = groupEnd;
             }
         }
     }
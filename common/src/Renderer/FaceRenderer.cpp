@@ -46,8 +46,9 @@ namespace TrenchBroom {
 
             void before(const Assets::Texture* texture) override {
                 if (texture != nullptr) {
-                    texture->activate();
-                    shader.set("ApplyTexture", applyTexture);
+                    // if the texture's upload was deferred, we only render its average color
+                    const auto active = texture->activate();
+                    shader.set("ApplyTexture", applyTexture && active);
                     shader.set("Color", texture->averageColor());
                 } else {
                     shader.set("ApplyTexture", false);
@@ -69,7 +70,15 @@ namespace TrenchBroom {
 
         FaceRenderer::FaceRenderer(std::shared_ptr<BrushVertexArray> vertexArray, std::shared_ptr<TextureToBrushIndicesMap> indexArrayMap, const Color& faceColor) :
         m_vertexArray(std::move(vertexArray)),
-        m_indexArrayMap(std::move(indexArrayMap)),
+        m_indexArrayMaps({std::move(indexArrayMap)}),
+        m_faceColor(faceColor),
+        m_grayscale(false),
+        m_tint(false),
+        m_alpha(1.0f) {}
+
+        FaceRenderer::FaceRenderer(std::shared_ptr<BrushVertexArray> vertexArray, std::vector<std::shared_ptr<TextureToBrushIndicesMap>> indexArrayMaps, const Color& faceColor) :
+        m_vertexArray(std::move(vertexArray)),
+        m_indexArrayMaps(std::move(indexArrayMaps)),
         m_faceColor(faceColor),
         m_grayscale(false),
         m_tint(false),
@@ -78,7 +87,7 @@ namespace TrenchBroom {
         FaceRenderer::FaceRenderer(const FaceRenderer& other) :
         IndexedRenderable(other),
         m_vertexArray(other.m_vertexArray),
-        m_indexArrayMap(other.m_indexArrayMap),
+        m_indexArrayMaps(other.m_indexArrayMaps),
         m_faceColor(other.m_faceColor),
         m_grayscale(other.m_grayscale),
         m_tint(other.m_tint),
@@ -94,7 +103,7 @@ namespace TrenchBroom {
         void swap(FaceRenderer& left, FaceRenderer& right)  {
             using std::swap;
             swap(left.m_vertexArray, right.m_vertexArray);
-            swap(left.m_indexArrayMap, right.m_indexArrayMap);
+            swap(left.m_indexArrayMaps, right.m_indexArrayMaps);
             swap(left.m_faceColor, right.m_faceColor);
             swap(left.m_grayscale, right.m_grayscale);
             swap(left.m_tint, right.m_tint);
@@ -122,16 +131,35 @@ namespace TrenchBroom {
             renderBatch.add(this);
         }
 
+        std::optional<RenderSortKey> FaceRenderer::doGetSortKey() const {
+            // opaque faces are depth tested, and transparent faces keep their relative order after all opaque faces
+            return RenderSortKey{m_alpha < 1.0f, &Shaders::FaceShader};
+        }
+
         void FaceRenderer::prepareVerticesAndIndices(VboManager& vboManager) {
             m_vertexArray->prepare(vboManager);
 
-            for (const auto& [texture, brushIndexHolderPtr] : *m_indexArrayMap) {
-                brushIndexHolderPtr->prepare(vboManager);
+            for (const auto& indexArrayMap : m_indexArrayMaps) {
+                for (const auto& [texture, brushIndexHolderPtr] : *indexArrayMap) {
+                    brushIndexHolderPtr->prepare(vboManager);
+                }
             }
         }
 
         void FaceRenderer::doRender(RenderContext& context) {
-            if (m_indexArrayMap->empty())
+            // collect the index arrays of all maps by texture so that each texture is activated only once; textures
+            // that render like the texture whose image they share are merged with that texture
+            std::unordered_map<const Assets::Texture*, std::vector<BrushIndexArray*>> indexArraysByTexture;
+            for (const auto& indexArrayMap : m_indexArrayMaps) {
+                for (const auto& [texture, brushIndexHolderPtr] : *indexArrayMap) {
+                    if (brushIndexHolderPtr->hasValidIndices()) {
+                        const auto* renderTexture = texture != nullptr ? texture->renderTexture() : nullptr;
+                        indexArraysByTexture[renderTexture].push_back(brushIndexHolderPtr.get());
+                    }
+                }
+            }
+
+            if (indexArraysByTexture.empty())
                 return;
 
             if (m_vertexArray->setupVertices()) {
@@ -172,11 +200,7 @@ namespace TrenchBroom {
                 if (m_alpha < 1.0f) {
                     glAssert(glDepthMask(GL_FALSE));
                 }
-                for (const auto& [texture, brushIndexHolderPtr] : *m_indexArrayMap) {
-                    if (!brushIndexHolderPtr->hasValidIndices()) {
-                        continue;
-                    }
-
+                for (const auto& [texture, indexArrays] : indexArraysByTexture) {
                     const bool enableMasked = texture != nullptr && texture->masked();
                     
                     // set any per-texture uniforms
@@ -184,9 +208,11 @@ namespace TrenchBroom {
                     shader.set("EnableMasked", enableMasked);
 
                     func.before(texture);
-                    brushIndexHolderPtr->setupIndices();
-                    brushIndexHolderPtr->render(PrimType::Triangles);
-                    brushIndexHolderPtr->cleanupIndices();
+                    for (auto* indexArray : indexArrays) {
+                        indexArray->setupIndices();
+                        indexArray->render(PrimType::Triangles);
+                        indexArray->cleanupIndices();
+                    }
                     func.after(texture);
                 }
                 if (m_alpha < 1.0f) {
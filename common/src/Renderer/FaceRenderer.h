@@ -26,7 +26,9 @@
 #include <vecmath/vec.h>
 
 #include <memory>
+#include <optional>
 #include <unordered_map>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Assets {
@@ -38,6 +40,12 @@ namespace TrenchBroom {
         class BrushVertexArray;
         class RenderBatch;
 
+        /**
+         * Renders the faces given by one or more maps of index arrays that all refer to the same vertex array.
+         *
+         * The faces of all maps are rendered texture by texture, so each texture is bound only once per render call
+         * regardless of how many maps contain faces with that texture.
+         */
         class FaceRenderer : public IndexedRenderable {
         private:
             struct RenderFunc;
@@ -45,7 +53,7 @@ namespace TrenchBroom {
             using TextureToBrushIndicesMap = const std::unordered_map<const Assets::Texture*, std::shared_ptr<BrushIndexArray>>;
 
             std::shared_ptr<BrushVertexArray> m_vertexArray;
-            std::shared_ptr<TextureToBrushIndicesMap> m_indexArrayMap;
+            std::vector<std::shared_ptr<TextureToBrushIndicesMap>> m_indexArrayMaps;
             Color m_faceColor;
             bool m_grayscale;
             bool m_tint;
@@ -54,6 +62,7 @@ namespace TrenchBroom {
         public:
             FaceRenderer();
             FaceRenderer(std::shared_ptr<BrushVertexArray> vertexArray, std::shared_ptr<TextureToBrushIndicesMap> indexArrayMap, const Color& faceColor);
+            FaceRenderer(std::shared_ptr<BrushVertexArray> vertexArray, std::vector<std::shared_ptr<TextureToBrushIndicesMap>> indexArrayMaps, const Color& faceColor);
 
             FaceRenderer(const FaceRenderer& other);
             FaceRenderer& operator=(FaceRenderer other);
@@ -68,6 +77,7 @@ namespace TrenchBroom {
         private:
             void prepareVerticesAndIndices(VboManager& vboManager) override;
             void doRender(RenderContext& context) override;
+            std::optional<RenderSortKey> doGetSortKey() const override;
         };
 
         void swap(FaceRenderer& left, FaceRenderer& right);
@@ -31,7 +31,10 @@ namespace TrenchBroom {
 
         FontManager::~FontManager() = default;
 
+        static const size_t MaxCachedFontSizes = 4096u;
+
         void FontManager::clearCache() {
+            m_fontSizeCache.clear();
             m_cache.clear();
         }
 
@@ -45,12 +48,23 @@ namespace TrenchBroom {
         }
 
         FontDescriptor FontManager::selectFontSize(const FontDescriptor& fontDescriptor, const std::string& string, const float maxWidth, const size_t minFontSize) {
+            auto key = FontSizeKey{fontDescriptor, string, maxWidth, minFontSize};
+            if (const auto it = m_fontSizeCache.find(key); it != std::end(m_fontSizeCache)) {
+                return it->second;
+            }
+
+            if (m_fontSizeCache.size() >= MaxCachedFontSizes) {
+                m_fontSizeCache.clear();
+            }
+
             FontDescriptor actualDescriptor = fontDescriptor;
             vm::vec2f actualBounds = font(actualDescriptor).measure(string);
             while (actualBounds.x() > maxWidth && actualDescriptor.size() > minFontSize) {
                 actualDescriptor = FontDescriptor(actualDescriptor.path(), actualDescriptor.size() - 1);
                 actualBounds = font(actualDescriptor).measure(string);
             }
+
+            m_fontSizeCache.emplace(std::move(key), actualDescriptor);
             return actualDescriptor;
         }
     }
@@ -24,6 +24,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <tuple>
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -35,11 +36,18 @@ namespace TrenchBroom {
         private:
             std::unique_ptr<FontFactory> m_factory;
             std::map<FontDescriptor, std::unique_ptr<TextureFont>> m_cache;
+
+            using FontSizeKey = std::tuple<FontDescriptor, std::string, float, size_t>;
+            std::map<FontSizeKey, FontDescriptor> m_fontSizeCache;
         public:
             FontManager();
             ~FontManager();
 
             TextureFont& font(const FontDescriptor& fontDescriptor);
+            /**
+             * Returns a descriptor for the largest font size not smaller than the given minimum size such that the
+             * given string fits into the given width. The results are cached until the cache is cleared.
+             */
             FontDescriptor selectFontSize(const FontDescriptor& fontDescriptor, const std::string& string, float maxWidth, size_t minFontSize);
             void clearCache();
 
@@ -22,13 +22,16 @@
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
-#include "IO/Reader.h"
 #include "Renderer/FontFactory.h"
 
 #include <memory>
 #include <utility>
 
 namespace TrenchBroom {
+    namespace IO {
+        class File;
+    }
+
     namespace Renderer {
         class FontDescriptor;
         class TextureFont;
@@ -42,7 +45,7 @@ namespace TrenchBroom {
         private:
             std::unique_ptr<TextureFont> doCreateFont(const FontDescriptor& fontDescriptor) override;
 
-            std::pair<FT_Face, IO::BufferedReader> loadFont(const FontDescriptor& fontDescriptor);
+            std::pair<FT_Face, std::shared_ptr<IO::File>> loadFont(const FontDescriptor& fontDescriptor);
             std::unique_ptr<TextureFont> buildFont(FT_Face face, unsigned char firstChar, unsigned char charCount);
 
             Metrics computeMetrics(FT_Face face, unsigned char firstChar, unsigned char charCount) const;
@@ -26,6 +26,9 @@
 
 #include <vecmath/vec.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace TrenchBroom {
     namespace Renderer {
         /**
@@ -120,6 +123,55 @@ namespace TrenchBroom {
             deleteCopyAndMove(GLVertexAttributeNormal)
         };
 
+        /**
+         * Vertex normal attribute type that stores each component as a signed byte, which OpenGL maps back to
+         * [-1..1] when the normal array is read. The fourth byte is unused and keeps the following attributes aligned.
+         *
+         * Normals stored this way take up 4 instead of 12 bytes per vertex. The precision is sufficient for lighting
+         * flat faces, but not for computations that require exact normals.
+         */
+        class GLVertexAttributePackedNormal {
+        public:
+            using ComponentType = GLbyte;
+            using ElementType = vm::vec<ComponentType,4>;
+            static const size_t Size = sizeof(ElementType);
+
+            /**
+             * Quantizes the given unit normal for storage in a vertex.
+             */
+            static ElementType pack(const vm::vec3f& normal) {
+                return ElementType(packComponent(normal.x()), packComponent(normal.y()), packComponent(normal.z()), ComponentType(0));
+            }
+
+            /**
+             * Returns the normal that OpenGL will see for the given packed normal.
+             */
+            static vm::vec3f unpack(const ElementType& packed) {
+                return vm::vec3f(unpackComponent(packed[0]), unpackComponent(packed[1]), unpackComponent(packed[2]));
+            }
+
+            static void setup(ShaderProgram* /* program */, const size_t /* index */, const size_t stride, const size_t offset) {
+                glAssert(glEnableClientState(GL_NORMAL_ARRAY))
+                glAssert(glNormalPointer(GL_BYTE, static_cast<GLsizei>(stride), reinterpret_cast<GLvoid*>(offset)))
+            }
+
+            static void cleanup(ShaderProgram* /* program */, const size_t /* index */) {
+                glAssert(glDisableClientState(GL_NORMAL_ARRAY))
+            }
+
+            // Non-instantiable
+            GLVertexAttributePackedNormal() = delete;
+            deleteCopyAndMove(GLVertexAttributePackedNormal)
+        private:
+            static ComponentType packComponent(const float c) {
+                return static_cast<ComponentType>(std::round(std::clamp(c, -1.0f, 1.0f) * 127.0f));
+            }
+
+            static float unpackComponent(const ComponentType c) {
+                return std::max(static_cast<float>(c) / 127.0f, -1.0f);
+            }
+        };
+
         /**
          * Vertex color attribute types.
          *
@@ -180,6 +232,7 @@ namespace TrenchBroom {
             using P2  = GLVertexAttributePosition<GL_FLOAT, 2>;
             using P3  = GLVertexAttributePosition<GL_FLOAT, 3>;
             using N   = GLVertexAttributeNormal<GL_FLOAT, 3>;
+            using NP  = GLVertexAttributePackedNormal;
             using T02 = GLVertexAttributeTexCoord0<GL_FLOAT, 2>;
             using C4  = GLVertexAttributeColor<GL_FLOAT, 4>;
         }
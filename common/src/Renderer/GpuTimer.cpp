@@ -0,0 +1,115 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "GpuTimer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        GpuTimer::GpuTimer() = default;
+
+        GpuTimer::~GpuTimer() {
+            if (!m_allQueries.empty()) {
+                glAssert(glDeleteQueries(static_cast<GLsizei>(m_allQueries.size()), m_allQueries.data()));
+            }
+        }
+
+        bool GpuTimer::available() {
+            return GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+        }
+
+        void GpuTimer::beginFrame() {
+            if (!m_pendingFrame.empty() && collect(m_pendingFrame)) {
+                recycle(m_pendingFrame);
+            }
+
+            if (!m_currentFrame.empty()) {
+                if (m_pendingFrame.empty()) {
+                    std::swap(m_pendingFrame, m_currentFrame);
+                } else {
+                    recycle(m_currentFrame);
+                }
+            }
+        }
+
+        void GpuTimer::timestamp(const char* section) {
+            if (!available()) {
+                return;
+            }
+
+            if (m_unusedQueries.empty()) {
+                GLuint query;
+                glAssert(glGenQueries(1, &query));
+                m_allQueries.push_back(query);
+                m_unusedQueries.push_back(query);
+            }
+
+            const auto query = m_unusedQueries.back();
+            m_unusedQueries.pop_back();
+
+            glAssert(glQueryCounter(query, GL_TIMESTAMP));
+            m_currentFrame.push_back(Timestamp{section, query});
+        }
+
+        const std::vector<std::pair<std::string, double>>& GpuTimer::sectionMilliseconds() const {
+            return m_sectionMilliseconds;
+        }
+
+        bool GpuTimer::collect(const std::vector<Timestamp>& frame) {
+            // the queries are completed in order, so all results are available once the last one is
+            GLint available = 0;
+            glAssert(glGetQueryObjectiv(frame.back().query, GL_QUERY_RESULT_AVAILABLE, &available));
+            if (!available) {
+                return false;
+            }
+
+            auto times = std::vector<GLuint64>(frame.size());
+            for (size_t i = 0; i < frame.size(); ++i) {
+                glAssert(glGetQueryObjectui64v(frame[i].query, GL_QUERY_RESULT, &times[i]));
+            }
+
+            m_sectionMilliseconds.clear();
+            for (size_t i = 0; i + 1 < frame.size(); ++i) {
+                if (const auto* section = frame[i].section) {
+                    const auto milliseconds = static_cast<double>(times[i + 1] - times[i]) / 1000000.0;
+                    const auto it = std::find_if(std::begin(m_sectionMilliseconds), std::end(m_sectionMilliseconds), [&](const auto& entry) {
+                        return std::strcmp(entry.first.c_str(), section) == 0;
+                    });
+                    if (it != std::end(m_sectionMilliseconds)) {
+                        it->second += milliseconds;
+                    } else {
+                        m_sectionMilliseconds.emplace_back(section, milliseconds);
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        void GpuTimer::recycle(std::vector<Timestamp>& frame) {
+            for (const auto& timestamp : frame) {
+                m_unusedQueries.push_back(timestamp.query);
+            }
+            frame.clear();
+        }
+    }
+}
@@ -0,0 +1,84 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Macros.h"
+#include "Renderer/GL.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        /**
+         * Measures how long the GPU spends on the sections of a frame using timestamp queries.
+         *
+         * A section starts at a timestamp and ends at the next timestamp of the same frame. The durations of
+         * sections with the same name are summed up. The query results are read back one frame later, and only
+         * if they are available by then, so that measuring never stalls the pipeline. If the GPU lags behind
+         * further, the results of the current frame are dropped.
+         *
+         * Query objects cannot be shared between OpenGL contexts, so every view needs its own timer. Timestamp
+         * queries require OpenGL 3.3 or ARB_timer_query, otherwise a timer does nothing.
+         */
+        class GpuTimer {
+        private:
+            struct Timestamp {
+                const char* section;
+                GLuint query;
+            };
+
+            std::vector<GLuint> m_allQueries;
+            std::vector<GLuint> m_unusedQueries;
+            std::vector<Timestamp> m_currentFrame;
+            std::vector<Timestamp> m_pendingFrame;
+            std::vector<std::pair<std::string, double>> m_sectionMilliseconds;
+        public:
+            GpuTimer();
+            ~GpuTimer();
+
+            static bool available();
+
+            /**
+             * Collects the results of the previous frame if they are available. Must be called with the OpenGL
+             * context of the view being current.
+             */
+            void beginFrame();
+
+            /**
+             * Records a timestamp that starts the section with the given name. The name is not copied and must
+             * therefore be a string literal. Pass nullptr to end the previous section without starting a new one.
+             */
+            void timestamp(const char* section);
+
+            /**
+             * Returns the GPU time spent per section in the last frame whose results were collected.
+             */
+            const std::vector<std::pair<std::string, double>>& sectionMilliseconds() const;
+        private:
+            bool collect(const std::vector<Timestamp>& frame);
+            void recycle(std::vector<Timestamp>& frame);
+
+            deleteCopyAndMove(GpuTimer)
+        };
+    }
+}
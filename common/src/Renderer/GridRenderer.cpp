@@ -32,38 +32,69 @@
 #include <vecmath/bbox.h>
 #include <vecmath/vec.h>
 
+#include <algorithm>
+
 namespace TrenchBroom {
     namespace Renderer {
         GridRenderer::GridRenderer(const OrthographicCamera& camera, const vm::bbox3& worldBounds) :
-        m_vertexArray(VertexArray::move(vertices(camera, worldBounds))) {}
+        m_worldBounds(worldBounds),
+        m_extent(extent(camera, worldBounds)),
+        m_vertexArray(VertexArray::move(vertices(camera, worldBounds, m_extent))) {}
+
+        bool GridRenderer::canRender(const OrthographicCamera& camera, const vm::bbox3& worldBounds) const {
+            if (worldBounds != m_worldBounds) {
+                return false;
+            }
+
+            // the quad is infinitely thin along the view axis, so only the other axes are checked
+            const auto area = visibleArea(camera);
+            const auto axis = vm::find_abs_max_component(camera.direction());
+            for (size_t i = 0; i < 3; ++i) {
+                if (i != axis && (area.min[i] < m_extent.min[i] || area.max[i] > m_extent.max[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
 
-        std::vector<GridRenderer::Vertex> GridRenderer::vertices(const OrthographicCamera& camera, const vm::bbox3& worldBounds) {
+        vm::bbox3f GridRenderer::visibleArea(const OrthographicCamera& camera) {
             const auto& viewport = camera.zoomedViewport();
-            const auto w = float(viewport.width) / 2.0f;
-            const auto h = float(viewport.height) / 2.0f;
+            const auto halfSize = std::max(float(viewport.width), float(viewport.height)) / 2.0f;
+            return vm::bbox3f(camera.position() - vm::vec3f::fill(halfSize), camera.position() + vm::vec3f::fill(halfSize));
+        }
+
+        vm::bbox3f GridRenderer::extent(const OrthographicCamera& camera, const vm::bbox3& worldBounds) {
+            // the camera is usually moved around within the world bounds, so the quad extends well beyond them, but
+            // it must always cover the visible area
+            const auto expandedWorldBounds = vm::bbox3f(worldBounds.expand(vm::get_max_component(worldBounds.size())));
+            return vm::merge(expandedWorldBounds, visibleArea(camera).expand(vm::get_max_component(visibleArea(camera).size())));
+        }
+
+        std::vector<GridRenderer::Vertex> GridRenderer::vertices(const OrthographicCamera& camera, const vm::bbox3& worldBounds, const vm::bbox3f& extent) {
+            const auto& min = extent.min;
+            const auto& max = extent.max;
 
-            const auto& p = camera.position();
             switch (vm::find_abs_max_component(camera.direction())) {
                 case vm::axis::x:
                     return {
-                        Vertex(vm::vec3f(float(worldBounds.min.x()), p.y() - w, p.z() - h)),
-                        Vertex(vm::vec3f(float(worldBounds.min.x()), p.y() - w, p.z() + h)),
-                        Vertex(vm::vec3f(float(worldBounds.min.x()), p.y() + w, p.z() + h)),
-                        Vertex(vm::vec3f(float(worldBounds.min.x()), p.y() + w, p.z() - h))
+                        Vertex(vm::vec3f(float(worldBounds.min.x()), min.y(), min.z())),
+                        Vertex(vm::vec3f(float(worldBounds.min.x()), min.y(), max.z())),
+                        Vertex(vm::vec3f(float(worldBounds.min.x()), max.y(), max.z())),
+                        Vertex(vm::vec3f(float(worldBounds.min.x()), max.y(), min.z()))
                     };
                 case vm::axis::y:
                     return {
-                        Vertex(vm::vec3f(p.x() - w, float(worldBounds.max.y()), p.z() - h)),
-                        Vertex(vm::vec3f(p.x() - w, float(worldBounds.max.y()), p.z() + h)),
-                        Vertex(vm::vec3f(p.x() + w, float(worldBounds.max.y()), p.z() + h)),
-                        Vertex(vm::vec3f(p.x() + w, float(worldBounds.max.y()), p.z() - h))
+                        Vertex(vm::vec3f(min.x(), float(worldBounds.max.y()), min.z())),
+                        Vertex(vm::vec3f(min.x(), float(worldBounds.max.y()), max.z())),
+                        Vertex(vm::vec3f(max.x(), float(worldBounds.max.y()), max.z())),
+                        Vertex(vm::vec3f(max.x(), float(worldBounds.max.y()), min.z()))
                     };
                 case vm::axis::z:
                     return {
-                        Vertex(vm::vec3f(p.x() - w, p.y() - h, float(worldBounds.min.z()))),
-                        Vertex(vm::vec3f(p.x() - w, p.y() + h, float(worldBounds.min.z()))),
-                        Vertex(vm::vec3f(p.x() + w, p.y() + h, float(worldBounds.min.z()))),
-                        Vertex(vm::vec3f(p.x() + w, p.y() - h, float(worldBounds.min.z())))
+                        Vertex(vm::vec3f(min.x(), min.y(), float(worldBounds.min.z()))),
+                        Vertex(vm::vec3f(min.x(), max.y(), float(worldBounds.min.z()))),
+                        Vertex(vm::vec3f(max.x(), max.y(), float(worldBounds.min.z()))),
+                        Vertex(vm::vec3f(max.x(), min.y(), float(worldBounds.min.z())))
                     };
                 default:
                     // Should not happen.
@@ -24,6 +24,8 @@
 #include "Renderer/VertexArray.h"
 #include "Renderer/GLVertexType.h"
 
+#include <vecmath/bbox.h>
+
 #include <vector>
 
 namespace TrenchBroom {
@@ -32,14 +34,30 @@ namespace TrenchBroom {
         class RenderContext;
         class VboManager;
 
+        /**
+         * Renders the grid of a 2D view. The grid lines are computed by the fragment shader, so the renderer only
+         * needs a single quad on the plane that the camera looks at. The quad covers an area much larger than the
+         * world bounds, so it rarely depends on the position and zoom of the camera, and the renderer can be kept
+         * until the world bounds change or the camera leaves the quad.
+         */
         class GridRenderer : public DirectRenderable {
         private:
             using Vertex = GLVertexTypes::P3::Vertex;
+            vm::bbox3 m_worldBounds;
+            vm::bbox3f m_extent;
             VertexArray m_vertexArray;
         public:
             GridRenderer(const OrthographicCamera& camera, const vm::bbox3& worldBounds);
+
+            /**
+             * Indicates whether this renderer can still be used to render the grid for the given camera and world
+             * bounds.
+             */
+            bool canRender(const OrthographicCamera& camera, const vm::bbox3& worldBounds) const;
         private:
-            static std::vector<Vertex> vertices(const OrthographicCamera& camera, const vm::bbox3& worldBounds);
+            static vm::bbox3f visibleArea(const OrthographicCamera& camera);
+            static vm::bbox3f extent(const OrthographicCamera& camera, const vm::bbox3& worldBounds);
+            static std::vector<Vertex> vertices(const OrthographicCamera& camera, const vm::bbox3& worldBounds, const vm::bbox3f& extent);
 
             void doPrepareVertices(VboManager& vboManager) override;
             void doRender(RenderContext& renderContext) override;
@@ -22,7 +22,7 @@
 #include "Renderer/PrimType.h"
 #include "Renderer/VertexArray.h"
 
-#include <kdl/vector_utils.h>
+#include <iterator>
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -79,8 +79,8 @@ namespace TrenchBroom {
 
         void IndexRangeMap::IndicesAndCounts::add(const IndicesAndCounts& other, [[maybe_unused]] const bool dynamicGrowth) {
             assert(dynamicGrowth || indices.capacity() >= indices.size() + other.indices.size());
-            indices = kdl::vec_concat(std::move(indices), other.indices);
-            counts = kdl::vec_concat(std::move(counts), other.counts);
+            indices.insert(std::end(indices), std::begin(other.indices), std::end(other.indices));
+            counts.insert(std::end(counts), std::begin(other.counts), std::end(other.counts));
         }
 
         void IndexRangeMap::Size::inc(const PrimType primType, const size_t count) {
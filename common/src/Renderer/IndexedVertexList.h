@@ -68,7 +68,7 @@ namespace TrenchBroom {
 
             void addVertices(const typename T::Vertex::List& vertices) {
                 assert(m_allowDynamicGrowth || vertices.size() <= m_vertices.capacity() - m_vertices.size());
-                m_vertices = kdl::vec_concat(std::move(m_vertices), vertices);
+                m_vertices.insert(std::end(m_vertices), std::begin(vertices), std::end(vertices));
             }
 
             void addPrimitive(const typename T::Vertex::List& vertices) {
@@ -80,9 +80,9 @@ namespace TrenchBroom {
                 assert(m_allowDynamicGrowth || primitives.vertices().size() <= m_vertices.capacity() - m_vertices.size());
                 assert(m_allowDynamicGrowth || primitives.indices().size() <= m_indices.capacity() - m_indices.size());
                 assert(m_allowDynamicGrowth || primitives.counts().size() <= m_counts.capacity() - m_counts.size());
-                m_vertices = kdl::vec_concat(std::move(m_vertices), primitives.vertices());
-                m_indices = kdl::vec_concat(std::move(m_indices), primitives.indices());
-                m_counts = kdl::vec_concat(std::move(m_counts), primitives.counts());
+                m_vertices.insert(std::end(m_vertices), std::begin(primitives.vertices()), std::end(primitives.vertices()));
+                m_indices.insert(std::end(m_indices), std::begin(primitives.indices()), std::end(primitives.indices()));
+                m_counts.insert(std::end(m_counts), std::begin(primitives.counts()), std::end(primitives.counts()));
                 m_primStart = m_vertices.size();
             }
 
@@ -37,9 +37,16 @@ namespace TrenchBroom {
         }
 
         void LinkRenderer::invalidate() {
+            invalidateVertices();
+            doInvalidate();
+        }
+
+        void LinkRenderer::invalidateVertices() {
             m_valid = false;
         }
 
+        void LinkRenderer::doInvalidate() {}
+
         void LinkRenderer::doPrepareVertices(VboManager& vboManager) {
             if (!m_valid) {
                 validate();
@@ -56,6 +56,12 @@ namespace TrenchBroom {
 
             void render(RenderContext& renderContext, RenderBatch& renderBatch);
             void invalidate();
+        protected:
+            /**
+             * Causes the vertex arrays to be rebuilt from getLinks() on the next render, but unlike invalidate(), does
+             * not notify subclasses, which can thus keep any cached link data.
+             */
+            void invalidateVertices();
         private:
             void doPrepareVertices(VboManager& vboManager) override;
             void doRender(RenderContext& renderContext) override;
@@ -65,6 +71,7 @@ namespace TrenchBroom {
 
             void validate();
 
+            virtual void doInvalidate();
             virtual std::vector<LinkRenderer::LineVertex> getLinks() = 0;
 
             deleteCopy(LinkRenderer)
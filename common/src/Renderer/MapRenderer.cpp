@@ -21,6 +21,7 @@
 
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Profiler.h"
 #include "Assets/EntityDefinitionManager.h"
 #include "Model/Brush.h"
 #include "Model/BrushNode.h"
@@ -29,16 +30,19 @@
 #include "Model/EntityNode.h"
 #include "Model/GroupNode.h"
 #include "Model/LayerNode.h"
+#include "Model/ModelUtils.h"
 #include "Model/Node.h"
 #include "Model/PatchNode.h"
 #include "Model/WorldNode.h"
 #include "Renderer/BrushRenderer.h"
 #include "Renderer/EntityLinkRenderer.h"
+#include "Renderer/GpuTimer.h"
 #include "Renderer/GroupLinkRenderer.h"
 #include "Renderer/ObjectRenderer.h"
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
 #include "Renderer/RenderUtils.h"
+#include "Renderer/Transformation.h"
 #include "View/Selection.h"
 #include "View/MapDocument.h"
 
@@ -46,6 +50,9 @@
 #include <kdl/overload.h>
 #include <kdl/vector_set.h>
 
+#include <vecmath/mat.h>
+
+#include <algorithm>
 #include <set>
 #include <vector>
 
@@ -110,7 +117,7 @@ namespace TrenchBroom {
                 
                 bool anyFaceVisible = false;
                 for (const Model::BrushFace& face : brush.faces()) {
-                    const bool faceVisible = !selected(brushNode, face) && visible(brushNode, face);
+                    const bool faceVisible = !selected(brushNode, face) && brushVisible && faceVisible(face);
                     face.setMarked(faceVisible);
                     anyFaceVisible |= faceVisible;
                 }
@@ -129,11 +136,10 @@ namespace TrenchBroom {
 
         MapRenderer::MapRenderer(std::weak_ptr<View::MapDocument> document) :
         m_document(document),
-        m_defaultRenderer(createDefaultRenderer(m_document)),
         m_selectionRenderer(createSelectionRenderer(m_document)),
-        m_lockedRenderer(createLockRenderer(m_document)),
         m_entityLinkRenderer(std::make_unique<EntityLinkRenderer>(m_document)),
-        m_groupLinkRenderer(std::make_unique<GroupLinkRenderer>(m_document)) {
+        m_groupLinkRenderer(std::make_unique<GroupLinkRenderer>(m_document)),
+        m_pendingRendererUpdates(0) {
             connectObservers();
             setupRenderers();
         }
@@ -166,10 +172,34 @@ namespace TrenchBroom {
                 LockedBrushRendererFilter(kdl::mem_lock(document)->editorContext()));
         }
 
+        ObjectRenderer& MapRenderer::defaultRenderer(const Model::LayerNode* layer) {
+            auto& renderer = m_defaultRenderers[layer];
+            if (renderer == nullptr) {
+                renderer = createDefaultRenderer(m_document);
+                setupDefaultRenderer(*renderer);
+            }
+            return *renderer;
+        }
+
+        ObjectRenderer& MapRenderer::lockedRenderer(const Model::LayerNode* layer) {
+            auto& renderer = m_lockedRenderers[layer];
+            if (renderer == nullptr) {
+                renderer = createLockRenderer(m_document);
+                setupLockedRenderer(*renderer);
+            }
+            return *renderer;
+        }
+
         void MapRenderer::clear() {
-            m_defaultRenderer->clear();
+            m_pendingRendererUpdates = 0;
+            m_pendingLayerUpdates.clear();
+            for (auto& [layer, renderer] : m_defaultRenderers) {
+                renderer->clear();
+            }
             m_selectionRenderer->clear();
-            m_lockedRenderer->clear();
+            for (auto& [layer, renderer] : m_lockedRenderers) {
+                renderer->clear();
+            }
             m_entityLinkRenderer->invalidate();
             m_groupLinkRenderer->invalidate();
         }
@@ -190,21 +220,34 @@ namespace TrenchBroom {
         }
 
         void MapRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch) {
+            TB_PROFILE_SCOPE("MapRenderer::render");
             commitPendingChanges();
             setupGL(renderBatch);
+
+            // the durations of the opaque and transparent passes are summed up per renderer
+            timestamp(renderContext, renderBatch, "default");
             renderDefaultOpaque(renderContext, renderBatch);
+            timestamp(renderContext, renderBatch, "locked");
             renderLockedOpaque(renderContext, renderBatch);
+            timestamp(renderContext, renderBatch, "selection");
             renderSelectionOpaque(renderContext, renderBatch);
 
+            timestamp(renderContext, renderBatch, "default");
             renderDefaultTransparent(renderContext, renderBatch);
+            timestamp(renderContext, renderBatch, "locked");
             renderLockedTransparent(renderContext, renderBatch);
+            timestamp(renderContext, renderBatch, "selection");
             renderSelectionTransparent(renderContext, renderBatch);
 
+            timestamp(renderContext, renderBatch, "links");
             renderEntityLinks(renderContext, renderBatch);
             renderGroupLinks(renderContext, renderBatch);
+            timestamp(renderContext, renderBatch, nullptr);
         }
 
         void MapRenderer::commitPendingChanges() {
+            updatePendingRenderers();
+
             auto document = kdl::mem_lock(m_document);
             document->commitPendingAssets();
         }
@@ -225,35 +268,98 @@ namespace TrenchBroom {
         }
 
         void MapRenderer::renderDefaultOpaque(RenderContext& renderContext, RenderBatch& renderBatch) {
-            m_defaultRenderer->setShowOverlays(renderContext.render3D());
-            m_defaultRenderer->renderOpaque(renderContext, renderBatch);
+            for (auto& [layer, renderer] : m_defaultRenderers) {
+                renderer->setShowOverlays(renderContext.render3D());
+                renderer->renderOpaque(renderContext, renderBatch);
+            }
         }
 
         void MapRenderer::renderDefaultTransparent(RenderContext& renderContext, RenderBatch& renderBatch) {
-            m_defaultRenderer->setShowOverlays(renderContext.render3D());
-            m_defaultRenderer->renderTransparent(renderContext, renderBatch);
+            for (auto& [layer, renderer] : m_defaultRenderers) {
+                renderer->setShowOverlays(renderContext.render3D());
+                renderer->renderTransparent(renderContext, renderBatch);
+            }
+        }
+
+        class GpuTimestamp : public Renderable {
+        private:
+            GpuTimer& m_timer;
+            const char* m_section;
+        public:
+            GpuTimestamp(GpuTimer& timer, const char* section) :
+            m_timer(timer),
+            m_section(section) {}
+        private:
+            void doRender(RenderContext&) override {
+                m_timer.timestamp(m_section);
+            }
+        };
+
+        void MapRenderer::timestamp(RenderContext& renderContext, RenderBatch& renderBatch, const char* section) {
+            if (auto* gpuTimer = renderContext.gpuTimer()) {
+                renderBatch.addOneShot(new GpuTimestamp(*gpuTimer, section));
+            }
+        }
+
+        class PushModelMatrix : public Renderable {
+        private:
+            vm::mat4x4f m_matrix;
+        public:
+            explicit PushModelMatrix(const vm::mat4x4f& matrix) :
+            m_matrix(matrix) {}
+        private:
+            void doRender(RenderContext& renderContext) override {
+                renderContext.transformation().pushModelMatrix(m_matrix);
+            }
+        };
+
+        class PopModelMatrix : public Renderable {
+        private:
+            void doRender(RenderContext& renderContext) override {
+                renderContext.transformation().popModelMatrix();
+            }
+        };
+
+        template <typename F>
+        void MapRenderer::renderWithSelectionPreviewTransformation(RenderBatch& renderBatch, const F& render) {
+            auto document = kdl::mem_lock(m_document);
+            if (const auto& transformation = document->selectionPreviewTransformation()) {
+                renderBatch.addOneShot(new PushModelMatrix(vm::mat4x4f(*transformation)));
+                render();
+                renderBatch.addOneShot(new PopModelMatrix());
+            } else {
+                render();
+            }
         }
 
         void MapRenderer::renderSelectionOpaque(RenderContext& renderContext, RenderBatch& renderBatch) {
             if (!renderContext.hideSelection()) {
-                m_selectionRenderer->renderOpaque(renderContext, renderBatch);
+                renderWithSelectionPreviewTransformation(renderBatch, [&]() {
+                    m_selectionRenderer->renderOpaque(renderContext, renderBatch);
+                });
             }
         }
 
         void MapRenderer::renderSelectionTransparent(RenderContext& renderContext, RenderBatch& renderBatch) {
             if (!renderContext.hideSelection()) {
-                m_selectionRenderer->renderTransparent(renderContext, renderBatch);
+                renderWithSelectionPreviewTransformation(renderBatch, [&]() {
+                    m_selectionRenderer->renderTransparent(renderContext, renderBatch);
+                });
             }
         }
 
         void MapRenderer::renderLockedOpaque(RenderContext& renderContext, RenderBatch& renderBatch) {
-            m_lockedRenderer->setShowOverlays(renderContext.render3D());
-            m_lockedRenderer->renderOpaque(renderContext, renderBatch);
+            for (auto& [layer, renderer] : m_lockedRenderers) {
+                renderer->setShowOverlays(renderContext.render3D());
+                renderer->renderOpaque(renderContext, renderBatch);
+            }
         }
 
         void MapRenderer::renderLockedTransparent(RenderContext& renderContext, RenderBatch& renderBatch) {
-            m_lockedRenderer->setShowOverlays(renderContext.render3D());
-            m_lockedRenderer->renderTransparent(renderContext, renderBatch);
+            for (auto& [layer, renderer] : m_lockedRenderers) {
+                renderer->setShowOverlays(renderContext.render3D());
+                renderer->renderTransparent(renderContext, renderBatch);
+            }
         }
 
         void MapRenderer::renderEntityLinks(RenderContext& renderContext, RenderBatch& renderBatch) {
@@ -265,9 +371,13 @@ namespace TrenchBroom {
         }
 
         void MapRenderer::setupRenderers() {
-            setupDefaultRenderer(*m_defaultRenderer);
+            for (auto& [layer, renderer] : m_defaultRenderers) {
+                setupDefaultRenderer(*renderer);
+            }
             setupSelectionRenderer(*m_selectionRenderer);
-            setupLockedRenderer(*m_lockedRenderer);
+            for (auto& [layer, renderer] : m_lockedRenderers) {
+                setupLockedRenderer(*renderer);
+            }
         }
 
         void MapRenderer::setupDefaultRenderer(ObjectRenderer& renderer) {
@@ -282,6 +392,8 @@ namespace TrenchBroom {
 
             renderer.setBrushFaceColor(pref(Preferences::FaceColor));
             renderer.setBrushEdgeColor(pref(Preferences::EdgeColor));
+
+            renderer.setOcclusionCulling(pref(Preferences::OcclusionCulling));
         }
 
         void MapRenderer::setupSelectionRenderer(ObjectRenderer& renderer) {
@@ -326,11 +438,7 @@ namespace TrenchBroom {
             renderer.setBrushEdgeColor(pref(Preferences::LockedEdgeColor));
         }
 
-        void MapRenderer::updateRenderers(const Renderer renderers) {
-            const auto renderDefault   = (renderers & Renderer_Default) != 0;
-            const auto renderSelection = (renderers & Renderer_Selection) != 0;
-            const auto renderLocked    = (renderers & Renderer_Locked) != 0;
-
+        namespace {
             struct RenderableNodes {
                 std::vector<Model::GroupNode*> groups;
                 std::vector<Model::EntityNode*> entities;
@@ -338,99 +446,191 @@ namespace TrenchBroom {
                 std::vector<Model::PatchNode*> patches;
             };
 
-            RenderableNodes defaultNodes;
-            RenderableNodes selectedNodes;
-            RenderableNodes lockedNodes;
-
-            const auto selected = [](const auto* node) {
-                return node->selected() || node->descendantSelected() || node->parentSelected();
-            };
+            void setObjects(ObjectRenderer& renderer, const RenderableNodes& nodes) {
+                renderer.setObjects(nodes.groups, nodes.entities, nodes.brushes, nodes.patches);
+            }
 
-            auto document = kdl::mem_lock(m_document);
-            document->world()->accept(kdl::overload(
-                [](auto&& thisLambda, Model::WorldNode* world) { world->visitChildren(thisLambda); },
-                [](auto&& thisLambda, Model::LayerNode* layer) { layer->visitChildren(thisLambda); },
-                [&](auto&& thisLambda, Model::GroupNode* group) {
-                    if (group->locked()) {
-                        if (renderLocked) lockedNodes.groups.push_back(group);
-                    } else if (selected(group) || group->opened()) {
-                        if (renderSelection) selectedNodes.groups.push_back(group);
-                    } else {
-                        if (renderDefault) defaultNodes.groups.push_back(group);
+            /**
+             * Distributes the nodes of the given layer among the given containers.
+             */
+            void collectRenderableNodes(Model::LayerNode* layerNode, const bool renderDefault, const bool renderSelection, const bool renderLocked, RenderableNodes& defaultNodes, RenderableNodes& selectedNodes, RenderableNodes& lockedNodes) {
+                const auto selected = [](const auto* node) {
+                    return node->selected() || node->descendantSelected() || node->parentSelected();
+                };
+
+                layerNode->accept(kdl::overload(
+                    [](auto&& thisLambda, Model::WorldNode* world) { world->visitChildren(thisLambda); },
+                    [](auto&& thisLambda, Model::LayerNode* layer) { layer->visitChildren(thisLambda); },
+                    [&](auto&& thisLambda, Model::GroupNode* group) {
+                        if (group->locked()) {
+                            if (renderLocked) lockedNodes.groups.push_back(group);
+                        } else if (selected(group) || group->opened()) {
+                            if (renderSelection) selectedNodes.groups.push_back(group);
+                        } else {
+                            if (renderDefault) defaultNodes.groups.push_back(group);
+                        }
+                        group->visitChildren(thisLambda);
+                    },
+                    [&](auto&& thisLambda, Model::EntityNode* entity) {
+                        if (entity->locked()) {
+                            if (renderLocked) lockedNodes.entities.push_back(entity);
+                        } else if (selected(entity)) {
+                            if (renderSelection) selectedNodes.entities.push_back(entity);
+                        } else {
+                            if (renderDefault) defaultNodes.entities.push_back(entity);
+                        }
+                        entity->visitChildren(thisLambda);
+                    },
+                    [&](Model::BrushNode* brush) {
+                        if (brush->locked()) {
+                            if (renderLocked) lockedNodes.brushes.push_back(brush);
+                        } else if (selected(brush) || brush->hasSelectedFaces()) {
+                            if (renderSelection) selectedNodes.brushes.push_back(brush);
+                        }
+                        if (!brush->selected() && !brush->parentSelected() && !brush->locked()) {
+                            if (renderDefault) defaultNodes.brushes.push_back(brush);
+                        }
+                    },
+                    [&](Model::PatchNode* patchNode) {
+                        if (patchNode->locked()) {
+                            if (renderLocked) lockedNodes.patches.push_back(patchNode);
+                        } else if (selected(patchNode)) {
+                            if (renderSelection) selectedNodes.patches.push_back(patchNode);
+                        }
+                        if (!patchNode->selected() && !patchNode->parentSelected() && !patchNode->locked()) {
+                            if (renderDefault) defaultNodes.patches.push_back(patchNode);
+                        }
                     }
-                    group->visitChildren(thisLambda);
-                },
-                [&](auto&& thisLambda, Model::EntityNode* entity) {
-                    if (entity->locked()) {
-                        if (renderLocked) lockedNodes.entities.push_back(entity);
-                    } else if (selected(entity)) {
-                        if (renderSelection) selectedNodes.entities.push_back(entity);
+                ));
+            }
+
+            /**
+             * Clears and removes the renderers of layers that are no longer part of the world.
+             */
+            void removeStaleRenderers(std::map<const Model::LayerNode*, std::unique_ptr<ObjectRenderer>>& renderers, const std::vector<Model::LayerNode*>& layers) {
+                for (auto it = std::begin(renderers); it != std::end(renderers);) {
+                    if (std::find(std::begin(layers), std::end(layers), it->first) == std::end(layers)) {
+                        it->second->clear();
+                        it = renderers.erase(it);
                     } else {
-                        if (renderDefault) defaultNodes.entities.push_back(entity);
-                    }
-                    entity->visitChildren(thisLambda);
-                },
-                [&](Model::BrushNode* brush) {
-                    if (brush->locked()) {
-                        if (renderLocked) lockedNodes.brushes.push_back(brush);
-                    } else if (selected(brush) || brush->hasSelectedFaces()) {
-                        if (renderSelection) selectedNodes.brushes.push_back(brush);
-                    }
-                    if (!brush->selected() && !brush->parentSelected() && !brush->locked()) {
-                        if (renderDefault) defaultNodes.brushes.push_back(brush);
-                    }
-                },
-                [&](Model::PatchNode* patchNode) {
-                    if (patchNode->locked()) {
-                        if (renderLocked) lockedNodes.patches.push_back(patchNode);
-                    } else if (selected(patchNode)) {
-                        if (renderSelection) selectedNodes.patches.push_back(patchNode);
-                    }
-                    if (!patchNode->selected() && !patchNode->parentSelected() && !patchNode->locked()) {
-                        if (renderDefault) defaultNodes.patches.push_back(patchNode);
+                        ++it;
                     }
                 }
-            ));
+            }
+        }
+
+        void MapRenderer::updateRenderers(const Renderer renderers) {
+            const auto renderDefault   = (renderers & Renderer_Default) != 0;
+            const auto renderSelection = (renderers & Renderer_Selection) != 0;
+            const auto renderLocked    = (renderers & Renderer_Locked) != 0;
+
+            auto document = kdl::mem_lock(m_document);
+            const auto layers = document->world()->allLayers();
+
+            RenderableNodes selectedNodes;
+            for (auto* layer : layers) {
+                RenderableNodes defaultNodes;
+                RenderableNodes lockedNodes;
+                collectRenderableNodes(layer, renderDefault, renderSelection, renderLocked, defaultNodes, selectedNodes, lockedNodes);
+
+                if (renderDefault) {
+                    setObjects(defaultRenderer(layer), defaultNodes);
+                }
+                if (renderLocked) {
+                    setObjects(lockedRenderer(layer), lockedNodes);
+                }
+            }
 
             if (renderDefault) {
-                m_defaultRenderer->setObjects(defaultNodes.groups,
-                                              defaultNodes.entities,
-                                              defaultNodes.brushes,
-                                              defaultNodes.patches);
+                removeStaleRenderers(m_defaultRenderers, layers);
             }
             if (renderSelection) {
-                m_selectionRenderer->setObjects(selectedNodes.groups,
-                                                selectedNodes.entities,
-                                                selectedNodes.brushes,
-                                                selectedNodes.patches);
+                setObjects(*m_selectionRenderer, selectedNodes);
             }
             if (renderLocked) {
-                m_lockedRenderer->setObjects(lockedNodes.groups,
-                                             lockedNodes.entities,
-                                             lockedNodes.brushes,
-                                             lockedNodes.patches);
+                removeStaleRenderers(m_lockedRenderers, layers);
             }
             invalidateEntityLinkRenderer();
         }
 
+        void MapRenderer::updateLayerRenderers(const std::set<const Model::LayerNode*>& layersToUpdate) {
+            auto document = kdl::mem_lock(m_document);
+            for (auto* layer : document->world()->allLayers()) {
+                if (layersToUpdate.count(layer) > 0) {
+                    RenderableNodes defaultNodes;
+                    RenderableNodes selectedNodes;
+                    RenderableNodes lockedNodes;
+                    collectRenderableNodes(layer, true, false, true, defaultNodes, selectedNodes, lockedNodes);
+
+                    setObjects(defaultRenderer(layer), defaultNodes);
+                    setObjects(lockedRenderer(layer), lockedNodes);
+                }
+            }
+            invalidateEntityLinkRenderer();
+        }
+
+        void MapRenderer::scheduleUpdateRenderers(const Renderer renderers) {
+            m_pendingRendererUpdates |= renderers;
+        }
+
+        void MapRenderer::updatePendingRenderers() {
+            auto pendingLayerUpdates = std::move(m_pendingLayerUpdates);
+            m_pendingLayerUpdates.clear();
+
+            if (m_pendingRendererUpdates != 0) {
+                const auto renderers = static_cast<Renderer>(m_pendingRendererUpdates);
+                m_pendingRendererUpdates = 0;
+                updateRenderers(renderers);
+
+                if ((renderers & Renderer_Default_Locked) == Renderer_Default_Locked) {
+                    // the layer renderers have been updated already
+                    pendingLayerUpdates.clear();
+                }
+            }
+
+            if (!pendingLayerUpdates.empty()) {
+                updateLayerRenderers(pendingLayerUpdates);
+            }
+        }
+
         void MapRenderer::invalidateRenderers(Renderer renderers) {
-            if ((renderers & Renderer_Default) != 0)
-                m_defaultRenderer->invalidate();
-            if ((renderers & Renderer_Selection) != 0)
+            if ((renderers & Renderer_Default) != 0) {
+                for (auto& [layer, renderer] : m_defaultRenderers) {
+                    renderer->invalidate();
+                }
+            }
+            if ((renderers & Renderer_Selection) != 0) {
                 m_selectionRenderer->invalidate();
-            if ((renderers& Renderer_Locked) != 0)
-                m_lockedRenderer->invalidate();
+            }
+            if ((renderers& Renderer_Locked) != 0) {
+                for (auto& [layer, renderer] : m_lockedRenderers) {
+                    renderer->invalidate();
+                }
+            }
+        }
+
+        void MapRenderer::invalidateLayerRenderers(const Model::LayerNode* layer) {
+            if (const auto it = m_defaultRenderers.find(layer); it != std::end(m_defaultRenderers)) {
+                it->second->invalidate();
+            }
+            if (const auto it = m_lockedRenderers.find(layer); it != std::end(m_lockedRenderers)) {
+                it->second->invalidate();
+            }
         }
 
         void MapRenderer::invalidateBrushesInRenderers(Renderer renderers, const std::vector<Model::BrushNode*>& brushes) {
             if ((renderers & Renderer_Default) != 0) {
-                m_defaultRenderer->invalidateBrushes(brushes);
+                for (auto& [layer, renderer] : m_defaultRenderers) {
+                    renderer->invalidateBrushes(brushes);
+                }
             }
             if ((renderers & Renderer_Selection) != 0) {
                 m_selectionRenderer->invalidateBrushes(brushes);
             }
             if ((renderers& Renderer_Locked) != 0) {
-                m_lockedRenderer->invalidateBrushes(brushes);
+                for (auto& [layer, renderer] : m_lockedRenderers) {
+                    renderer->invalidateBrushes(brushes);
+                }
             }
         }
 
@@ -443,9 +643,13 @@ namespace TrenchBroom {
         }
 
         void MapRenderer::reloadEntityModels() {
-            m_defaultRenderer->reloadModels();
+            for (auto& [layer, renderer] : m_defaultRenderers) {
+                renderer->reloadModels();
+            }
             m_selectionRenderer->reloadModels();
-            m_lockedRenderer->reloadModels();
+            for (auto& [layer, renderer] : m_lockedRenderers) {
+                renderer->reloadModels();
+            }
         }
 
         void MapRenderer::connectObservers() {
@@ -457,7 +661,7 @@ namespace TrenchBroom {
             m_notifierConnection += document->documentWasLoadedNotifier.connect(this, &MapRenderer::documentWasNewedOrLoaded);
             m_notifierConnection += document->nodesWereAddedNotifier.connect(this, &MapRenderer::nodesWereAdded);
             m_notifierConnection += document->nodesWereRemovedNotifier.connect(this, &MapRenderer::nodesWereRemoved);
-            m_notifierConnection += document->nodesDidChangeNotifier.connect(this, &MapRenderer::nodesDidChange);
+            m_notifierConnection += document->coalescedNodesDidChangeNotifier.connect(this, &MapRenderer::nodesDidChange);
             m_notifierConnection += document->nodeVisibilityDidChangeNotifier.connect(this, &MapRenderer::nodeVisibilityDidChange);
             m_notifierConnection += document->nodeLockingDidChangeNotifier.connect(this, &MapRenderer::nodeLockingDidChange);
             m_notifierConnection += document->groupWasOpenedNotifier.connect(this, &MapRenderer::groupWasOpened);
@@ -465,6 +669,7 @@ namespace TrenchBroom {
             m_notifierConnection += document->brushFacesDidChangeNotifier.connect(this, &MapRenderer::brushFacesDidChange);
             m_notifierConnection += document->selectionDidChangeNotifier.connect(this, &MapRenderer::selectionDidChange);
             m_notifierConnection += document->textureCollectionsWillChangeNotifier.connect(this, &MapRenderer::textureCollectionsWillChange);
+            m_notifierConnection += document->textureCollectionsDidLoadNotifier.connect(this, &MapRenderer::textureCollectionsDidLoad);
             m_notifierConnection += document->entityDefinitionsDidChangeNotifier.connect(this, &MapRenderer::entityDefinitionsDidChange);
             m_notifierConnection += document->modsDidChangeNotifier.connect(this, &MapRenderer::modsDidChange);
             m_notifierConnection += document->editorContextDidChangeNotifier.connect(this, &MapRenderer::editorContextDidChange);
@@ -479,40 +684,88 @@ namespace TrenchBroom {
 
         void MapRenderer::documentWasNewedOrLoaded(View::MapDocument*) {
             clear();
-            updateRenderers(Renderer_All);
+            scheduleUpdateRenderers(Renderer_All);
         }
 
         void MapRenderer::nodesWereAdded(const std::vector<Model::Node*>&) {
-            updateRenderers(Renderer_All);
+            scheduleUpdateRenderers(Renderer_All);
             invalidateGroupLinkRenderer();
         }
 
         void MapRenderer::nodesWereRemoved(const std::vector<Model::Node*>&) {
-            updateRenderers(Renderer_All);
+            // removed nodes may be deleted before the next frame, so they must be removed from the renderers now
+            scheduleUpdateRenderers(Renderer_All);
+            updatePendingRenderers();
             invalidateGroupLinkRenderer();
         }
 
-        void MapRenderer::nodesDidChange(const std::vector<Model::Node*>&) {
+        void MapRenderer::nodesDidChange(const std::vector<Model::Node*>& nodes) {
             invalidateRenderers(Renderer_Selection);
-            invalidateEntityLinkRenderer();
-            invalidateGroupLinkRenderer();
+            m_entityLinkRenderer->invalidateNodes(nodes);
+
+            // group links only change if a group or one of its descendants has changed
+            const auto affectsGroups = std::any_of(std::begin(nodes), std::end(nodes), [](const Model::Node* node) {
+                return Model::findContainingGroup(node) != nullptr || node->accept(kdl::overload(
+                    [](const Model::WorldNode*)  { return false; },
+                    [](const Model::LayerNode*)  { return false; },
+                    [](const Model::GroupNode*)  { return true; },
+                    [](const Model::EntityNode*) { return false; },
+                    [](const Model::BrushNode*)  { return false; },
+                    [](const Model::PatchNode*)  { return false; }
+                ));
+            });
+            if (affectsGroups) {
+                invalidateGroupLinkRenderer();
+            }
         }
 
-        void MapRenderer::nodeVisibilityDidChange(const std::vector<Model::Node*>&) {
-            invalidateRenderers(Renderer_All);
+        void MapRenderer::nodeVisibilityDidChange(const std::vector<Model::Node*>& nodes) {
+            // the visibility of a node only affects the renderers of its own layer
+            auto layers = std::set<const Model::LayerNode*>{};
+            for (auto* node : nodes) {
+                if (const auto* layer = Model::findContainingLayer(node)) {
+                    layers.insert(layer);
+                } else {
+                    invalidateRenderers(Renderer_All);
+                    return;
+                }
+            }
+
+            for (const auto* layer : layers) {
+                invalidateLayerRenderers(layer);
+            }
+            invalidateRenderers(Renderer_Selection);
         }
 
-        void MapRenderer::nodeLockingDidChange(const std::vector<Model::Node*>&) {
-            updateRenderers(Renderer_Default_Locked);
+        void MapRenderer::nodeLockingDidChange(const std::vector<Model::Node*>& nodes) {
+            // the lock state of a node only affects the renderers of its own layer
+            for (auto* node : nodes) {
+                if (const auto* layer = Model::findContainingLayer(node)) {
+                    m_pendingLayerUpdates.insert(layer);
+                } else {
+                    scheduleUpdateRenderers(Renderer_Default_Locked);
+                    return;
+                }
+            }
         }
 
-        void MapRenderer::groupWasOpened(Model::GroupNode*) {
-            updateRenderers(Renderer_Default_Selection);
+        void MapRenderer::groupWasOpened(Model::GroupNode* group) {
+            scheduleUpdateRenderers(Renderer_Selection);
+            if (const auto* layer = Model::findContainingLayer(group)) {
+                m_pendingLayerUpdates.insert(layer);
+            } else {
+                scheduleUpdateRenderers(Renderer_Default);
+            }
             invalidateGroupLinkRenderer();
         }
 
-        void MapRenderer::groupWasClosed(Model::GroupNode*) {
-            updateRenderers(Renderer_Default_Selection);
+        void MapRenderer::groupWasClosed(Model::GroupNode* group) {
+            scheduleUpdateRenderers(Renderer_Selection);
+            if (const auto* layer = Model::findContainingLayer(group)) {
+                m_pendingLayerUpdates.insert(layer);
+            } else {
+                scheduleUpdateRenderers(Renderer_Default);
+            }
             invalidateGroupLinkRenderer();
         }
 
@@ -521,7 +774,31 @@ namespace TrenchBroom {
         }
 
         void MapRenderer::selectionDidChange(const View::Selection& selection) {
-            updateRenderers(Renderer_All); // need to update locked objects also because a selected object may have been reparented into a locked layer before deselection
+            // Only the layers containing the affected nodes need to move nodes between their default and locked
+            // renderers. The locked renderers must be updated, too, because a selected object may have been
+            // reparented into a locked layer before deselection.
+            scheduleUpdateRenderers(Renderer_Selection);
+
+            const auto scheduleUpdateLayerRenderers = [&](Model::Node* node) {
+                if (const auto* layer = Model::findContainingLayer(node)) {
+                    m_pendingLayerUpdates.insert(layer);
+                } else {
+                    scheduleUpdateRenderers(Renderer_All);
+                }
+            };
+
+            for (auto* node : selection.selectedNodes()) {
+                scheduleUpdateLayerRenderers(node);
+            }
+            for (auto* node : selection.deselectedNodes()) {
+                scheduleUpdateLayerRenderers(node);
+            }
+            for (const auto& handle : selection.selectedBrushFaces()) {
+                scheduleUpdateLayerRenderers(handle.node());
+            }
+            for (const auto& handle : selection.deselectedBrushFaces()) {
+                scheduleUpdateLayerRenderers(handle.node());
+            }
 
             // selecting faces needs to invalidate the brushes
             if (!selection.selectedBrushFaces().empty()
@@ -541,6 +818,10 @@ namespace TrenchBroom {
             invalidateRenderers(Renderer_All);
         }
 
+        void MapRenderer::textureCollectionsDidLoad() {
+            invalidateRenderers(Renderer_All);
+        }
+
         void MapRenderer::entityDefinitionsDidChange() {
             reloadEntityModels();
             invalidateRenderers(Renderer_All);
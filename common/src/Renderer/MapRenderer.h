@@ -24,6 +24,7 @@
 
 #include <map>
 #include <memory>
+#include <set>
 #include <vector>
 
 namespace TrenchBroom {
@@ -60,16 +61,31 @@ namespace TrenchBroom {
             class LockedBrushRendererFilter;
             class UnselectedBrushRendererFilter;
 
-            using RendererMap = std::map<Model::LayerNode*, ObjectRenderer*>;
+            using LayerRendererMap = std::map<const Model::LayerNode*, std::unique_ptr<ObjectRenderer>>;
 
             std::weak_ptr<View::MapDocument> m_document;
 
-            std::unique_ptr<ObjectRenderer> m_defaultRenderer;
+            /**
+             * The default and locked renderers are kept per layer, so that changing the visibility or the lock state
+             * of the nodes in a layer only updates the renderers of that layer.
+             */
+            LayerRendererMap m_defaultRenderers;
+            LayerRendererMap m_lockedRenderers;
             std::unique_ptr<ObjectRenderer> m_selectionRenderer;
-            std::unique_ptr<ObjectRenderer> m_lockedRenderer;
             std::unique_ptr<EntityLinkRenderer> m_entityLinkRenderer;
             std::unique_ptr<GroupLinkRenderer> m_groupLinkRenderer;
 
+            /**
+             * The renderers whose objects must be updated before the next frame, see scheduleUpdateRenderers().
+             */
+            int m_pendingRendererUpdates;
+
+            /**
+             * The layers whose default and locked renderers must be updated before the next frame. Changes to the
+             * selection or to lock states only affect the layers containing the changed nodes.
+             */
+            std::set<const Model::LayerNode*> m_pendingLayerUpdates;
+
             NotifierConnection m_notifierConnection;
         public:
             explicit MapRenderer(std::weak_ptr<View::MapDocument> document);
@@ -80,6 +96,8 @@ namespace TrenchBroom {
             static std::unique_ptr<ObjectRenderer> createDefaultRenderer(std::weak_ptr<View::MapDocument> document);
             static std::unique_ptr<ObjectRenderer> createSelectionRenderer(std::weak_ptr<View::MapDocument> document);
             static std::unique_ptr<ObjectRenderer> createLockRenderer(std::weak_ptr<View::MapDocument> document);
+            ObjectRenderer& defaultRenderer(const Model::LayerNode* layer);
+            ObjectRenderer& lockedRenderer(const Model::LayerNode* layer);
             void clear();
         public: // color config
             void overrideSelectionColors(const Color& color, float mix);
@@ -89,10 +107,13 @@ namespace TrenchBroom {
         private:
             void commitPendingChanges();
             void setupGL(RenderBatch& renderBatch);
+            void timestamp(RenderContext& renderContext, RenderBatch& renderBatch, const char* section);
             void renderDefaultOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderDefaultTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderSelectionOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderSelectionTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
+            template <typename F>
+            void renderWithSelectionPreviewTransformation(RenderBatch& renderBatch, const F& render);
             void renderLockedOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderLockedTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderEntityLinks(RenderContext& renderContext, RenderBatch& renderBatch);
@@ -119,7 +140,21 @@ namespace TrenchBroom {
              * If brushes are modified, you need to call invalidateRenderers() or invalidateObjectsInRenderers()
              */
             void updateRenderers(Renderer renderers);
+
+            /**
+             * Like updateRenderers(Renderer_Default_Locked), but only updates the renderers of the given layers.
+             */
+            void updateLayerRenderers(const std::set<const Model::LayerNode*>& layers);
+
+            /**
+             * Defers updating the given renderers until the next frame is rendered. This coalesces the updates
+             * requested by several notifications in a row, and all map views showing the next frame share a single
+             * update.
+             */
+            void scheduleUpdateRenderers(Renderer renderers);
+            void updatePendingRenderers();
             void invalidateRenderers(Renderer renderers);
+            void invalidateLayerRenderers(const Model::LayerNode* layer);
             void invalidateBrushesInRenderers(Renderer renderers, const std::vector<Model::BrushNode*>& brushes);
             void invalidateEntityLinkRenderer();
             void invalidateGroupLinkRenderer();
@@ -145,6 +180,7 @@ namespace TrenchBroom {
             void selectionDidChange(const View::Selection& selection);
 
             void textureCollectionsWillChange();
+            void textureCollectionsDidLoad();
             void entityDefinitionsDidChange();
             void modsDidChange();
 
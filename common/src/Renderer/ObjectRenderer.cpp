@@ -147,6 +147,10 @@ namespace TrenchBroom {
             m_brushRenderer.setShowHiddenBrushes(showHiddenObjects);
         }
 
+        void ObjectRenderer::setOcclusionCulling(const bool occlusionCulling) {
+            m_brushRenderer.setOcclusionCulling(occlusionCulling);
+        }
+
         void ObjectRenderer::renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch) {
             m_brushRenderer.renderOpaque(renderContext, renderBatch);
             m_patchRenderer.render(renderContext, renderBatch);
@@ -0,0 +1,75 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "OcclusionQuery.h"
+
+#include <cassert>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        OcclusionQuery::OcclusionQuery() :
+        m_queryId(0),
+        m_pending(false),
+        m_visible(true) {}
+
+        OcclusionQuery::~OcclusionQuery() {
+            assert(m_queryId == 0);
+        }
+
+        void OcclusionQuery::free() {
+            if (m_queryId != 0) {
+                glAssert(glDeleteQueries(1, &m_queryId));
+                m_queryId = 0;
+                m_pending = false;
+            }
+        }
+
+        bool OcclusionQuery::visible() {
+            if (m_pending) {
+                GLuint available = 0;
+                glAssert(glGetQueryObjectuiv(m_queryId, GL_QUERY_RESULT_AVAILABLE, &available));
+                if (available != 0) {
+                    GLuint samples = 0;
+                    glAssert(glGetQueryObjectuiv(m_queryId, GL_QUERY_RESULT, &samples));
+                    m_visible = samples > 0;
+                    m_pending = false;
+                }
+            }
+            return m_visible;
+        }
+
+        bool OcclusionQuery::pending() const {
+            return m_pending;
+        }
+
+        void OcclusionQuery::begin() {
+            assert(!m_pending);
+            if (m_queryId == 0) {
+                glAssert(glGenQueries(1, &m_queryId));
+            }
+            glAssert(glBeginQuery(GL_SAMPLES_PASSED, m_queryId));
+        }
+
+        void OcclusionQuery::end() {
+            glAssert(glEndQuery(GL_SAMPLES_PASSED));
+            m_pending = true;
+        }
+    }
+}
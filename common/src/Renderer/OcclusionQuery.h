@@ -0,0 +1,70 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Macros.h"
+#include "Renderer/GL.h"
+
+namespace TrenchBroom {
+    namespace Renderer {
+        /**
+         * Wrapper around an OpenGL occlusion query that is read back without stalling the pipeline.
+         *
+         * The result of a query is only read once it is available, which is usually the case by the next frame.
+         * Until then, visible() returns the result of the previous query, so that the visibility of an object lags
+         * behind by at least one frame. Objects are considered visible until the first result is available.
+         */
+        class OcclusionQuery {
+        private:
+            GLuint m_queryId;
+            bool m_pending;
+            bool m_visible;
+        public:
+            OcclusionQuery();
+            ~OcclusionQuery();
+
+            /**
+             * Deletes the underlying OpenGL query if it was created. Must be called while an OpenGL context is
+             * current, before the destructor.
+             */
+            void free();
+
+            /**
+             * Returns whether the most recent query whose result is available has passed any samples. Must be called
+             * while an OpenGL context is current.
+             */
+            bool visible();
+
+            /**
+             * Indicates whether a query was issued whose result has not been read back yet.
+             */
+            bool pending() const;
+
+            /**
+             * Begins a new query. Every sample that passes the depth test until end() is called is counted.
+             */
+            void begin();
+            void end();
+
+            deleteCopyAndMove(OcclusionQuery)
+        };
+    }
+}
@@ -37,6 +37,7 @@
 #include "Renderer/TexturedIndexArrayRenderer.h"
 #include "Renderer/VertexArray.h"
 
+#include <kdl/parallel.h>
 #include <kdl/vector_utils.h>
 
 #include <vecmath/forward.h>
@@ -129,18 +130,24 @@ namespace TrenchBroom {
                 }
 
                 using Vertex = GLVertexTypes::P3NT2::Vertex;
+
+                // converting the grid points is independent for each patch, so it is done in parallel
+                auto verticesPerPatch = kdl::vec_parallel_transform(patchNodes, [](const Model::PatchNode* patchNode) {
+                    return kdl::vec_transform(patchNode->grid().points, [](const auto& p) { return Vertex{vm::vec3f{p.position}, vm::vec3f{p.normal}, vm::vec2f{p.texCoords}}; });
+                });
+
                 auto vertices = std::vector<Vertex>{};
                 vertices.reserve(vertexCount);
 
                 auto indexArrayMapBuilder = TexturedIndexArrayMapBuilder{indexArrayMapSize};
                 using Index = TexturedIndexArrayMapBuilder::Index;
 
-                for (const auto* patchNode : patchNodes) {
+                for (size_t i = 0u; i < patchNodes.size(); ++i) {
+                    const auto* patchNode = patchNodes[i];
                     const auto vertexOffset = vertices.size();
 
                     const auto& grid = patchNode->grid();
-                    auto gridVertices = kdl::vec_transform(grid.points, [](const auto& p) { return Vertex{vm::vec3f{p.position}, vm::vec3f{p.normal}, vm::vec2f{p.texCoords}}; });
-                    vertices = kdl::vec_concat(std::move(vertices), std::move(gridVertices));
+                    vertices.insert(std::end(vertices), std::begin(verticesPerPatch[i]), std::end(verticesPerPatch[i]));
 
                     const auto* texture = patchNode->patch().texture();
 
@@ -163,55 +170,66 @@ namespace TrenchBroom {
                 return TexturedIndexArrayRenderer{std::move(vertexArray), std::move(indexArray), std::move(indexArrayMapBuilder.ranges())};
         }
 
-        static DirectEdgeRenderer buildEdgeRenderer(const std::vector<Model::PatchNode*>& patchNodes) {
-                size_t vertexCount = 0u;
-                auto indexRangeMapSize = IndexRangeMap::Size{};
+        /**
+         * Returns the vertices of the boundary of the given patch, in order.
+         */
+        static std::vector<GLVertexTypes::P3::Vertex> edgeLoopVertices(const Model::PatchNode* patchNode) {
+            const auto& grid = patchNode->grid();
 
-                for (const auto* patchNode : patchNodes) {
-                    vertexCount += (patchNode->grid().pointRowCount + patchNode->grid().pointColumnCount - 2u) * 2u;
-                    indexRangeMapSize.inc(PrimType::LineLoop, vertexCount);
-                }
+            auto result = std::vector<GLVertexTypes::P3::Vertex>{};
+            result.reserve((grid.pointRowCount + grid.pointColumnCount - 2u) * 2u);
 
-                auto indexRangeMapBuilder = IndexRangeMapBuilder<GLVertexTypes::P3>{vertexCount, indexRangeMapSize};
+            // walk around the patch to collect the edge vertices
+            // for each side, collect the first vertex up to but not including the last vertex
 
-                for (const auto* patchNode : patchNodes) {
-                    const auto& grid = patchNode->grid();
+            const auto t = 0u;
+            const auto b = grid.pointRowCount - 1u;
+            const auto l = 0u;
+            const auto r = grid.pointColumnCount - 1u;
 
-                    auto edgeLoopVertices = std::vector<GLVertexTypes::P3::Vertex>{};
-                    edgeLoopVertices.reserve((grid.pointRowCount + grid.pointColumnCount - 2u) * 2u);
-                    
-                    // walk around the patch to collect the edge vertices
-                    // for each side, collect the first vertex up to but not including the last vertex
+            size_t row = t;
+            size_t col = l;
 
-                    const auto t = 0u;
-                    const auto b = grid.pointRowCount - 1u;
-                    const auto l = 0u;
-                    const auto r = grid.pointColumnCount - 1u;
+            while (col < r) {
+                result.emplace_back(vm::vec3f{grid.point(row, col++).position});
+            }
+            assert(row == t && col == r);
 
-                    size_t row = t;
-                    size_t col = l;
+            while (row < b) {
+                result.emplace_back(vm::vec3f{grid.point(row++, col).position});
+            }
+            assert(row == b && col == r);
 
-                    while (col < r) {
-                        edgeLoopVertices.emplace_back(vm::vec3f{grid.point(row, col++).position});
-                    }
-                    assert(row == t && col == r);
+            while (col > l) {
+                result.emplace_back(vm::vec3f{grid.point(row, col--).position});
+            }
+            assert(row == b && col == l);
 
-                    while (row < b) {
-                        edgeLoopVertices.emplace_back(vm::vec3f{grid.point(row++, col).position});
-                    }
-                    assert(row == b && col == r);
+            while (row > t) {
+                result.emplace_back(vm::vec3f{grid.point(row--, col).position});
+            }
+            assert(row == t && col == l);
 
-                    while (col > l) {
-                        edgeLoopVertices.emplace_back(vm::vec3f{grid.point(row, col--).position});
-                    }
-                    assert(row == b && col == l);
+            return result;
+        }
 
-                    while (row > t) {
-                        edgeLoopVertices.emplace_back(vm::vec3f{grid.point(row--, col).position});
-                    }
-                    assert(row == t && col == l);
+        static DirectEdgeRenderer buildEdgeRenderer(const std::vector<Model::PatchNode*>& patchNodes) {
+                // collecting the edge loops is independent for each patch, so it is done in parallel
+                auto edgeLoops = kdl::vec_parallel_transform(patchNodes, [](const Model::PatchNode* patchNode) {
+                    return edgeLoopVertices(patchNode);
+                });
 
-                    indexRangeMapBuilder.addLineLoop(std::move(edgeLoopVertices));
+                size_t vertexCount = 0u;
+                auto indexRangeMapSize = IndexRangeMap::Size{};
+
+                for (const auto& edgeLoop : edgeLoops) {
+                    vertexCount += edgeLoop.size();
+                    indexRangeMapSize.inc(PrimType::LineLoop);
+                }
+
+                auto indexRangeMapBuilder = IndexRangeMapBuilder<GLVertexTypes::P3>{vertexCount, indexRangeMapSize};
+                for (auto& edgeLoop : edgeLoops) {
+                    indexRangeMapBuilder.addLineLoop(std::move(edgeLoop));
                 }
 
                 auto vertexArray = VertexArray::move(std::move(indexRangeMapBuilder.vertices()));
@@ -246,8 +264,9 @@ namespace TrenchBroom {
                 void before(const Assets::Texture* texture) override {
                     shader.set("GridColor", gridColorForTexture(texture));
                     if (texture != nullptr) {
-                        texture->activate();
-                        shader.set("ApplyTexture", applyTexture);
+                        // if the texture's upload was deferred, we only render its average color
+                        const auto active = texture->activate();
+                        shader.set("ApplyTexture", applyTexture && active);
                         shader.set("Color", texture->averageColor());
                     } else {
                         shader.set("ApplyTexture", false);
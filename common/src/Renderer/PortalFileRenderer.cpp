@@ -0,0 +1,117 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "PortalFileRenderer.h"
+
+#include "Color.h"
+#include "Model/PortalFile.h"
+#include "Renderer/Camera.h"
+#include "Renderer/PrimitiveRenderer.h"
+#include "Renderer/RenderBatch.h"
+#include "Renderer/RenderContext.h"
+
+#include <kdl/parallel.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/polygon.h>
+#include <vecmath/vec.h>
+
+#include <cmath>
+#include <map>
+#include <tuple>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        static vm::bbox3f computeBounds(const vm::polygon3f& portal) {
+            vm::bbox3f::builder builder;
+            for (const auto& vertex : portal.vertices()) {
+                builder.add(vertex);
+            }
+            return builder.bounds();
+        }
+
+        PortalFileRenderer::PortalFileRenderer(const Model::PortalFile& portalFile, const Color& fillColor, const Color& borderColor) {
+            using ChunkKey = std::tuple<int, int, int>;
+
+            const auto& portals = portalFile.portals();
+            std::map<ChunkKey, std::vector<size_t>> portalsByChunk;
+            for (size_t i = 0; i < portals.size(); ++i) {
+                if (portals[i].vertices().empty()) {
+                    continue;
+                }
+
+                const auto center = computeBounds(portals[i]).center();
+                const auto cell = [&](const size_t j) { return static_cast<int>(std::floor(center[j] / ChunkSize)); };
+                portalsByChunk[ChunkKey{cell(0), cell(1), cell(2)}].push_back(i);
+            }
+
+            std::vector<const std::vector<size_t>*> chunkPortals;
+            chunkPortals.reserve(portalsByChunk.size());
+            for (const auto& [key, indices] : portalsByChunk) {
+                chunkPortals.push_back(&indices);
+            }
+
+            // every chunk has its own renderer, so the chunks can be triangulated independently
+            m_chunks.resize(chunkPortals.size());
+            kdl::parallel_for(chunkPortals.size(), [&](const size_t i) {
+                auto& chunk = m_chunks[i];
+                chunk.renderer = std::make_unique<PrimitiveRenderer>();
+
+                vm::bbox3f::builder builder;
+                for (const auto index : *chunkPortals[i]) {
+                    const auto& portal = portals[index];
+                    builder.add(computeBounds(portal));
+
+                    chunk.renderer->renderFilledPolygon(fillColor,
+                                                        PrimitiveRendererOcclusionPolicy::Hide,
+                                                        PrimitiveRendererCullingPolicy::ShowBackfaces,
+                                                        portal.vertices());
+
+                    const auto lineWidth = 4.0f;
+                    chunk.renderer->renderPolygon(borderColor,
+                                                  lineWidth,
+                                                  PrimitiveRendererOcclusionPolicy::Hide,
+                                                  portal.vertices());
+                }
+                chunk.bounds = builder.bounds();
+            });
+        }
+
+        PortalFileRenderer::~PortalFileRenderer() = default;
+
+        void PortalFileRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch, const float viewDistance) {
+            const auto& camera = renderContext.camera();
+            const auto limitDistance = renderContext.render3D() && viewDistance > 0.0f;
+
+            for (auto& chunk : m_chunks) {
+                if (!camera.intersectsFrustum(chunk.bounds)) {
+                    continue;
+                }
+                if (limitDistance) {
+                    const auto closestPoint = vm::max(chunk.bounds.min, vm::min(chunk.bounds.max, camera.position()));
+                    if (vm::squared_distance(closestPoint, camera.position()) > viewDistance * viewDistance) {
+                        continue;
+                    }
+                }
+                renderBatch.add(chunk.renderer.get());
+            }
+        }
+    }
+}
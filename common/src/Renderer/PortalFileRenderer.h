@@ -0,0 +1,79 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <vecmath/forward.h>
+#include <vecmath/bbox.h>
+
+#include <memory>
+#include <vector>
+
+namespace TrenchBroom {
+    class Color;
+
+    namespace Model {
+        class PortalFile;
+    }
+
+    namespace Renderer {
+        class PrimitiveRenderer;
+        class RenderBatch;
+        class RenderContext;
+
+        /**
+         * Renders the portals of a portal file.
+         *
+         * The portals are bucketed into chunks on a regular grid by the centers of their bounds, and every chunk has
+         * its own primitive renderer. Chunks that lie outside of the camera frustum or, in the 3D view, beyond the
+         * view distance are skipped when rendering, so that large portal files remain interactive.
+         */
+        class PortalFileRenderer {
+        private:
+            /**
+             * The edge length of a chunk.
+             */
+            static constexpr float ChunkSize = 1024.0f;
+
+            struct Chunk {
+                vm::bbox3f bounds;
+                std::unique_ptr<PrimitiveRenderer> renderer;
+            };
+
+            std::vector<Chunk> m_chunks;
+        public:
+            /**
+             * Triangulates the portals of the given portal file in parallel.
+             */
+            PortalFileRenderer(const Model::PortalFile& portalFile, const Color& fillColor, const Color& borderColor);
+            ~PortalFileRenderer();
+
+            /**
+             * Adds the visible chunks to the given render batch.
+             *
+             * @param renderContext the render context
+             * @param renderBatch the render batch
+             * @param viewDistance the maximum distance of a rendered chunk from the camera in the 3D view, or 0 to
+             * render all chunks regardless of their distance
+             */
+            void render(RenderContext& renderContext, RenderBatch& renderBatch, float viewDistance);
+        };
+    }
+}
@@ -25,6 +25,9 @@
 
 #include <kdl/vector_utils.h>
 
+#include <algorithm>
+#include <iterator>
+
 namespace TrenchBroom {
     namespace Renderer {
         class RenderBatch::IndexedRenderableWrapper : public IndexedRenderable {
@@ -43,6 +46,10 @@ namespace TrenchBroom {
             void doRender(RenderContext& renderContext) override {
                 m_wrappee->render(renderContext);
             }
+
+            std::optional<RenderSortKey> doGetSortKey() const override {
+                return m_wrappee->sortKey();
+            }
         };
 
         RenderBatch::RenderBatch(VboManager& vboManager) :
@@ -89,7 +96,10 @@ namespace TrenchBroom {
 
         void RenderBatch::render(RenderContext& renderContext) {
             prepareRenderables();
+            sortRenderables();
             renderRenderables(renderContext);
+            m_vboManager.insertFence();
+            m_vboManager.recycleReleasedVbos();
         }
 
         void RenderBatch::doAdd(Renderable* renderable) {
@@ -106,6 +116,26 @@ namespace TrenchBroom {
             }
         }
 
+        void RenderBatch::sortRenderables() {
+            // only consecutive renderables with sort keys are reordered, all others act as barriers
+            auto runBegin = std::begin(m_batch);
+            while (runBegin != std::end(m_batch)) {
+                runBegin = std::find_if(runBegin, std::end(m_batch), [](const auto* renderable) {
+                    return renderable->sortKey().has_value();
+                });
+                const auto runEnd = std::find_if(runBegin, std::end(m_batch), [](const auto* renderable) {
+                    return !renderable->sortKey().has_value();
+                });
+
+                if (std::distance(runBegin, runEnd) > 1) {
+                    std::stable_sort(runBegin, runEnd, [](const auto* lhs, const auto* rhs) {
+                        return *lhs->sortKey() < *rhs->sortKey();
+                    });
+                }
+                runBegin = runEnd;
+            }
+        }
+
         void RenderBatch::renderRenderables(RenderContext& renderContext) {
             for (Renderable* renderable : m_batch)
                 renderable->render(renderContext);
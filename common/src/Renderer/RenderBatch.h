@@ -65,6 +65,7 @@ namespace TrenchBroom {
             void doAdd(Renderable* renderable);
 
             void prepareRenderables();
+            void sortRenderables();
 
             void renderRenderables(RenderContext& renderContext);
         };
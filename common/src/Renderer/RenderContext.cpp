@@ -28,6 +28,7 @@ namespace TrenchBroom {
         m_transformation(m_camera.projectionMatrix(), m_camera.viewMatrix()),
         m_fontManager(fontManager),
         m_shaderManager(shaderManager),
+        m_gpuTimer(nullptr),
         m_showTextures(true),
         m_showFaces(true),
         m_showEdges(true),
@@ -69,6 +70,14 @@ namespace TrenchBroom {
             return m_shaderManager;
         }
 
+        GpuTimer* RenderContext::gpuTimer() {
+            return m_gpuTimer;
+        }
+
+        void RenderContext::setGpuTimer(GpuTimer* gpuTimer) {
+            m_gpuTimer = gpuTimer;
+        }
+
         bool RenderContext::showTextures() const {
             return m_showTextures;
         }
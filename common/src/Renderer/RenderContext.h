@@ -28,6 +28,7 @@ namespace TrenchBroom {
     namespace Renderer {
         class Camera;
         class FontManager;
+        class GpuTimer;
         class ShaderManager;
 
         enum class RenderMode {
@@ -51,6 +52,7 @@ namespace TrenchBroom {
             Transformation m_transformation;
             FontManager& m_fontManager;
             ShaderManager& m_shaderManager;
+            GpuTimer* m_gpuTimer;
 
             // settings for any map rendering view
             bool m_showTextures;
@@ -87,6 +89,13 @@ namespace TrenchBroom {
             FontManager& fontManager();
             ShaderManager& shaderManager();
 
+            /**
+             * Returns the timer that measures the GPU time of this view's render passes, or nullptr if the passes
+             * are not timed.
+             */
+            GpuTimer* gpuTimer();
+            void setGpuTimer(GpuTimer* gpuTimer);
+
             bool showTextures() const;
             void setShowTextures(bool showTextures);
 
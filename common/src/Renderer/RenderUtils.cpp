@@ -78,6 +78,10 @@ namespace TrenchBroom {
         void TextureRenderFunc::before(const Assets::Texture* /* texture */) {}
         void TextureRenderFunc::after(const Assets::Texture* /* texture */) {}
 
+        InstanceRenderFunc::~InstanceRenderFunc() {}
+        void InstanceRenderFunc::before(const size_t /* index */) {}
+        void InstanceRenderFunc::after(const size_t /* index */) {}
+
         void DefaultTextureRenderFunc::before(const Assets::Texture* texture) {
             if (texture != nullptr) {
                 texture->activate();
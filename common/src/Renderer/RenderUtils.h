@@ -53,6 +53,17 @@ namespace TrenchBroom {
             void after(const Assets::Texture* texture) override;
         };
 
+        /**
+         * Callbacks that are invoked before and after each instance is drawn when a renderer draws multiple
+         * instances of its primitives, e.g. to set the instance's transformation.
+         */
+        class InstanceRenderFunc {
+        public:
+            virtual ~InstanceRenderFunc();
+            virtual void before(size_t index);
+            virtual void after(size_t index);
+        };
+
         std::vector<vm::vec2f> circle2D(float radius, size_t segments);
         std::vector<vm::vec2f> circle2D(float radius, float startAngle, float angleLength, size_t segments);
         std::vector<vm::vec3f> circle2D(float radius, vm::axis::type axis, float startAngle, float angleLength, size_t segments);
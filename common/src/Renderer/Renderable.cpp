@@ -19,12 +19,29 @@
 
 #include "Renderable.h"
 
+#include <functional>
+
 namespace TrenchBroom {
     namespace Renderer {
+        bool operator<(const RenderSortKey& lhs, const RenderSortKey& rhs) {
+            if (lhs.transparent != rhs.transparent) {
+                return !lhs.transparent;
+            }
+            return std::less<const void*>()(lhs.state, rhs.state);
+        }
+
         void Renderable::render(RenderContext& renderContext) {
             doRender(renderContext);
         }
 
+        std::optional<RenderSortKey> Renderable::sortKey() const {
+            return doGetSortKey();
+        }
+
+        std::optional<RenderSortKey> Renderable::doGetSortKey() const {
+            return std::nullopt;
+        }
+
         void DirectRenderable::prepareVertices(VboManager& vboManager) {
             doPrepareVertices(vboManager);
         }
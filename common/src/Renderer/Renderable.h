@@ -21,19 +21,41 @@
 
 #include "Macros.h"
 
+#include <optional>
+
 namespace TrenchBroom {
     namespace Renderer {
         class RenderContext;
         class VboManager;
 
+        /**
+         * Allows a render batch to reorder renderables that do not depend on the order in which they are rendered.
+         *
+         * Renderables with the same state set up the same GL state, e.g. they use the same shader program, and are
+         * rendered next to each other. Transparent renderables are rendered after all opaque renderables.
+         */
+        struct RenderSortKey {
+            bool transparent;
+            const void* state;
+        };
+
+        bool operator<(const RenderSortKey& lhs, const RenderSortKey& rhs);
+
         class Renderable {
         public:
             Renderable() = default;
             virtual ~Renderable() = default;
 
             void render(RenderContext& renderContext);
+
+            /**
+             * Returns the key by which this renderable may be reordered, or nothing if it must be rendered in the
+             * order in which it was added to the render batch.
+             */
+            std::optional<RenderSortKey> sortKey() const;
         private:
             virtual void doRender(RenderContext& renderContext) = 0;
+            virtual std::optional<RenderSortKey> doGetSortKey() const;
 
             defineCopyAndMove(Renderable)
         };
@@ -20,21 +20,50 @@
 #include "ShaderManager.h"
 
 #include "Ensure.h"
+#include "Exceptions.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/IOUtils.h"
 #include "IO/Path.h"
+#include "IO/Reader.h"
 #include "IO/SystemPaths.h"
 #include "Renderer/Shader.h"
 #include "Renderer/ShaderProgram.h"
 #include "Renderer/ShaderConfig.h"
 
 #include <cassert>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
 
 namespace TrenchBroom {
     namespace Renderer {
+        static const std::string BinaryEntryMagic = "TBSP";
+        // increment this whenever the entry layout changes
+        static const uint32_t BinaryEntryVersion = 1u;
+
         ShaderManager::ShaderManager() : m_currentProgram(nullptr) {}
 
         ShaderManager::~ShaderManager() = default;
 
+        void ShaderManager::setBinaryCacheDirectory(IO::Path directory, std::string driverId) {
+            if (!GLEW_ARB_get_program_binary) {
+                return;
+            }
+
+            // some drivers expose the extension without supporting any binary formats
+            GLint formatCount = 0;
+            glAssert(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount));
+            if (formatCount > 0) {
+                m_binaryCacheDirectory = std::move(directory);
+                m_driverId = std::move(driverId);
+            }
+        }
+
         ShaderProgram& ShaderManager::program(const ShaderConfig& config) {
             auto it = m_programs.find(&config);
             if (it != std::end(m_programs)) {
@@ -58,6 +87,13 @@ namespace TrenchBroom {
         std::unique_ptr<ShaderProgram> ShaderManager::createProgram(const ShaderConfig& config) {
             auto program = std::make_unique<ShaderProgram>(this, config.name());
 
+            const auto key = m_binaryCacheDirectory ? std::optional<uint64_t>{computeBinaryKey(config)} : std::nullopt;
+            if (key) {
+                if (const auto binary = readBinary(*key); binary && program->loadBinary(*binary)) {
+                    return program;
+                }
+            }
+
             for (const auto& path : config.vertexShaders()) {
                 Shader& shader = loadShader(path, GL_VERTEX_SHADER);
                 program->attach(shader);
@@ -68,6 +104,13 @@ namespace TrenchBroom {
                 program->attach(shader);
             }
 
+            if (key) {
+                program->link();
+                if (const auto binary = program->binary()) {
+                    writeBinary(*key, *binary);
+                }
+            }
+
             return program;
         }
 
@@ -83,5 +126,116 @@ namespace TrenchBroom {
 
             return *(result.first->second);
         }
+
+        static void hashBytes(uint64_t& hash, const std::string_view bytes) {
+            // 64 bit FNV-1a
+            for (const char c : bytes) {
+                hash ^= static_cast<uint64_t>(static_cast<unsigned char>(c));
+                hash *= uint64_t(1099511628211ull);
+            }
+        }
+
+        /**
+         * The key covers the driver and the sources of all shaders of the given program, so entries become stale
+         * when the driver is updated or a shader is changed.
+         */
+        uint64_t ShaderManager::computeBinaryKey(const ShaderConfig& config) const {
+            auto hash = uint64_t(14695981039346656037ull);
+            hashBytes(hash, m_driverId);
+            hashBytes(hash, config.name());
+
+            const auto hashShaders = [&](const std::vector<std::string>& names) {
+                for (const auto& name : names) {
+                    const auto shaderPath = IO::SystemPaths::findResourceFile(IO::Path("shader") + IO::Path(name));
+                    const auto file = IO::Disk::openFile(shaderPath);
+                    auto reader = file->reader().buffer();
+                    hashBytes(hash, name);
+                    hashBytes(hash, reader.stringView());
+                }
+            };
+            hashShaders(config.vertexShaders());
+            hashShaders(config.fragmentShaders());
+
+            return hash;
+        }
+
+        IO::Path ShaderManager::binaryPath(const uint64_t key) const {
+            auto name = std::stringstream{};
+            name << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+            return *m_binaryCacheDirectory + IO::Path(name.str());
+        }
+
+        std::optional<ShaderProgramBinary> ShaderManager::readBinary(const uint64_t key) const {
+            const auto path = binaryPath(key);
+            if (!IO::Disk::fileExists(path)) {
+                return std::nullopt;
+            }
+
+            try {
+                const auto file = IO::Disk::openFile(path);
+                auto reader = file->reader().buffer();
+
+                if (reader.readString(BinaryEntryMagic.size()) != BinaryEntryMagic ||
+                    reader.readUnsignedInt<uint32_t>() != BinaryEntryVersion ||
+                    reader.read<uint64_t, uint64_t>() != key) {
+                    return std::nullopt;
+                }
+
+                const auto format = reader.readUnsignedInt<uint32_t>();
+                const auto size = reader.readSize<uint64_t>();
+                if (size == 0u || !reader.canRead(size)) {
+                    return std::nullopt;
+                }
+
+                auto result = ShaderProgramBinary{static_cast<GLenum>(format), std::vector<char>(size)};
+                reader.read(result.data.data(), size);
+                return result;
+            } catch (const Exception&) {
+                // treat unreadable entries as missing; they will be overwritten
+                return std::nullopt;
+            }
+        }
+
+        template <typename T>
+        static void writeValue(std::ostream& stream, const T value) {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        void ShaderManager::writeBinary(const uint64_t key, const ShaderProgramBinary& binary) const {
+            try {
+                IO::Disk::ensureDirectoryExists(*m_binaryCacheDirectory);
+
+                const auto path = binaryPath(key);
+
+                // write to a temporary file first so that other instances never see partially written entries
+                auto tempName = std::stringstream{};
+                tempName << path.lastComponent().asString() << "." << std::hash<std::thread::id>{}(std::this_thread::get_id()) << ".tmp";
+                const auto tempPath = path.deleteLastComponent() + IO::Path(tempName.str());
+
+                {
+                    auto stream = IO::openPathAsOutputStream(tempPath, std::ios::out | std::ios::binary);
+                    if (!stream) {
+                        return;
+                    }
+
+                    stream.write(BinaryEntryMagic.data(), static_cast<std::streamsize>(BinaryEntryMagic.size()));
+                    writeValue(stream, BinaryEntryVersion);
+                    writeValue(stream, key);
+                    writeValue(stream, static_cast<uint32_t>(binary.format));
+                    writeValue(stream, static_cast<uint64_t>(binary.data.size()));
+                    stream.write(binary.data.data(), static_cast<std::streamsize>(binary.data.size()));
+
+                    if (!stream) {
+                        stream.close();
+                        IO::Disk::deleteFile(tempPath);
+                        return;
+                    }
+                }
+
+                IO::Disk::moveFile(tempPath, path, true);
+            } catch (const Exception&) {
+                // the cache is an optimization, the program will just be built from its shaders next time
+            }
+        }
     }
 }
@@ -19,17 +19,22 @@
 
 #pragma once
 
+#include "IO/Path.h"
 #include "Renderer/GL.h"
 
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Renderer {
         class Shader;
         class ShaderConfig;
         class ShaderProgram;
+        struct ShaderProgramBinary;
 
         class ShaderManager {
         private:
@@ -40,16 +45,35 @@ namespace TrenchBroom {
             ShaderCache m_shaders;
             ShaderProgramCache m_programs;
             ShaderProgram* m_currentProgram;
+
+            std::optional<IO::Path> m_binaryCacheDirectory;
+            std::string m_driverId;
         public:
             ShaderManager();
             ~ShaderManager();
         public:
+            /**
+             * Enables caching linked programs in the given directory so that they don't have to be compiled and
+             * linked again when the application is restarted. Does nothing if the driver does not support program
+             * binaries. Must be called with the OpenGL context current.
+             *
+             * @param directory the cache directory
+             * @param driverId identifies the driver, e.g. vendor, renderer and version; entries written by other
+             * drivers are ignored
+             */
+            void setBinaryCacheDirectory(IO::Path directory, std::string driverId);
+
             ShaderProgram& program(const ShaderConfig& config);
             ShaderProgram* currentProgram();
         private:
             void setCurrentProgram(ShaderProgram* program);
             std::unique_ptr<ShaderProgram> createProgram(const ShaderConfig& config);
             Shader& loadShader(const std::string& name, const GLenum type);
+
+            uint64_t computeBinaryKey(const ShaderConfig& config) const;
+            IO::Path binaryPath(uint64_t key) const;
+            std::optional<ShaderProgramBinary> readBinary(uint64_t key) const;
+            void writeBinary(uint64_t key, const ShaderProgramBinary& binary) const;
         };
     }
 }
@@ -27,12 +27,28 @@
 #include <vecmath/vec.h>
 #include <vecmath/mat.h>
 
+#include <cstring>
 #include <memory>
+#include <optional>
 #include <string>
 #include <sstream>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Renderer {
+        /**
+         * Stores the given value in the given cache and returns whether it differs from the previously cached value.
+         */
+        template <typename T>
+        static bool updateValue(std::vector<unsigned char>& cachedValue, const T& value) {
+            const auto* bytes = reinterpret_cast<const unsigned char*>(&value);
+            if (cachedValue.size() == sizeof(T) && std::memcmp(cachedValue.data(), bytes, sizeof(T)) == 0) {
+                return false;
+            }
+            cachedValue.assign(bytes, bytes + sizeof(T));
+            return true;
+        }
+
         ShaderProgram::ShaderProgram(ShaderManager* shaderManager, const std::string& name) :
         m_name(name),
         m_programId(glCreateProgram()),
@@ -86,55 +102,84 @@ namespace TrenchBroom {
 
         void ShaderProgram::set(const std::string& name, const int value) {
             assert(checkActive());
-            glAssert(glUniform1i(findUniformLocation(name), value));
+            auto& variable = findUniformVariable(name);
+            if (updateValue(variable.value, value)) {
+                glAssert(glUniform1i(variable.location, value));
+            }
         }
 
         void ShaderProgram::set(const std::string& name, const size_t value) {
-            assert(checkActive());
-            glAssert(glUniform1i(findUniformLocation(name), static_cast<int>(value)));
+            return set(name, static_cast<int>(value));
         }
 
         void ShaderProgram::set(const std::string& name, const float value) {
             assert(checkActive());
-            glAssert(glUniform1f(findUniformLocation(name), value));
+            auto& variable = findUniformVariable(name);
+            if (updateValue(variable.value, value)) {
+                glAssert(glUniform1f(variable.location, value));
+            }
         }
 
         void ShaderProgram::set(const std::string& name, const double value) {
             assert(checkActive());
-            glAssert(glUniform1d(findUniformLocation(name), value));
+            auto& variable = findUniformVariable(name);
+            if (updateValue(variable.value, value)) {
+                glAssert(glUniform1d(variable.location, value));
+            }
         }
 
         void ShaderProgram::set(const std::string& name, const vm::vec2f& value) {
             assert(checkActive());
-            glAssert(glUniform2f(findUniformLocation(name), value.x(), value.y()));
+            auto& variable = findUniformVariable(name);
+            if (updateValue(variable.value, value)) {
+                glAssert(glUniform2f(variable.location, value.x(), value.y()));
+            }
         }
 
         void ShaderProgram::set(const std::string& name, const vm::vec3f& value) {
             assert(checkActive());
-            glAssert(glUniform3f(findUniformLocation(name), value.x(), value.y(), value.z()));
+            auto& variable = findUniformVariable(name);
+            if (updateValue(variable.value, value)) {
+                glAssert(glUniform3f(variable.location, value.x(), value.y(), value.z()));
+            }
         }
 
         void ShaderProgram::set(const std::string& name, const vm::vec4f& value) {
             assert(checkActive());
-            glAssert(glUniform4f(findUniformLocation(name), value.x(), value.y(), value.z(), value.w()));
+            auto& variable = findUniformVariable(name);
+            if (updateValue(variable.value, value)) {
+                glAssert(glUniform4f(variable.location, value.x(), value.y(), value.z(), value.w()));
+            }
         }
 
         void ShaderProgram::set(const std::string& name, const vm::mat2x2f& value) {
             assert(checkActive());
-            glAssert(glUniformMatrix2fv(findUniformLocation(name), 1, false, reinterpret_cast<const float*>(value.v)));
+            auto& variable = findUniformVariable(name);
+            if (updateValue(variable.value, value)) {
+                glAssert(glUniformMatrix2fv(variable.location, 1, false, reinterpret_cast<const float*>(value.v)));
+            }
         }
 
         void ShaderProgram::set(const std::string& name, const vm::mat3x3f& value) {
             assert(checkActive());
-            glAssert(glUniformMatrix3fv(findUniformLocation(name), 1, false, reinterpret_cast<const float*>(value.v)));
+            auto& variable = findUniformVariable(name);
+            if (updateValue(variable.value, value)) {
+                glAssert(glUniformMatrix3fv(variable.location, 1, false, reinterpret_cast<const float*>(value.v)));
+            }
         }
 
         void ShaderProgram::set(const std::string& name, const vm::mat4x4f& value) {
             assert(checkActive());
-            glAssert(glUniformMatrix4fv(findUniformLocation(name), 1, false, reinterpret_cast<const float*>(value.v)));
+            auto& variable = findUniformVariable(name);
+            if (updateValue(variable.value, value)) {
+                glAssert(glUniformMatrix4fv(variable.location, 1, false, reinterpret_cast<const float*>(value.v)));
+            }
         }
 
         void ShaderProgram::link() {
+            if (GLEW_ARB_get_program_binary) {
+                glAssert(glProgramParameteri(m_programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+            }
             glAssert(glLinkProgram(m_programId));
 
             GLint linkStatus = 0;
@@ -163,6 +208,43 @@ namespace TrenchBroom {
             m_needsLinking = false;
         }
 
+        bool ShaderProgram::loadBinary(const ShaderProgramBinary& binary) {
+            if (!GLEW_ARB_get_program_binary) {
+                return false;
+            }
+
+            glAssert(glProgramBinary(m_programId, binary.format, binary.data.data(), static_cast<GLsizei>(binary.data.size())));
+
+            GLint linkStatus = 0;
+            glAssert(glGetProgramiv(m_programId, GL_LINK_STATUS, &linkStatus));
+            if (linkStatus == 0) {
+                return false;
+            }
+
+            m_variableCache.clear();
+            m_attributeCache.clear();
+            m_needsLinking = false;
+            return true;
+        }
+
+        std::optional<ShaderProgramBinary> ShaderProgram::binary() const {
+            assert(!m_needsLinking);
+            if (!GLEW_ARB_get_program_binary) {
+                return std::nullopt;
+            }
+
+            GLint length = 0;
+            glAssert(glGetProgramiv(m_programId, GL_PROGRAM_BINARY_LENGTH, &length));
+            if (length <= 0) {
+                return std::nullopt;
+            }
+
+            auto result = ShaderProgramBinary{0, std::vector<char>(static_cast<size_t>(length))};
+            glAssert(glGetProgramBinary(m_programId, length, &length, &result.format, result.data.data()));
+            result.data.resize(static_cast<size_t>(length));
+            return result;
+        }
+
         GLint ShaderProgram::findAttributeLocation(const std::string& name) const {
             auto it = m_attributeCache.find(name);
             if (it == std::end(m_attributeCache)) {
@@ -178,7 +260,7 @@ namespace TrenchBroom {
             return it->second;
         }
 
-        GLint ShaderProgram::findUniformLocation(const std::string& name) const {
+        ShaderProgram::UniformVariable& ShaderProgram::findUniformVariable(const std::string& name) {
             auto it = m_variableCache.find(name);
             if (it == std::end(m_variableCache)) {
                 GLint index;
@@ -187,8 +269,7 @@ namespace TrenchBroom {
                     throw RenderException("Location of uniform variable '" + name + "' could not be found in shader program " + m_name);
                 }
 
-                m_variableCache[name] = index;
-                return index;
+                it = m_variableCache.emplace(name, UniformVariable{index, {}}).first;
             }
             return it->second;
         }
@@ -24,21 +24,41 @@
 #include <vecmath/forward.h>
 
 #include <map>
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Renderer {
         class ShaderManager;
         class Shader;
 
+        /**
+         * A linked program in the driver specific binary format, see glGetProgramBinary.
+         */
+        struct ShaderProgramBinary {
+            GLenum format;
+            std::vector<char> data;
+        };
+
         class ShaderProgram {
         private:
-            using UniformVariableCache = std::map<std::string, GLint>;
+            /**
+             * The location of a uniform variable and the value that was last assigned to it. Uniform values are part
+             * of the program object's state, so assigning the same value again can be skipped.
+             */
+            struct UniformVariable {
+                GLint location;
+                std::vector<unsigned char> value;
+            };
+
+            using UniformVariableCache = std::unordered_map<std::string, UniformVariable>;
             using AttributeLocationCache = std::map<std::string, GLint>;
             std::string m_name;
             GLuint m_programId;
             bool m_needsLinking;
-            mutable UniformVariableCache m_variableCache;
+            UniformVariableCache m_variableCache;
             mutable AttributeLocationCache m_attributeCache;
             ShaderManager* m_shaderManager;
         public:
@@ -64,9 +84,28 @@ namespace TrenchBroom {
             void set(const std::string& name, const vm::mat4x4f& value);
 
             GLint findAttributeLocation(const std::string& name) const;
-        private:
+
+            /**
+             * Links this program immediately instead of on first activation.
+             *
+             * @throws RenderException if linking fails
+             */
             void link();
-            GLint findUniformLocation(const std::string& name) const;
+
+            /**
+             * Restores this program from the given binary instead of compiling and linking its shaders. Returns
+             * false if the driver rejects the binary, e.g. because it was created by a different driver version; in
+             * that case, the program must be built from its shaders.
+             */
+            bool loadBinary(const ShaderProgramBinary& binary);
+
+            /**
+             * Returns the binary of this program, or an empty optional if the driver does not provide it. The
+             * program must have been linked.
+             */
+            std::optional<ShaderProgramBinary> binary() const;
+        private:
+            UniformVariable& findUniformVariable(const std::string& name);
             bool checkActive() const;
         };
     }
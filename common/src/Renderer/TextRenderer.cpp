@@ -43,14 +43,11 @@ namespace TrenchBroom {
         const size_t TextRenderer::RectCornerSegments = 3;
         const float TextRenderer::RectCornerRadius = 3.0f;
 
-        TextRenderer::Entry::Entry(std::vector<vm::vec2f>& i_vertices, const vm::vec2f& i_size, const vm::vec3f& i_offset, const Color& i_textColor, const Color& i_backgroundColor) :
-        size(i_size),
+        TextRenderer::Entry::Entry(std::shared_ptr<const TextLayout> i_layout, const vm::vec3f& i_offset, const Color& i_textColor, const Color& i_backgroundColor) :
+        layout(std::move(i_layout)),
         offset(i_offset),
         textColor(i_textColor),
-        backgroundColor(i_backgroundColor) {
-            using std::swap;
-            swap(vertices, i_vertices);
-        }
+        backgroundColor(i_backgroundColor) {}
 
         TextRenderer::EntryCollection::EntryCollection() :
         textVertexCount(0),
@@ -77,39 +74,39 @@ namespace TrenchBroom {
             if (distance <= 0.0f)
                 return;
 
-            if (!isVisible(renderContext, string, position, distance, onTop))
-                return;
+            // cull by distance before the string is laid out
+            if (!onTop) {
+                if (renderContext.render3D() && distance > m_maxViewDistance)
+                    return;
+                if (renderContext.render2D() && camera.zoom() < m_minZoomFactor)
+                    return;
+            }
 
             FontManager& fontManager = renderContext.fontManager();
             TextureFont& font = fontManager.font(m_fontDescriptor);
+            auto layout = font.layout(string);
+
+            if (!isVisible(renderContext, layout->size, position))
+                return;
 
-            std::vector<vm::vec2f> vertices = font.quads(string, true);
             const float alphaFactor = computeAlphaFactor(renderContext, distance, onTop);
-            const vm::vec2f size = font.measure(string);
-            const vm::vec3f offset = position.offset(camera, size);
+            const vm::vec3f offset = position.offset(camera, layout->size);
 
             if (onTop)
-                addEntry(m_entriesOnTop, Entry(vertices, size, offset,
+                addEntry(m_entriesOnTop, Entry(std::move(layout), offset,
                                                Color(textColor, alphaFactor * textColor.a()),
                                                Color(backgroundColor, alphaFactor * backgroundColor.a())));
             else
-                addEntry(m_entries, Entry(vertices, size, offset,
+                addEntry(m_entries, Entry(std::move(layout), offset,
                                           Color(textColor, alphaFactor * textColor.a()),
                                           Color(backgroundColor, alphaFactor * backgroundColor.a())));
         }
 
-        bool TextRenderer::isVisible(RenderContext& renderContext, const AttrString& string, const TextAnchor& position, const float distance, const bool onTop) const {
-            if (!onTop) {
-                if (renderContext.render3D() && distance > m_maxViewDistance)
-                    return false;
-                if (renderContext.render2D() && renderContext.camera().zoom() < m_minZoomFactor)
-                    return false;
-            }
-
+        bool TextRenderer::isVisible(RenderContext& renderContext, const vm::vec2f& stringSize, const TextAnchor& position) const {
             const Camera& camera = renderContext.camera();
             const Camera::Viewport& viewport = camera.viewport();
 
-            const vm::vec2f size = stringSize(renderContext, string);
+            const vm::vec2f size = round(stringSize);
             const vm::vec2f offset = vm::vec2f(position.offset(camera, size)) - m_inset;
             const vm::vec2f actualSize = size + 2.0f * m_inset;
 
@@ -134,16 +131,10 @@ namespace TrenchBroom {
             }
         }
 
-        void TextRenderer::addEntry(EntryCollection& collection, const Entry& entry) {
-            collection.entries.push_back(entry);
-            collection.textVertexCount += entry.vertices.size();
+        void TextRenderer::addEntry(EntryCollection& collection, Entry entry) {
+            collection.textVertexCount += entry.layout->quads.size() / 2u;
             collection.rectVertexCount += roundedRect2DVertexCount(RectCornerSegments);
-        }
-
-        vm::vec2f TextRenderer::stringSize(RenderContext& renderContext, const AttrString& string) const {
-            FontManager& fontManager = renderContext.fontManager();
-            TextureFont& font = fontManager.font(m_fontDescriptor);
-            return round(font.measure(string));
+            collection.entries.push_back(std::move(entry));
         }
 
         void TextRenderer::doPrepareVertices(VboManager& vboManager) {
@@ -158,8 +149,9 @@ namespace TrenchBroom {
             std::vector<RectVertex> rectVertices;
             rectVertices.reserve(collection.rectVertexCount);
 
+            auto rectCache = RectCache{};
             for (const Entry& entry : collection.entries) {
-                addEntry(entry, onTop, textVertices, rectVertices);
+                addEntry(entry, onTop, rectCache, textVertices, rectVertices);
             }
 
             collection.textArray = VertexArray::move(std::move(textVertices));
@@ -169,9 +161,9 @@ namespace TrenchBroom {
             collection.rectArray.prepare(vboManager);
         }
 
-        void TextRenderer::addEntry(const Entry& entry, const bool /* onTop */, std::vector<TextVertex>& textVertices, std::vector<RectVertex>& rectVertices) {
-            const std::vector<vm::vec2f>& stringVertices = entry.vertices;
-            const vm::vec2f& stringSize = entry.size;
+        void TextRenderer::addEntry(const Entry& entry, const bool /* onTop */, RectCache& rectCache, std::vector<TextVertex>& textVertices, std::vector<RectVertex>& rectVertices) {
+            const std::vector<vm::vec2f>& stringVertices = entry.layout->quads;
+            const vm::vec2f& stringSize = entry.layout->size;
 
             const vm::vec3f& offset = entry.offset;
 
@@ -184,7 +176,12 @@ namespace TrenchBroom {
                 textVertices.emplace_back(vm::vec3f(position2 + offset.xy(), -offset.z()), texCoords, textColor);
             }
 
-            const std::vector<vm::vec2f> rect = roundedRect2D(stringSize + 2.0f * m_inset, RectCornerRadius, RectCornerSegments);
+            // labels that show the same string share the same background rectangle
+            auto rectIt = rectCache.find(stringSize);
+            if (rectIt == std::end(rectCache)) {
+                rectIt = rectCache.emplace(stringSize, roundedRect2D(stringSize + 2.0f * m_inset, RectCornerRadius, RectCornerSegments)).first;
+            }
+            const std::vector<vm::vec2f>& rect = rectIt->second;
             for (size_t i = 0; i < rect.size(); ++i) {
                 const vm::vec2f& vertex = rect[i];
                 rectVertices.emplace_back(vm::vec3f(vertex + offset.xy() + stringSize / 2.0f, -offset.z()), rectColor);
@@ -28,6 +28,8 @@
 #include <vecmath/forward.h>
 #include <vecmath/vec.h>
 
+#include <map>
+#include <memory>
 #include <vector>
 
 namespace TrenchBroom {
@@ -35,6 +37,7 @@ namespace TrenchBroom {
         class AttrString;
         class RenderContext;
         class TextAnchor;
+        struct TextLayout;
 
         class TextRenderer : public DirectRenderable {
         private:
@@ -45,15 +48,17 @@ namespace TrenchBroom {
             static const float RectCornerRadius;
 
             struct Entry {
-                std::vector<vm::vec2f> vertices;
-                vm::vec2f size;
+                std::shared_ptr<const TextLayout> layout;
                 vm::vec3f offset;
                 Color textColor;
                 Color backgroundColor;
 
-                Entry(std::vector<vm::vec2f>& i_vertices, const vm::vec2f& i_size, const vm::vec3f& i_offset, const Color& i_textColor, const Color& i_backgroundColor);
+                Entry(std::shared_ptr<const TextLayout> i_layout, const vm::vec3f& i_offset, const Color& i_textColor, const Color& i_backgroundColor);
             };
 
+            /** The background rectangles of the entries that are being prepared, by string size. */
+            using RectCache = std::map<vm::vec2f, std::vector<vm::vec2f>>;
+
             using EntryList = std::vector<Entry>;
 
             struct EntryCollection {
@@ -85,16 +90,14 @@ namespace TrenchBroom {
         private:
             void renderString(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const AttrString& string, const TextAnchor& position, bool onTop);
 
-            bool isVisible(RenderContext& renderContext, const AttrString& string, const TextAnchor& position, float distance, bool onTop) const;
+            bool isVisible(RenderContext& renderContext, const vm::vec2f& stringSize, const TextAnchor& position) const;
             float computeAlphaFactor(const RenderContext& renderContext, float distance, bool onTop) const;
-            void addEntry(EntryCollection& collection, const Entry& entry);
-
-            vm::vec2f stringSize(RenderContext& renderContext, const AttrString& string) const;
+            void addEntry(EntryCollection& collection, Entry entry);
         private:
             void doPrepareVertices(VboManager& vboManager) override;
             void prepare(EntryCollection& collection, bool onTop, VboManager& vboManager);
 
-            void addEntry(const Entry& entry, bool onTop, std::vector<TextVertex>& textVertices, std::vector<RectVertex>& rectVertices);
+            void addEntry(const Entry& entry, bool onTop, RectCache& rectCache, std::vector<TextVertex>& textVertices, std::vector<RectVertex>& rectVertices);
 
             void doRender(RenderContext& renderContext) override;
             void render(EntryCollection& collection, RenderContext& renderContext);
@@ -32,6 +32,8 @@
 
 namespace TrenchBroom {
     namespace Renderer {
+        const size_t TextureFont::MaxCachedLayouts = 4096u;
+
         TextureFont::TextureFont(std::unique_ptr<FontTexture> texture, const std::vector<FontGlyph>& glyphs, const int lineHeight, const unsigned char firstChar, const unsigned char charCount) :
         m_texture(std::move(texture)),
         m_glyphs(glyphs),
@@ -201,6 +203,20 @@ namespace TrenchBroom {
         }
 
         vm::vec2f TextureFont::measure(const std::string& string) const {
+            if (const auto it = m_measureCache.find(string); it != std::end(m_measureCache)) {
+                return it->second;
+            }
+
+            if (m_measureCache.size() >= MaxCachedLayouts) {
+                m_measureCache.clear();
+            }
+
+            const auto result = computeSize(string);
+            m_measureCache.emplace(string, result);
+            return result;
+        }
+
+        vm::vec2f TextureFont::computeSize(const std::string& string) const {
             vm::vec2f result;
 
             int x = 0;
@@ -227,6 +243,20 @@ namespace TrenchBroom {
             return result;
         }
 
+        std::shared_ptr<const TextLayout> TextureFont::layout(const AttrString& string) {
+            if (const auto it = m_layoutCache.find(string); it != std::end(m_layoutCache)) {
+                return it->second;
+            }
+
+            if (m_layoutCache.size() >= MaxCachedLayouts) {
+                m_layoutCache.clear();
+            }
+
+            auto result = std::make_shared<const TextLayout>(TextLayout{quads(string, true), measure(string)});
+            m_layoutCache.emplace(string, result);
+            return result;
+        }
+
         void TextureFont::activate() {
             m_texture->activate();
         }
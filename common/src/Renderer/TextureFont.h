@@ -20,28 +20,43 @@
 #pragma once
 
 #include "Macros.h"
+#include "Renderer/AttrString.h"
 
 #include <vecmath/forward.h>
 #include <vecmath/vec.h>
 
+#include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
     namespace Renderer {
-        class AttrString;
         class FontGlyph;
         class FontTexture;
 
+        /**
+         * The clockwise quads and the size of a string rendered with a texture font.
+         */
+        struct TextLayout {
+            std::vector<vm::vec2f> quads;
+            vm::vec2f size;
+        };
+
         class TextureFont {
         private:
+            static const size_t MaxCachedLayouts;
+
             std::unique_ptr<FontTexture> m_texture;
             std::vector<FontGlyph> m_glyphs;
             int m_lineHeight;
 
             unsigned char m_firstChar;
             unsigned char m_charCount;
+
+            std::map<AttrString, std::shared_ptr<const TextLayout>> m_layoutCache;
+            mutable std::unordered_map<std::string, vm::vec2f> m_measureCache;
         public:
             TextureFont(std::unique_ptr<FontTexture> texture, const std::vector<FontGlyph>& glyphs, int lineHeight, unsigned char firstChar, unsigned char charCount);
             ~TextureFont();
@@ -52,10 +67,23 @@ namespace TrenchBroom {
             vm::vec2f measure(const AttrString& string) const;
 
             std::vector<vm::vec2f> quads(const std::string& string, bool clockwise, const vm::vec2f& offset = vm::vec2f::zero()) const;
+
+            /**
+             * Returns the size of the given string. Sizes are cached because labels are measured repeatedly, e.g.
+             * when selecting a font size that fits a given width.
+             */
             vm::vec2f measure(const std::string& string) const;
 
+            /**
+             * Returns the layout of the given string. Layouts are cached, so that labels which are rendered every frame
+             * need not be laid out again. The returned layout remains valid even if the cache is cleared.
+             */
+            std::shared_ptr<const TextLayout> layout(const AttrString& string);
+
             void activate();
             void deactivate();
+        private:
+            vm::vec2f computeSize(const std::string& string) const;
         };
     }
 }
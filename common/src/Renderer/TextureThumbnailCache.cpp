@@ -0,0 +1,144 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextureThumbnailCache.h"
+
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+
+#include <vecmath/vec.h>
+
+#include <cassert>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        TextureThumbnailCache::TextureThumbnailCache() = default;
+
+        TextureThumbnailCache::~TextureThumbnailCache() {
+            clear();
+        }
+
+        bool TextureThumbnailCache::activate(const Assets::Texture& texture, const vm::vec2s& minSize) {
+            deleteUnusedTextures();
+
+            const auto it = m_thumbnails.find(&texture);
+            if (it != std::end(m_thumbnails)) {
+                auto& thumbnail = it->second;
+                if (thumbnail.size.x() >= minSize.x() && thumbnail.size.y() >= minSize.y()) {
+                    glAssert(glBindTexture(GL_TEXTURE_2D, thumbnail.textureId));
+                    return true;
+                }
+
+                // the thumbnail is too small
+                m_unusedTextureIds.push_back(thumbnail.textureId);
+                m_thumbnails.erase(it);
+                deleteUnusedTextures();
+            }
+
+            auto thumbnail = Thumbnail{0, vm::vec2s::zero()};
+            if (!createThumbnail(texture, minSize, thumbnail)) {
+                return false;
+            }
+
+            m_thumbnails.emplace(&texture, thumbnail);
+            glAssert(glBindTexture(GL_TEXTURE_2D, thumbnail.textureId));
+            return true;
+        }
+
+        void TextureThumbnailCache::deactivate() {
+            glAssert(glBindTexture(GL_TEXTURE_2D, 0));
+        }
+
+        void TextureThumbnailCache::invalidate() {
+            for (const auto& [texture, thumbnail] : m_thumbnails) {
+                m_unusedTextureIds.push_back(thumbnail.textureId);
+            }
+            m_thumbnails.clear();
+        }
+
+        void TextureThumbnailCache::clear() {
+            invalidate();
+            deleteUnusedTextures();
+        }
+
+        void TextureThumbnailCache::deleteUnusedTextures() {
+            if (!m_unusedTextureIds.empty()) {
+                glAssert(glDeleteTextures(static_cast<GLsizei>(m_unusedTextureIds.size()), m_unusedTextureIds.data()));
+                m_unusedTextureIds.clear();
+            }
+        }
+
+        bool TextureThumbnailCache::createThumbnail(const Assets::Texture& texture, const vm::vec2s& minSize, Thumbnail& thumbnail) {
+            if (texture.width() == 0 || texture.height() == 0) {
+                return false;
+            }
+
+            // once a texture has been uploaded, its buffers are released, and we use the full texture instead
+            const auto& buffers = texture.buffersIfUnprepared();
+            if (buffers.empty()) {
+                return false;
+            }
+
+            const auto fits = [&](const vm::vec2s& size) {
+                return size.x() >= minSize.x() && size.y() >= minSize.y();
+            };
+
+            // find the smallest mip level that is still large enough
+            auto level = size_t(0);
+            while (level + 1 < buffers.size() && fits(Assets::sizeAtMipLevel(texture.width(), texture.height(), level + 1))) {
+                ++level;
+            }
+
+            const auto format = texture.format();
+            auto size = Assets::sizeAtMipLevel(texture.width(), texture.height(), level);
+            const auto* buffer = &buffers[level];
+
+            // downsample the last level until it fits if the texture doesn't have enough mip levels
+            auto downsampled = Assets::TextureBuffer();
+            auto halfSize = Assets::sizeAtMipLevel(size.x(), size.y(), 1);
+            while (halfSize != size && fits(halfSize)) {
+                downsampled = Assets::downsampleBuffer(*buffer, size, format);
+                buffer = &downsampled;
+                size = halfSize;
+                halfSize = Assets::sizeAtMipLevel(size.x(), size.y(), 1);
+            }
+
+            GLuint textureId = 0;
+            glAssert(glGenTextures(1, &textureId));
+            assert(textureId > 0);
+
+            const auto filter = texture.masked() ? GL_NEAREST : GL_LINEAR;
+
+            glAssert(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+            glAssert(glBindTexture(GL_TEXTURE_2D, textureId));
+            glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter));
+            glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter));
+            glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+            glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+            glAssert(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA,
+                                  static_cast<GLsizei>(size.x()),
+                                  static_cast<GLsizei>(size.y()),
+                                  0, format, GL_UNSIGNED_BYTE, reinterpret_cast<const GLvoid*>(buffer->data())));
+            glAssert(glBindTexture(GL_TEXTURE_2D, 0));
+
+            thumbnail = Thumbnail{textureId, size};
+            return true;
+        }
+    }
+}
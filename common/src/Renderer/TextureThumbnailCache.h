@@ -0,0 +1,90 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Renderer/GL.h"
+
+#include <vecmath/vec.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        class Texture;
+    }
+
+    namespace Renderer {
+        /**
+         * Maintains small versions of textures for the texture browser, so that browsing a texture collection does
+         * not upload every texture at its full resolution.
+         *
+         * A thumbnail is created from the smallest mip level of a texture that is at least as large as the requested
+         * size. If a texture has no such mip level, its largest mip level is downsampled until it fits.
+         *
+         * All functions that create or delete thumbnails require the corresponding OpenGL context to be current.
+         */
+        class TextureThumbnailCache {
+        private:
+            struct Thumbnail {
+                GLuint textureId;
+                vm::vec2s size;
+            };
+
+            std::unordered_map<const Assets::Texture*, Thumbnail> m_thumbnails;
+            std::vector<GLuint> m_unusedTextureIds;
+        public:
+            TextureThumbnailCache();
+            ~TextureThumbnailCache();
+
+            TextureThumbnailCache(const TextureThumbnailCache&) = delete;
+            TextureThumbnailCache& operator=(const TextureThumbnailCache&) = delete;
+
+            /**
+             * Binds a thumbnail of the given texture that is at least the given size in pixels and creates it if
+             * necessary.
+             *
+             * If the texture has already been uploaded, no thumbnail is created because the full texture does not
+             * occupy any additional video memory. In that case, this function returns false and the caller should
+             * activate the texture itself.
+             *
+             * @param texture the texture
+             * @param minSize the minimum size of the thumbnail in pixels
+             * @return true if a thumbnail was bound and false otherwise
+             */
+            bool activate(const Assets::Texture& texture, const vm::vec2s& minSize);
+            void deactivate();
+
+            /**
+             * Discards all thumbnails. Their textures are deleted the next time a thumbnail is activated, so this
+             * function can be called while the OpenGL context is not current, e.g. when the textures change.
+             */
+            void invalidate();
+
+            /**
+             * Deletes all thumbnail textures immediately.
+             */
+            void clear();
+        private:
+            void deleteUnusedTextures();
+            static bool createThumbnail(const Assets::Texture& texture, const vm::vec2s& minSize, Thumbnail& thumbnail);
+        };
+    }
+}
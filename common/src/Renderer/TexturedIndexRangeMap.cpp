@@ -115,6 +115,18 @@ namespace TrenchBroom {
             }
         }
 
+        void TexturedIndexRangeMap::renderInstances(VertexArray& vertexArray, const size_t instanceCount, TextureRenderFunc& textureFunc, InstanceRenderFunc& func) {
+            for (const auto& [texture, indexArray] : *m_data) {
+                textureFunc.before(texture);
+                for (size_t i = 0; i < instanceCount; ++i) {
+                    func.before(i);
+                    indexArray.render(vertexArray);
+                    func.after(i);
+                }
+                textureFunc.after(texture);
+            }
+        }
+
         void TexturedIndexRangeMap::forEachPrimitive(std::function<void(const Texture*, PrimType, size_t, size_t)> func) const {
             for (const auto& entry : *m_data) {
                 const auto* texture = entry.first;
@@ -29,6 +29,7 @@ namespace TrenchBroom {
     }
 
     namespace Renderer {
+        class InstanceRenderFunc;
         class TextureRenderFunc;
         class VertexArray;
 
@@ -168,6 +169,19 @@ namespace TrenchBroom {
              */
             void render(VertexArray& vertexArray, TextureRenderFunc& func);
 
+            /**
+             * Renders the primitives stored in this index range map the given number of times using the vertices in
+             * the given vertex array. Each texture is activated once, and then the primitives associated with it are
+             * rendered for each instance. The given texture callbacks are invoked once per texture, and the given
+             * instance callbacks are invoked before and after each instance is rendered.
+             *
+             * @param vertexArray the vertex array to render with
+             * @param instanceCount the number of instances to render
+             * @param textureFunc the texture callbacks
+             * @param func the instance callbacks
+             */
+            void renderInstances(VertexArray& vertexArray, size_t instanceCount, TextureRenderFunc& textureFunc, InstanceRenderFunc& func);
+
             /**
              * Invokes the given function for each primitive stored in this map.
              *
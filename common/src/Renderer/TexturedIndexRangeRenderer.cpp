@@ -39,6 +39,10 @@ namespace TrenchBroom {
             return m_vertexArray.empty();
         }
 
+        size_t TexturedIndexRangeRenderer::sizeInBytes() const {
+            return m_vertexArray.sizeInBytes();
+        }
+
         void TexturedIndexRangeRenderer::prepare(VboManager& vboManager) {
             m_vertexArray.prepare(vboManager);
         }
@@ -57,6 +61,13 @@ namespace TrenchBroom {
             }
         }
 
+        void TexturedIndexRangeRenderer::renderInstances(const size_t instanceCount, TextureRenderFunc& textureFunc, InstanceRenderFunc& func) {
+            if (m_vertexArray.setup()) {
+                m_indexRange.renderInstances(m_vertexArray, instanceCount, textureFunc, func);
+                m_vertexArray.cleanup();
+            }
+        }
+
         MultiTexturedIndexRangeRenderer::MultiTexturedIndexRangeRenderer(std::vector<std::unique_ptr<TexturedIndexRangeRenderer>> renderers) :
         m_renderers(std::move(renderers)) {}
 
@@ -71,6 +82,14 @@ namespace TrenchBroom {
             return true;
         }
 
+        size_t MultiTexturedIndexRangeRenderer::sizeInBytes() const {
+            size_t result = 0u;
+            for (const auto& renderer : m_renderers) {
+                result += renderer->sizeInBytes();
+            }
+            return result;
+        }
+
         void MultiTexturedIndexRangeRenderer::prepare(VboManager& vboManager) {
             for (auto& renderer : m_renderers) {
                 renderer->prepare(vboManager);
@@ -88,5 +107,11 @@ namespace TrenchBroom {
                 renderer->render(func);
             }
         }
+
+        void MultiTexturedIndexRangeRenderer::renderInstances(const size_t instanceCount, TextureRenderFunc& textureFunc, InstanceRenderFunc& func) {
+            for (auto& renderer : m_renderers) {
+                renderer->renderInstances(instanceCount, textureFunc, func);
+            }
+        }
     }
 }
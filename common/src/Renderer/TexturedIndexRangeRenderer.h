@@ -31,6 +31,7 @@ namespace TrenchBroom {
     }
 
     namespace Renderer {
+        class InstanceRenderFunc;
         class VboManager;
         class TextureRenderFunc;
 
@@ -40,9 +41,21 @@ namespace TrenchBroom {
 
             virtual bool empty() const = 0;
 
+            /**
+             * Returns the size in bytes of the vertex data rendered by this renderer.
+             */
+            virtual size_t sizeInBytes() const = 0;
+
             virtual void prepare(VboManager& vboManager) = 0;
             virtual void render() = 0;
             virtual void render(TextureRenderFunc& func) = 0;
+
+            /**
+             * Renders the given number of instances, setting up the vertices and textures only once. The given
+             * texture callbacks are invoked around each texture, and the instance callbacks are invoked around each
+             * instance, e.g. to set its transformation.
+             */
+            virtual void renderInstances(size_t instanceCount, TextureRenderFunc& textureFunc, InstanceRenderFunc& func) = 0;
         };
 
         class TexturedIndexRangeRenderer : public TexturedRenderer {
@@ -56,10 +69,12 @@ namespace TrenchBroom {
             ~TexturedIndexRangeRenderer() override;
 
             bool empty() const override;
+            size_t sizeInBytes() const override;
 
             void prepare(VboManager& vboManager) override;
             void render() override;
             void render(TextureRenderFunc& func) override;
+            void renderInstances(size_t instanceCount, TextureRenderFunc& textureFunc, InstanceRenderFunc& func) override;
         };
 
         class MultiTexturedIndexRangeRenderer : public TexturedRenderer {
@@ -70,10 +85,12 @@ namespace TrenchBroom {
             ~MultiTexturedIndexRangeRenderer() override;
 
             bool empty() const override;
+            size_t sizeInBytes() const override;
 
             void prepare(VboManager& vboManager) override;
             void render() override;
             void render(TextureRenderFunc& func) override;
+            void renderInstances(size_t instanceCount, TextureRenderFunc& textureFunc, InstanceRenderFunc& func) override;
         };
     }
 }
@@ -22,12 +22,18 @@
 #include "Ensure.h"
 
 #include <cassert>
+#include <cstring>
 
 namespace TrenchBroom {
     namespace Renderer {
         Vbo::Vbo(GLenum type, const size_t capacity, const GLenum usage) :
         m_type(type),
-        m_capacity(capacity) {
+        m_capacity(capacity),
+        m_mapping(nullptr),
+        m_vboManager(nullptr),
+        m_region(0u),
+        m_regionFrames{},
+        m_recyclable(false) {
             assert(m_type == GL_ELEMENT_ARRAY_BUFFER
                    || m_type == GL_ARRAY_BUFFER);
 
@@ -36,8 +42,40 @@ namespace TrenchBroom {
             glAssert(glBufferData(m_type, static_cast<GLsizeiptr>(m_capacity), nullptr, usage));
         }
 
+        Vbo::Vbo(GLenum type, const size_t capacity, VboManager* vboManager) :
+        m_type(type),
+        m_capacity(capacity),
+        m_mapping(nullptr),
+        m_vboManager(vboManager),
+        m_region(0u),
+        m_regionFrames{},
+        m_recyclable(false) {
+            assert(m_type == GL_ELEMENT_ARRAY_BUFFER
+                   || m_type == GL_ARRAY_BUFFER);
+            assert(m_vboManager != nullptr);
+
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            const auto size = static_cast<GLsizeiptr>(m_capacity * RegionCount);
+            m_regionFrames[m_region] = m_vboManager->currentFrame();
+
+            glAssert(glGenBuffers(1, &m_bufferId));
+            glAssert(glBindBuffer(m_type, m_bufferId));
+            glAssert(glBufferStorage(m_type, size, nullptr, flags));
+            if (m_capacity > 0) {
+                GLvoid* mapping = nullptr;
+                glAssert(mapping = glMapBufferRange(m_type, 0, size, flags));
+                ensure(mapping != nullptr, "failed to map buffer");
+                m_mapping = static_cast<unsigned char*>(mapping);
+            }
+        }
+
         void Vbo::free() {
             assert(m_bufferId != 0);
+            if (m_mapping != nullptr) {
+                glAssert(glBindBuffer(m_type, m_bufferId));
+                glAssert(glUnmapBuffer(m_type));
+                m_mapping = nullptr;
+            }
             glAssert(glDeleteBuffers(1, &m_bufferId));
             m_bufferId = 0;
         }
@@ -47,13 +85,21 @@ namespace TrenchBroom {
         }
 
         size_t Vbo::offset() const {
-            return 0;
+            return m_region * m_capacity;
         }
 
         size_t Vbo::capacity() const {
             return m_capacity;
         }
 
+        size_t Vbo::size() const {
+            return m_mapping != nullptr ? m_capacity * RegionCount : m_capacity;
+        }
+
+        bool Vbo::persistentlyMapped() const {
+            return m_mapping != nullptr;
+        }
+
         void Vbo::bind() {
             assert(m_bufferId != 0);
             glAssert(glBindBuffer(m_type, m_bufferId));
@@ -63,5 +109,32 @@ namespace TrenchBroom {
             assert(m_bufferId != 0);
             glAssert(glBindBuffer(m_type, 0));
         }
+
+        size_t Vbo::region() const {
+            return m_region;
+        }
+
+        bool Vbo::advanceRegion() {
+            if (m_mapping == nullptr) {
+                return false;
+            }
+
+            const auto currentFrame = m_vboManager->currentFrame();
+            if (m_regionFrames[m_region] == currentFrame) {
+                return false;
+            }
+
+            // the current region was read by the draw calls of the previous frame at the latest
+            m_regionFrames[m_region] = currentFrame - 1u;
+            m_region = (m_region + 1u) % RegionCount;
+            m_vboManager->waitForFrame(m_regionFrames[m_region]);
+            m_regionFrames[m_region] = currentFrame;
+            return true;
+        }
+
+        void Vbo::writeMapped(const size_t address, const GLvoid* ptr, const size_t size) {
+            assert(m_mapping != nullptr);
+            std::memcpy(m_mapping + offset() + address, ptr, size);
+        }
     }
 }
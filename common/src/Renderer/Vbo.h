@@ -21,6 +21,7 @@
 
 #include "Renderer/VboManager.h"
 
+#include <array>
 #include <cassert>
 #include <vector>
 #include <type_traits>
@@ -31,6 +32,12 @@ namespace TrenchBroom {
          * Wrapper around an OpenGL buffer
          */
         class Vbo {
+        public:
+            /**
+             * The number of regions of a persistently mapped buffer. Each region holds a complete copy of the buffer's
+             * contents so that the CPU can write to one region while the GPU still reads from the others.
+             */
+            static const size_t RegionCount = 3u;
         private:
             friend class VboManager;
 
@@ -41,11 +48,38 @@ namespace TrenchBroom {
             size_t m_capacity;
             GLuint m_bufferId;
 
+            /**
+             * If this buffer is persistently mapped, these point to the mapped memory and to the manager whose fences
+             * must be waited for before writing to a region. Otherwise, both are null.
+             */
+            unsigned char* m_mapping;
+            VboManager* m_vboManager;
+            /**
+             * The region of a persistently mapped buffer that is written to and read by draw calls.
+             */
+            size_t m_region;
+            /**
+             * For the current region, the frame in which it became current. For all other regions, the last frame in
+             * which draw calls may have read it.
+             */
+            std::array<size_t, RegionCount> m_regionFrames;
+            /**
+             * Whether this buffer may be recycled by the VBO manager when it is destroyed.
+             */
+            bool m_recyclable;
+
             /**
              * Immediately creates and binds to a buffer of the given type and capacity.
              * The contents are initially unspecified.
              */
             Vbo(GLenum type, size_t capacity, GLenum usage);
+
+            /**
+             * Immediately creates and binds to an immutable buffer with RegionCount regions of the given type and
+             * capacity, and maps it persistently and coherently for writing. Requires ARB_buffer_storage.
+             * The contents are initially unspecified.
+             */
+            Vbo(GLenum type, size_t capacity, VboManager* vboManager);
             ~Vbo();
 
             /**
@@ -57,10 +91,31 @@ namespace TrenchBroom {
 
         public:
             /**
-             * Deprecated, always returns 0.
+             * Returns the byte offset of the current region, which is always 0 unless this buffer is persistently
+             * mapped. Draw calls must add this offset to their vertex and index offsets.
              */
             size_t offset() const;
+            /**
+             * Returns the capacity of a region.
+             */
             size_t capacity() const;
+            /**
+             * Returns the number of bytes that were allocated for all regions.
+             */
+            size_t size() const;
+            bool persistentlyMapped() const;
+
+            size_t region() const;
+
+            /**
+             * If this buffer is persistently mapped, makes the next region current once the GPU has finished reading
+             * it, and returns true. The new region does not contain the writes that were made to the other regions
+             * since it was last current, so the caller must write them again.
+             *
+             * Returns false and keeps the current region if this buffer is not persistently mapped, or if the current
+             * region became current in this frame, in which case no draw call has read it yet.
+             */
+            bool advanceRegion();
 
             void bind();
             void unbind();
@@ -93,13 +148,19 @@ namespace TrenchBroom {
                 static_assert(std::is_standard_layout<T>::value);
 
                 const GLvoid* ptr = static_cast<const GLvoid*>(array);
-                const GLintptr offset = static_cast<GLintptr>(address);
-                const GLsizeiptr sizei = static_cast<GLsizeiptr>(size);
-                glAssert(glBindBuffer(m_type, m_bufferId));
-                glAssert(glBufferSubData(m_type, offset, sizei, ptr));
+                if (m_mapping != nullptr) {
+                    writeMapped(address, ptr, size);
+                } else {
+                    const GLintptr offset = static_cast<GLintptr>(address);
+                    const GLsizeiptr sizei = static_cast<GLsizeiptr>(size);
+                    glAssert(glBindBuffer(m_type, m_bufferId));
+                    glAssert(glBufferSubData(m_type, offset, sizei, ptr));
+                }
 
                 return size;
             }
+        private:
+            void writeMapped(size_t address, const GLvoid* ptr, size_t size);
         };
     }
 }
@@ -24,6 +24,7 @@
 #include "Macros.h"
 
 #include <algorithm> // for std::max
+#include <cassert>
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -50,18 +51,132 @@ namespace TrenchBroom {
             }
         }
 
+        // the capacities of recyclable buffers are rounded up to powers of two between these bounds so that buffers
+        // of similar sizes can be reused for each other
+        static const size_t MinRecyclableVboCapacity = 1024u;
+        static const size_t MaxRecyclableVboCapacity = 64u * 1024u;
+        // the maximum total capacity of the buffers that are kept for reuse
+        static const size_t MaxPooledVboSize = 16u * 1024u * 1024u;
+
+        static size_t recyclableVboCapacity(const size_t capacity) {
+            auto result = MinRecyclableVboCapacity;
+            while (result < capacity) {
+                result *= 2u;
+            }
+            return result;
+        }
+
         // VboManager
 
         VboManager::VboManager(ShaderManager* shaderManager) :
         m_peakVboCount(0u),
         m_currentVboCount(0u),
         m_currentVboSize(0u),
-        m_shaderManager(shaderManager) {}
+        m_shaderManager(shaderManager),
+        m_persistentMapping(false),
+        m_currentFrame(1u),
+        m_pooledVboSize(0u) {}
+
+        VboManager::~VboManager() {
+            assert(m_fences.empty());
+            assert(m_releasedVbos.empty());
+            assert(m_pooledVboSize == 0u);
+        }
+
+        void VboManager::setPersistentMapping(const bool persistentMapping) {
+            m_persistentMapping = persistentMapping && GLEW_ARB_buffer_storage;
+        }
+
+        bool VboManager::persistentMapping() const {
+            return m_persistentMapping;
+        }
+
+        static bool fenceSignaled(GLsync fence) {
+            GLenum result = GL_TIMEOUT_EXPIRED;
+            glAssert(result = glClientWaitSync(fence, 0, 0));
+            return result != GL_TIMEOUT_EXPIRED;
+        }
+
+        static void waitForFence(GLsync fence) {
+            // flush the command queue with the first wait, otherwise the fence might never be signaled
+            static const GLuint64 Timeout = 1000000000u; // one second in nanoseconds
+            GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+            GLenum result = GL_TIMEOUT_EXPIRED;
+            while (result == GL_TIMEOUT_EXPIRED) {
+                glAssert(result = glClientWaitSync(fence, flags, Timeout));
+                flags = 0;
+            }
+        }
+
+        void VboManager::insertFence() {
+            if (m_persistentMapping) {
+                // drop the fences of the frames that have already completed so that the queue doesn't grow
+                while (!m_fences.empty() && fenceSignaled(m_fences.front().second)) {
+                    glAssert(glDeleteSync(m_fences.front().second));
+                    m_fences.pop_front();
+                }
+
+                GLsync fence = nullptr;
+                glAssert(fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+                m_fences.emplace_back(m_currentFrame, fence);
+            }
+            ++m_currentFrame;
+        }
+
+        size_t VboManager::currentFrame() const {
+            return m_currentFrame;
+        }
+
+        void VboManager::waitForFrame(const size_t frame) {
+            // the fences are ordered by frame, and a fence is only signaled once all earlier commands have completed
+            while (!m_fences.empty() && m_fences.front().first <= frame) {
+                waitForFence(m_fences.front().second);
+                glAssert(glDeleteSync(m_fences.front().second));
+                m_fences.pop_front();
+            }
+        }
+
+        void VboManager::releaseResources() {
+            waitForFrame(m_currentFrame);
+
+            recycleReleasedVbos();
+            for (auto& [key, vbos] : m_availableVbos) {
+                for (auto* vbo : vbos) {
+                    deleteVbo(vbo);
+                }
+            }
+            m_availableVbos.clear();
+            m_pooledVboSize = 0u;
+        }
+
+        void VboManager::recycleReleasedVbos() {
+            for (auto* vbo : m_releasedVbos) {
+                m_availableVbos[{vbo->m_type, vbo->m_capacity}].push_back(vbo);
+            }
+            m_releasedVbos.clear();
+        }
 
         Vbo* VboManager::allocateVbo(VboType type, const size_t capacity, const VboUsage usage) {
-            auto* result = new Vbo(typeToOpenGL(type), capacity, usageToOpenGL(usage));
+            Vbo* result = nullptr;
+            if (usage == VboUsage::StaticDraw && capacity <= MaxRecyclableVboCapacity) {
+                const auto recyclableCapacity = recyclableVboCapacity(capacity);
+                auto& available = m_availableVbos[{typeToOpenGL(type), recyclableCapacity}];
+                if (!available.empty()) {
+                    result = available.back();
+                    available.pop_back();
+                    m_pooledVboSize -= recyclableCapacity;
+                    result->bind();
+                } else {
+                    result = new Vbo(typeToOpenGL(type), recyclableCapacity, usageToOpenGL(usage));
+                    result->m_recyclable = true;
+                }
+            } else {
+                result = m_persistentMapping && usage == VboUsage::DynamicDraw
+                    ? new Vbo(typeToOpenGL(type), capacity, this)
+                    : new Vbo(typeToOpenGL(type), capacity, usageToOpenGL(usage));
+            }
 
-            m_currentVboSize += capacity;
+            m_currentVboSize += result->size();
             m_currentVboCount++;
             m_peakVboCount = std::max(m_peakVboCount, m_currentVboCount);
 
@@ -69,11 +184,15 @@ namespace TrenchBroom {
         }
 
         void VboManager::destroyVbo(Vbo* vbo) {
-            m_currentVboSize -= vbo->capacity();
+            m_currentVboSize -= vbo->size();
             m_currentVboCount--;
 
-            vbo->free();
-            delete vbo;
+            if (vbo->m_recyclable && m_pooledVboSize + vbo->capacity() <= MaxPooledVboSize) {
+                m_pooledVboSize += vbo->capacity();
+                m_releasedVbos.push_back(vbo);
+            } else {
+                deleteVbo(vbo);
+            }
         }
 
         size_t VboManager::peakVboCount() const {
@@ -88,8 +207,17 @@ namespace TrenchBroom {
             return m_currentVboSize;
         }
 
+        size_t VboManager::pooledVboSize() const {
+            return m_pooledVboSize;
+        }
+
         ShaderManager& VboManager::shaderManager() {
             return *m_shaderManager;
         }
+
+        void VboManager::deleteVbo(Vbo* vbo) {
+            vbo->free();
+            delete vbo;
+        }
     }
 }
@@ -22,6 +22,10 @@
 #include "Renderer/GL.h"
 
 #include <cstddef> // for size_t
+#include <deque>
+#include <map>
+#include <utility>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -44,8 +48,68 @@ namespace TrenchBroom {
             size_t m_currentVboCount;
             size_t m_currentVboSize;
             ShaderManager* m_shaderManager;
+
+            bool m_persistentMapping;
+
+            /**
+             * Counts the frames, i.e. the calls to insertFence. Persistently mapped buffers record the frames in which
+             * their regions were read so that they only wait for the fences of these frames.
+             */
+            size_t m_currentFrame;
+            std::deque<std::pair<size_t, GLsync>> m_fences;
+
+            /**
+             * Small static buffers are recycled instead of being deleted, because many vertex and index arrays only
+             * live for one frame. Buffers that are released during a frame may still be read by its draw calls, so
+             * they become available for reuse only once the frame has ended.
+             */
+            std::vector<Vbo*> m_releasedVbos;
+            std::map<std::pair<GLenum, size_t>, std::vector<Vbo*>> m_availableVbos;
+            size_t m_pooledVboSize;
         public:
             explicit VboManager(ShaderManager* shaderManager);
+            ~VboManager();
+
+            /**
+             * Specifies whether dynamic buffers should be allocated as persistently mapped buffers. Writing to such
+             * buffers is a plain memory copy rather than a call to glBufferSubData. Has no effect unless
+             * ARB_buffer_storage is supported.
+             *
+             * Only affects buffers that are allocated after calling this method.
+             */
+            void setPersistentMapping(bool persistentMapping);
+            bool persistentMapping() const;
+
+            /**
+             * Ends the current frame by inserting a fence after all commands that were issued so far. Before a
+             * persistently mapped buffer writes to a region that was read in this frame, it waits until this fence
+             * is signaled so that it doesn't overwrite data that is still being read by pending draw calls.
+             */
+            void insertFence();
+
+            /**
+             * Returns the number of the current frame.
+             */
+            size_t currentFrame() const;
+
+            /**
+             * Waits until the commands of the given frame have completed. Returns immediately if the fence of that
+             * frame was already found to be signaled.
+             */
+            void waitForFrame(size_t frame);
+
+            /**
+             * Waits for all pending fences and frees them along with the buffers that are kept for reuse. Must be
+             * called while an OpenGL context is current, before this manager is destroyed.
+             */
+            void releaseResources();
+
+            /**
+             * Makes the buffers that were released since the last call available for reuse. Call this after the
+             * draw calls of a frame have been issued.
+             */
+            void recycleReleasedVbos();
+
             /**
             * Immediately creates and binds to an OpenGL buffer of the given type and capacity.
             * The contents are initially unspecified. See Vbo class.
@@ -53,11 +117,18 @@ namespace TrenchBroom {
             Vbo* allocateVbo(VboType type, size_t capacity, VboUsage usage = VboUsage::StaticDraw);
             void destroyVbo(Vbo* vbo);
 
+            /**
+             * Returns the total capacity of the buffers that are kept for reuse.
+             */
+            size_t pooledVboSize() const;
+
             size_t peakVboCount() const;
             size_t currentVboCount() const;
             size_t currentVboSize() const;
 
             ShaderManager& shaderManager();
+        private:
+            static void deleteVbo(Vbo* vbo);
         };
     }
 }
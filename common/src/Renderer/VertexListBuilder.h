@@ -162,7 +162,9 @@ namespace TrenchBroom {
 
                 const size_t index = currentIndex();
                 const size_t count = vertices.size();
-                m_vertices = kdl::vec_concat(std::move(m_vertices), vertices);
+                // vec_concat would copy the given vertices and reserve the exact size, which makes growing the list
+                // quadratic, therefore we rely on the vector's geometric growth
+                m_vertices.insert(std::end(m_vertices), std::begin(vertices), std::end(vertices));
 
                 return Range(index, count);
             }
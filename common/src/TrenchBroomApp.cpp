@@ -19,6 +19,7 @@
 
 #include "TrenchBroomApp.h"
 
+#include "FileLogger.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "RecoverableExceptions.h"
@@ -500,7 +501,8 @@ namespace TrenchBroom {
                 mapPath = IO::Path();
             }
 
-            // Copy the log file
+            // Copy the log file, including the messages which have not been written yet
+            FileLogger::instance().flush();
             if (!QFile::copy(IO::pathAsQString(IO::SystemPaths::logFilePath()), QString::fromStdString(logPath.asString()))) {
                 logPath = IO::Path();
             }
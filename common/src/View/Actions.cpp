@@ -1554,6 +1554,13 @@ namespace TrenchBroom {
                 [](ActionExecutionContext& context) {
                     return context.hasDocument();
                 }));
+            debugMenu.addItem(createMenuAction(IO::Path("Menu/Debug/Print Allocation Counts"), QObject::tr("Print Allocation Counts to Console"), 0,
+                [](ActionExecutionContext& context) {
+                    context.frame()->debugPrintAllocationCounts();
+                },
+                [](ActionExecutionContext& context) {
+                    return context.hasDocument();
+                }));
             debugMenu.addItem(createMenuAction(IO::Path("Menu/Debug/Create Brush..."), QObject::tr("Create Brush..."), 0,
                 [](ActionExecutionContext& context) {
                     context.frame()->debugCreateBrush();
@@ -1633,6 +1640,13 @@ namespace TrenchBroom {
                 [](ActionExecutionContext&) {
                     return true;
                 }));
+            helpMenu.addItem(createMenuAction(IO::Path("Menu/Help/Export Performance Trace..."), QObject::tr("Export Performance Trace..."), 0,
+                [](ActionExecutionContext& context) {
+                    context.frame()->exportPerformanceTrace();
+                },
+                [](ActionExecutionContext& context) {
+                    return context.hasDocument();
+                }));
         }
 
         Menu& ActionManager::createMainMenu(const std::string& name) {
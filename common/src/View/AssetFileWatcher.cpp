@@ -0,0 +1,127 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AssetFileWatcher.h"
+
+#include "IO/PathQt.h"
+#include "View/MapDocument.h"
+
+#include <kdl/memory_utils.h>
+
+#include <QFileSystemWatcher>
+#include <QStringList>
+#include <QTimer>
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        static const int ReloadDelayMs = 500;
+
+        AssetFileWatcher::AssetFileWatcher(std::weak_ptr<MapDocument> document, QObject* parent) :
+        QObject(parent),
+        m_document(std::move(document)),
+        m_watcher(new QFileSystemWatcher(this)),
+        m_reloadTimer(new QTimer(this)) {
+            m_reloadTimer->setSingleShot(true);
+            m_reloadTimer->setInterval(ReloadDelayMs);
+
+            connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &AssetFileWatcher::fileDidChange);
+            connect(m_reloadTimer, &QTimer::timeout, this, &AssetFileWatcher::reloadChangedAssets);
+
+            connectObservers();
+            updateWatchedFiles();
+        }
+
+        void AssetFileWatcher::connectObservers() {
+            auto document = kdl::mem_lock(m_document);
+            m_notifierConnection += document->documentWasNewedNotifier.connect(this, &AssetFileWatcher::documentDidChange);
+            m_notifierConnection += document->documentWasLoadedNotifier.connect(this, &AssetFileWatcher::documentDidChange);
+            m_notifierConnection += document->documentWasClearedNotifier.connect(this, &AssetFileWatcher::documentDidChange);
+            m_notifierConnection += document->textureCollectionsDidChangeNotifier.connect(this, &AssetFileWatcher::assetsDidChange);
+            m_notifierConnection += document->entityDefinitionsDidChangeNotifier.connect(this, &AssetFileWatcher::assetsDidChange);
+        }
+
+        void AssetFileWatcher::documentDidChange(MapDocument*) {
+            m_changedFilePaths.clear();
+            m_reloadTimer->stop();
+            updateWatchedFiles();
+        }
+
+        void AssetFileWatcher::assetsDidChange() {
+            updateWatchedFiles();
+        }
+
+        void AssetFileWatcher::updateWatchedFiles() {
+            const auto watchedFiles = m_watcher->files();
+            if (!watchedFiles.isEmpty()) {
+                m_watcher->removePaths(watchedFiles);
+            }
+
+            m_entityDefinitionFilePath = IO::Path();
+            m_textureCollectionFilePaths.clear();
+
+            auto document = kdl::mem_lock(m_document);
+            if (document->world() == nullptr) {
+                return;
+            }
+
+            m_entityDefinitionFilePath = document->entityDefinitionFilePath();
+            if (!m_entityDefinitionFilePath.isEmpty()) {
+                m_watcher->addPath(IO::pathAsQString(m_entityDefinitionFilePath));
+            }
+
+            for (const auto& [collectionPath, filePath] : document->textureCollectionFilePaths()) {
+                m_textureCollectionFilePaths.emplace(filePath, collectionPath);
+                m_watcher->addPath(IO::pathAsQString(filePath));
+            }
+        }
+
+        void AssetFileWatcher::fileDidChange(const QString& path) {
+            m_changedFilePaths.insert(IO::pathFromQString(path));
+            m_reloadTimer->start();
+        }
+
+        void AssetFileWatcher::reloadChangedAssets() {
+            auto changedFilePaths = std::set<IO::Path>{};
+            std::swap(changedFilePaths, m_changedFilePaths);
+
+            auto textureCollectionsToReload = std::vector<IO::Path>{};
+            auto reloadEntityDefinitions = false;
+            for (const auto& path : changedFilePaths) {
+                if (path == m_entityDefinitionFilePath) {
+                    reloadEntityDefinitions = true;
+                } else if (const auto it = m_textureCollectionFilePaths.find(path); it != std::end(m_textureCollectionFilePaths)) {
+                    textureCollectionsToReload.push_back(it->second);
+                }
+            }
+
+            auto document = kdl::mem_lock(m_document);
+            if (!textureCollectionsToReload.empty()) {
+                document->reloadTextureCollections(textureCollectionsToReload);
+            }
+            if (reloadEntityDefinitions) {
+                document->reloadEntityDefinitions();
+            }
+
+            // files that were replaced rather than modified in place are no longer watched
+            updateWatchedFiles();
+        }
+    }
+}
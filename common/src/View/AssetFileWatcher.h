@@ -0,0 +1,70 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "NotifierConnection.h"
+#include "IO/Path.h"
+
+#include <QObject>
+
+#include <map>
+#include <memory>
+#include <set>
+
+class QFileSystemWatcher;
+class QString;
+class QTimer;
+
+namespace TrenchBroom {
+    namespace View {
+        class MapDocument;
+
+        /**
+         * Watches the entity definition file and the texture collection files of a document. When any of these files
+         * change on disk, only the affected assets are reloaded. Changes are collected for a short while before
+         * reloading because editors tend to write files in several steps.
+         */
+        class AssetFileWatcher : public QObject {
+            Q_OBJECT
+        private:
+            std::weak_ptr<MapDocument> m_document;
+            QFileSystemWatcher* m_watcher;
+            QTimer* m_reloadTimer;
+
+            IO::Path m_entityDefinitionFilePath;
+            // maps the absolute file paths to the paths of the texture collections
+            std::map<IO::Path, IO::Path> m_textureCollectionFilePaths;
+
+            std::set<IO::Path> m_changedFilePaths;
+
+            NotifierConnection m_notifierConnection;
+        public:
+            explicit AssetFileWatcher(std::weak_ptr<MapDocument> document, QObject* parent = nullptr);
+        private:
+            void connectObservers();
+            void documentDidChange(MapDocument* document);
+            void assetsDidChange();
+
+            void updateWatchedFiles();
+            void fileDidChange(const QString& path);
+            void reloadChangedAssets();
+        };
+    }
+}
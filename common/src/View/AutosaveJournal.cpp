@@ -0,0 +1,262 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AutosaveJournal.h"
+
+#include "Exceptions.h"
+#include "IO/DiskIO.h"
+#include "IO/IOUtils.h"
+#include "IO/MapCache.h"
+
+#include <kdl/string_compare.h>
+#include <kdl/string_utils.h>
+
+#include <fmt/format.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+#include <utility>
+
+namespace TrenchBroom {
+    namespace View {
+        static const std::string_view JournalMagic = "TBJOURNAL 1";
+
+        AutosaveJournal::AutosaveJournal(IO::Path path) :
+        m_path(std::move(path)) {}
+
+        const IO::Path& AutosaveJournal::path() const {
+            return m_path;
+        }
+
+        bool AutosaveJournal::started() const {
+            // the header block is always recorded, even if it is empty
+            return !m_blockHashes.empty();
+        }
+
+        void AutosaveJournal::writeCheckpoint(const std::string_view mapText) {
+            write(mapText, true);
+        }
+
+        void AutosaveJournal::append(const std::string_view mapText) {
+            write(mapText, !started());
+        }
+
+        static std::string_view trimLineEnd(std::string_view line) {
+            while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) {
+                line.remove_suffix(1u);
+            }
+            return line;
+        }
+
+        std::vector<std::vector<std::string_view>> AutosaveJournal::splitBlocks(const std::string_view mapText) {
+            auto result = std::vector<std::vector<std::string_view>>{};
+            result.push_back({mapText}); // the header, unless an entity is found
+
+            auto inHeader = true;
+            auto depth = size_t(0);
+            auto propertiesStart = std::optional<size_t>{};
+            auto childStart = size_t(0);
+            auto pos = size_t(0);
+            while (pos < mapText.size()) {
+                const auto eol = mapText.find('\n', pos);
+                const auto lineEnd = eol == std::string_view::npos ? mapText.size() : eol + 1u;
+                const auto line = trimLineEnd(mapText.substr(pos, lineEnd - pos));
+
+                if (depth == 0u) {
+                    if (inHeader && (line == "{" || kdl::cs::str_is_prefix(line, "// entity "))) {
+                        result.front().front() = mapText.substr(0u, pos);
+                        inHeader = false;
+                    }
+                    if (line == "{") {
+                        result.emplace_back();
+                        propertiesStart = lineEnd;
+                        depth = 1u;
+                    }
+                } else if (depth == 1u) {
+                    const auto isChild = line == "{" || kdl::cs::str_is_prefix(line, "// brush ");
+                    if (propertiesStart && (isChild || line == "}")) {
+                        result.back().push_back(mapText.substr(*propertiesStart, pos - *propertiesStart));
+                        propertiesStart = std::nullopt;
+                    }
+                    if (line == "{") {
+                        childStart = pos;
+                        depth = 2u;
+                    } else if (line == "}") {
+                        depth = 0u;
+                    }
+                } else {
+                    if (line == "{") {
+                        ++depth;
+                    } else if (line == "}" && --depth == 1u) {
+                        result.back().push_back(mapText.substr(childStart, lineEnd - childStart));
+                    }
+                }
+
+                pos = lineEnd;
+            }
+
+            return result;
+        }
+
+        void AutosaveJournal::write(const std::string_view mapText, const bool checkpoint) {
+            if (checkpoint) {
+                m_blockHashes.clear();
+            }
+
+            auto data = std::string{};
+            if (checkpoint) {
+                fmt::format_to(std::back_inserter(data), "{}\n", JournalMagic);
+            }
+
+            // the state lists the hashes of the blocks of one entity per line, so the blocks are written first
+            const auto entities = splitBlocks(mapText);
+            auto state = std::string{};
+            fmt::format_to(std::back_inserter(state), "S {}\n", entities.size());
+            for (const auto& blocks : entities) {
+                for (size_t i = 0u; i < blocks.size(); ++i) {
+                    const auto& block = blocks[i];
+                    const auto hash = IO::MapCache::hashSource(block);
+                    if (m_blockHashes.insert(hash).second) {
+                        fmt::format_to(std::back_inserter(data), "B {:016x} {}\n", hash, block.size());
+                        data.append(block);
+                        data.push_back('\n');
+                    }
+                    fmt::format_to(std::back_inserter(state), i == 0u ? "{:016x}" : " {:016x}", hash);
+                }
+                state.push_back('\n');
+            }
+            data.append(state);
+            data.append("E\n");
+
+            try {
+                // a checkpoint replaces the journal only once it was written completely
+                const auto filePath = checkpoint ? m_path.addExtension("tmp") : m_path;
+                const auto mode = std::ios::binary | (checkpoint ? std::ios::out | std::ios::trunc : std::ios::app);
+                {
+                    auto stream = IO::openPathAsOutputStream(filePath, mode);
+                    if (!stream.write(data.data(), static_cast<std::streamsize>(data.size())).flush()) {
+                        throw FileSystemException("Could not write autosave journal '" + filePath.asString() + "'");
+                    }
+                }
+                if (checkpoint) {
+                    IO::Disk::moveFile(filePath, m_path, true);
+                }
+            } catch (const FileSystemException&) {
+                // the journal file may be inconsistent with the recorded hashes, so start over the next time
+                m_blockHashes.clear();
+                throw;
+            }
+        }
+
+        static std::optional<std::string_view> readLine(const std::string_view data, size_t& pos) {
+            const auto eol = data.find('\n', pos);
+            if (eol == std::string_view::npos) {
+                return std::nullopt;
+            }
+            const auto line = data.substr(pos, eol - pos);
+            pos = eol + 1u;
+            return line;
+        }
+
+        static std::optional<uint64_t> parseHash(const std::string_view str) {
+            if (str.size() != 16u) {
+                return std::nullopt;
+            }
+            const auto s = std::string{str};
+            char* end = nullptr;
+            const auto hash = std::strtoull(s.c_str(), &end, 16);
+            if (end != s.c_str() + s.size()) {
+                return std::nullopt;
+            }
+            return static_cast<uint64_t>(hash);
+        }
+
+        std::optional<std::string> AutosaveJournal::recover(const std::string_view journalData) {
+            auto pos = size_t(0);
+            if (readLine(journalData, pos) != JournalMagic) {
+                return std::nullopt;
+            }
+
+            auto blocks = std::unordered_map<uint64_t, std::string_view>{};
+            auto result = std::optional<std::string>{};
+
+            // stop at the first record that is incomplete or malformed, it was not written completely
+            while (const auto line = readLine(journalData, pos)) {
+                if (kdl::cs::str_is_prefix(*line, "B ")) {
+                    const auto separator = line->find(' ', 2u);
+                    if (separator == std::string_view::npos) {
+                        break;
+                    }
+                    const auto hash = parseHash(line->substr(2u, separator - 2u));
+                    const auto size = kdl::str_to_size(std::string{line->substr(separator + 1u)});
+                    if (!hash || !size || pos + *size >= journalData.size() || journalData[pos + *size] != '\n') {
+                        break;
+                    }
+                    blocks[*hash] = journalData.substr(pos, *size);
+                    pos += *size + 1u;
+                } else if (kdl::cs::str_is_prefix(*line, "S ")) {
+                    const auto count = kdl::str_to_size(std::string{line->substr(2u)});
+                    if (!count || *count == 0u) {
+                        break;
+                    }
+
+                    auto state = std::string{};
+                    auto complete = true;
+                    for (size_t i = 0u; i < *count && complete; ++i) {
+                        const auto entityLine = readLine(journalData, pos);
+                        const auto hashes = entityLine ? kdl::str_split(*entityLine, " ") : std::vector<std::string>{};
+                        if (hashes.empty() || (i == 0u && hashes.size() != 1u)) {
+                            complete = false;
+                            break;
+                        }
+
+                        if (i > 0u) {
+                            fmt::format_to(std::back_inserter(state), "// entity {}\n{{\n", i - 1u);
+                        }
+                        for (size_t j = 0u; j < hashes.size() && complete; ++j) {
+                            const auto hash = parseHash(hashes[j]);
+                            const auto it = hash ? blocks.find(*hash) : blocks.end();
+                            if (it == blocks.end()) {
+                                complete = false;
+                            } else {
+                                if (j > 0u) {
+                                    fmt::format_to(std::back_inserter(state), "// brush {}\n", j - 1u);
+                                }
+                                state.append(it->second);
+                            }
+                        }
+                        if (i > 0u) {
+                            state.append("}\n");
+                        }
+                    }
+                    if (!complete || readLine(journalData, pos) != std::string_view{"E"}) {
+                        break;
+                    }
+                    result = std::move(state);
+                } else {
+                    break;
+                }
+            }
+
+            return result;
+        }
+    }
+}
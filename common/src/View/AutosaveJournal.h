@@ -0,0 +1,97 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "IO/Path.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        /**
+         * An append-only journal of autosaved map states which is kept next to the autosave backups.
+         *
+         * The journal stores the serialized map as a collection of blocks: the header, and for every top level entity
+         * its properties and each of its brushes and patches. Every block is written to the journal only once,
+         * identified by a hash of its text. Each recorded map state is then just the list of the hashes of its blocks,
+         * so the cost of appending a state is proportional to the number of objects that changed since the last
+         * state, plus a few bytes per object.
+         *
+         * A checkpoint discards the journal and starts a new one that contains all blocks of the given map.
+         *
+         * The journal is guarded against incomplete writes: recovering a journal yields the last state that was
+         * written completely and ignores any trailing data.
+         */
+        class AutosaveJournal {
+        private:
+            IO::Path m_path;
+            std::unordered_set<uint64_t> m_blockHashes;
+        public:
+            /**
+             * Creates a journal that is written to the file at the given absolute path. Nothing is written until the
+             * first checkpoint.
+             */
+            explicit AutosaveJournal(IO::Path path);
+
+            const IO::Path& path() const;
+
+            /**
+             * Returns whether a checkpoint was written, i.e. whether states can be appended.
+             */
+            bool started() const;
+
+            /**
+             * Replaces the journal file by a new journal containing only the given map text.
+             *
+             * @throws FileSystemException if the journal file cannot be written
+             */
+            void writeCheckpoint(std::string_view mapText);
+
+            /**
+             * Appends the given map text to the journal, writing only the blocks that the journal doesn't contain
+             * yet. Writes a checkpoint if none has been written yet.
+             *
+             * @throws FileSystemException if the journal file cannot be written
+             */
+            void append(std::string_view mapText);
+
+            /**
+             * Splits the given map text as written by NodeWriter into blocks. The first returned element contains
+             * only the header, which may be empty. Every following element contains the properties of a top level
+             * entity followed by its brushes and patches. The "// entity" and "// brush" comments are omitted since
+             * they depend on the position of an object in the map.
+             */
+            static std::vector<std::vector<std::string_view>> splitBlocks(std::string_view mapText);
+
+            /**
+             * Reconstructs the map text of the last complete state recorded in the given journal data. Returns an
+             * empty optional if the journal data doesn't contain a complete state.
+             */
+            static std::optional<std::string> recover(std::string_view journalData);
+        private:
+            void write(std::string_view mapText, bool checkpoint);
+        };
+    }
+}
@@ -20,19 +20,34 @@
 #include "Autosaver.h"
 
 #include "Exceptions.h"
+#include "Logger.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/IOUtils.h"
+#include "IO/NodeWriter.h"
+#include "IO/Reader.h"
+#include "Model/Game.h"
+#include "Model/GroupNode.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+#include "View/AutosaveJournal.h"
 #include "View/MapDocument.h"
 
 #include <kdl/memory_utils.h>
+#include <kdl/overload.h>
 #include <kdl/string_compare.h>
 #include <kdl/string_format.h>
 #include <kdl/string_utils.h>
 
 #include <algorithm> // for std::sort
 #include <cassert>
+#include <chrono>
 #include <limits>
 #include <memory>
+#include <sstream>
+#include <utility>
 
 namespace TrenchBroom {
     namespace View {
@@ -62,14 +77,26 @@ namespace TrenchBroom {
             return backupNo > 0u;
         }
 
-        Autosaver::Autosaver(std::weak_ptr<MapDocument> document, const std::chrono::milliseconds saveInterval, const size_t maxBackups) :
+        Autosaver::Autosaver(std::weak_ptr<MapDocument> document, const std::chrono::milliseconds saveInterval, const size_t maxBackups, const size_t checkpointInterval) :
         m_document(document),
         m_saveInterval(saveInterval),
         m_maxBackups(maxBackups),
+        m_checkpointInterval(checkpointInterval),
+        m_autosavesSinceCheckpoint(0),
         m_lastSaveTime(Clock::now()),
         m_lastModificationCount(kdl::mem_lock(m_document)->modificationCount()) {}
 
+        Autosaver::~Autosaver() {
+            if (m_pendingBackup.valid()) {
+                m_pendingBackup.wait();
+            }
+        }
+
         void Autosaver::triggerAutosave(Logger& logger) {
+            if (!collectBackup(logger)) {
+                return;
+            }
+
             if (kdl::mem_expired(m_document)) {
                 return;
             }
@@ -98,6 +125,129 @@ namespace TrenchBroom {
             autosave(logger, document);
         }
 
+        void Autosaver::waitForBackup(Logger& logger) {
+            if (m_pendingBackup.valid()) {
+                m_pendingBackup.wait();
+            }
+            collectBackup(logger);
+        }
+
+        static std::string readFile(const IO::WritableDiskFileSystem& fs, const IO::Path& path) {
+            const auto file = fs.openFile(path);
+            auto reader = file->reader().buffer();
+            return std::string{reader.stringView()};
+        }
+
+        void Autosaver::recoverJournal(Logger& logger) {
+            waitForBackup(logger);
+
+            if (kdl::mem_expired(m_document)) {
+                return;
+            }
+
+            auto document = kdl::mem_lock(m_document);
+            const auto& mapPath = document->path();
+            if (!mapPath.isAbsolute()) {
+                return;
+            }
+
+            const auto mapBasename = mapPath.lastComponent().deleteExtension();
+            const auto journalName = makeJournalName(mapBasename);
+            if (!IO::Disk::fileExists(IO::Disk::fixPath(makeAutosavePath(mapPath) + journalName))) {
+                return;
+            }
+
+            try {
+                auto fs = createBackupFileSystem(logger, mapPath);
+                const auto mapText = AutosaveJournal::recover(readFile(fs, journalName));
+                if (!mapText) {
+                    return;
+                }
+
+                auto backups = collectBackups(fs, mapBasename);
+                if (!backups.empty() && readFile(fs, backups.back()) == *mapText) {
+                    return;
+                }
+
+                // the recovered state is newer than all backups, so it's numbered after them
+                const auto backupNo = backups.empty() ? 1u : extractBackupNo(backups.back()) + 1u;
+                const auto backupName = makeBackupName(mapBasename, backupNo);
+                fs.createFileAtomic(backupName, *mapText);
+                logger.info() << "Recovered autosave journal to " << fs.makeAbsolute(backupName);
+            } catch (const Exception& e) {
+                logger.error() << "Cannot recover autosave journal: " << e.what();
+            }
+        }
+
+        bool Autosaver::collectBackup(Logger& logger) {
+            if (!m_pendingBackup.valid()) {
+                return true;
+            }
+            if (m_pendingBackup.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                return false;
+            }
+
+            const auto result = m_pendingBackup.get();
+            m_snapshot.reset();
+
+            if (result.errorMessage) {
+                logger.error() << "Aborting autosave: " << *result.errorMessage;
+            } else if (result.journal) {
+                logger.info() << "Updated autosave journal at " << result.backupFilePath;
+            } else {
+                logger.info() << "Created autosave backup at " << result.backupFilePath;
+            }
+            return true;
+        }
+
+        static void copyPersistentIds(const std::vector<Model::Node*>& originals, const std::vector<Model::Node*>& clones) {
+            assert(originals.size() == clones.size());
+            for (size_t i = 0; i < originals.size(); ++i) {
+                auto* clone = clones[i];
+                originals[i]->accept(kdl::overload(
+                    [] (const Model::WorldNode*) {},
+                    [&](const Model::LayerNode* layerNode) {
+                        if (const auto persistentId = layerNode->persistentId()) {
+                            static_cast<Model::LayerNode*>(clone)->setPersistentId(*persistentId);
+                        }
+                    },
+                    [&](const Model::GroupNode* groupNode) {
+                        if (const auto persistentId = groupNode->persistentId()) {
+                            static_cast<Model::GroupNode*>(clone)->setPersistentId(*persistentId);
+                        }
+                    },
+                    [] (const Model::EntityNode*) {},
+                    [] (const Model::BrushNode*) {},
+                    [] (const Model::PatchNode*) {}
+                ));
+                copyPersistentIds(originals[i]->children(), clone->children());
+            }
+        }
+
+        /**
+         * Creates a copy of the given world which can be written while the original is being edited. The brushes of
+         * the copy share their geometry with the original brushes. The copy keeps the persistent IDs of the original
+         * layers and groups so that the backup refers to the same IDs as the map file.
+         */
+        static std::unique_ptr<Model::WorldNode> createSnapshot(const Model::WorldNode& world, const vm::bbox3& worldBounds) {
+            auto snapshot = std::make_unique<Model::WorldNode>(world.entity(), world.mapFormat());
+            snapshot->disableNodeTreeUpdates();
+
+            const auto* defaultLayerNode = world.defaultLayer();
+            auto* snapshotDefaultLayerNode = snapshot->defaultLayer();
+            snapshotDefaultLayerNode->setLayer(defaultLayerNode->layer());
+            snapshotDefaultLayerNode->setVisibilityState(defaultLayerNode->visibilityState());
+            snapshotDefaultLayerNode->setLockState(defaultLayerNode->lockState());
+            snapshotDefaultLayerNode->addChildren(Model::Node::cloneRecursively(worldBounds, defaultLayerNode->children()));
+
+            for (const auto* layerNode : world.customLayers()) {
+                snapshot->addChild(layerNode->cloneRecursively(worldBounds));
+            }
+
+            copyPersistentIds(world.children(), snapshot->children());
+            return snapshot;
+        }
+
         void Autosaver::autosave(Logger& logger, std::shared_ptr<MapDocument> document) {
             const auto& mapPath = document->path();
             assert(IO::Disk::fileExists(IO::Disk::fixPath(mapPath)));
@@ -107,29 +257,72 @@ namespace TrenchBroom {
 
             try {
                 auto fs = createBackupFileSystem(logger, mapPath);
-                auto backups = collectBackups(fs, mapBasename);
 
-                thinBackups(logger, fs, backups);
-                cleanBackups(fs, backups, mapBasename);
+                auto journal = std::shared_ptr<AutosaveJournal>{};
+                if (m_checkpointInterval > 1u) {
+                    const auto journalPath = fs.makeAbsolute(makeJournalName(mapBasename));
+                    if (!m_journal || m_journal->path() != journalPath) {
+                        m_journal = std::make_shared<AutosaveJournal>(journalPath);
+                        m_autosavesSinceCheckpoint = 0u;
+                    }
+                    journal = m_journal;
+                }
+
+                const auto checkpoint = !journal || !journal->started() || m_autosavesSinceCheckpoint == 0u;
+
+                auto backupName = IO::Path{};
+                auto backupFilePath = journal ? journal->path() : IO::Path{};
+                if (checkpoint) {
+                    auto backups = collectBackups(fs, mapBasename);
 
-                assert(backups.size() < m_maxBackups);
-                const auto backupNo = backups.size() + 1;
+                    thinBackups(logger, fs, backups);
+                    cleanBackups(fs, backups, mapBasename);
 
-                const auto backupFilePath = fs.makeAbsolute(makeBackupName(mapBasename, backupNo));
+                    assert(backups.size() < m_maxBackups);
+                    const auto backupNo = backups.size() + 1;
+
+                    backupName = makeBackupName(mapBasename, backupNo);
+                    backupFilePath = fs.makeAbsolute(backupName);
+                }
 
                 m_lastSaveTime = Clock::now();
                 m_lastModificationCount = document->modificationCount();
-                document->saveDocumentTo(backupFilePath);
+                m_autosavesSinceCheckpoint = checkpoint ? 1u : m_autosavesSinceCheckpoint + 1u;
+                if (m_autosavesSinceCheckpoint >= m_checkpointInterval) {
+                    m_autosavesSinceCheckpoint = 0u;
+                }
 
-                logger.info() << "Created autosave backup at " << backupFilePath;
+                // the snapshot is written on a worker thread so that editing can continue in the meantime
+                m_snapshot = createSnapshot(*document->world(), document->worldBounds());
+                m_pendingBackup = std::async(std::launch::async, [fs = std::move(fs), checkpoint, journal, backupName, backupFilePath, game = document->game(), snapshot = m_snapshot.get()]() mutable {
+                    try {
+                        auto stream = std::stringstream{};
+                        IO::writeGameComment(stream, game->gameName(), Model::formatName(snapshot->mapFormat()));
+
+                        IO::NodeWriter writer(*snapshot, stream);
+                        writer.writeMap();
+
+                        const auto mapText = stream.str();
+                        if (checkpoint) {
+                            fs.createFileAtomic(backupName, mapText);
+                            if (journal) {
+                                journal->writeCheckpoint(mapText);
+                            }
+                        } else {
+                            journal->append(mapText);
+                        }
+                        return BackupResult{backupFilePath, !checkpoint, std::nullopt};
+                    } catch (const Exception& e) {
+                        return BackupResult{backupFilePath, !checkpoint, std::string{e.what()}};
+                    }
+                });
             } catch (const FileSystemException& e) {
                 logger.error() << "Aborting autosave: " << e.what();
             }
         }
 
         IO::WritableDiskFileSystem Autosaver::createBackupFileSystem(Logger& logger, const IO::Path& mapPath) const {
-            const auto basePath = mapPath.deleteLastComponent();
-            const auto autosavePath = basePath + IO::Path("autosave");
+            const auto autosavePath = makeAutosavePath(mapPath);
 
             try {
                 // ensures that the directory exists or is created if it doesn't
@@ -180,6 +373,14 @@ namespace TrenchBroom {
             return IO::Path(kdl::str_to_string(mapBasename,".", index, ".map"));
         }
 
+        IO::Path Autosaver::makeJournalName(const IO::Path& mapBasename) const {
+            return IO::Path(kdl::str_to_string(mapBasename, ".journal"));
+        }
+
+        IO::Path Autosaver::makeAutosavePath(const IO::Path& mapPath) const {
+            return mapPath.deleteLastComponent() + IO::Path("autosave");
+        }
+
         size_t extractBackupNo(const IO::Path& path) {
                 // currently this function is only used when comparing file names which have already been verified as
                 // valid backup file names, so this should not go wrong, but if it does, sort the invalid file names to
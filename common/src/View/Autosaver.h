@@ -22,7 +22,11 @@
 #include "IO/Path.h"
 
 #include <chrono>
+#include <future>
 #include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 namespace TrenchBroom {
     class Logger;
@@ -31,7 +35,12 @@ namespace TrenchBroom {
         class WritableDiskFileSystem;
     }
 
+    namespace Model {
+        class WorldNode;
+    }
+
     namespace View {
+        class AutosaveJournal;
         class Command;
         class MapDocument;
 
@@ -60,6 +69,24 @@ namespace TrenchBroom {
              */
             size_t m_maxBackups;
 
+            /**
+             * The number of autosaves after which a full backup is written again. The autosaves in between only append
+             * the entities that changed to the autosave journal. If this is 1, every autosave writes a full backup and
+             * no journal is kept.
+             */
+            size_t m_checkpointInterval;
+
+            /**
+             * The number of autosaves since the last full backup.
+             */
+            size_t m_autosavesSinceCheckpoint;
+
+            /**
+             * The journal of the current document, if any. It is only accessed by the pending backup while one is
+             * being written.
+             */
+            std::shared_ptr<AutosaveJournal> m_journal;
+
             /**
              * The time at which the last autosave has succeeded.
              */
@@ -69,18 +96,63 @@ namespace TrenchBroom {
              * The modification count that was last recorded.
              */
             size_t m_lastModificationCount;
-            
+
+            /**
+             * The outcome of writing a backup on a worker thread, which is logged on the main thread.
+             */
+            struct BackupResult {
+                IO::Path backupFilePath;
+                bool journal;
+                std::optional<std::string> errorMessage;
+            };
+
+            /**
+             * The copy of the world that is being written by the pending backup. It is owned here so that it is
+             * destroyed on the main thread, which releases the assets it refers to.
+             */
+            std::unique_ptr<Model::WorldNode> m_snapshot;
+
+            /**
+             * The backup that is being written on a worker thread, if any. Declared after the snapshot so that it is
+             * waited for before the snapshot is destroyed.
+             */
+            std::future<BackupResult> m_pendingBackup;
         public:
-            explicit Autosaver(std::weak_ptr<MapDocument> document, std::chrono::milliseconds saveInterval = std::chrono::milliseconds(10 * 60 * 1000), size_t maxBackups = 50);
+            explicit Autosaver(std::weak_ptr<MapDocument> document, std::chrono::milliseconds saveInterval = std::chrono::milliseconds(10 * 60 * 1000), size_t maxBackups = 50, size_t checkpointInterval = 1);
+            ~Autosaver();
 
+            /**
+             * Starts writing a backup on a worker thread if the document was modified and the save interval has
+             * passed. No backup is started while the previous one is still being written.
+             */
             void triggerAutosave(Logger& logger);
+
+            /**
+             * Waits until the pending backup, if any, has been written and logs its outcome.
+             */
+            void waitForBackup(Logger& logger);
+
+            /**
+             * Writes the last complete state recorded in the document's autosave journal as a new backup, unless the
+             * newest backup already contains it. The journal holds the autosaves since the last full backup, so this
+             * makes them available as a regular backup if the editor exited or crashed before the next full backup.
+             *
+             * Call this after a document was loaded, before its first autosave replaces the journal.
+             */
+            void recoverJournal(Logger& logger);
         private:
+            /**
+             * Logs the outcome of the pending backup if it has finished. Returns false if it is still being written.
+             */
+            bool collectBackup(Logger& logger);
             void autosave(Logger& logger, std::shared_ptr<View::MapDocument> document);
             IO::WritableDiskFileSystem createBackupFileSystem(Logger& logger, const IO::Path& mapPath) const;
             std::vector<IO::Path> collectBackups(const IO::WritableDiskFileSystem& fs, const IO::Path& mapBasename) const;
             void thinBackups(Logger& logger, IO::WritableDiskFileSystem& fs, std::vector<IO::Path>& backups) const;
             void cleanBackups(IO::WritableDiskFileSystem& fs, std::vector<IO::Path>& backups, const IO::Path& mapBasename) const;
             IO::Path makeBackupName(const IO::Path& mapBasename, const size_t index) const;
+            IO::Path makeJournalName(const IO::Path& mapBasename) const;
+            IO::Path makeAutosavePath(const IO::Path& mapPath) const;
         };
 
         size_t extractBackupNo(const IO::Path& path);
@@ -27,6 +27,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <utility>
 #include <vector>
 
 #include <QVariant>
@@ -420,6 +421,20 @@ namespace TrenchBroom {
                 return m_rows.size();
             }
 
+            /**
+             * Returns the half open range of indices of the rows that intersect the given vertical range. Since the
+             * rows are sorted by their position, the range is found using binary search.
+             */
+            std::pair<size_t, size_t> visibleRows(const float y, const float height) const {
+                const auto first = std::lower_bound(std::begin(m_rows), std::end(m_rows), y, [](const Row& row, const float top) {
+                    return row.bounds().bottom() < top;
+                });
+                const auto last = std::upper_bound(first, std::end(m_rows), y + height, [](const float bottom, const Row& row) {
+                    return bottom < row.bounds().top();
+                });
+                return { static_cast<size_t>(first - std::begin(m_rows)), static_cast<size_t>(last - std::begin(m_rows)) };
+            }
+
             bool rowAt(const float y, const Row** result) const {
                 size_t index = indexOfRowAt(y);
                 if (index == m_rows.size())
@@ -512,7 +527,7 @@ namespace TrenchBroom {
                 m_height = 2.0f * m_outerMargin;
                 m_valid = true;
                 if (!m_groups.empty()) {
-                    auto copy = m_groups;
+                    auto copy = std::move(m_groups);
                     m_groups.clear();
 
                     for (size_t i = 0; i < copy.size(); ++i) {
@@ -672,6 +687,22 @@ namespace TrenchBroom {
                 return false;
             }
 
+            /**
+             * Returns the half open range of indices of the groups that intersect the given vertical range.
+             */
+            std::pair<size_t, size_t> visibleGroups(const float y, const float height) {
+                if (!m_valid)
+                    validate();
+
+                const auto first = std::lower_bound(std::begin(m_groups), std::end(m_groups), y, [](const Group& group, const float top) {
+                    return group.bounds().bottom() < top;
+                });
+                const auto last = std::upper_bound(first, std::end(m_groups), y + height, [](const float bottom, const Group& group) {
+                    return bottom < group.bounds().top();
+                });
+                return { static_cast<size_t>(first - std::begin(m_groups)), static_cast<size_t>(last - std::begin(m_groups)) };
+            }
+
             const LayoutBounds titleBoundsForVisibleRect(const Group& group, const float y, const float height) const {
                 return group.titleBoundsForVisibleRect(y, height, m_groupMargin);
             }
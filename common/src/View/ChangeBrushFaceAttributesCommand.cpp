@@ -0,0 +1,64 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ChangeBrushFaceAttributesCommand.h"
+
+#include "View/MapDocumentCommandFacade.h"
+
+#include <algorithm>
+
+namespace TrenchBroom {
+    namespace View {
+        const Command::CommandType ChangeBrushFaceAttributesCommand::Type = Command::freeType();
+
+        ChangeBrushFaceAttributesCommand::ChangeBrushFaceAttributesCommand(const std::string& name, std::vector<BrushFaceAttributesState> faces) :
+        UndoableCommand(Type, name, true),
+        m_faces(std::move(faces)) {}
+
+        ChangeBrushFaceAttributesCommand::~ChangeBrushFaceAttributesCommand() = default;
+
+        std::unique_ptr<CommandResult> ChangeBrushFaceAttributesCommand::doPerformDo(MapDocumentCommandFacade* document) {
+            document->performSwapBrushFaceAttributes(m_faces);
+            return std::make_unique<CommandResult>(true);
+        }
+
+        std::unique_ptr<CommandResult> ChangeBrushFaceAttributesCommand::doPerformUndo(MapDocumentCommandFacade* document) {
+            document->performSwapBrushFaceAttributes(m_faces);
+            return std::make_unique<CommandResult>(true);
+        }
+
+        bool ChangeBrushFaceAttributesCommand::doCollateWith(UndoableCommand* command) {
+            // After performing, both commands hold the states of their faces before they were changed. If both
+            // commands changed the same faces, this command already holds the states to restore.
+            const auto* other = static_cast<ChangeBrushFaceAttributesCommand*>(command);
+            return std::equal(std::begin(m_faces), std::end(m_faces), std::begin(other->m_faces), std::end(other->m_faces), [](const auto& lhs, const auto& rhs) {
+                return lhs.faceHandle == rhs.faceHandle;
+            });
+        }
+
+        size_t ChangeBrushFaceAttributesCommand::doGetMemoryUsage() const {
+            auto result = sizeof(ChangeBrushFaceAttributesCommand) + m_name.capacity();
+            for (const auto& face : m_faces) {
+                result += sizeof(face) + face.attributes.textureName().capacity();
+            }
+            return result;
+        }
+    }
+}
@@ -0,0 +1,71 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Macros.h"
+#include "Model/BrushFaceAttributes.h"
+#include "Model/BrushFaceHandle.h"
+#include "Model/TexCoordSystem.h"
+#include "View/UndoableCommand.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        /**
+         * The part of a brush face that is changed by editing its attributes. The snapshot of the texture coordinate
+         * system is null for texture coordinate systems that are fully determined by the attributes.
+         */
+        struct BrushFaceAttributesState {
+            Model::BrushFaceHandle faceHandle;
+            Model::BrushFaceAttributes attributes;
+            std::unique_ptr<Model::TexCoordSystemSnapshot> texCoordSystemSnapshot;
+        };
+
+        /**
+         * Changes the attributes of brush faces. Only the attributes and texture coordinate systems of the affected
+         * faces are recorded for undo, so the affected brushes don't need to be copied. Faces that belong to linked
+         * groups must be changed using SwapNodeContentsCommand instead because the linked groups must be updated.
+         *
+         * Consecutive changes of the same faces are collated, e.g. when dragging a spin control.
+         */
+        class ChangeBrushFaceAttributesCommand : public UndoableCommand {
+        public:
+            static const CommandType Type;
+        private:
+            std::vector<BrushFaceAttributesState> m_faces;
+        public:
+            ChangeBrushFaceAttributesCommand(const std::string& name, std::vector<BrushFaceAttributesState> faces);
+            ~ChangeBrushFaceAttributesCommand() override;
+        private:
+            std::unique_ptr<CommandResult> doPerformDo(MapDocumentCommandFacade* document) override;
+            std::unique_ptr<CommandResult> doPerformUndo(MapDocumentCommandFacade* document) override;
+
+            bool doCollateWith(UndoableCommand* command) override;
+
+            size_t doGetMemoryUsage() const override;
+
+            deleteCopyAndMove(ChangeBrushFaceAttributesCommand)
+        };
+    }
+}
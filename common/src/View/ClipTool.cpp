@@ -41,6 +41,7 @@
 #include <kdl/map_utils.h>
 #include <kdl/memory_utils.h>
 #include <kdl/overload.h>
+#include <kdl/parallel.h>
 #include <kdl/set_temp.h>
 #include <kdl/string_utils.h>
 #include <kdl/vector_utils.h>
@@ -50,8 +51,10 @@
 #include <vecmath/vec_io.h>
 
 #include <algorithm>
+#include <array>
 #include <map>
 #include <optional>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
@@ -503,6 +506,7 @@ namespace TrenchBroom {
         m_strategy(nullptr),
         m_remainingBrushRenderer(std::make_unique<Renderer::BrushRenderer>()),
         m_clippedBrushRenderer(std::make_unique<Renderer::BrushRenderer>()),
+        m_brushesValid(false),
         m_ignoreNotifications(false),
         m_dragging(false) {}
 
@@ -528,7 +532,11 @@ namespace TrenchBroom {
                         m_clipSide = ClipSide_Front;
                         break;
                 }
-                update();
+
+                // the brushes of both sides are already computed, only the renderers need to be updated
+                clearRenderers();
+                updateRenderers();
+                refreshViews();
             }
         }
 
@@ -601,6 +609,7 @@ namespace TrenchBroom {
                 document->removeNodes(toRemove);
                 document->select(addedNodes);
 
+                clearBrushes();
                 update();
             }
         }
@@ -625,6 +634,7 @@ namespace TrenchBroom {
                 }
             }
 
+            m_brushesValid = false;
             resetStrategy();
             return result;
         }
@@ -737,47 +747,86 @@ namespace TrenchBroom {
 
         void ClipTool::update() {
             clearRenderers();
-            clearBrushes();
 
-            updateBrushes();
+            const auto currentClipPoints = clipPoints();
+            if (!m_brushesValid || m_brushesClipPoints != currentClipPoints) {
+                clearBrushes();
+                updateBrushes(currentClipPoints);
+            }
             updateRenderers();
 
             refreshViews();
         }
 
+        std::optional<std::array<vm::vec3, 3>> ClipTool::clipPoints() const {
+            if (!canClip()) {
+                return std::nullopt;
+            }
+
+            vm::vec3 point1, point2, point3;
+            const auto numPoints = m_strategy->getPoints(point1, point2, point3);
+            ensure(numPoints == 3, "invalid number of points");
+            return std::array<vm::vec3, 3>{point1, point2, point3};
+        }
+
         void ClipTool::clearBrushes() {
             kdl::map_clear_and_delete(m_frontBrushes);
             kdl::map_clear_and_delete(m_backBrushes);
+            m_brushesValid = false;
         }
 
-        void ClipTool::updateBrushes() {
+        void ClipTool::updateBrushes(const std::optional<std::array<vm::vec3, 3>>& clipPoints) {
             auto document = kdl::mem_lock(m_document);
 
             const auto& brushNodes = document->selectedNodes().brushes();
             const auto& worldBounds = document->worldBounds();
 
-            const auto clip = [&](auto* node, const auto& p1, const auto& p2, const auto& p3, auto& brushMap) {
-                auto brush = node->brush();
-                Model::BrushFace::create(p1, p2, p3, Model::BrushFaceAttributes(document->currentTextureName()), document->world()->mapFormat())
-                    .and_then([&](Model::BrushFace&& clipFace) {
-                            setFaceAttributes(brush.faces(), clipFace);
-                            return brush.clip(worldBounds, std::move(clipFace));
-                    }).and_then([&]() {
-                            brushMap[node->parent()].push_back(new Model::BrushNode(std::move(brush)));
-                    }).handle_errors([&](const Model::BrushError e) {
-                            document->error() << "Could not clip brush: " << e;
-                    });
-            };
-
-            if (canClip()) {
-                vm::vec3 point1, point2, point3;
-                const auto numPoints = m_strategy->getPoints(point1, point2, point3);
-                ensure(numPoints == 3, "invalid number of points");
+            m_brushesValid = true;
+            m_brushesClipPoints = clipPoints;
+
+            if (clipPoints) {
+                struct ClipResult {
+                    std::optional<Model::Brush> brush;
+                    std::optional<Model::BrushError> error;
+                };
+
+                const auto& textureName = document->currentTextureName();
+                const auto mapFormat = document->world()->mapFormat();
+                const auto clip = [&](const Model::BrushNode* node, const vm::vec3& p1, const vm::vec3& p2, const vm::vec3& p3) {
+                    auto result = ClipResult{};
+                    auto brush = node->brush();
+                    Model::BrushFace::create(p1, p2, p3, Model::BrushFaceAttributes(textureName), mapFormat)
+                        .and_then([&](Model::BrushFace&& clipFace) {
+                                setFaceAttributes(brush.faces(), clipFace);
+                                return brush.clip(worldBounds, std::move(clipFace));
+                        }).and_then([&]() {
+                                result.brush = std::move(brush);
+                        }).handle_errors([&](const Model::BrushError e) {
+                                result.error = e;
+                        });
+                    return result;
+                };
+
+                // the brushes are clipped in parallel, but the results are stored and errors are logged in order
+                const auto& [point1, point2, point3] = *clipPoints;
+                auto clipResults = kdl::vec_parallel_transform(brushNodes, [&](const Model::BrushNode* brushNode) {
+                    return std::make_pair(clip(brushNode, point1, point2, point3), clip(brushNode, point1, point3, point2));
+                });
+
+                const auto storeResult = [&](Model::Node* parent, ClipResult& result, auto& brushMap) {
+                    if (result.brush) {
+                        brushMap[parent].push_back(new Model::BrushNode(std::move(*result.brush)));
+                    } else if (result.error) {
+                        document->error() << "Could not clip brush: " << *result.error;
+                    }
+                };
 
-                for (auto* brushNode : brushNodes) {
-                    clip(brushNode, point1, point2, point3, m_frontBrushes);
-                    clip(brushNode, point1, point3, point2, m_backBrushes);
-               }
+                for (size_t i = 0; i < brushNodes.size(); ++i) {
+                    auto* parent = brushNodes[i]->parent();
+                    auto& [frontResult, backResult] = clipResults[i];
+                    storeResult(parent, frontResult, m_frontBrushes);
+                    storeResult(parent, backResult, m_backBrushes);
+                }
             } else {
                 for (auto* brushNode : brushNodes) {
                     auto* parent = brushNode->parent();
@@ -894,24 +943,28 @@ namespace TrenchBroom {
 
         void ClipTool::selectionDidChange(const Selection&) {
             if (!m_ignoreNotifications) {
+                clearBrushes();
                 update();
             }
         }
 
         void ClipTool::nodesWillChange(const std::vector<Model::Node*>&) {
             if (!m_ignoreNotifications) {
+                clearBrushes();
                 update();
             }
         }
 
         void ClipTool::nodesDidChange(const std::vector<Model::Node*>&) {
             if (!m_ignoreNotifications) {
+                clearBrushes();
                 update();
             }
         }
 
         void ClipTool::brushFacesDidChange(const std::vector<Model::BrushFaceHandle>&) {
             if (!m_ignoreNotifications) {
+                clearBrushes();
                 update();
             }
         }
@@ -24,6 +24,9 @@
 #include "Model/HitType.h"
 #include "View/Tool.h"
 
+#include <vecmath/vec.h>
+
+#include <array>
 #include <map>
 #include <memory>
 #include <optional>
@@ -123,6 +126,13 @@ namespace TrenchBroom {
             std::map<Model::Node*, std::vector<Model::Node*>> m_frontBrushes;
             std::map<Model::Node*, std::vector<Model::Node*>> m_backBrushes;
 
+            /**
+             * Whether the front and back brushes are up to date, and the clip points they were computed from, if any.
+             * Changing the clip side doesn't change the brushes, and neither does updating with unchanged points.
+             */
+            bool m_brushesValid;
+            std::optional<std::array<vm::vec3, 3>> m_brushesClipPoints;
+
             std::unique_ptr<Renderer::BrushRenderer> m_remainingBrushRenderer;
             std::unique_ptr<Renderer::BrushRenderer> m_clippedBrushRenderer;
 
@@ -174,8 +184,9 @@ namespace TrenchBroom {
             void resetStrategy();
             void update();
 
+            std::optional<std::array<vm::vec3, 3>> clipPoints() const;
             void clearBrushes();
-            void updateBrushes();
+            void updateBrushes(const std::optional<std::array<vm::vec3, 3>>& clipPoints);
 
             void setFaceAttributes(const std::vector<Model::BrushFace>& faces, Model::BrushFace& toSet) const;
 
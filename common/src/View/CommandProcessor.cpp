@@ -21,6 +21,7 @@
 
 #include "Exceptions.h"
 #include "Notifier.h"
+#include "Profiler.h"
 #include "View/Command.h"
 #include "View/UndoableCommand.h"
 
@@ -29,6 +30,8 @@
 #include <kdl/vector_utils.h>
 
 #include <algorithm>
+#include <iterator>
+#include <numeric>
 
 #include <QDateTime>
 
@@ -108,6 +111,14 @@ namespace TrenchBroom {
             bool doCollateWith(UndoableCommand*) override {
                 return false;
             }
+
+            size_t doGetMemoryUsage() const override {
+                auto result = sizeof(TransactionCommand) + m_name.capacity();
+                for (const auto& command : m_commands) {
+                    result += command->memoryUsage();
+                }
+                return result;
+            }
         };
 
         const Command::CommandType CommandProcessor::TransactionCommand::Type = Command::freeType();
@@ -115,6 +126,7 @@ namespace TrenchBroom {
         CommandProcessor::CommandProcessor(MapDocumentCommandFacade* document, const std::chrono::milliseconds collationInterval) :
         m_document(document),
         m_collationInterval(collationInterval),
+        m_undoMemoryBudget(0u),
         m_lastCommandTimestamp(std::chrono::time_point<std::chrono::system_clock>()) {}
 
         CommandProcessor::~CommandProcessor() = default;
@@ -143,6 +155,19 @@ namespace TrenchBroom {
             }
         }
 
+        size_t CommandProcessor::undoMemoryBudget() const {
+            return m_undoMemoryBudget;
+        }
+
+        void CommandProcessor::setUndoMemoryBudget(const size_t undoMemoryBudget) {
+            m_undoMemoryBudget = undoMemoryBudget;
+            enforceUndoMemoryBudget();
+        }
+
+        size_t CommandProcessor::undoStackMemoryUsage() const {
+            return std::accumulate(std::begin(m_undoStackMemoryUsage), std::end(m_undoStackMemoryUsage), size_t(0));
+        }
+
         void CommandProcessor::startTransaction(const std::string& name) {
             m_transactionStack.push_back(TransactionState(name));
         }
@@ -171,6 +196,7 @@ namespace TrenchBroom {
             auto result = executeCommand(command.get());
             if (result->success()) {
                 m_undoStack.clear();
+                m_undoStackMemoryUsage.clear();
                 m_redoStack.clear();
             }
             return result;
@@ -216,6 +242,7 @@ namespace TrenchBroom {
             assert(m_transactionStack.empty());
 
             m_undoStack.clear();
+            m_undoStackMemoryUsage.clear();
             m_redoStack.clear();
             m_lastCommandTimestamp = std::chrono::time_point<std::chrono::system_clock>();
         }
@@ -232,6 +259,7 @@ namespace TrenchBroom {
         }
 
         std::unique_ptr<CommandResult> CommandProcessor::executeCommand(Command* command) {
+            TB_PROFILE_SCOPE("CommandProcessor::executeCommand");
             notifyCommandIfNotType(commandDoNotifier, TransactionCommand::Type, command);
             auto result = command->performDo(m_document);
             if (result->success()) {
@@ -246,6 +274,7 @@ namespace TrenchBroom {
         }
 
         std::unique_ptr<CommandResult> CommandProcessor::undoCommand(UndoableCommand* command) {
+            TB_PROFILE_SCOPE("CommandProcessor::undoCommand");
             notifyCommandIfNotType(commandUndoNotifier, TransactionCommand::Type, command);
             auto result = command->performUndo(m_document);
             if (result->success()) {
@@ -315,11 +344,15 @@ namespace TrenchBroom {
             if (collatable(collate, timestamp)) {
                 auto& lastCommand = m_undoStack.back();
                 if (lastCommand->collateWith(command.get())) {
+                    m_undoStackMemoryUsage.back() = lastCommand->memoryUsage();
+                    enforceUndoMemoryBudget();
                     return false;
                 }
             }
 
+            m_undoStackMemoryUsage.push_back(command->memoryUsage());
             m_undoStack.push_back(std::move(command));
+            enforceUndoMemoryBudget();
             return true;
         }
 
@@ -327,9 +360,28 @@ namespace TrenchBroom {
             assert(m_transactionStack.empty());
             assert(!m_undoStack.empty());
 
+            m_undoStackMemoryUsage.pop_back();
             return kdl::vec_pop_back(m_undoStack);
         }
 
+        void CommandProcessor::enforceUndoMemoryBudget() {
+            if (m_undoMemoryBudget == 0u) {
+                return;
+            }
+
+            auto memoryUsage = undoStackMemoryUsage();
+            auto count = size_t(0);
+            while (count + 1u < m_undoStack.size() && memoryUsage > m_undoMemoryBudget) {
+                memoryUsage -= m_undoStackMemoryUsage[count];
+                ++count;
+            }
+
+            if (count > 0u) {
+                m_undoStack.erase(std::begin(m_undoStack), std::next(std::begin(m_undoStack), static_cast<std::ptrdiff_t>(count)));
+                m_undoStackMemoryUsage.erase(std::begin(m_undoStackMemoryUsage), std::next(std::begin(m_undoStackMemoryUsage), static_cast<std::ptrdiff_t>(count)));
+            }
+        }
+
         bool CommandProcessor::collatable(const bool collate, const std::chrono::system_clock::time_point timestamp) const {
             return collate && !m_undoStack.empty() && timestamp - m_lastCommandTimestamp <= m_collationInterval;
         }
@@ -22,6 +22,7 @@
 #include "Notifier.h"
 
 #include <chrono>
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <vector>
@@ -65,6 +66,17 @@ namespace TrenchBroom {
              */
             std::vector<std::unique_ptr<UndoableCommand>> m_undoStack;
 
+            /**
+             * Holds the estimated memory usage of each command on the undo stack, in bytes, at the time it was pushed
+             * onto the undo stack.
+             */
+            std::vector<size_t> m_undoStackMemoryUsage;
+
+            /**
+             * The maximum number of bytes that the commands on the undo stack may use, or 0 if there is no limit.
+             */
+            size_t m_undoMemoryBudget;
+
             /**
              * Holds the commands that were undone, with the most recently undone command at the beginning of
              * the vector.
@@ -157,6 +169,26 @@ namespace TrenchBroom {
              */
             const std::string& redoCommandName() const;
 
+            /**
+             * Returns the maximum number of bytes that the commands on the undo stack may use, or 0 if there is no
+             * limit.
+             */
+            size_t undoMemoryBudget() const;
+
+            /**
+             * Sets the maximum number of bytes that the commands on the undo stack may use. Whenever a command is
+             * pushed onto the undo stack and the estimated memory usage of the undo stack exceeds the budget, the
+             * oldest commands are discarded until it fits again. The most recent command is never discarded.
+             *
+             * @param undoMemoryBudget the budget in bytes, or 0 to disable the limit
+             */
+            void setUndoMemoryBudget(size_t undoMemoryBudget);
+
+            /**
+             * Returns the estimated memory usage of the commands on the undo stack, in bytes.
+             */
+            size_t undoStackMemoryUsage() const;
+
             /**
              * Starts a new transaction. If a transaction is currently executing, then the newly started transaction
              * becomes a nested transaction and will be added as a command to its parent transaction upon commit.
@@ -341,6 +373,12 @@ namespace TrenchBroom {
              */
             std::unique_ptr<UndoableCommand> popFromUndoStack();
 
+            /**
+             * Discards the oldest commands from the undo stack until its estimated memory usage fits the budget or
+             * until only one command remains.
+             */
+            void enforceUndoMemoryBudget();
+
             bool collatable(bool collate, std::chrono::system_clock::time_point timestamp) const;
 
             /**
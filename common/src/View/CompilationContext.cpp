@@ -42,7 +42,14 @@ namespace TrenchBroom {
         }
 
         std::string CompilationContext::interpolate(const std::string& input) const {
-            return EL::interpolate(input, EL::EvaluationContext(*m_variables));
+            const auto it = m_interpolationCache.find(input);
+            if (it != std::end(m_interpolationCache)) {
+                return it->second;
+            }
+
+            auto result = EL::interpolate(input, EL::EvaluationContext(*m_variables));
+            m_interpolationCache.emplace(input, result);
+            return result;
         }
 
         std::string CompilationContext::variableValue(const std::string& variableName) const {
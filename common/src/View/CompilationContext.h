@@ -24,6 +24,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 namespace TrenchBroom {
     namespace View {
@@ -34,6 +35,12 @@ namespace TrenchBroom {
             std::weak_ptr<MapDocument> m_document;
             std::unique_ptr<EL::VariableStore> m_variables;
 
+            /**
+             * The variables don't change during a compilation run, so the result of interpolating a string can be
+             * reused. Profiles often contain the same specs in many tasks, e.g. the path of the compiled map.
+             */
+            mutable std::unordered_map<std::string, std::string> m_interpolationCache;
+
             TextOutputAdapter m_output;
             bool m_test;
         public:
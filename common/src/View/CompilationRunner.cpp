@@ -31,6 +31,9 @@
 #include "View/CompilationVariables.h"
 #include "View/MapDocument.h"
 
+#include <kdl/vector_utils.h>
+
+#include <algorithm>
 #include <string>
 
 #include <QtGlobal>
@@ -45,6 +48,10 @@ namespace TrenchBroom {
 
         CompilationTaskRunner::~CompilationTaskRunner() = default;
 
+        void CompilationTaskRunner::setOutputPrefix(const QString& outputPrefix) {
+            m_outputPrefix = outputPrefix;
+        }
+
         void CompilationTaskRunner::execute() {
             doExecute();
         }
@@ -149,7 +156,9 @@ namespace TrenchBroom {
                 disconnect(m_process, &QProcess::errorOccurred, this, &CompilationRunToolTaskRunner::processErrorOccurred);
                 disconnect(m_process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, &CompilationRunToolTaskRunner::processFinished);
                 m_process->kill();
-                m_context << "\n\n#### Terminated\n";
+                flushOutput(m_pendingStandardOutput);
+                flushOutput(m_pendingStandardError);
+                m_context << "\n\n" << m_outputPrefix << "#### Terminated\n";
             }
         }
 
@@ -161,7 +170,7 @@ namespace TrenchBroom {
                 const auto workDir = m_context.variableValue(CompilationVariableNames::WORK_DIR_PATH);
                 const auto cmd = this->cmd();
 
-                m_context << "#### Executing '" << QString::fromStdString(cmd) << "'\n";
+                m_context << m_outputPrefix << "#### Executing '" << QString::fromStdString(cmd) << "'\n";
 
                 if (!m_context.test()) {
                     m_process = new QProcess{this};
@@ -195,29 +204,60 @@ namespace TrenchBroom {
             }
         }
 
+        void CompilationRunToolTaskRunner::appendOutput(QString& pending, const QString& output) {
+            if (m_outputPrefix.isEmpty()) {
+                m_context << output;
+                return;
+            }
+
+            // only write complete lines so that the output of concurrent tasks is not interleaved within a line
+            pending += output;
+            const auto lastNewline = pending.lastIndexOf('\n');
+            if (lastNewline < 0) {
+                return;
+            }
+
+            const auto lines = pending.left(lastNewline).split('\n');
+            pending = pending.mid(lastNewline + 1);
+            for (const auto& line : lines) {
+                m_context << m_outputPrefix << line << "\n";
+            }
+        }
+
+        void CompilationRunToolTaskRunner::flushOutput(QString& pending) {
+            if (!pending.isEmpty()) {
+                m_context << m_outputPrefix << pending << "\n";
+                pending.clear();
+            }
+        }
+
         void CompilationRunToolTaskRunner::processErrorOccurred(const QProcess::ProcessError processError) {
-            m_context << "#### Error '"
+            flushOutput(m_pendingStandardOutput);
+            flushOutput(m_pendingStandardError);
+            m_context << m_outputPrefix << "#### Error '"
                       << QMetaEnum::fromType<QProcess::ProcessError>().valueToKey(processError)
                       << "' occurred when communicating with process\n\n";
             emit error();
         }
 
         void CompilationRunToolTaskRunner::processFinished(const int exitCode, const QProcess::ExitStatus /* exitStatus */) {
-            m_context << "#### Finished with exit status " << exitCode << "\n\n";
+            flushOutput(m_pendingStandardOutput);
+            flushOutput(m_pendingStandardError);
+            m_context << m_outputPrefix << "#### Finished with exit status " << exitCode << "\n\n";
             emit end();
         }
 
         void CompilationRunToolTaskRunner::processReadyReadStandardError() {
             if (m_process != nullptr) {
                 const QByteArray bytes = m_process->readAllStandardError();
-                m_context << QString::fromLocal8Bit(bytes);
+                appendOutput(m_pendingStandardError, QString::fromLocal8Bit(bytes));
             }
         }
 
         void CompilationRunToolTaskRunner::processReadyReadStandardOutput() {
             if (m_process != nullptr) {
                 const QByteArray bytes = m_process->readAllStandardOutput();
-                m_context << QString::fromLocal8Bit(bytes);
+                appendOutput(m_pendingStandardOutput, QString::fromLocal8Bit(bytes));
             }
         }
 
@@ -225,17 +265,21 @@ namespace TrenchBroom {
         QObject{parent},
         m_context{std::move(context)},
         m_taskRunners{createTaskRunners(*m_context, profile)},
-        m_currentTask{std::end(m_taskRunners)} {}
+        m_jobCount{std::max(profile->jobCount(), size_t(1))},
+        m_running{false} {}
 
         CompilationRunner::~CompilationRunner() = default;
 
         class CompilationRunner::CreateTaskRunnerVisitor : public Model::ConstCompilationTaskVisitor {
         private:
             CompilationContext& m_context;
+            bool m_prefixOutput;
             TaskRunnerList m_runners;
+            std::vector<std::string> m_names;
         public:
-            explicit CreateTaskRunnerVisitor(CompilationContext& context) :
-            m_context{context} {}
+            CreateTaskRunnerVisitor(CompilationContext& context, const bool prefixOutput) :
+            m_context{context},
+            m_prefixOutput{prefixOutput} {}
 
             TaskRunnerList runners() {
                 return std::move(m_runners);
@@ -243,30 +287,51 @@ namespace TrenchBroom {
 
             void visit(const Model::CompilationExportMap& task) override {
                 if (task.enabled()) {
-                    appendRunner(std::make_unique<CompilationExportMapTaskRunner>(m_context, task));
+                    appendRunner(task, std::make_unique<CompilationExportMapTaskRunner>(m_context, task));
                 }
             }
 
             void visit(const Model::CompilationCopyFiles& task) override {
                 if (task.enabled()) {
-                    appendRunner(std::make_unique<CompilationCopyFilesTaskRunner>(m_context, task));
+                    appendRunner(task, std::make_unique<CompilationCopyFilesTaskRunner>(m_context, task));
                 }
             }
 
             void visit(const Model::CompilationRunTool& task) override {
                 if (task.enabled()) {
-                    appendRunner(std::make_unique<CompilationRunToolTaskRunner>(m_context, task));
+                    appendRunner(task, std::make_unique<CompilationRunToolTaskRunner>(m_context, task));
                 }
             }
 
         private:
-            void appendRunner(std::unique_ptr<CompilationTaskRunner> runner) {
-                m_runners.emplace_back(std::move(runner));
+            void appendRunner(const Model::CompilationTask& task, std::unique_ptr<CompilationTaskRunner> runner) {
+                auto dependencies = std::vector<size_t>{};
+                if (const auto& dependencyNames = task.dependencies()) {
+                    for (const auto& name : *dependencyNames) {
+                        // only preceding tasks are found here, so the dependency graph cannot contain cycles
+                        const auto index = name.empty() ? std::nullopt : kdl::vec_index_of(m_names, name);
+                        if (index) {
+                            dependencies.push_back(*index);
+                        } else {
+                            m_context << "#### Ignoring dependency on unknown or disabled task '" << QString::fromStdString(name) << "'\n";
+                        }
+                    }
+                } else if (!m_runners.empty()) {
+                    dependencies.push_back(m_runners.size() - 1u);
+                }
+
+                if (m_prefixOutput) {
+                    const auto label = task.name().empty() ? QString::number(m_runners.size() + 1u) : QString::fromStdString(task.name());
+                    runner->setOutputPrefix("[" + label + "] ");
+                }
+
+                m_names.push_back(task.name());
+                m_runners.push_back(TaskRunner{std::move(runner), std::move(dependencies), TaskState::Pending});
             }
         };
 
         CompilationRunner::TaskRunnerList CompilationRunner::createTaskRunners(CompilationContext& context, const Model::CompilationProfile* profile) {
-            auto visitor = CreateTaskRunnerVisitor{context};
+            auto visitor = CreateTaskRunnerVisitor{context, profile->jobCount() > 1u};
             profile->accept(visitor);
             return visitor.runners();
         }
@@ -274,12 +339,15 @@ namespace TrenchBroom {
         void CompilationRunner::execute() {
             assert(!running());
 
-            m_currentTask = std::begin(m_taskRunners);
-            if (m_currentTask == std::end(m_taskRunners)) {
+            if (m_taskRunners.empty()) {
                 emit compilationEnded();
                 return;
             }
-            bindEvents(m_currentTask->get());
+
+            for (auto& taskRunner : m_taskRunners) {
+                taskRunner.state = TaskState::Pending;
+            }
+            m_running = true;
 
             emit compilationStarted();
 
@@ -289,48 +357,99 @@ namespace TrenchBroom {
             } else {
                 *m_context << "#### Using working directory '" << workDir << "'\n";
             }
-            m_currentTask->get()->execute();
+            startReadyTasks();
         }
 
         void CompilationRunner::terminate() {
             assert(running());
-            unbindEvents(m_currentTask->get());
-            m_currentTask->get()->terminate();
-            m_currentTask = std::end(m_taskRunners);
-
-            emit compilationEnded();
+            terminateRunningTasks();
+            endCompilation();
         }
 
         bool CompilationRunner::running() const {
-            return m_currentTask != std::end(m_taskRunners);
+            return m_running;
         }
 
-        void CompilationRunner::bindEvents(CompilationTaskRunner* runner) {
-            connect(runner, &CompilationTaskRunner::error, this, &CompilationRunner::taskError);
-            connect(runner, &CompilationTaskRunner::end, this, &CompilationRunner::taskEnd);
+        void CompilationRunner::startReadyTasks() {
+            // Tasks that don't run an external tool end (or fail) while they are being executed, which calls back into
+            // this function, so the state is re-examined after each task is started.
+            while (running()) {
+                const auto runningCount = static_cast<size_t>(std::count_if(std::begin(m_taskRunners), std::end(m_taskRunners), [](const auto& taskRunner) {
+                    return taskRunner.state == TaskState::Running;
+                }));
+                if (runningCount >= m_jobCount) {
+                    return;
+                }
+
+                const auto index = kdl::vec_index_of(m_taskRunners, [&](const auto& taskRunner) {
+                    return taskRunner.state == TaskState::Pending && dependenciesEnded(taskRunner);
+                });
+                if (!index) {
+                    return;
+                }
+
+                auto& taskRunner = m_taskRunners[*index];
+                taskRunner.state = TaskState::Running;
+                bindEvents(*index);
+                taskRunner.runner->execute();
+            }
+        }
+
+        bool CompilationRunner::dependenciesEnded(const TaskRunner& taskRunner) const {
+            return std::all_of(std::begin(taskRunner.dependencies), std::end(taskRunner.dependencies), [&](const auto index) {
+                return m_taskRunners[index].state == TaskState::Ended;
+            });
+        }
+
+        void CompilationRunner::terminateRunningTasks() {
+            for (auto& taskRunner : m_taskRunners) {
+                if (taskRunner.state == TaskState::Running) {
+                    unbindEvents(taskRunner.runner.get());
+                    taskRunner.runner->terminate();
+                    taskRunner.state = TaskState::Ended;
+                }
+            }
+        }
+
+        void CompilationRunner::endCompilation() {
+            m_running = false;
+            emit compilationEnded();
+        }
+
+        void CompilationRunner::bindEvents(const size_t index) {
+            auto* runner = m_taskRunners[index].runner.get();
+            connect(runner, &CompilationTaskRunner::error, this, [this, index]() { taskError(index); });
+            connect(runner, &CompilationTaskRunner::end, this, [this, index]() { taskEnd(index); });
         }
 
         void CompilationRunner::unbindEvents(CompilationTaskRunner* runner) {
             runner->disconnect(this);
         }
 
-        void CompilationRunner::taskError() {
+        void CompilationRunner::taskError(const size_t index) {
             if (running()) {
-                unbindEvents(m_currentTask->get());
-                m_currentTask = std::end(m_taskRunners);
-                emit compilationEnded();
+                auto& taskRunner = m_taskRunners[index];
+                unbindEvents(taskRunner.runner.get());
+                taskRunner.state = TaskState::Ended;
+
+                terminateRunningTasks();
+                endCompilation();
             }
         }
 
-        void CompilationRunner::taskEnd() {
+        void CompilationRunner::taskEnd(const size_t index) {
             if (running()) {
-                unbindEvents(m_currentTask->get());
-                ++m_currentTask;
-                if (m_currentTask != std::end(m_taskRunners)) {
-                    bindEvents(m_currentTask->get());
-                    m_currentTask->get()->execute();
+                auto& taskRunner = m_taskRunners[index];
+                unbindEvents(taskRunner.runner.get());
+                taskRunner.state = TaskState::Ended;
+
+                const auto allEnded = std::all_of(std::begin(m_taskRunners), std::end(m_taskRunners), [](const auto& t) {
+                    return t.state == TaskState::Ended;
+                });
+                if (allEnded) {
+                    endCompilation();
                 } else {
-                    emit compilationEnded();
+                    startReadyTasks();
                 }
             }
         }
@@ -27,6 +27,7 @@
 
 #include <QObject>
 #include <QProcess> // for QProcess::ProcessError
+#include <QString>
 
 namespace TrenchBroom {
     namespace Model {
@@ -43,11 +44,18 @@ namespace TrenchBroom {
             Q_OBJECT
         protected:
             CompilationContext& m_context;
+            QString m_outputPrefix;
         protected:
             explicit CompilationTaskRunner(CompilationContext& context);
         public:
             ~CompilationTaskRunner() override;
 
+            /**
+             * Sets a prefix that is prepended to every line of output of this task. Used to tell apart the output of
+             * tasks that run concurrently.
+             */
+            void setOutputPrefix(const QString& outputPrefix);
+
             void execute();
             void terminate();
         signals:
@@ -97,6 +105,8 @@ namespace TrenchBroom {
             std::unique_ptr<const Model::CompilationRunTool> m_task;
             QProcess* m_process;
             bool m_terminated;
+            QString m_pendingStandardOutput;
+            QString m_pendingStandardError;
         public:
             CompilationRunToolTaskRunner(CompilationContext& context, const Model::CompilationRunTool& task);
             ~CompilationRunToolTaskRunner() override;
@@ -106,6 +116,8 @@ namespace TrenchBroom {
         private:
             void startProcess();
             std::string cmd();
+            void appendOutput(QString& pending, const QString& output);
+            void flushOutput(QString& pending);
         private slots:
             void processErrorOccurred(QProcess::ProcessError processError);
             void processFinished(int exitCode, QProcess::ExitStatus exitStatus);
@@ -115,14 +127,33 @@ namespace TrenchBroom {
             deleteCopyAndMove(CompilationRunToolTaskRunner)
         };
 
+        /**
+         * Runs the enabled tasks of a compilation profile.
+         *
+         * A task is started once all of its dependencies have ended, and up to the profile's job count tasks run at
+         * the same time. Since tasks can only depend on tasks that precede them in the profile, the dependency graph is
+         * acyclic. If a task fails, all running tasks are terminated and the compilation ends.
+         */
         class CompilationRunner : public QObject {
             Q_OBJECT
         private:
-            using TaskRunnerList = std::vector<std::unique_ptr<CompilationTaskRunner>>;
+            enum class TaskState {
+                Pending,
+                Running,
+                Ended
+            };
+
+            struct TaskRunner {
+                std::unique_ptr<CompilationTaskRunner> runner;
+                std::vector<size_t> dependencies;
+                TaskState state;
+            };
+            using TaskRunnerList = std::vector<TaskRunner>;
 
             std::unique_ptr<CompilationContext> m_context;
             TaskRunnerList m_taskRunners;
-            TaskRunnerList::iterator m_currentTask;
+            size_t m_jobCount;
+            bool m_running;
         public:
             CompilationRunner(std::unique_ptr<CompilationContext> context, const Model::CompilationProfile* profile, QObject* parent = nullptr);
             ~CompilationRunner() override;
@@ -134,11 +165,15 @@ namespace TrenchBroom {
             void terminate();
             bool running() const;
         private:
-            void bindEvents(CompilationTaskRunner* runner);
+            void startReadyTasks();
+            bool dependenciesEnded(const TaskRunner& taskRunner) const;
+            void terminateRunningTasks();
+            void endCompilation();
+            void bindEvents(size_t index);
             void unbindEvents(CompilationTaskRunner* runner);
-        private slots:
-            void taskError();
-            void taskEnd();
+        private:
+            void taskError(size_t index);
+            void taskEnd(size_t index);
         signals:
             void compilationStarted();
             void compilationEnded();
@@ -23,19 +23,23 @@
 #include "View/ViewConstants.h"
 
 #include <string>
+#include <utility>
 
 #include <QDebug>
+#include <QMetaObject>
+#include <QPlainTextEdit>
 #include <QScrollBar>
-#include <QTextEdit>
 #include <QVBoxLayout>
 
 namespace TrenchBroom {
     namespace View {
         Console::Console(QWidget* parent) :
         TabBookPage(parent) {
-            m_textView = new QTextEdit();
+            // unlike QTextEdit, QPlainTextEdit only lays out the visible lines
+            m_textView = new QPlainTextEdit();
             m_textView->setReadOnly(true);
             m_textView->setWordWrapMode(QTextOption::NoWrap);
+            m_textView->setMaximumBlockCount(MaxLines);
 
             QVBoxLayout* sizer = new QVBoxLayout();
             sizer->setContentsMargins(0, 0, 0, 0);
@@ -60,28 +64,60 @@ namespace TrenchBroom {
         }
 
         void Console::logToConsole(const LogLevel level, const QString& message) {
+            auto scheduleFlush = false;
+            {
+                std::lock_guard<std::mutex> lock(m_pendingMutex);
+                scheduleFlush = m_pendingMessages.empty();
+                m_pendingMessages.push_back(Message{level, message});
+            }
+
+            if (scheduleFlush) {
+                QMetaObject::invokeMethod(this, [this]() { flushPendingMessages(); }, Qt::QueuedConnection);
+            }
+        }
+
+        static QTextCharFormat messageFormat(const LogLevel level, const QPalette& palette) {
             // NOTE: QPalette::Text is the correct color role for contrast against QPalette::Base
             // which is the background of text entry widgets 
             QTextCharFormat format;
             switch (level) {
                 case LogLevel::Debug:
-                    format.setForeground(QBrush(m_textView->palette().color(QPalette::Disabled, QPalette::Text)));
+                    format.setForeground(QBrush(palette.color(QPalette::Disabled, QPalette::Text)));
                     break;
                 case LogLevel::Info:
                     break;
                 case LogLevel::Warn:
-                    format.setForeground(QBrush(m_textView->palette().color(QPalette::Active, QPalette::Text)));
+                    format.setForeground(QBrush(palette.color(QPalette::Active, QPalette::Text)));
                     break;
                 case LogLevel::Error:
                     format.setForeground(QBrush(QColor(250, 30, 60)));
                     break;
             }
             format.setFont(Fonts::fixedWidthFont());
+            return format;
+        }
+
+        void Console::flushPendingMessages() {
+            auto messages = std::vector<Message>{};
+            {
+                std::lock_guard<std::mutex> lock(m_pendingMutex);
+                std::swap(messages, m_pendingMessages);
+            }
+
+            // only the last MaxLines messages can remain visible
+            const auto first = messages.size() > size_t(MaxLines) ? messages.size() - size_t(MaxLines) : size_t(0);
 
             QTextCursor cursor(m_textView->document());
             cursor.movePosition(QTextCursor::MoveOperation::End);
-            cursor.insertText(message, format);
-            cursor.insertText("\n");
+            cursor.beginEditBlock();
+            for (size_t i = first; i < messages.size(); ++i) {
+                const auto& [level, message] = messages[i];
+                const auto format = messageFormat(level, m_textView->palette());
+
+                cursor.insertText(message, format);
+                cursor.insertText("\n");
+            }
+            cursor.endEditBlock();
 
             m_textView->moveCursor(QTextCursor::MoveOperation::End);
         }
@@ -22,17 +22,39 @@
 #include "Logger.h"
 #include "View/TabBook.h"
 
+#include <mutex>
 #include <string>
+#include <vector>
 
-class QTextEdit;
-class QString;
+#include <QString>
+
+class QPlainTextEdit;
 class QWidget;
 
 namespace TrenchBroom {
     namespace View {
+        /**
+         * Shows the log messages in a text view.
+         *
+         * Messages are not appended to the view immediately. Instead, they are queued and appended in a single batch
+         * once control returns to the event loop, so that logging thousands of messages (e.g. parser warnings or the
+         * output of compilation tools) only lays out the text view once. Messages may be logged from any thread.
+         *
+         * The view only retains the most recent MaxLines lines.
+         */
         class Console : public TabBookPage, public Logger {
         private:
-            QTextEdit* m_textView;
+            static const int MaxLines = 10000;
+
+            struct Message {
+                LogLevel level;
+                QString str;
+            };
+
+            QPlainTextEdit* m_textView;
+
+            std::mutex m_pendingMutex;
+            std::vector<Message> m_pendingMessages;
         public:
             explicit Console(QWidget* parent = nullptr);
         private:
@@ -40,6 +62,7 @@ namespace TrenchBroom {
             void doLog(LogLevel level, const QString& message) override;
             void logToDebugOut(LogLevel level, const QString& message);
             void logToConsole(LogLevel level, const QString& message);
+            void flushPendingMessages();
         };
     }
 }
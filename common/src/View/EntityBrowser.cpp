@@ -135,7 +135,7 @@ namespace TrenchBroom {
             m_notifierConnection += document->documentWasLoadedNotifier.connect(this, &EntityBrowser::documentWasLoaded);
             m_notifierConnection += document->modsDidChangeNotifier.connect(this, &EntityBrowser::modsDidChange);
             m_notifierConnection += document->entityDefinitionsDidChangeNotifier.connect(this, &EntityBrowser::entityDefinitionsDidChange);
-            m_notifierConnection += document->nodesDidChangeNotifier.connect(this, &EntityBrowser::nodesDidChange);
+            m_notifierConnection += document->coalescedNodesDidChangeNotifier.connect(this, &EntityBrowser::nodesDidChange);
 
             PreferenceManager& prefs = PreferenceManager::instance();
             m_notifierConnection += prefs.preferenceDidChangeNotifier.connect(this, &EntityBrowser::preferenceDidChange);
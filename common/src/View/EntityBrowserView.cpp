@@ -29,6 +29,7 @@
 #include "Assets/EntityDefinitionManager.h"
 #include "Assets/EntityModel.h"
 #include "Assets/EntityModelManager.h"
+#include "Assets/ModelDefinition.h"
 #include "Renderer/GL.h"
 #include "Renderer/FontDescriptor.h"
 #include "Renderer/FontManager.h"
@@ -143,6 +144,9 @@ namespace TrenchBroom {
 
             const Renderer::FontDescriptor font(fontPath, static_cast<size_t>(fontSize));
 
+            releaseRenderers();
+            const auto specs = loadModels();
+
             if (m_group) {
                 for (const auto& group : m_entityDefinitionManager.groups()) {
                     const auto& definitions = group.definitions(Assets::EntityDefinitionType::PointEntity, m_sortOrder);
@@ -153,7 +157,7 @@ namespace TrenchBroom {
 
                         for (const auto* definition : definitions) {
                             const auto* pointEntityDefinition = static_cast<const Assets::PointEntityDefinition*>(definition);
-                            addEntityToLayout(layout, pointEntityDefinition, font);
+                            addEntityToLayout(layout, pointEntityDefinition, specs, font);
                         }
                     }
                 }
@@ -161,7 +165,7 @@ namespace TrenchBroom {
                 const auto& definitions = m_entityDefinitionManager.definitions(Assets::EntityDefinitionType::PointEntity, m_sortOrder);
                 for (const auto* definition : definitions) {
                     const auto* pointEntityDefinition = static_cast<const Assets::PointEntityDefinition*>(definition);
-                    addEntityToLayout(layout, pointEntityDefinition, font);
+                    addEntityToLayout(layout, pointEntityDefinition, specs, font);
                 }
             }
         }
@@ -176,16 +180,46 @@ namespace TrenchBroom {
             return prefix + name;
         }
 
-        void EntityBrowserView::addEntityToLayout(Layout& layout, const Assets::PointEntityDefinition* definition, const Renderer::FontDescriptor& font) {
-            if ((!m_hideUnused || definition->usageCount() > 0) &&
-                (m_filterText.empty() || kdl::ci::str_contains(definition->name(), m_filterText))) {
+        bool EntityBrowserView::isDefinitionVisible(const Assets::PointEntityDefinition* definition) const {
+            return (!m_hideUnused || definition->usageCount() > 0) &&
+                   (m_filterText.empty() || kdl::ci::str_contains(definition->name(), m_filterText));
+        }
+
+        Assets::ModelSpecification EntityBrowserView::modelSpecification(const Assets::PointEntityDefinition* definition) const {
+            return Assets::safeGetModelSpecification(m_logger, definition->name(), [&]() {
+                return definition->defaultModel();
+            });
+        }
 
+        EntityBrowserView::ModelSpecifications EntityBrowserView::loadModels() {
+            auto specs = ModelSpecifications{};
+            auto specsToLoad = std::vector<Assets::ModelSpecification>{};
+            for (const auto* definition : m_entityDefinitionManager.definitions(Assets::EntityDefinitionType::PointEntity, m_sortOrder)) {
+                const auto* pointEntityDefinition = static_cast<const Assets::PointEntityDefinition*>(definition);
+                if (isDefinitionVisible(pointEntityDefinition)) {
+                    const auto spec = modelSpecification(pointEntityDefinition);
+                    specs.emplace(pointEntityDefinition, spec);
+                    specsToLoad.push_back(spec);
+                }
+            }
+            m_entityModelManager.loadModels(specsToLoad);
+            return specs;
+        }
+
+        void EntityBrowserView::releaseRenderers() {
+            for (const auto* renderer : m_acquiredRenderers) {
+                m_entityModelManager.releaseRenderer(renderer);
+            }
+            m_acquiredRenderers.clear();
+        }
+
+        void EntityBrowserView::addEntityToLayout(Layout& layout, const Assets::PointEntityDefinition* definition, const ModelSpecifications& specs, const Renderer::FontDescriptor& font) {
+            const auto it = specs.find(definition);
+            if (it != std::end(specs)) {
                 const auto maxCellWidth = layout.maxCellWidth();
                 const auto actualFont = fontManager().selectFontSize(font, definition->name(), maxCellWidth, 5);
                 const auto actualSize = fontManager().font(actualFont).measure(definition->name());
-                const auto spec = Assets::safeGetModelSpecification(m_logger, definition->name(), [&]() {
-                    return definition->defaultModel();
-                });
+                const auto& spec = it->second;
 
                 const auto* frame = m_entityModelManager.frame(spec);
                 Renderer::TexturedRenderer* modelRenderer = nullptr;
@@ -196,7 +230,10 @@ namespace TrenchBroom {
                     const auto center = bounds.center();
                     const auto transform =vm::translation_matrix(center) * vm::rotation_matrix(m_rotation) *vm::translation_matrix(-center);
                     rotatedBounds = bounds.transform(transform);
-                    modelRenderer = m_entityModelManager.renderer(spec);
+                    modelRenderer = m_entityModelManager.acquireRenderer(spec);
+                    if (modelRenderer != nullptr) {
+                        m_acquiredRenderers.push_back(modelRenderer);
+                    }
                 } else {
                     rotatedBounds = vm::bbox3f(definition->bounds());
                     const auto center = rotatedBounds.center();
@@ -213,7 +250,9 @@ namespace TrenchBroom {
             }
         }
 
-        void EntityBrowserView::doClear() {}
+        void EntityBrowserView::doClear() {
+            releaseRenderers();
+        }
 
         void EntityBrowserView::doRender(Layout& layout, const float y, const float height) {
             const float viewLeft      = static_cast<float>(0);
@@ -259,10 +298,12 @@ namespace TrenchBroom {
             using BoundsVertex = Renderer::GLVertexTypes::P3C4::Vertex;
             std::vector<BoundsVertex> vertices;
 
-            for (size_t i = 0; i < layout.size(); ++i) {
+            const auto [firstGroup, lastGroup] = layout.visibleGroups(y, height);
+            for (size_t i = firstGroup; i < lastGroup; ++i) {
                 const auto& group = layout[i];
                 if (group.intersectsY(y, height)) {
-                    for (size_t j = 0; j < group.size(); ++j) {
+                    const auto [firstRow, lastRow] = group.visibleRows(y, height);
+                    for (size_t j = firstRow; j < lastRow; ++j) {
                         const auto& row = group[j];
                         if (row.intersectsY(y, height)) {
                             for (size_t k = 0; k < row.size(); ++k) {
@@ -292,6 +333,7 @@ namespace TrenchBroom {
         void EntityBrowserView::renderModels(Layout& layout, const float y, const float height, Renderer::Transformation& transformation) {
             Renderer::ActiveShader shader(shaderManager(), Renderer::Shaders::EntityModelShader);
             shader.set("ApplyTinting", false);
+            shader.set("ApplyTexture", true);
             shader.set("Brightness", pref(Preferences::Brightness));
             shader.set("GrayScale", false);
 
@@ -299,10 +341,12 @@ namespace TrenchBroom {
 
             m_entityModelManager.prepare(vboManager());
 
-            for (size_t i = 0; i < layout.size(); ++i) {
+            const auto [firstGroup, lastGroup] = layout.visibleGroups(y, height);
+            for (size_t i = firstGroup; i < lastGroup; ++i) {
                 const auto& group = layout[i];
                 if (group.intersectsY(y, height)) {
-                    for (size_t j = 0; j < group.size(); ++j) {
+                    const auto [firstRow, lastRow] = group.visibleRows(y, height);
+                    for (size_t j = firstRow; j < lastRow; ++j) {
                         const auto& row = group[j];
                         if (row.intersectsY(y, height)) {
                             for (size_t k = 0; k < row.size(); ++k) {
@@ -335,7 +379,8 @@ namespace TrenchBroom {
             using Vertex = Renderer::GLVertexTypes::P2::Vertex;
             std::vector<Vertex> vertices;
 
-            for (size_t i = 0; i < layout.size(); ++i) {
+            const auto [firstGroup, lastGroup] = layout.visibleGroups(y, height);
+            for (size_t i = firstGroup; i < lastGroup; ++i) {
                 const auto& group = layout[i];
                 if (group.intersectsY(y, height)) {
                     const LayoutBounds titleBounds = layout.titleBoundsForVisibleRect(group, y, height);
@@ -387,7 +432,8 @@ namespace TrenchBroom {
             const std::vector<Color> textColor{ pref(Preferences::BrowserTextColor) };
 
             StringMap stringVertices;
-            for (size_t i = 0; i < layout.size(); ++i) {
+            const auto [firstGroup, lastGroup] = layout.visibleGroups(y, height);
+            for (size_t i = firstGroup; i < lastGroup; ++i) {
                 const auto& group = layout[i];
                 if (group.intersectsY(y, height)) {
                     const auto& title = group.item();
@@ -406,7 +452,8 @@ namespace TrenchBroom {
                         allTitleVertices = kdl::vec_concat(std::move(allTitleVertices), titleVertices);
                     }
 
-                    for (size_t j = 0; j < group.size(); ++j) {
+                    const auto [firstRow, lastRow] = group.visibleRows(y, height);
+                    for (size_t j = firstRow; j < lastRow; ++j) {
                         const auto& row = group[j];
                         if (row.intersectsY(y, height)) {
                             for (unsigned int k = 0; k < row.size(); k++) {
@@ -28,6 +28,7 @@
 #include <vecmath/quat.h>
 #include <vecmath/bbox.h>
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -38,6 +39,7 @@ namespace TrenchBroom {
         class EntityDefinitionManager;
         enum class EntityDefinitionSortOrder;
         class EntityModelManager;
+        struct ModelSpecification;
         class PointEntityDefinition;
     }
 
@@ -80,6 +82,12 @@ namespace TrenchBroom {
             Assets::EntityDefinitionSortOrder m_sortOrder;
             std::string m_filterText;
 
+            /**
+             * The model renderers used by the cells of the current layout. They are acquired from the entity model
+             * manager so that they are not evicted while the layout refers to them.
+             */
+            std::vector<const EntityRenderer*> m_acquiredRenderers;
+
             NotifierConnection m_notifierConnection;
         public:
             EntityBrowserView(QScrollBar* scrollBar,
@@ -100,7 +108,19 @@ namespace TrenchBroom {
             bool dndEnabled() override;
             QString dndData(const Cell& cell) override;
 
-            void addEntityToLayout(Layout& layout, const Assets::PointEntityDefinition* definition, const Renderer::FontDescriptor& font);
+            bool isDefinitionVisible(const Assets::PointEntityDefinition* definition) const;
+            Assets::ModelSpecification modelSpecification(const Assets::PointEntityDefinition* definition) const;
+
+            using ModelSpecifications = std::map<const Assets::PointEntityDefinition*, Assets::ModelSpecification>;
+
+            /**
+             * Loads the models of all visible cells at once so that they are parsed concurrently instead of one by one
+             * while the cells are added to the layout. Returns the model specifications of the visible definitions,
+             * which are then used to add the cells.
+             */
+            ModelSpecifications loadModels();
+            void releaseRenderers();
+            void addEntityToLayout(Layout& layout, const Assets::PointEntityDefinition* definition, const ModelSpecifications& specs, const Renderer::FontDescriptor& font);
 
             void doClear() override;
             void doRender(Layout& layout, float y, float height) override;
@@ -24,6 +24,7 @@
 #include "Model/EntityNodeBase.h"
 #include "View/EntityPropertyGrid.h"
 #include "View/MapDocument.h"
+#include "View/SignalDelayer.h"
 #include "View/SmartPropertyEditorManager.h"
 #include "View/Splitter.h"
 #include "View/QtUtils.h"
@@ -47,9 +48,11 @@ namespace TrenchBroom {
         m_propertyGrid(nullptr),
         m_smartEditorManager(nullptr),
         m_documentationText(nullptr),
-        m_currentDefinition(nullptr) {
-        createGui(document);
-        connectObservers();
+        m_currentDefinition(nullptr),
+        m_updateSignalDelayer(new SignalDelayer(this)) {
+            createGui(document);
+            connectObservers();
+            connect(m_updateSignalDelayer, &SignalDelayer::processSignal, this, &EntityPropertyEditor::updateIfSelectedEntityDefinitionChanged);
         }
 
         EntityPropertyEditor::~EntityPropertyEditor() {
@@ -63,15 +66,15 @@ namespace TrenchBroom {
         void EntityPropertyEditor::connectObservers() {
             auto document = kdl::mem_lock(m_document);
             m_notifierConnection += document->selectionDidChangeNotifier.connect(this, &EntityPropertyEditor::selectionDidChange);
-            m_notifierConnection += document->nodesDidChangeNotifier.connect(this, &EntityPropertyEditor::nodesDidChange);
+            m_notifierConnection += document->coalescedNodesDidChangeNotifier.connect(this, &EntityPropertyEditor::nodesDidChange);
         }
 
         void EntityPropertyEditor::selectionDidChange(const Selection&) {
-            updateIfSelectedEntityDefinitionChanged();
+            m_updateSignalDelayer->queueSignal();
         }
 
         void EntityPropertyEditor::nodesDidChange(const std::vector<Model::Node*>&) {
-            updateIfSelectedEntityDefinitionChanged();
+            m_updateSignalDelayer->queueSignal();
         }
 
         void EntityPropertyEditor::updateIfSelectedEntityDefinitionChanged() {
@@ -44,6 +44,7 @@ namespace TrenchBroom {
         class EntityPropertyGrid;
         class MapDocument;
         class Selection;
+        class SignalDelayer;
         class SmartPropertyEditorManager;
 
         /**
@@ -59,6 +60,7 @@ namespace TrenchBroom {
             SmartPropertyEditorManager* m_smartEditorManager;
             QTextEdit* m_documentationText;
             const Assets::EntityDefinition* m_currentDefinition;
+            SignalDelayer* m_updateSignalDelayer;
 
             NotifierConnection m_notifierConnection;
         public:
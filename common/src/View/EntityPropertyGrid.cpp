@@ -26,6 +26,7 @@
 #include "View/EntityPropertyModel.h"
 #include "View/EntityPropertyTable.h"
 #include "View/MapDocument.h"
+#include "View/SignalDelayer.h"
 #include "View/ViewConstants.h"
 #include "View/QtUtils.h"
 
@@ -45,7 +46,6 @@
 #include <QDebug>
 #include <QKeyEvent>
 #include <QSortFilterProxyModel>
-#include <QTimer>
 
 #define GRID_LOG(x)
 
@@ -53,9 +53,11 @@ namespace TrenchBroom {
     namespace View {
         EntityPropertyGrid::EntityPropertyGrid(std::weak_ptr<MapDocument> document, QWidget* parent) :
         QWidget(parent),
-        m_document(document) {
+        m_document(document),
+        m_updateControlsSignalDelayer{new SignalDelayer{this}} {
             createGui(document);
             connectObservers();
+            connect(m_updateControlsSignalDelayer, &SignalDelayer::processSignal, this, &EntityPropertyGrid::updateControlsNow);
         }
 
         void EntityPropertyGrid::backupSelection() {
@@ -301,23 +303,31 @@ namespace TrenchBroom {
             auto document = kdl::mem_lock(m_document);
             m_notifierConnection += document->documentWasNewedNotifier.connect(this, &EntityPropertyGrid::documentWasNewed);
             m_notifierConnection += document->documentWasLoadedNotifier.connect(this, &EntityPropertyGrid::documentWasLoaded);
-            m_notifierConnection += document->nodesDidChangeNotifier.connect(this, &EntityPropertyGrid::nodesDidChange);
+            m_notifierConnection += document->coalescedNodesDidChangeNotifier.connect(this, &EntityPropertyGrid::nodesDidChange);
+            m_notifierConnection += document->nodesWereRemovedNotifier.connect(this, &EntityPropertyGrid::nodesWereRemoved);
             m_notifierConnection += document->selectionWillChangeNotifier.connect(this, &EntityPropertyGrid::selectionWillChange);
             m_notifierConnection += document->selectionDidChangeNotifier.connect(this, &EntityPropertyGrid::selectionDidChange);
         }
 
         void EntityPropertyGrid::documentWasNewed(MapDocument*) {
+            m_model->clearNodes();
             updateControls();
         }
 
         void EntityPropertyGrid::documentWasLoaded(MapDocument*) {
+            m_model->clearNodes();
             updateControls();
         }
 
-        void EntityPropertyGrid::nodesDidChange(const std::vector<Model::Node*>&) {
+        void EntityPropertyGrid::nodesDidChange(const std::vector<Model::Node*>& nodes) {
+            m_model->nodesDidChange(nodes);
             updateControls();
         }
 
+        void EntityPropertyGrid::nodesWereRemoved(const std::vector<Model::Node*>& nodes) {
+            m_model->nodesWereRemoved(nodes);
+        }
+
         void EntityPropertyGrid::selectionWillChange() {
         }
 
@@ -330,18 +340,22 @@ namespace TrenchBroom {
             // is selected. If we call this directly, it'll cause the table to be rebuilt based on that intermediate
             // state. Everything is fine except you lose the selected row in the table, unless it's a key
             // name that exists in worldspawn. To avoid that problem, make a delayed call to update the table.
-            QTimer::singleShot(0, this, [&](){
-                m_model->updateFromMapDocument();
+            // Several notifications in a row, e.g. from the steps of a repeated command, only need one update.
+            m_updateControlsSignalDelayer->queueSignal();
+        }
 
-                if (m_table->selectionModel()->selectedIndexes().empty()) {
-                    restoreSelection();
-                }
-                ensureSelectionVisible();
+        void EntityPropertyGrid::updateControlsNow() {
+            m_model->updateFromMapDocument();
+
+            if (m_table->selectionModel()->selectedIndexes().empty()) {
+                restoreSelection();
+            }
+            ensureSelectionVisible();
+
+            const auto shouldShowProtectedProperties = m_model->shouldShowProtectedProperties();
+            m_table->setColumnHidden(EntityPropertyModel::ColumnProtected, !shouldShowProtectedProperties);
+            m_addProtectedPropertyButton->setHidden(!shouldShowProtectedProperties);
 
-                const auto shouldShowProtectedProperties = m_model->shouldShowProtectedProperties();
-                m_table->setColumnHidden(EntityPropertyModel::ColumnProtected, !shouldShowProtectedProperties);
-                m_addProtectedPropertyButton->setHidden(!shouldShowProtectedProperties);
-            });
             updateControlsEnabled();
         }
 
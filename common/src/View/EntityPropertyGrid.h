@@ -43,6 +43,7 @@ namespace TrenchBroom {
         class EntityPropertyTable;
         class MapDocument;
         class Selection;
+        class SignalDelayer;
 
         struct PropertyGridSelection {
             std::string propertyKey;
@@ -66,6 +67,7 @@ namespace TrenchBroom {
             QAbstractButton* m_removePropertiesButton;
             QCheckBox* m_showDefaultPropertiesCheckBox;
             std::vector<PropertyGridSelection> m_selectionBackup;
+            SignalDelayer* m_updateControlsSignalDelayer;
 
             NotifierConnection m_notifierConnection;
         public:
@@ -87,12 +89,14 @@ namespace TrenchBroom {
             void documentWasNewed(MapDocument* document);
             void documentWasLoaded(MapDocument* document);
             void nodesDidChange(const std::vector<Model::Node*>& nodes);
+            void nodesWereRemoved(const std::vector<Model::Node*>& nodes);
             void selectionWillChange();
             void selectionDidChange(const Selection& selection);
             void entityDefinitionsOrModsDidChange();
         private:
             void ensureSelectionVisible();
             void updateControls();
+            void updateControlsNow();
             void updateControlsEnabled();
         public:
             std::string selectedRowName() const;
@@ -24,13 +24,17 @@
 #include "Assets/EntityDefinitionManager.h"
 #include "Assets/PropertyDefinition.h"
 #include "IO/ResourceUtils.h"
+#include "Model/BrushNode.h"
 #include "Model/Entity.h"
+#include "Model/EntityNode.h"
 #include "Model/EntityNodeBase.h"
 #include "Model/EntityNodeIndex.h"
 #include "Model/EntityProperties.h"
 #include "Model/Group.h"
 #include "Model/GroupNode.h"
+#include "Model/LayerNode.h"
 #include "Model/ModelUtils.h"
+#include "Model/PatchNode.h"
 #include "Model/WorldNode.h"
 #include "View/MapDocument.h"
 #include "View/ViewConstants.h"
@@ -38,10 +42,12 @@
 
 #include <kdl/map_utils.h>
 #include <kdl/memory_utils.h>
+#include <kdl/overload.h>
 #include <kdl/string_utils.h>
 #include <kdl/vector_utils.h>
 #include <kdl/vector_set.h>
 
+#include <algorithm>
 #include <cassert>
 #include <iterator>
 #include <map>
@@ -62,21 +68,25 @@
 namespace TrenchBroom {
     namespace View {
         // helper functions
+        static bool isReservedWorldspawnProperty(const std::string& key) {
+            return key == Model::PropertyKeys::Classname
+                || key == Model::PropertyKeys::Mods
+                || key == Model::PropertyKeys::EntityDefinitions
+                || key == Model::PropertyKeys::Wad
+                || key == Model::PropertyKeys::Textures
+                || key == Model::PropertyKeys::SoftMapBounds
+                || key == Model::PropertyKeys::LayerColor
+                || key == Model::PropertyKeys::LayerLocked
+                || key == Model::PropertyKeys::LayerHidden
+                || key == Model::PropertyKeys::LayerOmitFromExport;
+        }
+
         static bool isPropertyKeyMutable(const Model::Entity& entity, const std::string& key) {
             assert(!Model::isGroup(entity.classname(), entity.properties()));
             assert(!Model::isLayer(entity.classname(), entity.properties()));
 
             if (Model::isWorldspawn(entity.classname(), entity.properties())) {
-                return !(key == Model::PropertyKeys::Classname
-                    || key == Model::PropertyKeys::Mods
-                    || key == Model::PropertyKeys::EntityDefinitions
-                    || key == Model::PropertyKeys::Wad
-                    || key == Model::PropertyKeys::Textures
-                    || key == Model::PropertyKeys::SoftMapBounds
-                    || key == Model::PropertyKeys::LayerColor
-                    || key == Model::PropertyKeys::LayerLocked
-                    || key == Model::PropertyKeys::LayerHidden
-                    || key == Model::PropertyKeys::LayerOmitFromExport);
+                return !isReservedWorldspawnProperty(key);
             }
 
             return true;
@@ -87,16 +97,7 @@ namespace TrenchBroom {
             assert(!Model::isLayer(entity.classname(), entity.properties()));
 
             if (Model::isWorldspawn(entity.classname(), entity.properties())) {
-                return !(key == Model::PropertyKeys::Classname
-                    || key == Model::PropertyKeys::Mods
-                    || key == Model::PropertyKeys::EntityDefinitions
-                    || key == Model::PropertyKeys::Wad
-                    || key == Model::PropertyKeys::Textures
-                    || key == Model::PropertyKeys::SoftMapBounds
-                    || key == Model::PropertyKeys::LayerColor
-                    || key == Model::PropertyKeys::LayerLocked
-                    || key == Model::PropertyKeys::LayerHidden
-                    || key == Model::PropertyKeys::LayerOmitFromExport);
+                return !isReservedWorldspawnProperty(key);
             }
 
             return true;
@@ -161,6 +162,15 @@ namespace TrenchBroom {
             return false;
         }
 
+        PropertyRow::PropertyRow(std::string key, std::string value, const ValueType valueType, const bool keyMutable, const bool valueMutable, const PropertyProtection protection, std::string tooltip) :
+        m_key(std::move(key)),
+        m_value(std::move(value)),
+        m_valueType(valueType),
+        m_keyMutable(keyMutable),
+        m_valueMutable(valueMutable),
+        m_protected(protection),
+        m_tooltip(std::move(tooltip)) {}
+
         PropertyRow::PropertyRow(const std::string& key, const Model::EntityNodeBase* node) :
             m_key(key) {
             const Assets::PropertyDefinition* definition = Model::propertyDefinition(node, key);
@@ -324,6 +334,218 @@ namespace TrenchBroom {
             // unreachable
         }
 
+        // PropertyAggregate
+
+        void PropertyAggregate::update(const std::vector<Model::EntityNodeBase*>& nodes) {
+            const auto nodeSet = std::unordered_set<const Model::EntityNodeBase*>(std::begin(nodes), std::end(nodes));
+
+            // subtract the nodes which are no longer part of the aggregate; the nodes may have been deleted, so
+            // they must not be dereferenced
+            for (auto it = std::begin(m_nodes); it != std::end(m_nodes);) {
+                if (nodeSet.count(it->first) == 0u) {
+                    subtractSnapshot(it->second);
+                    m_invalidNodes.erase(it->first);
+                    it = m_nodes.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+
+            for (const auto* node : nodes) {
+                const auto it = m_nodes.find(node);
+                if (it == std::end(m_nodes)) {
+                    addNode(node);
+                } else if (m_invalidNodes.count(node) > 0u
+                    || it->second.definition != node->entity().definition()
+                    || it->second.protectable != (Model::findContainingLinkedGroup(*node) != nullptr)) {
+                    // entity definitions and linked groups can change without notifying us about the node
+                    subtractSnapshot(it->second);
+                    m_nodes.erase(it);
+                    addNode(node);
+                }
+            }
+            m_invalidNodes.clear();
+        }
+
+        void PropertyAggregate::invalidateNode(const Model::EntityNodeBase* node) {
+            if (m_nodes.count(node) > 0u) {
+                m_invalidNodes.insert(node);
+            }
+        }
+
+        void PropertyAggregate::removeNode(const Model::EntityNodeBase* node) {
+            const auto it = m_nodes.find(node);
+            if (it != std::end(m_nodes)) {
+                subtractSnapshot(it->second);
+                m_nodes.erase(it);
+            }
+            m_invalidNodes.erase(node);
+        }
+
+        void PropertyAggregate::clear() {
+            m_nodes.clear();
+            m_invalidNodes.clear();
+            m_keys.clear();
+            m_protectedKeyCounts.clear();
+            m_definitionCounts.clear();
+            m_worldspawnCount = 0u;
+            m_protectableCount = 0u;
+        }
+
+        std::map<std::string, PropertyRow> PropertyAggregate::rows(const std::vector<Model::EntityNodeBase*>& nodes, const bool showDefaultRows, const bool showProtectedProperties) const {
+            assert(nodes.size() == m_nodes.size());
+
+            auto keys = kdl::vector_set<std::string>{};
+            for (const auto& [key, stats] : m_keys) {
+                keys.insert(key);
+            }
+            if (showDefaultRows) {
+                for (const auto& [definition, count] : m_definitionCounts) {
+                    if (definition != nullptr) {
+                        for (const auto& propertyDefinition : definition->propertyDefinitions()) {
+                            keys.insert(propertyDefinition->key());
+                        }
+                    }
+                }
+            }
+            if (showProtectedProperties) {
+                for (const auto& [key, count] : m_protectedKeyCounts) {
+                    keys.insert(key);
+                }
+            }
+
+            auto result = std::map<std::string, PropertyRow>{};
+            if (nodes.empty()) {
+                return result;
+            }
+
+            // like PropertyRow::rowForEntityNodes, take the tooltip and the default value from the first node
+            const auto* firstNode = nodes.front();
+            for (const auto& key : keys) {
+                const auto* definition = Model::propertyDefinition(firstNode, key);
+
+                auto value = std::string{};
+                auto valueType = ValueType::Unset;
+
+                const auto statsIt = m_keys.find(key);
+                if (statsIt == std::end(m_keys)) {
+                    if (definition != nullptr) {
+                        value = Assets::PropertyDefinition::defaultValue(*definition);
+                    }
+                } else {
+                    const auto& stats = statsIt->second;
+                    value = std::begin(stats.valueCounts)->first;
+                    if (stats.valueCounts.size() > 1u) {
+                        valueType = ValueType::MultipleValues;
+                    } else if (stats.setCount == m_nodes.size()) {
+                        valueType = ValueType::SingleValue;
+                    } else {
+                        valueType = ValueType::SingleValueAndUnset;
+                    }
+                }
+
+                const auto mutableKey = m_worldspawnCount == 0u || !isReservedWorldspawnProperty(key);
+                auto tooltip = definition != nullptr ? definition->shortDescription() : "";
+                if (tooltip.empty()) {
+                    tooltip = "No description found";
+                }
+
+                result.emplace(key, PropertyRow{key, std::move(value), valueType, mutableKey, mutableKey, protection(key), std::move(tooltip)});
+            }
+
+            return result;
+        }
+
+        bool PropertyAggregate::allNodesProtectable() const {
+            return !m_nodes.empty() && m_protectableCount == m_nodes.size();
+        }
+
+        void PropertyAggregate::addNode(const Model::EntityNodeBase* node) {
+            const auto& entity = node->entity();
+            auto snapshot = NodeSnapshot{
+                entity.properties(),
+                entity.protectedProperties(),
+                entity.definition(),
+                Model::isWorldspawn(entity.classname(), entity.properties()),
+                Model::findContainingLinkedGroup(*node) != nullptr
+            };
+
+            for (const auto& property : snapshot.properties) {
+                auto& stats = m_keys[property.key()];
+                ++stats.setCount;
+                ++stats.valueCounts[property.value()];
+            }
+            for (const auto& key : snapshot.protectedProperties) {
+                ++m_protectedKeyCounts[key];
+            }
+            ++m_definitionCounts[snapshot.definition];
+            if (snapshot.worldspawn) {
+                ++m_worldspawnCount;
+            }
+            if (snapshot.protectable) {
+                ++m_protectableCount;
+            }
+
+            m_nodes.emplace(node, std::move(snapshot));
+        }
+
+        template <typename K, typename V>
+        static void decrementCount(std::map<K, V>& counts, const K& key) {
+            const auto it = counts.find(key);
+            assert(it != std::end(counts));
+            if (--it->second == 0u) {
+                counts.erase(it);
+            }
+        }
+
+        void PropertyAggregate::subtractSnapshot(const NodeSnapshot& snapshot) {
+            for (const auto& property : snapshot.properties) {
+                const auto it = m_keys.find(property.key());
+                assert(it != std::end(m_keys));
+                decrementCount(it->second.valueCounts, property.value());
+                if (--it->second.setCount == 0u) {
+                    m_keys.erase(it);
+                }
+            }
+            for (const auto& key : snapshot.protectedProperties) {
+                decrementCount(m_protectedKeyCounts, key);
+            }
+            decrementCount(m_definitionCounts, snapshot.definition);
+            if (snapshot.worldspawn) {
+                --m_worldspawnCount;
+            }
+            if (snapshot.protectable) {
+                --m_protectableCount;
+            }
+        }
+
+        PropertyProtection PropertyAggregate::protection(const std::string& key) const {
+            if (key == Model::PropertyKeys::Origin || !allNodesProtectable()) {
+                return PropertyProtection::NotProtectable;
+            }
+
+            const auto matchesKey = [&](const std::string& protectedKey) {
+                return Model::isNumberedProperty(protectedKey, key);
+            };
+
+            // protected properties are rare, so only look at the individual nodes if any of them might match
+            if (std::none_of(std::begin(m_protectedKeyCounts), std::end(m_protectedKeyCounts), [&](const auto& entry) { return matchesKey(entry.first); })) {
+                return PropertyProtection::NotProtected;
+            }
+
+            auto protectedCount = size_t(0);
+            for (const auto& [node, snapshot] : m_nodes) {
+                if (std::any_of(std::begin(snapshot.protectedProperties), std::end(snapshot.protectedProperties), matchesKey)) {
+                    ++protectedCount;
+                }
+            }
+
+            if (protectedCount == m_nodes.size()) {
+                return PropertyProtection::Protected;
+            }
+            return protectedCount == 0u ? PropertyProtection::NotProtected : PropertyProtection::Mixed;
+        }
+
         // EntityPropertyModel
 
         EntityPropertyModel::EntityPropertyModel(std::weak_ptr<MapDocument> document, QObject* parent) :
@@ -592,31 +814,43 @@ namespace TrenchBroom {
             return result;
         }
 
-        static bool computeShouldShowProtectedProperties(const std::vector<Model::EntityNodeBase*>& entityNodes) {
-            if (entityNodes.empty()) {
-                return false;
-            }
-
-            for (const auto* entityNode : entityNodes) {
-                if (Model::findContainingLinkedGroup(*entityNode) == nullptr) {
-                    return false;
-                }
-            }
-
-            return true;
-        }
-
         void EntityPropertyModel::updateFromMapDocument() {
             MODEL_LOG(qDebug() << "updateFromMapDocument");
 
             auto document = kdl::mem_lock(m_document);
 
             const auto entityNodes = document->allSelectedEntityNodes();
+            m_aggregate.update(entityNodes);
             const std::map<std::string, PropertyRow> rowsMap =
-                PropertyRow::rowsForEntityNodes(entityNodes, m_showDefaultRows, true);
+                m_aggregate.rows(entityNodes, m_showDefaultRows, true);
 
             setRows(rowsMap);
-            m_shouldShowProtectedProperties = computeShouldShowProtectedProperties(entityNodes);
+            m_shouldShowProtectedProperties = m_aggregate.allNodesProtectable();
+        }
+
+        void EntityPropertyModel::nodesDidChange(const std::vector<Model::Node*>& nodes) {
+            for (const auto* node : nodes) {
+                if (const auto* entityNode = dynamic_cast<const Model::EntityNodeBase*>(node)) {
+                    m_aggregate.invalidateNode(entityNode);
+                }
+            }
+        }
+
+        void EntityPropertyModel::nodesWereRemoved(const std::vector<Model::Node*>& nodes) {
+            for (auto* node : nodes) {
+                node->accept(kdl::overload(
+                    [&](auto&& thisLambda, Model::WorldNode* world)   { m_aggregate.removeNode(world); world->visitChildren(thisLambda); },
+                    [] (auto&& thisLambda, Model::LayerNode* layer)   { layer->visitChildren(thisLambda); },
+                    [] (auto&& thisLambda, Model::GroupNode* group)   { group->visitChildren(thisLambda); },
+                    [&](auto&& thisLambda, Model::EntityNode* entity) { m_aggregate.removeNode(entity); entity->visitChildren(thisLambda); },
+                    [] (Model::BrushNode*)                            {},
+                    [] (Model::PatchNode*)                            {}
+                ));
+            }
+        }
+
+        void EntityPropertyModel::clearNodes() {
+            m_aggregate.clear();
         }
 
         int EntityPropertyModel::rowCount(const QModelIndex& parent) const {
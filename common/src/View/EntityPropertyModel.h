@@ -19,17 +19,26 @@
 
 #pragma once
 
+#include "Model/EntityProperties.h"
+
 #include <QAbstractTableModel>
 
 #include <map>
 #include <memory>
 #include <string>
 #include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom {
+    namespace Assets {
+        class EntityDefinition;
+    }
+
     namespace Model {
         class EntityNodeBase;
+        class Node;
     }
 
     namespace View {
@@ -77,6 +86,7 @@ namespace TrenchBroom {
         public:
             PropertyRow();
             PropertyRow(const std::string& key, const Model::EntityNodeBase* node);
+            PropertyRow(std::string key, std::string value, ValueType valueType, bool keyMutable, bool valueMutable, PropertyProtection protection, std::string tooltip);
             bool operator==(const PropertyRow& other) const;
             bool operator<(const PropertyRow& other) const;
             void merge(const Model::EntityNodeBase* other);
@@ -100,6 +110,77 @@ namespace TrenchBroom {
             static std::string newPropertyKeyForEntityNodes(const std::vector<Model::EntityNodeBase*>& nodes);
         };
 
+        /**
+         * Aggregates the properties of a set of entity nodes per key, so that the rows for a large selection can
+         * be updated from the nodes that were added, removed or changed instead of merging all nodes again.
+         *
+         * Every node contributes a snapshot of its properties, which is subtracted again when the node is removed
+         * or has changed. The aggregate cannot detect changes by itself; changed nodes must be invalidated.
+         *
+         * The rows are the same as those returned by PropertyRow::rowsForEntityNodes for the same nodes.
+         */
+        class PropertyAggregate {
+        private:
+            struct NodeSnapshot {
+                std::vector<Model::EntityProperty> properties;
+                std::vector<std::string> protectedProperties;
+                const Assets::EntityDefinition* definition;
+                bool worldspawn;
+                bool protectable;
+            };
+
+            struct KeyStats {
+                size_t setCount = 0u;
+                std::map<std::string, size_t> valueCounts;
+            };
+
+            std::unordered_map<const Model::EntityNodeBase*, NodeSnapshot> m_nodes;
+            std::unordered_set<const Model::EntityNodeBase*> m_invalidNodes;
+
+            std::map<std::string, KeyStats> m_keys;
+            std::map<std::string, size_t> m_protectedKeyCounts;
+            std::map<const Assets::EntityDefinition*, size_t> m_definitionCounts;
+            size_t m_worldspawnCount = 0u;
+            size_t m_protectableCount = 0u;
+        public:
+            /**
+             * Makes the aggregate contain exactly the given nodes. Only nodes that were not contained before, that
+             * were invalidated or whose entity definition changed are read.
+             */
+            void update(const std::vector<Model::EntityNodeBase*>& nodes);
+
+            /**
+             * Marks the given node as changed, so that it is read again by the next update.
+             */
+            void invalidateNode(const Model::EntityNodeBase* node);
+
+            /**
+             * Removes the given node immediately, e.g. because it was removed from the document and might be
+             * deleted before the next update.
+             */
+            void removeNode(const Model::EntityNodeBase* node);
+
+            /**
+             * Removes all nodes, e.g. because the document was replaced and the nodes will be deleted.
+             */
+            void clear();
+
+            /**
+             * Returns the rows for the nodes passed to the last update. The nodes must be passed again because
+             * tooltips and default values are taken from the first node.
+             */
+            std::map<std::string, PropertyRow> rows(const std::vector<Model::EntityNodeBase*>& nodes, bool showDefaultRows, bool showProtectedProperties) const;
+
+            /**
+             * Indicates whether the aggregate contains at least one node and every node belongs to a linked group.
+             */
+            bool allNodesProtectable() const;
+        private:
+            void addNode(const Model::EntityNodeBase* node);
+            void subtractSnapshot(const NodeSnapshot& snapshot);
+            PropertyProtection protection(const std::string& key) const;
+        };
+
         /**
          * Model for the QTableView.
          *
@@ -125,6 +206,7 @@ namespace TrenchBroom {
             static const int NumColumns = 3;
         private:
             std::vector<PropertyRow> m_rows;
+            PropertyAggregate m_aggregate;
             bool m_showDefaultRows;
             bool m_shouldShowProtectedProperties;
             std::weak_ptr<MapDocument> m_document;
@@ -150,6 +232,22 @@ namespace TrenchBroom {
             std::vector<std::string> getAllClassnames() const;
         public slots:
             void updateFromMapDocument();
+        public:
+            /**
+             * Must be called when nodes have changed, so that their properties are aggregated again by the next
+             * update.
+             */
+            void nodesDidChange(const std::vector<Model::Node*>& nodes);
+            /**
+             * Must be called when nodes are removed from the document. Forgets about the removed nodes and their
+             * descendants because they might be deleted before the next update.
+             */
+            void nodesWereRemoved(const std::vector<Model::Node*>& nodes);
+            /**
+             * Must be called when the document was newed or loaded, because the previous nodes are deleted without
+             * notifying us.
+             */
+            void clearNodes();
 
         public: // QAbstractTableModel overrides
             int rowCount(const QModelIndex& parent) const override;
@@ -467,10 +467,11 @@ namespace TrenchBroom {
             auto document = kdl::mem_lock(m_document);
             m_notifierConnection += document->documentWasNewedNotifier.connect(this, &FaceAttribsEditor::documentWasNewed);
             m_notifierConnection += document->documentWasLoadedNotifier.connect(this, &FaceAttribsEditor::documentWasLoaded);
-            m_notifierConnection += document->nodesDidChangeNotifier.connect(this, &FaceAttribsEditor::nodesDidChange);
+            m_notifierConnection += document->coalescedNodesDidChangeNotifier.connect(this, &FaceAttribsEditor::nodesDidChange);
             m_notifierConnection += document->brushFacesDidChangeNotifier.connect(this, &FaceAttribsEditor::brushFacesDidChange);
             m_notifierConnection += document->selectionDidChangeNotifier.connect(this, &FaceAttribsEditor::selectionDidChange);
             m_notifierConnection += document->textureCollectionsDidChangeNotifier.connect(this, &FaceAttribsEditor::textureCollectionsDidChange);
+            m_notifierConnection += document->textureCollectionsDidLoadNotifier.connect(this, &FaceAttribsEditor::textureCollectionsDidChange);
             m_notifierConnection += document->grid().gridDidChangeNotifier.connect(this, &FaceAttribsEditor::updateIncrements);
         }
 
@@ -25,17 +25,12 @@
 
 #include <vecmath/vec.h>
 
-#include <QElapsedTimer>
+#include <algorithm>
+
 #include <QMouseEvent>
 
 namespace TrenchBroom {
     namespace View {
-        static qint64 msecsSinceReference() {
-            QElapsedTimer timer;
-            timer.start();
-            return timer.msecsSinceReference();
-        }
-
         FlyModeHelper::FlyModeHelper(Renderer::Camera& camera) :
         m_camera(camera),
         m_forward(false),
@@ -44,12 +39,15 @@ namespace TrenchBroom {
         m_right(false),
         m_up(false),
         m_down(false),
-        m_lastPollTime(msecsSinceReference()) {}
+        m_lastPollTime(0),
+        m_lastFrameTime(0) {
+            m_timer.start();
+        }
 
         void FlyModeHelper::pollAndUpdate() {
-            const auto currentTime = msecsSinceReference();
-            const auto time = float(currentTime - m_lastPollTime);
-            m_lastPollTime = currentTime;
+            // if no frame was presented since the last call, the frame time is not known yet and the camera stays
+            const auto time = float(m_lastFrameTime - m_lastPollTime) / 1000000.0f; // in milliseconds
+            m_lastPollTime = m_lastFrameTime;
 
             if (anyKeyDown()) {
                 const auto delta = moveDelta(time);
@@ -102,7 +100,7 @@ namespace TrenchBroom {
 
             if (anyKeyDown() && !wasAnyKeyDown) {
                 // Reset the last polling time, otherwise the view will jump!
-                m_lastPollTime = msecsSinceReference();
+                resetTime();
             }
         }
 
@@ -140,6 +138,10 @@ namespace TrenchBroom {
             }
         }
 
+        void FlyModeHelper::framePresented() {
+            m_lastFrameTime = std::max(m_lastPollTime, int64_t(m_timer.nsecsElapsed()));
+        }
+
         bool FlyModeHelper::anyKeyDown() const {
             return m_forward || m_backward || m_left || m_right || m_up || m_down;
         }
@@ -148,6 +150,10 @@ namespace TrenchBroom {
             m_forward = m_backward = m_left = m_right = m_up = m_down = false;
         }
 
+        void FlyModeHelper::resetTime() {
+            m_lastPollTime = m_lastFrameTime = int64_t(m_timer.nsecsElapsed());
+        }
+
         vm::vec3f FlyModeHelper::moveDelta(const float time) {
             const float dist = moveSpeed() * time;
 
@@ -23,6 +23,8 @@
 
 #include <cstdint>
 
+#include <QElapsedTimer>
+
 class QKeyEvent;
 
 namespace TrenchBroom {
@@ -31,6 +33,15 @@ namespace TrenchBroom {
     }
 
     namespace View {
+        /**
+         * Moves the camera while the fly keys are held down.
+         *
+         * The camera is moved once per rendered frame. The distance is derived from the time between the last two
+         * frames that were presented on screen rather than the time at which the next frame happens to be rendered, so
+         * the motion per frame matches what the user saw even if the time spent processing events and rendering varies.
+         * Time is measured with nanosecond resolution because at high refresh rates, a millisecond is a considerable
+         * fraction of a frame.
+         */
         class FlyModeHelper {
         private:
             Renderer::Camera& m_camera;
@@ -42,11 +53,24 @@ namespace TrenchBroom {
             bool m_up;
             bool m_down;
 
+            QElapsedTimer m_timer;
+            /** The time in nanoseconds up to which the camera motion has been applied. */
             int64_t m_lastPollTime;
+            /** The time in nanoseconds at which the last frame was presented. */
+            int64_t m_lastFrameTime;
         public:
             explicit FlyModeHelper(Renderer::Camera& camera);
 
+            /**
+             * Moves the camera by the distance covered between the previous call and the presentation of the last
+             * frame. Call this before rendering a frame.
+             */
             void pollAndUpdate();
+
+            /**
+             * Records that a frame was presented. Call this when the buffers of the view were swapped.
+             */
+            void framePresented();
         public:
             void keyDown(QKeyEvent* event);
             void keyUp(QKeyEvent* event);
@@ -56,6 +80,7 @@ namespace TrenchBroom {
             bool anyKeyDown() const;
             void resetKeys();
         private:
+            void resetTime();
             vm::vec3f moveDelta(float time);
             float moveSpeed() const;
         };
@@ -22,6 +22,7 @@
 #include "Exceptions.h"
 #include "TrenchBroomApp.h"
 #include "View/AboutDialog.h"
+#include "View/GLContextManager.h"
 #include "View/MapDocument.h"
 #include "View/MapDocumentCommandFacade.h"
 #include "View/MapFrame.h"
@@ -68,6 +69,15 @@ namespace TrenchBroom {
             return m_frames.empty();
         }
 
+        std::shared_ptr<GLContextManager> FrameManager::contextManager() {
+            auto contextManager = m_contextManager.lock();
+            if (!contextManager) {
+                contextManager = std::make_shared<GLContextManager>();
+                m_contextManager = contextManager;
+            }
+            return contextManager;
+        }
+
         void FrameManager::onFocusChange(QWidget* /* old */, QWidget* now) {
             if (now == nullptr) {
                 return;
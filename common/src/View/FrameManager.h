@@ -26,6 +26,7 @@
 
 namespace TrenchBroom {
     namespace View {
+        class GLContextManager;
         class MapDocument;
         class MapFrame;
 
@@ -34,6 +35,7 @@ namespace TrenchBroom {
         private:
             bool m_singleFrame;
             std::vector<MapFrame*> m_frames;
+            std::weak_ptr<GLContextManager> m_contextManager;
         public:
             explicit FrameManager(bool singleFrame);
             ~FrameManager() override;
@@ -45,6 +47,12 @@ namespace TrenchBroom {
             MapFrame* topFrame() const;
             bool allFramesClosed() const;
 
+            /**
+             * Returns the context manager shared by all frames. Since all OpenGL contexts share their objects, the
+             * frames can also share the shaders, fonts and vertex buffers, which therefore are only created once.
+             * The context manager is destroyed when the last frame that uses it is destroyed.
+             */
+            std::shared_ptr<GLContextManager> contextManager();
         private:
             void onFocusChange(QWidget* old, QWidget* now);
             MapFrame* createOrReuseFrame();
@@ -20,6 +20,10 @@
 #include "GLContextManager.h"
 
 #include "Exceptions.h"
+#include "PreferenceManager.h"
+#include "Preferences.h"
+#include "IO/Path.h"
+#include "IO/SystemPaths.h"
 #include "Renderer/FontManager.h"
 #include "Renderer/GL.h"
 #include "Renderer/ShaderManager.h"
@@ -66,6 +70,10 @@ namespace TrenchBroom {
                 GLRenderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
                 GLVersion  = reinterpret_cast<const char*>(glGetString(GL_VERSION));
 
+                // some drivers handle persistently mapped buffers poorly, so they must be enabled explicitly
+                m_vboManager->setPersistentMapping(pref(Preferences::PersistentlyMappedBuffers));
+                m_shaderManager->setBinaryCacheDirectory(IO::SystemPaths::userDataDirectory() + IO::Path("cache/shaders"), GLVendor + "\n" + GLRenderer + "\n" + GLVersion);
+
                 m_initialized = true;
                 return true;
             }
@@ -31,6 +31,7 @@
 #include <vecmath/scalar.h>
 
 #include <array>
+#include <vector>
 
 // FIXME: should this be moved to Model?
 namespace TrenchBroom {
@@ -144,17 +145,25 @@ namespace TrenchBroom {
                     return f;
                 }
 
-                const T actSize = static_cast<T>(actualSize());
+                return snap(f, static_cast<T>(actualSize()), snapDir, skip);
+            }
+
+            /**
+             * Snaps the given scalar to the given grid size, which allows callers that snap many scalars at once to
+             * compute the grid size only once.
+             */
+            template <typename T>
+            static T snap(const T f, const T actSize, const SnapDir snapDir, const bool skip) {
                 switch (snapDir) {
                     case SnapDir_None:
                         return vm::snap(f, actSize);
                     case SnapDir_Up: {
                         const T s = actSize * std::ceil(f / actSize);
-                        return (skip && vm::is_equal(s, f, vm::constants<T>::almost_zero())) ? s + static_cast<T>(actualSize()) : s;
+                        return (skip && vm::is_equal(s, f, vm::constants<T>::almost_zero())) ? s + actSize : s;
                     }
                     case SnapDir_Down: {
                         const T s = actSize * std::floor(f / actSize);
-                        return (skip && vm::is_equal(s, f, vm::constants<T>::almost_zero())) ? s - static_cast<T>(actualSize()) : s;
+                        return (skip && vm::is_equal(s, f, vm::constants<T>::almost_zero())) ? s - actSize : s;
                     }
                     switchDefault()
                 }
@@ -192,26 +201,46 @@ namespace TrenchBroom {
                 if (!snap()) {
                     return p;
                 }
+                const T actSize = static_cast<T>(actualSize());
                 vm::vec<T,S> result;
                 for (size_t i = 0; i < S; ++i) {
-                    result[i] = snap(p[i], snapDir, skip);
+                    result[i] = snap(p[i], actSize, snapDir, skip);
                 }
                 return result;
             }
+        public: // Snap many vectors at once.
+            /**
+             * Snaps each component of each of the given points to the nearest grid increment. Unlike snapping each
+             * point individually, the grid size is computed only once, and the loop over the components is simple
+             * enough for the compiler to vectorize it.
+             */
+            template <typename T, size_t S>
+            std::vector<vm::vec<T,S>> snap(std::vector<vm::vec<T,S>> points) const {
+                if (snap()) {
+                    const T actSize = static_cast<T>(actualSize());
+                    for (auto& p : points) {
+                        for (size_t i = 0; i < S; ++i) {
+                            p[i] = vm::snap(p[i], actSize);
+                        }
+                    }
+                }
+                return points;
+            }
         public: // Snap towards an arbitrary direction.
             template <typename T, size_t S>
             vm::vec<T,S> snapTowards(const vm::vec<T,S>& p, const vm::vec<T,S>& d, const bool skip = false) const {
                 if (!snap()) {
                     return p;
                 }
-                vm::vec3 result;
+                const T actSize = static_cast<T>(actualSize());
+                vm::vec<T,S> result;
                 for (size_t i = 0; i < S; ++i) {
                     if (d[i] > T(0.0)) {
-                        result[i] = snapUp(p[i], skip);
+                        result[i] = snap(p[i], actSize, SnapDir_Up, skip);
                     } else if(d[i] < T(0.0)) {
-                        result[i] = snapDown(p[i], skip);
+                        result[i] = snap(p[i], actSize, SnapDir_Down, skip);
                     } else {
-                        result[i] = snap(p[i]);
+                        result[i] = snap(p[i], actSize, SnapDir_None, false);
                     }
                 }
                 return result;
@@ -19,6 +19,8 @@
 
 #include "IssueBrowser.h"
 
+#include "Model/BrushFaceHandle.h"
+#include "Model/BrushNode.h"
 #include "Model/Issue.h"
 #include "Model/IssueGenerator.h"
 #include "Model/WorldNode.h"
@@ -27,6 +29,7 @@
 #include "View/MapDocument.h"
 
 #include <kdl/memory_utils.h>
+#include <kdl/vector_utils.h>
 
 #include <QList>
 #include <QStringList>
@@ -73,10 +76,15 @@ namespace TrenchBroom {
             m_notifierConnection += document->documentWasSavedNotifier.connect(this, &IssueBrowser::documentWasSaved);
             m_notifierConnection += document->documentWasNewedNotifier.connect(this, &IssueBrowser::documentWasNewedOrLoaded);
             m_notifierConnection += document->documentWasLoadedNotifier.connect(this, &IssueBrowser::documentWasNewedOrLoaded);
+            m_notifierConnection += document->documentWasClearedNotifier.connect(this, &IssueBrowser::documentWasCleared);
             m_notifierConnection += document->nodesWereAddedNotifier.connect(this, &IssueBrowser::nodesWereAdded);
+            m_notifierConnection += document->nodesWillBeRemovedNotifier.connect(this, &IssueBrowser::nodesWillBeRemoved);
             m_notifierConnection += document->nodesWereRemovedNotifier.connect(this, &IssueBrowser::nodesWereRemoved);
+            m_notifierConnection += document->nodesWillChangeNotifier.connect(this, &IssueBrowser::nodesWillChange);
             m_notifierConnection += document->nodesDidChangeNotifier.connect(this, &IssueBrowser::nodesDidChange);
             m_notifierConnection += document->brushFacesDidChangeNotifier.connect(this, &IssueBrowser::brushFacesDidChange);
+            m_notifierConnection += document->entityDefinitionsDidChangeNotifier.connect(this, &IssueBrowser::entityDefinitionsOrModsDidChange);
+            m_notifierConnection += document->modsDidChangeNotifier.connect(this, &IssueBrowser::entityDefinitionsOrModsDidChange);
         }
 
         void IssueBrowser::documentWasNewedOrLoaded(MapDocument*) {
@@ -88,19 +96,41 @@ namespace TrenchBroom {
             m_view->update();
         }
 
-        void IssueBrowser::nodesWereAdded(const std::vector<Model::Node*>&) {
+        void IssueBrowser::documentWasCleared(MapDocument*) {
             m_view->reload();
         }
 
-        void IssueBrowser::nodesWereRemoved(const std::vector<Model::Node*>&) {
-            m_view->reload();
+        void IssueBrowser::nodesWereAdded(const std::vector<Model::Node*>& nodes) {
+            m_view->nodesWereAdded(nodes);
         }
 
-        void IssueBrowser::nodesDidChange(const std::vector<Model::Node*>&) {
-            m_view->reload();
+        void IssueBrowser::nodesWillBeRemoved(const std::vector<Model::Node*>& nodes) {
+            m_view->nodesWillBeRemoved(nodes);
+        }
+
+        void IssueBrowser::nodesWereRemoved(const std::vector<Model::Node*>& nodes) {
+            m_view->nodesWereRemoved(nodes);
+        }
+
+        void IssueBrowser::nodesWillChange(const std::vector<Model::Node*>& nodes) {
+            m_view->nodesWillChange(nodes);
+        }
+
+        void IssueBrowser::nodesDidChange(const std::vector<Model::Node*>& nodes) {
+            m_view->nodesDidChange(nodes);
+        }
+
+        void IssueBrowser::brushFacesDidChange(const std::vector<Model::BrushFaceHandle>& faces) {
+            auto nodes = std::vector<Model::Node*>{};
+            nodes.reserve(faces.size());
+            for (const auto& handle : faces) {
+                nodes.push_back(handle.node());
+            }
+            m_view->nodesDidChange(kdl::vec_sort_and_remove_duplicates(std::move(nodes)));
         }
 
-        void IssueBrowser::brushFacesDidChange(const std::vector<Model::BrushFaceHandle>&) {
+        void IssueBrowser::entityDefinitionsOrModsDidChange() {
+            // these affect the issues of nodes that are not reported as changed
             m_view->reload();
         }
 
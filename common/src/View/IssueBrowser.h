@@ -62,11 +62,15 @@ namespace TrenchBroom {
         private:
             void connectObservers();
             void documentWasNewedOrLoaded(MapDocument* document);
+            void documentWasCleared(MapDocument* document);
             void documentWasSaved(MapDocument* document);
             void nodesWereAdded(const std::vector<Model::Node*>& nodes);
+            void nodesWillBeRemoved(const std::vector<Model::Node*>& nodes);
             void nodesWereRemoved(const std::vector<Model::Node*>& nodes);
+            void nodesWillChange(const std::vector<Model::Node*>& nodes);
             void nodesDidChange(const std::vector<Model::Node*>& nodes);
             void brushFacesDidChange(const std::vector<Model::BrushFaceHandle>& faces);
+            void entityDefinitionsOrModsDidChange();
             void issueIgnoreChanged(Model::Issue* issue);
 
             void updateFilterFlags();
@@ -22,16 +22,11 @@
 #include "Ensure.h"
 #include "Model/Issue.h"
 #include "Model/IssueQuickFix.h"
-#include "Model/BrushNode.h"
-#include "Model/EntityNode.h"
-#include "Model/GroupNode.h"
-#include "Model/LayerNode.h"
-#include "Model/PatchNode.h"
 #include "Model/WorldNode.h"
 #include "View/MapDocument.h"
+#include "View/SignalDelayer.h"
 
 #include <kdl/memory_utils.h>
-#include <kdl/overload.h>
 #include <kdl/vector_utils.h>
 #include <kdl/vector_set.h>
 
@@ -42,6 +37,7 @@
 #include <QMenu>
 #include <QHeaderView>
 #include <QItemSelectionModel>
+#include <QShowEvent>
 
 namespace TrenchBroom {
     namespace View {
@@ -50,9 +46,11 @@ namespace TrenchBroom {
         m_document(document),
         m_hiddenGenerators(0),
         m_showHiddenIssues(false),
-        m_valid(false) {
+        m_valid(false),
+        m_validateSignalDelayer(new SignalDelayer(this)) {
             createGui();
             bindEvents();
+            connect(m_validateSignalDelayer, &SignalDelayer::processSignal, this, &IssueBrowserView::validate);
         }
 
         void IssueBrowserView::createGui() {
@@ -89,6 +87,31 @@ namespace TrenchBroom {
         }
 
         void IssueBrowserView::reload() {
+            auto document = kdl::mem_lock(m_document);
+            m_issueIndex.reset(document->world());
+            invalidate();
+        }
+
+        void IssueBrowserView::nodesWereAdded(const std::vector<Model::Node*>& nodes) {
+            m_issueIndex.nodesWereAdded(nodes);
+            invalidate();
+        }
+
+        void IssueBrowserView::nodesWillBeRemoved(const std::vector<Model::Node*>& nodes) {
+            m_issueIndex.nodesWillBeRemoved(nodes);
+        }
+
+        void IssueBrowserView::nodesWereRemoved(const std::vector<Model::Node*>& nodes) {
+            m_issueIndex.nodesWereRemoved(nodes);
+            invalidate();
+        }
+
+        void IssueBrowserView::nodesWillChange(const std::vector<Model::Node*>& nodes) {
+            m_issueIndex.nodesWillChange(nodes);
+        }
+
+        void IssueBrowserView::nodesDidChange(const std::vector<Model::Node*>& nodes) {
+            m_issueIndex.nodesDidChange(nodes);
             invalidate();
         }
 
@@ -117,28 +140,16 @@ namespace TrenchBroom {
         void IssueBrowserView::updateIssues() {
             auto document = kdl::mem_lock(m_document);
             if (document->world() != nullptr) {
-                const auto& issueGenerators = document->world()->registeredIssueGenerators();
-                
-                auto issues = std::vector<Model::Issue*>{};
-                const auto collectIssues = [&](auto* node) {
-                    for (auto* issue : node->issues(issueGenerators)) {
-                        if (m_showHiddenIssues || (!issue->hidden() && (issue->type() & m_hiddenGenerators) == 0)) {
-                            issues.push_back(issue);
-                        }
-                    }
-                };
+                m_issueIndex.validate(document->world()->registeredIssueGenerators());
 
-                document->world()->accept(kdl::overload(
-                    [&](auto&& thisLambda, Model::WorldNode* world)   { collectIssues(world); world->visitChildren(thisLambda); },
-                    [&](auto&& thisLambda, Model::LayerNode* layer)   { collectIssues(layer); layer->visitChildren(thisLambda); },
-                    [&](auto&& thisLambda, Model::GroupNode* group)   { collectIssues(group); group->visitChildren(thisLambda); },
-                    [&](auto&& thisLambda, Model::EntityNode* entity) { collectIssues(entity); entity->visitChildren(thisLambda); },
-                    [&](Model::BrushNode* brush)                      { collectIssues(brush); },
-                    [&](Model::PatchNode* patch)                      { collectIssues(patch); }
-                ));
+                auto issues = kdl::vec_filter(m_issueIndex.issues(), [&](const auto* issue) {
+                    return m_showHiddenIssues || (!issue->hidden() && (issue->type() & m_hiddenGenerators) == 0);
+                });
 
                 issues = kdl::vec_sort(std::move(issues), [](const auto* lhs, const auto* rhs) { return lhs->seqId() > rhs->seqId(); });
                 m_tableModel->setIssues(std::move(issues));
+            } else {
+                m_tableModel->setIssues({});
             }
         }
 
@@ -257,14 +268,19 @@ namespace TrenchBroom {
             setIssueVisibility(false);
         }
 
+        void IssueBrowserView::showEvent(QShowEvent* event) {
+            QWidget::showEvent(event);
+            validate();
+        }
+
         void IssueBrowserView::invalidate() {
             m_valid = false;
 
-            QMetaObject::invokeMethod(this, "validate", Qt::QueuedConnection);
+            m_validateSignalDelayer->queueSignal();
         }
 
         void IssueBrowserView::validate() {
-            if (!m_valid) {
+            if (!m_valid && isVisible()) {
                 m_valid = true;
 
                 updateIssues();
@@ -323,8 +339,11 @@ namespace TrenchBroom {
             } else if (role == Qt::FontRole) {
                 if (issue->hidden()) {
                     // hidden issues are italic
-                    QFont italicFont;
-                    italicFont.setItalic(true);
+                    static const auto italicFont = []() {
+                        auto font = QFont{};
+                        font.setItalic(true);
+                        return font;
+                    }();
                     return QVariant(italicFont);
                 }
                 return QVariant();
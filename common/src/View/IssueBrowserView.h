@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "Model/IssueIndex.h"
 #include "Model/IssueType.h"
 
 #include <memory>
@@ -28,17 +29,20 @@
 #include <QAbstractItemModel>
 
 class QWidget;
+class QShowEvent;
 class QTableView;
 
 namespace TrenchBroom {
     namespace Model {
         class Issue;
         class IssueQuickFix;
+        class Node;
     }
 
     namespace View {
         class IssueBrowserModel;
         class MapDocument;
+        class SignalDelayer;
 
         class IssueBrowserView : public QWidget {
             Q_OBJECT
@@ -48,7 +52,9 @@ namespace TrenchBroom {
             int m_hiddenGenerators;
             bool m_showHiddenIssues;
 
+            Model::IssueIndex m_issueIndex;
             bool m_valid;
+            SignalDelayer* m_validateSignalDelayer;
 
             QTableView* m_tableView;
             IssueBrowserModel* m_tableModel;
@@ -60,7 +66,18 @@ namespace TrenchBroom {
             int hiddenGenerators() const;
             void setHiddenGenerators(int hiddenGenerators);
             void setShowHiddenIssues(bool show);
+            /**
+             * Revalidates all nodes of the document.
+             */
             void reload();
+
+            // Only the given nodes, their ancestors and the entities linked to them are revalidated.
+            void nodesWereAdded(const std::vector<Model::Node*>& nodes);
+            void nodesWillBeRemoved(const std::vector<Model::Node*>& nodes);
+            void nodesWereRemoved(const std::vector<Model::Node*>& nodes);
+            void nodesWillChange(const std::vector<Model::Node*>& nodes);
+            void nodesDidChange(const std::vector<Model::Node*>& nodes);
+
             void deselectAll();
         private:
             void updateIssues();
@@ -80,9 +97,14 @@ namespace TrenchBroom {
             void showIssues();
             void hideIssues();
             void applyQuickFix(const Model::IssueQuickFix* quickFix);
+        protected:
+            void showEvent(QShowEvent* event) override;
         private:
             void invalidate();
         public slots:
+            /**
+             * Updates the issue list if it is invalid. While the view is hidden, it is not updated until it is shown.
+             */
             void validate();
         };
 
@@ -41,20 +41,20 @@ namespace TrenchBroom {
             m_cur = point;
         }
 
-        bool Lasso::selects(const vm::vec3& point, const vm::plane3& plane, const vm::bbox2& box) const {
-            const auto projected = project(point, plane);
+        bool Lasso::selects(const vm::vec3& point, const vm::plane3& plane, const vm::mat4x4& transform, const vm::bbox2& box) const {
+            const auto projected = project(point, plane, transform);
             return !vm::is_nan(projected) && box.contains(vm::vec2{projected});
         }
 
-        bool Lasso::selects(const vm::segment3& edge, const vm::plane3& plane, const vm::bbox2& box) const {
-            return selects(edge.center(), plane, box);
+        bool Lasso::selects(const vm::segment3& edge, const vm::plane3& plane, const vm::mat4x4& transform, const vm::bbox2& box) const {
+            return selects(edge.center(), plane, transform, box);
         }
 
-        bool Lasso::selects(const vm::polygon3& polygon, const vm::plane3& plane, const vm::bbox2& box) const {
-            return selects(polygon.center(), plane, box);
+        bool Lasso::selects(const vm::polygon3& polygon, const vm::plane3& plane, const vm::mat4x4& transform, const vm::bbox2& box) const {
+            return selects(polygon.center(), plane, transform, box);
         }
 
-        vm::vec3 Lasso::project(const vm::vec3& point, const vm::plane3& plane) const {
+        vm::vec3 Lasso::project(const vm::vec3& point, const vm::plane3& plane, const vm::mat4x4& transform) const {
             const auto ray = vm::ray3{m_camera.pickRay(vm::vec3f{point})};
             const auto hitDistance = vm::intersect_ray_plane(ray, plane);
             if (vm::is_nan(hitDistance)) {
@@ -62,7 +62,7 @@ namespace TrenchBroom {
             }
 
             const auto hitPoint = vm::point_at_distance(ray, hitDistance);
-            return getTransform() * hitPoint;
+            return transform * hitPoint;
         }
 
         void Lasso::render(Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch) const {
@@ -21,9 +21,15 @@
 
 #include "FloatType.h"
 
+#include <kdl/parallel.h>
+
+#include <vecmath/mat.h>
 #include <vecmath/plane.h>
 #include <vecmath/bbox.h>
 
+#include <iterator>
+#include <vector>
+
 namespace TrenchBroom {
     namespace Renderer {
         class Camera;
@@ -43,22 +49,37 @@ namespace TrenchBroom {
 
             void update(const vm::vec3& point);
 
+            /**
+             * Writes the elements of the given range that are selected by this lasso to the given output iterator,
+             * preserving their order. The given iterators must be random access iterators.
+             *
+             * The elements are tested in parallel since projecting every handle onto the lasso plane dominates the
+             * cost of lasso selection in the vertex tools.
+             */
             template <typename I, typename O>
             void selected(I cur, I end, O out) const {
                 const auto plane = getPlane();
-                const auto box = getBox(getTransform());
-                while (cur != end) {
-                    if (selects(*cur, plane, box)) {
+                const auto transform = getTransform();
+                const auto box = getBox(transform);
+
+                const auto count = static_cast<size_t>(std::distance(cur, end));
+                // don't use std::vector<bool> because its elements cannot be written concurrently
+                auto selectedFlags = std::vector<char>(count, 0);
+                kdl::parallel_for(count, [&](const size_t i) {
+                    selectedFlags[i] = selects(*std::next(cur, static_cast<typename std::iterator_traits<I>::difference_type>(i)), plane, transform, box) ? 1 : 0;
+                });
+
+                for (size_t i = 0u; i < count; ++i, ++cur) {
+                    if (selectedFlags[i]) {
                         out = *cur;
                     }
-                    ++cur;
                 }
             }
         private:
-            bool selects(const vm::vec3& point, const vm::plane3& plane, const vm::bbox2& box) const;
-            bool selects(const vm::segment3& edge, const vm::plane3& plane, const vm::bbox2& box) const;
-            bool selects(const vm::polygon3& polygon, const vm::plane3& plane, const vm::bbox2& box) const;
-            vm::vec3 project(const vm::vec3& point, const vm::plane3& plane) const;
+            bool selects(const vm::vec3& point, const vm::plane3& plane, const vm::mat4x4& transform, const vm::bbox2& box) const;
+            bool selects(const vm::segment3& edge, const vm::plane3& plane, const vm::mat4x4& transform, const vm::bbox2& box) const;
+            bool selects(const vm::polygon3& polygon, const vm::plane3& plane, const vm::mat4x4& transform, const vm::bbox2& box) const;
+            vm::vec3 project(const vm::vec3& point, const vm::plane3& plane, const vm::mat4x4& transform) const;
         public:
             void render(Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch) const;
         private:
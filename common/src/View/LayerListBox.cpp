@@ -22,6 +22,7 @@
 #include "Model/LayerNode.h"
 #include "Model/WorldNode.h"
 #include "View/MapDocument.h"
+#include "View/SignalDelayer.h"
 #include "View/ViewConstants.h"
 #include "View/QtUtils.h"
 
@@ -154,8 +155,10 @@ namespace TrenchBroom {
 
         LayerListBox::LayerListBox(std::weak_ptr<MapDocument> document, QWidget* parent) :
         ControlListBox("", true, parent),
-        m_document(std::move(document)) {
+        m_document(std::move(document)),
+        m_updateLayersSignalDelayer(new SignalDelayer(this)) {
             connectObservers();
+            connect(m_updateLayersSignalDelayer, &SignalDelayer::processSignal, this, &LayerListBox::updateLayers);
         }
 
         Model::LayerNode* LayerListBox::selectedLayer() const {
@@ -178,9 +181,9 @@ namespace TrenchBroom {
             m_notifierConnection += document->documentWasLoadedNotifier.connect(this, &LayerListBox::documentDidChange);
             m_notifierConnection += document->documentWasClearedNotifier.connect(this, &LayerListBox::documentDidChange);
             m_notifierConnection += document->currentLayerDidChangeNotifier.connect(this, &LayerListBox::currentLayerDidChange);
-            m_notifierConnection += document->nodesWereAddedNotifier.connect(this, &LayerListBox::nodesDidChange);
-            m_notifierConnection += document->nodesWereRemovedNotifier.connect(this, &LayerListBox::nodesDidChange);
-            m_notifierConnection += document->nodesDidChangeNotifier.connect(this, &LayerListBox::nodesDidChange);
+            m_notifierConnection += document->nodesWereAddedNotifier.connect(this, &LayerListBox::nodesWereAddedOrRemoved);
+            m_notifierConnection += document->nodesWereRemovedNotifier.connect(this, &LayerListBox::nodesWereAddedOrRemoved);
+            m_notifierConnection += document->coalescedNodesDidChangeNotifier.connect(this, &LayerListBox::nodesDidChange);
             m_notifierConnection += document->nodeVisibilityDidChangeNotifier.connect(this, &LayerListBox::nodesDidChange);
             m_notifierConnection += document->nodeLockingDidChangeNotifier.connect(this, &LayerListBox::nodesDidChange);
         }
@@ -189,8 +192,27 @@ namespace TrenchBroom {
             reload();
         }
 
+        void LayerListBox::nodesWereAddedOrRemoved(const std::vector<Model::Node*>&) {
+            // the list must not keep any removed layers, so it is updated right away
+            updateLayers();
+        }
+
         void LayerListBox::nodesDidChange(const std::vector<Model::Node*>&) {
-            const auto documentLayers = kdl::mem_lock(m_document)->world()->allLayersUserSorted();
+            m_updateLayersSignalDelayer->queueSignal();
+        }
+
+        void LayerListBox::currentLayerDidChange(const Model::LayerNode*) {
+            m_updateLayersSignalDelayer->queueSignal();
+        }
+
+        void LayerListBox::updateLayers() {
+            auto document = kdl::mem_lock(m_document);
+            if (document->world() == nullptr) {
+                // the document was cleared before a delayed update was processed
+                return;
+            }
+
+            const auto documentLayers = document->world()->allLayersUserSorted();
 
             if (layers() != documentLayers) {
                 // A layer was added or removed or modified, so we need to clear and repopulate the list
@@ -202,10 +224,6 @@ namespace TrenchBroom {
             updateItems();
         }
 
-        void LayerListBox::currentLayerDidChange(const Model::LayerNode*) {
-            updateItems();
-        }
-
         size_t LayerListBox::itemCount() const {
             auto document = kdl::mem_lock(m_document);
             const auto* world = document->world();
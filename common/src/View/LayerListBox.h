@@ -37,6 +37,7 @@ namespace TrenchBroom {
 
     namespace View {
         class MapDocument;
+        class SignalDelayer;
 
         class LayerListBoxWidget : public ControlListBoxItemRenderer {
             Q_OBJECT
@@ -72,6 +73,7 @@ namespace TrenchBroom {
             Q_OBJECT
         private:
             std::weak_ptr<MapDocument> m_document;
+            SignalDelayer* m_updateLayersSignalDelayer;
 
             NotifierConnection m_notifierConnection;
         public:
@@ -89,9 +91,12 @@ namespace TrenchBroom {
             void connectObservers();
 
             void documentDidChange(MapDocument* document);
+            void nodesWereAddedOrRemoved(const std::vector<Model::Node*>& nodes);
             void nodesDidChange(const std::vector<Model::Node*>& nodes);
             void currentLayerDidChange(const Model::LayerNode* layer);
 
+            void updateLayers();
+
             const LayerListBoxWidget* widgetAtRow(int row) const;
             Model::LayerNode* layerForRow(int row) const;
 
@@ -19,7 +19,9 @@
 
 #include "View/MapDocument.h"
 
+#include "AllocationCounting.h"
 #include "Exceptions.h"
+#include "Profiler.h"
 #include "Uuid.h"
 #include "Model/EntityProperties.h"
 #include "PreferenceManager.h"
@@ -36,8 +38,10 @@
 #include "IO/DiskFileSystem.h"
 #include "IO/DiskIO.h"
 #include "IO/GameConfigParser.h"
+#include "IO/NodeSerializationCache.h"
 #include "IO/SimpleParserStatus.h"
 #include "IO/SystemPaths.h"
+#include "IO/TextureCache.h"
 #include "Model/BezierPatch.h"
 #include "Model/Brush.h"
 #include "Model/BrushError.h"
@@ -56,6 +60,7 @@
 #include "Model/Game.h"
 #include "Model/GameFactory.h"
 #include "Model/GroupNode.h"
+#include "Model/InternedString.h"
 #include "Model/InvalidTextureScaleIssueGenerator.h"
 #include "Model/LayerNode.h"
 #include "Model/LinkSourceIssueGenerator.h"
@@ -69,6 +74,7 @@
 #include "Model/MixedBrushContentsIssueGenerator.h"
 #include "Model/ModelUtils.h"
 #include "Model/Node.h"
+#include "Model/NodeCollection.h"
 #include "Model/NodeContents.h"
 #include "Model/NonIntegerVerticesIssueGenerator.h"
 #include "Model/PatchNode.h"
@@ -87,6 +93,7 @@
 #include "View/AddRemoveNodesCommand.h"
 #include "View/Actions.h"
 #include "View/BrushVertexCommands.h"
+#include "View/ChangeBrushFaceAttributesCommand.h"
 #include "View/CurrentGroupCommand.h"
 #include "View/Grid.h"
 #include "View/MapTextEncoding.h"
@@ -94,6 +101,7 @@
 #include "View/ReparentNodesCommand.h"
 #include "View/RepeatStack.h"
 #include "View/SelectionCommand.h"
+#include "View/SetBrushFaceTexturesCommand.h"
 #include "View/SetLockStateCommand.h"
 #include "View/SetCurrentLayerCommand.h"
 #include "View/SetVisibilityCommand.h"
@@ -118,12 +126,15 @@
 #include <vecmath/vec_io.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstdlib> // for std::abs
 #include <map>
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
@@ -314,6 +325,7 @@ namespace TrenchBroom {
             pref(Preferences::TextureMagFilter),
             pref(Preferences::TextureMinFilter), logger())),
         m_tagManager(std::make_unique<Model::TagManager>()),
+        m_exportCache(std::make_unique<IO::NodeSerializationCache>()),
         m_editorContext(std::make_unique<Model::EditorContext>()),
         m_grid(std::make_unique<Grid>(4)),
         m_path(DefaultDocumentName),
@@ -493,20 +505,79 @@ namespace TrenchBroom {
             documentWasNewedNotifier(this);
         }
 
+        namespace {
+            /**
+             * Measures the stages of loading a document and logs a breakdown, so that users can tell which stage
+             * takes so long when a map loads slowly. If allocation counting is enabled, the number of bytes that
+             * were allocated in each stage is logged, too.
+             */
+            class LoadReport {
+            private:
+                struct Stage {
+                    std::string name;
+                    long long milliseconds;
+                    size_t allocatedBytes;
+                };
+
+                std::vector<Stage> m_stages;
+            public:
+                template <typename F>
+                void timeStage(std::string name, F&& stage) {
+                    const auto startBytes = totalAllocationCounts().bytes;
+                    const auto startTime = std::chrono::steady_clock::now();
+                    stage();
+                    const auto endTime = std::chrono::steady_clock::now();
+
+                    const auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
+                    m_stages.push_back(Stage{std::move(name), milliseconds, totalAllocationCounts().bytes - startBytes});
+                }
+
+                void log(Logger& logger, Model::WorldNode& world) const {
+                    auto totalMilliseconds = 0ll;
+                    for (const auto& stage : m_stages) {
+                        totalMilliseconds += stage.milliseconds;
+                    }
+
+                    const auto nodes = Model::collectNodesByType({&world});
+                    logger.info() << "Loaded document in " << totalMilliseconds << "ms: "
+                                  << nodes.layers().size() << " layers, "
+                                  << nodes.groups().size() << " groups, "
+                                  << nodes.entities().size() << " entities, "
+                                  << nodes.brushes().size() << " brushes, "
+                                  << nodes.patches().size() << " patches";
+
+                    for (const auto& stage : m_stages) {
+                        auto str = std::stringstream{};
+                        str << "  " << stage.name << ": " << stage.milliseconds << "ms";
+                        if (allocationCountingEnabled()) {
+                            str << ", " << stage.allocatedBytes / 1024u << "KiB allocated";
+                        }
+                        logger.info(str.str());
+                    }
+                }
+            };
+        }
+
         void MapDocument::loadDocument(const Model::MapFormat mapFormat, const vm::bbox3& worldBounds, std::shared_ptr<Model::Game> game, const IO::Path& path) {
             info("Loading document from " + path.asString());
 
             clearRepeatableCommands();
             doClearCommandProcessor();
             clearDocument();
-            loadWorld(mapFormat, worldBounds, game, path);
 
-            loadAssets();
-            registerIssueGenerators();
-            registerSmartTags();
-            createTagActions();
+            auto report = LoadReport{};
+            report.timeStage("read map", [&]() { loadWorld(mapFormat, worldBounds, game, path); });
+            report.timeStage("load assets", [&]() { loadAssets(); });
+            report.timeStage("register issue generators and tags", [&]() {
+                registerIssueGenerators();
+                registerSmartTags();
+                createTagActions();
+            });
+
+            // the observers initialize the node tags, validate the issues and prepare the renderers
+            report.timeStage("notify observers", [&]() { documentWasLoadedNotifier(this); });
 
-            documentWasLoadedNotifier(this);
+            report.log(logger(), *m_world);
         }
 
         void MapDocument::saveDocument() {
@@ -524,7 +595,7 @@ namespace TrenchBroom {
         }
 
         void MapDocument::exportDocumentAs(const Model::ExportFormat format, const IO::Path& path) {
-            m_game->exportMap(*m_world, format, path);
+            m_game->exportMap(*m_world, format, path, m_exportCache.get());
         }
 
         void MapDocument::doSaveDocument(const IO::Path& path) {
@@ -566,9 +637,13 @@ namespace TrenchBroom {
             return stream.str();
         }
 
-        PasteType MapDocument::paste(const std::string& str) {
+        std::string MapDocument::serializedNodesCacheData(const std::string& str) {
+            return m_game->writeNodesCacheData(str, m_world->mapFormat(), logger());
+        }
+
+        PasteType MapDocument::paste(const std::string& str, const std::string_view cacheData) {
             // Try parsing as entities, then as brushes, in all compatible formats
-            const std::vector<Model::Node*> nodes = m_game->parseNodes(str, m_world->mapFormat(), m_worldBounds, logger());
+            const std::vector<Model::Node*> nodes = m_game->parseNodes(str, m_world->mapFormat(), m_worldBounds, logger(), cacheData);
             if (!nodes.empty()) {
                 if (pasteNodes(nodes)) {
                     return PasteType::Node;
@@ -863,6 +938,14 @@ namespace TrenchBroom {
             return m_selectionBounds;
         }
 
+        const std::optional<vm::mat4x4>& MapDocument::selectionPreviewTransformation() const {
+            return m_selectionPreviewTransformation;
+        }
+
+        void MapDocument::setSelectionPreviewTransformation(std::optional<vm::mat4x4> transformation) {
+            m_selectionPreviewTransformation = std::move(transformation);
+        }
+
         const std::string& MapDocument::currentTextureName() const {
             return m_currentTextureName;
         }
@@ -1301,9 +1384,13 @@ namespace TrenchBroom {
             auto nodesToSelect = std::vector<Model::Node*>{};
             auto newParentMap = std::map<Model::Node*, Model::Node*>{};
 
-            for (Model::Node* original : selectedNodes().nodes()) {
+            const auto& originals = selectedNodes().nodes();
+            const auto clones = Model::Node::cloneRecursively(m_worldBounds, originals);
+
+            for (size_t i = 0u; i < originals.size(); ++i) {
+                Model::Node* original = originals[i];
                 Model::Node* suggestedParent = parentForNodes(std::vector<Model::Node*>{original});
-                Model::Node* clone = original->cloneRecursively(m_worldBounds);
+                Model::Node* clone = clones[i];
 
                 if (shouldCloneParentWhenCloningNode(original)) {
                     // e.g. original is a brush in a brush entity, so we need to clone the entity (parent)
@@ -1871,24 +1958,34 @@ namespace TrenchBroom {
             auto selectedNodes = std::vector<Model::Node*>{};
             auto unselectedNodes = std::vector<Model::Node*>{};
 
+            /*
+             * Returns true if the given node is selected. Unselected nodes are collected without their descendants
+             * because the descendants of a hidden node inherit its visibility.
+             */
             const auto collectNode = [&](auto* node) {
                 if (node->transitivelySelected() || node->descendantSelected()) {
                     selectedNodes.push_back(node);
+                    return true;
                 } else {
                     unselectedNodes.push_back(node);
+                    return false;
                 }
             };
 
             m_world->accept(kdl::overload(
                 [] (auto&& thisLambda, Model::WorldNode* world)   { world->visitChildren(thisLambda); },
                 [] (auto&& thisLambda, Model::LayerNode* layer)   { layer->visitChildren(thisLambda); },
-                [&](auto&& thisLambda, Model::GroupNode* group)   { collectNode(group); group->visitChildren(thisLambda); },
-                [&](auto&& thisLambda, Model::EntityNode* entity) { collectNode(entity); entity->visitChildren(thisLambda); },
+                [&](auto&& thisLambda, Model::GroupNode* group)   { if (collectNode(group)) { group->visitChildren(thisLambda); } },
+                [&](auto&& thisLambda, Model::EntityNode* entity) { if (collectNode(entity)) { entity->visitChildren(thisLambda); } },
                 [&](Model::BrushNode* brush) { collectNode(brush); },
                 [&](Model::PatchNode* patch) { collectNode(patch); }
             ));
 
             Transaction transaction(this, "Isolate Objects");
+
+            // Reset visibility of any forced shown descendants of the nodes to hide
+            downgradeShownToInherit(Model::collectDescendants(unselectedNodes));
+
             executeAndStore(SetVisibilityCommand::hide(unselectedNodes));
             executeAndStore(SetVisibilityCommand::show(selectedNodes));
         }
@@ -1933,7 +2030,11 @@ namespace TrenchBroom {
         }
 
         void MapDocument::showAll() {
-            resetVisibility(Model::collectDescendants(kdl::vec_element_cast<Model::Node*>(m_world->allLayers())));
+            // only nodes with an explicit visibility state need to be reset
+            const auto nodesToReset = kdl::vec_filter(
+                Model::collectDescendants(kdl::vec_element_cast<Model::Node*>(m_world->allLayers())),
+                [](const auto* node) { return node->visibilityState() != Model::VisibilityState::Inherited; });
+            resetVisibility(nodesToReset);
         }
 
         void MapDocument::ensureVisible(const std::vector<Model::Node*>& nodes) {
@@ -1988,7 +2089,9 @@ namespace TrenchBroom {
                     nodesToReset.push_back(node);
                 }
             }
-            resetVisibility(nodesToReset);
+            if (!nodesToReset.empty()) {
+                resetVisibility(nodesToReset);
+            }
         }
 
         /**
@@ -2001,7 +2104,9 @@ namespace TrenchBroom {
                     nodesToReset.push_back(node);
                 }
             }
-            resetLock(nodesToReset);
+            if (!nodesToReset.empty()) {
+                resetLock(nodesToReset);
+            }
         }
 
         bool MapDocument::swapNodeContents(const std::string& commandName, std::vector<std::pair<Model::Node*, Model::NodeContents>> nodesToSwap, std::vector<std::pair<const Model::GroupNode*, std::vector<Model::GroupNode*>>> linkedGroupsToUpdate) {
@@ -2045,6 +2150,7 @@ namespace TrenchBroom {
 
             const bool lockTexturesPref = pref(Preferences::TextureLock);
             auto transformResults = kdl::vec_parallel_transform(nodesToTransform, [&](Model::Node* node) -> TransformResult {
+                const auto allocationScope = AllocationScope{AllocationTag::Model};
                 return node->accept(kdl::overload(
                     [&](Model::WorldNode*) -> TransformResult { ensure(false, "Unexpected world node"); },
                     [&](Model::LayerNode*) -> TransformResult { ensure(false, "Unexpected layer node"); },
@@ -2211,13 +2317,24 @@ namespace TrenchBroom {
             const auto minuendNodes = std::vector<Model::BrushNode*>{selectedNodes().brushes()};
             const auto subtrahends = kdl::vec_transform(subtrahendNodes, [](const auto* subtrahendNode) { return &subtrahendNode->brush(); });
 
+            // The minuends are independent of each other, so we compute their fragments in parallel. Only the subtrahends
+            // whose bounds intersect a minuend can change it.
+            const auto mapFormat = m_world->mapFormat();
+            const auto textureName = currentTextureName();
+            auto subtractionResults = kdl::vec_parallel_transform(minuendNodes, [&](const Model::BrushNode* minuendNode) {
+                const Model::Brush& minuend = minuendNode->brush();
+                const auto touchingSubtrahends = kdl::vec_filter(subtrahends, [&](const Model::Brush* subtrahend) {
+                    return minuend.intersects(subtrahend->bounds());
+                });
+                return minuend.subtract(mapFormat, m_worldBounds, textureName, touchingSubtrahends);
+            });
+
             auto toAdd = std::map<Model::Node*, std::vector<Model::Node*>>{};
             auto toRemove = std::vector<Model::Node*>{std::begin(subtrahendNodes), std::end(subtrahendNodes)};
 
-            for (auto* minuendNode : minuendNodes) {
-                const Model::Brush& minuend = minuendNode->brush();
-                auto currentSubtractionResults = minuend.subtract(m_world->mapFormat(), m_worldBounds, currentTextureName(), subtrahends);
-                auto currentBrushes = kdl::collect_values(std::move(currentSubtractionResults), [&](const Model::BrushError& e) { 
+            for (size_t i = 0u; i < minuendNodes.size(); ++i) {
+                auto* minuendNode = minuendNodes[i];
+                auto currentBrushes = kdl::collect_values(std::move(subtractionResults[i]), [&](const Model::BrushError& e) {
                     error() << "Could not create brush: " << e;
                 });
 
@@ -2237,23 +2354,61 @@ namespace TrenchBroom {
             return true;
         }
 
+        /**
+         * Intersects the given brushes. Since intersecting is associative, the brushes are intersected in pairs, and
+         * the pairs of each round are intersected in parallel until only one brush is left. The intersection is empty
+         * as soon as the bounds of two brushes are disjoint, which is checked before any geometry is built.
+         */
+        static kdl::result<Model::Brush, Model::BrushError> intersectBrushes(std::vector<Model::Brush> brushes, const vm::bbox3& worldBounds) {
+            assert(!brushes.empty());
+
+            auto bounds = brushes.front().bounds();
+            for (const auto& brush : brushes) {
+                if (!bounds.intersects(brush.bounds())) {
+                    return Model::BrushError::EmptyBrush;
+                }
+                bounds = vm::bbox3(vm::max(bounds.min, brush.bounds().min), vm::min(bounds.max, brush.bounds().max));
+            }
+
+            while (brushes.size() > 1u) {
+                const auto pairCount = brushes.size() / 2u;
+                auto errors = std::vector<std::optional<Model::BrushError>>(pairCount);
+                kdl::parallel_for(pairCount, [&](const size_t i) {
+                    auto& lhs = brushes[2u * i];
+                    const auto& rhs = brushes[2u * i + 1u];
+                    lhs.intersect(worldBounds, rhs).handle_errors([&](const Model::BrushError e) {
+                        errors[i] = e;
+                    });
+                });
+
+                for (const auto& e : errors) {
+                    if (e) {
+                        return *e;
+                    }
+                }
+
+                // keep the intersections and the unpaired last brush, if any
+                auto remainingBrushes = std::vector<Model::Brush>{};
+                remainingBrushes.reserve(pairCount + 1u);
+                for (size_t i = 0u; i < brushes.size(); i += 2u) {
+                    remainingBrushes.push_back(std::move(brushes[i]));
+                }
+                brushes = std::move(remainingBrushes);
+            }
+
+            return std::move(brushes.front());
+        }
+
         bool MapDocument::csgIntersect() {
             const std::vector<Model::BrushNode*> brushes = selectedNodes().brushes();
             if (brushes.size() < 2u) {
                 return false;
             }
 
-            Model::Brush intersection = brushes.front()->brush();
-
-            bool valid = true;
-            for (auto it = std::next(std::begin(brushes)), end = std::end(brushes); it != end && valid; ++it) {
-                Model::BrushNode* brushNode = *it;
-                const Model::Brush& brush = brushNode->brush();
-                valid = intersection.intersect(m_worldBounds, brush)
-                    .handle_errors([&](const Model::BrushError e) {
-                        error() << "Could not intersect brushes: " << e;
-                    });
-            }
+            auto intersection = intersectBrushes(kdl::vec_transform(brushes, [](const auto* brushNode) { return brushNode->brush(); }), m_worldBounds);
+            const auto valid = intersection.handle_errors([&](const Model::BrushError e) {
+                error() << "Could not intersect brushes: " << e;
+            });
 
             const std::vector<Model::Node*> toRemove(std::begin(brushes), std::end(brushes));
 
@@ -2261,7 +2416,7 @@ namespace TrenchBroom {
             deselect(toRemove);
 
             if (valid) {
-                Model::BrushNode* intersectionNode = new Model::BrushNode(std::move(intersection));
+                Model::BrushNode* intersectionNode = new Model::BrushNode(std::move(intersection).value());
                 addNodes({{parentForNodes(toRemove), {intersectionNode}}});
                 removeNodes(toRemove);
                 select(intersectionNode);
@@ -2278,28 +2433,42 @@ namespace TrenchBroom {
                 return false;
             }
 
+            // Hollow the brushes in parallel, but report errors afterwards on this thread.
+            const auto mapFormat = m_world->mapFormat();
+            const auto textureName = currentTextureName();
+            const auto delta = -1.0 * static_cast<FloatType>(m_grid->actualSize());
+            auto hollowResults = kdl::vec_parallel_transform(brushNodes, [&](const Model::BrushNode* brushNode) {
+                const auto& originalBrush = brushNode->brush();
+
+                auto shrunkenBrush = originalBrush;
+                return shrunkenBrush.expand(m_worldBounds, delta, true)
+                    .and_then([&]() {
+                        return originalBrush.subtract(mapFormat, m_worldBounds, textureName, shrunkenBrush);
+                    });
+            });
+
             bool didHollowAnything = false;
-            std::vector<std::pair<Model::BrushNode*, std::vector<Model::Brush>>> fragmentsAndSourceNodes =
-                kdl::vec_transform(brushNodes, [&](Model::BrushNode* brushNode) {
-                    const auto& originalBrush = brushNode->brush();
+            std::vector<std::pair<Model::BrushNode*, std::vector<Model::Brush>>> fragmentsAndSourceNodes;
+            fragmentsAndSourceNodes.reserve(brushNodes.size());
 
-                    auto shrunkenBrush = originalBrush;
-                    std::vector<Model::Brush> fragments;
-                    shrunkenBrush.expand(m_worldBounds, -1.0 * static_cast<FloatType>(m_grid->actualSize()), true)
-                        .and_then([&]() {
-                            didHollowAnything = true;
+            for (size_t i = 0u; i < brushNodes.size(); ++i) {
+                auto* brushNode = brushNodes[i];
 
-                            auto subtractionResults = originalBrush.subtract(m_world->mapFormat(), m_worldBounds, currentTextureName(), shrunkenBrush);
-                            fragments = kdl::collect_values(std::move(subtractionResults), [&](const Model::BrushError& e) { 
-                                error() << "Could not create brush: " << e;
-                            });
-                        }).handle_errors([&](const Model::BrushError& e) {
-                            error() << "Could not hollow brush: " << e;
-                            fragments = { originalBrush };
+                std::vector<Model::Brush> fragments;
+                std::move(hollowResults[i])
+                    .and_then([&](std::vector<kdl::result<Model::Brush, Model::BrushError>>&& subtractionResults) {
+                        didHollowAnything = true;
+
+                        fragments = kdl::collect_values(std::move(subtractionResults), [&](const Model::BrushError& e) {
+                            error() << "Could not create brush: " << e;
                         });
+                    }).handle_errors([&](const Model::BrushError& e) {
+                        error() << "Could not hollow brush: " << e;
+                        fragments = { brushNode->brush() };
+                    });
 
-                    return std::make_pair(brushNode, std::move(fragments));
-                });
+                fragmentsAndSourceNodes.emplace_back(brushNode, std::move(fragments));
+            }
 
             if (!didHollowAnything) {
                 return false;
@@ -2568,11 +2737,52 @@ namespace TrenchBroom {
             return setFaceAttributes(request);
         }
 
+        /**
+         * Returns whether any of the given faces belongs to a linked group. Such faces cannot be changed using the
+         * commands that only record the changed face attributes because the linked groups must be updated.
+         */
+        static bool belongsToLinkedGroup(Model::WorldNode& worldNode, const std::vector<Model::BrushFaceHandle>& faces) {
+            const auto nodes = kdl::vec_sort_and_remove_duplicates(kdl::vec_transform(faces, [](const auto& faceHandle) -> Model::Node* { return faceHandle.node(); }));
+            return !findContainingLinkedGroupsToUpdate(worldNode, nodes).empty();
+        }
+
         bool MapDocument::setFaceAttributes(const Model::ChangeBrushFaceAttributesRequest& request) {
-            return applyAndSwap(*this, request.name(), allSelectedBrushFaces(), [&](Model::BrushFace& brushFace) {
-                request.evaluate(brushFace);
+            const auto faces = allSelectedBrushFaces();
+            if (faces.empty()) {
                 return true;
+            }
+
+            if (belongsToLinkedGroup(*m_world, faces)) {
+                return applyAndSwap(*this, request.name(), faces, [&](Model::BrushFace& brushFace) {
+                    request.evaluate(brushFace);
+                    return true;
+                });
+            }
+
+            auto facesToChange = kdl::vec_transform(faces, [&](const auto& faceHandle) {
+                auto face = faceHandle.face();
+                request.evaluate(face);
+                return BrushFaceAttributesState{faceHandle, face.attributes(), face.takeTexCoordSystemSnapshot()};
             });
+            return executeAndStore(std::make_unique<ChangeBrushFaceAttributesCommand>(request.name(), std::move(facesToChange)))->success();
+        }
+
+        bool MapDocument::setFaceTextureName(const std::vector<Model::BrushFaceHandle>& faces, const std::string& textureName) {
+            if (faces.empty()) {
+                return true;
+            }
+
+            if (belongsToLinkedGroup(*m_world, faces)) {
+                return applyAndSwap(*this, "Set Texture", faces, [&](Model::BrushFace& brushFace) {
+                    auto attributes = brushFace.attributes();
+                    attributes.setTextureName(textureName);
+                    brushFace.setAttributes(attributes);
+                    return true;
+                });
+            }
+
+            auto facesToChange = kdl::vec_transform(faces, [&](const auto& faceHandle) { return std::make_pair(faceHandle, textureName); });
+            return executeAndStore(std::make_unique<SetBrushFaceTexturesCommand>("Set Texture", std::move(facesToChange)))->success();
         }
 
         bool MapDocument::copyTexCoordSystemFromFace(const Model::TexCoordSystemSnapshot& coordSystemSnapshot, const Model::BrushFaceAttributes& attribs, const vm::plane3& sourceFacePlane, const Model::WrapStyle wrapStyle) {
@@ -2615,27 +2825,47 @@ namespace TrenchBroom {
             size_t succeededBrushCount = 0;
             size_t failedBrushCount = 0;
 
+            // Snapping rebuilds the geometry of a brush, and the brushes are independent of each other, so they are
+            // snapped in parallel. Brushes whose vertices are snapped already are left alone.
             const auto allSelectedBrushes = m_selectedNodes.brushesRecursively();
-            applyAndSwap(*this, "Snap Brush Vertices", allSelectedBrushes, findContainingLinkedGroupsToUpdate(*m_world, allSelectedBrushes), kdl::overload(
-                [] (Model::Layer&)  { return true; },
-                [] (Model::Group&)  { return true; },
-                [] (Model::Entity&) { return true; },
-                [&](Model::Brush& originalBrush) {
-                    if (originalBrush.canSnapVertices(m_worldBounds, snapTo)) {
-                        originalBrush.snapVertices(m_worldBounds, snapTo, pref(Preferences::UVLock))
-                            .and_then([&]() {
-                                succeededBrushCount += 1;
-                            }).handle_errors([&](const Model::BrushError e) {
-                                error() << "Could not snap vertices: " << e;
-                                failedBrushCount += 1;
-                            });
-                    } else {
+            const auto uvLock = pref(Preferences::UVLock);
+            auto snapResults = kdl::vec_parallel_transform(allSelectedBrushes, [&](const Model::BrushNode* brushNode) -> std::optional<kdl::result<Model::Brush, Model::BrushError>> {
+                const auto& originalBrush = brushNode->brush();
+                if (originalBrush.hasSnappedVertices(snapTo)) {
+                    return std::nullopt;
+                }
+
+                auto brush = originalBrush;
+                return brush.snapVertices(m_worldBounds, snapTo, uvLock).and_then([&]() { return std::move(brush); });
+            });
+
+            auto nodesToSwap = std::vector<std::pair<Model::Node*, Model::NodeContents>>{};
+            auto snappedBrushes = std::vector<Model::BrushNode*>{};
+            for (size_t i = 0u; i < allSelectedBrushes.size(); ++i) {
+                if (!snapResults[i]) {
+                    continue;
+                }
+
+                auto* brushNode = allSelectedBrushes[i];
+                std::move(*snapResults[i]).visit(kdl::overload(
+                    [&](Model::Brush&& brush) {
+                        nodesToSwap.emplace_back(brushNode, Model::NodeContents(std::move(brush)));
+                        snappedBrushes.push_back(brushNode);
+                        succeededBrushCount += 1;
+                    },
+                    [&](const Model::BrushError e) {
+                        // the snapped vertices of a brush often don't form a valid brush, which is not worth logging
+                        if (e != Model::BrushError::InvalidBrush) {
+                            error() << "Could not snap vertices: " << e;
+                        }
                         failedBrushCount += 1;
                     }
-                    return true;
-                },
-                [] (Model::BezierPatch&) { return true; }
-            ));
+                ));
+            }
+
+            if (!nodesToSwap.empty()) {
+                swapNodeContents("Snap Brush Vertices", std::move(nodesToSwap), findContainingLinkedGroupsToUpdate(*m_world, snappedBrushes));
+            }
 
             if (succeededBrushCount > 0) {
                 info(kdl::str_to_string("Snapped vertices of ", succeededBrushCount, " ", kdl::str_plural(succeededBrushCount, "brush", "brushes")));
@@ -2659,17 +2889,20 @@ namespace TrenchBroom {
                         return true;
                     }
 
-                    if (!brush.canMoveVertices(m_worldBounds, verticesToMove, delta)) {
-                        return false;
-                    }
-
-                    return brush.moveVertices(m_worldBounds, verticesToMove, delta, pref(Preferences::UVLock))
-                        .and_then([&]() {
-                            auto newPositions = brush.findClosestVertexPositions(verticesToMove + delta);
-                            newVertexPositions = kdl::vec_concat(std::move(newVertexPositions), std::move(newPositions));
-                        }).handle_errors([&](const Model::BrushError e) {
-                            error() << "Could not move brush vertices: " << e;
-                        });
+                    return brush.moveVerticesIfPossible(m_worldBounds, verticesToMove, delta, pref(Preferences::UVLock))
+                        .visit(kdl::overload(
+                            [&](const bool moved) {
+                                if (moved) {
+                                    auto newPositions = brush.findClosestVertexPositions(verticesToMove + delta);
+                                    newVertexPositions = kdl::vec_concat(std::move(newVertexPositions), std::move(newPositions));
+                                }
+                                return moved;
+                            },
+                            [&](const Model::BrushError e) {
+                                error() << "Could not move brush vertices: " << e;
+                                return false;
+                            }
+                        ));
                },
                [] (Model::BezierPatch&) { return true; }
             ));
@@ -2948,6 +3181,17 @@ namespace TrenchBroom {
             m_textureManager->commitChanges();
         }
 
+        void MapDocument::collectLoadedTextures() {
+            if (m_textureManager->collectLoadedCollections()) {
+                setTextures();
+                textureCollectionsDidLoadNotifier();
+            }
+        }
+
+        bool MapDocument::hasPendingTextures() const {
+            return m_textureManager->hasPendingCollections();
+        }
+
         void MapDocument::pick(const vm::ray3& pickRay, Model::PickResult& pickResult) const {
             if (m_world != nullptr)
                 m_world->pick(*m_editorContext, pickRay, pickResult);
@@ -3036,6 +3280,49 @@ namespace TrenchBroom {
             initializeAllNodeTags(this);
         }
 
+        void MapDocument::reloadTextureCollections(const std::vector<IO::Path>& paths) {
+            const auto nodes = std::vector<Model::Node*>{m_world.get()};
+            NotifyBeforeAndAfter notifyNodes(nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
+            NotifyBeforeAndAfter notifyTextureCollections(textureCollectionsWillChangeNotifier, textureCollectionsDidChangeNotifier);
+
+            for (const auto& path : paths) {
+                info() << "Reloading texture collection " << path;
+            }
+
+            // the faces must let go of the textures before their collections are unloaded
+            unsetTextures();
+            m_textureManager->unloadTextureCollections(paths);
+            loadTextures();
+            setTextures();
+            initializeAllNodeTags(this);
+        }
+
+        IO::Path MapDocument::entityDefinitionFilePath() const {
+            try {
+                return m_game->findEntityDefinitionFile(entityDefinitionFile(), externalSearchPaths());
+            } catch (const Exception&) {
+                return IO::Path();
+            }
+        }
+
+        std::vector<std::pair<IO::Path, IO::Path>> MapDocument::textureCollectionFilePaths() const {
+            auto result = std::vector<std::pair<IO::Path, IO::Path>>{};
+            if (m_world == nullptr) {
+                return result;
+            }
+
+            const auto searchPaths = externalSearchPaths();
+            for (const auto& path : enabledTextureCollections()) {
+                if (m_game->isTextureCollection(path)) {
+                    auto absolutePath = IO::Disk::resolvePath(searchPaths, path);
+                    if (!absolutePath.isEmpty()) {
+                        result.emplace_back(path, std::move(absolutePath));
+                    }
+                }
+            }
+            return result;
+        }
+
         void MapDocument::reloadEntityDefinitions() {
             const auto nodes = std::vector<Model::Node*>{m_world.get()};
             NotifyBeforeAndAfter notifyNodes(nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
@@ -3044,12 +3331,23 @@ namespace TrenchBroom {
             info("Reloading entity definitions");
         }
 
+        static void setEntityDefinitionsOfNodes(Assets::EntityDefinitionManager& manager, Model::WorldNode& worldNode, const Model::NodeCollection& nodes);
+        static void setEntityModelsOfNodes(Logger& logger, Assets::EntityModelManager& manager, const Model::NodeCollection& nodes);
+        static void setTexturesOfNodes(Assets::TextureManager& manager, const std::vector<Model::BrushNode*>& brushNodes, const std::vector<Model::PatchNode*>& patchNodes);
+
         void MapDocument::loadAssets() {
             loadEntityDefinitions();
-            setEntityDefinitions();
-            loadEntityModels();
+            m_entityModelManager->setLoader(m_game.get());
             loadTextures();
-            setTextures();
+
+            // collect the nodes once and assign all assets from the collection instead of traversing the world once
+            // per asset type; the entity definitions must be set first because they determine the entity models
+            const auto nodes = Model::collectNodesByType({m_world.get()});
+            setEntityDefinitionsOfNodes(*m_entityDefinitionManager, *m_world, nodes);
+            setEntityModelsOfNodes(*this, *m_entityModelManager, nodes);
+            if (setTexturesOfNodes(*m_textureManager, nodes.brushes(), nodes.patches())) {
+                textureUsageCountsDidChangeNotifier();
+            }
         }
 
         void MapDocument::unloadAssets() {
@@ -3098,13 +3396,28 @@ namespace TrenchBroom {
             loadTextures();
         }
 
+        /**
+         * Returns the texture cache shared by all documents.
+         */
+        static std::shared_ptr<IO::TextureCache> sharedTextureCache() {
+            static const auto cache = std::make_shared<IO::TextureCache>(IO::SystemPaths::userDataDirectory() + IO::Path("cache/textures"));
+            return cache;
+        }
+
         void MapDocument::loadTextures() {
+            TB_PROFILE_SCOPE("MapDocument::loadTextures");
             try {
                 const IO::Path docDir = m_path.isEmpty() ? IO::Path() : m_path.deleteLastComponent();
+                m_textureManager->setLoadAsynchronously(pref(Preferences::LoadTexturesInBackground));
+                m_textureManager->setTextureCache(pref(Preferences::CacheDecodedTextures) ? sharedTextureCache() : nullptr);
                 m_game->loadTextureCollections(m_world->entity(), docDir, *m_textureManager, logger());
             } catch (const Exception& e) {
                 error(e.what());
             }
+
+            if (m_textureManager->hasPendingCollections()) {
+                textureCollectionsWillLoadNotifier();
+            }
         }
 
         void MapDocument::unloadTextures() {
@@ -3112,87 +3425,133 @@ namespace TrenchBroom {
             m_textureManager->clear();
         }
 
-        static auto makeSetTexturesVisitor(Assets::TextureManager& manager) {
-            return kdl::overload(
-                [] (auto&& thisLambda, Model::WorldNode* world) { world->visitChildren(thisLambda); },
-                [] (auto&& thisLambda, Model::LayerNode* layer) { layer->visitChildren(thisLambda); },
-                [] (auto&& thisLambda, Model::GroupNode* group) { group->visitChildren(thisLambda); },
-                [] (auto&& thisLambda, Model::EntityNode* entity) { entity->visitChildren(thisLambda); },
-                [&](Model::BrushNode* brushNode) { 
-                    const Model::Brush& brush = brushNode->brush();
-                    for (size_t i = 0u; i < brush.faceCount(); ++i) {
-                        const Model::BrushFace& face = brush.face(i);
-                        Assets::Texture* texture = manager.texture(face.attributes().textureName());
-                        brushNode->setFaceTexture(i, texture);
-                    }
-                },
-                [&](Model::PatchNode* patchNode) { 
-                    auto* texture = manager.texture(patchNode->patch().textureName());
-                    patchNode->setTexture(texture);
+        /**
+         * Assigns textures to all faces of the given brushes and to the given patches. The texture names are collected
+         * first so that the texture manager can resolve them in one batch. Assigning a texture only modifies the brush
+         * and the texture's atomic usage count, so the brushes are processed in parallel.
+         *
+         * Returns true if the texture of any face or patch has changed, i.e. if any texture usage count has changed.
+         */
+        static bool setTexturesOfNodes(Assets::TextureManager& manager, const std::vector<Model::BrushNode*>& brushNodes, const std::vector<Model::PatchNode*>& patchNodes) {
+            // the index of the first face of each brush in textureNames
+            auto faceOffsets = std::vector<size_t>{};
+            faceOffsets.reserve(brushNodes.size());
+
+            auto textureNames = std::vector<Model::InternedString>{};
+            for (const auto* brushNode : brushNodes) {
+                faceOffsets.push_back(textureNames.size());
+
+                const Model::Brush& brush = brushNode->brush();
+                for (size_t i = 0u; i < brush.faceCount(); ++i) {
+                    textureNames.push_back(brush.face(i).attributes().internedTextureName());
                 }
-            );
+            }
+
+            const auto patchOffset = textureNames.size();
+            for (const auto* patchNode : patchNodes) {
+                textureNames.emplace_back(patchNode->patch().textureName());
+            }
+
+            const auto textures = manager.textures(textureNames);
+            auto changed = std::atomic<bool>{false};
+            kdl::parallel_for(brushNodes.size(), [&](const size_t i) {
+                auto* brushNode = brushNodes[i];
+                auto brushChanged = false;
+                for (size_t j = 0u; j < brushNode->brush().faceCount(); ++j) {
+                    brushChanged |= brushNode->setFaceTexture(j, textures[faceOffsets[i] + j]);
+                }
+                if (brushChanged) {
+                    changed.store(true, std::memory_order_relaxed);
+                }
+            });
+
+            auto patchesChanged = false;
+            for (size_t i = 0u; i < patchNodes.size(); ++i) {
+                patchesChanged |= patchNodes[i]->setTexture(textures[patchOffset + i]);
+            }
+            return changed.load() || patchesChanged;
         }
 
-        static auto makeUnsetTexturesVisitor() {
+        /**
+         * Assigns textures to all brush faces and patches of the given nodes and their descendants.
+         */
+        static bool setTexturesOfNodes(Assets::TextureManager& manager, const std::vector<Model::Node*>& nodes) {
+            const auto collectedNodes = Model::collectNodesByType(nodes);
+            return setTexturesOfNodes(manager, collectedNodes.brushes(), collectedNodes.patches());
+        }
+
+        /**
+         * Removes the textures from all brush faces and patches. Sets the given flag if any texture was removed.
+         */
+        static auto makeUnsetTexturesVisitor(bool& changed) {
             return kdl::overload (
                 [](auto&& thisLambda, Model::WorldNode* world) { world->visitChildren(thisLambda); },
                 [](auto&& thisLambda, Model::LayerNode* layer) { layer->visitChildren(thisLambda); },
                 [](auto&& thisLambda, Model::GroupNode* group) { group->visitChildren(thisLambda); },
                 [](auto&& thisLambda, Model::EntityNode* entity) { entity->visitChildren(thisLambda); },
-                [](Model::BrushNode* brushNode) { 
+                [&](Model::BrushNode* brushNode) {
                     const Model::Brush& brush = brushNode->brush();
                     for (size_t i = 0u; i < brush.faceCount(); ++i) {
-                        brushNode->setFaceTexture(i, nullptr);
+                        changed |= brushNode->setFaceTexture(i, nullptr);
                     }
                 },
-                [] (Model::PatchNode* patchNode) { 
-                    patchNode->setTexture(nullptr);
+                [&](Model::PatchNode* patchNode) {
+                    changed |= patchNode->setTexture(nullptr);
                 }
             );
         }
 
+        // The texture usage counts are maintained by the faces' texture references, so observers are only notified
+        // once per batch of assignments, and only if any face actually changed its texture. This spares the texture
+        // browser from sorting its textures by usage again after commands that don't affect any textures.
+
         void MapDocument::setTextures() {
-            m_world->accept(makeSetTexturesVisitor(*m_textureManager));
-            textureUsageCountsDidChangeNotifier();
+            if (setTexturesOfNodes(*m_textureManager, {m_world.get()})) {
+                textureUsageCountsDidChangeNotifier();
+            }
         }
 
         void MapDocument::setTextures(const std::vector<Model::Node*>& nodes) {
-            Model::Node::visitAll(nodes, makeSetTexturesVisitor(*m_textureManager));
-            textureUsageCountsDidChangeNotifier();
+            if (setTexturesOfNodes(*m_textureManager, nodes)) {
+                textureUsageCountsDidChangeNotifier();
+            }
         }
 
         void MapDocument::setTextures(const std::vector<Model::BrushFaceHandle>& faceHandles) {
+            auto changed = false;
             for (const auto& faceHandle : faceHandles) {
                 Model::BrushNode* node = faceHandle.node();
                 const Model::BrushFace& face = faceHandle.face();
                 Assets::Texture* texture = m_textureManager->texture(face.attributes().textureName());
-                node->setFaceTexture(faceHandle.faceIndex(), texture);
+                changed |= node->setFaceTexture(faceHandle.faceIndex(), texture);
+            }
+            if (changed) {
+                textureUsageCountsDidChangeNotifier();
             }
-            textureUsageCountsDidChangeNotifier();
         }
 
         void MapDocument::unsetTextures() {
-            m_world->accept(makeUnsetTexturesVisitor());
-            textureUsageCountsDidChangeNotifier();
+            auto changed = false;
+            m_world->accept(makeUnsetTexturesVisitor(changed));
+            if (changed) {
+                textureUsageCountsDidChangeNotifier();
+            }
         }
 
         void MapDocument::unsetTextures(const std::vector<Model::Node*>& nodes) {
-            Model::Node::visitAll(nodes, makeUnsetTexturesVisitor());
-            textureUsageCountsDidChangeNotifier();
+            auto changed = false;
+            Model::Node::visitAll(nodes, makeUnsetTexturesVisitor(changed));
+            if (changed) {
+                textureUsageCountsDidChangeNotifier();
+            }
         }
 
-        static auto makeSetEntityDefinitionsVisitor(Assets::EntityDefinitionManager& manager) {
-            // this helper lambda must be captured by value
-            const auto setEntityDefinition = [&](auto* node) {
-                auto* definition = manager.definition(node);
-                node->setDefinition(definition);
-            };
-
+        static auto makeCollectEntityNodesVisitor(std::vector<Model::EntityNodeBase*>& result) {
             return kdl::overload(
-                [=](auto&& thisLambda, Model::WorldNode* world) { setEntityDefinition(world); world->visitChildren(thisLambda); },
+                [&](auto&& thisLambda, Model::WorldNode* world) { result.push_back(world); world->visitChildren(thisLambda); },
                 [] (auto&& thisLambda, Model::LayerNode* layer) { layer->visitChildren(thisLambda); },
                 [] (auto&& thisLambda, Model::GroupNode* group) { group->visitChildren(thisLambda); },
-                [=](Model::EntityNode* entity)                  { setEntityDefinition(entity); },
+                [&](Model::EntityNode* entity)                  { result.push_back(entity); },
                 [] (Model::BrushNode*) {},
                 [] (Model::PatchNode*) {}
             );
@@ -3209,16 +3568,33 @@ namespace TrenchBroom {
             );
         }
 
+        static void setEntityDefinitionsOfNodes(Assets::EntityDefinitionManager& manager, Model::WorldNode& worldNode, const Model::NodeCollection& nodes) {
+            auto entityNodes = std::vector<Model::EntityNodeBase*>{};
+            entityNodes.reserve(nodes.entities().size() + 1u);
+            entityNodes.push_back(&worldNode);
+            entityNodes.insert(std::end(entityNodes), std::begin(nodes.entities()), std::end(nodes.entities()));
+            manager.setDefinitions(entityNodes);
+        }
+
         void MapDocument::setEntityDefinitions() {
-            m_world->accept(makeSetEntityDefinitionsVisitor(*m_entityDefinitionManager));
+            auto entityNodes = std::vector<Model::EntityNodeBase*>{};
+            m_world->accept(makeCollectEntityNodesVisitor(entityNodes));
+            m_entityDefinitionManager->setDefinitions(entityNodes);
         }
 
         void MapDocument::setEntityDefinitions(const std::vector<Model::Node*>& nodes) {
-            Model::Node::visitAll(nodes, makeSetEntityDefinitionsVisitor(*m_entityDefinitionManager));
+            auto entityNodes = std::vector<Model::EntityNodeBase*>{};
+            Model::Node::visitAll(nodes, makeCollectEntityNodesVisitor(entityNodes));
+            m_entityDefinitionManager->setDefinitions(entityNodes);
         }
 
         void MapDocument::unsetEntityDefinitions() {
-            m_world->accept(makeUnsetEntityDefinitionsVisitor());
+            m_world->setDefinition(nullptr);
+
+            const auto nodes = Model::collectNodesByType({m_world.get()});
+            for (auto* entityNode : nodes.entities()) {
+                entityNode->setDefinition(nullptr);
+            }
         }
 
         void MapDocument::unsetEntityDefinitions(const std::vector<Model::Node*>& nodes) {
@@ -3238,23 +3614,43 @@ namespace TrenchBroom {
             m_entityModelManager->clear();
         }
 
-        static auto makeSetEntityModelsVisitor(Logger& logger, Assets::EntityModelManager& manager) {
+        using EntityModelSpecifications = std::vector<std::tuple<Model::EntityNode*, Assets::ModelSpecification>>;
+
+        static auto makeCollectEntityModelsVisitor(Logger& logger, EntityModelSpecifications& result) {
             return kdl::overload(
                 [] (auto&& thisLambda, Model::WorldNode* world) { world->visitChildren(thisLambda); },
                 [] (auto&& thisLambda, Model::LayerNode* layer) { layer->visitChildren(thisLambda); },
                 [] (auto&& thisLambda, Model::GroupNode* group) { group->visitChildren(thisLambda); },
                 [&](Model::EntityNode* entityNode)                  {
-                    const auto modelSpec = Assets::safeGetModelSpecification(logger, entityNode->entity().classname(), [&]() {
+                    auto modelSpec = Assets::safeGetModelSpecification(logger, entityNode->entity().classname(), [&]() {
                         return entityNode->entity().modelSpecification();
                     });
-                    const auto* frame = manager.frame(modelSpec);
-                    entityNode->setModelFrame(frame);
+                    result.emplace_back(entityNode, std::move(modelSpec));
                 },
                 [] (Model::BrushNode*) {},
                 [] (Model::PatchNode*) {}
             );
         }
 
+        static void setEntityModelFrames(Assets::EntityModelManager& manager, const EntityModelSpecifications& entityModels) {
+            // parse all models up front so that they are loaded concurrently rather than one by one on first use
+            manager.loadModels(kdl::vec_transform(entityModels, [](const auto& entityModel) { return std::get<1>(entityModel); }));
+
+            for (const auto& [entityNode, modelSpec] : entityModels) {
+                entityNode->setModelFrame(manager.frame(modelSpec));
+            }
+        }
+
+        static void setEntityModelsOfNodes(Logger& logger, Assets::EntityModelManager& manager, const Model::NodeCollection& nodes) {
+            const auto entityModels = kdl::vec_transform(nodes.entities(), [&](auto* entityNode) {
+                auto modelSpec = Assets::safeGetModelSpecification(logger, entityNode->entity().classname(), [&]() {
+                    return entityNode->entity().modelSpecification();
+                });
+                return std::make_tuple(entityNode, std::move(modelSpec));
+            });
+            setEntityModelFrames(manager, entityModels);
+        }
+
         static auto makeUnsetEntityModelsVisitor() {
             return kdl::overload(
                 [](auto&& thisLambda, Model::WorldNode* world) { world->visitChildren(thisLambda); },
@@ -3267,15 +3663,22 @@ namespace TrenchBroom {
         }
 
         void MapDocument::setEntityModels() {
-            m_world->accept(makeSetEntityModelsVisitor(*this, *m_entityModelManager));
+            auto entityModels = EntityModelSpecifications{};
+            m_world->accept(makeCollectEntityModelsVisitor(*this, entityModels));
+            setEntityModelFrames(*m_entityModelManager, entityModels);
         }
 
         void MapDocument::setEntityModels(const std::vector<Model::Node*>& nodes) {
-            Model::Node::visitAll(nodes, makeSetEntityModelsVisitor(*this, *m_entityModelManager));
+            auto entityModels = EntityModelSpecifications{};
+            Model::Node::visitAll(nodes, makeCollectEntityModelsVisitor(*this, entityModels));
+            setEntityModelFrames(*m_entityModelManager, entityModels);
         }
 
         void MapDocument::unsetEntityModels() {
-            m_world->accept(makeUnsetEntityModelsVisitor());
+            const auto nodes = Model::collectNodesByType({m_world.get()});
+            for (auto* entityNode : nodes.entities()) {
+                entityNode->setModelFrame(nullptr);
+            }
         }
 
         void MapDocument::unsetEntityModels(const std::vector<Model::Node*>& nodes) {
@@ -3408,17 +3811,30 @@ namespace TrenchBroom {
             return m_tagManager->smartTag(index);
         }
 
-        static auto makeInitializeNodeTagsVisitor(Model::TagManager& tagManager) {
+        /**
+         * Initializes the tags of all visited nodes except for brushes, which are collected in the given vector.
+         */
+        static auto makeInitializeNodeTagsVisitor(Model::TagManager& tagManager, std::vector<Model::BrushNode*>& brushes) {
             return kdl::overload(
                 [&](auto&& thisLambda, Model::WorldNode* world) { world->initializeTags(tagManager); world->visitChildren(thisLambda); },
                 [&](auto&& thisLambda, Model::LayerNode* layer) { layer->initializeTags(tagManager); layer->visitChildren(thisLambda); },
                 [&](auto&& thisLambda, Model::GroupNode* group) { group->initializeTags(tagManager); group->visitChildren(thisLambda); },
                 [&](auto&& thisLambda, Model::EntityNode* entity) { entity->initializeTags(tagManager); entity->visitChildren(thisLambda); },
-                [&](Model::BrushNode* brush) { brush->initializeTags(tagManager); },
+                [&](Model::BrushNode* brush) { brushes.push_back(brush); },
                 [&](Model::PatchNode* patch) { patch->initializeTags(tagManager); }
             );
         }
 
+        /**
+         * Initializes the tags of the given brushes and their faces. The tags of a brush only depend on the brush
+         * itself, its faces and its containing entity, so the brushes are processed in parallel.
+         */
+        static void initializeBrushTags(Model::TagManager& tagManager, const std::vector<Model::BrushNode*>& brushes) {
+            kdl::parallel_for(brushes.size(), [&](const size_t i) {
+                brushes[i]->initializeTags(tagManager);
+            });
+        }
+
         static auto makeClearNodeTagsVisitor() {
             return kdl::overload(
                 [](auto&& thisLambda, Model::WorldNode* world) { world->clearTags(); world->visitChildren(thisLambda); },
@@ -3433,11 +3849,15 @@ namespace TrenchBroom {
         void MapDocument::initializeAllNodeTags(MapDocument* document) {
             assert(document == this);
             unused(document);
-            m_world->accept(makeInitializeNodeTagsVisitor(*m_tagManager));
+            auto brushes = std::vector<Model::BrushNode*>{};
+            m_world->accept(makeInitializeNodeTagsVisitor(*m_tagManager, brushes));
+            initializeBrushTags(*m_tagManager, brushes);
         }
 
         void MapDocument::initializeNodeTags(const std::vector<Model::Node*>& nodes) {
-            Model::Node::visitAll(nodes, makeInitializeNodeTagsVisitor(*m_tagManager));
+            auto brushes = std::vector<Model::BrushNode*>{};
+            Model::Node::visitAll(nodes, makeInitializeNodeTagsVisitor(*m_tagManager, brushes));
+            initializeBrushTags(*m_tagManager, brushes);
         }
 
         void MapDocument::clearNodeTags(const std::vector<Model::Node*>& nodes) {
@@ -3458,14 +3878,29 @@ namespace TrenchBroom {
         }
 
         void MapDocument::updateAllFaceTags() {
-            m_world->accept(kdl::overload(
-                [] (auto&& thisLambda, Model::WorldNode* world)   { world->visitChildren(thisLambda); },
-                [] (auto&& thisLambda, Model::LayerNode* layer)   { layer->visitChildren(thisLambda); },
-                [] (auto&& thisLambda, Model::GroupNode* group)   { group->visitChildren(thisLambda); },
-                [] (auto&& thisLambda, Model::EntityNode* entity) { entity->visitChildren(thisLambda); },
-                [&](Model::BrushNode* brush)                      { brush->initializeTags(*m_tagManager); },
-                [] (Model::PatchNode*)                            {}
-            ));
+            initializeBrushTags(*m_tagManager, Model::collectNodesByType({m_world.get()}).brushes());
+        }
+
+        void MapDocument::invalidateExportCache(const std::vector<Model::Node*>& nodes) {
+            m_exportCache->invalidate(nodes);
+        }
+
+        void MapDocument::invalidateExportCacheForFaces(const std::vector<Model::BrushFaceHandle>& faces) {
+            auto nodes = std::vector<Model::Node*>{};
+            nodes.reserve(faces.size());
+            for (const auto& handle : faces) {
+                nodes.push_back(handle.node());
+            }
+            m_exportCache->invalidate(nodes);
+        }
+
+        void MapDocument::removeFromExportCache(const std::vector<Model::Node*>& nodes) {
+            // the removed nodes may be destroyed later, so their descendants must not remain in the cache either
+            m_exportCache->invalidateRecursively(nodes);
+        }
+
+        void MapDocument::clearExportCache() {
+            m_exportCache->clear();
         }
 
         bool MapDocument::persistent() const {
@@ -3529,9 +3964,23 @@ namespace TrenchBroom {
             m_notifierConnection += nodesWereAddedNotifier.connect(this, &MapDocument::initializeNodeTags);
             m_notifierConnection += nodesWillBeRemovedNotifier.connect(this, &MapDocument::clearNodeTags);
             m_notifierConnection += nodesDidChangeNotifier.connect(this, &MapDocument::updateNodeTags);
+            m_notifierConnection += nodesDidChangeNotifier.connect([&](const std::vector<Model::Node*>& nodes) {
+                coalescedNodesDidChangeNotifier.notify(nodes);
+            });
             m_notifierConnection += brushFacesDidChangeNotifier.connect(this, &MapDocument::updateFaceTags);
             m_notifierConnection += modsDidChangeNotifier.connect(this, &MapDocument::updateAllFaceTags);
             m_notifierConnection += textureCollectionsDidChangeNotifier.connect(this, &MapDocument::updateAllFaceTags);
+            m_notifierConnection += textureCollectionsDidLoadNotifier.connect(this, &MapDocument::updateAllFaceTags);
+
+            // export cache
+            m_notifierConnection += documentWasClearedNotifier.connect([&](MapDocument*) { clearExportCache(); });
+            m_notifierConnection += nodesDidChangeNotifier.connect(this, &MapDocument::invalidateExportCache);
+            m_notifierConnection += brushFacesDidChangeNotifier.connect(this, &MapDocument::invalidateExportCacheForFaces);
+            m_notifierConnection += nodesWereRemovedNotifier.connect(this, &MapDocument::removeFromExportCache);
+            // the serialized surface attributes of brush faces may depend on their textures
+            m_notifierConnection += textureCollectionsDidChangeNotifier.connect(this, &MapDocument::clearExportCache);
+            m_notifierConnection += textureCollectionsDidLoadNotifier.connect(this, &MapDocument::clearExportCache);
+            m_notifierConnection += modsDidChangeNotifier.connect(this, &MapDocument::clearExportCache);
         }
 
         void MapDocument::textureCollectionsWillChange() {
@@ -3624,20 +4073,25 @@ namespace TrenchBroom {
         }
 
         void Transaction::rollback() {
+            // dispatch now because the rollback may destroy nodes that were added during this transaction
+            m_document->coalescedNodesDidChangeNotifier.flush();
             m_document->rollbackTransaction();
         }
 
         void Transaction::cancel() {
+            m_document->coalescedNodesDidChangeNotifier.endCoalescing();
             m_document->cancelTransaction();
             m_cancelled = true;
         }
 
         void Transaction::begin(const std::string& name) {
             m_document->startTransaction(name);
+            m_document->coalescedNodesDidChangeNotifier.beginCoalescing();
         }
 
         void Transaction::commit() {
             m_document->commitTransaction();
+            m_document->coalescedNodesDidChangeNotifier.endCoalescing();
         }
     }
 }
@@ -37,6 +37,8 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -52,6 +54,10 @@ namespace TrenchBroom {
         class TextureManager;
     }
 
+    namespace IO {
+        class NodeSerializationCache;
+    }
+
     namespace Model {
         class Brush;
         class BrushFace;
@@ -104,6 +110,12 @@ namespace TrenchBroom {
             std::unique_ptr<Assets::TextureManager> m_textureManager;
             std::unique_ptr<Model::TagManager> m_tagManager;
 
+            /**
+             * Keeps the serialized brushes and patches of the last map export so that repeated exports, e.g. when
+             * compiling, only have to serialize the nodes that changed in the meantime.
+             */
+            std::unique_ptr<IO::NodeSerializationCache> m_exportCache;
+
             std::unique_ptr<Model::EditorContext> m_editorContext;
             std::unique_ptr<Grid> m_grid;
 
@@ -123,6 +135,7 @@ namespace TrenchBroom {
             vm::bbox3 m_lastSelectionBounds;
             mutable vm::bbox3 m_selectionBounds;
             mutable bool m_selectionBoundsValid;
+            std::optional<vm::mat4x4> m_selectionPreviewTransformation;
 
             ViewEffectsService* m_viewEffectsService;
 
@@ -164,6 +177,13 @@ namespace TrenchBroom {
             Notifier<const std::vector<Model::Node*>&> nodesWillChangeNotifier;
             Notifier<const std::vector<Model::Node*>&> nodesDidChangeNotifier;
 
+            /**
+             * Forwards the notifications of nodesDidChangeNotifier, but coalesces them while a Transaction object is
+             * alive. Observers that only refresh views or UI state should connect here so that a multi-step operation
+             * triggers their work only once.
+             */
+            CoalescingNotifier<Model::Node*> coalescedNodesDidChangeNotifier;
+
             Notifier<const std::vector<Model::Node*>&> nodeVisibilityDidChangeNotifier;
             Notifier<const std::vector<Model::Node*>&> nodeLockingDidChangeNotifier;
 
@@ -174,6 +194,8 @@ namespace TrenchBroom {
 
             Notifier<> textureCollectionsWillChangeNotifier;
             Notifier<> textureCollectionsDidChangeNotifier;
+            Notifier<> textureCollectionsWillLoadNotifier;
+            Notifier<> textureCollectionsDidLoadNotifier;
             
             Notifier<> textureUsageCountsDidChangeNotifier;
 
@@ -273,8 +295,14 @@ namespace TrenchBroom {
         public: // copy and paste
             std::string serializeSelectedNodes();
             std::string serializeSelectedBrushFaces();
+            /**
+             * Returns cache data for the given string returned by serializeSelectedNodes. Passing the cache data to
+             * paste along with the string avoids parsing the string again when pasting into a document of the same
+             * map format. The cache data is ignored if it doesn't match the string.
+             */
+            std::string serializedNodesCacheData(const std::string& str);
 
-            PasteType paste(const std::string& str);
+            PasteType paste(const std::string& str, std::string_view cacheData = {});
         private:
             bool pasteNodes(const std::vector<Model::Node*>& nodes);
             bool pasteBrushFaces(const std::vector<Model::BrushFace>& faces);
@@ -304,6 +332,15 @@ namespace TrenchBroom {
             const vm::bbox3& referenceBounds() const override;
             const vm::bbox3& lastSelectionBounds() const override;
             const vm::bbox3& selectionBounds() const override;
+
+            /**
+             * A transformation which is applied to the selected objects when rendering them, but not to the objects
+             * themselves. Interactive tools use it to preview a transformation which they apply once the user is
+             * done, instead of transforming the objects on every step.
+             */
+            const std::optional<vm::mat4x4>& selectionPreviewTransformation() const;
+            void setSelectionPreviewTransformation(std::optional<vm::mat4x4> transformation);
+
             const std::string& currentTextureName() const override;
             void setCurrentTextureName(const std::string& currentTextureName);
 
@@ -460,6 +497,12 @@ namespace TrenchBroom {
             bool setFaceAttributes(const Model::BrushFaceAttributes& attributes) override;
             bool setFaceAttributesExceptContentFlags(const Model::BrushFaceAttributes& attributes) override;
             bool setFaceAttributes(const Model::ChangeBrushFaceAttributesRequest& request) override;
+            /**
+             * Sets the texture name of the given faces, which need not be selected. Unless some of the faces belong
+             * to linked groups, only the previous texture names are recorded for undo instead of copies of the
+             * affected brushes.
+             */
+            bool setFaceTextureName(const std::vector<Model::BrushFaceHandle>& faces, const std::string& textureName);
             bool copyTexCoordSystemFromFace(const Model::TexCoordSystemSnapshot& coordSystemSnapshot, const Model::BrushFaceAttributes& attribs, const vm::plane3& sourceFacePlane, const Model::WrapStyle wrapStyle);
             bool moveTextures(const vm::vec3f& cameraUp, const vm::vec3f& cameraRight, const vm::vec2f& delta) override;
             bool rotateTextures(float angle) override;
@@ -512,6 +555,12 @@ namespace TrenchBroom {
             virtual std::unique_ptr<CommandResult> doExecuteAndStore(std::unique_ptr<UndoableCommand>&& command) = 0;
         public: // asset state management
             void commitPendingAssets();
+            /**
+             * Assigns the textures of collections that have finished loading in the background. Must be called
+             * periodically on the main thread while texture collections are loading.
+             */
+            void collectLoadedTextures();
+            bool hasPendingTextures() const;
         public: // picking
             void pick(const vm::ray3& pickRay, Model::PickResult& pickResult) const;
             std::vector<Model::Node*> findNodesContaining(const vm::vec3& point) const;
@@ -532,7 +581,23 @@ namespace TrenchBroom {
             void setEnabledTextureCollections(const std::vector<IO::Path>& paths);
             void reloadTextureCollections();
 
+            /**
+             * Reloads only the texture collections with the given paths and keeps all other collections.
+             */
+            void reloadTextureCollections(const std::vector<IO::Path>& paths);
+
             void reloadEntityDefinitions();
+
+            /**
+             * Returns the absolute path of the entity definition file, or an empty path if it cannot be found.
+             */
+            IO::Path entityDefinitionFilePath() const;
+
+            /**
+             * Returns the enabled texture collections that are stored in files, each paired with the absolute path of
+             * its file. Collections whose files cannot be found are omitted.
+             */
+            std::vector<std::pair<IO::Path, IO::Path>> textureCollectionFilePaths() const;
         private:
             void loadAssets();
             void unloadAssets();
@@ -596,6 +661,11 @@ namespace TrenchBroom {
 
             void updateFaceTags(const std::vector<Model::BrushFaceHandle>& faces);
             void updateAllFaceTags();
+
+            void invalidateExportCache(const std::vector<Model::Node*>& nodes);
+            void invalidateExportCacheForFaces(const std::vector<Model::BrushFaceHandle>& faces);
+            void removeFromExportCache(const std::vector<Model::Node*>& nodes);
+            void clearExportCache();
         public: // document path
             bool persistent() const;
             std::string filename() const;
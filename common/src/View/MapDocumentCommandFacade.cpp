@@ -27,6 +27,7 @@
 #include "Model/Brush.h"
 #include "Model/BrushError.h"
 #include "Model/BrushFace.h"
+#include "Model/BrushFaceHandle.h"
 #include "Model/BrushNode.h"
 #include "Model/ChangeBrushFaceAttributesRequest.h"
 #include "Model/EditorContext.h"
@@ -39,6 +40,7 @@
 #include "Model/ModelUtils.h"
 #include "Model/PatchNode.h"
 #include "Model/WorldNode.h"
+#include "View/ChangeBrushFaceAttributesCommand.h"
 #include "View/CommandProcessor.h"
 #include "View/UndoableCommand.h"
 #include "View/Selection.h"
@@ -54,9 +56,11 @@
 #include <vecmath/segment.h>
 #include <vecmath/polygon.h>
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace TrenchBroom {
@@ -68,6 +72,7 @@ namespace TrenchBroom {
 
         MapDocumentCommandFacade::MapDocumentCommandFacade() :
         m_commandProcessor(std::make_unique<CommandProcessor>(this)) {
+            m_commandProcessor->setUndoMemoryBudget(static_cast<size_t>(std::max(0, pref(Preferences::UndoMemoryBudget))) * 1024u * 1024u);
             connectObservers();
         }
 
@@ -94,7 +99,7 @@ namespace TrenchBroom {
             m_selectedNodes.addNodes(selected);
 
             Selection selection;
-            selection.addSelectedNodes(selected);
+            selection.addSelectedNodes(std::move(selected));
 
             selectionDidChangeNotifier(selection);
             invalidateSelectionBounds();
@@ -118,7 +123,7 @@ namespace TrenchBroom {
             m_selectedBrushFaces = kdl::vec_concat(std::move(m_selectedBrushFaces), selected);
 
             Selection selection;
-            selection.addSelectedBrushFaces(selected);
+            selection.addSelectedBrushFaces(std::move(selected));
 
             selectionDidChangeNotifier(selection);
         }
@@ -158,7 +163,7 @@ namespace TrenchBroom {
             m_selectedNodes.removeNodes(deselected);
 
             Selection selection;
-            selection.addDeselectedNodes(deselected);
+            selection.addDeselectedNodes(std::move(deselected));
 
             selectionDidChangeNotifier(selection);
             invalidateSelectionBounds();
@@ -179,10 +184,11 @@ namespace TrenchBroom {
                 }
             }
 
-            m_selectedBrushFaces = kdl::vec_erase_all(std::move(m_selectedBrushFaces), deselected);
+            // the faces are already deselected, so this avoids searching for every deselected face
+            m_selectedBrushFaces = kdl::vec_erase_if(std::move(m_selectedBrushFaces), [](const auto& handle) { return !handle.face().selected(); });
 
             Selection selection;
-            selection.addDeselectedBrushFaces(deselected);
+            selection.addDeselectedBrushFaces(std::move(deselected));
 
             selectionDidChangeNotifier(selection);
         }
@@ -220,7 +226,7 @@ namespace TrenchBroom {
             }
 
             Selection selection;
-            selection.addDeselectedBrushFaces(m_selectedBrushFaces);
+            selection.addDeselectedBrushFaces(std::move(m_selectedBrushFaces));
 
             m_selectedBrushFaces.clear();
 
@@ -365,6 +371,42 @@ namespace TrenchBroom {
             invalidateSelectionBounds();
         }
 
+        static std::vector<Model::Node*> collectBrushNodes(const std::vector<Model::BrushFaceHandle>& faceHandles) {
+            return kdl::vec_sort_and_remove_duplicates(kdl::vec_transform(faceHandles, [](const auto& faceHandle) -> Model::Node* { return faceHandle.node(); }));
+        }
+
+        void MapDocumentCommandFacade::performSwapBrushFaceTextureNames(std::vector<std::pair<Model::BrushFaceHandle, std::string>>& facesToSwap) {
+            const auto faceHandles = kdl::vec_transform(facesToSwap, [](const auto& pair) { return pair.first; });
+            const auto nodes = collectBrushNodes(faceHandles);
+            const auto parents = collectParents(nodes);
+
+            // the geometry doesn't change, so the descendants don't need to be notified
+            NotifyBeforeAndAfter notifyNodes(nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
+            NotifyBeforeAndAfter notifyParents(nodesWillChangeNotifier, nodesDidChangeNotifier, parents);
+
+            for (auto& [faceHandle, textureName] : facesToSwap) {
+                textureName = faceHandle.node()->setFaceTextureName(faceHandle.faceIndex(), std::move(textureName));
+            }
+
+            setTextures(faceHandles);
+        }
+
+        void MapDocumentCommandFacade::performSwapBrushFaceAttributes(std::vector<BrushFaceAttributesState>& facesToSwap) {
+            const auto faceHandles = kdl::vec_transform(facesToSwap, [](const auto& state) { return state.faceHandle; });
+            const auto nodes = collectBrushNodes(faceHandles);
+            const auto parents = collectParents(nodes);
+
+            NotifyBeforeAndAfter notifyNodes(nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
+            NotifyBeforeAndAfter notifyParents(nodesWillChangeNotifier, nodesDidChangeNotifier, parents);
+
+            for (auto& state : facesToSwap) {
+                auto* brushNode = state.faceHandle.node();
+                std::tie(state.attributes, state.texCoordSystemSnapshot) = brushNode->setFaceAttributes(state.faceHandle.faceIndex(), std::move(state.attributes), state.texCoordSystemSnapshot.get());
+            }
+
+            setTextures(faceHandles);
+        }
+
         std::map<Model::Node*, Model::VisibilityState> MapDocumentCommandFacade::setVisibilityState(const std::vector<Model::Node*>& nodes, const Model::VisibilityState visibilityState) {
             std::map<Model::Node*, Model::VisibilityState> result;
 
@@ -379,7 +421,9 @@ namespace TrenchBroom {
                 }
             }
 
-            nodeVisibilityDidChangeNotifier(changedNodes);
+            if (!changedNodes.empty()) {
+                nodeVisibilityDidChangeNotifier(changedNodes);
+            }
             return result;
         }
 
@@ -397,7 +441,9 @@ namespace TrenchBroom {
                 }
             }
 
-            nodeVisibilityDidChangeNotifier(changedNodes);
+            if (!changedNodes.empty()) {
+                nodeVisibilityDidChangeNotifier(changedNodes);
+            }
             return result;
         }
 
@@ -410,7 +456,9 @@ namespace TrenchBroom {
                     changedNodes.push_back(node);
             }
 
-            nodeVisibilityDidChangeNotifier(changedNodes);
+            if (!changedNodes.empty()) {
+                nodeVisibilityDidChangeNotifier(changedNodes);
+            }
         }
 
         std::map<Model::Node*, Model::LockState> MapDocumentCommandFacade::setLockState(const std::vector<Model::Node*>& nodes, const Model::LockState lockState) {
@@ -427,7 +475,9 @@ namespace TrenchBroom {
                 }
             }
 
-            nodeLockingDidChangeNotifier(changedNodes);
+            if (!changedNodes.empty()) {
+                nodeLockingDidChangeNotifier(changedNodes);
+            }
             return result;
         }
 
@@ -440,7 +490,9 @@ namespace TrenchBroom {
                     changedNodes.push_back(node);
             }
 
-            nodeLockingDidChangeNotifier(changedNodes);
+            if (!changedNodes.empty()) {
+                nodeLockingDidChangeNotifier(changedNodes);
+            }
         }
 
         void MapDocumentCommandFacade::performPushGroup(Model::GroupNode* group) {
@@ -38,6 +38,7 @@ namespace TrenchBroom {
     }
 
     namespace View {
+        struct BrushFaceAttributesState;
         class CommandProcessor;
 
         /**
@@ -78,6 +79,8 @@ namespace TrenchBroom {
             std::vector<std::pair<Model::Node*, std::vector<std::unique_ptr<Model::Node>>>> performReplaceChildren(std::vector<std::pair<Model::Node*, std::vector<std::unique_ptr<Model::Node>>>> nodes);
         public: // swapping node contents
             void performSwapNodeContents(std::vector<std::pair<Model::Node*, Model::NodeContents>>& nodesToSwap);
+            void performSwapBrushFaceTextureNames(std::vector<std::pair<Model::BrushFaceHandle, std::string>>& facesToSwap);
+            void performSwapBrushFaceAttributes(std::vector<BrushFaceAttributesState>& facesToSwap);
         public: // Node Visibility
             std::map<Model::Node*, Model::VisibilityState> setVisibilityState(const std::vector<Model::Node*>& nodes, Model::VisibilityState visibilityState);
             std::map<Model::Node*, Model::VisibilityState> setVisibilityEnsured(const std::vector<Model::Node*>& nodes);
@@ -19,12 +19,15 @@
 
 #include "MapFrame.h"
 
+#include "AllocationCounting.h"
 #include "Console.h"
 #include "Exceptions.h"
 #include "FileLogger.h"
 #include "Preferences.h"
+#include "Profiler.h"
 #include "PreferenceManager.h"
 #include "TrenchBroomApp.h"
+#include "IO/IOUtils.h"
 #include "IO/PathQt.h"
 #include "Model/BrushNode.h"
 #include "Model/EditorContext.h"
@@ -41,7 +44,9 @@
 #include "Model/Node.h"
 #include "Model/PatchNode.h"
 #include "Model/WorldNode.h"
+#include "Renderer/VboManager.h"
 #include "View/Actions.h"
+#include "View/AssetFileWatcher.h"
 #include "View/Autosaver.h"
 #if !defined __APPLE__
 #include "View/BorderLine.h"
@@ -72,6 +77,7 @@
 #include "View/QtUtils.h"
 #include "View/MapViewToolBox.h"
 
+#include <kdl/invoke.h>
 #include <kdl/overload.h>
 #include <kdl/string_format.h>
 #include <kdl/string_utils.h>
@@ -81,6 +87,7 @@
 
 #include <cassert>
 #include <chrono>
+#include <fstream>
 #include <iterator>
 #include <string>
 #include <vector>
@@ -90,6 +97,7 @@
 #include <QLabel>
 #include <QString>
 #include <QApplication>
+#include <QByteArray>
 #include <QChildEvent>
 #include <QClipboard>
 #include <QInputDialog>
@@ -111,12 +119,14 @@ namespace TrenchBroom {
         m_frameManager(frameManager),
         m_document(std::move(document)),
         m_lastInputTime(std::chrono::system_clock::now()),
-        m_autosaver(std::make_unique<Autosaver>(m_document)),
+        m_autosaver(std::make_unique<Autosaver>(m_document, std::chrono::minutes(10), 50u, 6u)),
         m_autosaveTimer(nullptr),
+        m_loadedAssetsTimer(nullptr),
+        m_assetFileWatcher(std::make_unique<AssetFileWatcher>(m_document)),
         m_toolBar(nullptr),
         m_hSplitter(nullptr),
         m_vSplitter(nullptr),
-        m_contextManager(std::make_unique<GLContextManager>()),
+        m_contextManager(frameManager->contextManager()),
         m_mapView(nullptr),
         m_currentMapView(nullptr),
         m_infoPanel(nullptr),
@@ -155,6 +165,13 @@ namespace TrenchBroom {
             m_autosaveTimer = new QTimer(this);
             m_autosaveTimer->start(1000);
 
+            // picks up texture collections that are loaded in the background, runs only while loads are pending
+            m_loadedAssetsTimer = new QTimer(this);
+            m_loadedAssetsTimer->setInterval(100);
+            if (m_document->hasPendingTextures()) {
+                m_loadedAssetsTimer->start();
+            }
+
             connectObservers();
             bindEvents();
 
@@ -195,7 +212,11 @@ namespace TrenchBroom {
             m_document->setViewEffectsService(nullptr);
             m_document.reset();
 
-            // FIXME: m_contextManager is deleted via smart pointer; it may release openGL resources in its destructor
+            // the render view's context is still current, so the fences and pooled buffers can be freed
+            m_contextManager->vboManager().releaseResources();
+
+            // FIXME: m_contextManager is shared with the other frames and deleted via smart pointer when the last frame
+            // is destroyed; it may release openGL resources in its destructor
         }
 
         void MapFrame::positionOnScreen(QWidget* reference) {
@@ -660,7 +681,7 @@ namespace TrenchBroom {
 
             m_notifierConnection += m_document->documentWasClearedNotifier.connect(this, &MapFrame::documentWasCleared);
             m_notifierConnection += m_document->documentWasNewedNotifier.connect(this, &MapFrame::documentDidChange);
-            m_notifierConnection += m_document->documentWasLoadedNotifier.connect(this, &MapFrame::documentDidChange);
+            m_notifierConnection += m_document->documentWasLoadedNotifier.connect(this, &MapFrame::documentWasLoaded);
             m_notifierConnection += m_document->documentWasSavedNotifier.connect(this, &MapFrame::documentDidChange);
             m_notifierConnection += m_document->documentModificationStateDidChangeNotifier.connect(this, &MapFrame::documentModificationStateDidChange);
             m_notifierConnection += m_document->transactionDoneNotifier.connect(this, &MapFrame::transactionDone);
@@ -671,6 +692,7 @@ namespace TrenchBroom {
             m_notifierConnection += m_document->groupWasClosedNotifier.connect(this, &MapFrame::groupWasClosed);
             m_notifierConnection += m_document->nodeVisibilityDidChangeNotifier.connect(this, &MapFrame::nodeVisibilityDidChange);
             m_notifierConnection += m_document->editorContextDidChangeNotifier.connect(this, &MapFrame::editorContextDidChange);
+            m_notifierConnection += m_document->textureCollectionsWillLoadNotifier.connect(this, &MapFrame::textureCollectionsWillLoad);
 
             Grid& grid = m_document->grid();
             m_notifierConnection += grid.gridDidChangeNotifier.connect(this, &MapFrame::gridDidChange);
@@ -693,6 +715,11 @@ namespace TrenchBroom {
             updateRecentDocumentsMenu();
         }
 
+        void MapFrame::documentWasLoaded(View::MapDocument* document) {
+            documentDidChange(document);
+            m_autosaver->recoverJournal(logger());
+        }
+
         void MapFrame::documentModificationStateDidChange() {
             updateTitleDelayed();
         }
@@ -767,8 +794,15 @@ namespace TrenchBroom {
             updateStatusBarDelayed();
         }
 
+        void MapFrame::textureCollectionsWillLoad() {
+            if (!m_loadedAssetsTimer->isActive()) {
+                m_loadedAssetsTimer->start();
+            }
+        }
+
         void MapFrame::bindEvents() {
             connect(m_autosaveTimer, &QTimer::timeout, this, &MapFrame::triggerAutosave);
+            connect(m_loadedAssetsTimer, &QTimer::timeout, this, &MapFrame::collectLoadedAssets);
             connect(qApp, &QApplication::focusChanged, this, &MapFrame::focusChange);
             connect(m_gridChoice, QOverload<int>::of(&QComboBox::activated), this, [this](const int index) { setGridSize(index + Grid::MinSize); });
             connect(QApplication::clipboard(), &QClipboard::dataChanged, this, [this]() {
@@ -797,6 +831,16 @@ namespace TrenchBroom {
             if (!confirmOrDiscardChanges() || !closeCompileDialog()) {
                 return false;
             }
+
+            // loading blocks the event loop, so indicate that we are busy until the document is loaded
+            QApplication::setOverrideCursor(Qt::WaitCursor);
+            statusBar()->showMessage(tr("Loading %1...").arg(IO::pathAsQString(path.lastComponent())));
+            statusBar()->repaint();
+            const auto restoreStatus = kdl::invoke_later{[&]() {
+                statusBar()->clearMessage();
+                QApplication::restoreOverrideCursor();
+            }};
+
             const auto startTime = std::chrono::high_resolution_clock::now();
             m_document->loadDocument(mapFormat, MapDocument::DefaultWorldBounds, game, path);
             const auto endTime = std::chrono::high_resolution_clock::now();
@@ -1090,17 +1134,32 @@ namespace TrenchBroom {
             }
         }
 
+        /**
+         * The clipboard format for the cache data that accompanies copied nodes. Only TrenchBroom understands this
+         * format, other applications use the text.
+         */
+        static const auto NodesCacheMimeType = QString("application/x-trenchbroom-nodes-cache");
+
         void MapFrame::copyToClipboard() {
             QClipboard *clipboard = QApplication::clipboard();
 
-            std::string str;
+            auto* mimeData = new QMimeData();
             if (m_document->hasSelectedNodes()) {
-                str = m_document->serializeSelectedNodes();
+                const auto str = m_document->serializeSelectedNodes();
+                mimeData->setText(mapStringToUnicode(m_document->encoding(), str));
+
+                // Parsing large selections is slow, so we parse them once now and let every paste restore the
+                // parsed objects from the cache data.
+                const auto cacheData = m_document->serializedNodesCacheData(str);
+                if (!cacheData.empty()) {
+                    mimeData->setData(NodesCacheMimeType, QByteArray(cacheData.data(), static_cast<int>(cacheData.size())));
+                }
             } else if (m_document->hasSelectedBrushFaces()) {
-                str = m_document->serializeSelectedBrushFaces();
+                const auto str = m_document->serializeSelectedBrushFaces();
+                mimeData->setText(mapStringToUnicode(m_document->encoding(), str));
             }
 
-            clipboard->setText(mapStringToUnicode(m_document->encoding(), str));
+            clipboard->setMimeData(mimeData);
         }
 
         bool MapFrame::canCutSelection() const {
@@ -1145,7 +1204,10 @@ namespace TrenchBroom {
                 return PasteType::Failed;
             }
 
-            return m_document->paste(mapStringFromUnicode(m_document->encoding(), qtext));
+            // the cache data is ignored unless it was created for exactly this text and the document's map format
+            const auto* mimeData = clipboard->mimeData();
+            const auto cacheData = mimeData != nullptr ? mimeData->data(NodesCacheMimeType) : QByteArray();
+            return m_document->paste(mapStringFromUnicode(m_document->encoding(), qtext), std::string_view(cacheData.constData(), static_cast<size_t>(cacheData.size())));
         }
 
         /**
@@ -1719,10 +1781,43 @@ namespace TrenchBroom {
             m_inspector->faceInspector()->revealTexture(texture);
         }
 
+        void MapFrame::exportPerformanceTrace() {
+            const QString fileName = QFileDialog::getSaveFileName(this, tr("Export Performance Trace"), "TrenchBroom-trace.json", "Chrome trace files (*.json)");
+            if (fileName.isEmpty()) {
+                return;
+            }
+
+            const auto path = IO::pathFromQString(fileName);
+            auto stream = IO::openPathAsOutputStream(path);
+            if (!stream) {
+                QMessageBox::critical(this, "", QString::fromStdString("Could not write performance trace to " + path.asString()));
+                return;
+            }
+
+            writeChromeTrace(stream);
+            logger().info() << "Exported performance trace to " << path;
+        }
+
         void MapFrame::debugPrintVertices() {
             m_document->printVertices();
         }
 
+        void MapFrame::debugPrintAllocationCounts() {
+            if (!allocationCountingEnabled()) {
+                m_document->info("Allocation counting is disabled, rebuild with TB_ENABLE_ALLOCATION_COUNTING to enable it");
+                return;
+            }
+
+            for (size_t i = 0u; i < AllocationTagCount; ++i) {
+                const auto tag = static_cast<AllocationTag>(i);
+                const auto counts = allocationCounts(tag);
+                m_document->info() << allocationTagName(tag) << ": " << counts.allocations << " allocations, " << counts.bytes << " bytes";
+            }
+
+            const auto total = totalAllocationCounts();
+            m_document->info() << "Total: " << total.allocations << " allocations, " << total.bytes << " bytes";
+        }
+
         void MapFrame::debugCreateBrush() {
             bool ok = false;
             const QString str = QInputDialog::getText(this, "Create Brush", "Enter a list of at least 4 points (x y z) (x y z) ...", QLineEdit::Normal, "", &ok);
@@ -1894,6 +1989,13 @@ namespace TrenchBroom {
             }
         }
 
+        void MapFrame::collectLoadedAssets() {
+            m_document->collectLoadedTextures();
+            if (!m_document->hasPendingTextures()) {
+                m_loadedAssetsTimer->stop();
+            }
+        }
+
         // DebugPaletteWindow
 
         DebugPaletteWindow::DebugPaletteWindow(QWidget *parent)
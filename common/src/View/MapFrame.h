@@ -62,6 +62,7 @@ namespace TrenchBroom {
 
     namespace View {
         class Action;
+        class AssetFileWatcher;
         class Autosaver;
         class Console;
         class FrameManager;
@@ -85,13 +86,15 @@ namespace TrenchBroom {
             std::chrono::time_point<std::chrono::system_clock> m_lastInputTime;
             std::unique_ptr<Autosaver> m_autosaver;
             QTimer* m_autosaveTimer;
+            QTimer* m_loadedAssetsTimer;
+            std::unique_ptr<AssetFileWatcher> m_assetFileWatcher;
 
             QToolBar* m_toolBar;
 
             QSplitter* m_hSplitter;
             QSplitter* m_vSplitter;
 
-            std::unique_ptr<GLContextManager> m_contextManager;
+            std::shared_ptr<GLContextManager> m_contextManager;
             SwitchableMapViewContainer* m_mapView;
             /**
              * Last focused MapViewBase. It's a QPointer to handle changing from e.g. a 2-pane map view to 1-pane.
@@ -155,6 +158,7 @@ namespace TrenchBroom {
 
             void documentWasCleared(View::MapDocument* document);
             void documentDidChange(View::MapDocument* document);
+            void documentWasLoaded(View::MapDocument* document);
             void documentModificationStateDidChange();
 
             void transactionDone(const std::string&);
@@ -171,6 +175,7 @@ namespace TrenchBroom {
             void groupWasClosed(Model::GroupNode* group);
             void nodeVisibilityDidChange(const std::vector<Model::Node*>& nodes);
             void editorContextDidChange();
+            void textureCollectionsWillLoad();
         private: // menu event handlers
             void bindEvents();
         public:
@@ -365,7 +370,10 @@ namespace TrenchBroom {
 
             void revealTexture(const Assets::Texture* texture);
 
+            void exportPerformanceTrace();
+
             void debugPrintVertices();
+            void debugPrintAllocationCounts();
             void debugCreateBrush();
             void debugCreateCube();
             void debugClipBrush();
@@ -387,6 +395,7 @@ namespace TrenchBroom {
             bool eventFilter(QObject* target, QEvent* event) override;
         private:
             void triggerAutosave();
+            void collectLoadedAssets();
         };
 
         class DebugPaletteWindow : public QDialog {
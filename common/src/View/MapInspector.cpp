@@ -288,7 +288,7 @@ namespace TrenchBroom {
             auto document = kdl::mem_lock(m_document);
             m_notifierConnection += document->documentWasNewedNotifier.connect(this, &MapPropertiesEditor::documentWasNewed);
             m_notifierConnection += document->documentWasLoadedNotifier.connect(this, &MapPropertiesEditor::documentWasLoaded);
-            m_notifierConnection += document->nodesDidChangeNotifier.connect(this, &MapPropertiesEditor::nodesDidChange);
+            m_notifierConnection += document->coalescedNodesDidChangeNotifier.connect(this, &MapPropertiesEditor::nodesDidChange);
         }
 
         void MapPropertiesEditor::documentWasNewed(MapDocument*) {
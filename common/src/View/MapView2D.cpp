@@ -65,6 +65,8 @@
 #include <kdl/overload.h>
 #include <kdl/result.h>
 
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
 #include <vecmath/util.h>
 
 #include <memory>
@@ -319,7 +321,10 @@ namespace TrenchBroom {
 
         void MapView2D::doRenderGrid(Renderer::RenderContext&, Renderer::RenderBatch& renderBatch) {
             auto document = kdl::mem_lock(m_document);
-            renderBatch.addOneShot(new Renderer::GridRenderer(*m_camera, document->worldBounds()));
+            if (!m_gridRenderer || !m_gridRenderer->canRender(*m_camera, document->worldBounds())) {
+                m_gridRenderer = std::make_unique<Renderer::GridRenderer>(*m_camera, document->worldBounds());
+            }
+            renderBatch.add(m_gridRenderer.get());
         }
 
         void MapView2D::doRenderMap(Renderer::MapRenderer& renderer, Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch) {
@@ -327,7 +332,8 @@ namespace TrenchBroom {
 
             auto document = kdl::mem_lock(m_document);
             if (renderContext.showSelectionGuide() && document->hasSelectedNodes()) {
-                const vm::bbox3& bounds = document->selectionBounds();
+                const auto& previewTransformation = document->selectionPreviewTransformation();
+                const vm::bbox3 bounds = previewTransformation ? document->selectionBounds().transform(*previewTransformation) : document->selectionBounds();
                 Renderer::SelectionBoundsRenderer boundsRenderer(bounds);
                 boundsRenderer.render(renderContext, renderBatch);
             }
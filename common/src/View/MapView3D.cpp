@@ -70,6 +70,8 @@
 
 #include <kdl/set_temp.h>
 
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
 #include <vecmath/util.h>
 
 #include <memory>
@@ -173,6 +175,7 @@ namespace TrenchBroom {
         }
 
         void MapView3D::updateFlyMode() {
+            m_flyModeHelper->framePresented();
             if (m_flyModeHelper->anyKeyDown()) {
                 update();
             }
@@ -453,7 +456,8 @@ namespace TrenchBroom {
 
             auto document = kdl::mem_lock(m_document);
             if (renderContext.showSelectionGuide() && document->hasSelectedNodes()) {
-                const vm::bbox3& bounds = document->selectionBounds();
+                const auto& previewTransformation = document->selectionPreviewTransformation();
+                const vm::bbox3 bounds = previewTransformation ? document->selectionBounds().transform(*previewTransformation) : document->selectionBounds();
                 Renderer::SelectionBoundsRenderer boundsRenderer(bounds);
                 boundsRenderer.render(renderContext, renderBatch);
 
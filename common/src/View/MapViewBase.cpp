@@ -26,6 +26,7 @@
 #include "Assets/EntityDefinition.h"
 #include "Assets/EntityDefinitionGroup.h"
 #include "Assets/EntityDefinitionManager.h"
+#include "Assets/Texture.h"
 #include "Model/BezierPatch.h"
 #include "Model/BrushNode.h"
 #include "Model/BrushFace.h"
@@ -48,7 +49,7 @@
 #include "Renderer/FontDescriptor.h"
 #include "Renderer/FontManager.h"
 #include "Renderer/MapRenderer.h"
-#include "Renderer/PrimitiveRenderer.h"
+#include "Renderer/PortalFileRenderer.h"
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
 #include "Renderer/RenderService.h"
@@ -74,6 +75,7 @@
 #include <vecmath/polygon.h>
 #include <vecmath/util.h>
 
+#include <chrono>
 #include <sstream>
 #include <vector>
 
@@ -87,6 +89,7 @@
 namespace TrenchBroom {
     namespace View {
         const int MapViewBase::DefaultCameraAnimationDuration = 250;
+        const int MapViewBase::TextureUploadBudgetPerFrame = 8;
 
         MapViewBase::MapViewBase(Logger* logger, std::weak_ptr<MapDocument> document, MapViewToolBox& toolBox, Renderer::MapRenderer& renderer, GLContextManager& contextManager) :
         RenderView(contextManager),
@@ -132,13 +135,14 @@ namespace TrenchBroom {
             auto document = kdl::mem_lock(m_document);
             m_notifierConnection += document->nodesWereAddedNotifier.connect(this, &MapViewBase::nodesDidChange);
             m_notifierConnection += document->nodesWereRemovedNotifier.connect(this, &MapViewBase::nodesDidChange);
-            m_notifierConnection += document->nodesDidChangeNotifier.connect(this, &MapViewBase::nodesDidChange);
+            m_notifierConnection += document->coalescedNodesDidChangeNotifier.connect(this, &MapViewBase::nodesDidChange);
             m_notifierConnection += document->nodeVisibilityDidChangeNotifier.connect(this, &MapViewBase::nodesDidChange);
             m_notifierConnection += document->nodeLockingDidChangeNotifier.connect(this, &MapViewBase::nodesDidChange);
             m_notifierConnection += document->commandDoneNotifier.connect(this, &MapViewBase::commandDone);
             m_notifierConnection += document->commandUndoneNotifier.connect(this, &MapViewBase::commandUndone);
             m_notifierConnection += document->selectionDidChangeNotifier.connect(this, &MapViewBase::selectionDidChange);
             m_notifierConnection += document->textureCollectionsDidChangeNotifier.connect(this, &MapViewBase::textureCollectionsDidChange);
+            m_notifierConnection += document->textureCollectionsDidLoadNotifier.connect(this, &MapViewBase::textureCollectionsDidChange);
             m_notifierConnection += document->entityDefinitionsDidChangeNotifier.connect(this, &MapViewBase::entityDefinitionsDidChange);
             m_notifierConnection += document->modsDidChangeNotifier.connect(this, &MapViewBase::modsDidChange);
             m_notifierConnection += document->editorContextDidChangeNotifier.connect(this, &MapViewBase::editorContextDidChange);
@@ -170,6 +174,7 @@ namespace TrenchBroom {
         }
 
         void MapViewBase::nodesDidChange(const std::vector<Model::Node*>&) {
+            invalidateWorldPickResult();
             updatePickResult();
             update();
         }
@@ -181,18 +186,21 @@ namespace TrenchBroom {
         }
 
         void MapViewBase::commandDone(Command*) {
+            invalidateWorldPickResult();
             updateActionStatesDelayed();
             updatePickResult();
             update();
         }
 
         void MapViewBase::commandUndone(UndoableCommand*) {
+            invalidateWorldPickResult();
             updateActionStatesDelayed();
             updatePickResult();
             update();
         }
 
         void MapViewBase::selectionDidChange(const Selection&) {
+            invalidateWorldPickResult();
             updateActionStatesDelayed();
         }
 
@@ -201,16 +209,19 @@ namespace TrenchBroom {
         }
 
         void MapViewBase::entityDefinitionsDidChange() {
+            invalidateWorldPickResult();
             createActions();
             updateActionStates();
             update();
         }
 
         void MapViewBase::modsDidChange() {
+            invalidateWorldPickResult();
             update();
         }
 
         void MapViewBase::editorContextDidChange() {
+            invalidateWorldPickResult();
             update();
         }
 
@@ -232,11 +243,13 @@ namespace TrenchBroom {
                 fontManager().clearCache();
             }
 
+            invalidateWorldPickResult();
             updateActionBindings();
             update();
         }
 
         void MapViewBase::documentDidChange(MapDocument*) {
+            invalidateWorldPickResult();
             createActionsAndUpdatePicking();
             update();
         }
@@ -831,6 +844,9 @@ namespace TrenchBroom {
             renderContext.setSoftMapBounds(pref(Preferences::ShowSoftMapBounds)
                 ? vm::bbox3f(document->softMapBounds().bounds.value_or(vm::bbox3()))
                 : vm::bbox3f());
+            if (pref(Preferences::ShowFPS)) {
+                renderContext.setGpuTimer(&gpuTimer());
+            }
 
             setupGL(renderContext);
             setRenderOptions(renderContext);
@@ -849,7 +865,12 @@ namespace TrenchBroom {
             renderCompass(renderBatch);
             renderFPS(renderContext, renderBatch);
 
+            // limit the time spent uploading textures in this frame, and render again if any uploads were deferred
+            Assets::TextureUploadBudget::beginFrame(std::chrono::milliseconds{TextureUploadBudgetPerFrame});
             renderBatch.render(renderContext);
+            if (Assets::TextureUploadBudget::endFrame()) {
+                update();
+            }
         }
 
         void MapViewBase::setupGL(Renderer::RenderContext& context) {
@@ -900,7 +921,7 @@ namespace TrenchBroom {
                 validatePortalFileRenderer(renderContext);
                 assert(m_portalFileRenderer != nullptr);
             }
-            renderBatch.add(m_portalFileRenderer.get());
+            m_portalFileRenderer->render(renderContext, renderBatch, pref(Preferences::PortalFileViewDistance));
         }
 
         void MapViewBase::invalidatePortalFileRenderer() {
@@ -909,24 +930,12 @@ namespace TrenchBroom {
 
         void MapViewBase::validatePortalFileRenderer(Renderer::RenderContext&) {
             assert(m_portalFileRenderer == nullptr);
-            m_portalFileRenderer = std::make_unique<Renderer::PrimitiveRenderer>();
 
             auto document = kdl::mem_lock(m_document);
             Model::PortalFile* portalFile = document->portalFile();
-            if (portalFile != nullptr) {
-                for (const auto& poly : portalFile->portals()) {
-                    m_portalFileRenderer->renderFilledPolygon(pref(Preferences::PortalFileFillColor),
-                                                              Renderer::PrimitiveRendererOcclusionPolicy::Hide,
-                                                              Renderer::PrimitiveRendererCullingPolicy::ShowBackfaces,
-                                                              poly.vertices());
-
-                    const auto lineWidth = 4.0f;
-                    m_portalFileRenderer->renderPolygon(pref(Preferences::PortalFileBorderColor),
-                                                        lineWidth,
-                                                        Renderer::PrimitiveRendererOcclusionPolicy::Hide,
-                                                        poly.vertices());
-                }
-            }
+            m_portalFileRenderer = std::make_unique<Renderer::PortalFileRenderer>(portalFile != nullptr ? *portalFile : Model::PortalFile(),
+                                                                                  pref(Preferences::PortalFileFillColor),
+                                                                                  pref(Preferences::PortalFileBorderColor));
         }
 
         void MapViewBase::renderCompass(Renderer::RenderBatch& renderBatch) {
@@ -60,7 +60,7 @@ namespace TrenchBroom {
         class Camera;
         class Compass;
         class MapRenderer;
-        class PrimitiveRenderer;
+        class PortalFileRenderer;
         class RenderBatch;
         class RenderContext;
         enum class RenderMode;
@@ -81,6 +81,10 @@ namespace TrenchBroom {
             Q_OBJECT
         public:
             static const int DefaultCameraAnimationDuration;
+            /**
+             * The time in milliseconds that may be spent uploading textures while rendering a frame.
+             */
+            static const int TextureUploadBudgetPerFrame;
         protected:
             Logger* m_logger;
             std::weak_ptr<MapDocument> m_document;
@@ -91,7 +95,7 @@ namespace TrenchBroom {
         private:
             Renderer::MapRenderer& m_renderer;
             std::unique_ptr<Renderer::Compass> m_compass;
-            std::unique_ptr<Renderer::PrimitiveRenderer> m_portalFileRenderer;
+            std::unique_ptr<Renderer::PortalFileRenderer> m_portalFileRenderer;
 
             /**
              * Tracks whether this map view has most recently gotten the focus. This is tracked and updated by a
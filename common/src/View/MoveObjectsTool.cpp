@@ -20,6 +20,8 @@
 #include "MoveObjectsTool.h"
 
 #include "FloatType.h"
+#include "PreferenceManager.h"
+#include "Preferences.h"
 #include "Model/BrushNode.h"
 #include "View/Grid.h"
 #include "View/InputState.h"
@@ -29,6 +31,9 @@
 #include <kdl/memory_utils.h>
 
 #include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
 
 #include <cassert>
 
@@ -37,7 +42,9 @@ namespace TrenchBroom {
         MoveObjectsTool::MoveObjectsTool(std::weak_ptr<MapDocument> document) :
         Tool(true),
         m_document(document),
-        m_duplicateObjects(false) {}
+        m_duplicateObjects(false),
+        m_previewMove(false),
+        m_previewDelta(vm::vec3::zero()) {}
 
         const Grid& MoveObjectsTool::grid() const {
             return kdl::mem_lock(m_document)->grid();
@@ -52,6 +59,10 @@ namespace TrenchBroom {
 
             document->startTransaction(duplicateObjects(inputState) ? "Duplicate Objects" : "Move Objects");
             m_duplicateObjects = duplicateObjects(inputState);
+
+            // with texture lock, moving the objects doesn't change how their textures look, so the preview is exact
+            m_previewMove = pref(Preferences::TextureLock);
+            m_previewDelta = vm::vec3::zero();
             return true;
         }
 
@@ -59,7 +70,7 @@ namespace TrenchBroom {
             auto document = kdl::mem_lock(m_document);
             const auto& worldBounds = document->worldBounds();
             const auto bounds = document->selectionBounds();
-            if (!worldBounds.contains(bounds.translate(delta))) {
+            if (!worldBounds.contains(bounds.translate(m_previewDelta + delta))) {
                 return MR_Deny;
             }
 
@@ -68,6 +79,13 @@ namespace TrenchBroom {
                 document->duplicateObjects();
             }
 
+            if (m_previewMove) {
+                m_previewDelta = m_previewDelta + delta;
+                document->setSelectionPreviewTransformation(vm::translation_matrix(m_previewDelta));
+                refreshViews();
+                return MR_Continue;
+            }
+
             if (!document->translateObjects(delta)) {
                 return MR_Deny;
             } else {
@@ -77,14 +95,30 @@ namespace TrenchBroom {
 
         void MoveObjectsTool::endMove(const InputState&) {
             auto document = kdl::mem_lock(m_document);
+            if (m_previewMove) {
+                endPreview();
+                if (!vm::is_zero(m_previewDelta, vm::C::almost_zero())) {
+                    document->translateObjects(m_previewDelta);
+                }
+            }
             document->commitTransaction();
         }
 
         void MoveObjectsTool::cancelMove() {
             auto document = kdl::mem_lock(m_document);
+            if (m_previewMove) {
+                endPreview();
+            }
             document->cancelTransaction();
         }
 
+        void MoveObjectsTool::endPreview() {
+            auto document = kdl::mem_lock(m_document);
+            document->setSelectionPreviewTransformation(std::nullopt);
+            m_previewMove = false;
+            refreshViews();
+        }
+
         bool MoveObjectsTool::duplicateObjects(const InputState& inputState) const {
             return inputState.modifierKeysDown(ModifierKeys::MKCtrlCmd);
         }
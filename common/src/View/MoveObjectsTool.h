@@ -22,6 +22,8 @@
 #include "FloatType.h"
 #include "View/Tool.h"
 
+#include <vecmath/vec.h>
+
 #include <memory>
 
 namespace TrenchBroom {
@@ -40,6 +42,13 @@ namespace TrenchBroom {
         private:
             std::weak_ptr<MapDocument> m_document;
             bool m_duplicateObjects;
+
+            /**
+             * If set, the selection is not moved on every drag step. Instead, the accumulated delta is rendered as a
+             * preview transformation and applied once when the move ends.
+             */
+            bool m_previewMove;
+            vm::vec3 m_previewDelta;
         public:
             explicit MoveObjectsTool(std::weak_ptr<MapDocument> document);
         public:
@@ -51,6 +60,7 @@ namespace TrenchBroom {
             void cancelMove();
         private:
             bool duplicateObjects(const InputState& inputState) const;
+            void endPreview();
 
             QWidget* doCreatePage(QWidget* parent) override;
         };
@@ -22,6 +22,7 @@
 #include "TrenchBroomApp.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Assets/Texture.h"
 #include "Renderer/GLVertexType.h"
 #include "Renderer/PrimType.h"
 #include "Renderer/Transformation.h"
@@ -75,6 +76,7 @@
 #include <vecmath/mat.h>
 #include <vecmath/mat_ext.h>
 
+#include <algorithm>
 #include <iostream>
 
 namespace TrenchBroom {
@@ -84,6 +86,8 @@ namespace TrenchBroom {
         m_glContext(&contextManager),
         m_framesRendered(0),
         m_maxFrameTimeMsecs(0),
+        m_inputTimeNsecs(0),
+        m_renderTimeNsecs(0),
         m_lastFPSCounterUpdate(0) {
             QPalette pal;
             const QColor color = pal.color(QPalette::Highlight);
@@ -98,16 +102,31 @@ namespace TrenchBroom {
                 const int maxFrameTime = m_maxFrameTimeMsecs;
                 const int64_t fpsCounterPeriod = currentTime - m_lastFPSCounterUpdate;
                 const double avgFps = static_cast<double>(framesRenderedInPeriod) / (static_cast<double>(fpsCounterPeriod) / 1000.0);
+                const double frameCount = static_cast<double>(std::max(framesRenderedInPeriod, 1));
+                const double avgInputTime = static_cast<double>(m_inputTimeNsecs) / frameCount / 1000000.0;
+                const double avgRenderTime = static_cast<double>(m_renderTimeNsecs) / frameCount / 1000000.0;
 
                 m_framesRendered = 0;
                 m_maxFrameTimeMsecs = 0;
+                m_inputTimeNsecs = 0;
+                m_renderTimeNsecs = 0;
                 m_lastFPSCounterUpdate = currentTime;
 
                 m_currentFPS = std::string("Avg FPS: ") + std::to_string(avgFps) + " Max time between frames: " +
-                    std::to_string(maxFrameTime) + "ms. " +
+                    std::to_string(maxFrameTime) + "ms. Avg time per frame: " +
+                    std::to_string(avgInputTime) + "ms input, " +
+                    std::to_string(avgRenderTime) + "ms rendering. " +
                     std::to_string(m_glContext->vboManager().currentVboCount()) + " current VBOs (" +
                     std::to_string(m_glContext->vboManager().peakVboCount()) + " peak) totalling " +
-                    std::to_string(m_glContext->vboManager().currentVboSize() / 1024u) + " KiB";
+                    std::to_string(m_glContext->vboManager().currentVboSize() / 1024u) + " KiB, " +
+                    std::to_string(Assets::Texture::uploadedBytes() / 1024u) + " KiB textures";
+
+                if (!m_gpuTimer.sectionMilliseconds().empty()) {
+                    m_currentFPS += ". GPU time:";
+                    for (const auto& [section, milliseconds] : m_gpuTimer.sectionMilliseconds()) {
+                        m_currentFPS += " " + section + " " + std::to_string(milliseconds) + "ms";
+                    }
+                }
 
 
             });
@@ -121,11 +140,13 @@ namespace TrenchBroom {
         RenderView::~RenderView() = default;
 
         void RenderView::keyPressEvent(QKeyEvent* event) {
+            m_lastMouseMove = std::nullopt;
             m_eventRecorder.recordEvent(*event);
             update();
         }
 
         void RenderView::keyReleaseEvent(QKeyEvent* event) {
+            m_lastMouseMove = std::nullopt;
             m_eventRecorder.recordEvent(*event);
             update();
         }
@@ -139,26 +160,40 @@ namespace TrenchBroom {
         }
 
         void RenderView::mouseDoubleClickEvent(QMouseEvent* event) {
+            m_lastMouseMove = std::nullopt;
             m_eventRecorder.recordEvent(mouseEventWithFullPrecisionLocalPos(this, event));
             update();
         }
 
         void RenderView::mouseMoveEvent(QMouseEvent* event) {
-            m_eventRecorder.recordEvent(mouseEventWithFullPrecisionLocalPos(this, event));
+            const auto mouseEvent = mouseEventWithFullPrecisionLocalPos(this, event);
+            if (m_lastMouseMove
+                && m_lastMouseMove->localPos == mouseEvent.localPos()
+                && m_lastMouseMove->buttons == mouseEvent.buttons()
+                && m_lastMouseMove->modifiers == mouseEvent.modifiers()) {
+                // nothing changed, so neither the tools nor the rendered frame can change
+                return;
+            }
+            m_lastMouseMove = MouseMoveState{mouseEvent.localPos(), mouseEvent.buttons(), mouseEvent.modifiers()};
+
+            m_eventRecorder.recordEvent(mouseEvent);
             update();
         }
 
         void RenderView::mousePressEvent(QMouseEvent* event) {
+            m_lastMouseMove = std::nullopt;
             m_eventRecorder.recordEvent(mouseEventWithFullPrecisionLocalPos(this, event));
             update();
         }
 
         void RenderView::mouseReleaseEvent(QMouseEvent* event) {
+            m_lastMouseMove = std::nullopt;
             m_eventRecorder.recordEvent(mouseEventWithFullPrecisionLocalPos(this, event));
             update();
         }
 
         void RenderView::wheelEvent(QWheelEvent* event) {
+            m_lastMouseMove = std::nullopt;
             m_eventRecorder.recordEvent(*event);
             update();
         }
@@ -181,6 +216,10 @@ namespace TrenchBroom {
         }
 
 
+        Renderer::GpuTimer& RenderView::gpuTimer() {
+            return m_gpuTimer;
+        }
+
        Renderer::VboManager& RenderView::vboManager() {
             return m_glContext->vboManager();
         }
@@ -213,10 +252,18 @@ namespace TrenchBroom {
         }
 
         void RenderView::render() {
+            QElapsedTimer timer;
+            timer.start();
+
             processInput();
+            m_inputTimeNsecs += timer.nsecsElapsed();
+            timer.restart();
+
+            m_gpuTimer.beginFrame();
             clearBackground();
             doRender();
             renderFocusIndicator();
+            m_renderTimeNsecs += timer.nsecsElapsed();
         }
 
         void RenderView::processInput() {
@@ -21,12 +21,15 @@
 
 #include "Color.h"
 #include "Renderer/GL.h" // must be included here, before QOpenGLWidget, because it includes glew
+#include "Renderer/GpuTimer.h"
 #include "View/InputEvent.h"
 
+#include <optional>
 #include <string>
 
 #include <QOpenGLWidget>
 #include <QElapsedTimer>
+#include <QPointF>
 
 #undef Bool
 #undef Status
@@ -48,13 +51,27 @@ namespace TrenchBroom {
             Color m_focusColor;
             GLContextManager* m_glContext;
             InputEventRecorder m_eventRecorder;
+
+            /**
+             * The last mouse move event, used to skip moves that change neither the position, the buttons nor the
+             * modifiers. Reset by all other input events.
+             */
+            struct MouseMoveState {
+                QPointF localPos;
+                Qt::MouseButtons buttons;
+                Qt::KeyboardModifiers modifiers;
+            };
+            std::optional<MouseMoveState> m_lastMouseMove;
         private: // FPS counter
             // stats since the last counter update
             int m_framesRendered;
             int m_maxFrameTimeMsecs;
+            int64_t m_inputTimeNsecs;
+            int64_t m_renderTimeNsecs;
             // other
             int64_t m_lastFPSCounterUpdate;
             QElapsedTimer m_timeSinceLastFrame;
+            Renderer::GpuTimer m_gpuTimer;
         protected:
             std::string m_currentFPS;
         protected:
@@ -73,6 +90,7 @@ namespace TrenchBroom {
             Renderer::VboManager& vboManager();
             Renderer::FontManager& fontManager();
             Renderer::ShaderManager& shaderManager();
+            Renderer::GpuTimer& gpuTimer();
 
             int depthBits() const;
             bool multisample() const;
@@ -22,7 +22,6 @@
 #include "Assets/Texture.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushFaceHandle.h"
-#include "Model/ChangeBrushFaceAttributesRequest.h"
 #include "Model/ModelUtils.h"
 #include "Model/WorldNode.h"
 #include "View/BorderLine.h"
@@ -67,12 +66,8 @@ namespace TrenchBroom {
                 return;
             }
 
-            Model::ChangeBrushFaceAttributesRequest request;
-            request.setTextureName(replacement->name());
-            
             Transaction transaction(document, "Replace Textures");
-            document->select(faces);
-            document->setFaceAttributes(request);
+            document->setFaceTextureName(faces, replacement->name());
 
             std::stringstream msg;
             msg << "Replaced texture '" << subject->name() << "' with '" << replacement->name() << "' on " << faces.size() << " faces.";
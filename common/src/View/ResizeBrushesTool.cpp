@@ -32,6 +32,7 @@
 #include "Model/Hit.h"
 #include "Model/HitAdapter.h"
 #include "Model/HitFilter.h"
+#include "Model/NodeContents.h"
 #include "Model/PickResult.h"
 #include "Model/Polyhedron.h"
 #include "Renderer/Camera.h"
@@ -55,6 +56,8 @@
 
 #include <limits>
 #include <map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
@@ -351,16 +354,8 @@ namespace TrenchBroom {
                 if (splitBrushesOutward(faceDelta) || splitBrushesInward(faceDelta)) {
                     return true;
                 }
-            } else {
-                document->rollbackTransaction();
-                if (document->resizeBrushes(polygonsAtDragStart(), faceDelta)) {
-                    m_totalDelta = faceDelta;
-                } else {
-                    // resizeBrushes() fails if some brushes were completely clipped away.
-                    // In that case, restore the last m_totalDelta to be successfully applied.
-                    document->resizeBrushes(polygonsAtDragStart(), m_totalDelta);
-                }
-
+            } else if (resizeBrushesAtDragStart(faceDelta)) {
+                m_totalDelta = faceDelta;
                 updateCurrentDragVisualHandles();
             }
 
@@ -607,6 +602,50 @@ namespace TrenchBroom {
             return true;
         }
 
+        /**
+         * Resizes the brushes of the drag handles by moving their faces at the start of the drag by the given delta.
+         *
+         * Since the brushes are computed from their state at the start of the drag, the transaction doesn't have to be
+         * rolled back first, and the swap commands of consecutive calls are collated into one. If any brush cannot be
+         * resized, e.g. because it would be completely clipped away, the document remains unchanged and false is
+         * returned.
+         */
+        bool ResizeBrushesTool::resizeBrushesAtDragStart(const vm::vec3& delta) {
+            auto document = kdl::mem_lock(m_document);
+            const auto& worldBounds = document->worldBounds();
+            const auto lockTextures = pref(Preferences::TextureLock);
+
+            auto nodesToSwap = std::vector<std::pair<Model::Node*, Model::NodeContents>>{};
+            nodesToSwap.reserve(m_dragHandlesAtDragStart.size());
+
+            // like MapDocument::resizeBrushes, move only one face of each brush
+            auto visitedNodes = std::unordered_set<Model::BrushNode*>{};
+            for (const auto& dragHandle : m_dragHandlesAtDragStart) {
+                if (!visitedNodes.insert(dragHandle.node).second) {
+                    continue;
+                }
+
+                auto brush = dragHandle.brushAtDragStart;
+                const auto success = brush.moveBoundary(worldBounds, dragHandle.faceIndex, delta, lockTextures)
+                    .visit(kdl::overload(
+                        [&]() {
+                            return worldBounds.contains(brush.bounds());
+                        },
+                        [&](const Model::BrushError e) {
+                            document->error() << "Could not resize brush: " << e;
+                            return false;
+                        }
+                    ));
+                if (!success) {
+                    return false;
+                }
+
+                nodesToSwap.emplace_back(dragHandle.node, Model::NodeContents(std::move(brush)));
+            }
+
+            return document->swapNodeContents("Resize Brushes", std::move(nodesToSwap));
+        }
+
         std::vector<vm::polygon3> ResizeBrushesTool::polygonsAtDragStart() const {
             return kdl::vec_transform(m_dragHandlesAtDragStart, [](const auto& handle) {
                 return handle.brushAtDragStart.face(handle.faceIndex).polygon();
@@ -146,6 +146,7 @@ namespace TrenchBroom {
         private:
             bool splitBrushesOutward(const vm::vec3& delta);
             bool splitBrushesInward(const vm::vec3& delta);
+            bool resizeBrushesAtDragStart(const vm::vec3& delta);
             std::vector<vm::polygon3> polygonsAtDragStart() const;
             void updateCurrentDragVisualHandles();
         private:
@@ -25,6 +25,16 @@
 
 namespace TrenchBroom {
     namespace View {
+        template <typename T>
+        static void append(std::vector<T>& vec, std::vector<T> values) {
+            // the vectors are usually empty, in which case we can adopt the given vector without copying it
+            if (vec.empty()) {
+                vec = std::move(values);
+            } else {
+                vec = kdl::vec_concat(std::move(vec), std::move(values));
+            }
+        }
+
         const std::vector<Model::Node*>& Selection::selectedNodes() const {
             return m_selectedNodes;
         }
@@ -41,20 +51,20 @@ namespace TrenchBroom {
             return m_deselectedBrushFaces;
         }
 
-        void Selection::addSelectedNodes(const std::vector<Model::Node*>& nodes) {
-            m_selectedNodes = kdl::vec_concat(std::move(m_selectedNodes), nodes);
+        void Selection::addSelectedNodes(std::vector<Model::Node*> nodes) {
+            append(m_selectedNodes, std::move(nodes));
         }
 
-        void Selection::addDeselectedNodes(const std::vector<Model::Node*>& nodes) {
-            m_deselectedNodes = kdl::vec_concat(std::move(m_deselectedNodes), nodes);
+        void Selection::addDeselectedNodes(std::vector<Model::Node*> nodes) {
+            append(m_deselectedNodes, std::move(nodes));
         }
 
-        void Selection::addSelectedBrushFaces(const std::vector<Model::BrushFaceHandle>& faces) {
-            m_selectedBrushFaces = kdl::vec_concat(std::move(m_selectedBrushFaces), faces);
+        void Selection::addSelectedBrushFaces(std::vector<Model::BrushFaceHandle> faces) {
+            append(m_selectedBrushFaces, std::move(faces));
         }
 
-        void Selection::addDeselectedBrushFaces(const std::vector<Model::BrushFaceHandle>& faces) {
-            m_deselectedBrushFaces = kdl::vec_concat(std::move(m_deselectedBrushFaces), faces);
+        void Selection::addDeselectedBrushFaces(std::vector<Model::BrushFaceHandle> faces) {
+            append(m_deselectedBrushFaces, std::move(faces));
         }
     }
 }
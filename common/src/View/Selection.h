@@ -41,10 +41,10 @@ namespace TrenchBroom {
             const std::vector<Model::BrushFaceHandle>& selectedBrushFaces() const;
             const std::vector<Model::BrushFaceHandle>& deselectedBrushFaces() const;
 
-            void addSelectedNodes(const std::vector<Model::Node*>& nodes);
-            void addDeselectedNodes(const std::vector<Model::Node*>& nodes);
-            void addSelectedBrushFaces(const std::vector<Model::BrushFaceHandle>& faces);
-            void addDeselectedBrushFaces(const std::vector<Model::BrushFaceHandle>& faces);
+            void addSelectedNodes(std::vector<Model::Node*> nodes);
+            void addDeselectedNodes(std::vector<Model::Node*> nodes);
+            void addSelectedBrushFaces(std::vector<Model::BrushFaceHandle> faces);
+            void addDeselectedBrushFaces(std::vector<Model::BrushFaceHandle> faces);
         };
     }
 }
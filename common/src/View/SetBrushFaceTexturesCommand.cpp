@@ -0,0 +1,63 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "SetBrushFaceTexturesCommand.h"
+
+#include "View/MapDocumentCommandFacade.h"
+
+#include <algorithm>
+
+namespace TrenchBroom {
+    namespace View {
+        const Command::CommandType SetBrushFaceTexturesCommand::Type = Command::freeType();
+
+        SetBrushFaceTexturesCommand::SetBrushFaceTexturesCommand(const std::string& name, std::vector<std::pair<Model::BrushFaceHandle, std::string>> faces) :
+        UndoableCommand(Type, name, true),
+        m_faces(std::move(faces)) {}
+
+        SetBrushFaceTexturesCommand::~SetBrushFaceTexturesCommand() = default;
+
+        std::unique_ptr<CommandResult> SetBrushFaceTexturesCommand::doPerformDo(MapDocumentCommandFacade* document) {
+            document->performSwapBrushFaceTextureNames(m_faces);
+            return std::make_unique<CommandResult>(true);
+        }
+
+        std::unique_ptr<CommandResult> SetBrushFaceTexturesCommand::doPerformUndo(MapDocumentCommandFacade* document) {
+            document->performSwapBrushFaceTextureNames(m_faces);
+            return std::make_unique<CommandResult>(true);
+        }
+
+        bool SetBrushFaceTexturesCommand::doCollateWith(UndoableCommand* command) {
+            // this command already holds the texture names to restore if both commands changed the same faces
+            const auto* other = static_cast<SetBrushFaceTexturesCommand*>(command);
+            return std::equal(std::begin(m_faces), std::end(m_faces), std::begin(other->m_faces), std::end(other->m_faces), [](const auto& lhs, const auto& rhs) {
+                return lhs.first == rhs.first;
+            });
+        }
+
+        size_t SetBrushFaceTexturesCommand::doGetMemoryUsage() const {
+            auto result = sizeof(SetBrushFaceTexturesCommand) + m_name.capacity();
+            for (const auto& [faceHandle, textureName] : m_faces) {
+                result += sizeof(faceHandle) + textureName.capacity();
+            }
+            return result;
+        }
+    }
+}
@@ -84,7 +84,7 @@ namespace TrenchBroom {
         void SmartPropertyEditorManager::connectObservers() {
             auto document = kdl::mem_lock(m_document);
             m_notifierConnection += document->selectionDidChangeNotifier.connect(this, &SmartPropertyEditorManager::selectionDidChange);
-            m_notifierConnection += document->nodesDidChangeNotifier.connect(this, &SmartPropertyEditorManager::nodesDidChange);
+            m_notifierConnection += document->coalescedNodesDidChangeNotifier.connect(this, &SmartPropertyEditorManager::nodesDidChange);
         }
 
         void SmartPropertyEditorManager::selectionDidChange(const Selection&) {
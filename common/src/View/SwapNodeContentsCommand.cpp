@@ -35,7 +35,7 @@ namespace TrenchBroom {
         SwapNodeContentsCommand::SwapNodeContentsCommand(const std::string& name, std::vector<std::pair<Model::Node*, Model::NodeContents>> nodes, std::vector<std::pair<const Model::GroupNode*, std::vector<Model::GroupNode*>>> linkedGroupsToUpdate) :
         UndoableCommand(Type, name, true),
         m_nodes(std::move(nodes)),
-        m_updateLinkedGroupsHelper(std::move(linkedGroupsToUpdate)) {}
+        m_updateLinkedGroupsHelper(std::move(linkedGroupsToUpdate), kdl::vec_transform(m_nodes, [](const auto& pair) -> const Model::Node* { return pair.first; })) {}
 
         SwapNodeContentsCommand::~SwapNodeContentsCommand() = default;
 
@@ -73,5 +73,13 @@ namespace TrenchBroom {
 
             return false;
         }
+
+        size_t SwapNodeContentsCommand::doGetMemoryUsage() const {
+            auto result = sizeof(SwapNodeContentsCommand) + m_name.capacity();
+            for (const auto& [node, contents] : m_nodes) {
+                result += sizeof(node) + contents.memoryUsage();
+            }
+            return result;
+        }
     }
 }
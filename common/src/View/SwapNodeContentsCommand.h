@@ -53,6 +53,8 @@ namespace TrenchBroom {
 
             bool doCollateWith(UndoableCommand* command) override;
 
+            size_t doGetMemoryUsage() const override;
+
             deleteCopyAndMove(SwapNodeContentsCommand)
         };
     }
@@ -172,9 +172,10 @@ namespace TrenchBroom {
             m_notifierConnection += document->documentWasLoadedNotifier.connect(this, &TextureBrowser::documentWasLoaded);
             m_notifierConnection += document->nodesWereAddedNotifier.connect(this, &TextureBrowser::nodesWereAdded);
             m_notifierConnection += document->nodesWereRemovedNotifier.connect(this, &TextureBrowser::nodesWereRemoved);
-            m_notifierConnection += document->nodesDidChangeNotifier.connect(this, &TextureBrowser::nodesDidChange);
+            m_notifierConnection += document->coalescedNodesDidChangeNotifier.connect(this, &TextureBrowser::nodesDidChange);
             m_notifierConnection += document->brushFacesDidChangeNotifier.connect(this, &TextureBrowser::brushFacesDidChange);
             m_notifierConnection += document->textureCollectionsDidChangeNotifier.connect(this, &TextureBrowser::textureCollectionsDidChange);
+            m_notifierConnection += document->textureCollectionsDidLoadNotifier.connect(this, &TextureBrowser::textureCollectionsDidChange);
             m_notifierConnection += document->currentTextureNameDidChangeNotifier.connect(this, &TextureBrowser::currentTextureNameDidChange);
 
             PreferenceManager& prefs = PreferenceManager::instance();
@@ -44,6 +44,7 @@
 #include <vecmath/mat.h>
 #include <vecmath/mat_ext.h>
 
+#include <cmath>
 #include <string>
 #include <vector>
 
@@ -66,10 +67,16 @@ namespace TrenchBroom {
         m_selectedTexture(nullptr) {
             auto doc = kdl::mem_lock(m_document);
             m_notifierConnection += doc->textureUsageCountsDidChangeNotifier.connect(this, &TextureBrowserView::usageCountDidChange);
+            m_notifierConnection += doc->textureCollectionsDidChangeNotifier.connect(this, &TextureBrowserView::textureCollectionsDidChange);
+            m_notifierConnection += doc->textureCollectionsDidLoadNotifier.connect(this, &TextureBrowserView::textureCollectionsDidChange);
         }
 
         TextureBrowserView::~TextureBrowserView() {
             clear();
+
+            // deleting the thumbnails requires the OpenGL context to be current
+            makeCurrent();
+            m_thumbnails.clear();
         }
 
         void TextureBrowserView::setSortOrder(const TextureSortOrder sortOrder) {
@@ -77,6 +84,7 @@ namespace TrenchBroom {
                 return;
             }
             m_sortOrder = sortOrder;
+            m_sortedTextures.clear();
             invalidate();
             update();
         }
@@ -128,10 +136,20 @@ namespace TrenchBroom {
         }
 
         void TextureBrowserView::usageCountDidChange() {
+            if (m_sortOrder == TextureSortOrder::Usage) {
+                m_sortedTextures.clear();
+            }
             invalidate();
             update();
         }
 
+        void TextureBrowserView::textureCollectionsDidChange() {
+            // the thumbnails and sorted textures refer to the textures by address, which may be reused by the new
+            // textures
+            m_thumbnails.invalidate();
+            m_sortedTextures.clear();
+        }
+
         void TextureBrowserView::doInitLayout(Layout& layout) {
             const float scaleFactor = pref(Preferences::TextureBrowserIconSize);
 
@@ -151,25 +169,28 @@ namespace TrenchBroom {
 
             const Renderer::FontDescriptor font(fontPath, static_cast<size_t>(fontSize));
 
+            // the group font only depends on the group name, so it is selected once per group and not for every texture
+            const float maxCellWidth = layout.maxCellWidth();
             if (m_group) {
                 for (const Assets::TextureCollection& collection : getCollections()) {
                     layout.addGroup(collection.name(), static_cast<float>(fontSize) + 2.0f);
+                    const auto groupFont = fontManager().selectFontSize(font, collection.name(), maxCellWidth, 6);
                     for (const Assets::Texture* texture : getTextures(collection))
-                        addTextureToLayout(layout, texture, collection.name(), font);
+                        addTextureToLayout(layout, texture, collection.name(), font, groupFont);
                 }
             } else {
+                const auto groupFont = fontManager().selectFontSize(font, "", maxCellWidth, 6);
                 for (const Assets::Texture* texture : getTextures())
-                    addTextureToLayout(layout, texture, "", font);
+                    addTextureToLayout(layout, texture, "", font, groupFont);
             }
         }
 
-        void TextureBrowserView::addTextureToLayout(Layout& layout, const Assets::Texture* texture, const std::string& groupName, const Renderer::FontDescriptor& font) {
+        void TextureBrowserView::addTextureToLayout(Layout& layout, const Assets::Texture* texture, const std::string& groupName, const Renderer::FontDescriptor& font, const Renderer::FontDescriptor& groupFont) {
             const float maxCellWidth = layout.maxCellWidth();
 
             const auto  textureName = IO::Path(texture->name()).lastComponent().asString();
 
             const auto textureFont = fontManager().selectFontSize(font, textureName, maxCellWidth, 6);
-            const auto groupFont   = fontManager().selectFontSize(font, groupName, maxCellWidth, 6);
 
             const auto defaultTextHeight = fontManager().font(font).measure(groupName + textureName).y();
             const auto textureNameSize   = fontManager().font(textureFont).measure(textureName);
@@ -244,20 +265,32 @@ namespace TrenchBroom {
         }
 
         std::vector<const Assets::Texture*> TextureBrowserView::getTextures(const Assets::TextureCollection& collection) const {
-            auto textures = kdl::vec_transform(collection.textures(), [](const auto& t) { return &t; });
+            auto textures = getSortedTextures(&collection, kdl::vec_transform(collection.textures(), [](const auto& t) { return &t; }));
             filterTextures(textures);
-            sortTextures(textures);
             return textures;
         }
 
         std::vector<const Assets::Texture*> TextureBrowserView::getTextures() const {
             auto doc = kdl::mem_lock(m_document);
-            auto textures = doc->textureManager().textures();
+            auto textures = getSortedTextures(nullptr, doc->textureManager().textures());
             filterTextures(textures);
-            sortTextures(textures);
             return textures;
         }
 
+        /**
+         * Returns the given textures in the current sort order. The result is cached, and the cache entry is reused
+         * as long as the given textures are the same, which is cheap to check compared to sorting them.
+         */
+        std::vector<const Assets::Texture*> TextureBrowserView::getSortedTextures(const Assets::TextureCollection* collection, std::vector<const Assets::Texture*> textures) const {
+            auto& cached = m_sortedTextures[collection];
+            if (cached.textures != textures) {
+                cached.sortedTextures = textures;
+                sortTextures(cached.sortedTextures);
+                cached.textures = std::move(textures);
+            }
+            return cached.sortedTextures;
+        }
+
         void TextureBrowserView::filterTextures(std::vector<const Assets::Texture*>& textures) const {
             if (m_hideUnused)
                 textures = kdl::vec_erase_if(std::move(textures), MatchUsageCount());
@@ -311,10 +344,12 @@ namespace TrenchBroom {
             using BoundsVertex = Renderer::GLVertexTypes::P2C4::Vertex;
             std::vector<BoundsVertex> vertices;
 
-            for (size_t i = 0; i < layout.size(); ++i) {
+            const auto [firstGroup, lastGroup] = layout.visibleGroups(y, height);
+            for (size_t i = firstGroup; i < lastGroup; ++i) {
                 const Group& group = layout[i];
                 if (group.intersectsY(y, height)) {
-                    for (size_t j = 0; j < group.size(); ++j) {
+                    const auto [firstRow, lastRow] = group.visibleRows(y, height);
+                    for (size_t j = firstRow; j < lastRow; ++j) {
                         const Row& row = group[j];
                         if (row.intersectsY(y, height)) {
                             for (size_t k = 0; k < row.size(); ++k) {
@@ -357,10 +392,12 @@ namespace TrenchBroom {
 
             size_t num = 0;
 
-            for (size_t i = 0; i < layout.size(); ++i) {
+            const auto [firstGroup, lastGroup] = layout.visibleGroups(y, height);
+            for (size_t i = firstGroup; i < lastGroup; ++i) {
                 const Group& group = layout[i];
                 if (group.intersectsY(y, height)) {
-                    for (size_t j = 0; j < group.size(); ++j) {
+                    const auto [firstRow, lastRow] = group.visibleRows(y, height);
+                    for (size_t j = firstRow; j < lastRow; ++j) {
                         const Row& row = group[j];
                         if (row.intersectsY(y, height)) {
                             for (size_t k = 0; k < row.size(); ++k) {
@@ -376,12 +413,25 @@ namespace TrenchBroom {
                                 }));
 
                                 shader.set("GrayScale", texture->overridden());
-                                texture->activate();
+
+                                // the cell bounds are in points, but the thumbnail size must be given in pixels
+                                const auto thumbnailSize = vm::vec2s(
+                                    static_cast<size_t>(std::ceil(static_cast<double>(bounds.width()) * devicePixelRatioF())),
+                                    static_cast<size_t>(std::ceil(static_cast<double>(bounds.height()) * devicePixelRatioF())));
+
+                                const bool useThumbnail = m_thumbnails.activate(*texture, thumbnailSize);
+                                if (!useThumbnail) {
+                                    texture->activate();
+                                }
 
                                 vertexArray.prepare(vboManager());
                                 vertexArray.render(Renderer::PrimType::Quads);
 
-                                texture->deactivate();
+                                if (useThumbnail) {
+                                    m_thumbnails.deactivate();
+                                } else {
+                                    texture->deactivate();
+                                }
 
                                 ++num;
                             }
@@ -400,7 +450,8 @@ namespace TrenchBroom {
             using Vertex = Renderer::GLVertexTypes::P2::Vertex;
             std::vector<Vertex> vertices;
 
-            for (size_t i = 0; i < layout.size(); ++i) {
+            const auto [firstGroup, lastGroup] = layout.visibleGroups(y, height);
+            for (size_t i = firstGroup; i < lastGroup; ++i) {
                 const Group& group = layout[i];
                 if (group.intersectsY(y, height)) {
                     const LayoutBounds titleBounds = layout.titleBoundsForVisibleRect(group, y, height);
@@ -448,7 +499,8 @@ namespace TrenchBroom {
             const std::vector<Color> subTextColor{ pref(Preferences::BrowserSubTextColor) };
 
             StringMap stringVertices;
-            for (size_t i = 0; i < layout.size(); ++i) {
+            const auto [firstGroup, lastGroup] = layout.visibleGroups(y, height);
+            for (size_t i = firstGroup; i < lastGroup; ++i) {
                 const auto& group = layout[i];
                 if (group.intersectsY(y, height)) {
                     const auto& title = group.item();
@@ -467,7 +519,8 @@ namespace TrenchBroom {
                         vertices.insert(std::end(vertices), std::begin(titleVertices), std::end(titleVertices));
                     }
 
-                    for (size_t j = 0; j < group.size(); ++j) {
+                    const auto [firstRow, lastRow] = group.visibleRows(y, height);
+                    for (size_t j = firstRow; j < lastRow; ++j) {
                         const auto& row = group[j];
                         if (row.intersectsY(y, height)) {
                             for (unsigned int k = 0; k < row.size(); k++) {
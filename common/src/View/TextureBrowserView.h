@@ -22,11 +22,13 @@
 #include "NotifierConnection.h"
 #include "Renderer/FontDescriptor.h"
 #include "Renderer/GLVertexType.h"
+#include "Renderer/TextureThumbnailCache.h"
 #include "View/CellView.h"
 
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class QScrollBar;
@@ -70,6 +72,19 @@ namespace TrenchBroom {
             std::string m_filterText;
 
             const Assets::Texture* m_selectedTexture;
+            Renderer::TextureThumbnailCache m_thumbnails;
+
+            struct SortedTextures {
+                std::vector<const Assets::Texture*> textures;
+                std::vector<const Assets::Texture*> sortedTextures;
+            };
+
+            /**
+             * The sorted textures of each collection, and of all textures under the null key. Filtering preserves the
+             * order, so the textures only need to be sorted again if they or the sort order change, and not whenever
+             * the filter text changes.
+             */
+            mutable std::unordered_map<const Assets::TextureCollection*, SortedTextures> m_sortedTextures;
 
             NotifierConnection m_notifierConnection;
         public:
@@ -89,10 +104,11 @@ namespace TrenchBroom {
             void revealTexture(const Assets::Texture* texture);
         private:
             void usageCountDidChange();
+            void textureCollectionsDidChange();
 
             void doInitLayout(Layout& layout) override;
             void doReloadLayout(Layout& layout) override;
-            void addTextureToLayout(Layout& layout, const Assets::Texture* texture, const std::string& groupName, const Renderer::FontDescriptor& font);
+            void addTextureToLayout(Layout& layout, const Assets::Texture* texture, const std::string& groupName, const Renderer::FontDescriptor& font, const Renderer::FontDescriptor& groupFont);
 
             struct CompareByUsageCount;
             struct CompareByName;
@@ -103,6 +119,8 @@ namespace TrenchBroom {
             std::vector<const Assets::Texture*> getTextures(const Assets::TextureCollection& collection) const;
             std::vector<const Assets::Texture*> getTextures() const;
 
+            std::vector<const Assets::Texture*> getSortedTextures(const Assets::TextureCollection* collection, std::vector<const Assets::Texture*> textures) const;
+
             void filterTextures(std::vector<const Assets::Texture*>& textures) const;
             void sortTextures(std::vector<const Assets::Texture*>& textures) const;
 
@@ -55,11 +55,23 @@ namespace TrenchBroom {
             ensure(m_toolBox != nullptr, "toolBox is null");
 
             m_inputState.setPickRequest(doGetPickRequest(m_inputState.mouseX(),  m_inputState.mouseY()));
-            Model::PickResult pickResult = doPick(m_inputState.pickRay());
+            Model::PickResult pickResult = pickWorld(m_inputState.pickRay());
             m_toolBox->pick(m_toolChain, m_inputState, pickResult);
             m_inputState.setPickResult(std::move(pickResult));
         }
 
+        void ToolBoxConnector::invalidateWorldPickResult() {
+            m_worldPickResult = std::nullopt;
+        }
+
+        const Model::PickResult& ToolBoxConnector::pickWorld(const vm::ray3& pickRay) {
+            if (!m_worldPickResult || pickRay.origin != m_worldPickRay.origin || pickRay.direction != m_worldPickRay.direction) {
+                m_worldPickResult = doPick(pickRay);
+                m_worldPickRay = pickRay;
+            }
+            return *m_worldPickResult;
+        }
+
         void ToolBoxConnector::setToolBox(ToolBox& toolBox) {
             assert(m_toolBox == nullptr);
             m_toolBox = &toolBox;
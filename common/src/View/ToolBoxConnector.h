@@ -24,6 +24,7 @@
 #include "View/InputState.h"
 
 #include <memory>
+#include <optional>
 #include <string>
 
 namespace TrenchBroom {
@@ -53,6 +54,14 @@ namespace TrenchBroom {
             float m_lastMouseX;
             float m_lastMouseY;
             bool m_ignoreNextDrag;
+
+            /**
+             * The result of picking the world for the last pick ray, without any hits added by the tools. Every
+             * input event updates the pick result, so as long as the ray and the document don't change, the world
+             * is not traversed again. The tools still pick their own handles every time.
+             */
+            std::optional<Model::PickResult> m_worldPickResult;
+            vm::ray3 m_worldPickRay;
         public:
             ToolBoxConnector();
             ~ToolBoxConnector() override;
@@ -63,6 +72,12 @@ namespace TrenchBroom {
 
             void updatePickResult();
         protected:
+            /**
+             * Discards the cached world pick result. Must be called whenever the document changes in a way that
+             * might affect picking.
+             */
+            void invalidateWorldPickResult();
+
             void setToolBox(ToolBox& toolBox);
             void addTool(std::unique_ptr<ToolController> tool);
         public: // drag and drop
@@ -102,6 +117,8 @@ namespace TrenchBroom {
             void mouseMoved(float x, float y);
         public:
             bool cancelDrag();
+        private:
+            const Model::PickResult& pickWorld(const vm::ray3& pickRay);
         private:
             virtual PickRequest doGetPickRequest(float x, float y) const = 0;
             virtual Model::PickResult doPick(const vm::ray3& pickRay) const = 0;
@@ -86,7 +86,7 @@ namespace TrenchBroom {
         void UVView::connectObservers() {
             auto document = kdl::mem_lock(m_document);
             m_notifierConnection += document->documentWasClearedNotifier.connect(this, &UVView::documentWasCleared);
-            m_notifierConnection += document->nodesDidChangeNotifier.connect(this, &UVView::nodesDidChange);
+            m_notifierConnection += document->coalescedNodesDidChangeNotifier.connect(this, &UVView::nodesDidChange);
             m_notifierConnection += document->brushFacesDidChangeNotifier.connect(this, &UVView::brushFacesDidChange);
             m_notifierConnection += document->selectionDidChangeNotifier.connect(this, &UVView::selectionDidChange);
             m_notifierConnection += document->grid().gridDidChangeNotifier.connect(this, &UVView::gridDidChange);
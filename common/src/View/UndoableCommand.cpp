@@ -64,5 +64,13 @@ namespace TrenchBroom {
             }
             return false;
         }
+
+        size_t UndoableCommand::memoryUsage() const {
+            return doGetMemoryUsage();
+        }
+
+        size_t UndoableCommand::doGetMemoryUsage() const {
+            return sizeof(UndoableCommand) + m_name.capacity();
+        }
     }
 }
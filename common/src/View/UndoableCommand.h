@@ -22,6 +22,7 @@
 #include "Macros.h"
 #include "View/Command.h"
 
+#include <cstddef>
 #include <memory>
 #include <string>
 
@@ -41,11 +42,19 @@ namespace TrenchBroom {
             virtual std::unique_ptr<CommandResult> performUndo(MapDocumentCommandFacade* document);
 
             virtual bool collateWith(UndoableCommand* command);
+
+            /**
+             * Returns an estimate of the number of bytes used by this command, including the data it keeps for undo
+             * and redo. Data that is shared with the document is only partially accounted for.
+             */
+            size_t memoryUsage() const;
         private:
             virtual std::unique_ptr<CommandResult> doPerformUndo(MapDocumentCommandFacade* document) = 0;
 
             virtual bool doCollateWith(UndoableCommand* command) = 0;
 
+            virtual size_t doGetMemoryUsage() const;
+
             deleteCopyAndMove(UndoableCommand)
         };
     }
@@ -23,6 +23,7 @@
 #include "Model/GroupNode.h"
 #include "Model/ModelUtils.h"
 #include "Model/Node.h"
+#include "Model/NodeContents.h"
 #include "Model/UpdateLinkedGroupsError.h"
 #include "View/MapDocumentCommandFacade.h"
 
@@ -31,6 +32,7 @@
 #include <kdl/result_for_each.h>
 #include <kdl/vector_utils.h>
 
+#include <algorithm>
 #include <cassert>
 #include <map>
 #include <unordered_set>
@@ -58,20 +60,24 @@ namespace TrenchBroom {
             return rhs.first->isAncestorOf(lhs.first);
         };
 
-        UpdateLinkedGroupsHelper::UpdateLinkedGroupsHelper(LinkedGroupsToUpdate linkedGroupsToUpdate) :
-        m_state{kdl::vec_sort(std::move(linkedGroupsToUpdate), compareByAncestry)} {}
+        UpdateLinkedGroupsHelper::UpdateLinkedGroupsHelper(LinkedGroupsToUpdate linkedGroupsToUpdate, std::vector<const Model::Node*> changedNodes) :
+        m_state{kdl::vec_sort(std::move(linkedGroupsToUpdate), compareByAncestry)},
+        m_changedNodes{std::move(changedNodes)} {}
 
         UpdateLinkedGroupsHelper::~UpdateLinkedGroupsHelper() = default;
 
         kdl::result<void, Model::UpdateLinkedGroupsError> UpdateLinkedGroupsHelper::applyLinkedGroupUpdates(MapDocumentCommandFacade& document) {
             return computeLinkedGroupUpdates(document)
                 .and_then([&]() {
+                    // the replaced children may contain nodes whose contents are swapped, see collateWith
+                    doSwapLinkedGroupContents(document);
                     doApplyOrUndoLinkedGroupUpdates(document);
                 });
         }
 
         void UpdateLinkedGroupsHelper::undoLinkedGroupUpdates(MapDocumentCommandFacade& document) {
             doApplyOrUndoLinkedGroupUpdates(document);
+            doSwapLinkedGroupContents(document);
         }
 
         void UpdateLinkedGroupsHelper::collateWith(UpdateLinkedGroupsHelper& other) {
@@ -91,6 +97,25 @@ namespace TrenchBroom {
             auto& myLinkedGroupUpdates = std::get<LinkedGroupUpdates>(m_state);
             auto& theirLinkedGroupUpdates = std::get<LinkedGroupUpdates>(other.m_state);
 
+            // Let c_o be a content update from the other helper. If this helper has a content update for the same
+            // node, then we keep the old contents stored in this helper. If the node was created when this helper
+            // replaced the children of a linked group node, then undoing this helper restores the original children
+            // anyway, and redoing it restores the replacement nodes including the changes made by the other helper, so
+            // we discard c_o. Otherwise, we add c_o to our content updates.
+            //
+            // Conversely, if the other helper replaced a linked group node that contains nodes whose contents were
+            // swapped by this helper, the replaced nodes are stored with the changes of this helper. This is why the
+            // contents are always swapped after replacing children when undoing, and before when redoing.
+            for (auto& theirContentUpdate : other.m_contentUpdates) {
+                Model::Node* theirNodeToUpdate = theirContentUpdate.first;
+
+                const auto replacedByMe = std::any_of(std::begin(myLinkedGroupUpdates), std::end(myLinkedGroupUpdates), [&](const auto& p) { return p.first->isAncestorOf(theirNodeToUpdate); });
+                const auto updatedByMe = std::any_of(std::begin(m_contentUpdates), std::end(m_contentUpdates), [&](const auto& p) { return p.first == theirNodeToUpdate; });
+                if (!replacedByMe && !updatedByMe) {
+                    m_contentUpdates.emplace_back(theirNodeToUpdate, std::move(theirContentUpdate.second));
+                }
+            }
+
             for (auto& theirUpdate : theirLinkedGroupUpdates) {
                 Model::Node* theirGroupNodeToUpdate = theirUpdate.first;
                 std::vector<std::unique_ptr<Model::Node>>& theirOldChildren = theirUpdate.second;
@@ -105,9 +130,11 @@ namespace TrenchBroom {
         kdl::result<void, Model::UpdateLinkedGroupsError> UpdateLinkedGroupsHelper::computeLinkedGroupUpdates(MapDocumentCommandFacade& document) {
             return std::visit(kdl::overload(
                 [&](const LinkedGroupsToUpdate& linkedGroups) {
-                    return computeLinkedGroupUpdates(linkedGroups, document.worldBounds())
-                        .and_then([&](auto&& linkedGroupUpdates) {
-                            m_state = std::move(linkedGroupUpdates);
+                    return computeLinkedGroupUpdates(linkedGroups, m_changedNodes, document.worldBounds())
+                        .and_then([&](auto&& updates) {
+                            m_state = std::move(updates.first);
+                            m_contentUpdates = std::move(updates.second);
+                            m_changedNodes.clear();
                         });
                 },
                 [](const LinkedGroupUpdates&) -> kdl::result<void, Model::UpdateLinkedGroupsError> { 
@@ -116,15 +143,42 @@ namespace TrenchBroom {
             ), m_state);
         }
 
-        kdl::result<UpdateLinkedGroupsHelper::LinkedGroupUpdates, Model::UpdateLinkedGroupsError> UpdateLinkedGroupsHelper::computeLinkedGroupUpdates(const LinkedGroupsToUpdate& linkedGroupsToUpdate, const vm::bbox3& worldBounds) {
+        kdl::result<std::pair<UpdateLinkedGroupsHelper::LinkedGroupUpdates, UpdateLinkedGroupsHelper::LinkedGroupContentUpdates>, Model::UpdateLinkedGroupsError> UpdateLinkedGroupsHelper::computeLinkedGroupUpdates(const LinkedGroupsToUpdate& linkedGroupsToUpdate, const std::vector<const Model::Node*>& changedNodes, const vm::bbox3& worldBounds) {
+            using ComputeResult = kdl::result<std::pair<LinkedGroupUpdates, LinkedGroupContentUpdates>, Model::UpdateLinkedGroupsError>;
+
             if (!checkLinkedGroupsToUpdate(kdl::vec_transform(linkedGroupsToUpdate, [](const auto& p) { return p.first; }))) {
                 return Model::UpdateLinkedGroupsError::UpdateIsInconsistent;
             }
 
+            // If more than one link set is affected, then the link sets may be nested, and the updates of the inner link
+            // sets must be propagated to the outer link sets by replacing their children.
+            if (!changedNodes.empty() && linkedGroupsToUpdate.size() == 1u) {
+                const auto* sourceGroupNode = linkedGroupsToUpdate.front().first;
+                const auto& targetGroupNodes = linkedGroupsToUpdate.front().second;
+
+                auto targetGroupNodesToUpdate = std::vector<Model::GroupNode*>{};
+                auto targetGroupNodesToReplace = std::vector<Model::GroupNode*>{};
+                for (auto* targetGroupNode : targetGroupNodes) {
+                    if (Model::canUpdateLinkedGroupContents(*sourceGroupNode, *targetGroupNode)) {
+                        targetGroupNodesToUpdate.push_back(targetGroupNode);
+                    } else {
+                        targetGroupNodesToReplace.push_back(targetGroupNode);
+                    }
+                }
+
+                return Model::updateLinkedGroupContents(*sourceGroupNode, targetGroupNodesToUpdate, changedNodes, worldBounds)
+                    .and_then([&](auto&& contentUpdates) -> ComputeResult {
+                        return Model::updateLinkedGroups(*sourceGroupNode, targetGroupNodesToReplace, worldBounds)
+                            .and_then([&](auto&& linkedGroupUpdates) {
+                                return std::make_pair(std::move(linkedGroupUpdates), std::move(contentUpdates));
+                            });
+                    });
+            }
+
             return kdl::for_each_result(linkedGroupsToUpdate, [&](const auto& pair) {
                 return Model::updateLinkedGroups(*pair.first, pair.second, worldBounds);
-            }).and_then([&](auto&& nestedUpdateLists) -> kdl::result<LinkedGroupUpdates, Model::UpdateLinkedGroupsError> {
-                return kdl::vec_flatten(std::move(nestedUpdateLists));
+            }).and_then([&](auto&& nestedUpdateLists) -> ComputeResult {
+                return std::make_pair(kdl::vec_flatten(std::move(nestedUpdateLists)), LinkedGroupContentUpdates{});
             });
         }
 
@@ -136,5 +190,11 @@ namespace TrenchBroom {
                 }
             ), std::move(m_state));
         }
+
+        void UpdateLinkedGroupsHelper::doSwapLinkedGroupContents(MapDocumentCommandFacade& document) {
+            if (!m_contentUpdates.empty()) {
+                document.performSwapNodeContents(m_contentUpdates);
+            }
+        }
     }
 }
@@ -32,6 +32,7 @@ namespace TrenchBroom {
     namespace Model {
         class GroupNode;
         class Node;
+        class NodeContents;
         enum class UpdateLinkedGroupsError;
     }
 
@@ -54,14 +55,30 @@ namespace TrenchBroom {
          * a replacement node is created for each linked group that needs to be updated, and these
          * linked groups are replaced with their replacements. Calling applyLinkedGroupUpdates replaces
          * the replacement nodes with their original corresponding groups again, effectively undoing the change.
+         *
+         * If the helper is given the nodes whose contents were changed, and if these changes must be propagated for
+         * a single link set only, then the contents of the changed nodes are transformed and swapped into the
+         * corresponding nodes of every linked group that has the same structure as the source group. This avoids
+         * cloning the entire source group for every linked group. Linked groups with a different structure are still
+         * replaced.
          */
         class UpdateLinkedGroupsHelper {
         private:
             using LinkedGroupsToUpdate = std::vector<std::pair<const Model::GroupNode*, std::vector<Model::GroupNode*>>>;
             using LinkedGroupUpdates = std::vector<std::pair<Model::Node*, std::vector<std::unique_ptr<Model::Node>>>>;
+            using LinkedGroupContentUpdates = std::vector<std::pair<Model::Node*, Model::NodeContents>>;
             std::variant<LinkedGroupsToUpdate, LinkedGroupUpdates> m_state;
+            std::vector<const Model::Node*> m_changedNodes;
+            LinkedGroupContentUpdates m_contentUpdates;
         public:
-            explicit UpdateLinkedGroupsHelper(LinkedGroupsToUpdate linkedGroupsToUpdate);
+            /**
+             * Creates a helper that propagates changes to the given linked groups.
+             *
+             * @param linkedGroupsToUpdate the source groups and the members of their link sets
+             * @param changedNodes the nodes whose contents were changed, or an empty vector if the structure of the
+             * source groups changed, too
+             */
+            explicit UpdateLinkedGroupsHelper(LinkedGroupsToUpdate linkedGroupsToUpdate, std::vector<const Model::Node*> changedNodes = {});
             ~UpdateLinkedGroupsHelper();
 
             kdl::result<void, Model::UpdateLinkedGroupsError> applyLinkedGroupUpdates(MapDocumentCommandFacade& document);
@@ -69,9 +86,10 @@ namespace TrenchBroom {
             void collateWith(UpdateLinkedGroupsHelper& other);
         private:
             kdl::result<void, Model::UpdateLinkedGroupsError> computeLinkedGroupUpdates(MapDocumentCommandFacade& document);
-            static kdl::result<LinkedGroupUpdates, Model::UpdateLinkedGroupsError> computeLinkedGroupUpdates(const LinkedGroupsToUpdate& linkedGroupsToUpdate, const vm::bbox3& worldBounds);
+            static kdl::result<std::pair<LinkedGroupUpdates, LinkedGroupContentUpdates>, Model::UpdateLinkedGroupsError> computeLinkedGroupUpdates(const LinkedGroupsToUpdate& linkedGroupsToUpdate, const std::vector<const Model::Node*>& changedNodes, const vm::bbox3& worldBounds);
 
             void doApplyOrUndoLinkedGroupUpdates(MapDocumentCommandFacade& document);
+            void doSwapLinkedGroupContents(MapDocumentCommandFacade& document);
         };
     }
 }
@@ -28,10 +28,15 @@
 
 #include <kdl/vector_set.h>
 
+#include <vecmath/polygon.h>
 #include <vecmath/segment.h>
+#include <vecmath/vec.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iterator>
 #include <map>
+#include <tuple>
 #include <vector>
 
 namespace TrenchBroom {
@@ -165,6 +170,28 @@ namespace TrenchBroom {
              */
             HandleMap m_handles;
 
+            /**
+             * A cell of the uniform grid that indexes the handles by their position.
+             */
+            using CellKey = std::tuple<long, long, long>;
+            using HandleIndex = std::map<CellKey, std::vector<typename HandleMap::iterator>>;
+
+            /**
+             * The edge length of the grid cells.
+             */
+            static constexpr FloatType CellSize = 16.0;
+
+            /**
+             * Two handles are considered to be at the same position if their coordinates differ by at most this value.
+             */
+            static constexpr FloatType CloseHandleEpsilon = 0.001 * 0.001;
+
+            /**
+             * Maps each grid cell to the handles whose position lies in it, so that finding the handles close to a
+             * given handle does not need to scan all handles. The iterators remain valid until the handle is removed.
+             */
+            HandleIndex m_handleIndex;
+
             /**
              * The total number of selected handles, not counting duplicates.
              */
@@ -300,7 +327,13 @@ namespace TrenchBroom {
              * @param handle the handle to add
              */
             void add(const Handle& handle) {
-                m_handles[handle].inc(); // unknown value gets value constructed, which for HandleInfo means its default constructor is called
+                // unknown value gets value constructed, which for HandleInfo means its default constructor is called
+                const auto [it, inserted] = m_handles.try_emplace(handle);
+                it->second.inc();
+
+                if (inserted) {
+                    m_handleIndex[cellKey(handlePosition(handle))].push_back(it);
+                }
             }
 
             /**
@@ -317,6 +350,7 @@ namespace TrenchBroom {
 
                     if (info.count == 0) {
                         deselect(info);
+                        removeFromIndex(it);
                         m_handles.erase(it);
                     }
                     return true;
@@ -330,6 +364,7 @@ namespace TrenchBroom {
              */
             void clear() {
                 m_handles.clear();
+                m_handleIndex.clear();
                 m_selectedHandleCount = 0;
             }
 
@@ -419,14 +454,59 @@ namespace TrenchBroom {
         private:
             template <typename F>
             void forEachCloseHandle(const H& otherHandle, F fun) {
-                static const auto epsilon = 0.001 * 0.001;
-                for (auto& [handle, info] : m_handles) {
-                    if (compare(otherHandle, handle, epsilon) == 0) {
-                        fun(info);
+                // The positions of close handles differ by at most the epsilon, so only the cells overlapping the
+                // epsilon box around the position of the given handle need to be checked.
+                const auto position = handlePosition(otherHandle);
+                const auto [minX, minY, minZ] = cellKey(position - vm::vec3::fill(CloseHandleEpsilon));
+                const auto [maxX, maxY, maxZ] = cellKey(position + vm::vec3::fill(CloseHandleEpsilon));
+
+                for (auto x = minX; x <= maxX; ++x) {
+                    for (auto y = minY; y <= maxY; ++y) {
+                        for (auto z = minZ; z <= maxZ; ++z) {
+                            const auto cell = m_handleIndex.find(CellKey{x, y, z});
+                            if (cell != std::end(m_handleIndex)) {
+                                for (auto it : cell->second) {
+                                    if (compare(otherHandle, it->first, CloseHandleEpsilon) == 0) {
+                                        fun(it->second);
+                                    }
+                                }
+                            }
+                        }
                     }
                 }
             }
 
+            static vm::vec3 handlePosition(const vm::vec3& handle) {
+                return handle;
+            }
+
+            static vm::vec3 handlePosition(const vm::segment3& handle) {
+                return handle.center();
+            }
+
+            static vm::vec3 handlePosition(const vm::polygon3& handle) {
+                return handle.center();
+            }
+
+            static CellKey cellKey(const vm::vec3& position) {
+                return CellKey{
+                    static_cast<long>(std::floor(position.x() / CellSize)),
+                    static_cast<long>(std::floor(position.y() / CellSize)),
+                    static_cast<long>(std::floor(position.z() / CellSize))
+                };
+            }
+
+            void removeFromIndex(const typename HandleMap::iterator it) {
+                const auto cell = m_handleIndex.find(cellKey(handlePosition(it->first)));
+                assert(cell != std::end(m_handleIndex));
+
+                auto& handles = cell->second;
+                handles.erase(std::find(std::begin(handles), std::end(handles), it));
+                if (handles.empty()) {
+                    m_handleIndex.erase(cell);
+                }
+            }
+
             void select(HandleInfo& info) {
                 if (info.select()) {
                     assert(selectedHandleCount() < totalHandleCount());
@@ -480,9 +560,9 @@ namespace TrenchBroom {
              */
             template <typename I>
             std::vector<Model::BrushNode*> findIncidentBrushes(const Handle& handle, I begin, I end) const {
-                kdl::vector_set<Model::BrushNode*> result;
-                findIncidentBrushes(handle, begin, end, std::inserter(result, result.end()));
-                return result.release_data();
+                std::vector<Model::BrushNode*> result;
+                findIncidentBrushes(handle, begin, end, std::back_inserter(result));
+                return kdl::vector_set<Model::BrushNode*>(result).release_data();
             }
 
             /**
@@ -498,12 +578,13 @@ namespace TrenchBroom {
              */
             template <typename I1, typename I2>
             std::vector<Model::BrushNode*> findIncidentBrushes(I1 hBegin, I1 hEnd, I2 bBegin, I2 bEnd) const {
-                kdl::vector_set<Model::BrushNode*> result;
-                auto out = std::inserter(result, std::end(result));
+                // collect the brushes first and remove the duplicates at once
+                std::vector<Model::BrushNode*> result;
+                auto out = std::back_inserter(result);
                 for (auto hCur = hBegin; hCur != hEnd; ++hCur) {
                     findIncidentBrushes(*hCur, bBegin, bEnd, out);
                 }
-                return result.release_data();
+                return kdl::vector_set<Model::BrushNode*>(result).release_data();
             }
 
             /**
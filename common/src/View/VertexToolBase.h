@@ -131,8 +131,9 @@ namespace TrenchBroom {
             template <typename M, typename I>
             std::vector<Model::BrushNode*> findIncidentBrushes(const M& manager, I cur, I end) const {
                 const std::vector<Model::BrushNode*>& brushes = selectedBrushes();
-                kdl::vector_set<Model::BrushNode*> result;
-                auto out = std::inserter(result, std::end(result));
+                // collect the brushes first and remove the duplicates at once
+                std::vector<Model::BrushNode*> result;
+                auto out = std::back_inserter(result);
 
                 while (cur != end) {
                     const auto& handle = *cur;
@@ -140,7 +141,7 @@ namespace TrenchBroom {
                     ++cur;
                 }
 
-                return result.release_data();
+                return kdl::vector_set<Model::BrushNode*>(result).release_data();
             }
 
             virtual void pick(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const = 0;
@@ -521,6 +521,18 @@ L [ ( -1 -1 -1 ) ( 1 1 1 ) ]: 1
         assertIntersectors(tree, RAY(VEC(0.0,  0.0,  0.0), VEC::pos_x()), { 1u });
     }
 
+    TEST_CASE("AABBTreeTest.findIntersectorsWithOriginOnFace", "[AABBTreeTest]") {
+        AABB tree;
+        tree.insert(BOX(VEC(-1.0, -1.0, -1.0), VEC(+1.0, +1.0, +1.0)), 1u);
+
+        // the rays are parallel to the faces their origins lie on
+        assertIntersectors(tree, RAY(VEC(-2.0, +1.0,  0.0), VEC::pos_x()), { 1u });
+        assertIntersectors(tree, RAY(VEC(-2.0, -1.0,  0.0), VEC::pos_x()), { 1u });
+        assertIntersectors(tree, RAY(VEC( 0.0, +1.0, +1.0), VEC::pos_x()), { 1u });
+        assertIntersectors(tree, RAY(VEC( 0.0,  0.0, +1.0), VEC::neg_y()), { 1u });
+        assertIntersectors(tree, RAY(VEC(-2.0, +1.5,  0.0), VEC::pos_x()), {});
+    }
+
     TEST_CASE("AABBTreeTest.findIntersectorsFromInsideRootBBox", "[AABBTreeTest]") {
         AABB tree;
         tree.insert(BOX(VEC(-4.0, -1.0, -1.0), VEC(-2.0, +1.0, +1.0)), 1u);
@@ -550,4 +562,137 @@ L [ ( -1 -1 -1 ) ( 1 1 1 ) ]: 1
         CHECK_FALSE(tree.contains(2u));
         REQUIRE_THAT(tree.findContainers(vm::vec3d{0.5, 0.5, 0.5}), Catch::UnorderedEquals(std::vector<size_t>{}));
     }
+
+    TEST_CASE("AABBTreeTest.clearAndBuild", "[AABBTreeTest]") {
+        // a grid of unit boxes with gaps between them
+        auto boxes = std::vector<BOX>{};
+        for (size_t x = 0u; x < 8u; ++x) {
+            for (size_t y = 0u; y < 8u; ++y) {
+                const auto min = VEC(2.0 * double(x), 2.0 * double(y), 0.0);
+                boxes.emplace_back(min, min + VEC(1.0, 1.0, 1.0));
+            }
+        }
+
+        auto data = std::vector<size_t>{};
+        for (size_t i = 0u; i < boxes.size(); ++i) {
+            data.push_back(i);
+        }
+
+        AABB tree;
+        tree.insert(BOX(VEC(-1.0, -1.0, -1.0), VEC(0.0, 0.0, 0.0)), 1000u);
+        tree.clearAndBuild(data, [&](const size_t i) { return boxes[i]; });
+
+        CHECK_FALSE(tree.contains(1000u));
+        CHECK(tree.bounds() == BOX(VEC(0.0, 0.0, 0.0), VEC(15.0, 15.0, 1.0)));
+
+        // a balanced tree of 64 leafs has a height of 7
+        CHECK(tree.height() == 7u);
+
+        for (const auto i : data) {
+            assertTreeContains(tree, boxes[i], i);
+        }
+
+        assertIntersectors(tree, RAY(VEC(0.5, -1.0, 0.5), VEC::pos_y()), {0u, 1u, 2u, 3u, 4u, 5u, 6u, 7u});
+        assertIntersectors(tree, RAY(VEC(1.5, -1.0, 0.5), VEC::pos_y()), {});
+
+        SECTION("Inserting and removing nodes after building") {
+            const auto bounds = BOX(VEC(16.0, 16.0, 0.0), VEC(17.0, 17.0, 1.0));
+            tree.insert(bounds, 64u);
+            assertTreeContains(tree, bounds, 64u);
+
+            CHECK(tree.remove(0u));
+            assertTreeDoesNotContain(tree, boxes[0], 0u);
+            for (size_t i = 1u; i < data.size(); ++i) {
+                assertTreeContains(tree, boxes[i], i);
+            }
+            CHECK(tree.bounds() == BOX(VEC(0.0, 0.0, 0.0), VEC(17.0, 17.0, 1.0)));
+        }
+
+        SECTION("Building from duplicate data") {
+            CHECK_THROWS_AS(tree.clearAndBuild(std::vector<size_t>{1u, 2u, 1u}, [&](const size_t i) { return boxes[i]; }), NodeTreeException);
+            CHECK(tree.empty());
+        }
+    }
+    TEST_CASE("AABBTreeTest.insertMultipleNodes", "[AABBTreeTest]") {
+        // a row of unit boxes with gaps between them
+        auto boxes = std::vector<BOX>{};
+        for (size_t x = 0u; x < 16u; ++x) {
+            const auto min = VEC(2.0 * double(x), 0.0, 0.0);
+            boxes.emplace_back(min, min + VEC(1.0, 1.0, 1.0));
+        }
+
+        AABB tree;
+        tree.clearAndBuild(std::vector<size_t>{0u, 1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u, 9u, 10u, 11u}, [&](const size_t i) { return boxes[i]; });
+
+        auto expected = std::vector<size_t>{0u, 1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u, 9u, 10u, 11u};
+        const auto insert = [&](const std::vector<size_t>& toInsert) {
+            tree.insert(toInsert, [&](const size_t i) { return boxes[i]; });
+            expected.insert(std::end(expected), std::begin(toInsert), std::end(toInsert));
+        };
+
+        SECTION("Inserting a few nodes") {
+            insert({12u, 13u});
+        }
+
+        SECTION("Inserting many nodes") {
+            insert({12u, 13u, 14u, 15u});
+            CHECK(tree.bounds() == BOX(VEC(0.0, 0.0, 0.0), VEC(31.0, 1.0, 1.0)));
+        }
+
+        SECTION("Inserting nodes that are already in the tree") {
+            CHECK_THROWS_AS(tree.insert(std::vector<size_t>{12u, 1u}, [&](const size_t i) { return boxes[i]; }), NodeTreeException);
+            CHECK_FALSE(tree.contains(12u));
+        }
+
+        SECTION("Inserting duplicate nodes") {
+            CHECK_THROWS_AS(tree.insert(std::vector<size_t>{12u, 13u, 14u, 15u, 12u}, [&](const size_t i) { return boxes[i]; }), NodeTreeException);
+            CHECK_FALSE(tree.contains(12u));
+        }
+
+        for (const auto i : expected) {
+            assertTreeContains(tree, boxes[i], i);
+        }
+    }
+
+    TEST_CASE("AABBTreeTest.updateMultipleNodes", "[AABBTreeTest]") {
+        // a row of unit boxes with gaps between them
+        auto boxes = std::vector<BOX>{};
+        for (size_t x = 0u; x < 16u; ++x) {
+            const auto min = VEC(2.0 * double(x), 0.0, 0.0);
+            boxes.emplace_back(min, min + VEC(1.0, 1.0, 1.0));
+        }
+
+        auto data = std::vector<size_t>{};
+        for (size_t i = 0u; i < boxes.size(); ++i) {
+            data.push_back(i);
+        }
+
+        AABB tree;
+        tree.clearAndBuild(data, [&](const size_t i) { return boxes[i]; });
+
+        const auto offset = VEC(0.0, 4.0, 0.0);
+        const auto move = [&](const std::vector<size_t>& toMove) {
+            for (const auto i : toMove) {
+                boxes[i] = boxes[i].translate(offset);
+            }
+            tree.update(toMove, [&](const size_t i) { return boxes[i]; });
+        };
+
+        SECTION("Updating a few nodes") {
+            move({3u, 7u});
+        }
+
+        SECTION("Updating most nodes") {
+            move({0u, 1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u, 9u, 10u, 11u});
+            CHECK(tree.bounds() == BOX(VEC(0.0, 0.0, 0.0), VEC(31.0, 5.0, 1.0)));
+        }
+
+        SECTION("Updating a missing node") {
+            CHECK_THROWS_AS(tree.update(std::vector<size_t>{1u, 100u}, [&](const size_t i) { return boxes[i]; }), NodeTreeException);
+        }
+
+        for (const auto i : data) {
+            assertTreeContains(tree, boxes[i], i);
+        }
+    }
 }
@@ -0,0 +1,147 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Exceptions.h"
+#include "Logger.h"
+#include "Assets/EntityModel.h"
+#include "Assets/EntityModelManager.h"
+#include "Assets/ModelDefinition.h"
+#include "Assets/Texture.h"
+#include "IO/EntityModelLoader.h"
+#include "IO/Path.h"
+#include "Renderer/IndexRangeMap.h"
+#include "Renderer/PrimType.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <memory>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace Assets {
+        /**
+         * Creates models with a single surface and skin, and a single triangle per frame. Models named "missing.mdl"
+         * cannot be loaded.
+         */
+        class TriangleModelLoader : public IO::EntityModelLoader {
+        private:
+            std::unique_ptr<EntityModel> doInitializeModel(const IO::Path& path, Logger& /* logger */) const override {
+                if (path == IO::Path("missing.mdl")) {
+                    throw GameException("Model not found: " + path.asString());
+                }
+
+                auto model = std::make_unique<EntityModel>(path.asString(), PitchType::Normal);
+                model->addFrames(2u);
+
+                auto skins = std::vector<Texture>{};
+                skins.emplace_back("skin", 1u, 1u);
+                model->addSurface("surface").setSkins(std::move(skins));
+                return model;
+            }
+
+            void doLoadFrame(const IO::Path& /* path */, const size_t frameIndex, EntityModel& model, Logger& /* logger */) const override {
+                const auto vertices = std::vector<EntityModelVertex>{
+                    EntityModelVertex(vm::vec3f(0, 0, 0), vm::vec2f(0, 0)),
+                    EntityModelVertex(vm::vec3f(1, 0, 0), vm::vec2f(1, 0)),
+                    EntityModelVertex(vm::vec3f(0, 1, 0), vm::vec2f(0, 1)),
+                };
+
+                auto& frame = model.loadFrame(frameIndex, "frame", vm::bbox3f(vm::vec3f::zero(), vm::vec3f::one()));
+                model.surface(0u).addIndexedMesh(frame, vertices, Renderer::IndexRangeMap(Renderer::PrimType::Triangles, 0u, 3u));
+            }
+        };
+
+        TEST_CASE("EntityModelManagerTest.evictUnusedRenderers", "[EntityModelManagerTest]") {
+            auto logger = NullLogger{};
+            auto loader = TriangleModelLoader{};
+            auto manager = EntityModelManager{0, 0, logger};
+            manager.setLoader(&loader);
+
+            const auto spec0 = ModelSpecification(IO::Path("model.mdl"), 0u, 0u);
+            const auto spec1 = ModelSpecification(IO::Path("model.mdl"), 0u, 1u);
+            REQUIRE(manager.frame(spec0) != nullptr);
+            REQUIRE(manager.frame(spec1) != nullptr);
+
+            auto* renderer0 = manager.acquireRenderer(spec0);
+            auto* renderer1 = manager.acquireRenderer(spec1);
+            REQUIRE(renderer0 != nullptr);
+            REQUIRE(renderer1 != nullptr);
+
+            const auto rendererSize = renderer0->sizeInBytes();
+            REQUIRE(rendererSize > 0u);
+            CHECK(manager.rendererSize() == 2u * rendererSize);
+
+            manager.setRendererBudget(0u);
+
+            // renderers in use are never evicted
+            manager.evictRenderers();
+            CHECK(manager.rendererSize() == 2u * rendererSize);
+
+            manager.releaseRenderer(renderer1);
+            manager.evictRenderers();
+            CHECK(manager.rendererSize() == rendererSize);
+            CHECK(manager.renderer(spec0) == renderer0);
+
+            // an evicted renderer is rebuilt on demand
+            CHECK(manager.renderer(spec1) != nullptr);
+            CHECK(manager.rendererSize() == 2u * rendererSize);
+
+            // releasing renderer0 makes it the most recently used renderer, so renderer1 is evicted first
+            manager.releaseRenderer(renderer0);
+            manager.setRendererBudget(rendererSize);
+            manager.evictRenderers();
+            CHECK(manager.rendererSize() == rendererSize);
+
+            manager.setRendererBudget(0u);
+            manager.evictRenderers();
+            CHECK(manager.rendererSize() == 0u);
+        }
+
+        TEST_CASE("EntityModelManagerTest.loadModels", "[EntityModelManagerTest]") {
+            auto logger = NullLogger{};
+            auto loader = TriangleModelLoader{};
+            auto manager = EntityModelManager{0, 0, logger};
+            manager.setLoader(&loader);
+
+            const auto frame0 = ModelSpecification(IO::Path("first.mdl"), 0u, 0u);
+            const auto frame1 = ModelSpecification(IO::Path("second.mdl"), 0u, 1u);
+            const auto missing = ModelSpecification(IO::Path("missing.mdl"), 0u, 0u);
+            const auto outOfBounds = ModelSpecification(IO::Path("second.mdl"), 0u, 2u);
+
+            manager.loadModels({ frame0, frame1, frame1, missing, outOfBounds, ModelSpecification() });
+
+            const auto* loadedFrame0 = manager.frame(frame0);
+            REQUIRE(loadedFrame0 != nullptr);
+            CHECK(loadedFrame0->loaded());
+
+            const auto* loadedFrame1 = manager.frame(frame1);
+            REQUIRE(loadedFrame1 != nullptr);
+            CHECK(loadedFrame1->loaded());
+            CHECK(loadedFrame1->index() == 1u);
+
+            CHECK(manager.frame(missing) == nullptr);
+            CHECK(manager.frame(outOfBounds) == nullptr);
+            CHECK(manager.renderer(frame0) != nullptr);
+        }
+    }
+}
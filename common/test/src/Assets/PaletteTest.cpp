@@ -0,0 +1,71 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Color.h"
+#include "Assets/Palette.h"
+#include "Assets/TextureBuffer.h"
+#include "IO/Reader.h"
+
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace Assets {
+        static Palette makeTestPalette() {
+            auto data = std::vector<unsigned char>(768, 0);
+            // index 0 is red, index 1 is green, all other indices are black
+            data[0] = 255;
+            data[4] = 255;
+            return Palette(data);
+        }
+
+        TEST_CASE("PaletteTest.indexedToRgba", "[PaletteTest]") {
+            const auto palette = makeTestPalette();
+            const auto indices = std::vector<unsigned char>{0, 0, 1, 255};
+
+            auto reader = IO::Reader::from(reinterpret_cast<const char*>(indices.data()), reinterpret_cast<const char*>(indices.data() + indices.size())).buffer();
+            auto rgbaImage = TextureBuffer(4 * indices.size());
+            auto averageColor = Color();
+
+            SECTION("Opaque") {
+                CHECK_FALSE(palette.indexedToRgba(reader, indices.size(), rgbaImage, PaletteTransparency::Opaque, averageColor));
+                CHECK(std::vector<unsigned char>(rgbaImage.data(), rgbaImage.data() + rgbaImage.size()) == std::vector<unsigned char>{
+                    255, 0, 0, 255,  255, 0, 0, 255,  0, 255, 0, 255,  0, 0, 0, 255,
+                });
+                CHECK(averageColor == Color(0.5f, 0.25f, 0.0f, 1.0f));
+            }
+
+            SECTION("Index 255 transparent") {
+                CHECK(palette.indexedToRgba(reader, indices.size(), rgbaImage, PaletteTransparency::Index255Transparent, averageColor));
+                CHECK(std::vector<unsigned char>(rgbaImage.data(), rgbaImage.data() + rgbaImage.size()) == std::vector<unsigned char>{
+                    255, 0, 0, 255,  255, 0, 0, 255,  0, 255, 0, 255,  0, 0, 0, 0,
+                });
+                CHECK(averageColor == Color(0.5f, 0.25f, 0.0f, 1.0f));
+            }
+
+            SECTION("Index 255 transparent without transparent pixels") {
+                auto opaqueImage = TextureBuffer(4 * 3u);
+                CHECK_FALSE(palette.indexedToRgba(reader, 3u, opaqueImage, PaletteTransparency::Index255Transparent, averageColor));
+                CHECK(averageColor == Color(2.0f / 3.0f, 1.0f / 3.0f, 0.0f, 1.0f));
+            }
+        }
+    }
+}
@@ -0,0 +1,66 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/TextureBuffer.h"
+
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace Assets {
+        static std::vector<unsigned char> toVector(const TextureBuffer& buffer) {
+            return std::vector<unsigned char>(buffer.data(), buffer.data() + buffer.size());
+        }
+
+        TEST_CASE("TextureBufferTest.downsampleBuffer", "[TextureBufferTest]") {
+            SECTION("Averages 2x2 blocks") {
+                // a 4x2 RGB image
+                const auto pixels = std::vector<unsigned char>{
+                    10, 20, 30,   30, 40, 50,    0,   0,   0,  100, 100, 100,
+                    10, 20, 30,   30, 40, 50,  100, 100, 100,  200, 200, 200,
+                };
+                auto buffer = TextureBuffer(pixels.size());
+                std::copy(std::begin(pixels), std::end(pixels), buffer.data());
+
+                const auto result = downsampleBuffer(buffer, vm::vec2s(4, 2), GL_RGB);
+                CHECK(toVector(result) == std::vector<unsigned char>{
+                    20, 30, 40,  100, 100, 100,
+                });
+            }
+
+            SECTION("Keeps at least one pixel in each dimension") {
+                // a 2x1 RGBA image
+                const auto pixels = std::vector<unsigned char>{
+                    0, 10, 20, 255,   100, 110, 120, 255,
+                };
+                auto buffer = TextureBuffer(pixels.size());
+                std::copy(std::begin(pixels), std::end(pixels), buffer.data());
+
+                const auto result = downsampleBuffer(buffer, vm::vec2s(2, 1), GL_RGBA);
+                CHECK(toVector(result) == std::vector<unsigned char>{
+                    50, 60, 70, 255,
+                });
+            }
+        }
+    }
+}
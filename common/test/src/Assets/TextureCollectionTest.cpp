@@ -0,0 +1,85 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Color.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "Assets/TextureCollection.h"
+#include "IO/Path.h"
+
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace Assets {
+        static Texture makeTexture(const std::string& name, const std::string& imagePath) {
+            auto texture = Texture{name, 1u, 1u, Color(), TextureBuffer(4u), GL_RGBA, TextureType::Opaque};
+            texture.setImagePath(IO::Path(imagePath));
+            return texture;
+        }
+
+        TEST_CASE("TextureCollectionTest.texturesWithSameImageShareImage", "[TextureCollectionTest]") {
+            auto textures = std::vector<Texture>{};
+            textures.push_back(makeTexture("wall", "textures/base/wall.tga"));
+            textures.push_back(makeTexture("wall_blend", "textures/base/wall.tga"));
+            textures.push_back(makeTexture("wall_nocull", "textures/base/wall.tga"));
+            textures.push_back(makeTexture("floor", "textures/base/floor.tga"));
+            textures.push_back(makeTexture("other", ""));
+            textures[1].setBlendFunc(GL_ONE, GL_ONE);
+            textures[2].setCulling(TextureCulling::CullNone);
+
+            const auto collection = TextureCollection{IO::Path("base"), std::move(textures)};
+            const auto& wall = collection.textures()[0];
+            const auto& wallBlend = collection.textures()[1];
+            const auto& wallNoCull = collection.textures()[2];
+            const auto& floor = collection.textures()[3];
+            const auto& other = collection.textures()[4];
+
+            CHECK(&wall.imageTexture() == &wall);
+            CHECK(&wallBlend.imageTexture() == &wall);
+            CHECK(&wallNoCull.imageTexture() == &wall);
+            CHECK(&floor.imageTexture() == &floor);
+            CHECK(&other.imageTexture() == &other);
+
+            CHECK(wallBlend.buffersIfUnprepared().empty());
+            CHECK_FALSE(wall.buffersIfUnprepared().empty());
+
+            // textures with different culling or blending cannot be rendered together
+            CHECK(wall.renderTexture() == &wall);
+            CHECK(wallBlend.renderTexture() == &wallBlend);
+            CHECK(wallNoCull.renderTexture() == &wallNoCull);
+        }
+
+        TEST_CASE("TextureCollectionTest.texturesWithSameRenderStateAreMerged", "[TextureCollectionTest]") {
+            auto textures = std::vector<Texture>{};
+            textures.push_back(makeTexture("wall", "textures/base/wall.tga"));
+            textures.push_back(makeTexture("wall_clip", "textures/base/wall.tga"));
+
+            const auto collection = TextureCollection{IO::Path("base"), std::move(textures)};
+            const auto& wall = collection.textures()[0];
+            const auto& wallClip = collection.textures()[1];
+
+            CHECK(wall.renderTexture() == &wall);
+            CHECK(wallClip.renderTexture() == &wall);
+        }
+    }
+}
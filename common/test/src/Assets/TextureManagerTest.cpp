@@ -0,0 +1,106 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Logger.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureCollection.h"
+#include "Assets/TextureManager.h"
+#include "IO/Path.h"
+#include "Model/InternedString.h"
+
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace Assets {
+        static std::vector<Texture> makeTextures(const std::vector<std::string>& names) {
+            auto result = std::vector<Texture>{};
+            for (const auto& name : names) {
+                result.emplace_back(name, 1u, 1u);
+            }
+            return result;
+        }
+
+        static std::vector<std::string> textureNames(const std::vector<const Texture*>& textures) {
+            auto result = std::vector<std::string>{};
+            for (const auto* texture : textures) {
+                result.push_back(texture->name());
+            }
+            return result;
+        }
+
+        TEST_CASE("TextureManagerTest.lookupIsCaseInsensitive", "[TextureManagerTest]") {
+            auto logger = NullLogger{};
+            auto manager = TextureManager{0, 0, logger};
+
+            auto collections = std::vector<TextureCollection>{};
+            collections.emplace_back(IO::Path("first"), makeTextures({"Sky1", "wall", "Floor"}));
+            manager.setTextureCollections(std::move(collections));
+
+            CHECK(manager.texture("sky1") != nullptr);
+            CHECK(manager.texture("SKY1") == manager.texture("Sky1"));
+            CHECK(manager.texture("floor")->name() == "Floor");
+            CHECK(manager.texture("missing") == nullptr);
+
+            CHECK(textureNames(manager.textures()) == std::vector<std::string>{"Floor", "Sky1", "wall"});
+        }
+
+        TEST_CASE("TextureManagerTest.laterCollectionsOverrideTextures", "[TextureManagerTest]") {
+            auto logger = NullLogger{};
+            auto manager = TextureManager{0, 0, logger};
+
+            auto collections = std::vector<TextureCollection>{};
+            collections.emplace_back(IO::Path("first"), makeTextures({"sky1", "wall"}));
+            collections.emplace_back(IO::Path("second"), makeTextures({"SKY1"}));
+            manager.setTextureCollections(std::move(collections));
+
+            const auto& first = manager.collections()[0].textures();
+            const auto& second = manager.collections()[1].textures();
+
+            CHECK(manager.texture("sky1") == &second[0]);
+            CHECK(first[0].overridden());
+            CHECK_FALSE(first[1].overridden());
+            CHECK_FALSE(second[0].overridden());
+
+            CHECK(textureNames(manager.textures()) == std::vector<std::string>{"SKY1", "wall"});
+        }
+
+        TEST_CASE("TextureManagerTest.batchLookup", "[TextureManagerTest]") {
+            auto logger = NullLogger{};
+            auto manager = TextureManager{0, 0, logger};
+
+            auto collections = std::vector<TextureCollection>{};
+            collections.emplace_back(IO::Path("first"), makeTextures({"sky1", "wall"}));
+            manager.setTextureCollections(std::move(collections));
+
+            const auto names = std::vector<Model::InternedString>{
+                Model::InternedString("wall"),
+                Model::InternedString("missing"),
+                Model::InternedString("WALL"),
+                Model::InternedString("wall"),
+            };
+
+            auto* wall = manager.texture("wall");
+            REQUIRE(wall != nullptr);
+            CHECK(manager.textures(names) == std::vector<Texture*>{wall, nullptr, wall, wall});
+        }
+    }
+}
@@ -27,6 +27,7 @@
 #include "IO/ELParser.h"
 
 #include <string>
+#include <vector>
 
 #include "Catch2.h"
 
@@ -341,5 +342,12 @@ namespace TrenchBroom {
             evaluateAndAssert("true && true -> false", false);
             evaluateAndAssert("2 + 3 < 2 + 4 -> 6 % 5", 1);
         }
+
+        TEST_CASE("ExpressionTest.testVariableNames", "[ExpressionTest]") {
+            using V = std::vector<std::string>;
+            CHECK(IO::ELParser::parseStrict("1 + 2").variableNames() == V{});
+            CHECK(IO::ELParser::parseStrict("x + y * x").variableNames() == V{"x", "y"});
+            CHECK(IO::ELParser::parseStrict(R"({{ spawnflags == 1 -> { "path": model }, [ skin, "b" ][0] }})").variableNames() == V{"model", "skin", "spawnflags"});
+        }
     }
 }
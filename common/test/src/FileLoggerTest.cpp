@@ -0,0 +1,62 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "FileLogger.h"
+#include "IO/DiskIO.h"
+#include "IO/Path.h"
+#include "IO/TestEnvironment.h"
+
+#include <chrono>
+#include <string>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    TEST_CASE("FileLoggerTest.flush", "[FileLoggerTest]") {
+        IO::TestEnvironment env("FileLoggerTest");
+        const auto logFilePath = env.dir() + IO::Path("test.log");
+
+        // use a long flush interval so that the messages can only have been written by flush
+        auto logger = FileLogger(logFilePath, std::chrono::hours(1));
+        logger.info() << "first";
+        logger.warn() << "second";
+        logger.flush();
+
+        CHECK(IO::Disk::readTextFile(logFilePath) == "first\nsecond\n");
+    }
+
+    TEST_CASE("FileLoggerTest.writeOnDestruction", "[FileLoggerTest]") {
+        IO::TestEnvironment env("FileLoggerTest");
+        const auto logFilePath = env.dir() + IO::Path("test.log");
+
+        {
+            auto logger = FileLogger(logFilePath, std::chrono::hours(1));
+            for (size_t i = 0; i < 100; ++i) {
+                logger.info() << std::to_string(i);
+            }
+        }
+
+        auto expected = std::string{};
+        for (size_t i = 0; i < 100; ++i) {
+            expected += std::to_string(i) + "\n";
+        }
+        CHECK(IO::Disk::readTextFile(logFilePath) == expected);
+    }
+}
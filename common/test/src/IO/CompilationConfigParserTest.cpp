@@ -23,7 +23,9 @@
 #include "Model/CompilationProfile.h"
 #include "Model/CompilationTask.h"
 
+#include <optional>
 #include <string>
+#include <vector>
 
 #include "Catch2.h"
 
@@ -418,5 +420,47 @@ namespace TrenchBroom {
 
             profile->task(0)->accept(AssertCompilationCopyFilesVisitor(true, "${WORK_DIR_PATH}/${MAP_BASE_NAME}.bsp", "C:\\quake2\\chaos\\maps\\"));
         }
+    
+        TEST_CASE("CompilationConfigParserTest.parseJobsAndTaskDependencies", "[CompilationConfigParserTest]") {
+            const std::string config(R"({
+                'version': 1,
+                'profiles': [
+                    {
+                        'name': 'A profile',
+                        'workdir': '',
+                        'jobs': 2,
+                        'tasks': [
+                            { 'type': 'tool', 'name': 'bsp', 'tool': 'qbsp', 'parameters': '' },
+                            { 'type': 'tool', 'name': 'light', 'dependsOn': [ 'bsp' ], 'tool': 'light', 'parameters': '' },
+                            { 'type': 'copy', 'dependsOn': [], 'source': 'the source', 'target': 'the target' }
+                        ]
+                    }
+                ]
+            })");
+            CompilationConfigParser parser(config);
+
+            Model::CompilationConfig result = parser.parse();
+            CHECK(result.profileCount() == 1u);
+
+            const Model::CompilationProfile* profile = result.profile(0);
+            CHECK(profile->jobCount() == 2u);
+            CHECK(profile->taskCount() == 3u);
+
+            CHECK(profile->task(0)->name() == "bsp");
+            CHECK(profile->task(0)->dependencies() == std::nullopt);
+            CHECK(profile->task(1)->name() == "light");
+            CHECK(profile->task(1)->dependencies() == std::vector<std::string>{"bsp"});
+            CHECK(profile->task(2)->name() == "");
+            CHECK(profile->task(2)->dependencies() == std::vector<std::string>{});
+        }
+
+        TEST_CASE("CompilationConfigParserTest.parseInvalidJobCount", "[CompilationConfigParserTest]") {
+            const std::string config(R"({
+                'version': 1,
+                'profiles': [ { 'name': 'A profile', 'workdir': '', 'jobs': 0, 'tasks': [] } ]
+            })");
+            CompilationConfigParser parser(config);
+            CHECK_THROWS_AS(parser.parse(), ParserException);
+        }
     }
 }
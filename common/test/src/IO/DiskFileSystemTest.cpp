@@ -138,6 +138,21 @@ namespace TrenchBroom {
             }));
         }
 
+        TEST_CASE("DiskTest.getDirectoryEntries", "[DiskTest]") {
+            FSTestEnvironment env;
+
+            CHECK_THROWS_AS(Disk::getDirectoryEntries(Path("asdf/bleh")), FileSystemException);
+            CHECK_THROWS_AS(Disk::getDirectoryEntries(env.dir() + Path("does/not/exist")), FileSystemException);
+
+            CHECK_THAT(Disk::getDirectoryEntries(env.dir()), Catch::UnorderedEquals(std::vector<std::pair<Path, bool>>{
+                {Path("dir1"), true},
+                {Path("dir2"), true},
+                {Path("anotherDir"), true},
+                {Path("test.txt"), false},
+                {Path("test2.map"), false},
+            }));
+        }
+
         TEST_CASE("DiskTest.openFile", "[DiskTest]") {
             FSTestEnvironment env;
 
@@ -0,0 +1,104 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/ModelDefinition.h"
+#include "Assets/PropertyDefinition.h"
+#include "IO/EntityDefinitionCache.h"
+#include "IO/EntityDefinitionClassInfo.h"
+#include "IO/FgdParser.h"
+#include "IO/Path.h"
+#include "IO/TestParserStatus.h"
+
+#include <string>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        static const auto CacheTestFgd = std::string(R"(
+@BaseClass color(255 0 0) = Base [ target(target_destination) : "Target" ]
+@PointClass base(Base) size(-16 -16 -24, 16 16 32) model({ "path": ":progs/player.mdl", "skin": 1 }) = info_player_start : "Player start"
+[
+    angle(integer) : "Angle" : 90
+    message(string) : "Message" : "hello world"
+    speed(float) : "Speed" : "1.5"
+    style(choices) : "Style" : 1 = [ 0 : "Normal" 1 : "Flicker" ]
+    spawnflags(flags) = [ 1 : "Suspended" : 1 2 : "Silent" : 0 ]
+    unknown(bogus) : "Unknown"
+]
+@SolidClass = func_door : "Door" []
+)");
+
+        TEST_CASE("EntityDefinitionCacheTest.cachePath", "[EntityDefinitionCacheTest]") {
+            const auto path = EntityDefinitionCache::cachePath(Path("/cache"), Path("/defs/quake.fgd"));
+            CHECK(path.deleteLastComponent() == Path("/cache"));
+            CHECK(path.extension() == "tbdefcache");
+            CHECK(path == EntityDefinitionCache::cachePath(Path("/cache"), Path("/defs/quake.fgd")));
+            CHECK(path != EntityDefinitionCache::cachePath(Path("/cache"), Path("/defs/hexen.fgd")));
+        }
+
+        TEST_CASE("EntityDefinitionCacheTest.restoreClassInfos", "[EntityDefinitionCacheTest]") {
+            FgdParser parser(CacheTestFgd, Color(1.0f, 1.0f, 1.0f, 1.0f));
+            TestParserStatus status;
+            const auto classInfos = parser.parseClassInfos(status);
+            REQUIRE(classInfos.size() == 3u);
+
+            const auto cacheData = EntityDefinitionCache::write(CacheTestFgd, {}, classInfos);
+            const auto restoredClassInfos = EntityDefinitionCache::read(cacheData, CacheTestFgd);
+            REQUIRE(restoredClassInfos.has_value());
+            REQUIRE(restoredClassInfos->size() == classInfos.size());
+
+            for (size_t i = 0; i < classInfos.size(); ++i) {
+                const auto& expected = classInfos[i];
+                const auto& actual = (*restoredClassInfos)[i];
+
+                CHECK(actual.type == expected.type);
+                CHECK(actual.line == expected.line);
+                CHECK(actual.column == expected.column);
+                CHECK(actual.name == expected.name);
+                CHECK(actual.description == expected.description);
+                CHECK(actual.color == expected.color);
+                CHECK(actual.size == expected.size);
+                CHECK(actual.modelDefinition == expected.modelDefinition);
+                CHECK(actual.superClasses == expected.superClasses);
+
+                REQUIRE(actual.propertyDefinitions.size() == expected.propertyDefinitions.size());
+                for (size_t j = 0; j < expected.propertyDefinitions.size(); ++j) {
+                    const auto& expectedDefinition = *expected.propertyDefinitions[j];
+                    const auto& actualDefinition = *actual.propertyDefinitions[j];
+                    CHECK(actualDefinition.equals(&expectedDefinition));
+                    CHECK(actualDefinition.shortDescription() == expectedDefinition.shortDescription());
+                    CHECK(actualDefinition.longDescription() == expectedDefinition.longDescription());
+                    CHECK(Assets::PropertyDefinition::defaultValue(actualDefinition) == Assets::PropertyDefinition::defaultValue(expectedDefinition));
+                }
+            }
+        }
+
+        TEST_CASE("EntityDefinitionCacheTest.rejectStaleData", "[EntityDefinitionCacheTest]") {
+            FgdParser parser(CacheTestFgd, Color(1.0f, 1.0f, 1.0f, 1.0f));
+            TestParserStatus status;
+            const auto classInfos = parser.parseClassInfos(status);
+            const auto cacheData = EntityDefinitionCache::write(CacheTestFgd, {}, classInfos);
+
+            CHECK_FALSE(EntityDefinitionCache::read(cacheData, CacheTestFgd + " ").has_value());
+            CHECK_FALSE(EntityDefinitionCache::read(cacheData.substr(0, cacheData.size() / 2u), CacheTestFgd).has_value());
+            CHECK_FALSE(EntityDefinitionCache::read("", CacheTestFgd).has_value());
+        }
+    }
+}
@@ -19,6 +19,7 @@
 
 #include "TestLogger.h"
 
+#include "Color.h"
 #include "Assets/Texture.h"
 #include "IO/DiskIO.h"
 #include "IO/DiskFileSystem.h"
@@ -34,13 +35,13 @@
 
 namespace TrenchBroom {
     namespace IO {
-        static Assets::Texture loadTexture(const std::string& name) {
+        static Assets::Texture loadTexture(const std::string& name, const bool deferDecoding = false) {
             const auto imagePath = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Image/");
             DiskFileSystem diskFS(imagePath);
 
             TextureReader::TextureNameStrategy nameStrategy;
             NullLogger logger;
-            FreeImageTextureReader textureLoader(nameStrategy, diskFS, logger);
+            FreeImageTextureReader textureLoader(nameStrategy, diskFS, logger, deferDecoding);
 
             return textureLoader.readTexture(diskFS.openFile(Path(name)));
         }
@@ -113,6 +114,15 @@ namespace TrenchBroom {
             testImageContents(loadTexture("jpgContentsTest.jpg"), ColorMatch::Approximate);
         }
 
+        TEST_CASE("FreeImageTextureReaderTest.testDeferredDecoding", "[FreeImageTextureReaderTest]") {
+            // the file system is destroyed before the texture is decoded
+            const auto texture = loadTexture("pngContentsTest.png", true);
+            CHECK(texture.name() == "pngContentsTest.png");
+
+            testImageContents(texture, ColorMatch::Exact);
+            CHECK(texture.averageColor() != Color(0.5f, 0.5f, 0.5f, 1.0f));
+        }
+
         TEST_CASE("FreeImageTextureReaderTest.alphaMaskTest", "[FreeImageTextureReaderTest]") {
             const auto texture = loadTexture("alphaMaskTest.png");
             const std::size_t w = 25u;
@@ -0,0 +1,184 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "IO/MapCache.h"
+#include "IO/Path.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/BezierPatch.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushNode.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/PatchNode.h"
+#include "Model/WorldNode.h"
+
+#include <vecmath/bbox.h>
+
+#include <string>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        static void checkSameWorld(const Model::WorldNode& expected, const Model::WorldNode& actual) {
+            CHECK(actual.entity().properties() == expected.entity().properties());
+
+            const auto& expectedChildren = expected.defaultLayer()->children();
+            const auto& actualChildren = actual.defaultLayer()->children();
+            REQUIRE(actualChildren.size() == expectedChildren.size());
+
+            for (size_t i = 0; i < expectedChildren.size(); ++i) {
+                if (const auto* expectedBrushNode = dynamic_cast<const Model::BrushNode*>(expectedChildren[i])) {
+                    const auto* actualBrushNode = dynamic_cast<const Model::BrushNode*>(actualChildren[i]);
+                    REQUIRE(actualBrushNode != nullptr);
+                    CHECK(actualBrushNode->brush().faces() == expectedBrushNode->brush().faces());
+                    CHECK(actualBrushNode->lineNumber() == expectedBrushNode->lineNumber());
+                } else if (const auto* expectedEntityNode = dynamic_cast<const Model::EntityNode*>(expectedChildren[i])) {
+                    const auto* actualEntityNode = dynamic_cast<const Model::EntityNode*>(actualChildren[i]);
+                    REQUIRE(actualEntityNode != nullptr);
+                    CHECK(actualEntityNode->entity().properties() == expectedEntityNode->entity().properties());
+                    CHECK(actualEntityNode->childCount() == expectedEntityNode->childCount());
+                } else if (const auto* expectedPatchNode = dynamic_cast<const Model::PatchNode*>(expectedChildren[i])) {
+                    const auto* actualPatchNode = dynamic_cast<const Model::PatchNode*>(actualChildren[i]);
+                    REQUIRE(actualPatchNode != nullptr);
+                    CHECK(actualPatchNode->patch() == expectedPatchNode->patch());
+                }
+            }
+        }
+
+        TEST_CASE("MapCacheTest.cachePath", "[MapCacheTest]") {
+            CHECK(MapCache::cachePath(Path("/maps/test.map")) == Path("/maps/test.map.tbcache"));
+        }
+
+        TEST_CASE("MapCacheTest.restoreWorld", "[MapCacheTest]") {
+            using T = std::tuple<Model::MapFormat, std::string>;
+            const auto [mapFormat, data] = GENERATE(values<T>({
+                {Model::MapFormat::Standard, R"(
+{
+"classname" "worldspawn"
+"message" "yay"
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) tex1 1 2 3 4 5
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) tex2 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) tex3 0 0 0 1 1
+( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) tex4 0 0 0 1 1
+( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) tex5 0 0 0 1 1
+( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) tex6 0 0 0 1 1
+}
+}
+{
+"classname" "func_door"
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) tex1 0 0 0 1 1
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) tex2 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) tex3 0 0 0 1 1
+( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) tex4 0 0 0 1 1
+( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) tex5 0 0 0 1 1
+( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) tex6 0 0 0 1 1
+}
+}
+{
+"classname" "light"
+"origin" "1 2 3"
+})"},
+                {Model::MapFormat::Valve, R"(
+{
+"classname" "worldspawn"
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) METAL4_5 [ 1 0 0 64 ] [ 0 -1 0 0 ] 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) METAL4_5 [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) METAL4_5 [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) METAL4_5 [ 1 0 0 64 ] [ 0 0 -1 0 ] 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) METAL4_5 [ 1 0 0 64 ] [ 0 0 -1 0 ] 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) METAL4_5 [ 1 0 0 64 ] [ 0 -1 0 0 ] 0 1 1
+}
+})"},
+                {Model::MapFormat::Quake3, R"(
+{
+"classname" "worldspawn"
+{
+patchDef2
+{
+common/caulk
+( 3 3 0 0 0 )
+(
+( (-64 -64 4 0   0 ) (-64 0 4 0   -0.25 ) (-64 64 4 0   -0.5 ) )
+( (  0 -64 4 0.2 0 ) (  0 0 4 0.2 -0.25 ) (  0 64 4 0.2 -0.5 ) )
+( ( 64 -64 4 0.4 0 ) ( 64 0 4 0.4 -0.25 ) ( 64 64 4 0.4 -0.5 ) )
+)
+}
+}
+})"},
+            }));
+
+            CAPTURE(Model::formatName(mapFormat));
+
+            const auto worldBounds = vm::bbox3(8192.0);
+            auto status = TestParserStatus{};
+
+            auto parsedReader = WorldReader{data, mapFormat};
+            auto [parsedWorld, cacheData] = parsedReader.read(worldBounds, std::string_view{}, status);
+            REQUIRE(parsedWorld != nullptr);
+            REQUIRE(cacheData.has_value());
+
+            auto cachedReader = WorldReader{data, mapFormat};
+            auto [cachedWorld, newCacheData] = cachedReader.read(worldBounds, *cacheData, status);
+            REQUIRE(cachedWorld != nullptr);
+            CHECK_FALSE(newCacheData.has_value());
+
+            checkSameWorld(*parsedWorld, *cachedWorld);
+        }
+
+        TEST_CASE("MapCacheTest.rejectStaleCache", "[MapCacheTest]") {
+            const auto data = std::string{R"(
+{
+"classname" "worldspawn"
+"message" "yay"
+})"};
+            const auto changedData = std::string{R"(
+{
+"classname" "worldspawn"
+"message" "nay"
+})"};
+
+            const auto worldBounds = vm::bbox3(8192.0);
+            auto status = TestParserStatus{};
+
+            auto reader = WorldReader{data, Model::MapFormat::Standard};
+            auto [world, cacheData] = reader.read(worldBounds, std::string_view{}, status);
+            REQUIRE(cacheData.has_value());
+
+            CHECK(MapCache::read(*cacheData, data, Model::MapFormat::Standard, Model::MapFormat::Standard).has_value());
+            CHECK_FALSE(MapCache::read(*cacheData, changedData, Model::MapFormat::Standard, Model::MapFormat::Standard).has_value());
+            CHECK_FALSE(MapCache::read(*cacheData, data, Model::MapFormat::Valve, Model::MapFormat::Valve).has_value());
+            CHECK_FALSE(MapCache::read(std::string_view{*cacheData}.substr(0, cacheData->size() - 1u), data, Model::MapFormat::Standard, Model::MapFormat::Standard).has_value());
+
+            auto changedReader = WorldReader{changedData, Model::MapFormat::Standard};
+            auto [changedWorld, changedCacheData] = changedReader.read(worldBounds, *cacheData, status);
+            CHECK(changedCacheData.has_value());
+            CHECK(changedWorld->entity().property("message") != nullptr);
+            CHECK(*changedWorld->entity().property("message") == "nay");
+        }
+    }
+}
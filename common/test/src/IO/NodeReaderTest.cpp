@@ -26,8 +26,13 @@
 #include "Model/GroupNode.h"
 #include "Model/ParaxialTexCoordSystem.h"
 
+#include <kdl/vector_utils.h>
+
 #include <vecmath/bbox.h>
 
+#include <string>
+#include <vector>
+
 namespace TrenchBroom {
     namespace Model {
         TEST_CASE("NodeReaderTest.parseFaceAsNode", "[NodeReaderTest]") {
@@ -108,5 +113,58 @@ namespace TrenchBroom {
             const Brush brush = brushNode->brush();
             CHECK(dynamic_cast<const ParaxialTexCoordSystem*>(&brush.face(0).texCoordSystem()) != nullptr);
         }
+
+        TEST_CASE("NodeReaderTest.readWithCacheData", "[NodeReaderTest]") {
+            const std::string data(R"(// entity 0
+{
+"classname" "func_group"
+"_tb_type" "_tb_group"
+"_tb_name" "Unnamed"
+"_tb_id" "3"
+// brush 0
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) __TB_empty [ 0 -1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -64 -64 -16 ) ( -64 -64 -15 ) ( -63 -64 -16 ) __TB_empty [ 1 0 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -64 -64 -16 ) ( -63 -64 -16 ) ( -64 -63 -16 ) __TB_empty [ -1 0 0 0 ] [ 0 -1 0 0 ] 0 1 1
+( 64 64 16 ) ( 64 65 16 ) ( 65 64 16 ) __TB_empty [ 1 0 0 0 ] [ 0 -1 0 0 ] 0 1 1
+( 64 64 16 ) ( 65 64 16 ) ( 64 64 17 ) __TB_empty [ -1 0 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( 64 64 16 ) ( 64 64 17 ) ( 64 65 16 ) __TB_empty [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+}
+}
+)");
+
+            const vm::bbox3 worldBounds(4096.0);
+
+            IO::TestParserStatus status;
+
+            const auto cacheData = IO::NodeReader::writeCacheData(data, MapFormat::Valve, status);
+            REQUIRE_FALSE(cacheData.empty());
+
+            const auto checkNodes = [](std::vector<Node*> nodes) {
+                REQUIRE(nodes.size() == 1u);
+                auto* groupNode = dynamic_cast<GroupNode*>(nodes.front());
+                REQUIRE(groupNode != nullptr);
+                CHECK(groupNode->name() == "Unnamed");
+                REQUIRE(groupNode->childCount() == 1u);
+                CHECK(dynamic_cast<BrushNode*>(groupNode->children().front()) != nullptr);
+                kdl::vec_clear_and_delete(nodes);
+            };
+
+            SECTION("Matching cache data") {
+                checkNodes(IO::NodeReader::read(data, MapFormat::Valve, worldBounds, cacheData, status));
+            }
+
+            SECTION("Cache data for another map format is ignored") {
+                checkNodes(IO::NodeReader::read(data, MapFormat::Standard, worldBounds, cacheData, status));
+            }
+
+            SECTION("Malformed cache data is ignored") {
+                checkNodes(IO::NodeReader::read(data, MapFormat::Valve, worldBounds, "garbage", status));
+            }
+
+            SECTION("Unparseable text yields no cache data") {
+                CHECK(IO::NodeReader::writeCacheData("{ garbage", MapFormat::Valve, status).empty());
+            }
+        }
     }
 }
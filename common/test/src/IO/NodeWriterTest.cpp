@@ -18,6 +18,7 @@
  */
 
 #include "Exceptions.h"
+#include "IO/NodeSerializationCache.h"
 #include "IO/NodeWriter.h"
 #include "Model/BezierPatch.h"
 #include "Model/BrushNode.h"
@@ -36,6 +37,7 @@
 
 #include <kdl/result.h>
 #include <kdl/string_compare.h>
+#include <kdl/string_utils.h>
 
 #include <vecmath/mat.h>
 #include <vecmath/mat_ext.h>
@@ -47,6 +49,7 @@
 
 #include <iostream>
 #include <sstream>
+#include <string>
 #include <vector>
 
 #include "Catch2.h"
@@ -297,6 +300,39 @@ R"(// entity 0
             CHECK(actual == expected);
         }
 
+        TEST_CASE("NodeWriterTest.writeMapWithManyBrushes", "[NodeWriterTest]") {
+            // enough brushes to be serialized in several batches, with entity brushes interleaved with world brushes
+            const vm::bbox3 worldBounds(8192.0);
+
+            Model::WorldNode map(Model::Entity(), Model::MapFormat::Standard);
+            Model::BrushBuilder builder(map.mapFormat(), worldBounds);
+
+            std::vector<Model::BrushNode*> brushNodes;
+            for (size_t i = 0u; i < 10000u; ++i) {
+                auto* brushNode = new Model::BrushNode(builder.createCube(64.0, "tex" + std::to_string(i)).value());
+                if (i % 1000u == 0u) {
+                    auto* entityNode = new Model::EntityNode(Model::Entity({{"classname", "func_door"}}));
+                    entityNode->addChild(brushNode);
+                    map.defaultLayer()->addChild(entityNode);
+                } else {
+                    map.defaultLayer()->addChild(brushNode);
+                }
+                brushNodes.push_back(brushNode);
+            }
+
+            std::stringstream str;
+            NodeWriter writer(map, str);
+            writer.writeMap();
+
+            const auto lines = kdl::str_split(str.str(), "\n");
+            for (size_t i = 0u; i < brushNodes.size(); ++i) {
+                // the file position of a brush starts at its opening brace, the first face follows
+                const auto* brushNode = brushNodes[i];
+                REQUIRE(brushNode->lineNumber() < lines.size());
+                CHECK_THAT(lines[brushNode->lineNumber()], Catch::EndsWith(" tex" + std::to_string(i) + " 0 0 0 1 1"));
+            }
+        }
+
         TEST_CASE("NodeWriterTest.writeWorldspawnWithBrushInCustomLayer", "[NodeWriterTest]") {
             const vm::bbox3 worldBounds(8192.0);
 
@@ -1205,5 +1241,45 @@ common/caulk
         }
 
 
+    
+        TEST_CASE("NodeWriterTest.writeMapWithSerializationCache", "[NodeWriterTest]") {
+            const vm::bbox3 worldBounds(8192.0);
+
+            Model::WorldNode map(Model::Entity(), Model::MapFormat::Standard);
+
+            Model::BrushBuilder builder(map.mapFormat(), worldBounds);
+            Model::BrushNode* brushNode = new Model::BrushNode(builder.createCube(64.0, "none").value());
+            map.defaultLayer()->addChild(brushNode);
+
+            const auto write = [&](NodeSerializationCache* cache) {
+                std::stringstream str;
+                NodeWriter writer(map, str, cache);
+                writer.writeMap();
+                return str.str();
+            };
+
+            const auto expected = write(nullptr);
+
+            auto cache = NodeSerializationCache{};
+            CHECK(write(&cache) == expected);
+            CHECK(cache.size() == 1u);
+            CHECK(write(&cache) == expected);
+
+            // a cached node is not serialized again
+            cache.insert(brushNode, SerializedNode{"cached\n", 1u});
+            CHECK_THAT(write(&cache), Catch::Contains("cached\n"));
+
+            cache.invalidate({brushNode});
+            CHECK(cache.size() == 0u);
+            CHECK(write(&cache) == expected);
+
+            cache.invalidateRecursively({map.defaultLayer()});
+            CHECK(cache.size() == 0u);
+
+            // changing the format clears the cache
+            write(&cache);
+            cache.setFormat(Model::MapFormat::Valve);
+            CHECK(cache.size() == 0u);
+        }
     }
 }
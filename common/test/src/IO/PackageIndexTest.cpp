@@ -0,0 +1,127 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/PackageIndex.h"
+#include "IO/Reader.h"
+#include "IO/TestEnvironment.h"
+#include "IO/ZipFileSystem.h"
+
+#include <kdl/vector_utils.h>
+
+#include <string>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        static std::vector<std::string> entryNames(const std::vector<ZipFileSystem::Entry>& entries) {
+            return kdl::vec_transform(entries, [](const auto& entry) { return entry.name; });
+        }
+
+        TEST_CASE("PackageIndexTest.recordAndReadEntries", "[PackageIndexTest]") {
+            TestEnvironment env("package_index_test");
+            const auto zipPath = env.dir() + Path("stored_test.zip");
+            const auto indexPath = env.dir() + Path("package_index.bin");
+            Disk::copyFile(Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Zip/stored_test.zip"), zipPath, false);
+
+            const auto scannedFS = ZipFileSystem(zipPath);
+            const auto scannedEntries = scannedFS.entries();
+            REQUIRE(scannedEntries.size() == 2u);
+
+            {
+                auto index = PackageIndex{};
+                CHECK(index.entries(zipPath) == std::nullopt);
+
+                index.setEntries(zipPath, scannedEntries);
+                CHECK(index.modified());
+                index.write(indexPath);
+            }
+
+            auto index = PackageIndex::read(indexPath);
+            CHECK_FALSE(index.modified());
+
+            const auto indexedEntries = index.entries(zipPath);
+            REQUIRE(indexedEntries.has_value());
+            CHECK(entryNames(*indexedEntries) == entryNames(scannedEntries));
+
+            // the recorded entries can be used instead of reading the archive's directory
+            const auto indexedFS = ZipFileSystem(nullptr, zipPath, *indexedEntries);
+            const auto file = indexedFS.openFile(Path("deflated.txt"));
+            const auto expected = scannedFS.openFile(Path("deflated.txt"));
+            CHECK(std::string{file->reader().buffer().stringView()} == std::string{expected->reader().buffer().stringView()});
+        }
+
+        TEST_CASE("PackageIndexTest.keepUnusedRecords", "[PackageIndexTest]") {
+            TestEnvironment env("package_index_test");
+            const auto zipPath1 = env.dir() + Path("stored_test1.zip");
+            const auto zipPath2 = env.dir() + Path("stored_test2.zip");
+            const auto indexPath = env.dir() + Path("package_index.bin");
+            Disk::copyFile(Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Zip/stored_test.zip"), zipPath1, false);
+            Disk::copyFile(Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Zip/stored_test.zip"), zipPath2, false);
+
+            {
+                auto index = PackageIndex{};
+                index.setEntries(zipPath1, ZipFileSystem(zipPath1).entries());
+                index.setEntries(zipPath2, ZipFileSystem(zipPath2).entries());
+                index.write(indexPath);
+            }
+
+            {
+                // e.g. another game only uses one of the packages
+                auto index = PackageIndex::read(indexPath);
+                CHECK(index.recordCount() == 2u);
+                CHECK(index.entries(zipPath1).has_value());
+                CHECK_FALSE(index.modified());
+
+                index.setEntries(zipPath1, ZipFileSystem(zipPath1).entries());
+                REQUIRE(index.modified());
+                index.write(indexPath);
+            }
+
+            auto index = PackageIndex::read(indexPath);
+            CHECK(index.recordCount() == 2u);
+            CHECK(index.entries(zipPath2).has_value());
+        }
+
+        TEST_CASE("PackageIndexTest.ignoreChangedPackage", "[PackageIndexTest]") {
+            TestEnvironment env("package_index_test");
+            const auto zipPath = env.dir() + Path("stored_test.zip");
+            Disk::copyFile(Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Zip/stored_test.zip"), zipPath, false);
+
+            auto index = PackageIndex{};
+            index.setEntries(zipPath, ZipFileSystem(zipPath).entries());
+            REQUIRE(index.entries(zipPath).has_value());
+
+            env.createFile(Path("stored_test.zip"), "not an archive anymore");
+            CHECK(index.entries(zipPath) == std::nullopt);
+        }
+
+        TEST_CASE("PackageIndexTest.readMalformedIndex", "[PackageIndexTest]") {
+            TestEnvironment env("package_index_test");
+            env.createFile(Path("package_index.bin"), "garbage");
+
+            auto index = PackageIndex::read(env.dir() + Path("package_index.bin"));
+            CHECK(index.entries(env.dir() + Path("some.pk3")) == std::nullopt);
+            CHECK_FALSE(index.modified());
+        }
+    }
+}
@@ -0,0 +1,150 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Color.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/DiskIO.h"
+#include "IO/FreeImageTextureReader.h"
+#include "IO/Path.h"
+#include "IO/TestEnvironment.h"
+#include "IO/TextureCache.h"
+#include "IO/TextureReader.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include "TestLogger.h"
+#include "TestUtils.h"
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        static Assets::Texture makeTexture(const std::string& name) {
+            auto buffers = Assets::TextureBufferList{};
+            Assets::setMipBufferSize(buffers, 2u, 4u, 2u, GL_RGBA);
+            for (auto& buffer : buffers) {
+                for (size_t i = 0u; i < buffer.size(); ++i) {
+                    buffer.data()[i] = static_cast<unsigned char>(i);
+                }
+            }
+            return Assets::Texture(name, 4u, 2u, Color(0.25f, 0.5f, 0.75f, 1.0f), std::move(buffers), GL_RGBA, Assets::TextureType::Masked);
+        }
+
+        static bool equalBuffers(const Assets::TextureBuffer& lhs, const Assets::TextureBuffer& rhs) {
+            return lhs.size() == rhs.size() && std::equal(lhs.data(), lhs.data() + lhs.size(), rhs.data());
+        }
+
+        TEST_CASE("TextureCacheTest.computeKey", "[TextureCacheTest]") {
+            const auto data1 = std::string("some texture data");
+            const auto data2 = std::string("some texture date");
+
+            CHECK(TextureCache::computeKey(data1.data(), data1.data() + data1.size()) == TextureCache::computeKey(data1.data(), data1.data() + data1.size()));
+            CHECK(TextureCache::computeKey(data1.data(), data1.data() + data1.size()) != TextureCache::computeKey(data2.data(), data2.data() + data2.size()));
+        }
+
+        TEST_CASE("TextureCacheTest.writeAndReadTexture", "[TextureCacheTest]") {
+            TestEnvironment env("texture_cache_test");
+            const auto cache = TextureCache(env.dir() + Path("cache"));
+
+            const auto original = makeTexture("original");
+            cache.writeTexture(1234u, 56u, original);
+
+            SECTION("Reading an existing entry") {
+                const auto cached = cache.readTexture(1234u, 56u, "cached");
+                REQUIRE(cached.has_value());
+
+                CHECK(cached->name() == "cached");
+                CHECK(cached->width() == original.width());
+                CHECK(cached->height() == original.height());
+                CHECK(cached->format() == original.format());
+                CHECK(cached->type() == original.type());
+                CHECK(cached->averageColor() == original.averageColor());
+
+                const auto& cachedBuffers = cached->buffersIfUnprepared();
+                const auto& originalBuffers = original.buffersIfUnprepared();
+                REQUIRE(cachedBuffers.size() == originalBuffers.size());
+                for (size_t i = 0u; i < cachedBuffers.size(); ++i) {
+                    CHECK(equalBuffers(cachedBuffers[i], originalBuffers[i]));
+                }
+            }
+
+            SECTION("Reading a missing entry") {
+                CHECK_FALSE(cache.readTexture(4321u, 56u, "cached").has_value());
+            }
+
+            SECTION("Reading an entry for data of a different size") {
+                CHECK_FALSE(cache.readTexture(1234u, 57u, "cached").has_value());
+            }
+
+            SECTION("Reading a corrupt entry") {
+                env.createFile(Path("cache/0000000000000063.tex"), "TBTC");
+                CHECK_FALSE(cache.readTexture(99u, 56u, "cached").has_value());
+            }
+        }
+
+        TEST_CASE("TextureCacheTest.evictEntries", "[TextureCacheTest]") {
+            TestEnvironment env("texture_cache_test");
+
+            // determine the size of an entry
+            const auto entrySize = [&]() {
+                const auto cache = TextureCache(env.dir() + Path("sizes"));
+                cache.writeTexture(1u, 56u, makeTexture("texture"));
+                return Disk::openFile(env.dir() + Path("sizes/0000000000000001.tex"))->size();
+            }();
+
+            const auto cache = TextureCache(env.dir() + Path("cache"), 2u * entrySize + entrySize / 2u);
+            cache.writeTexture(1u, 56u, makeTexture("texture1"));
+            cache.writeTexture(2u, 56u, makeTexture("texture2"));
+            CHECK(Disk::getDirectoryContents(cache.directory()).size() == 2u);
+
+            cache.writeTexture(3u, 56u, makeTexture("texture3"));
+            CHECK(Disk::getDirectoryContents(cache.directory()).size() == 2u);
+
+            // the entry that was written last is never evicted
+            CHECK(cache.readTexture(3u, 56u, "texture3").has_value());
+        }
+
+        TEST_CASE("TextureCacheTest.freeImageTextureReader", "[TextureCacheTest]") {
+            TestEnvironment env("texture_cache_test");
+            auto cache = std::make_shared<TextureCache>(env.dir() + Path("cache"));
+
+            const auto imagePath = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Image/");
+            DiskFileSystem diskFS(imagePath);
+
+            TextureReader::TextureNameStrategy nameStrategy;
+            NullLogger logger;
+            FreeImageTextureReader textureReader(nameStrategy, diskFS, logger);
+            textureReader.setCache(cache);
+
+            const auto decoded = textureReader.readTexture(diskFS.openFile(Path("pngContentsTest.png")));
+            REQUIRE(Disk::getDirectoryContents(cache->directory()).size() == 1u);
+
+            const auto cached = textureReader.readTexture(diskFS.openFile(Path("pngContentsTest.png")));
+            CHECK(cached.name() == decoded.name());
+            CHECK(cached.averageColor() == decoded.averageColor());
+            REQUIRE(cached.buffersIfUnprepared().size() == 1u);
+            CHECK(equalBuffers(cached.buffersIfUnprepared().front(), decoded.buffersIfUnprepared().front()));
+            checkColor(cached, 0, 0, 255, 0, 0, 255, ColorMatch::Exact);
+        }
+    }
+}
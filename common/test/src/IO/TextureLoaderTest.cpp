@@ -26,7 +26,10 @@
 #include "IO/TextureLoader.h"
 #include "Model/GameConfig.h"
 
+#include <chrono>
+#include <memory>
 #include <string>
+#include <thread>
 
 #include "Catch2.h"
 
@@ -144,5 +147,48 @@ namespace TrenchBroom {
                 CHECK(texture->height() == height);
             }
         }
+
+        TEST_CASE("TextureLoaderTest.testLoadAsync", "[TextureLoaderTest]") {
+            const std::vector<IO::Path> paths({ Path("fixture/test/IO/Wad/cr8_czg.wad") });
+
+            const IO::Path root = IO::Disk::getCurrentWorkingDir();
+            const std::vector<IO::Path> fileSearchPaths{ root };
+            const IO::DiskFileSystem fileSystem(root, true);
+
+            const Model::TextureConfig textureConfig(
+                Model::TexturePackageConfig(
+                    Model::PackageFormatConfig("wad", "idmip")),
+                    Model::PackageFormatConfig("D", "idmip"),
+                    IO::Path("fixture/test/palette.lmp"),
+                    "wad",
+                    IO::Path(),
+                    {});
+
+            auto logger = NullLogger();
+            auto textureManager = Assets::TextureManager(0, 0, logger);
+
+            auto textureLoader = std::make_shared<IO::TextureLoader>(fileSystem, fileSearchPaths, textureConfig, textureManager.backgroundLogger());
+            textureManager.setTextureCollectionsAsync(paths, std::move(textureLoader));
+
+            // the collection is represented by a placeholder until it has been collected
+            REQUIRE(textureManager.collections().size() == 1u);
+            CHECK(textureManager.collections().front().path() == paths.front());
+
+            using namespace std::chrono_literals;
+            const auto startTime = std::chrono::steady_clock::now();
+            while (textureManager.hasPendingCollections() && std::chrono::steady_clock::now() - startTime < 10s) {
+                textureManager.collectLoadedCollections();
+                std::this_thread::sleep_for(1ms);
+            }
+
+            CHECK_FALSE(textureManager.hasPendingCollections());
+            CHECK(textureManager.collections().front().loaded());
+            CHECK(textureManager.textures().size() == 21u);
+
+            const auto* texture = textureManager.texture("cr8_czg_3");
+            REQUIRE(texture != nullptr);
+            CHECK(texture->width() == 64u);
+            CHECK(texture->height() == 128u);
+        }
     }
 }
@@ -1151,6 +1151,91 @@ common/caulk
             CHECK_NOTHROW(reader.read(worldBounds, status));
         }
 
+        TEST_CASE("WorldReaderTest.parseDuplicateEntityProperties", "[WorldReaderTest]") {
+            const std::string data(R"(
+{
+"classname" "worldspawn"
+"message" "first"
+"message" "second"
+"wad" "some.wad"
+})");
+
+            const vm::bbox3 worldBounds(8192.0);
+
+            IO::TestParserStatus status;
+            WorldReader reader(data, Model::MapFormat::Standard);
+
+            auto worldNode = reader.read(worldBounds, status);
+            REQUIRE(worldNode != nullptr);
+            CHECK(*worldNode->entity().property("message") == "first");
+            CHECK(*worldNode->entity().property("wad") == "some.wad");
+            CHECK(status.countStatus(LogLevel::Warn) == 1u);
+        }
+
+        TEST_CASE("WorldReaderTest.parseLargeMapInChunks", "[WorldReaderTest]") {
+            // large enough to be split into chunks that are parsed in parallel
+            const auto entityCount = size_t(5000);
+
+            std::string data = R"({
+"classname" "worldspawn"
+}
+)";
+            for (size_t i = 0u; i < entityCount; ++i) {
+                data += fmt::format(R"({{
+"classname" "func_detail"
+"index" "{0}"
+{{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) tex{0} 0 0 0 1 1
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) tex{0} 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) tex{0} 0 0 0 1 1
+( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) tex{0} 0 0 0 1 1
+( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) tex{0} 0 0 0 1 1
+( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) tex{0} 0 0 0 1 1
+}}
+}}
+)", i);
+            }
+
+            // a duplicate property in the last entity must be reported exactly once
+            data += R"({
+"classname" "info_null"
+"message" "first"
+"message" "second"
+}
+)";
+
+            const vm::bbox3 worldBounds(8192.0);
+
+            IO::TestParserStatus status;
+            WorldReader reader(data, Model::MapFormat::Standard);
+
+            auto world = reader.read(worldBounds, status);
+            REQUIRE(world != nullptr);
+            CHECK(status.countStatus(LogLevel::Warn) == 1u);
+
+            const auto* defaultLayer = world->defaultLayer();
+            REQUIRE(defaultLayer->childCount() == entityCount + 1u);
+
+            // every entity occupies 12 lines, the worldspawn entity occupies 3 lines
+            for (size_t i = 0u; i < entityCount; ++i) {
+                const auto* entityNode = dynamic_cast<const Model::EntityNode*>(defaultLayer->children()[i]);
+                REQUIRE(entityNode != nullptr);
+                CHECK(*entityNode->entity().property("index") == std::to_string(i));
+                CHECK(entityNode->lineNumber() == 4u + 12u * i);
+
+                REQUIRE(entityNode->childCount() == 1u);
+                const auto* brushNode = dynamic_cast<const Model::BrushNode*>(entityNode->children().front());
+                REQUIRE(brushNode != nullptr);
+                CHECK(brushNode->lineNumber() == 7u + 12u * i);
+                CHECK(brushNode->brush().face(0u).attributes().textureName() == "tex" + std::to_string(i));
+            }
+
+            const auto* lastEntityNode = dynamic_cast<const Model::EntityNode*>(defaultLayer->children().back());
+            REQUIRE(lastEntityNode != nullptr);
+            CHECK(*lastEntityNode->entity().property("message") == "first");
+            CHECK(lastEntityNode->lineNumber() == 4u + 12u * entityCount);
+        }
+
         TEST_CASE("WorldReaderTest.parseEscapedDoubleQuotationMarks", "[WorldReaderTest]") {
             const std::string data(R"(
 {
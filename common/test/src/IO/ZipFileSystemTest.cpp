@@ -20,11 +20,14 @@
 #include "Exceptions.h"
 #include "IO/DiskIO.h"
 #include "IO/DiskFileSystem.h"
+#include "IO/File.h"
 #include "IO/FileMatcher.h"
+#include "IO/Reader.h"
 #include "IO/ZipFileSystem.h"
 
 #include <algorithm>
 #include <cassert>
+#include <string>
 
 #include "Catch2.h"
 
@@ -51,6 +54,7 @@ namespace TrenchBroom {
 
             CHECK(fs.fileExists(Path("pics/tag1.pcx")));
             CHECK(fs.fileExists(Path("PICS/TAG1.pcX")));
+            CHECK(fs.fileExists(Path("textures/../PICS/TAG1.pcX")));
         }
 
         TEST_CASE("ZipFileSystemTest.findItems", "[ZipFileSystemTest]") {
@@ -139,5 +143,31 @@ namespace TrenchBroom {
 
             CHECK(fs.openFile(Path("amnet.cfg")) != nullptr);
         }
+
+        TEST_CASE("ZipFileSystemTest.openStoredAndCompressedFiles", "[ZipFileSystemTest]") {
+            const Path zipPath = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Zip/stored_test.zip");
+
+            ZipFileSystem fs(zipPath);
+
+            const auto storedFile = fs.openFile(Path("stored.txt"));
+            CHECK(std::string{storedFile->reader().buffer().stringView()} == "This file is stored without compression.\n");
+
+            auto expected = std::string{};
+            for (size_t i = 0u; i < 8u; ++i) {
+                expected += "This file is compressed. ";
+            }
+            expected += "\n";
+
+            const auto compressedFile = fs.openFile(Path("deflated.txt"));
+            CHECK(std::string{compressedFile->reader().buffer().stringView()} == expected);
+
+            // decompressed files are cached
+            CHECK(fs.openFile(Path("deflated.txt")) == compressedFile);
+
+            fs.setCacheCapacity(0u);
+            const auto uncachedFile = fs.openFile(Path("deflated.txt"));
+            CHECK(uncachedFile != compressedFile);
+            CHECK(std::string{uncachedFile->reader().buffer().stringView()} == expected);
+        }
     }
 }
@@ -44,6 +44,7 @@
 #include <vecmath/vec.h>
 #include <vecmath/mat.h>
 #include <vecmath/mat_ext.h>
+#include <vecmath/polygon.h>
 
 #include <memory>
 #include <vector>
@@ -137,6 +138,26 @@ namespace TrenchBroom {
             CHECK(face.projectedArea(vm::axis::z) == vm::approx{0.0});
         }
 
+        TEST_CASE("BrushFaceTest.vertexPositions", "[BrushFaceTest]") {
+            const auto worldBounds = vm::bbox3{8192.0};
+            const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+            auto brush = builder.createCuboid(vm::bbox3(vm::vec3(-64, -64, -64), vm::vec3(64, 64, 64)), "texture").value();
+            for (const auto& face : brush.faces()) {
+                CHECK(face.vertexPositions() == face.geometry()->vertexPositions());
+            }
+
+            // the cached positions must follow the geometry when it is rebuilt
+            REQUIRE(brush.transform(worldBounds, vm::translation_matrix(vm::vec3(16, 0, 0)), false).is_success());
+            const auto copy = brush;
+            for (size_t i = 0u; i < brush.faceCount(); ++i) {
+                const auto& face = brush.face(i);
+                CHECK(face.vertexPositions() == face.geometry()->vertexPositions());
+                CHECK(copy.face(i).vertexPositions() == face.vertexPositions());
+                CHECK(face.polygon() == vm::polygon3(face.geometry()->vertexPositions()));
+            }
+        }
+
         static void getFaceVertsAndTexCoords(const BrushFace& face,
                                              std::vector<vm::vec3> *vertPositions,
                                              std::vector<vm::vec2f> *vertTexCoords) {
@@ -537,6 +558,35 @@ namespace TrenchBroom {
             checkTextureLockOffWithScale(cube);
         }
 
+        TEST_CASE("BrushFaceTest.textureLockTranslationKeepsScaleAndRotation", "[BrushFaceTest]") {
+            const vm::bbox3 worldBounds(8192.0);
+            Assets::Texture texture("testTexture", 64, 64);
+
+            const auto mapFormat = GENERATE(MapFormat::Standard, MapFormat::Valve);
+
+            BrushBuilder builder(mapFormat, worldBounds);
+            Brush cube = builder.createCube(128.0, "").value();
+
+            for (auto& face : cube.faces()) {
+                face.setTexture(&texture);
+
+                auto attributes = face.attributes();
+                attributes.setScale(vm::vec2f(0.5f, -2.0f));
+                attributes.setRotation(30.0f);
+                face.setAttributes(attributes);
+
+                const auto origFace = face;
+                checkTextureLockOnWithTransform(vm::translation_matrix(vm::vec3(13.0, -7.0, 100.0)), origFace);
+
+                auto transformedFace = origFace;
+                REQUIRE(transformedFace.transform(vm::translation_matrix(vm::vec3(13.0, -7.0, 100.0)), true));
+                CHECK(transformedFace.attributes().scale() == origFace.attributes().scale());
+                CHECK(transformedFace.attributes().rotation() == origFace.attributes().rotation());
+                CHECK(transformedFace.textureXAxis() == vm::approx(origFace.textureXAxis()));
+                CHECK(transformedFace.textureYAxis() == vm::approx(origFace.textureYAxis()));
+            }
+        }
+
         // https://github.com/TrenchBroom/TrenchBroom/issues/2001
         TEST_CASE("BrushFaceTest.testValveRotation", "[BrushFaceTest]") {
             const std::string data("{\n"
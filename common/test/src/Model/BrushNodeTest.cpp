@@ -47,6 +47,7 @@
 #include <vecmath/polygon.h>
 #include <vecmath/ray.h>
 
+#include <cmath>
 #include <memory>
 #include <string>
 #include <vector>
@@ -68,6 +69,25 @@ namespace TrenchBroom {
             CHECK(brushNode->entity() == &entityNode);
         }
 
+        TEST_CASE("BrushNodeTest.setFaceTexture", "[BrushNodeTest]") {
+            const auto worldBounds = vm::bbox3{4096.0};
+
+            auto texture = Assets::Texture{"testure", 16u, 16u};
+            auto brushNode = BrushNode{BrushBuilder{MapFormat::Quake3, worldBounds}.createCube(64.0, "testure").value()};
+
+            CHECK(brushNode.setFaceTexture(0u, &texture));
+            CHECK(brushNode.brush().face(0u).texture() == &texture);
+            CHECK(texture.usageCount() == 1u);
+
+            // assigning the same texture again does not change anything
+            CHECK_FALSE(brushNode.setFaceTexture(0u, &texture));
+            CHECK(texture.usageCount() == 1u);
+
+            CHECK(brushNode.setFaceTexture(0u, nullptr));
+            CHECK(texture.usageCount() == 0u);
+            CHECK_FALSE(brushNode.setFaceTexture(0u, nullptr));
+        }
+
         TEST_CASE("BrushNodeTest.hasSelectedFaces", "[BrushNodeTest]") {
             const vm::bbox3 worldBounds(4096.0);
             
@@ -279,6 +299,25 @@ namespace TrenchBroom {
             PickResult hits2;
             brush.pick(editorContext, vm::ray3(vm::vec3(8.0, -8.0, 8.0), vm::vec3::neg_y()), hits2);
             CHECK(hits2.empty());
+
+            // a ray that starts inside of the brush does not hit any face from the front
+            PickResult hits3;
+            brush.pick(editorContext, vm::ray3(vm::vec3(8.0, 8.0, 8.0), vm::vec3::pos_y()), hits3);
+            CHECK(hits3.empty());
+
+            // a ray that is parallel to a face and passes above it
+            PickResult hits4;
+            brush.pick(editorContext, vm::ray3(vm::vec3(8.0, -8.0, 17.0), vm::vec3::pos_y()), hits4);
+            CHECK(hits4.empty());
+
+            // a diagonal ray that enters the brush through the top face
+            PickResult hits5;
+            brush.pick(editorContext, vm::ray3(vm::vec3(4.0, 8.0, 20.0), vm::normalize(vm::vec3(1.0, 0.0, -1.0))), hits5);
+            CHECK(hits5.size() == 1u);
+
+            Hit hit5 = hits5.all().front();
+            CHECK(hit5.distance() == vm::approx(std::sqrt(32.0)));
+            CHECK(hitToFaceHandle(hit5)->face().boundary().normal == vm::vec3::pos_z());
         }
 
         TEST_CASE("BrushNodeTest.clone", "[BrushNodeTest]") {
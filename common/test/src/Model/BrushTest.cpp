@@ -39,6 +39,8 @@
 #include <kdl/vector_utils.h>
 
 #include <vecmath/approx.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
 #include <vecmath/polygon.h>
 #include <vecmath/ray.h>
 #include <vecmath/segment.h>
@@ -113,6 +115,36 @@ namespace TrenchBroom {
             CHECK(brush.findFace(vm::vec3::neg_z()));
         }
 
+        TEST_CASE("BrushTest.constructAxisAlignedCuboid", "[BrushTest]") {
+            const vm::bbox3 worldBounds(64.0);
+            const BrushBuilder builder(MapFormat::Standard, worldBounds);
+
+            const auto bounds = vm::bbox3(vm::vec3(-16, -8, 0), vm::vec3(32, 8, 16));
+            const Brush brush = builder.createCuboid(bounds, "texture").value();
+
+            const auto expectedVerticesArray = bounds.vertices();
+            const auto expectedVertices = std::vector<vm::vec3>(std::begin(expectedVerticesArray), std::end(expectedVerticesArray));
+
+            CHECK(brush.bounds() == bounds);
+            CHECK_THAT(brush.vertexPositions(), Catch::UnorderedEquals(expectedVertices));
+            CHECK(brush.edgeCount() == 12u);
+
+            REQUIRE(brush.faceCount() == 6u);
+            const auto expectedNormals = std::vector<vm::vec3>{
+                vm::vec3::neg_x(), vm::vec3::neg_y(), vm::vec3::neg_z(),
+                vm::vec3::pos_z(), vm::vec3::pos_y(), vm::vec3::pos_x()
+            };
+            for (size_t i = 0u; i < brush.faceCount(); ++i) {
+                const auto& face = brush.face(i);
+                CHECK(face.boundary().normal == expectedNormals[i]);
+                CHECK(face.geometry()->payload() == i);
+            }
+
+            // cuboids which touch or exceed the world bounds are not built directly and fail as before
+            CHECK(builder.createCuboid(vm::bbox3(vm::vec3(-64, -8, 0), vm::vec3(32, 8, 16)), "texture").is_error());
+            CHECK(builder.createCuboid(vm::bbox3(vm::vec3(-16, -8, 0), vm::vec3(32, 8, 128)), "texture").is_error());
+        }
+
         TEST_CASE("BrushTest.constructBrushWithRedundantFaces", "[BrushTest]") {
             const vm::bbox3 worldBounds(4096.0);
 
@@ -132,6 +164,47 @@ namespace TrenchBroom {
             }).is_error());
         }
 
+        TEST_CASE("BrushTest.copySharesGeometry", "[BrushTest]") {
+            const vm::bbox3 worldBounds(4096.0);
+
+            BrushBuilder builder(MapFormat::Standard, worldBounds);
+            const Brush original = builder.createCube(64.0, "left", "right", "front", "back", "top", "bottom").value();
+
+            Brush copy = original;
+            REQUIRE(copy.faceCount() == original.faceCount());
+            for (size_t i = 0u; i < copy.faceCount(); ++i) {
+                CHECK(copy.face(i).geometry() == original.face(i).geometry());
+            }
+
+            // changing the copy's geometry must not affect the original
+            REQUIRE(copy.transform(worldBounds, vm::translation_matrix(vm::vec3(16.0, 0.0, 0.0)), false).is_success());
+            CHECK(copy.bounds() == vm::bbox3(vm::vec3(-16.0, -32.0, -32.0), vm::vec3(48.0, 32.0, 32.0)));
+            CHECK(original.bounds() == vm::bbox3(32.0));
+            for (size_t i = 0u; i < copy.faceCount(); ++i) {
+                CHECK(copy.face(i).geometry() != original.face(i).geometry());
+            }
+        }
+
+        TEST_CASE("BrushTest.containsBounds", "[BrushTest]") {
+            const vm::bbox3 worldBounds(4096.0);
+
+            // a pyramid with a square base and its apex above the center of the base
+            const BrushBuilder builder(MapFormat::Standard, worldBounds);
+            const Brush brush = builder.createBrush(std::vector<vm::vec3>{
+                vm::vec3(-32.0, -32.0, 0.0),
+                vm::vec3( 32.0, -32.0, 0.0),
+                vm::vec3( 32.0,  32.0, 0.0),
+                vm::vec3(-32.0,  32.0, 0.0),
+                vm::vec3(  0.0,   0.0, 32.0),
+            }, "texture").value();
+
+            CHECK(brush.contains(vm::bbox3(vm::vec3(-8.0, -8.0, 0.0), vm::vec3(8.0, 8.0, 8.0))));
+            CHECK(brush.contains(vm::bbox3(vm::vec3(-32.0, -32.0, 0.0), vm::vec3(32.0, 32.0, 0.0))));
+            CHECK_FALSE(brush.contains(vm::bbox3(vm::vec3(16.0, 16.0, 16.0), vm::vec3(24.0, 24.0, 24.0))));
+            CHECK_FALSE(brush.contains(vm::bbox3(vm::vec3(-8.0, -8.0, 0.0), vm::vec3(8.0, 8.0, 30.0))));
+            CHECK_FALSE(brush.contains(vm::bbox3(vm::vec3(-8.0, -8.0, -1.0), vm::vec3(8.0, 8.0, 8.0))));
+        }
+
         TEST_CASE("BrushTest.clip", "[BrushTest]") {
             const vm::bbox3 worldBounds(4096.0);
 
@@ -307,6 +380,40 @@ namespace TrenchBroom {
             assertTexture("bottom", brush, p1, p3, p7, p5);
         }
 
+        TEST_CASE("BrushTest.moveVerticesIfPossible", "[BrushTest]") {
+            const vm::bbox3 worldBounds(4096.0);
+
+            BrushBuilder builder(MapFormat::Standard, worldBounds);
+            const Brush original = builder.createCube(64.0, "left", "right", "front", "back", "top", "bottom").value();
+
+            const vm::vec3 p8(+32.0, +32.0, +32.0);
+            const vm::vec3 p9(+16.0, +16.0, +32.0);
+
+            SECTION("Accepted move") {
+                Brush expected = original;
+                REQUIRE(expected.canMoveVertices(worldBounds, {p8}, p9 - p8));
+                REQUIRE(expected.moveVertices(worldBounds, {p8}, p9 - p8).is_success());
+
+                Brush brush = original;
+                const auto result = brush.moveVerticesIfPossible(worldBounds, {p8}, p9 - p8);
+                REQUIRE(result.is_success());
+                CHECK(result.value());
+                CHECK(brush == expected);
+            }
+
+            SECTION("Rejected move") {
+                // moving a vertex out of the world bounds is rejected and leaves the brush unchanged
+                const auto delta = vm::vec3(0.0, 0.0, 8192.0);
+                REQUIRE_FALSE(original.canMoveVertices(worldBounds, {p8}, delta));
+
+                Brush brush = original;
+                const auto result = brush.moveVerticesIfPossible(worldBounds, {p8}, delta);
+                REQUIRE(result.is_success());
+                CHECK_FALSE(result.value());
+                CHECK(brush == original);
+            }
+        }
+
         TEST_CASE("BrushTest.moveTetrahedronVertexToOpposideSide", "[BrushTest]") {
             const vm::bbox3 worldBounds(4096.0);
 
@@ -230,5 +230,49 @@ namespace TrenchBroom {
             CHECK_THAT(index.allValuesForKeys(EntityNodeIndexQuery::exact("test")), 
                 Catch::UnorderedEquals(std::vector<std::string>{ "somevalue", "somevalue2" }));
         }
+
+        TEST_CASE("EntityNodeIndexTest.findEntityNodesWithValueQuery", "[EntityNodeIndexTest]") {
+            EntityNodeIndex index;
+
+            EntityNode* entity1 = new EntityNode({
+                {"targetname", "door1"}
+            });
+
+            EntityNode* entity2 = new EntityNode({
+                {"targetname", "door2"},
+                {"target", "light1"}
+            });
+
+            EntityNode* entity3 = new EntityNode({
+                {"target1", "door1"},
+                {"target2", "door2"}
+            });
+
+            index.addEntityNode(entity1);
+            index.addEntityNode(entity2);
+            index.addEntityNode(entity3);
+
+            using Catch::UnorderedEquals;
+            using Nodes = std::vector<EntityNodeBase*>;
+
+            CHECK_THAT(index.findEntityNodes(EntityNodeIndexQuery::exact("targetname"), EntityNodeIndexQuery::prefix("door")),
+                UnorderedEquals(Nodes{ entity1, entity2 }));
+            CHECK_THAT(index.findEntityNodes(EntityNodeIndexQuery::exact("targetname"), EntityNodeIndexQuery::wildcard("*2")),
+                UnorderedEquals(Nodes{ entity2 }));
+            CHECK_THAT(index.findEntityNodes(EntityNodeIndexQuery::numbered("target"), EntityNodeIndexQuery::wildcard("door%")),
+                UnorderedEquals(Nodes{ entity3 }));
+            CHECK_THAT(index.findEntityNodes(EntityNodeIndexQuery::wildcard("target?"), EntityNodeIndexQuery::exact("door2")),
+                UnorderedEquals(Nodes{ entity3 }));
+            CHECK_THAT(index.findEntityNodes(EntityNodeIndexQuery::numbered("target"), EntityNodeIndexQuery::any()),
+                UnorderedEquals(Nodes{ entity2, entity3 }));
+            CHECK(index.findEntityNodes(EntityNodeIndexQuery::exact("target"), EntityNodeIndexQuery::prefix("door")).empty());
+
+            CHECK(index.countEntityNodes(EntityNodeIndexQuery::any(), EntityNodeIndexQuery::prefix("door")) == 3u);
+            CHECK(index.countEntityNodes(EntityNodeIndexQuery::exact("targetname"), EntityNodeIndexQuery::exact("light1")) == 0u);
+
+            delete entity1;
+            delete entity2;
+            delete entity3;
+        }
     }
 }
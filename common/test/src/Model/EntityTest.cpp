@@ -77,6 +77,20 @@ namespace TrenchBroom {
             }
         }
 
+        TEST_CASE("EntityTest.propertyKeysAreShared") {
+            const auto property1 = EntityProperty{"some_rather_long_property_key", "value1"};
+            const auto property2 = EntityProperty{std::string{"some_rather_long_property_key"}, "value2"};
+            CHECK(&property1.key() == &property2.key());
+            CHECK(property1 != property2);
+
+            auto property3 = EntityProperty{"other_key", "value1"};
+            CHECK(property3 < property1);
+
+            property3.setKey("some_rather_long_property_key");
+            CHECK(&property3.key() == &property1.key());
+            CHECK(property3 == property1);
+        }
+
         TEST_CASE("EntityTest.renameProperty") {
             Entity entity;
 
@@ -279,6 +293,41 @@ namespace TrenchBroom {
             }
         }
 
+        TEST_CASE("EntityTest.modelTransformation") {
+            Entity entity;
+            entity.addOrUpdateProperty(PropertyKeys::Classname, "some_class");
+            entity.addOrUpdateProperty(PropertyKeys::Origin, "1 2 3");
+            REQUIRE(entity.modelTransformation() == vm::translation_matrix(vm::vec3(1, 2, 3)));
+
+            SECTION("Updates cached model transformation when the angle changes") {
+                entity.addOrUpdateProperty(PropertyKeys::Angle, "90");
+                CHECK(entity.rotation() != vm::mat4x4::identity());
+                CHECK(entity.modelTransformation() == vm::translation_matrix(vm::vec3(1, 2, 3)) * entity.rotation());
+
+                entity.removeProperty(PropertyKeys::Angle);
+                CHECK(entity.modelTransformation() == vm::translation_matrix(vm::vec3(1, 2, 3)));
+            }
+
+            SECTION("Updates cached model transformation when the origin changes") {
+                entity.setOrigin(vm::vec3(3, 4, 5));
+                CHECK(entity.modelTransformation() == vm::translation_matrix(vm::vec3(3, 4, 5)));
+            }
+
+            SECTION("Keeps cached model transformation when other properties change") {
+                entity.addOrUpdateProperty("some_key", "some_value");
+                entity.renameProperty("some_key", "other_key");
+                entity.removeProperty("other_key");
+                CHECK(entity.modelTransformation() == vm::translation_matrix(vm::vec3(1, 2, 3)));
+            }
+
+            SECTION("Updates cached model transformation when a property is renamed to angle") {
+                entity.addOrUpdateProperty("some_key", "90");
+                entity.renameProperty("some_key", PropertyKeys::Angle);
+                CHECK(entity.rotation() != vm::mat4x4::identity());
+                CHECK(entity.modelTransformation() == vm::translation_matrix(vm::vec3(1, 2, 3)) * entity.rotation());
+            }
+        }
+
         TEST_CASE("EntityTest.requiresClassnameForRotation") {
             Entity entity;
             REQUIRE(entity.rotation() == vm::mat4x4::identity());
@@ -29,6 +29,7 @@
 #include "Model/GroupNode.h"
 #include "Model/Layer.h"
 #include "Model/LayerNode.h"
+#include "Model/NodeContents.h"
 #include "Model/PatchNode.h"
 #include "Model/UpdateLinkedGroupsError.h"
 #include "Model/WorldNode.h"
@@ -393,6 +394,56 @@ namespace TrenchBroom {
             ));
         }
 
+        TEST_CASE("GroupNodeTest.updateLinkedGroupContents", "[GroupNodeTest]") {
+            const auto worldBounds = vm::bbox3(8192.0);
+
+            auto groupNode = GroupNode{Group{"name"}};
+            auto* entityNode1 = new EntityNode{};
+            auto* entityNode2 = new EntityNode{};
+            groupNode.addChild(entityNode1);
+            groupNode.addChild(entityNode2);
+
+            auto groupNodeClone = std::unique_ptr<GroupNode>{static_cast<GroupNode*>(groupNode.cloneRecursively(worldBounds))};
+            transformNode(*groupNodeClone, vm::translation_matrix(vm::vec3(0.0, 2.0, 0.0)), worldBounds);
+            REQUIRE(canUpdateLinkedGroupContents(groupNode, *groupNodeClone));
+
+            transformNode(*entityNode1, vm::translation_matrix(vm::vec3(0.0, 0.0, 3.0)), worldBounds);
+            REQUIRE(entityNode1->entity().origin() == vm::vec3(0.0, 0.0, 3.0));
+
+            SECTION("Only the changed node is updated") {
+                const auto updateResult = updateLinkedGroupContents(groupNode, {groupNodeClone.get()}, {entityNode1}, worldBounds);
+                updateResult.visit(kdl::overload(
+                    [&](const UpdateLinkedGroupContentsResult& r) {
+                        REQUIRE(r.size() == 1u);
+
+                        const auto& [nodeToUpdate, newContents] = r.front();
+                        CHECK(nodeToUpdate == groupNodeClone->children().front());
+                        CHECK(std::get<Entity>(newContents.get()).origin() == vm::vec3(0.0, 2.0, 3.0));
+                    },
+                    [](const auto&) {
+                        FAIL();
+                    }
+                ));
+            }
+
+            SECTION("Nodes outside of the source group are ignored") {
+                const auto updateResult = updateLinkedGroupContents(groupNode, {groupNodeClone.get()}, {groupNodeClone->children().back()}, worldBounds);
+                updateResult.visit(kdl::overload(
+                    [&](const UpdateLinkedGroupContentsResult& r) {
+                        CHECK(r.empty());
+                    },
+                    [](const auto&) {
+                        FAIL();
+                    }
+                ));
+            }
+
+            SECTION("Groups with different structures cannot be updated") {
+                groupNodeClone->addChild(new EntityNode{});
+                CHECK_FALSE(canUpdateLinkedGroupContents(groupNode, *groupNodeClone));
+            }
+        }
+
         static void setGroupName(GroupNode& groupNode, const std::string& name) {
             auto group = groupNode.group();
             group.setName(name);
@@ -0,0 +1,82 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Model/Hit.h"
+
+#include <vecmath/vec.h>
+#include <vecmath/vec_io.h>
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        static const auto TestHitType = HitType::freeType();
+
+        TEST_CASE("HitTest.target") {
+            SECTION("Small target") {
+                const auto hit = Hit(TestHitType, 1.0, vm::vec3::zero(), vm::vec3(1, 2, 3));
+                CHECK(hit.target<vm::vec3>() == vm::vec3(1, 2, 3));
+                CHECK(hit.target<const vm::vec3&>() == vm::vec3(1, 2, 3));
+            }
+
+            SECTION("Target with heap memory") {
+                const auto hit = Hit(TestHitType, 1.0, vm::vec3::zero(), std::vector<std::string>{"a", "b"});
+                CHECK(hit.target<std::vector<std::string>>() == std::vector<std::string>{"a", "b"});
+            }
+
+            SECTION("Large target") {
+                using T = std::tuple<vm::vec3, vm::vec3, vm::vec3>;
+                const auto target = T{vm::vec3(1, 2, 3), vm::vec3(4, 5, 6), vm::vec3(7, 8, 9)};
+                const auto hit = Hit(TestHitType, 1.0, vm::vec3::zero(), target);
+                CHECK(hit.target<T>() == target);
+            }
+        }
+
+        TEST_CASE("HitTest.copyAndMove") {
+            using Large = std::tuple<vm::vec3, vm::vec3, vm::vec3>;
+            const auto large = Large{vm::vec3(1, 2, 3), vm::vec3(4, 5, 6), vm::vec3(7, 8, 9)};
+            const auto strings = std::vector<std::string>{"a", "b"};
+
+            auto hits = std::vector<Hit>{};
+            hits.push_back(Hit(TestHitType, 1.0, vm::vec3::zero(), strings));
+            hits.push_back(Hit(TestHitType, 2.0, vm::vec3::zero(), large));
+            hits.push_back(Hit::NoHit);
+
+            // force the vector to move its elements
+            hits.reserve(hits.capacity() + 1u);
+
+            auto copy = hits;
+            CHECK(copy[0].target<std::vector<std::string>>() == strings);
+            CHECK(copy[1].target<Large>() == large);
+            CHECK_FALSE(copy[2].isMatch());
+
+            copy[0] = copy[1];
+            CHECK(copy[0].target<Large>() == large);
+
+            copy[1] = std::move(hits[0]);
+            CHECK(copy[1].target<std::vector<std::string>>() == strings);
+            CHECK(hits[1].target<Large>() == large);
+        }
+    }
+}
@@ -0,0 +1,58 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Model/InternedString.h"
+
+#include <kdl/parallel.h>
+
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        TEST_CASE("InternedStringTest.defaultIsEmpty", "[InternedStringTest]") {
+            CHECK(InternedString().empty());
+            CHECK(InternedString() == InternedString(""));
+        }
+
+        TEST_CASE("InternedStringTest.equalStringsShareStorage", "[InternedStringTest]") {
+            const auto name = std::string("some_texture");
+            const auto a = InternedString(name);
+            const auto b = InternedString(std::string("some_") + "texture");
+
+            CHECK(a == b);
+            CHECK(&a.str() == &b.str());
+            CHECK(a.str() == name);
+
+            CHECK(a != InternedString("Some_Texture"));
+        }
+
+        TEST_CASE("InternedStringTest.internConcurrently", "[InternedStringTest]") {
+            const auto names = kdl::vec_parallel_transform(std::vector<size_t>(1000u, 0u), [](const size_t) {
+                return InternedString("concurrent_texture");
+            });
+
+            for (const auto& name : names) {
+                CHECK(name == names.front());
+            }
+        }
+    }
+}
@@ -0,0 +1,136 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/EntityProperties.h"
+#include "Model/Issue.h"
+#include "Model/IssueIndex.h"
+#include "Model/LayerNode.h"
+#include "Model/LinkTargetIssueGenerator.h"
+#include "Model/MapFormat.h"
+#include "Model/MissingClassnameIssueGenerator.h"
+#include "Model/WorldNode.h"
+
+#include <kdl/vector_utils.h>
+
+#include <memory>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        static std::vector<Node*> issueNodes(const IssueIndex& index) {
+            return kdl::vec_sort_and_remove_duplicates(kdl::vec_transform(index.issues(), [](const auto* issue) { return issue->node(); }));
+        }
+
+        TEST_CASE("IssueIndexTest.validate", "[IssueIndexTest]") {
+            auto missingClassname = MissingClassnameIssueGenerator{};
+            auto linkTarget = LinkTargetIssueGenerator{};
+            const auto issueGenerators = std::vector<IssueGenerator*>{&missingClassname, &linkTarget};
+
+            WorldNode world(Entity({{PropertyKeys::Classname, PropertyValues::WorldspawnClassname}}), MapFormat::Standard);
+            auto* layer = world.defaultLayer();
+
+            auto* entityWithClassname = new EntityNode(Entity({{PropertyKeys::Classname, "light"}}));
+            auto* entityWithoutClassname = new EntityNode(Entity());
+            layer->addChild(entityWithClassname);
+            layer->addChild(entityWithoutClassname);
+
+            auto index = IssueIndex{};
+            index.reset(&world);
+            REQUIRE(index.hasDirtyNodes());
+            CHECK(index.validate(issueGenerators));
+            CHECK_FALSE(index.hasDirtyNodes());
+            CHECK(issueNodes(index) == std::vector<Node*>{entityWithoutClassname});
+
+            SECTION("Validating without changes") {
+                CHECK_FALSE(index.validate(issueGenerators));
+                CHECK(issueNodes(index) == std::vector<Node*>{entityWithoutClassname});
+            }
+
+            SECTION("Changing a node") {
+                index.nodesWillChange({entityWithoutClassname});
+                entityWithoutClassname->setEntity(Entity({{PropertyKeys::Classname, "light"}}));
+                index.nodesDidChange({entityWithoutClassname});
+
+                CHECK(index.validate(issueGenerators));
+                CHECK(index.issues().empty());
+            }
+
+            SECTION("Removing a node") {
+                index.nodesWillBeRemoved({entityWithoutClassname});
+                layer->removeChild(entityWithoutClassname);
+                index.nodesWereRemoved({entityWithoutClassname});
+                auto removedNode = std::unique_ptr<Node>(entityWithoutClassname);
+
+                CHECK(index.validate(issueGenerators));
+                CHECK(index.issues().empty());
+            }
+
+            SECTION("Adding a node revalidates the entities linked to it") {
+                auto* source = new EntityNode(Entity({{PropertyKeys::Classname, "trigger"}, {PropertyKeys::Target, "door"}}));
+                layer->addChild(source);
+                index.nodesWereAdded({source});
+
+                CHECK(index.validate(issueGenerators));
+                CHECK(issueNodes(index) == kdl::vec_sort_and_remove_duplicates(std::vector<Node*>{entityWithoutClassname, source}));
+
+                auto* target = new EntityNode(Entity({{PropertyKeys::Classname, "door"}, {PropertyKeys::Targetname, "door"}}));
+                layer->addChild(target);
+                index.nodesWereAdded({target});
+
+                CHECK(index.validate(issueGenerators));
+                CHECK(issueNodes(index) == std::vector<Node*>{entityWithoutClassname});
+            }
+
+            SECTION("Issues invalidated without notification are revalidated") {
+                // the index must never return issues that were deleted by their node
+                entityWithoutClassname->setEntity(Entity({{PropertyKeys::Classname, "light"}}));
+
+                CHECK(index.validate(issueGenerators));
+                CHECK(index.issues().empty());
+            }
+        }
+
+        TEST_CASE("IssueIndexTest.validateAllIssues", "[IssueIndexTest]") {
+            WorldNode world(Entity({{PropertyKeys::Classname, PropertyValues::WorldspawnClassname}}), MapFormat::Standard);
+            world.registerIssueGenerator(new MissingClassnameIssueGenerator());
+            auto* layer = world.defaultLayer();
+
+            // use enough nodes to be split into several ranges
+            auto expectedNodes = std::vector<Node*>{};
+            for (size_t i = 0u; i < 500u; ++i) {
+                auto* entity = i % 3u == 0u ? new EntityNode(Entity()) : new EntityNode(Entity({{PropertyKeys::Classname, "light"}}));
+                layer->addChild(entity);
+                if (i % 3u == 0u) {
+                    expectedNodes.push_back(entity);
+                }
+            }
+
+            const auto issues = validateAllIssues(world);
+            CHECK(kdl::vec_transform(issues, [](const auto* issue) { return issue->node(); }) == expectedNodes);
+
+            for (auto* node : layer->children()) {
+                CHECK(node->issuesValid());
+            }
+        }
+    }
+}
@@ -235,6 +235,42 @@ namespace TrenchBroom {
             CHECK_THAT(collectNodes({innerGroupNode, outerGroupNode}),  Catch::Equals(std::vector<Node*>{innerGroupNode, entityNode, brushNode, outerGroupNode, innerGroupNode, entityNode, brushNode, patchNode}));
         }
 
+        TEST_CASE("ModelUtils.collectNodesByType") {
+            constexpr auto worldBounds = vm::bbox3d{8192.0};
+            constexpr auto mapFormat = MapFormat::Quake3;
+
+            auto worldNode = WorldNode{Entity{}, mapFormat};
+
+            auto* layerNode = new LayerNode{Layer{"layer"}};
+            auto* groupNode = new GroupNode{Group{"group"}};
+            auto* entityNode = new EntityNode{Entity{}};
+            auto* entityBrushNode = new BrushNode{BrushBuilder{mapFormat, worldBounds}.createCube(64.0, "texture").value()};
+            auto* brushNode = new BrushNode{BrushBuilder{mapFormat, worldBounds}.createCube(64.0, "texture").value()};
+            auto* patchNode = new PatchNode{BezierPatch{3, 3, {
+                {0, 0, 0}, {1, 0, 1}, {2, 0, 0},
+                {0, 1, 1}, {1, 1, 2}, {2, 1, 1},
+                {0, 2, 0}, {1, 2, 1}, {2, 2, 0} }, "texture"}};
+
+            entityNode->addChild(entityBrushNode);
+            groupNode->addChildren({entityNode, brushNode});
+            layerNode->addChildren({groupNode, patchNode});
+            worldNode.addChild(layerNode);
+
+            const auto collection = collectNodesByType({&worldNode});
+            CHECK_THAT(collection.layers(), Catch::Equals(std::vector<LayerNode*>{worldNode.defaultLayer(), layerNode}));
+            CHECK_THAT(collection.groups(), Catch::Equals(std::vector<GroupNode*>{groupNode}));
+            CHECK_THAT(collection.entities(), Catch::Equals(std::vector<EntityNode*>{entityNode}));
+            CHECK_THAT(collection.brushes(), Catch::Equals(std::vector<BrushNode*>{entityBrushNode, brushNode}));
+            CHECK_THAT(collection.patches(), Catch::Equals(std::vector<PatchNode*>{patchNode}));
+            CHECK(collection.nodeCount() == 7u);
+
+            const auto groupCollection = collectNodesByType({groupNode});
+            CHECK(groupCollection.layers().empty());
+            CHECK_THAT(groupCollection.groups(), Catch::Equals(std::vector<GroupNode*>{groupNode}));
+            CHECK_THAT(groupCollection.brushes(), Catch::Equals(std::vector<BrushNode*>{entityBrushNode, brushNode}));
+            CHECK(groupCollection.patches().empty());
+        }
+
         TEST_CASE("ModelUtils.collectTouchingNodes") {
             constexpr auto worldBounds = vm::bbox3d{8192.0};
             constexpr auto mapFormat = MapFormat::Quake3;
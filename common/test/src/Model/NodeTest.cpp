@@ -376,6 +376,27 @@ namespace TrenchBroom {
             CHECK(child3->parent() == &root);
         }
 
+        TEST_CASE("NodeTest.removeChildren", "[NodeTest]") {
+            auto root = TestNode{};
+            auto* child1 = new TestNode{};
+            auto* child2 = new TestNode{};
+            auto* child3 = new TestNode{};
+            auto* child4 = new TestNode{};
+            child2->addChild(new TestNode{});
+
+            root.addChildren({child1, child2, child3, child4});
+            REQUIRE(root.familySize() == 6u);
+
+            root.removeChildren(std::vector<Node*>{child4, child2});
+            CHECK(root.children() == std::vector<Node*>{child1, child3});
+            CHECK(child2->parent() == nullptr);
+            CHECK(child4->parent() == nullptr);
+            CHECK(root.familySize() == 3u);
+
+            delete child2;
+            delete child4;
+        }
+
         TEST_CASE("NodeTest.partialSelection", "[NodeTest]") {
             TestNode root;
             TestNode* child1 = new TestNode();
@@ -179,5 +179,33 @@ namespace TrenchBroom {
                 CHECK(pickResult.size() == 0u);
             }
         }
+
+        TEST_CASE("PatchNode.pickAfterSetPatch") {
+            using P = BezierPatch::Point;
+            const auto makeFlatPatch = [](const FloatType z) {
+                return BezierPatch{3, 3, {
+                    P{0.0, 2.0, z}, P{1.0, 2.0, z}, P{2.0, 2.0, z},
+                    P{0.0, 1.0, z}, P{1.0, 1.0, z}, P{2.0, 1.0, z},
+                    P{0.0, 0.0, z}, P{1.0, 0.0, z}, P{2.0, 0.0, z},
+                }, "texture"};
+            };
+
+            auto patchNode = PatchNode{makeFlatPatch(0.0)};
+
+            const auto editorContext = EditorContext{};
+            const auto pickRay = vm::ray3{vm::vec3{1, 1, 4}, vm::vec3::neg_z()};
+
+            auto pickResult = PickResult{};
+            patchNode.pick(editorContext, pickRay, pickResult);
+            REQUIRE(pickResult.size() == 1u);
+            CHECK(pickResult.all().front().hitPoint() == vm::vec3{1, 1, 0});
+
+            patchNode.setPatch(makeFlatPatch(2.0));
+
+            auto newPickResult = PickResult{};
+            patchNode.pick(editorContext, pickRay, newPickResult);
+            REQUIRE(newPickResult.size() == 1u);
+            CHECK(newPickResult.all().front().hitPoint() == vm::vec3{1, 1, 2});
+        }
     }
 }
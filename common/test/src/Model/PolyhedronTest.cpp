@@ -435,6 +435,35 @@ namespace TrenchBroom {
             CHECK(p.hasFace({ p2, p6, p8, p4 }));
         }
 
+        TEST_CASE("PolyhedronTest.constructCubeWithManyInteriorPoints", "[PolyhedronTest]") {
+            const auto corners = std::vector<vm::vec3d>{
+                vm::vec3d(-8.0, -8.0, -8.0),
+                vm::vec3d(-8.0, -8.0, +8.0),
+                vm::vec3d(-8.0, +8.0, -8.0),
+                vm::vec3d(-8.0, +8.0, +8.0),
+                vm::vec3d(+8.0, -8.0, -8.0),
+                vm::vec3d(+8.0, -8.0, +8.0),
+                vm::vec3d(+8.0, +8.0, -8.0),
+                vm::vec3d(+8.0, +8.0, +8.0),
+            };
+
+            // enough points on the boundary and in the interior to trigger discarding interior points
+            auto points = corners;
+            for (double x = -8.0; x <= 8.0; x += 4.0) {
+                for (double y = -8.0; y <= 8.0; y += 4.0) {
+                    for (double z = -8.0; z <= 8.0; z += 4.0) {
+                        points.push_back(vm::vec3d(x, y, z));
+                    }
+                }
+            }
+
+            const Polyhedron3d p(points);
+            CHECK(p.closed());
+            CHECK(p.vertexCount() == 8u);
+            CHECK(hasVertices(p, corners));
+            CHECK(p.faceCount() == 6u);
+        }
+
         TEST_CASE("PolyhedronTest.copy", "[PolyhedronTest]") {
             const vm::vec3d p1( 0.0, 0.0, 8.0);
             const vm::vec3d p2( 8.0, 0.0, 0.0);
@@ -120,11 +120,11 @@ namespace TrenchBroom {
             writer.writeMap();
         }
 
-        void TestGame::doExportMap(WorldNode& /* world */, const Model::ExportFormat /* format */, const IO::Path& /* path */) const {}
+        void TestGame::doExportMap(WorldNode& /* world */, const Model::ExportFormat /* format */, const IO::Path& /* path */, IO::NodeSerializationCache* /* cache */) const {}
 
-        std::vector<Node*> TestGame::doParseNodes(const std::string& str, const MapFormat mapFormat, const vm::bbox3& worldBounds, Logger& /* logger */) const {
+        std::vector<Node*> TestGame::doParseNodes(const std::string& str, const MapFormat mapFormat, const vm::bbox3& worldBounds, const std::string_view cacheData, Logger& /* logger */) const {
             IO::TestParserStatus status;
-            return IO::NodeReader::read(str, mapFormat, worldBounds, status);
+            return IO::NodeReader::read(str, mapFormat, worldBounds, cacheData, status);
         }
 
         std::vector<BrushFace> TestGame::doParseBrushFaces(const std::string& str, const MapFormat mapFormat, const vm::bbox3& worldBounds, Logger& /* logger */) const {
@@ -138,6 +138,11 @@ namespace TrenchBroom {
             writer.writeNodes(nodes);
         }
 
+        std::string TestGame::doWriteNodesCacheData(const std::string& str, const MapFormat mapFormat, Logger& /* logger */) const {
+            IO::TestParserStatus status;
+            return IO::NodeReader::writeCacheData(str, mapFormat, status);
+        }
+
         void TestGame::doWriteBrushFacesToStream(WorldNode& world, const std::vector<BrushFace>& faces, std::ostream& stream) const {
             IO::NodeWriter writer(world, stream);
             writer.writeBrushFaces(faces);
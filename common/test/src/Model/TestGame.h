@@ -24,12 +24,14 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace TrenchBroom {
     class Logger;
 
     namespace IO {
+        class NodeSerializationCache;
         class Path;
     }
 
@@ -63,11 +65,12 @@ namespace TrenchBroom {
             std::unique_ptr<WorldNode> doNewMap(MapFormat format, const vm::bbox3& worldBounds, Logger& logger) const override;
             std::unique_ptr<WorldNode> doLoadMap(MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const override;
             void doWriteMap(WorldNode& world, const IO::Path& path) const override;
-            void doExportMap(WorldNode& world, Model::ExportFormat format, const IO::Path& path) const override;
+            void doExportMap(WorldNode& world, Model::ExportFormat format, const IO::Path& path, IO::NodeSerializationCache* cache) const override;
 
-            std::vector<Node*> doParseNodes(const std::string& str, MapFormat mapFormat, const vm::bbox3& worldBounds, Logger& logger) const override;
+            std::vector<Node*> doParseNodes(const std::string& str, MapFormat mapFormat, const vm::bbox3& worldBounds, std::string_view cacheData, Logger& logger) const override;
             std::vector<BrushFace> doParseBrushFaces(const std::string& str, MapFormat mapFormat, const vm::bbox3& worldBounds, Logger& logger) const override;
             void doWriteNodesToStream(WorldNode& world, const std::vector<Node*>& nodes, std::ostream& stream) const override;
+            std::string doWriteNodesCacheData(const std::string& str, MapFormat mapFormat, Logger& logger) const override;
             void doWriteBrushFacesToStream(WorldNode& world, const std::vector<BrushFace>& faces, std::ostream& stream) const override;
 
             TexturePackageType doTexturePackageType() const override;
@@ -25,6 +25,8 @@
 
 #include <vecmath/vec.h>
 
+#include <vector>
+
 #include "Catch2.h"
 
 namespace TrenchBroom {
@@ -54,5 +56,35 @@ namespace TrenchBroom {
 #ifdef __clang__
 #pragma clang diagnostic pop
 #endif
+
+        TEST_CASE("TexCoordSystemTest.texCoordProjection", "[TexCoordSystemTest]") {
+            BrushFaceAttributes attribs("");
+            attribs.setOffset(vm::vec2f(16.0f, -8.0f));
+            attribs.setScale(vm::vec2f(0.5f, 0.0f));
+            attribs.setRotation(30.0f);
+
+            const auto textureSize = vm::vec2f(64.0f, 32.0f);
+            const auto points = std::vector<vm::vec3>{
+                vm::vec3(0.0, 0.0, 0.0),
+                vm::vec3(32.0, -16.0, 8.0),
+                vm::vec3(-128.5, 64.25, 1024.0)
+            };
+
+            ParaxialTexCoordSystem paraxial(vm::vec3::pos_z(), attribs);
+            ParallelTexCoordSystem parallel(vm::vec3::pos_y(), vm::vec3::pos_x());
+
+            for (const TexCoordSystem* system : std::vector<const TexCoordSystem*>{&paraxial, &parallel}) {
+                const auto projection = system->texCoordProjection(attribs, textureSize);
+                for (const auto& point : points) {
+                    CHECK(projection.texCoords(point) == system->getTexCoords(point, attribs, textureSize));
+                }
+
+                auto texCoords = std::vector<vm::vec2f>(points.size());
+                projection.texCoords(std::begin(points), std::end(points), std::begin(texCoords));
+                for (size_t i = 0u; i < points.size(); ++i) {
+                    CHECK(texCoords[i] == system->getTexCoords(points[i], attribs, textureSize));
+                }
+            }
+        }
     }
 }
@@ -151,6 +151,21 @@ namespace TrenchBroom {
                 CHECK(nodeTree.contains(patchNode));
             }
 
+            SECTION("Adding several nodes at once inserts all of them into node tree") {
+                worldNode.defaultLayer()->addChild(groupNode);
+
+                REQUIRE_FALSE(nodeTree.contains(entityNode));
+                REQUIRE_FALSE(nodeTree.contains(brushNode));
+                REQUIRE_FALSE(nodeTree.contains(patchNode));
+                groupNode->addChildren({entityNode, brushNode, patchNode});
+                CHECK(nodeTree.contains(entityNode));
+                CHECK(nodeTree.contains(brushNode));
+                CHECK(nodeTree.contains(patchNode));
+                CHECK_THAT(nodeTree.findContainers(vm::vec3d::zero()), Catch::UnorderedEquals(std::vector<Node*>{
+                    entityNode, brushNode, patchNode
+                }));
+            }
+
             SECTION("Removing a single node removes from node tree") {
                 auto* node = GENERATE_COPY(entityNode, brushNode, patchNode);
 
@@ -280,6 +295,38 @@ namespace TrenchBroom {
             CHECK(nodeTree.contains(patchNode));
         }
 
+        TEST_CASE("WorldNodeTest.updateNodeTreeAfterBoundsChange", "[WorldNodeTest]") {
+            constexpr auto worldBounds = vm::bbox3d{8192.0};
+            constexpr auto mapFormat = MapFormat::Quake3;
+
+            auto worldNode = WorldNode{Entity{}, mapFormat};
+            auto* entityNode = new EntityNode{Entity{}};
+            auto* brushNode = new BrushNode{BrushBuilder{mapFormat, worldBounds}.createCube(64.0, "texture").value()};
+
+            worldNode.defaultLayer()->addChild(entityNode);
+            entityNode->addChild(brushNode);
+
+            const auto offset = vm::vec3{256.0, 0.0, 0.0};
+            auto brush = brushNode->brush();
+            REQUIRE(brush.transform(worldBounds, vm::translation_matrix(offset), false).is_success());
+            brushNode->setBrush(std::move(brush));
+
+            const auto newCenter = vm::vec3{256.0, 0.0, 0.0};
+            CHECK_THAT(worldNode.nodeTree().findContainers(newCenter), Catch::UnorderedEquals(std::vector<Node*>{entityNode, brushNode}));
+            CHECK(worldNode.nodeTree().findContainers(vm::vec3::zero()).empty());
+
+            SECTION("Removing a node before the node tree is queried") {
+                auto movedBrush = brushNode->brush();
+                REQUIRE(movedBrush.transform(worldBounds, vm::translation_matrix(offset), false).is_success());
+                brushNode->setBrush(std::move(movedBrush));
+
+                entityNode->removeChild(brushNode);
+                CHECK_FALSE(worldNode.nodeTree().contains(brushNode));
+                CHECK(worldNode.nodeTree().contains(entityNode));
+                delete brushNode;
+            }
+        }
+
         TEST_CASE("WorldNodeTest.persistentIdOfDefaultLayer", "[WorldNodeTest]") {
             auto worldNode = WorldNode{Entity{}, MapFormat::Standard};
             CHECK(worldNode.defaultLayer()->persistentId() == std::nullopt);
@@ -378,5 +425,42 @@ namespace TrenchBroom {
             layerNode->addChild(groupNode);
             CHECK(groupNode->persistentId() == 2u);
         }
+
+        TEST_CASE("WorldNodeTest.findLinkedGroups", "[WorldNodeTest]") {
+            auto worldNode = WorldNode{Entity{}, MapFormat::Standard};
+
+            auto outerGroup = Group{"outer"};
+            outerGroup.setLinkedGroupId("outer_id");
+
+            auto innerGroup = Group{"inner"};
+            innerGroup.setLinkedGroupId("inner_id");
+
+            auto* outerGroupNode = new GroupNode{outerGroup};
+            auto* innerGroupNode = new GroupNode{innerGroup};
+            auto* unlinkedGroupNode = new GroupNode{Group{"unlinked"}};
+            outerGroupNode->addChild(innerGroupNode);
+
+            CHECK(worldNode.findLinkedGroups("outer_id").empty());
+
+            worldNode.defaultLayer()->addChild(outerGroupNode);
+            worldNode.defaultLayer()->addChild(unlinkedGroupNode);
+            CHECK(worldNode.findLinkedGroups("outer_id") == std::vector<GroupNode*>{outerGroupNode});
+            CHECK(worldNode.findLinkedGroups("inner_id") == std::vector<GroupNode*>{innerGroupNode});
+
+            SECTION("Changing a group's linked group ID updates the index") {
+                auto group = unlinkedGroupNode->group();
+                group.setLinkedGroupId("outer_id");
+                unlinkedGroupNode->setGroup(std::move(group));
+
+                CHECK_THAT(worldNode.findLinkedGroups("outer_id"), Catch::UnorderedEquals(std::vector<GroupNode*>{outerGroupNode, unlinkedGroupNode}));
+            }
+
+            SECTION("Removing a group removes its descendants from the index") {
+                worldNode.defaultLayer()->removeChild(outerGroupNode);
+                CHECK(worldNode.findLinkedGroups("outer_id").empty());
+                CHECK(worldNode.findLinkedGroups("inner_id").empty());
+                delete outerGroupNode;
+            }
+        }
     }
 }
@@ -387,4 +387,46 @@ namespace TrenchBroom {
             CHECK(moveCount <= 3);
         }
     }
+
+    TEST_CASE("CoalescingNotifier") {
+        auto n = CoalescingNotifier<int>{};
+        auto calls = std::vector<std::vector<int>>{};
+        auto connection = n.connect([&](const std::vector<int>& values) { calls.push_back(values); });
+
+        SECTION("Notifies immediately when not coalescing") {
+            n.notify({3, 1});
+            n.notify({2});
+            CHECK(calls == std::vector<std::vector<int>>{{3, 1}, {2}});
+        }
+
+        SECTION("Coalesces notifications in nested scopes") {
+            n.beginCoalescing();
+            n.notify({3, 1});
+            n.beginCoalescing();
+            n.notify({1, 2});
+            n.endCoalescing();
+            CHECK(calls.empty());
+
+            n.endCoalescing();
+            CHECK(calls == std::vector<std::vector<int>>{{1, 2, 3}});
+        }
+
+        SECTION("Flush dispatches pending values and keeps coalescing") {
+            n.beginCoalescing();
+            n.notify({2, 2});
+            n.flush();
+            CHECK(calls == std::vector<std::vector<int>>{{2}});
+
+            n.notify({1});
+            CHECK(n.coalescing());
+            n.endCoalescing();
+            CHECK(calls == std::vector<std::vector<int>>{{2}, {1}});
+        }
+
+        SECTION("Does not notify if nothing was collected") {
+            n.beginCoalescing();
+            n.endCoalescing();
+            CHECK(calls.empty());
+        }
+    }
 }
@@ -0,0 +1,79 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Profiler.h"
+
+#include <chrono>
+#include <sstream>
+#include <string>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    TEST_CASE("ProfilerTest.recordScope", "[ProfilerTest]") {
+        clearProfileEvents();
+        {
+            TB_PROFILE_SCOPE("outer");
+            {
+                TB_PROFILE_SCOPE("inner");
+            }
+        }
+
+        const auto events = profileEvents();
+        REQUIRE(events.size() == 2u);
+        CHECK(std::string{events[0].name} == "inner");
+        CHECK(std::string{events[1].name} == "outer");
+        CHECK(events[1].startNsecs <= events[0].startNsecs);
+        CHECK(events[0].startNsecs + events[0].durationNsecs <= events[1].startNsecs + events[1].durationNsecs);
+        CHECK(events[0].threadId == events[1].threadId);
+    }
+
+    TEST_CASE("ProfilerTest.ringBufferKeepsNewestEvents", "[ProfilerTest]") {
+        clearProfileEvents();
+
+        const auto now = std::chrono::steady_clock::now();
+        recordProfileEvent("first", now, now);
+        for (size_t i = 0u; i < ProfileEventCapacity; ++i) {
+            recordProfileEvent("second", now, now);
+        }
+        recordProfileEvent("third", now, now);
+
+        const auto events = profileEvents();
+        REQUIRE(events.size() == ProfileEventCapacity);
+        CHECK(std::string{events.front().name} == "second");
+        CHECK(std::string{events.back().name} == "third");
+    }
+
+    TEST_CASE("ProfilerTest.writeChromeTrace", "[ProfilerTest]") {
+        clearProfileEvents();
+
+        const auto now = std::chrono::steady_clock::now();
+        recordProfileEvent("event", now, now + std::chrono::microseconds{5});
+
+        auto str = std::stringstream{};
+        writeChromeTrace(str);
+
+        const auto trace = str.str();
+        CHECK(trace.find("\"traceEvents\":[") != std::string::npos);
+        CHECK(trace.find("\"name\":\"event\"") != std::string::npos);
+        CHECK(trace.find("\"ph\":\"X\"") != std::string::npos);
+        CHECK(trace.find("\"dur\":5.000") != std::string::npos);
+    }
+}
@@ -245,6 +245,110 @@ namespace TrenchBroom {
             }
         }
 
+        TEST_CASE("AllocationTrackerTest.compact", "[AllocationTrackerTest]") {
+            AllocationTracker t(500);
+
+            AllocationTracker::Block* blocks[5];
+            for (size_t i = 0; i < 5; ++i) {
+                blocks[i] = t.allocate(100);
+            }
+
+            t.free(blocks[0]);
+            t.free(blocks[2]);
+            CHECK(t.usedBlocks() == (std::vector<AllocationTracker::Range>{{100, 100}, {300, 100}, {400, 100}}));
+
+            CHECK(t.compact() == (std::vector<AllocationTracker::Relocation>{{100, 0, 100}, {300, 100, 100}, {400, 200, 100}}));
+            CHECK(t.capacity() == 500u);
+            CHECK(t.usedBlocks() == (std::vector<AllocationTracker::Range>{{0, 100}, {100, 100}, {200, 100}}));
+            CHECK(t.freeBlocks() == (std::vector<AllocationTracker::Range>{{300, 200}}));
+            CHECK(t.largestPossibleAllocation() == 200u);
+
+            // the blocks remain valid
+            CHECK(blocks[1]->pos == 0u);
+            CHECK(blocks[3]->pos == 100u);
+            CHECK(blocks[4]->pos == 200u);
+
+            t.free(blocks[3]);
+            CHECK(t.freeBlocks() == (std::vector<AllocationTracker::Range>{{100, 100}, {300, 200}}));
+
+            // nothing moves if the tracker is already compact
+            t.free(blocks[4]);
+            CHECK(t.compact() == (std::vector<AllocationTracker::Relocation>{}));
+            CHECK(t.freeBlocks() == (std::vector<AllocationTracker::Range>{{100, 400}}));
+
+            t.free(blocks[1]);
+            CHECK(t.compact() == (std::vector<AllocationTracker::Relocation>{}));
+            CHECK(t.freeBlocks() == (std::vector<AllocationTracker::Range>{{0, 500}}));
+            CHECK_FALSE(t.hasAllocations());
+        }
+
+        TEST_CASE("AllocationTrackerTest.compactEmpty", "[AllocationTrackerTest]") {
+            AllocationTracker t;
+            CHECK(t.compact() == (std::vector<AllocationTracker::Relocation>{}));
+            CHECK(t.capacity() == 0u);
+        }
+
+        TEST_CASE("AllocationTrackerTest.truncate", "[AllocationTrackerTest]") {
+            AllocationTracker t(500);
+
+            auto* block1 = t.allocate(100);
+            auto* block2 = t.allocate(100);
+
+            CHECK_THROWS_AS(t.truncate(600), std::invalid_argument);
+            CHECK_THROWS_AS(t.truncate(150), std::invalid_argument);
+
+            t.truncate(300);
+            CHECK(t.capacity() == 300u);
+            CHECK(t.freeBlocks() == (std::vector<AllocationTracker::Range>{{200, 100}}));
+
+            t.truncate(200);
+            CHECK(t.capacity() == 200u);
+            CHECK(t.freeBlocks() == (std::vector<AllocationTracker::Range>{}));
+            CHECK(t.allocate(1) == nullptr);
+
+            t.free(block2);
+            t.free(block1);
+            t.truncate(0);
+            CHECK(t.capacity() == 0u);
+            CHECK(t.freeBlocks() == (std::vector<AllocationTracker::Range>{}));
+
+            t.expand(100);
+            CHECK(t.freeBlocks() == (std::vector<AllocationTracker::Range>{{0, 100}}));
+        }
+
+        TEST_CASE("AllocationTrackerTest.statistics", "[AllocationTrackerTest]") {
+            AllocationTracker t(400);
+
+            AllocationTracker::Block* blocks[4];
+            for (size_t i = 0; i < 4; ++i) {
+                blocks[i] = t.allocate(100);
+            }
+
+            auto stats = t.statistics();
+            CHECK(stats.capacity == 400u);
+            CHECK(stats.usedSize == 400u);
+            CHECK(stats.freeSize == 0u);
+            CHECK(stats.usedBlockCount == 4u);
+            CHECK(stats.freeBlockCount == 0u);
+            CHECK(stats.fragmentation() == 0.0);
+
+            t.free(blocks[0]);
+            t.free(blocks[2]);
+
+            CHECK(t.usedSize() == 200u);
+
+            stats = t.statistics();
+            CHECK(stats.usedSize == 200u);
+            CHECK(stats.freeSize == 200u);
+            CHECK(stats.usedBlockCount == 2u);
+            CHECK(stats.freeBlockCount == 2u);
+            CHECK(stats.largestFreeBlock == 100u);
+            CHECK(stats.fragmentation() == 0.5);
+
+            t.compact();
+            CHECK(t.statistics().fragmentation() == 0.0);
+        }
+
         static constexpr size_t NumBrushes = 64'000;
 
         // between 12 and 140, inclusive.
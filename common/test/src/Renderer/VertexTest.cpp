@@ -23,6 +23,7 @@
 #include <vecmath/forward.h>
 #include <vecmath/vec.h>
 
+#include <cmath>
 #include <cstring>
 
 #include "Catch2.h"
@@ -69,5 +70,48 @@ namespace TrenchBroom {
             REQUIRE(actual.size() == expected.size());
             REQUIRE(std::memcmp(expected.data(), actual.data(), sizeof(TestVertex) * 3) == 0);
         }
+
+        TEST_CASE("VertexTest.memoryLayoutPackedNormal", "[VertexTest]") {
+            using Vertex = GLVertexTypes::P3NPT2::Vertex;
+
+            struct PackedTestVertex {
+                vm::vec3f pos;
+                GLbyte normal[4];
+                vm::vec2f uv;
+            };
+
+            const auto pos    = vm::vec3f(1.0f, 2.0f, 3.0f);
+            const auto normal = GLVertexAttributeTypes::NP::pack(vm::vec3f(0.0f, -1.0f, 1.0f));
+            const auto uv     = vm::vec2f(4.0f, 5.0f);
+
+            const auto expected = PackedTestVertex{ pos, { 0, -127, 127, 0 }, uv };
+            const auto actual   = Vertex(pos, normal, uv);
+
+            REQUIRE(sizeof(Vertex) == 24u);
+            REQUIRE(sizeof(Vertex) == sizeof(PackedTestVertex));
+            REQUIRE(std::memcmp(&expected, &actual, sizeof(expected)) == 0);
+        }
+
+        TEST_CASE("VertexTest.packNormal", "[VertexTest]") {
+            using NP = GLVertexAttributeTypes::NP;
+
+            const auto normals = std::vector<vm::vec3f>{
+                vm::vec3f(1.0f, 0.0f, 0.0f),
+                vm::vec3f(0.0f, -1.0f, 0.0f),
+                vm::vec3f(0.0f, 0.0f, 1.0f),
+                vm::vec3f(0.6f, -0.8f, 0.0f),
+                vm::vec3f(0.48f, 0.6f, -0.64f),
+            };
+
+            for (const auto& normal : normals) {
+                const auto unpacked = NP::unpack(NP::pack(normal));
+                for (size_t i = 0; i < 3; ++i) {
+                    CHECK(std::abs(unpacked[i] - normal[i]) <= 0.5f / 127.0f);
+                }
+            }
+
+            // components outside of [-1..1] are clamped
+            CHECK(NP::pack(vm::vec3f(2.0f, -2.0f, 0.0f)) == NP::ElementType(127, -127, 0, 0));
+        }
     }
 }
@@ -0,0 +1,138 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/TestEnvironment.h"
+#include "View/AutosaveJournal.h"
+
+#include <string>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace View {
+        static const auto Map1 = std::string{R"(// Game: Quake
+// Format: Standard
+// entity 0
+{
+"classname" "worldspawn"
+// brush 0
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) none 0 0 0 1 1
+( 64 64 16 ) ( 64 64 17 ) ( 64 65 16 ) none 0 0 0 1 1
+}
+// brush 1
+{
+patchDef2
+{
+none
+( 3 3 0 0 0 )
+(
+( ( 0 0 0 0 0 ) ( 0 32 0 0 0.5 ) ( 0 64 0 0 1 ) )
+( ( 32 0 0 0.5 0 ) ( 32 32 0 0.5 0.5 ) ( 32 64 0 0.5 1 ) )
+( ( 64 0 0 1 0 ) ( 64 32 0 1 0.5 ) ( 64 64 0 1 1 ) )
+)
+}
+}
+}
+// entity 1
+{
+"classname" "light"
+"origin" "0 0 32"
+}
+)"};
+
+        static const auto Map2 = std::string{R"(// Game: Quake
+// Format: Standard
+// entity 0
+{
+"classname" "worldspawn"
+// brush 0
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) none 0 0 0 1 1
+( 64 64 16 ) ( 64 64 17 ) ( 64 65 16 ) none 0 0 0 1 1
+}
+// brush 1
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) other 0 0 0 1 1
+( 64 64 16 ) ( 64 64 17 ) ( 64 65 16 ) other 0 0 0 1 1
+}
+}
+// entity 1
+{
+"classname" "light"
+"origin" "0 0 64"
+}
+)"};
+
+        static std::string readFile(const IO::Path& path) {
+            const auto file = IO::Disk::openFile(path);
+            auto reader = file->reader().buffer();
+            return std::string{reader.stringView()};
+        }
+
+        TEST_CASE("AutosaveJournalTest.splitBlocks", "[AutosaveJournalTest]") {
+            const auto blocks = AutosaveJournal::splitBlocks(Map1);
+            REQUIRE(blocks.size() == 3u);
+            CHECK(blocks[0] == std::vector<std::string_view>{"// Game: Quake\n// Format: Standard\n"});
+            REQUIRE(blocks[1].size() == 3u);
+            CHECK(blocks[1][0] == "\"classname\" \"worldspawn\"\n");
+            CHECK(blocks[1][1].substr(0u, 2u) == "{\n");
+            CHECK(blocks[1][2].substr(0u, 12u) == "{\npatchDef2\n");
+            CHECK(blocks[2] == std::vector<std::string_view>{"\"classname\" \"light\"\n\"origin\" \"0 0 32\"\n"});
+        }
+
+        TEST_CASE("AutosaveJournalTest.recoverAppendedStates", "[AutosaveJournalTest]") {
+            IO::TestEnvironment env("autosave_journal_test");
+            const auto journalPath = env.dir() + IO::Path("test.journal");
+
+            auto journal = AutosaveJournal{journalPath};
+            CHECK_FALSE(journal.started());
+
+            journal.append(Map1);
+            CHECK(journal.started());
+            CHECK(AutosaveJournal::recover(readFile(journalPath)) == Map1);
+
+            const auto checkpointSize = readFile(journalPath).size();
+
+            journal.append(Map2);
+            const auto data = readFile(journalPath);
+            CHECK(AutosaveJournal::recover(data) == Map2);
+
+            // only the changed brush and entity properties were appended
+            CHECK(data.size() - checkpointSize < checkpointSize);
+
+            // an incompletely written state is ignored
+            CHECK(AutosaveJournal::recover(data.substr(0u, data.size() - 2u)) == Map1);
+
+            journal.writeCheckpoint(Map2);
+            CHECK(readFile(journalPath).size() < data.size());
+            CHECK(AutosaveJournal::recover(readFile(journalPath)) == Map2);
+        }
+
+        TEST_CASE("AutosaveJournalTest.recoverInvalidJournal", "[AutosaveJournalTest]") {
+            CHECK(AutosaveJournal::recover("") == std::nullopt);
+            CHECK(AutosaveJournal::recover("TBJOURNAL 1\n") == std::nullopt);
+            CHECK(AutosaveJournal::recover("TBJOURNAL 1\nS 1\n0000000000000000\nE\n") == std::nullopt);
+        }
+    }
+}
@@ -18,14 +18,19 @@
  */
 
 #include "Logger.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
 #include "IO/Path.h"
+#include "IO/Reader.h"
 #include "IO/TestEnvironment.h"
 #include "Model/BrushNode.h"
 #include "Model/LayerNode.h"
+#include "View/AutosaveJournal.h"
 #include "View/Autosaver.h"
 #include "View/MapDocumentTest.h"
 
 #include <chrono>
+#include <string>
 #include <thread>
 
 #include "TestUtils.h"
@@ -61,6 +66,7 @@ namespace TrenchBroom {
             addNode(*document, document->currentLayer(), createBrushNode("some_texture"));
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForBackup(logger);
 
             CHECK_FALSE(env.fileExists(IO::Path("autosave/test.1.map")));
             CHECK_FALSE(env.directoryExists(IO::Path("autosave")));
@@ -77,6 +83,7 @@ namespace TrenchBroom {
 
             Autosaver autosaver(document, 0s);
             autosaver.triggerAutosave(logger);
+            autosaver.waitForBackup(logger);
 
             CHECK_FALSE(env.fileExists(IO::Path("autosave/test.1.map")));
             CHECK_FALSE(env.directoryExists(IO::Path("autosave")));
@@ -101,6 +108,7 @@ namespace TrenchBroom {
             std::this_thread::sleep_for(100ms);
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForBackup(logger);
 
             CHECK(env.fileExists(IO::Path("autosave/test.1.map")));
             CHECK(env.directoryExists(IO::Path("autosave")));
@@ -125,6 +133,7 @@ namespace TrenchBroom {
             std::this_thread::sleep_for(100ms);
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForBackup(logger);
 
             CHECK(env.fileExists(IO::Path("autosave/test.1.map")));
             CHECK(env.directoryExists(IO::Path("autosave")));
@@ -134,15 +143,139 @@ namespace TrenchBroom {
             std::this_thread::sleep_for(100ms);
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForBackup(logger);
             CHECK_FALSE(env.fileExists(IO::Path("autosave/test.2.map")));
 
             // modify the map
             addNode(*document, document->currentLayer(), createBrushNode("some_texture"));
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForBackup(logger);
             CHECK(env.fileExists(IO::Path("autosave/test.2.map")));
         }
 
+        TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverWritesSnapshot") {
+            using namespace std::literals::chrono_literals;
+
+            IO::TestEnvironment env("autosaver_test");
+            NullLogger logger;
+
+            document->saveDocumentAs(env.dir() + IO::Path("test.map"));
+            assert(env.fileExists(IO::Path("test.map")));
+
+            Autosaver autosaver(document, 0s);
+
+            // modify the map
+            addNode(*document, document->currentLayer(), createBrushNode("some_texture"));
+
+            autosaver.triggerAutosave(logger);
+
+            // modify the map while the backup is being written
+            addNode(*document, document->currentLayer(), createBrushNode("other_texture"));
+
+            autosaver.waitForBackup(logger);
+
+            REQUIRE(env.fileExists(IO::Path("autosave/test.1.map")));
+            CHECK_FALSE(env.fileExists(IO::Path("autosave/test.1.map.tmp")));
+
+            const auto file = IO::Disk::openFile(env.dir() + IO::Path("autosave/test.1.map"));
+            auto reader = file->reader().buffer();
+            const auto contents = std::string{reader.stringView()};
+            CHECK(contents.find("some_texture") != std::string::npos);
+            CHECK(contents.find("other_texture") == std::string::npos);
+        }
+
+        TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverAppendsToJournalBetweenCheckpoints") {
+            using namespace std::literals::chrono_literals;
+
+            IO::TestEnvironment env("autosaver_test");
+            NullLogger logger;
+
+            document->saveDocumentAs(env.dir() + IO::Path("test.map"));
+            assert(env.fileExists(IO::Path("test.map")));
+
+            Autosaver autosaver(document, 0s, 50u, 2u);
+
+            const auto readJournal = [&]() {
+                const auto file = IO::Disk::openFile(env.dir() + IO::Path("autosave/test.journal"));
+                auto reader = file->reader().buffer();
+                return std::string{reader.stringView()};
+            };
+
+            addNode(*document, document->currentLayer(), createBrushNode("some_texture"));
+            autosaver.triggerAutosave(logger);
+            autosaver.waitForBackup(logger);
+
+            CHECK(env.fileExists(IO::Path("autosave/test.1.map")));
+            REQUIRE(env.fileExists(IO::Path("autosave/test.journal")));
+            const auto checkpointSize = readJournal().size();
+
+            addNode(*document, document->currentLayer(), createBrushNode("other_texture"));
+            autosaver.triggerAutosave(logger);
+            autosaver.waitForBackup(logger);
+
+            CHECK_FALSE(env.fileExists(IO::Path("autosave/test.2.map")));
+
+            const auto journal = readJournal();
+            CHECK(journal.size() > checkpointSize);
+
+            const auto recovered = AutosaveJournal::recover(journal);
+            REQUIRE(recovered.has_value());
+            CHECK(recovered->find("some_texture") != std::string::npos);
+            CHECK(recovered->find("other_texture") != std::string::npos);
+
+            addNode(*document, document->currentLayer(), createBrushNode("third_texture"));
+            autosaver.triggerAutosave(logger);
+            autosaver.waitForBackup(logger);
+
+            CHECK(env.fileExists(IO::Path("autosave/test.2.map")));
+        }
+
+        TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverRecoversJournal") {
+            using namespace std::literals::chrono_literals;
+
+            const auto checkpointText = std::string{R"(// entity 0
+{
+"classname" "worldspawn"
+}
+)"};
+            const auto appendedText = std::string{R"(// entity 0
+{
+"classname" "worldspawn"
+}
+// entity 1
+{
+"classname" "light"
+}
+)"};
+
+            IO::TestEnvironment env("autosaver_test");
+            env.createDirectory(IO::Path("autosave"));
+            env.createFile(IO::Path("autosave/test.1.map"), checkpointText);
+
+            NullLogger logger;
+
+            document->saveDocumentAs(env.dir() + IO::Path("test.map"));
+            assert(env.fileExists(IO::Path("test.map")));
+
+            // a previous session appended a state to the journal, but exited before writing the next full backup
+            AutosaveJournal journal(env.dir() + IO::Path("autosave/test.journal"));
+            journal.writeCheckpoint(checkpointText);
+            journal.append(appendedText);
+
+            Autosaver autosaver(document, 0s, 50u, 2u);
+            autosaver.recoverJournal(logger);
+
+            REQUIRE(env.fileExists(IO::Path("autosave/test.2.map")));
+            const auto file = IO::Disk::openFile(env.dir() + IO::Path("autosave/test.2.map"));
+            auto reader = file->reader().buffer();
+            CHECK(std::string{reader.stringView()} == appendedText);
+
+            // the newest backup already contains the journal's state
+            autosaver.recoverJournal(logger);
+            CHECK_FALSE(env.fileExists(IO::Path("autosave/test.3.map")));
+        }
+
         TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesWhenCrashFilesPresent") {
             // https://github.com/TrenchBroom/TrenchBroom/issues/2544
 
@@ -165,6 +298,7 @@ namespace TrenchBroom {
             addNode(*document, document->currentLayer(), createBrushNode("some_texture"));
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForBackup(logger);
 
             CHECK(env.fileExists(IO::Path("autosave/test.2.map")));
         }
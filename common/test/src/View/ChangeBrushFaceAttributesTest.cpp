@@ -32,6 +32,8 @@
 
 #include "TestUtils.h"
 
+#include <vector>
+
 #include "Catch2.h"
 
 namespace TrenchBroom {
@@ -111,6 +113,83 @@ namespace TrenchBroom {
             checkTexture("texture2");
         }
 
+        TEST_CASE_METHOD(ValveMapDocumentTest, "ChangeBrushFaceAttributesTest.undoRestoresTextureAxes") {
+            Model::BrushNode* brushNode = createBrushNode();
+            addNode(*document, document->parentForNodes(), brushNode);
+
+            const size_t faceIndex = 0u;
+            const vm::vec3 initialX = brushNode->brush().face(faceIndex).textureXAxis();
+            const vm::vec3 initialY = brushNode->brush().face(faceIndex).textureYAxis();
+
+            document->select(Model::BrushFaceHandle(brushNode, faceIndex));
+
+            Model::ChangeBrushFaceAttributesRequest rotate;
+            rotate.addRotation(30.0f);
+            document->setFaceAttributes(rotate);
+            REQUIRE(brushNode->brush().face(faceIndex).textureXAxis() != initialX);
+
+            document->undoCommand();
+            CHECK(brushNode->brush().face(faceIndex).attributes().rotation() == 0.0f);
+            CHECK(brushNode->brush().face(faceIndex).textureXAxis() == initialX);
+            CHECK(brushNode->brush().face(faceIndex).textureYAxis() == initialY);
+        }
+
+        TEST_CASE_METHOD(ValveMapDocumentTest, "ChangeBrushFaceAttributesTest.collateOffsetChanges") {
+            Model::BrushNode* brushNode = createBrushNode();
+            addNode(*document, document->parentForNodes(), brushNode);
+
+            document->select(brushNode);
+
+            Model::ChangeBrushFaceAttributesRequest addOffset;
+            addOffset.addXOffset(1.0f);
+            for (size_t i = 0; i < 10; ++i) {
+                document->setFaceAttributes(addOffset);
+            }
+
+            for (const auto& face : brushNode->brush().faces()) {
+                CHECK(face.attributes().xOffset() == 10.0f);
+            }
+
+            document->undoCommand();
+            for (const auto& face : brushNode->brush().faces()) {
+                CHECK(face.attributes().xOffset() == 0.0f);
+            }
+
+            document->redoCommand();
+            for (const auto& face : brushNode->brush().faces()) {
+                CHECK(face.attributes().xOffset() == 10.0f);
+            }
+        }
+
+        TEST_CASE_METHOD(ValveMapDocumentTest, "ChangeBrushFaceAttributesTest.setFaceTextureName") {
+            Model::BrushNode* brushNode = createBrushNode("original");
+            addNode(*document, document->parentForNodes(), brushNode);
+
+            const auto xOffset = brushNode->brush().face(0u).attributes().xOffset();
+            const auto faces = std::vector<Model::BrushFaceHandle>{
+                Model::BrushFaceHandle(brushNode, 0u),
+                Model::BrushFaceHandle(brushNode, 2u)
+            };
+
+            document->deselectAll();
+            CHECK(document->setFaceTextureName(faces, "replacement"));
+            CHECK(brushNode->brush().face(0u).attributes().textureName() == "replacement");
+            CHECK(brushNode->brush().face(1u).attributes().textureName() == "original");
+            CHECK(brushNode->brush().face(2u).attributes().textureName() == "replacement");
+            CHECK(brushNode->brush().face(0u).attributes().xOffset() == xOffset);
+            CHECK(!document->hasSelectedBrushFaces());
+
+            document->undoCommand();
+            for (const auto& face : brushNode->brush().faces()) {
+                CHECK(face.attributes().textureName() == "original");
+            }
+
+            document->redoCommand();
+            CHECK(brushNode->brush().face(0u).attributes().textureName() == "replacement");
+            CHECK(brushNode->brush().face(1u).attributes().textureName() == "original");
+            CHECK(brushNode->brush().face(2u).attributes().textureName() == "replacement");
+        }
+
         TEST_CASE_METHOD(ValveMapDocumentTest, "ChangeBrushFaceAttributesTest.setAll") {
             Model::BrushNode* brushNode = createBrushNode();
             addNode(*document, document->parentForNodes(), brushNode);
@@ -584,5 +584,51 @@ namespace TrenchBroom {
             REQUIRE(commandProcessor.undoCommandName() == commandName1);
             REQUIRE(commandProcessor.redoCommandName() == commandName2);
         }
+
+        TEST_CASE("CommandProcessorTest.undoMemoryBudget", "[CommandProcessorTest]") {
+            /*
+             * Execute three commands, then limit the undo memory budget so that only two of them fit.
+             */
+
+            CommandProcessor commandProcessor(nullptr);
+
+            const auto commandName1 = "test command 1";
+            auto command1 = TestCommand::create(commandName1);
+
+            const auto commandName2 = "test command 2";
+            auto command2 = TestCommand::create(commandName2);
+
+            const auto commandName3 = "test command 3";
+            auto command3 = TestCommand::create(commandName3);
+
+            command1->expectDo(true);
+            command1->expectCollate(command2.get(), false);
+            command2->expectDo(true);
+            command2->expectCollate(command3.get(), false);
+            command3->expectDo(true);
+            command3->expectUndo(true);
+
+            const auto commandMemoryUsage = command1->memoryUsage();
+            REQUIRE(commandMemoryUsage > 0u);
+            REQUIRE(command2->memoryUsage() == commandMemoryUsage);
+            REQUIRE(command3->memoryUsage() == commandMemoryUsage);
+
+            commandProcessor.executeAndStore(std::move(command1));
+            commandProcessor.executeAndStore(std::move(command2));
+            commandProcessor.executeAndStore(std::move(command3));
+            CHECK(commandProcessor.undoStackMemoryUsage() == 3u * commandMemoryUsage);
+
+            commandProcessor.setUndoMemoryBudget(2u * commandMemoryUsage);
+            CHECK(commandProcessor.undoStackMemoryUsage() == 2u * commandMemoryUsage);
+
+            // the most recent command is kept even if it exceeds the budget
+            commandProcessor.setUndoMemoryBudget(1u);
+            CHECK(commandProcessor.undoStackMemoryUsage() == commandMemoryUsage);
+            REQUIRE(commandProcessor.undoCommandName() == commandName3);
+
+            CHECK(commandProcessor.undo()->success());
+            CHECK_FALSE(commandProcessor.canUndo());
+            CHECK(commandProcessor.undoStackMemoryUsage() == 0u);
+        }
     }
 }
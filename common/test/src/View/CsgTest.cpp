@@ -26,6 +26,7 @@
 #include "Model/BrushFace.h"
 #include "Model/EntityNode.h"
 #include "Model/LayerNode.h"
+#include "Model/NodeCollection.h"
 #include "Model/ParallelTexCoordSystem.h"
 #include "Model/WorldNode.h"
 
@@ -55,6 +56,44 @@ namespace TrenchBroom {
             CHECK(brush3->logicalBounds() == vm::bbox3(vm::vec3(0, 0, 0), vm::vec3(64, 64, 64)));
         }
 
+        TEST_CASE_METHOD(MapDocumentTest, "CsgTest.csgIntersectMultipleBrushes") {
+            const Model::BrushBuilder builder(document->world()->mapFormat(), document->worldBounds());
+
+            auto* brushNode1 = new Model::BrushNode(builder.createCuboid(vm::bbox3(vm::vec3(0, 0, 0), vm::vec3(64, 64, 64)), "texture").value());
+            auto* brushNode2 = new Model::BrushNode(builder.createCuboid(vm::bbox3(vm::vec3(16, 0, 0), vm::vec3(80, 64, 64)), "texture").value());
+            auto* brushNode3 = new Model::BrushNode(builder.createCuboid(vm::bbox3(vm::vec3(0, 16, 0), vm::vec3(64, 80, 64)), "texture").value());
+            auto* brushNode4 = new Model::BrushNode(builder.createCuboid(vm::bbox3(vm::vec3(0, 0, 16), vm::vec3(64, 64, 80)), "texture").value());
+            auto* brushNode5 = new Model::BrushNode(builder.createCuboid(vm::bbox3(vm::vec3(-16, -16, -16), vm::vec3(48, 48, 48)), "texture").value());
+            addNode(*document, document->parentForNodes(), brushNode1);
+            addNode(*document, document->parentForNodes(), brushNode2);
+            addNode(*document, document->parentForNodes(), brushNode3);
+            addNode(*document, document->parentForNodes(), brushNode4);
+            addNode(*document, document->parentForNodes(), brushNode5);
+
+            document->select(std::vector<Model::Node*>{ brushNode1, brushNode2, brushNode3, brushNode4, brushNode5 });
+            CHECK(document->csgIntersect());
+
+            const auto& brushNodes = document->selectedNodes().brushes();
+            REQUIRE(brushNodes.size() == 1u);
+            CHECK(brushNodes.front()->logicalBounds() == vm::bbox3(vm::vec3(16, 16, 16), vm::vec3(48, 48, 48)));
+        }
+
+        TEST_CASE_METHOD(MapDocumentTest, "CsgTest.csgIntersectDisjointBrushes") {
+            const Model::BrushBuilder builder(document->world()->mapFormat(), document->worldBounds());
+
+            auto* brushNode1 = new Model::BrushNode(builder.createCuboid(vm::bbox3(vm::vec3(0, 0, 0), vm::vec3(32, 32, 32)), "texture").value());
+            auto* brushNode2 = new Model::BrushNode(builder.createCuboid(vm::bbox3(vm::vec3(16, 0, 0), vm::vec3(48, 32, 32)), "texture").value());
+            auto* brushNode3 = new Model::BrushNode(builder.createCuboid(vm::bbox3(vm::vec3(64, 0, 0), vm::vec3(96, 32, 32)), "texture").value());
+            addNode(*document, document->parentForNodes(), brushNode1);
+            addNode(*document, document->parentForNodes(), brushNode2);
+            addNode(*document, document->parentForNodes(), brushNode3);
+
+            document->select(std::vector<Model::Node*>{ brushNode1, brushNode2, brushNode3 });
+            CHECK(document->csgIntersect());
+            CHECK(document->selectedNodes().empty());
+            CHECK(document->world()->defaultLayer()->children().empty());
+        }
+
         TEST_CASE_METHOD(MapDocumentTest, "CsgTest.csgConvexMergeFaces") {
             const Model::BrushBuilder builder(document->world()->mapFormat(), document->worldBounds());
 
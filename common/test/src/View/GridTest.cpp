@@ -28,12 +28,16 @@
 #include "View/Grid.h"
 
 #include <kdl/result.h>
+#include <kdl/vector_utils.h>
 
 #include <vecmath/approx.h>
 #include <vecmath/polygon.h>
 #include <vecmath/segment.h>
+#include <vecmath/vec.h>
+#include <vecmath/vec_io.h>
 
 #include <cmath>
+#include <vector>
 
 #include "Catch2.h"
 
@@ -120,6 +124,20 @@ namespace TrenchBroom {
             CHECK(Grid(2u).snapUp(-4.0, true) == vm::approx(0.0));
         }
 
+        TEST_CASE("GridTest.snapPoints", "[GridTest]") {
+            const auto points = std::vector<vm::vec3>{
+                vm::vec3(0.0, 1.999, -2.0),
+                vm::vec3(2.0, -1.999, 5.0),
+            };
+
+            CHECK(Grid(2u).snap(points) == std::vector<vm::vec3>{
+                vm::vec3(0.0, 0.0, -4.0),
+                vm::vec3(4.0, 0.0, 4.0),
+            });
+            CHECK(Grid(2u).snap(points) == kdl::vec_transform(points, [](const auto& p) { return Grid(2u).snap(p); }));
+            CHECK(Grid(2u).snap(std::vector<vm::vec3>{}).empty());
+        }
+
         TEST_CASE("GridTest.snapOnLine", "[GridTest]") {
             const vm::line3d X(vm::vec3d(5.0, 0.0, 0.0), vm::vec3d::pos_x());
 
@@ -0,0 +1,102 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/EntityNodeBase.h"
+#include "Model/EntityProperties.h"
+#include "View/EntityPropertyModel.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace View {
+        static void checkSameRows(const std::map<std::string, PropertyRow>& actual, const std::map<std::string, PropertyRow>& expected) {
+            REQUIRE(actual.size() == expected.size());
+            for (const auto& [key, expectedRow] : expected) {
+                const auto it = actual.find(key);
+                REQUIRE(it != std::end(actual));
+
+                const auto& actualRow = it->second;
+                CHECK(actualRow.value() == expectedRow.value());
+                CHECK(actualRow.isDefault() == expectedRow.isDefault());
+                CHECK(actualRow.multi() == expectedRow.multi());
+                CHECK(actualRow.subset() == expectedRow.subset());
+                CHECK(actualRow.keyMutable() == expectedRow.keyMutable());
+                CHECK(actualRow.valueMutable() == expectedRow.valueMutable());
+                CHECK(actualRow.isProtected() == expectedRow.isProtected());
+                CHECK(actualRow.tooltip() == expectedRow.tooltip());
+            }
+        }
+
+        TEST_CASE("PropertyAggregateTest.rowsMatchMergedRows", "[PropertyAggregateTest]") {
+            auto light1 = Model::EntityNode{Model::Entity{{
+                {Model::PropertyKeys::Classname, "light"},
+                {"light", "300"},
+                {"style", "1"}
+            }}};
+            auto light2 = Model::EntityNode{Model::Entity{{
+                {Model::PropertyKeys::Classname, "light"},
+                {"light", "200"}
+            }}};
+            auto worldspawn = Model::EntityNode{Model::Entity{{
+                {Model::PropertyKeys::Classname, Model::PropertyValues::WorldspawnClassname},
+                {Model::PropertyKeys::Wad, "some.wad"}
+            }}};
+
+            const auto nodes = std::vector<Model::EntityNodeBase*>{&light1, &light2, &worldspawn};
+
+            auto aggregate = PropertyAggregate{};
+            aggregate.update(nodes);
+            checkSameRows(aggregate.rows(nodes, true, true), PropertyRow::rowsForEntityNodes(nodes, true, true));
+            CHECK_FALSE(aggregate.allNodesProtectable());
+
+            SECTION("Removing nodes") {
+                const auto lights = std::vector<Model::EntityNodeBase*>{&light1, &light2};
+                aggregate.update(lights);
+                checkSameRows(aggregate.rows(lights, true, true), PropertyRow::rowsForEntityNodes(lights, true, true));
+
+                aggregate.removeNode(&light2);
+                const auto light = std::vector<Model::EntityNodeBase*>{&light1};
+                checkSameRows(aggregate.rows(light, true, true), PropertyRow::rowsForEntityNodes(light, true, true));
+            }
+
+            SECTION("Changing a node") {
+                auto entity = light2.entity();
+                entity.addOrUpdateProperty("light", "300");
+                entity.addOrUpdateProperty("style", "1");
+                light2.setEntity(std::move(entity));
+
+                aggregate.invalidateNode(&light2);
+                aggregate.update(nodes);
+                checkSameRows(aggregate.rows(nodes, true, true), PropertyRow::rowsForEntityNodes(nodes, true, true));
+            }
+
+            SECTION("Clearing the aggregate") {
+                aggregate.clear();
+                CHECK(aggregate.rows({}, true, true).empty());
+            }
+        }
+    }
+}
@@ -17,12 +17,18 @@
  along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "Model/Brush.h"
 #include "Model/BrushNode.h"
 #include "Model/NodeCollection.h"
 #include "View/MapDocumentTest.h"
 #include "View/MapDocument.h"
 #include "View/Grid.h"
 
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+
 #include "Catch2.h"
 
 namespace TrenchBroom {
@@ -53,5 +59,27 @@ namespace TrenchBroom {
             CHECK(document->selectedNodes().brushCount() == 1u);
             CHECK_NOTHROW(document->snapVertices(document->grid().actualSize()));
         }
+
+        TEST_CASE_METHOD(MapDocumentTest, "SnapBrushVerticesTest.snapVerticesOfMultipleBrushes") {
+            auto* snappedBrushNode = createBrushNode();
+            auto* unsnappedBrushNode = createBrushNode("texture", [&](Model::Brush& brush) {
+                REQUIRE(brush.transform(document->worldBounds(), vm::translation_matrix(vm::vec3(0.25, 0.0, 0.0)), false).is_success());
+            });
+            document->addNodes({{document->parentForNodes(), {snappedBrushNode, unsnappedBrushNode}}});
+            document->selectAllNodes();
+
+            const auto originalSnappedBounds = snappedBrushNode->logicalBounds();
+            const auto originalUnsnappedBounds = unsnappedBrushNode->logicalBounds();
+            REQUIRE(snappedBrushNode->brush().hasSnappedVertices(1.0));
+            REQUIRE_FALSE(unsnappedBrushNode->brush().hasSnappedVertices(1.0));
+
+            CHECK(document->snapVertices(1.0));
+            CHECK(snappedBrushNode->logicalBounds() == originalSnappedBounds);
+            CHECK(unsnappedBrushNode->brush().hasSnappedVertices(1.0));
+            CHECK(unsnappedBrushNode->logicalBounds() != originalUnsnappedBounds);
+
+            document->undoCommand();
+            CHECK(unsnappedBrushNode->logicalBounds() == originalUnsnappedBounds);
+        }
     }
 }
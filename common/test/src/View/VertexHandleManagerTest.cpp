@@ -0,0 +1,104 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "View/VertexHandleManager.h"
+
+#include <vecmath/segment.h>
+#include <vecmath/vec.h>
+
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace View {
+        TEST_CASE("VertexHandleManagerTest.selectCloseHandles", "[VertexHandleManagerTest]") {
+            VertexHandleManager manager;
+
+            // the handles lie on either side of a grid cell boundary of the spatial index
+            const auto h1 = vm::vec3(16.0, 0.0, 0.0);
+            const auto h2 = vm::vec3(16.0 - 0.0000005, 0.0, 0.0);
+            const auto h3 = vm::vec3(32.0, 0.0, 0.0);
+
+            manager.add(h1);
+            manager.add(h2);
+            manager.add(h3);
+            REQUIRE(manager.totalHandleCount() == 3u);
+
+            manager.select(vm::vec3(16.0 - 0.0000001, 0.0, 0.0));
+            CHECK(manager.selectedHandleCount() == 2u);
+            CHECK(manager.selected(h1));
+            CHECK(manager.selected(h2));
+            CHECK_FALSE(manager.selected(h3));
+
+            manager.deselect(h1);
+            CHECK(manager.selectedHandleCount() == 0u);
+
+            manager.select(h3);
+            CHECK(manager.selectedHandles() == std::vector<vm::vec3>{h3});
+        }
+
+        TEST_CASE("VertexHandleManagerTest.removeHandles", "[VertexHandleManagerTest]") {
+            VertexHandleManager manager;
+
+            const auto h1 = vm::vec3(-8.0, 8.0, 0.0);
+            const auto h2 = vm::vec3(8.0, 8.0, 0.0);
+
+            manager.add(h1);
+            manager.add(h1);
+            manager.add(h2);
+            REQUIRE(manager.totalHandleCount() == 2u);
+
+            // duplicates are only removed once all of them are removed
+            CHECK(manager.remove(h1));
+            manager.select(h1);
+            CHECK(manager.selected(h1));
+
+            CHECK(manager.remove(h1));
+            CHECK_FALSE(manager.contains(h1));
+            CHECK(manager.selectedHandleCount() == 0u);
+
+            // selecting a removed handle has no effect
+            manager.select(h1);
+            CHECK(manager.selectedHandleCount() == 0u);
+
+            manager.select(h2);
+            CHECK(manager.selected(h2));
+
+            manager.clear();
+            manager.add(h2);
+            CHECK_FALSE(manager.selected(h2));
+        }
+
+        TEST_CASE("EdgeHandleManagerTest.selectCloseHandles", "[VertexHandleManagerTest]") {
+            EdgeHandleManager manager;
+
+            const auto h1 = vm::segment3(vm::vec3(0.0, 0.0, 0.0), vm::vec3(32.0, 0.0, 0.0));
+            const auto h2 = vm::segment3(vm::vec3(0.0, 0.0, 0.0), vm::vec3(0.0, 32.0, 0.0));
+
+            manager.add(h1);
+            manager.add(h2);
+
+            manager.select(vm::segment3(vm::vec3(0.0, 0.0, 0.0), vm::vec3(32.0 + 0.0000001, 0.0, 0.0)));
+            CHECK(manager.selected(h1));
+            CHECK_FALSE(manager.selected(h2));
+        }
+    }
+}
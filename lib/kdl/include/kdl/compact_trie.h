@@ -21,9 +21,9 @@
 #include <kdl/string_format.h>
 #include <kdl/vector_utils.h>
 
+#include <algorithm>
 #include <cassert>
 #include <exception>
-#include <set>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -63,7 +63,6 @@ namespace kdl {
     template <typename V>
     class compact_trie {
     private:
-        struct node_cmp;
         class node;
 
         /**
@@ -198,50 +197,36 @@ namespace kdl {
         };
 
         /**
-         * A trie node. Children are stored in a set ordered by `node_cmp`. Each node can store a given value multiple
-         * times.
+         * A trie node. Each node can store a given value multiple times.
          *
-         * A trie node has only const methods and therefore appears to be immutable, but this is not the case. All of
-         * its members are actually declared as mutable and may be modified by the `insert` or `remove` member
-         * functions. The reason for this peculiar design choice is that trie nodes are stored by value in a `std::set`,
-         * and `std::set` does not allow its contents to be modified, since that might affect the position of the value
-         * in the set.
-         *
-         * But in this particular case, the position of a node in the containing set depends only on the node's key, and
-         * the node's key is changed only in ways that does not affect its position. The key can only become shorter
-         * or longer, that is, key "abc" might be changed to "ab" or "abcd", and neither of these changes affects how
-         * the key compares to other keys due to the order introduce by `node_cmp`, which consideres two keys equivalent
-         * if they share a non-empty prefix.
-         *
-         * This implies that the following two conditions hold for a node with key "abc":
-         * - There is no sibling node with a key that is a prefix of "abc".
-         * - There is no sibling node with a key that that has "abc" as a prefix.
-         *
-         * Therefore, shortening or extending a node's key does not affect its position in the containing set, and we
-         * can update a node's key without violating any invariants of the containing set.
+         * The keys of the children of a node never share a non-empty prefix, so no two children's keys start with the
+         * same character. The children are stored by value in a vector that is sorted by the first characters of their
+         * keys, which allows finding a child using a binary search. Compared to a node based container such as
+         * `std::set`, this avoids one allocation per node and keeps siblings next to each other in memory. A node's key
+         * may become shorter or longer during insertion and removal, but its first character never changes, so the
+         * order of its siblings is not affected.
          */
         class node {
         private:
-            friend struct node_cmp;
             friend class match_state;
 
             using value_container = std::unordered_map<V, std::size_t>;
-            using node_set = std::set<node, node_cmp>;
+            using node_list = std::vector<node>;
 
             /**
              * The partical key of this node.
              */
-            mutable std::string m_key;
+            std::string m_key;
 
             /**
              * Maps a value to the number of times it was stored in this node.
              */
-            mutable value_container m_values;
+            value_container m_values;
 
             /**
-             * The children of this node.
+             * The children of this node, sorted by the first characters of their keys.
              */
-            mutable node_set m_children;
+            node_list m_children;
         public:
             /**
              * Creates a new node with the given key.
@@ -260,7 +245,7 @@ namespace kdl {
              * @param key the key to insert
              * @param value the value to insert
              */
-            void insert(const std::string_view key, const V& value) const {
+            void insert(const std::string_view key, const V& value) {
                 /*
                  Possible cases for insertion:
                   index: 01234567 |   | #m_key: 6
@@ -291,7 +276,7 @@ namespace kdl {
                         // case 0, 1: m_key is a prefix of key, find or create a child that has a common prefix with
                         // the remainder of key and insert there
                         const auto remainder = key.substr(mismatch);
-                        const auto& child = *m_children.insert(node(std::string(remainder))).first;
+                        auto& child = find_or_insert_child(remainder);
                         child.insert(remainder, value);
                     } else { // mismatch == m_key.size()
                         // case 2: key and m_key have a common prefix, split this node and insert again
@@ -315,7 +300,7 @@ namespace kdl {
              * @param value the value to remove
              * @return true if the given key and value were removed from this node's subtree
              */
-            bool remove(const std::string_view key, const V& value) const {
+            bool remove(const std::string_view key, const V& value) {
                 bool result = false;
 
                 const std::size_t mismatch = kdl::cs::str_mismatch(key, m_key);
@@ -324,7 +309,7 @@ namespace kdl {
                     if (mismatch < key.length()) {
                         // m_key is a true prefix of key, continue at the corresponding child node
                         const auto remainder = key.substr(mismatch);
-                        const auto it = m_children.find(remainder);
+                        const auto it = find_child(m_children, remainder[0]);
                         assert(it != std::end(m_children));
 
                         result = it->remove(remainder, value);
@@ -418,8 +403,8 @@ namespace kdl {
                             }
                         } else {
                             // the key is consumed, so continue matching at the children
-                            for (const auto& c : { "*", "?", "%", "\\" }) {
-                                const auto it = m_children.find(c);
+                            for (const auto c : { '*', '?', '%', '\\' }) {
+                                const auto it = find_child(m_children, c);
                                 if (it != std::end(m_children)) {
                                     it->find_matches(pattern, p_i, this, match_state, out);
                                 }
@@ -470,7 +455,7 @@ namespace kdl {
                                 }
                             } else {
                                 // the key is consumed, so continue matching at the children
-                                for (auto it = m_children.lower_bound("0"), end = m_children.upper_bound("9"); it != end; ++it) {
+                                for (auto it = lower_bound_child(m_children, '0'), end = upper_bound_child(m_children, '9'); it != end; ++it) {
                                     it->find_matches(pattern, p_i, this, match_state, out);
                                 }
                             }
@@ -483,7 +468,7 @@ namespace kdl {
                                 }
                             } else {
                                 // the key is consumed, so continue matching at the children
-                                for (auto it = m_children.lower_bound("0"), end = m_children.upper_bound("9"); it != end; ++it) {
+                                for (auto it = lower_bound_child(m_children, '0'), end = upper_bound_child(m_children, '9'); it != end; ++it) {
                                     it->find_matches(pattern, p_i, this, match_state, out);
                                 }
                             }
@@ -496,7 +481,8 @@ namespace kdl {
                             }
                         } else {
                             // the key is consumed, so continue matching at the children
-                            for (auto [it, end] = m_children.equal_range(pattern.substr(p_i, 1u)); it != end; ++it) {
+                            const auto it = find_child(m_children, pattern[p_i]);
+                            if (it != std::end(m_children)) {
                                 it->find_matches(pattern, p_i, this, match_state, out);
                             }
                         }
@@ -523,11 +509,57 @@ namespace kdl {
                 }
             }
         private:
-            void insert_value(const V& value) const {
+            /**
+             * Returns an iterator to the first of the given children whose key does not start with a character less
+             * than the given character.
+             */
+            template <typename L>
+            static auto lower_bound_child(L& children, const char c) {
+                return std::lower_bound(std::begin(children), std::end(children), c, [](const node& n, const char c_) {
+                    return n.m_key[0] < c_;
+                });
+            }
+
+            /**
+             * Returns an iterator to the first of the given children whose key starts with a character greater than
+             * the given character.
+             */
+            template <typename L>
+            static auto upper_bound_child(L& children, const char c) {
+                return std::upper_bound(std::begin(children), std::end(children), c, [](const char c_, const node& n) {
+                    return c_ < n.m_key[0];
+                });
+            }
+
+            /**
+             * Returns an iterator to the child whose key starts with the given character, or the end iterator if there
+             * is no such child.
+             */
+            template <typename L>
+            static auto find_child(L& children, const char c) {
+                const auto it = lower_bound_child(children, c);
+                return it != std::end(children) && it->m_key[0] == c ? it : std::end(children);
+            }
+
+            /**
+             * Returns the child whose key shares a non-empty prefix with the given key. If there is no such child, a
+             * new child with the given key is inserted.
+             */
+            node& find_or_insert_child(const std::string_view key) {
+                assert(!key.empty());
+
+                auto it = lower_bound_child(m_children, key[0]);
+                if (it == std::end(m_children) || it->m_key[0] != key[0]) {
+                    it = m_children.insert(it, node(std::string(key)));
+                }
+                return *it;
+            }
+
+            void insert_value(const V& value) {
                 m_values[value]++;
             }
 
-            bool remove_value(const V& value) const {
+            bool remove_value(const V& value) {
                 auto it = m_values.find(value);
                 if (it == std::end(m_values)) {
                     return false;
@@ -552,7 +584,7 @@ namespace kdl {
              *
              * @param index the index at which to split the node's key
              */
-            void split_node(const std::size_t index) const {
+            void split_node(const std::size_t index) {
                 assert(m_key.length() > 1u);
 
                 auto new_key = m_key.substr(0u, index);
@@ -561,13 +593,13 @@ namespace kdl {
                 assert(!new_key.empty());
                 assert(!remainder.empty());
 
-                using std::swap;
-                node_set new_children;
-                swap(new_children, m_children);
+                auto new_child = node(std::move(remainder));
+                new_child.m_children = std::move(m_children);
+                new_child.m_values = std::move(m_values);
 
-                const node& new_child = *m_children.insert(node(std::move(remainder))).first;
-                swap(new_child.m_children, new_children);
-                swap(new_child.m_values, m_values);
+                m_children = node_list{};
+                m_children.push_back(std::move(new_child));
+                m_values = value_container{};
 
                 m_key = std::move(new_key);
             }
@@ -578,17 +610,13 @@ namespace kdl {
              *
              * Precondition: This node has only one child, and this node has no values of its own.
              */
-            void merge_node() const {
+            void merge_node() {
                 assert(m_children.size() == 1u);
                 assert(m_values.empty());
 
-                using std::swap;
-                node_set old_children;
-                swap(old_children, m_children);
-
-                const node& child = *std::begin(old_children);
-                swap(m_children, child.m_children);
-                swap(m_values, child.m_values);
+                auto child = std::move(m_children.front());
+                m_children = std::move(child.m_children);
+                m_values = std::move(child.m_values);
 
                 m_key += child.m_key;
             }
@@ -611,38 +639,6 @@ namespace kdl {
             }
         };
 
-        /**
-         * Compares nodes against each other or nodes against strings.
-         *
-         * Two nodes are compared by their keys.
-         * A node is compared to a string by comparing its key to the string.
-         *
-         * Two strings are compared by their first character only, soif two nodes share a non-empty prefix, they are
-         * considered equivalent. Therefore, the keys "ab" and "abc" are equivalent. Conversely, the keys "ab" and "bc"
-         * are not equivalent because they do not share a prefix, more specifically, "ab" is considered less than "bc".
-         *
-         * Precondition: the strings to copmare are not empty.
-         */
-        struct node_cmp {
-            using is_transparent = void;
-
-            bool operator()(const node& lhs, const node& rhs) const {
-                return compare(lhs.m_key, rhs.m_key);
-            }
-
-            bool operator()(const std::string_view lhs, const node& rhs) const {
-                return compare(lhs, rhs.m_key);
-            }
-
-            bool operator()(const node& lhs, const std::string_view rhs) const {
-                return compare(lhs.m_key, rhs);
-            }
-
-            bool compare(const std::string_view lhs, const std::string_view& rhs) const {
-                assert(!lhs.empty() && !rhs.empty());
-                return lhs[0] < rhs[0];
-            }
-        };
     private:
         node m_root;
     public:
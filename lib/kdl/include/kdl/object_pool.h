@@ -0,0 +1,267 @@
+/*
+ Copyright 2021 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef KDL_OBJECT_POOL_H
+#define KDL_OBJECT_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace kdl {
+    /**
+     * A process wide pool of memory blocks that are large enough to hold an object of type T. Blocks are carved out
+     * of chunks of `chunk_size` blocks each, so allocating and deallocating a block only pushes or pops a free list
+     * instead of going through the general purpose allocator.
+     *
+     * Every thread caches up to `2 * chunk_size` free blocks, so threads only contend for a lock when their cache runs
+     * empty or overflows. Blocks may be deallocated on another thread than the one which allocated them: once a
+     * thread's cache overflows, `chunk_size` of its blocks are moved back to the shared free list, where the allocating
+     * thread can pick them up again. When a thread exits, its cached blocks are handed back to the pool as well.
+     *
+     * The chunks are never released, so the memory held by the pool only ever grows to the largest number of objects
+     * that were alive at the same time plus the blocks cached by the threads.
+     *
+     * Use this by overloading the class specific allocation functions of T, e.g.
+     *
+     * static void* operator new(const std::size_t size) { return kdl::object_pool<T>::allocate(size); }
+     * static void operator delete(void* ptr) noexcept { kdl::object_pool<T>::deallocate(ptr); }
+     *
+     * @tparam T the type of the objects stored in the pool
+     * @tparam chunk_size the number of blocks to allocate at once
+     */
+    template <typename T, std::size_t chunk_size = 256>
+    class object_pool {
+        static_assert(chunk_size > 0u, "object_pool must have chunk_size > 0");
+    private:
+        union block {
+            block* next;
+            alignas(T) unsigned char storage[sizeof(T)];
+        };
+
+        struct shared_state {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<block[]>> chunks;
+            block* free_list = nullptr;
+        };
+
+        struct local_cache {
+            block* free_list = nullptr;
+            std::size_t count = 0u;
+        };
+
+        static constexpr std::size_t max_cached_blocks = 2u * chunk_size;
+
+        /**
+         * Returns the thread's free list back to the shared state when the thread exits.
+         */
+        struct thread_guard {
+            thread_guard() {
+                // constructs the shared state before the guard, if necessary
+                shared();
+            }
+
+            ~thread_guard() {
+                auto& cache = local();
+                if (cache.free_list != nullptr) {
+                    auto& state = shared();
+                    std::lock_guard<std::mutex> lock(state.mutex);
+                    push_list(state.free_list, cache.free_list);
+                }
+                cache.free_list = nullptr;
+                cache.count = 0u;
+                thread_exited() = true;
+            }
+        };
+    public:
+        /**
+         * Returns a block of memory for an object of type T.
+         *
+         * @param size the requested size, must not exceed sizeof(T)
+         *
+         * @throws std::bad_alloc if a new chunk is needed, but cannot be allocated
+         */
+        static void* allocate(const std::size_t size = sizeof(T)) {
+            if (size > sizeof(T)) {
+                throw std::bad_alloc();
+            }
+
+            if (!guarded()) {
+                auto& state = shared();
+                std::lock_guard<std::mutex> lock(state.mutex);
+                return pop(take_free_block(state));
+            }
+
+            auto& cache = local();
+            if (cache.free_list == nullptr) {
+                auto& state = shared();
+                std::lock_guard<std::mutex> lock(state.mutex);
+                cache.free_list = take_free_list(state, chunk_size, cache.count);
+            }
+            --cache.count;
+            return pop(cache.free_list);
+        }
+
+        /**
+         * Returns the given block, which must have been obtained from allocate(), to the pool.
+         */
+        static void deallocate(void* ptr) noexcept {
+            if (ptr == nullptr) {
+                return;
+            }
+
+            auto* b = reinterpret_cast<block*>(ptr);
+            if (!guarded()) {
+                auto& state = shared();
+                std::lock_guard<std::mutex> lock(state.mutex);
+                b->next = state.free_list;
+                state.free_list = b;
+            } else {
+                auto& cache = local();
+                b->next = cache.free_list;
+                cache.free_list = b;
+
+                if (++cache.count > max_cached_blocks) {
+                    // the blocks were likely allocated by another thread, so hand some of them back to it
+                    auto* spilled = split_list(cache.free_list, chunk_size);
+                    cache.count -= chunk_size;
+
+                    auto& state = shared();
+                    std::lock_guard<std::mutex> lock(state.mutex);
+                    push_list(state.free_list, spilled);
+                }
+            }
+        }
+
+        /**
+         * Returns the number of chunks that the pool has allocated so far.
+         */
+        static std::size_t chunk_count() {
+            auto& state = shared();
+            std::lock_guard<std::mutex> lock(state.mutex);
+            return state.chunks.size();
+        }
+    private:
+        static shared_state& shared() {
+            // intentionally leaked so that objects which are destroyed during static destruction can still be deallocated
+            static auto* state = new shared_state();
+            return *state;
+        }
+
+        // trivially destructible so that it remains accessible while the thread's other objects are destroyed
+        static local_cache& local() {
+            static thread_local local_cache cache;
+            return cache;
+        }
+
+        static bool& thread_exited() {
+            static thread_local bool exited = false;
+            return exited;
+        }
+
+        /**
+         * Ensures that the calling thread has a guard and returns whether the thread may use its own free list, which
+         * is not the case anymore once the guard has been destroyed.
+         */
+        static bool guarded() {
+            if (thread_exited()) {
+                return false;
+            }
+            static thread_local thread_guard guard;
+            (void)guard;
+            return true;
+        }
+
+        static void* pop(block*& free_list) {
+            auto* result = free_list;
+            free_list = result->next;
+            return result->storage;
+        }
+
+        static void push_list(block*& free_list, block* list) {
+            auto* last = list;
+            while (last->next != nullptr) {
+                last = last->next;
+            }
+            last->next = free_list;
+            free_list = list;
+        }
+
+        /**
+         * Detaches the first `count` blocks from the given list, which must contain more than `count` blocks, and
+         * returns them as a list of their own.
+         */
+        static block* split_list(block*& free_list, const std::size_t count) {
+            auto* result = free_list;
+            auto* last = free_list;
+            for (std::size_t i = 1; i < count; ++i) {
+                last = last->next;
+            }
+            free_list = last->next;
+            last->next = nullptr;
+            return result;
+        }
+
+        /**
+         * Removes up to `max_count` free blocks from the shared state, allocating a new chunk if there are none, and
+         * stores the number of removed blocks in `count`. Must be called with the shared state's mutex locked.
+         */
+        static block* take_free_list(shared_state& state, const std::size_t max_count, std::size_t& count) {
+            if (state.free_list == nullptr) {
+                allocate_chunk(state);
+            }
+
+            auto* result = state.free_list;
+            auto* last = result;
+            count = 1u;
+            while (count < max_count && last->next != nullptr) {
+                last = last->next;
+                ++count;
+            }
+            state.free_list = last->next;
+            last->next = nullptr;
+            return result;
+        }
+
+        /**
+         * Returns a reference to the shared free list after ensuring that it is not empty. Must be called with the
+         * shared state's mutex locked.
+         */
+        static block*& take_free_block(shared_state& state) {
+            if (state.free_list == nullptr) {
+                allocate_chunk(state);
+            }
+            return state.free_list;
+        }
+
+        static void allocate_chunk(shared_state& state) {
+            state.chunks.push_back(std::make_unique<block[]>(chunk_size));
+
+            auto& chunk = state.chunks.back();
+            for (std::size_t i = 0; i < chunk_size - 1; ++i) {
+                chunk[i].next = &chunk[i + 1];
+            }
+            chunk[chunk_size - 1].next = state.free_list;
+            state.free_list = &chunk[0];
+        }
+    };
+}
+
+#endif //KDL_OBJECT_POOL_H
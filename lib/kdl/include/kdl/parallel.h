@@ -18,16 +18,10 @@
 #ifndef KDL_PARALLEL_H
 #define KDL_PARALLEL_H
 
+#include "kdl/thread_pool.h"
 #include "kdl/vector_utils.h"
 
-#ifdef _WIN32
-#include <ppl.h>
-#endif
-
-#include <atomic>
-#include <future> // for std::async
 #include <optional>
-#include <thread>
 #include <utility> // for std::declval
 #include <vector>
 
@@ -35,10 +29,11 @@ namespace kdl {
     /**
      * Runs the given lambda `count` times, passing it indices `0` through `count - 1`.
      *
-     * Lambda is executed in parallel, using the number of threads returned by std::thread::hardware_concurrency().
+     * Lambda is executed in parallel on the process wide thread pool (see thread_pool::global()). The calling thread
+     * participates in the work, and the lambda may itself call parallel_for.
      *
-     * Because the threads are spawned with std::async(std::launch::async, ...) and no thread pool is used,
-     * there is a relatively large overhead and this should only be used on large/slow to process data sets.
+     * If the lambda throws, the remaining indices are skipped and the exception is rethrown once all running
+     * invocations have finished.
      *
      * @tparam L type of lambda
      * @param count the maximum value (exclusive) to pass to lambda
@@ -46,45 +41,27 @@ namespace kdl {
      */
     template<class L>
     void parallel_for(const size_t count, L&& lambda) {
-#ifdef _WIN32
-        concurrency::parallel_for<size_t>(0, count, lambda);
-#else
-        size_t numThreads = static_cast<size_t>(std::thread::hardware_concurrency());
-        if (numThreads == 0) {
-            numThreads = 1;
-        }
-
-        std::atomic<size_t> nextIndex(0);
-
-        std::vector<std::future<void>> threads;
-        threads.resize(numThreads);
-
-        for (size_t i = 0; i < numThreads; ++i) {
-            threads[i] = std::async(std::launch::async, [&]() {
-                while (true) {
-                    const size_t ourIndex = std::atomic_fetch_add(&nextIndex, static_cast<size_t>(1));
-                    if (ourIndex >= count) {
-                        break;
-                    }
-                    lambda(ourIndex);
-                }
-            });
-        }
+        thread_pool::global().parallel_for(count, lambda);
+    }
 
-        for (size_t i = 0; i < numThreads; ++i) {
-            threads[i].wait();
-        }
-#endif
+    /**
+     * Like parallel_for(count, lambda), but stops passing indices to the lambda once the given token is cancelled.
+     *
+     * @tparam L type of lambda
+     * @param count the maximum value (exclusive) to pass to lambda
+     * @param lambda the lambda to run
+     * @param token the token to check before each invocation
+     */
+    template<class L>
+    void parallel_for(const size_t count, L&& lambda, const cancellation_token& token) {
+        thread_pool::global().parallel_for(count, lambda, &token);
     }
 
     /**
      * Applies the given lambda to each element of the input (passing elements as rvalue references),
      * and returns a vector of the resulting values, in their original order.
      * 
-     * The lambda is executed in parallel, using the number of threads returned by std::thread::hardware_concurrency().
-     * 
-     * Because the threads are spawned with std::async(std::launch::async, ...) and no thread pool is used,
-     * there is a relatively large overhead and this should only be used on large/slow to process data sets.
+     * The lambda is executed in parallel on the process wide thread pool, see parallel_for.
      *
      * @tparam T the type of the vector elements
      * @tparam L the type of the lambda to apply
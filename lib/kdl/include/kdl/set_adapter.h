@@ -19,7 +19,7 @@
 
 #include "collection_utils.h"
 
-#include <algorithm> // for std::sort, std::unique, std::lower_bound, std::upper_bound
+#include <algorithm> // for std::sort, std::stable_sort, std::inplace_merge, std::unique, std::lower_bound, std::upper_bound
 #include <cassert>
 #include <functional> // for std::less
 #include <iterator> // for std::distance
@@ -616,6 +616,11 @@ namespace kdl {
         /**
          * Inserts the values from the given range [first, last) into this set.
          *
+         * The values are appended to the underlying collection, sorted, and then merged with the values that were
+         * already present, so inserting k values into a set of size n takes O(n + k log k) time instead of O(k * n).
+         * If the range contains values that are equivalent to each other or to a value already in this set, the value
+         * that was present first is kept, just as if the values were inserted one by one.
+         *
          * Postcondition: for each value in the given range, this set contains an equivalent value and its size has
          * increased by one if the by the number of unique values in the given range which were not present in this set
 
@@ -625,9 +630,17 @@ namespace kdl {
          */
         template <typename I>
         void insert(I first, I last) {
-            while (first != last) {
-                do_insert(*first);
-                ++first;
+            const auto old_size = static_cast<difference_type>(m_data.size());
+            m_data.insert(std::end(m_data), first, last);
+
+            const auto mid = std::next(std::begin(m_data), old_size);
+            if (mid != std::end(m_data)) {
+                // both the sort and the merge are stable, so the first of several equivalent values comes first
+                std::stable_sort(mid, std::end(m_data), m_cmp);
+                std::inplace_merge(std::begin(m_data), mid, std::end(m_data), m_cmp);
+                m_data.erase(std::unique(std::begin(m_data), std::end(m_data), [&](const auto& lhs, const auto& rhs) {
+                    return this->is_equivalent(lhs, rhs);
+                }), std::end(m_data));
             }
             assert(check_invariant());
         }
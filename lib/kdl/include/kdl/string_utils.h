@@ -49,14 +49,16 @@ namespace kdl {
         }
 
         std::vector<std::string> result;
-        std::stringstream buf;
+        // appending to a string is much cheaper than using a string stream, and this function is called a lot, e.g.
+        // whenever a path is created from a string
+        std::string buf;
 
         const auto appendPart = [&]() {
-            auto part = str_trim(buf.str());
+            auto part = str_trim(buf);
             if (!part.empty()) {
                 result.push_back(std::move(part));
             }
-            buf.str("");
+            buf.clear();
         };
 
         for (auto i = 0u; i < str.size(); ++i) {
@@ -65,7 +67,7 @@ namespace kdl {
                 // maybe escaped delimiter or backslash
                 const auto n = str[i+1];
                 if (n == '\\' || delims.find(n) != std::string_view::npos) {
-                    buf << n;
+                    buf += n;
                     ++i;
                     continue;
                 }
@@ -74,7 +76,7 @@ namespace kdl {
             if (delims.find(c) != std::string_view::npos) {
                 appendPart();
             } else {
-                buf << c;
+                buf += c;
             }
         }
 
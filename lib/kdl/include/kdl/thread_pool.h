@@ -0,0 +1,261 @@
+/*
+ Copyright 2021 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef KDL_THREAD_POOL_H
+#define KDL_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory> // for std::addressof
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace kdl {
+    /**
+     * Allows to cancel a running parallel loop. Once cancelled, no further indices are passed to the loop body,
+     * but invocations that have already started are allowed to finish.
+     */
+    class cancellation_token {
+    private:
+        std::atomic<bool> m_cancelled;
+    public:
+        cancellation_token() :
+        m_cancelled(false) {}
+
+        void cancel() {
+            m_cancelled.store(true, std::memory_order_relaxed);
+        }
+
+        bool cancelled() const {
+            return m_cancelled.load(std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * A pool of worker threads that process the indices of parallel loops.
+     *
+     * Each call to parallel_for enqueues a batch of indices. The calling thread processes indices of its own batch,
+     * and idle workers steal indices from any pending batch. Since the calling thread always works on its own batch,
+     * loops can be nested: a loop body may issue another parallel loop without risking a deadlock, even if all
+     * workers are busy.
+     *
+     * If the loop body throws an exception, the remaining indices of the batch are skipped and the first exception
+     * is rethrown in the calling thread.
+     */
+    class thread_pool {
+    private:
+        struct batch {
+            void (*invoke)(void* context, size_t index);
+            void* context;
+            size_t count;
+            const cancellation_token* token;
+
+            std::atomic<size_t> next_index;
+            std::atomic<size_t> finished_count;
+            std::atomic<bool> failed;
+
+            // guarded by the pool's mutex
+            std::exception_ptr exception;
+            size_t worker_count;
+
+            batch(void (*i_invoke)(void*, size_t), void* i_context, const size_t i_count, const cancellation_token* i_token) :
+            invoke(i_invoke),
+            context(i_context),
+            count(i_count),
+            token(i_token),
+            next_index(0),
+            finished_count(0),
+            failed(false),
+            worker_count(0) {}
+        };
+
+        std::mutex m_mutex;
+        std::condition_variable m_work_available;
+        std::condition_variable m_batch_finished;
+        std::deque<batch*> m_pending;
+        std::vector<std::thread> m_workers;
+        bool m_stopping;
+    public:
+        /**
+         * Creates a pool with the given number of worker threads. The threads that call parallel_for participate in
+         * the work, so a pool without any workers runs all loops serially.
+         */
+        explicit thread_pool(const size_t worker_count) :
+        m_stopping(false) {
+            m_workers.reserve(worker_count);
+            for (size_t i = 0; i < worker_count; ++i) {
+                m_workers.emplace_back([&]() { run_worker(); });
+            }
+        }
+
+        ~thread_pool() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopping = true;
+            }
+            m_work_available.notify_all();
+            for (auto& worker : m_workers) {
+                worker.join();
+            }
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        /**
+         * Returns the process wide pool, which uses one worker less than std::thread::hardware_concurrency() reports
+         * because the calling thread participates in the work. The workers are created on first use.
+         */
+        static thread_pool& global() {
+            static thread_pool pool(global_worker_count());
+            return pool;
+        }
+
+        size_t worker_count() const {
+            return m_workers.size();
+        }
+
+        /**
+         * Runs the given lambda `count` times, passing it indices `0` through `count - 1`, and returns once all
+         * invocations have finished.
+         *
+         * @tparam L type of lambda
+         * @param count the maximum value (exclusive) to pass to lambda
+         * @param lambda the lambda to run
+         * @param token if not null, no further indices are processed once the token is cancelled
+         *
+         * @throws any exception thrown by the lambda
+         */
+        template <class L>
+        void parallel_for(const size_t count, L&& lambda, const cancellation_token* token = nullptr) {
+            if (count == 0) {
+                return;
+            }
+
+            if (count == 1 || m_workers.empty()) {
+                for (size_t i = 0; i < count && !(token && token->cancelled()); ++i) {
+                    lambda(i);
+                }
+                return;
+            }
+
+            using lambda_type = std::remove_reference_t<L>;
+            const auto invoke = [](void* context, const size_t index) {
+                (*static_cast<lambda_type*>(context))(index);
+            };
+
+            batch b(invoke, const_cast<void*>(static_cast<const void*>(std::addressof(lambda))), count, token);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_pending.push_back(&b);
+            }
+            if (count - 1 >= m_workers.size()) {
+                m_work_available.notify_all();
+            } else {
+                for (size_t i = 0; i < count - 1; ++i) {
+                    m_work_available.notify_one();
+                }
+            }
+
+            process(b);
+
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_batch_finished.wait(lock, [&]() {
+                    return b.finished_count.load() == b.count && b.worker_count == 0;
+                });
+            }
+
+            if (b.exception) {
+                std::rethrow_exception(b.exception);
+            }
+        }
+    private:
+        static size_t global_worker_count() {
+            const auto thread_count = static_cast<size_t>(std::thread::hardware_concurrency());
+            return thread_count > 1 ? thread_count - 1 : 0;
+        }
+
+        void run_worker() {
+            while (true) {
+                batch* b = nullptr;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_work_available.wait(lock, [&]() { return m_stopping || !m_pending.empty(); });
+                    if (m_pending.empty()) {
+                        return;
+                    }
+                    b = m_pending.front();
+                    ++b->worker_count;
+                }
+
+                process(*b);
+
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    --b->worker_count;
+                }
+                m_batch_finished.notify_all();
+            }
+        }
+
+        /**
+         * Processes indices of the given batch until all of them have been claimed.
+         */
+        void process(batch& b) {
+            while (true) {
+                const auto index = b.next_index.fetch_add(1);
+                if (index >= b.count) {
+                    break;
+                }
+
+                if (!b.failed.load() && !(b.token && b.token->cancelled())) {
+                    try {
+                        b.invoke(b.context, index);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        if (!b.exception) {
+                            b.exception = std::current_exception();
+                        }
+                        b.failed = true;
+                    }
+                }
+
+                if (b.finished_count.fetch_add(1) + 1 == b.count) {
+                    // take the lock so that the waiting thread cannot miss the notification
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_batch_finished.notify_all();
+                }
+            }
+
+            // all indices are claimed, so there is nothing left for other threads to do
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto it = std::find(m_pending.begin(), m_pending.end(), &b);
+            if (it != m_pending.end()) {
+                m_pending.erase(it);
+            }
+        }
+    };
+}
+
+#endif //KDL_THREAD_POOL_H
@@ -0,0 +1,168 @@
+/*
+ Copyright 2021 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "kdl/object_pool.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace kdl {
+    struct pooled {
+        static int instances;
+
+        double values[3];
+
+        pooled() {
+            ++instances;
+        }
+
+        ~pooled() {
+            --instances;
+        }
+
+        static void* operator new(const std::size_t size) {
+            return object_pool<pooled, 4>::allocate(size);
+        }
+
+        static void operator delete(void* ptr) noexcept {
+            object_pool<pooled, 4>::deallocate(ptr);
+        }
+    };
+
+    int pooled::instances = 0;
+
+    TEST_CASE("object_pool_test.allocate_deallocate", "[object_pool_test]") {
+        auto blocks = std::vector<void*>();
+        for (size_t i = 0; i < 10; ++i) {
+            auto* block = object_pool<double, 4>::allocate();
+            CHECK(block != nullptr);
+            CHECK(reinterpret_cast<std::uintptr_t>(block) % alignof(double) == 0u);
+            CHECK(std::find(std::begin(blocks), std::end(blocks), block) == std::end(blocks));
+            blocks.push_back(block);
+        }
+
+        // the most recently deallocated block is reused first
+        object_pool<double, 4>::deallocate(blocks.back());
+        CHECK(object_pool<double, 4>::allocate() == blocks.back());
+
+        for (auto* block : blocks) {
+            object_pool<double, 4>::deallocate(block);
+        }
+    }
+
+    TEST_CASE("object_pool_test.allocate_too_large", "[object_pool_test]") {
+        CHECK_THROWS_AS(object_pool<double>::allocate(sizeof(double) + 1u), std::bad_alloc);
+    }
+
+    TEST_CASE("object_pool_test.class_specific_new", "[object_pool_test]") {
+        auto objects = std::vector<std::unique_ptr<pooled>>();
+        for (size_t i = 0; i < 9; ++i) {
+            objects.push_back(std::make_unique<pooled>());
+            objects.back()->values[0] = static_cast<double>(i);
+        }
+        CHECK(pooled::instances == 9);
+
+        for (size_t i = 0; i < objects.size(); ++i) {
+            CHECK(objects[i]->values[0] == static_cast<double>(i));
+        }
+
+        objects.clear();
+        CHECK(pooled::instances == 0);
+    }
+
+    TEST_CASE("object_pool_test.deallocate_on_other_thread", "[object_pool_test]") {
+        auto objects = std::vector<pooled*>();
+        std::thread([&]() {
+            for (size_t i = 0; i < 9; ++i) {
+                objects.push_back(new pooled());
+            }
+        }).join();
+
+        std::thread([&]() {
+            for (auto* object : objects) {
+                delete object;
+            }
+        }).join();
+        CHECK(pooled::instances == 0);
+
+        // the blocks returned by the exited thread are reused by a new thread
+        pooled* object = nullptr;
+        std::thread([&]() {
+            object = new pooled();
+        }).join();
+        CHECK(std::find(std::begin(objects), std::end(objects), object) != std::end(objects));
+        delete object;
+    }
+
+    struct cross_thread_pooled {
+        double value;
+    };
+
+    TEST_CASE("object_pool_test.allocate_and_deallocate_on_different_threads", "[object_pool_test]") {
+        using pool = object_pool<cross_thread_pooled, 4>;
+
+        const std::size_t rounds = 10u;
+        const std::size_t count = 64u;
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::vector<void*> blocks;
+        std::size_t round = 0u;
+        bool allocated = false;
+
+        // both threads stay alive for all rounds, so their cached blocks are never returned by a thread exit
+        auto allocator = std::thread([&]() {
+            for (std::size_t i = 0u; i < rounds; ++i) {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [&]() { return round == i && !allocated; });
+                for (std::size_t j = 0u; j < count; ++j) {
+                    blocks.push_back(pool::allocate());
+                }
+                allocated = true;
+                condition.notify_all();
+            }
+        });
+
+        std::size_t chunksAfterFirstRound = 0u;
+        for (std::size_t i = 0u; i < rounds; ++i) {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [&]() { return allocated; });
+            if (i == 0u) {
+                chunksAfterFirstRound = pool::chunk_count();
+            }
+            for (auto* block : blocks) {
+                pool::deallocate(block);
+            }
+            blocks.clear();
+            allocated = false;
+            ++round;
+            condition.notify_all();
+        }
+        allocator.join();
+
+        // the freed blocks are reused by the allocating thread, so only the caches of both threads may need new chunks
+        CHECK(pool::chunk_count() <= chunksAfterFirstRound + 4u);
+    }
+}
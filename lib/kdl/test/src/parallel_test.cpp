@@ -21,6 +21,7 @@
 #include <atomic>
 #include <chrono>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -63,6 +64,93 @@ namespace kdl {
         }
     }
 
+    TEST_CASE("nested for", "[parallel_test]") {
+        constexpr size_t OuterSize = 100;
+        constexpr size_t InnerSize = 100;
+
+        auto counter = std::atomic<size_t>{0};
+        kdl::parallel_for(OuterSize, [&](const size_t) {
+            kdl::parallel_for(InnerSize, [&](const size_t) {
+                std::atomic_fetch_add(&counter, static_cast<size_t>(1));
+            });
+        });
+
+        CHECK(static_cast<size_t>(counter) == OuterSize * InnerSize);
+    }
+
+    TEST_CASE("for rethrows exception", "[parallel_test]") {
+        auto counter = std::atomic<size_t>{0};
+        CHECK_THROWS_AS(kdl::parallel_for(10'000, [&](const size_t i) {
+            std::atomic_fetch_add(&counter, static_cast<size_t>(1));
+            if (i == 10) {
+                throw std::runtime_error("test");
+            }
+        }), std::runtime_error);
+
+        // the indices that were not started when the exception was thrown were skipped
+        CHECK(static_cast<size_t>(counter) < 10'000u);
+
+        // the pool is still usable
+        auto ran = std::atomic<size_t>{0};
+        kdl::parallel_for(100, [&](const size_t) { std::atomic_fetch_add(&ran, static_cast<size_t>(1)); });
+        CHECK(static_cast<size_t>(ran) == 100u);
+    }
+
+    TEST_CASE("for with cancellation", "[parallel_test]") {
+        auto token = kdl::cancellation_token{};
+        auto counter = std::atomic<size_t>{0};
+        kdl::parallel_for(10'000, [&](const size_t) {
+            if (std::atomic_fetch_add(&counter, static_cast<size_t>(1)) == 10) {
+                token.cancel();
+            }
+        }, token);
+
+        CHECK(token.cancelled());
+        CHECK(static_cast<size_t>(counter) < 10'000u);
+    }
+
+    TEST_CASE("thread_pool without workers", "[parallel_test]") {
+        auto pool = kdl::thread_pool{0};
+        CHECK(pool.worker_count() == 0u);
+
+        auto indices = std::vector<size_t>{};
+        pool.parallel_for(3, [&](const size_t i) { indices.push_back(i); });
+        CHECK(indices == std::vector<size_t>{0, 1, 2});
+    }
+
+    TEST_CASE("thread_pool with workers", "[parallel_test]") {
+        auto pool = kdl::thread_pool{4};
+        CHECK(pool.worker_count() == 4u);
+
+        SECTION("nested loops") {
+            auto counter = std::atomic<size_t>{0};
+            pool.parallel_for(100, [&](const size_t) {
+                pool.parallel_for(100, [&](const size_t) {
+                    std::atomic_fetch_add(&counter, static_cast<size_t>(1));
+                });
+            });
+            CHECK(static_cast<size_t>(counter) == 10'000u);
+        }
+
+        SECTION("exceptions") {
+            CHECK_THROWS_AS(pool.parallel_for(1'000, [&](const size_t i) {
+                if (i % 100 == 0) {
+                    throw std::runtime_error("test");
+                }
+            }), std::runtime_error);
+        }
+
+        SECTION("many small loops") {
+            auto counter = std::atomic<size_t>{0};
+            for (size_t i = 0; i < 1'000; ++i) {
+                pool.parallel_for(10, [&](const size_t) {
+                    std::atomic_fetch_add(&counter, static_cast<size_t>(1));
+                });
+            }
+            CHECK(static_cast<size_t>(counter) == 10'000u);
+        }
+    }
+
     TEST_CASE("transform", "[parallel_test]") {
         const auto L = [](const int& v) { return v * 10; };
 
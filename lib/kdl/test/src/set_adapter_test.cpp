@@ -313,6 +313,24 @@ namespace kdl {
         CHECK_THAT(v, Catch::Equals(std::vector<int>{ 1, 2, 3, 4 }));
     }
 
+    TEST_CASE("set_adapter_test.insert_with_range_into_non_empty_set", "[set_adapter_test]") {
+        using value = std::pair<int, int>;
+        struct cmp_first {
+            bool operator()(const value& lhs, const value& rhs) const {
+                return lhs.first < rhs.first;
+            }
+        };
+
+        auto v = std::vector<value>{ { 2, 0 }, { 5, 0 } };
+        auto s = wrap_set(v, cmp_first());
+
+        // equivalent values which are already present or which come later in the range are not inserted
+        const auto r = std::vector<value>{ { 6, 1 }, { 2, 1 }, { 3, 1 }, { 1, 1 }, { 3, 2 } };
+        s.insert(std::begin(r), std::end(r));
+
+        CHECK_THAT(v, Catch::Equals(std::vector<value>{ { 1, 1 }, { 2, 0 }, { 3, 1 }, { 5, 0 }, { 6, 1 } }));
+    }
+
 
     TEST_CASE("set_adapter_test.emplace", "[set_adapter_test]") {
         auto v = std::vector<int>();